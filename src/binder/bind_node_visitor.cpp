@@ -13,6 +13,7 @@
 #include "binder/bind_node_visitor.h"
 
 #include "expression/case_expression.h"
+#include "expression/subquery_expression.h"
 #include "expression/tuple_value_expression.h"
 
 namespace peloton {
@@ -115,6 +116,8 @@ void BindNodeVisitor::Visit(parser::LimitDescription *) {}
 void BindNodeVisitor::Visit(parser::CopyStatement *) {}
 void BindNodeVisitor::Visit(parser::CreateStatement *node) {
   node->TryBindDatabaseName(default_database_name_);
+  if (node->view_query != nullptr) node->view_query->Accept(this);
+  context_ = nullptr;
 }
 void BindNodeVisitor::Visit(parser::InsertStatement *node) {
   node->TryBindDatabaseName(default_database_name_);
@@ -175,5 +178,11 @@ void BindNodeVisitor::Visit(expression::CaseExpression *expr) {
   }
 }
 
+// The subquery gets a context of its own, its columns can still refer to the
+// tables of the enclosing query
+void BindNodeVisitor::Visit(expression::SubqueryExpression *expr) {
+  expr->GetSubSelect()->Accept(this);
+}
+
 }  // namespace binder
 }  // namespace peloton
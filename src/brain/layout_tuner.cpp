@@ -19,6 +19,7 @@
 #include "catalog/schema.h"
 #include "common/logger.h"
 #include "common/timer.h"
+#include "settings/settings_manager.h"
 #include "storage/data_table.h"
 
 namespace peloton {
@@ -156,12 +157,25 @@ void LayoutTuner::Tune() {
   while (layout_tuning_stop == false) {
     // Go over all tables
     for (auto table : tables) {
-      // Transform
+      // Visit the tile groups round-robin so that every cold tile group is
+      // eventually rewritten into the default layout or merged if sparse
       auto tile_group_count = table->GetTileGroupCount();
-      auto tile_group_offset = rand() % tile_group_count;
-
-      LOG_TRACE("Transforming tile group at offset: %lu", tile_group_offset);
-      table->TransformTileGroup(tile_group_offset, theta);
+      auto &tile_group_offset = tile_group_cursors[table];
+      if (tile_group_offset >= tile_group_count) {
+        tile_group_offset = 0;
+      }
+
+      LOG_TRACE("Reorganizing tile group at offset: %u", tile_group_offset);
+      table->ReorganizeTileGroup(tile_group_offset, theta,
+                                 compaction_threshold, cold_period);
+
+      // Compress tile groups that have gone quiet
+      auto freeze_period = settings::SettingsManager::GetInt(
+          settings::SettingId::tile_group_freeze_period);
+      if (freeze_period > 0) {
+        table->FreezeTileGroup(tile_group_offset, freeze_period * 1000);
+      }
+      tile_group_offset++;
 
       // Update partitioning periodically
       UpdateDefaultPartition(table);
@@ -195,6 +209,7 @@ void LayoutTuner::ClearTables() {
   {
     std::lock_guard<std::mutex> lock(layout_tuner_mutex);
     tables.clear();
+    tile_group_cursors.clear();
   }
 }
 
@@ -38,12 +38,18 @@ void Manager::AddTileGroup(const oid_t oid,
                            std::shared_ptr<storage::TileGroup> location) {
 
   // add/update the catalog reference to the tile group
+  if (tile_group_locator_.Find(oid) == nullptr) {
+    tile_group_count_++;
+  }
   tile_group_locator_.Update(oid, location);
 }
 
 void Manager::DropTileGroup(const oid_t oid) {
   
   // drop the catalog reference to the tile group
+  if (tile_group_locator_.Find(oid) != nullptr) {
+    tile_group_count_--;
+  }
   tile_group_locator_.Erase(oid, empty_tile_group_);
 }
 
@@ -59,6 +65,7 @@ std::shared_ptr<storage::TileGroup> Manager::GetTileGroup(const oid_t oid) {
 void Manager::ClearTileGroup() {
 
   tile_group_locator_.Clear(empty_tile_group_);
+  tile_group_count_ = 0;
 }
 
 
@@ -16,6 +16,7 @@
 #include "codegen/proxy/catalog_proxy.h"
 #include "codegen/proxy/transaction_proxy.h"
 #include "codegen/proxy/executor_context_proxy.h"
+#include "codegen/proxy/runtime_functions_proxy.h"
 #include "common/logger.h"
 #include "common/timer.h"
 
@@ -24,10 +25,12 @@ namespace codegen {
 
 // Constructor
 CompilationContext::CompilationContext(Query &query,
-                                       QueryResultConsumer &result_consumer)
+                                       QueryResultConsumer &result_consumer,
+                                       bool profile_operators)
     : query_(query),
       result_consumer_(result_consumer),
-      codegen_(query_.GetCodeContext()) {
+      codegen_(query_.GetCodeContext()),
+      profile_operators_(profile_operators) {
   // Allocate a catalog and transaction instance in the runtime state
   auto &runtime_state = GetRuntimeState();
 
@@ -42,6 +45,11 @@ CompilationContext::CompilationContext(Query &query,
   executor_context_state_id_ =
       runtime_state.RegisterState("executorContext", executor_context_type);
 
+  if (profile_operators_) {
+    row_counters_state_id_ = runtime_state.RegisterState(
+        "operatorRowCounters", codegen_.Int64Type()->getPointerTo());
+  }
+
   // Let the query consumer modify the runtime state object
   result_consumer_.Prepare(*this);
 }
@@ -75,6 +83,14 @@ void CompilationContext::GeneratePlan(QueryCompiler::CompileStats *stats) {
   // First we prepare the translators for all the operators in the tree
   Prepare(query_.GetPlan(), main_pipeline_);
 
+  // Give every operator a row counter if the query is profiled
+  if (profile_operators_) {
+    for (auto &iter : op_translators_) {
+      row_counter_ids_[iter.second.get()] =
+          query_.AddProfiledOperator(*iter.first);
+    }
+  }
+
   if (stats != nullptr) {
     timer.Stop();
     stats->setup_ms = timer.GetDuration();
@@ -153,6 +169,17 @@ llvm::Function *CompilationContext::GenerateInitFunction() {
       codegen_.VoidType(),
       {{"runtimeState", runtime_state.FinalizeType(codegen_)->getPointerTo()}}};
 
+  // Fetch the row counters of the operators from the query profile
+  if (profile_operators_) {
+    auto *row_counters = codegen_.Call(
+        RuntimeFunctionsProxy::GetOperatorRowCounters,
+        {GetExecutorContextPtr(),
+         codegen_.Const32(static_cast<uint32_t>(row_counter_ids_.size()))});
+    codegen_->CreateStore(
+        row_counters,
+        runtime_state.LoadStatePtr(codegen_, row_counters_state_id_));
+  }
+
   // Let the consumer initialize
   result_consumer_.InitializeState(*this);
 
@@ -225,6 +252,25 @@ llvm::Function *CompilationContext::GenerateTearDownFunction() {
   return function_builder.GetFunction();
 }
 
+// Bump the row counter of the given operator
+void CompilationContext::CountOperatorRows(const OperatorTranslator *translator,
+                                           llvm::Value *num_rows) {
+  if (!profile_operators_) {
+    return;
+  }
+
+  auto iter = row_counter_ids_.find(translator);
+  PL_ASSERT(iter != row_counter_ids_.end());
+
+  auto *row_counters =
+      GetRuntimeState().LoadStateValue(codegen_, row_counters_state_id_);
+  auto *row_counter = codegen_->CreateConstInBoundsGEP1_32(
+      codegen_.Int64Type(), row_counters, iter->second);
+  codegen_->CreateStore(
+      codegen_->CreateAdd(codegen_->CreateLoad(row_counter), num_rows),
+      row_counter);
+}
+
 // Get the registered translator for the given expression
 ExpressionTranslator *CompilationContext::GetTranslator(
     const expression::AbstractExpression &exp) const {
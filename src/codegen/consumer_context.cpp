@@ -24,6 +24,15 @@ ConsumerContext::ConsumerContext(CompilationContext &compilation_context,
 
 // Pass the row batch to the next operator in the pipeline
 void ConsumerContext::Consume(RowBatch &batch) {
+  // The operator at the current step in the pipeline produced the batch
+  if (compilation_context_.IsProfilingOperators()) {
+    auto &codegen = GetCodeGen();
+    compilation_context_.CountOperatorRows(
+        pipeline_.GetCurrentStep(),
+        codegen->CreateZExt(batch.GetNumValidRows(codegen),
+                            codegen.Int64Type()));
+  }
+
   auto *translator = pipeline_.NextStep();
   if (translator == nullptr) {
     // We're at the end of the query pipeline, we now send the output tuples
@@ -42,6 +51,10 @@ void ConsumerContext::Consume(RowBatch &batch) {
 
 // Pass this row to the next operator in the pipeline
 void ConsumerContext::Consume(RowBatch::Row &row) {
+  // The operator at the current step in the pipeline produced the row
+  compilation_context_.CountOperatorRows(pipeline_.GetCurrentStep(),
+                                         GetCodeGen().Const64(1));
+
   // If we're at a stage boundary in the pipeline, it means the next operator
   // in the pipeline wants to operate on a batch of rows. To facilitate this,
   // we mark the given row as valid in this batch and return immediately.
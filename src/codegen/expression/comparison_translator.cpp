@@ -12,6 +12,14 @@
 
 #include "codegen/expression/comparison_translator.h"
 
+#include "codegen/proxy/in_list_set_proxy.h"
+#include "codegen/proxy/like_pattern_proxy.h"
+#include "codegen/type/bigint_type.h"
+#include "codegen/type/boolean_type.h"
+#include "codegen/type/integer_type.h"
+#include "codegen/type/smallint_type.h"
+#include "codegen/type/tinyint_type.h"
+#include "codegen/type/varchar_type.h"
 #include "expression/comparison_expression.h"
 
 namespace peloton {
@@ -22,7 +30,67 @@ ComparisonTranslator::ComparisonTranslator(
     const expression::ComparisonExpression &comparison,
     CompilationContext &context)
     : ExpressionTranslator(comparison, context) {
-  PL_ASSERT(comparison.GetChildrenSize() == 2);
+  PL_ASSERT(comparison.GetChildrenSize() == 2 ||
+            (comparison.GetExpressionType() == ExpressionType::COMPARE_IN &&
+             comparison.GetChildrenSize() > 1));
+}
+
+// Negate a boolean, keeping it NULL if it is
+static codegen::Value Negate(CodeGen &codegen, const codegen::Value &val) {
+  llvm::Value *null = val.IsNullable() ? val.IsNull(codegen) : nullptr;
+  return codegen::Value{val.GetType(), codegen->CreateNot(val.GetValue()),
+                        nullptr, null};
+}
+
+// IN lists with more constants than this are probed through their compiled
+// set instead of being compared one constant after the other
+static const size_t kInListSetMinSize = 8;
+
+static bool IsInteger(const type::SqlType &sql_type) {
+  return sql_type == type::TinyInt::Instance() ||
+         sql_type == type::SmallInt::Instance() ||
+         sql_type == type::Integer::Instance() ||
+         sql_type == type::BigInt::Instance();
+}
+
+// Probe the compiled set of an IN list, or return nullptr if the value is
+// not of the type of all of its constants. The set lives in the plan, so we
+// can pass its address directly.
+static llvm::Value *ProbeInListSet(CodeGen &codegen,
+                                   const function::InListSet &in_list_set,
+                                   const codegen::Value &val) {
+  const auto &sql_type = val.GetType().GetSqlType();
+  llvm::Value *set_ptr = codegen->CreateIntToPtr(
+      codegen.Const64((int64_t)&in_list_set),
+      InListSetProxy::GetType(codegen)->getPointerTo());
+  if (in_list_set.IsAllIntegers() && IsInteger(sql_type)) {
+    llvm::Value *integer =
+        codegen->CreateSExt(val.GetValue(), codegen.Int64Type());
+    return codegen.Call(InListSetProxy::ContainsInteger, {set_ptr, integer});
+  }
+  if (in_list_set.IsAllStrings() && sql_type == type::Varchar::Instance()) {
+    return codegen.Call(InListSetProxy::ContainsString,
+                        {set_ptr, val.GetValue(), val.GetLength()});
+  }
+  return nullptr;
+}
+
+// Match a varchar against the compiled pattern of a constant LIKE, so the
+// pattern is not classified again for every row. Like the IN set, the
+// pattern lives in the plan.
+static codegen::Value MatchLikePattern(CodeGen &codegen,
+                                       const function::LikePattern &pattern,
+                                       const codegen::Value &val) {
+  llvm::Value *pattern_ptr = codegen->CreateIntToPtr(
+      codegen.Const64((int64_t)&pattern),
+      LikePatternProxy::GetType(codegen)->getPointerTo());
+  llvm::Value *match =
+      codegen.Call(LikePatternProxy::MatchString,
+                   {pattern_ptr, val.GetValue(), val.GetLength()});
+  llvm::Value *null = val.IsNullable() ? val.IsNull(codegen) : nullptr;
+  return codegen::Value{type::Type{type::Boolean::Instance(),
+                                   null != nullptr},
+                        match, nullptr, null};
 }
 
 // Produce the result of performing the comparison of left and right values
@@ -31,8 +99,53 @@ codegen::Value ComparisonTranslator::DeriveValue(CodeGen &codegen,
   const auto &comparison = GetExpressionAs<expression::ComparisonExpression>();
 
   codegen::Value left = row.DeriveValue(codegen, *comparison.GetChild(0));
+
+  // A long constant IN list is a lookup in its set. A NULL on the left, or a
+  // miss in a list with a NULL, is NULL.
+  const auto *in_list_set = comparison.GetInListSet();
+  if (in_list_set != nullptr &&
+      comparison.GetChildrenSize() - 1 > kInListSetMinSize) {
+    llvm::Value *found = ProbeInListSet(codegen, *in_list_set, left);
+    if (found != nullptr) {
+      llvm::Value *null = nullptr;
+      if (left.IsNullable()) {
+        null = left.IsNull(codegen);
+      }
+      if (in_list_set->HasNull()) {
+        llvm::Value *missed = codegen->CreateNot(found);
+        null = null != nullptr ? codegen->CreateOr(null, missed) : missed;
+      }
+      return codegen::Value{type::Type{type::Boolean::Instance(),
+                                       null != nullptr},
+                            found, nullptr, null};
+    }
+  }
+
+  // A LIKE against a constant pattern matches with the pattern compiled
+  // with the plan
+  const auto *like_pattern = comparison.GetLikePattern();
+  if (like_pattern != nullptr &&
+      left.GetType().GetSqlType() == type::Varchar::Instance()) {
+    codegen::Value match = MatchLikePattern(codegen, *like_pattern, left);
+    if (comparison.GetExpressionType() == ExpressionType::COMPARE_NOTLIKE) {
+      return Negate(codegen, match);
+    }
+    return match;
+  }
+
   codegen::Value right = row.DeriveValue(codegen, *comparison.GetChild(1));
 
+  // A short IN list is a disjunction of equalities, which LLVM turns into a
+  // switch for integers
+  if (comparison.GetExpressionType() == ExpressionType::COMPARE_IN) {
+    codegen::Value result = left.CompareEq(codegen, right);
+    for (size_t i = 2; i < comparison.GetChildrenSize(); i++) {
+      codegen::Value item = row.DeriveValue(codegen, *comparison.GetChild(i));
+      result = result.LogicalOr(codegen, left.CompareEq(codegen, item));
+    }
+    return result;
+  }
+
   switch (comparison.GetExpressionType()) {
     case ExpressionType::COMPARE_EQUAL:
       return left.CompareEq(codegen, right);
@@ -46,6 +159,15 @@ codegen::Value ComparisonTranslator::DeriveValue(CodeGen &codegen,
       return left.CompareGt(codegen, right);
     case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
       return left.CompareGte(codegen, right);
+    case ExpressionType::COMPARE_LIKE:
+      return left.CallBinaryOp(codegen, OperatorId::Like, right,
+                               OnError::Exception);
+    case ExpressionType::COMPARE_NOTLIKE:
+      return Negate(codegen, left.CallBinaryOp(codegen, OperatorId::Like,
+                                               right, OnError::Exception));
+    case ExpressionType::COMPARE_ILIKE:
+      return left.CallBinaryOp(codegen, OperatorId::ILike, right,
+                               OnError::Exception);
     default: {
       throw Exception{"Invalid expression type for translation " +
                       ExpressionTypeToString(comparison.GetExpressionType())};
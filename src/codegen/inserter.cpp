@@ -37,6 +37,7 @@ char *Inserter::ReserveTupleStorage() {
 
   // Get tuple storage area
   auto tile_group = table_->GetTileGroupById(location_.block);
+  PL_ASSERT(tile_group->IsFrozen() == false);
   tile_ = tile_group->GetTileReference(0);
   return tile_->GetTupleLocation(location_.offset);
 }
@@ -50,8 +51,11 @@ void Inserter::InsertReserved() {
   PL_ASSERT(txn_ && table_ && executor_context_ && tile_);
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
 
-  ContainerTuple<storage::TileGroup> tuple(
-      table_->GetTileGroupById(location_.block).get(), location_.offset);
+  auto tile_group = table_->GetTileGroupById(location_.block);
+  ContainerTuple<storage::TileGroup> tuple(tile_group.get(), location_.offset);
+
+  // The generated code wrote the tuple directly into the tile
+  tile_group->UpdateZoneMap(location_.offset);
   ItemPointer *index_entry_ptr = nullptr;
   bool result = table_->InsertTuple(&tuple, location_, txn_, &index_entry_ptr);
   if (result == false) {
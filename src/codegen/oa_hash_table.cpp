@@ -17,6 +17,7 @@
 #include "codegen/hash.h"
 #include "codegen/lang/if.h"
 #include "codegen/lang/loop.h"
+#include "codegen/proxy/executor_context_proxy.h"
 #include "codegen/proxy/oa_hash_table_proxy.h"
 #include "codegen/lang/vectorized_loop.h"
 #include "codegen/type/integer_type.h"
@@ -399,12 +400,19 @@ void OAHashTable::TranslateProbing(
 }
 
 void OAHashTable::Init(CodeGen &codegen, llvm::Value *ht_ptr) const {
+  auto *null_exec_ctx =
+      codegen.Null(ExecutorContextProxy::GetType(codegen)->getPointerTo());
+  Init(codegen, null_exec_ctx, ht_ptr);
+}
+
+void OAHashTable::Init(CodeGen &codegen, llvm::Value *exec_ctx_ptr,
+                       llvm::Value *ht_ptr) const {
   auto *key_size = codegen.Const64(key_storage_.MaxStorageSize());
   auto *value_size = codegen.Const64(value_size_);
   auto *initial_size =
       codegen.Const64(codegen::util::OAHashTable::kDefaultInitialSize);
   codegen.Call(OAHashTableProxy::Init,
-               {ht_ptr, key_size, value_size, initial_size});
+               {ht_ptr, key_size, value_size, initial_size, exec_ctx_ptr});
 }
 
 void OAHashTable::ProbeOrInsert(CodeGen &codegen, llvm::Value *ht_ptr,
@@ -615,6 +623,26 @@ void OAHashTable::FindAll(CodeGen &codegen, llvm::Value *ht_ptr,
                    false);         // If key is missing create it in empty slot
 }
 
+void OAHashTable::FindFirst(CodeGen &codegen, llvm::Value *ht_ptr,
+                            const std::vector<codegen::Value> &key,
+                            IterateCallback &callback) const {
+  // The first value of a key always stays inlined in the HashEntry, even after
+  // further values have been moved into a KeyValueList
+  auto key_found = [&codegen, &callback, &key](llvm::Value *data_ptr) {
+    callback.ProcessEntry(codegen, key, data_ptr);
+  };
+
+  // It does not do anything for a key that is not found
+  auto key_not_found = [](llvm::Value *data_ptr) { (void)data_ptr; };
+
+  TranslateProbing(codegen, ht_ptr, nullptr, key,
+                   key_found,      // Key found then process it and break
+                   key_not_found,  // Key not found then do nothing
+                   true,           // process value
+                   true,           // process only one value
+                   false);         // If key is missing create it in empty slot
+}
+
 void OAHashTable::Destroy(CodeGen &codegen, llvm::Value *ht_ptr) const {
   codegen.Call(OAHashTableProxy::Destroy, {ht_ptr});
 }
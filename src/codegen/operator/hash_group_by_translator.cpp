@@ -103,7 +103,8 @@ HashGroupByTranslator::HashGroupByTranslator(
 
 // Initialize the hash table instance
 void HashGroupByTranslator::InitializeState() {
-  hash_table_.Init(GetCodeGen(), LoadStatePtr(hash_table_id_));
+  auto *exec_ctx_ptr = GetCompilationContext().GetExecutorContextPtr();
+  hash_table_.Init(GetCodeGen(), exec_ctx_ptr, LoadStatePtr(hash_table_id_));
 }
 
 // Produce!
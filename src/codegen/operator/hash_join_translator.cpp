@@ -13,9 +13,11 @@
 #include "codegen/operator/hash_join_translator.h"
 
 #include "codegen/expression/tuple_value_translator.h"
+#include "codegen/lang/if.h"
 #include "codegen/lang/vectorized_loop.h"
 #include "codegen/proxy/bloom_filter_proxy.h"
 #include "codegen/proxy/oa_hash_table_proxy.h"
+#include "codegen/type/sql_type.h"
 #include "expression/tuple_value_expression.h"
 #include "planner/hash_join_plan.h"
 
@@ -60,6 +62,26 @@ HashJoinTranslator::HashJoinTranslator(const planner::HashJoinPlan &join,
         "bloomfilter", BloomFilterProxy::GetType(codegen));
   }
 
+  // Joins that care whether a probe tuple found a partner track it in a flag
+  if (PreservesRight() || IsSemiOrAntiJoin()) {
+    probe_matched_id_ =
+        runtime_state.RegisterState("hjMatched", codegen.BoolType(), true);
+  }
+
+  // NOT IN needs to know about NULLs and emptiness of the whole build side
+  if (GetJoinPlan().IsNullAware()) {
+    build_has_rows_id_ =
+        runtime_state.RegisterState("hjBuildRows", codegen.BoolType());
+    build_has_null_key_id_ =
+        runtime_state.RegisterState("hjBuildNull", codegen.BoolType());
+  }
+
+  // Unmatched build-side tuples are sent up the tree one at a time
+  if (PreservesLeft()) {
+    output_vector_id_ = runtime_state.RegisterState(
+        "hjOutVec", codegen.ArrayType(codegen.Int32Type(), 1), true);
+  }
+
   // Prepare translators for the left and right input operators
   context.Prepare(*join_.GetChild(0), left_pipeline_);
   context.Prepare(*join_.GetChild(1)->GetChild(0), pipeline);
@@ -130,19 +152,31 @@ HashJoinTranslator::HashJoinTranslator(const planner::HashJoinPlan &join,
   }
   needs_output_vector_ = false;
 
-  // Create the hash table
-  hash_table_ =
-      OAHashTable{codegen, left_key_type, left_value_storage_.MaxStorageSize()};
+  // Create the hash table. Joins that emit unmatched build-side tuples store a
+  // one-byte match flag after the values of every entry.
+  uint64_t value_size = left_value_storage_.MaxStorageSize();
+  if (PreservesLeft()) {
+    value_size += sizeof(uint8_t);
+  }
+  hash_table_ = OAHashTable{codegen, left_key_type, value_size};
   LOG_DEBUG("Finished constructing HashJoinTranslator ...");
 }
 
 // Initialize the hash-table instance
 void HashJoinTranslator::InitializeState() {
-  hash_table_.Init(GetCodeGen(), LoadStatePtr(hash_table_id_));
+  auto *exec_ctx_ptr = GetCompilationContext().GetExecutorContextPtr();
+  hash_table_.Init(GetCodeGen(), exec_ctx_ptr, LoadStatePtr(hash_table_id_));
   if (GetJoinPlan().IsBloomFilterEnabled()) {
     bloom_filter_.Init(GetCodeGen(), LoadStatePtr(bloom_filter_id_),
                        EstimateCardinalityLeft());
   }
+  if (GetJoinPlan().IsNullAware()) {
+    auto &codegen = GetCodeGen();
+    codegen->CreateStore(codegen.ConstBool(false),
+                         LoadStatePtr(build_has_rows_id_));
+    codegen->CreateStore(codegen.ConstBool(false),
+                         LoadStatePtr(build_has_null_key_id_));
+  }
 }
 
 // Produce!
@@ -153,6 +187,12 @@ void HashJoinTranslator::Produce() const {
   // Let the right child produce tuples, which we use to probe the hash table
   GetCompilationContext().Produce(*join_.GetChild(1)->GetChild(0));
 
+  // Build-side tuples without a partner are only known once the probe side has
+  // been exhausted
+  if (PreservesLeft()) {
+    ProduceUnmatchedLeft();
+  }
+
   // That's it, we've produced all the tuples
 }
 
@@ -275,7 +315,7 @@ void HashJoinTranslator::ConsumeFromLeft(ConsumerContext &,
   }
 
   // Insert tuples from the left side into the hash table
-  InsertLeft insert_left{left_value_storage_, vals};
+  InsertLeft insert_left{left_value_storage_, vals, PreservesLeft()};
   hash_table_.Insert(codegen, LoadStatePtr(hash_table_id_), hash, key,
                      insert_left);
 
@@ -283,6 +323,16 @@ void HashJoinTranslator::ConsumeFromLeft(ConsumerContext &,
     // Insert tuples into the bloom filter if enabled
     bloom_filter_.Add(codegen, LoadStatePtr(bloom_filter_id_), key);
   }
+
+  if (GetJoinPlan().IsNullAware()) {
+    codegen->CreateStore(codegen.ConstBool(true),
+                         LoadStatePtr(build_has_rows_id_));
+    llvm::Value *has_null_key = LoadStateValue(build_has_null_key_id_);
+    for (const auto &key_val : key) {
+      has_null_key = codegen->CreateOr(has_null_key, key_val.IsNull(codegen));
+    }
+    codegen->CreateStore(has_null_key, LoadStatePtr(build_has_null_key_id_));
+  }
 }
 
 // The given row is from the right child. Probe hash-table.
@@ -292,7 +342,12 @@ void HashJoinTranslator::ConsumeFromRight(ConsumerContext &context,
   std::vector<codegen::Value> key;
   CollectKeys(row, right_key_exprs_, key);
 
-  if (GetJoinPlan().IsBloomFilterEnabled()) {
+  // Probe rows without a partner still produce output in RIGHT, OUTER and
+  // ANTI joins, so they can't be discarded by the bloom filter
+  bool can_prefilter = !PreservesRight() &&
+                       GetJoinPlan().GetJoinType() != JoinType::ANTI;
+
+  if (GetJoinPlan().IsBloomFilterEnabled() && can_prefilter) {
     // Prefilter the tuple using Bloom Filter
     llvm::Value *contains = bloom_filter_.Contains(
         GetCodeGen(), LoadStatePtr(bloom_filter_id_), key);
@@ -313,14 +368,133 @@ void HashJoinTranslator::ConsumeFromRight(ConsumerContext &context,
 void HashJoinTranslator::CodegenHashProbe(
     ConsumerContext &context, RowBatch::Row &row,
     std::vector<codegen::Value> &key) const {
-  if (GetJoinPlan().GetJoinType() == JoinType::INNER) {
-    // For inner joins, find all join partners
-    ProbeRight probe_right{*this, context, row, key};
-    hash_table_.FindAll(GetCodeGen(), LoadStatePtr(hash_table_id_), key,
-                        probe_right);
+  auto &codegen = GetCodeGen();
+  llvm::Value *hash_table = LoadStatePtr(hash_table_id_);
+
+  switch (GetJoinPlan().GetJoinType()) {
+    case JoinType::INNER:
+    case JoinType::LEFT: {
+      // Find all join partners. LEFT joins flag the build-side tuples that
+      // were matched and emit the rest after probing.
+      ProbeRight probe_right{*this, context, row, key};
+      hash_table_.FindAll(codegen, hash_table, key, probe_right);
+      break;
+    }
+    case JoinType::RIGHT:
+    case JoinType::OUTER: {
+      // Values derived while processing a match only exist inside the probe
+      // loop, so the NULL-padded row is built from a copy taken beforehand
+      RowBatch::Row unmatched_row = row;
+
+      llvm::Value *matched = LoadStateValue(probe_matched_id_);
+      codegen->CreateStore(codegen.ConstBool(false), matched);
+
+      ProbeRight probe_right{*this, context, row, key, matched};
+      hash_table_.FindAll(codegen, hash_table, key, probe_right);
+
+      llvm::Value *no_match = codegen->CreateNot(codegen->CreateLoad(matched));
+      lang::If is_unmatched{codegen, no_match};
+      {
+        RegisterNullLeftAttributes(codegen, unmatched_row);
+
+        // The matches above already walked the pipeline
+        GetPipeline().MoveTo(this);
+        context.Consume(unmatched_row);
+      }
+      is_unmatched.EndIf();
+      break;
+    }
+    case JoinType::SEMI:
+    case JoinType::ANTI: {
+      // The predicate is evaluated on a copy so the probe row itself only
+      // carries its own attributes when it is sent up the pipeline
+      RowBatch::Row probe_row = row;
+
+      llvm::Value *matched = LoadStateValue(probe_matched_id_);
+      codegen->CreateStore(codegen.ConstBool(false), matched);
+
+      ProbeRight probe_right{*this, context, probe_row, key, matched};
+      if (GetJoinPlan().GetPredicate() == nullptr) {
+        // Without a predicate any entry with an equal key is a partner, so
+        // stop probing at the first one
+        hash_table_.FindFirst(codegen, hash_table, key, probe_right);
+      } else {
+        hash_table_.FindAll(codegen, hash_table, key, probe_right);
+      }
+
+      // A NULL key equals nothing, not even another NULL
+      llvm::Value *probe_key_null = codegen.ConstBool(false);
+      for (const auto &key_val : key) {
+        probe_key_null =
+            codegen->CreateOr(probe_key_null, key_val.IsNull(codegen));
+      }
+      llvm::Value *emit = codegen->CreateAnd(
+          codegen->CreateLoad(matched), codegen->CreateNot(probe_key_null));
+      if (GetJoinPlan().GetJoinType() == JoinType::ANTI) {
+        emit = codegen->CreateNot(emit);
+      }
+      if (GetJoinPlan().IsNullAware()) {
+        // x NOT IN (...) is NULL, not true, once the list has a NULL, and so
+        // is NULL NOT IN (...) unless the list is empty
+        llvm::Value *null_free = codegen->CreateNot(codegen->CreateOr(
+            LoadStateValue(build_has_null_key_id_), probe_key_null));
+        emit = codegen->CreateOr(
+            codegen->CreateNot(LoadStateValue(build_has_rows_id_)),
+            codegen->CreateAnd(emit, null_free));
+      }
+      lang::If should_emit{codegen, emit};
+      {
+        // Send the row up to the parent
+        context.Consume(row);
+      }
+      should_emit.EndIf();
+      break;
+    }
+    default: {
+      throw Exception{"Unsupported join type: " +
+                      JoinTypeToString(GetJoinPlan().GetJoinType())};
+    }
+  }
+}
+
+// Iterate over the hash table and send all the build-side tuples that were
+// never matched during the probe phase up the pipeline
+void HashJoinTranslator::ProduceUnmatchedLeft() const {
+  ProduceUnmatched producer{*this};
+  hash_table_.Iterate(GetCodeGen(), LoadStatePtr(hash_table_id_), producer);
+}
+
+void HashJoinTranslator::RegisterNullLeftAttributes(CodeGen &codegen,
+                                                    RowBatch::Row &row) const {
+  for (const auto *left_val_ai : left_val_ais_) {
+    auto null_val = left_val_ai->type.GetSqlType().GetNullValue(codegen);
+    row.RegisterAttributeValue(left_val_ai, null_val);
+  }
+  for (const auto *exp : left_key_exprs_) {
+    if (exp->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+      auto *tve = static_cast<const expression::TupleValueExpression *>(exp);
+      const auto *ai = tve->GetAttributeRef();
+      auto null_val = ai->type.GetSqlType().GetNullValue(codegen);
+      row.RegisterAttributeValue(ai, null_val);
+    }
   }
 }
 
+bool HashJoinTranslator::PreservesLeft() const {
+  auto join_type = GetJoinPlan().GetJoinType();
+  return join_type == JoinType::LEFT || join_type == JoinType::OUTER;
+}
+
+bool HashJoinTranslator::PreservesRight() const {
+  auto join_type = GetJoinPlan().GetJoinType();
+  return join_type == JoinType::RIGHT || join_type == JoinType::OUTER;
+}
+
+bool HashJoinTranslator::IsSemiOrAntiJoin() const {
+  auto join_type = GetJoinPlan().GetJoinType();
+  return join_type == JoinType::SEMI || join_type == JoinType::ANTI;
+}
+
 // Cleanup by destroying the hash-table instance
 void HashJoinTranslator::TearDownState() {
   auto &codegen = GetCodeGen();
@@ -354,6 +528,10 @@ std::string HashJoinTranslator::GetName() const {
       name.append("Semi");
       break;
     }
+    case JoinType::ANTI: {
+      name.append("Anti");
+      break;
+    }
     case JoinType::INVALID:
       throw Exception{"Invalid join type"};
   }
@@ -403,11 +581,13 @@ void HashJoinTranslator::CollectValues(
 
 HashJoinTranslator::ProbeRight::ProbeRight(
     const HashJoinTranslator &join_translator, ConsumerContext &context,
-    RowBatch::Row &row, const std::vector<codegen::Value> &right_key)
+    RowBatch::Row &row, const std::vector<codegen::Value> &right_key,
+    llvm::Value *matched)
     : join_translator_(join_translator),
       context_(context),
       row_(row),
-      right_key_(right_key) {}
+      right_key_(right_key),
+      matched_(matched) {}
 
 // The callback invoked when iterating the hash table.  The key and value of
 // the current hash table entry are provided as parameters.  We add these to
@@ -415,15 +595,36 @@ HashJoinTranslator::ProbeRight::ProbeRight(
 void HashJoinTranslator::ProbeRight::ProcessEntry(
     CodeGen &codegen, const std::vector<codegen::Value> &key,
     llvm::Value *data_area) const {
+  if (join_translator_.IsSemiOrAntiJoin()) {
+    // Once a partner has been found the remaining entries cannot change the
+    // outcome of a SEMI or ANTI join, so skip evaluating the predicate
+    llvm::Value *matched = codegen->CreateLoad(matched_);
+    lang::If not_yet_matched{codegen, codegen->CreateNot(matched),
+                             "notYetMatched"};
+    {
+      ProcessMatch(codegen, key, data_area);
+    }
+    not_yet_matched.EndIf();
+  } else {
+    ProcessMatch(codegen, key, data_area);
+  }
+}
+
+void HashJoinTranslator::ProbeRight::ProcessMatch(
+    CodeGen &codegen, const std::vector<codegen::Value> &key,
+    llvm::Value *data_area) const {
   const auto &storage = join_translator_.left_value_storage_;
 
+  // Points to the build-side match flag, if the entries have one
+  llvm::Value *left_matched = nullptr;
+
   if (join_translator_.needs_output_vector_) {
     // Use output vector for attribute access
     throw Exception{"Shouldn't need output"};
   } else {
     // LoadValues all the values from the hash entry
     std::vector<codegen::Value> left_vals;
-    storage.LoadValues(codegen, data_area, left_vals);
+    left_matched = storage.LoadValues(codegen, data_area, left_vals);
 
     // Put the values directly into the row
     const auto &left_val_ais = join_translator_.left_val_ais_;
@@ -444,6 +645,20 @@ void HashJoinTranslator::ProbeRight::ProcessEntry(
     }
   }
 
+  // Record the match and, unless this join only filters the probe side, send
+  // the joined row up to the parent
+  auto on_match = [&]() {
+    if (matched_ != nullptr) {
+      codegen->CreateStore(codegen.ConstBool(true), matched_);
+    }
+    if (join_translator_.PreservesLeft()) {
+      codegen->CreateStore(codegen.Const8(1), left_matched);
+    }
+    if (!join_translator_.IsSemiOrAntiJoin()) {
+      context_.Consume(row_);
+    }
+  };
+
   // Check predicate if one exists
   auto *predicate = join_translator_.GetJoinPlan().GetPredicate();
   if (predicate != nullptr) {
@@ -451,33 +666,114 @@ void HashJoinTranslator::ProbeRight::ProcessEntry(
     auto valid_row = row_.DeriveValue(codegen, *predicate);
     lang::If is_valid_row{codegen, valid_row};
     {
-      // Send row up to the parent
-      context_.Consume(row_);
+      on_match();
     }
     is_valid_row.EndIf();
   } else {
-    // Send the row up to the parent
-    context_.Consume(row_);
+    on_match();
   }
 }
 
+//===----------------------------------------------------------------------===//
+// PRODUCE UNMATCHED
+//===----------------------------------------------------------------------===//
+
+HashJoinTranslator::ProduceUnmatched::ProduceUnmatched(
+    const HashJoinTranslator &join_translator)
+    : join_translator_(join_translator) {}
+
+// The callback invoked for every entry in the hash table after the probe phase.
+// Entries whose match flag was never set are padded with NULLs for the probe
+// side and sent up the tree in a batch of one row.
+void HashJoinTranslator::ProduceUnmatched::ProcessEntry(
+    CodeGen &codegen, const std::vector<codegen::Value> &key,
+    llvm::Value *data_area) const {
+  const auto &storage = join_translator_.left_value_storage_;
+
+  std::vector<codegen::Value> left_vals;
+  llvm::Value *left_matched = storage.LoadValues(codegen, data_area, left_vals);
+
+  llvm::Value *is_unmatched = codegen->CreateICmpEQ(
+      codegen->CreateLoad(left_matched), codegen.Const8(0));
+  lang::If unmatched{codegen, is_unmatched, "unmatched"};
+  {
+    // Collect the values of every attribute the join produces
+    std::vector<const planner::AttributeInfo *> ais;
+    std::vector<codegen::Value> vals;
+
+    const auto &left_val_ais = join_translator_.left_val_ais_;
+    for (uint32_t i = 0; i < left_val_ais.size(); i++) {
+      ais.push_back(left_val_ais[i]);
+      vals.push_back(left_vals[i]);
+    }
+
+    const auto &left_key_exprs = join_translator_.left_key_exprs_;
+    for (uint32_t i = 0; i < left_key_exprs.size(); i++) {
+      const auto *exp = left_key_exprs[i];
+      if (exp->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+        auto *tve = static_cast<const expression::TupleValueExpression *>(exp);
+        ais.push_back(tve->GetAttributeRef());
+        vals.push_back(key[i]);
+      }
+    }
+
+    for (const auto *right_ai :
+         join_translator_.GetJoinPlan().GetRightAttributes()) {
+      ais.push_back(right_ai);
+      vals.push_back(right_ai->type.GetSqlType().GetNullValue(codegen));
+    }
+
+    std::vector<ValueAccess> accessors;
+    for (uint32_t i = 0; i < vals.size(); i++) {
+      accessors.emplace_back(vals, i);
+    }
+
+    // Create a row-batch of one row, place all the attributes into the row
+    llvm::Value *output_vector =
+        join_translator_.LoadStateValue(join_translator_.output_vector_id_);
+    Vector v{output_vector, 1, codegen.Int32Type()};
+    RowBatch batch{join_translator_.GetCompilationContext(),
+                   codegen.Const32(0), codegen.Const32(1), v, false};
+    for (uint32_t i = 0; i < ais.size(); i++) {
+      batch.AddAttribute(ais[i], &accessors[i]);
+    }
+
+    // Start walking up the pipeline from the join again
+    auto &pipeline = join_translator_.GetPipeline();
+    pipeline.MoveTo(&join_translator_);
+    ConsumerContext context{join_translator_.GetCompilationContext(),
+                            pipeline};
+    context.Consume(batch);
+  }
+  unmatched.EndIf();
+}
+
 //===----------------------------------------------------------------------===//
 // INSERT LEFT
 //===----------------------------------------------------------------------===//
 
 HashJoinTranslator::InsertLeft::InsertLeft(
-    const CompactStorage &storage, const std::vector<codegen::Value> &values)
-    : storage_(storage), values_(values) {}
+    const CompactStorage &storage, const std::vector<codegen::Value> &values,
+    bool track_matches)
+    : storage_(storage), values_(values), track_matches_(track_matches) {}
 
 // Store the attributes from the left-side input into the provided storage space
 void HashJoinTranslator::InsertLeft::StoreValue(CodeGen &codegen,
                                                 llvm::Value *space) const {
-  storage_.StoreValues(codegen, space, values_);
+  llvm::Value *end = storage_.StoreValues(codegen, space, values_);
+  if (track_matches_) {
+    // Nothing has matched this tuple yet
+    codegen->CreateStore(codegen.Const8(0), end);
+  }
 }
 
 llvm::Value *HashJoinTranslator::InsertLeft::GetValueSize(
     CodeGen &codegen) const {
-  return codegen.Const32(storage_.MaxStorageSize());
+  uint64_t size = storage_.MaxStorageSize();
+  if (track_matches_) {
+    size += sizeof(uint8_t);
+  }
+  return codegen.Const32(size);
 }
 
 }  // namespace codegen
@@ -59,7 +59,8 @@ HashTranslator::HashTranslator(const planner::HashPlan &hash_plan,
 
 // Initialize the hash table instance
 void HashTranslator::InitializeState() {
-  hash_table_.Init(GetCodeGen(), LoadStatePtr(hash_table_id_));
+  auto *exec_ctx_ptr = GetCompilationContext().GetExecutorContextPtr();
+  hash_table_.Init(GetCodeGen(), exec_ctx_ptr, LoadStatePtr(hash_table_id_));
 }
 
 // Produce!
@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// limit_translator.cpp
+//
+// Identification: src/codegen/operator/limit_translator.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/operator/limit_translator.h"
+
+#include "codegen/lang/if.h"
+#include "planner/limit_plan.h"
+
+namespace peloton {
+namespace codegen {
+
+LimitTranslator::LimitTranslator(const planner::LimitPlan &plan,
+                                 CompilationContext &context,
+                                 Pipeline &pipeline)
+    : OperatorTranslator(context, pipeline), plan_(plan) {
+  // Prepare translator for our child
+  context.Prepare(*plan_.GetChild(0), pipeline);
+
+  // The row count lives across all invocations of the pipeline
+  auto &codegen = GetCodeGen();
+  row_count_id_ = context.GetRuntimeState().RegisterState(
+      "limitCount", codegen.Int64Type());
+}
+
+void LimitTranslator::InitializeState() {
+  auto &codegen = GetCodeGen();
+  codegen->CreateStore(codegen.Const64(0), LoadStatePtr(row_count_id_));
+}
+
+void LimitTranslator::Produce() const {
+  GetCompilationContext().Produce(*plan_.GetChild(0));
+}
+
+void LimitTranslator::Consume(ConsumerContext &context,
+                              RowBatch::Row &row) const {
+  auto &codegen = GetCodeGen();
+
+  llvm::Value *row_count_ptr = LoadStatePtr(row_count_id_);
+  llvm::Value *row_count = codegen->CreateLoad(row_count_ptr);
+  codegen->CreateStore(codegen->CreateAdd(row_count, codegen.Const64(1)),
+                       row_count_ptr);
+
+  // Skip the rows before the offset and drop the ones past the limit
+  uint64_t offset = plan_.GetOffset();
+  uint64_t end = offset + plan_.GetLimit();
+  llvm::Value *in_limit = codegen->CreateAnd(
+      codegen->CreateICmpUGE(row_count, codegen.Const64(offset)),
+      codegen->CreateICmpULT(row_count, codegen.Const64(end)));
+
+  lang::If is_in_limit{codegen, in_limit};
+  {
+    // Send the row up to the parent
+    context.Consume(row);
+  }
+  is_in_limit.EndIf();
+}
+
+std::string LimitTranslator::GetName() const { return "Limit"; }
+
+}  // namespace codegen
+}  // namespace peloton
@@ -12,6 +12,8 @@
 
 #include "codegen/operator/order_by_translator.h"
 
+#include <limits>
+
 #include "codegen/function_builder.h"
 #include "codegen/proxy/runtime_functions_proxy.h"
 #include "codegen/proxy/sorter_proxy.h"
@@ -31,7 +33,8 @@ OrderByTranslator::OrderByTranslator(const planner::OrderByPlan &plan,
                                      Pipeline &pipeline)
     : OperatorTranslator(context, pipeline),
       plan_(plan),
-      child_pipeline_(this) {
+      child_pipeline_(this),
+      key_prefix_func_(nullptr) {
   LOG_DEBUG("Constructing OrderByTranslator ...");
 
   // Prepare the child
@@ -107,9 +110,15 @@ OrderByTranslator::OrderByTranslator(const planner::OrderByPlan &plan,
   LOG_DEBUG("Finished constructing OrderByTranslator ...");
 }
 
-// Initialize the sorter instance
+// Initialize the sorter instance. If a limit was pushed into the plan, only
+// the tuples up to the end of the limit are needed.
 void OrderByTranslator::InitializeState() {
-  sorter_.Init(GetCodeGen(), LoadStatePtr(sorter_id_), compare_func_);
+  uint64_t top_k = 0;
+  if (plan_.GetLimit()) {
+    top_k = plan_.GetLimitOffset() + plan_.GetLimitNumber();
+  }
+  sorter_.Init(GetCodeGen(), LoadStatePtr(sorter_id_), compare_func_, top_k,
+               key_prefix_func_);
 }
 
 //===----------------------------------------------------------------------===//
@@ -214,6 +223,65 @@ void OrderByTranslator::DefineAuxiliaryFunctions() {
 
   // Set the function pointer
   compare_func_ = compare.GetFunction();
+
+  DefineKeyPrefixFunction();
+}
+
+//===----------------------------------------------------------------------===//
+// If the first sort key is a non-NULL integral value, every tuple gets a
+// 64-bit prefix of it whose unsigned order is the sort order of the key:
+//
+// uint64_t sortKeyPrefix(tuple) {
+//   prefix = int64(tuple.getVal(first_key)) ^ (1 << 63)
+//   return descending ? ~prefix : prefix
+// }
+//
+// The sorter orders tuples by their prefixes in its own (compiled-in) sort
+// loop and only calls the comparison function when two prefixes are equal.
+//===----------------------------------------------------------------------===//
+void OrderByTranslator::DefineKeyPrefixFunction() {
+  auto &codegen = GetCodeGen();
+  auto &storage_format = sorter_.GetStorageFormat();
+
+  uint32_t slot = sort_key_info_[0].tuple_slot;
+  const auto &key_type = sort_key_info_[0].sort_key->type;
+  switch (key_type.type_id) {
+    case peloton::type::TypeId::TINYINT:
+    case peloton::type::TypeId::SMALLINT:
+    case peloton::type::TypeId::INTEGER:
+    case peloton::type::TypeId::BIGINT:
+    case peloton::type::TypeId::DATE:
+    case peloton::type::TypeId::TIMESTAMP:
+      break;
+    default:
+      return;
+  }
+  if (key_type.nullable) {
+    return;
+  }
+
+  LOG_DEBUG("Constructing 'sortKeyPrefix' function for sort ...");
+  std::vector<std::pair<std::string, llvm::Type *>> args = {
+      {"tuple", codegen.CharPtrType()}};
+  FunctionBuilder key_prefix{codegen.GetCodeContext(), "sortKeyPrefix",
+                             codegen.Int64Type(), args};
+
+  llvm::Value *tuple = key_prefix.GetArgumentByName("tuple");
+  auto key = storage_format.GetValueSkipNull(codegen, tuple, slot);
+  llvm::Value *prefix = key.GetValue();
+  if (prefix->getType() != codegen.Int64Type()) {
+    prefix = codegen->CreateSExt(prefix, codegen.Int64Type());
+  }
+
+  // Flipping the sign bit makes the unsigned order the signed order
+  prefix = codegen->CreateXor(
+      prefix, codegen.Const64(std::numeric_limits<int64_t>::min()));
+  if (plan_.GetDescendFlags()[0]) {
+    prefix = codegen->CreateNot(prefix);
+  }
+
+  key_prefix.ReturnAndFinish(prefix);
+  key_prefix_func_ = key_prefix.GetFunction();
 }
 
 void OrderByTranslator::Produce() const {
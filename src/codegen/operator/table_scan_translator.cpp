@@ -12,6 +12,9 @@
 
 #include "codegen/operator/table_scan_translator.h"
 
+#include <set>
+#include <unordered_set>
+
 #include "codegen/lang/if.h"
 #include "codegen/proxy/catalog_proxy.h"
 #include "codegen/proxy/transaction_runtime_proxy.h"
@@ -75,9 +78,24 @@ void TableScanTranslator::Produce() const {
   Vector sel_vec{LoadStateValue(selection_vector_id_),
                  Vector::kDefaultVectorSize, codegen.Int32Type()};
 
+  // The columns the scan reads, either to output them or to filter rows
+  const auto &scan_plan = GetScanPlan();
+  std::set<oid_t> used_column_ids(scan_plan.GetColumnIds().begin(),
+                                  scan_plan.GetColumnIds().end());
+  if (scan_plan.GetPredicate() != nullptr) {
+    std::unordered_set<const planner::AttributeInfo *> used_attributes;
+    scan_plan.GetPredicate()->GetUsedAttributes(used_attributes);
+    for (const auto *ai : used_attributes) {
+      used_column_ids.insert(ai->attribute_id);
+    }
+  }
+
   // Generate the scan
   ScanConsumer scan_consumer{*this, sel_vec};
-  table_.GenerateScan(codegen, table_ptr, sel_vec.GetCapacity(), scan_consumer);
+  table_.GenerateScan(codegen, table_ptr, sel_vec.GetCapacity(), scan_consumer,
+                      scan_plan.GetZoneMapPredicates(),
+                      std::vector<oid_t>(used_column_ids.begin(),
+                                         used_column_ids.end()));
 
   LOG_DEBUG("TableScan on [%u] finished producing tuples ...", table.GetOid());
 }
@@ -68,6 +68,13 @@ const OperatorTranslator *Pipeline::NextStep() {
   }
 }
 
+// Move the current position in this pipeline to the given translator
+void Pipeline::MoveTo(const OperatorTranslator *translator) {
+  auto iter = std::find(pipeline_.begin(), pipeline_.end(), translator);
+  PL_ASSERT(iter != pipeline_.end());
+  pipeline_index_ = static_cast<uint32_t>(iter - pipeline_.begin());
+}
+
 uint32_t Pipeline::GetNumStages() const {
   return static_cast<uint32_t>(stage_boundaries_.size()) + 1;
 }
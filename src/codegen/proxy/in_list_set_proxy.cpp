@@ -0,0 +1,24 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// in_list_set_proxy.cpp
+//
+// Identification: src/codegen/proxy/in_list_set_proxy.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/proxy/in_list_set_proxy.h"
+
+namespace peloton {
+namespace codegen {
+
+DEFINE_TYPE(InListSet, "function::InListSet", MEMBER(opaque));
+
+DEFINE_METHOD(peloton::function, InListSet, ContainsInteger);
+DEFINE_METHOD(peloton::function, InListSet, ContainsString);
+
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,23 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// like_pattern_proxy.cpp
+//
+// Identification: src/codegen/proxy/like_pattern_proxy.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/proxy/like_pattern_proxy.h"
+
+namespace peloton {
+namespace codegen {
+
+DEFINE_TYPE(LikePattern, "function::LikePattern", MEMBER(opaque));
+
+DEFINE_METHOD(peloton::function, LikePattern, MatchString);
+
+}  // namespace codegen
+}  // namespace peloton
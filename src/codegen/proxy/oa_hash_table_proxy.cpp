@@ -12,6 +12,8 @@
 
 #include "codegen/proxy/oa_hash_table_proxy.h"
 
+#include "codegen/proxy/executor_context_proxy.h"
+
 namespace peloton {
 namespace codegen {
 
@@ -27,7 +29,8 @@ DEFINE_TYPE(OAHashTable, "peloton::OAHashTable", MEMBER(buckets),
             MEMBER(num_buckets), MEMBER(bucket_mask),
             MEMBER(num_occupied_buckets), MEMBER(num_entries),
             MEMBER(resize_threshold), MEMBER(entry_size), MEMBER(key_size),
-            MEMBER(value_size));
+            MEMBER(value_size), MEMBER(memory_budget),
+            MEMBER(memory_reserved));
 
 DEFINE_METHOD(peloton::codegen::util, OAHashTable, Init);
 DEFINE_METHOD(peloton::codegen::util, OAHashTable, StoreTuple);
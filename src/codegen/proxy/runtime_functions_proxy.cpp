@@ -13,6 +13,7 @@
 #include "codegen/proxy/runtime_functions_proxy.h"
 
 #include "codegen/proxy/data_table_proxy.h"
+#include "codegen/proxy/executor_context_proxy.h"
 #include "codegen/proxy/tile_group_proxy.h"
 
 namespace peloton {
@@ -21,9 +22,14 @@ namespace codegen {
 DEFINE_TYPE(ColumnLayoutInfo, "peloton::ColumnLayoutInfo",
             MEMBER(col_start_ptr), MEMBER(stride), MEMBER(columnar));
 
+DEFINE_TYPE(ZoneMapPredicate, "peloton::storage::ZoneMapPredicate",
+            MEMBER(opaque));
+
 DEFINE_METHOD(peloton::codegen, RuntimeFunctions, HashCrc64);
 DEFINE_METHOD(peloton::codegen, RuntimeFunctions, GetTileGroup);
 DEFINE_METHOD(peloton::codegen, RuntimeFunctions, GetTileGroupLayout);
+DEFINE_METHOD(peloton::codegen, RuntimeFunctions, ShouldScanTileGroup);
+DEFINE_METHOD(peloton::codegen, RuntimeFunctions, GetOperatorRowCounters);
 DEFINE_METHOD(peloton::codegen, RuntimeFunctions, ThrowDivideByZeroException);
 DEFINE_METHOD(peloton::codegen, RuntimeFunctions, ThrowOverflowException);
 
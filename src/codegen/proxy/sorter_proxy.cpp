@@ -17,7 +17,8 @@ namespace codegen {
 
 DEFINE_TYPE(Sorter, "peloton::util::Sorter", MEMBER(buffer_start),
             MEMBER(buffer_pos), MEMBER(buffer_end), MEMBER(tuple_size),
-            MEMBER(comp_fn));
+            MEMBER(comp_fn), MEMBER(prefix_fn), MEMBER(top_k),
+            MEMBER(memory_budget), MEMBER(spilled_runs));
 
 DEFINE_METHOD(peloton::codegen::util, Sorter, Init);
 DEFINE_METHOD(peloton::codegen::util, Sorter, StoreInputTuple);
@@ -19,6 +19,8 @@ namespace peloton {
 namespace codegen {
 
 DEFINE_METHOD(peloton::function, StringFunctions, Ascii);
+DEFINE_METHOD(peloton::function, StringFunctions, Like);
+DEFINE_METHOD(peloton::function, StringFunctions, ILike);
 
 }  // namespace codegen
 }  // namespace peloton
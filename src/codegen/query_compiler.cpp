@@ -27,12 +27,12 @@ QueryCompiler::QueryCompiler() : next_id_(0) {}
 // Compile the given query statement
 std::unique_ptr<Query> QueryCompiler::Compile(
     const planner::AbstractPlan &root, QueryResultConsumer &result_consumer,
-    CompileStats *stats) {
+    CompileStats *stats, bool profile_operators) {
   // The query statement we compile
   std::unique_ptr<Query> query{new Query(root)};
 
   // Set up the compilation context
-  CompilationContext context{*query, result_consumer};
+  CompilationContext context{*query, result_consumer, profile_operators};
 
   // Perform the compilation
   context.GeneratePlan(stats);
@@ -46,6 +46,7 @@ bool QueryCompiler::IsSupported(const planner::AbstractPlan &plan) {
   switch (plan.GetPlanNodeType()) {
     case PlanNodeType::SEQSCAN:
     case PlanNodeType::ORDERBY:
+    case PlanNodeType::LIMIT:
     case PlanNodeType::DELETE:
     case PlanNodeType::INSERT:
     case PlanNodeType::AGGREGATE_V2: {
@@ -68,10 +69,17 @@ bool QueryCompiler::IsSupported(const planner::AbstractPlan &plan) {
     }
     case PlanNodeType::HASHJOIN: {
       const auto &hjp = static_cast<const planner::HashJoinPlan &>(plan);
-      // Right now, only support inner joins
-      if (hjp.GetJoinType() == JoinType::INNER) {
-        break;
+      switch (hjp.GetJoinType()) {
+        case JoinType::INNER:
+        case JoinType::LEFT:
+        case JoinType::RIGHT:
+        case JoinType::OUTER:
+        case JoinType::SEMI:
+        case JoinType::ANTI:
+          break;
+        default: { return false; }
       }
+      break;
     }
     case PlanNodeType::HASH: {
       break;
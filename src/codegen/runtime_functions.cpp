@@ -16,9 +16,13 @@
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "executor/executor_context.h"
+#include "executor/query_profile.h"
+#include "storage/compressed_column.h"
 #include "storage/data_table.h"
 #include "storage/tile_group.h"
 #include "storage/tile.h"
+#include "storage/zone_map.h"
 
 namespace peloton {
 namespace codegen {
@@ -72,10 +76,33 @@ storage::TileGroup *RuntimeFunctions::GetTileGroup(storage::DataTable *table,
 // column in the provided 'infos' array.  Specifically, we need a pointer to
 // where the first value of the column can be found, and the amount of bytes
 // to skip over to find successive values of the column.
+//
+// Frozen tiles have no slots to point into. The columns the query reads are
+// decoded into a per-thread buffer, which stays valid until the thread asks
+// for the layout of the next tile group. The others are left without data.
 //===----------------------------------------------------------------------===//
 void RuntimeFunctions::GetTileGroupLayout(const storage::TileGroup *tile_group,
                                           ColumnLayoutInfo *infos,
-                                          uint32_t num_cols) {
+                                          uint32_t num_cols,
+                                          const char *used_columns) {
+  static thread_local std::vector<char> decoded_columns;
+
+  size_t decoded_size = 0;
+  for (uint32_t col_idx = 0; col_idx < num_cols; col_idx++) {
+    if (used_columns[col_idx] == 0) continue;
+    oid_t tile_offset, tile_column_offset;
+    tile_group->LocateTileAndColumn(col_idx, tile_offset, tile_column_offset);
+    auto *column = tile_group->GetTile(tile_offset)
+                       ->GetCompressedColumn(tile_column_offset);
+    if (column != nullptr) {
+      decoded_size += column->GetWidth() * column->GetCount();
+    }
+  }
+  if (decoded_columns.size() < decoded_size) {
+    decoded_columns.resize(decoded_size);
+  }
+
+  size_t decoded_offset = 0;
   for (uint32_t col_idx = 0; col_idx < num_cols; col_idx++) {
     // Map the current column to a tile and a column offset in the tile
     oid_t tile_offset, tile_column_offset;
@@ -84,6 +111,24 @@ void RuntimeFunctions::GetTileGroupLayout(const storage::TileGroup *tile_group,
     // Now grab the column information
     auto *tile = tile_group->GetTile(tile_offset);
     auto *tile_schema = tile->GetSchema();
+    auto *column = tile->GetCompressedColumn(tile_column_offset);
+    if (column != nullptr && used_columns[col_idx] == 0) {
+      infos[col_idx].column = nullptr;
+      infos[col_idx].stride = column->GetWidth();
+      infos[col_idx].is_columnar = true;
+      continue;
+    }
+    if (column != nullptr) {
+      char *decoded_column = decoded_columns.data() + decoded_offset;
+      column->DecodeAll(decoded_column);
+      decoded_offset += column->GetWidth() * column->GetCount();
+
+      infos[col_idx].column = decoded_column;
+      infos[col_idx].stride = column->GetWidth();
+      infos[col_idx].is_columnar = true;
+      continue;
+    }
+    PL_ASSERT(tile->HasUncompressedData());
     infos[col_idx].column =
         tile->GetTupleLocation(0) + tile_schema->GetOffset(tile_column_offset);
     infos[col_idx].stride = tile_schema->GetLength();
@@ -94,6 +139,27 @@ void RuntimeFunctions::GetTileGroupLayout(const storage::TileGroup *tile_group,
   }
 }
 
+//===----------------------------------------------------------------------===//
+// Check the tile group's zone map against the scan's zone map predicates. The
+// tile group only needs to be scanned if some tuple might satisfy all of them.
+//===----------------------------------------------------------------------===//
+bool RuntimeFunctions::ShouldScanTileGroup(
+    const storage::TileGroup *tile_group,
+    const storage::ZoneMapPredicate *predicates, uint32_t num_predicates) {
+  return tile_group->ShouldScan(predicates, num_predicates);
+}
+
+//===----------------------------------------------------------------------===//
+// Hand out the row counters the operators of a profiled query bump. They live
+// in the query profile of the executor context, which outlives the query.
+//===----------------------------------------------------------------------===//
+uint64_t *RuntimeFunctions::GetOperatorRowCounters(
+    executor::ExecutorContext *executor_context, uint32_t num_operators) {
+  auto *profile = executor_context->GetProfile();
+  PL_ASSERT(profile != nullptr);
+  return profile->GetRowCounters(num_operators);
+}
+
 void RuntimeFunctions::ThrowDivideByZeroException() {
   throw DivideByZeroException("ERROR: division by zero");
 }
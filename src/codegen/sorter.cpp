@@ -36,9 +36,17 @@ Sorter::Sorter(CodeGen &codegen, const std::vector<type::Type> &row_desc) {
 
 // Just make a call to util::Sorter::Init(...)
 void Sorter::Init(CodeGen &codegen, llvm::Value *sorter_ptr,
-                  llvm::Value *comparison_func) const {
+                  llvm::Value *comparison_func, uint64_t top_k,
+                  llvm::Function *key_prefix_func) const {
   auto *tuple_size = codegen.Const32(storage_format_.GetStorageSize());
-  codegen.Call(SorterProxy::Init, {sorter_ptr, comparison_func, tuple_size});
+  llvm::Value *prefix_func = key_prefix_func;
+  if (prefix_func == nullptr) {
+    auto *init_func = SorterProxy::Init.GetFunction(codegen);
+    prefix_func = codegen.NullPtr(llvm::cast<llvm::PointerType>(
+        init_func->getFunctionType()->getParamType(4)));
+  }
+  codegen.Call(SorterProxy::Init, {sorter_ptr, comparison_func, tuple_size,
+                                   codegen.Const64(top_k), prefix_func});
 }
 
 // Append the given tuple into the sorter instance
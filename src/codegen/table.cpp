@@ -15,8 +15,10 @@
 #include "catalog/schema.h"
 #include "codegen/proxy/data_table_proxy.h"
 #include "codegen/lang/loop.h"
+#include "codegen/lang/if.h"
 #include "codegen/proxy/runtime_functions_proxy.h"
 #include "storage/data_table.h"
+#include "storage/zone_map.h"
 
 namespace peloton {
 namespace codegen {
@@ -38,6 +40,21 @@ llvm::Value *Table::GetTileGroup(CodeGen &codegen, llvm::Value *table_ptr,
                       {table_ptr, tile_group_id});
 }
 
+// We consult the tile group's zone map by calling
+// RuntimeFunctions::ShouldScanTileGroup(). The predicates live in the plan,
+// so we can pass their address directly.
+llvm::Value *Table::ShouldScanTileGroup(
+    CodeGen &codegen, llvm::Value *tile_group_ptr,
+    const std::vector<storage::ZoneMapPredicate> &zone_map_predicates) const {
+  llvm::Value *predicates_ptr = codegen->CreateIntToPtr(
+      codegen.Const64((int64_t)zone_map_predicates.data()),
+      ZoneMapPredicateProxy::GetType(codegen)->getPointerTo());
+  llvm::Value *num_predicates =
+      codegen.Const32(static_cast<uint32_t>(zone_map_predicates.size()));
+  return codegen.Call(RuntimeFunctionsProxy::ShouldScanTileGroup,
+                      {tile_group_ptr, predicates_ptr, num_predicates});
+}
+
 // Generate a scan over all tile groups.
 //
 // @code
@@ -49,14 +66,22 @@ llvm::Value *Table::GetTileGroup(CodeGen &codegen, llvm::Value *table_ptr,
 //
 // for (; tile_group_idx < num_tile_groups; ++tile_group_idx) {
 //   tile_group_ptr := GetTileGroup(table_ptr, tile_group_idx)
-//   consumer.TileGroupStart(tile_group_ptr);
-//   tile_group.TidScan(tile_group_ptr, column_layouts, vector_size, consumer);
-//   consumer.TileGroupEnd(tile_group_ptr);
+//   if (ShouldScanTileGroup(tile_group_ptr, zone_map_predicates)) {
+//     consumer.TileGroupStart(tile_group_ptr);
+//     tile_group.TidScan(tile_group_ptr, column_layouts, vector_size,
+//                        consumer);
+//     consumer.TileGroupEnd(tile_group_ptr);
+//   }
 // }
 //
 // @endcode
-void Table::GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
-                         uint32_t batch_size, ScanCallback &consumer) const {
+//
+// The zone map check is only generated if there are predicates to check.
+void Table::GenerateScan(
+    CodeGen &codegen, llvm::Value *table_ptr, uint32_t batch_size,
+    ScanCallback &consumer,
+    const std::vector<storage::ZoneMapPredicate> &zone_map_predicates,
+    const std::vector<oid_t> &column_ids) const {
   // First get the columns from the table the consumer needs. For every column,
   // we'll need to have a ColumnInfoLayout struct
   const uint32_t num_columns =
@@ -78,19 +103,33 @@ void Table::GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
     tile_group_idx = loop.GetLoopVar(0);
     llvm::Value *tile_group_ptr =
         GetTileGroup(codegen, table_ptr, tile_group_idx);
-    llvm::Value *tile_group_id =
-        tile_group_.GetTileGroupId(codegen, tile_group_ptr);
 
-    // Invoke the consumer to let her know that we're starting to iterate over
-    // the tile group now
-    consumer.TileGroupStart(codegen, tile_group_id, tile_group_ptr);
+    auto scan_tile_group = [&]() {
+      llvm::Value *tile_group_id =
+          tile_group_.GetTileGroupId(codegen, tile_group_ptr);
+
+      // Invoke the consumer to let her know that we're starting to iterate
+      // over the tile group now
+      consumer.TileGroupStart(codegen, tile_group_id, tile_group_ptr);
+
+      // Generate the scan cover over the given tile group
+      tile_group_.GenerateTidScan(codegen, tile_group_ptr, column_layouts,
+                                  column_ids, batch_size, consumer);
 
-    // Generate the scan cover over the given tile group
-    tile_group_.GenerateTidScan(codegen, tile_group_ptr, column_layouts,
-                                batch_size, consumer);
+      // Invoke the consumer to let her know that we're done with this tile
+      // group
+      consumer.TileGroupFinish(codegen, tile_group_ptr);
+    };
 
-    // Invoke the consumer to let her know that we're done with this tile group
-    consumer.TileGroupFinish(codegen, tile_group_ptr);
+    if (zone_map_predicates.empty()) {
+      scan_tile_group();
+    } else {
+      llvm::Value *should_scan =
+          ShouldScanTileGroup(codegen, tile_group_ptr, zone_map_predicates);
+      lang::If tile_group_qualifies{codegen, should_scan, "scanTileGroup"};
+      { scan_tile_group(); }
+      tile_group_qualifies.EndIf();
+    }
 
     // Move to next tile group in the table
     tile_group_idx = codegen->CreateAdd(tile_group_idx, codegen.Const64(1));
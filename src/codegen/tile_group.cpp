@@ -46,10 +46,12 @@ TileGroup::TileGroup(const catalog::Schema &schema) : schema_(schema) {}
 //
 void TileGroup::GenerateTidScan(CodeGen &codegen, llvm::Value *tile_group_ptr,
                                 llvm::Value *column_layouts,
+                                const std::vector<oid_t> &column_ids,
                                 uint32_t batch_size,
                                 ScanCallback &consumer) const {
   // Get the column layouts
-  auto col_layouts = GetColumnLayouts(codegen, tile_group_ptr, column_layouts);
+  auto col_layouts =
+      GetColumnLayouts(codegen, tile_group_ptr, column_layouts, column_ids);
 
   llvm::Value *num_tuples = GetNumTuples(codegen, tile_group_ptr);
   lang::VectorizedLoop loop{codegen, num_tuples, batch_size, {}};
@@ -84,15 +86,24 @@ llvm::Value *TileGroup::GetTileGroupId(CodeGen &codegen,
 // 1. The starting memory address (where the first value of the column is)
 // 2. The stride length
 // 3. Whether the column is in columnar layout
+//
+// Frozen columns are decoded to get there, so we also tell which columns will
+// actually be read, one byte per column.
 //===----------------------------------------------------------------------===//
 std::vector<TileGroup::ColumnLayout> TileGroup::GetColumnLayouts(
     CodeGen &codegen, llvm::Value *tile_group_ptr,
-    llvm::Value *column_layout_infos) const {
-  // Call RuntimeFunctions::GetTileGroupLayout()
+    llvm::Value *column_layout_infos,
+    const std::vector<oid_t> &column_ids) const {
   uint32_t num_cols = schema_.GetColumnCount();
-  codegen.Call(
-      RuntimeFunctionsProxy::GetTileGroupLayout,
-      {tile_group_ptr, column_layout_infos, codegen.Const32(num_cols)});
+  std::string used_columns(num_cols, '\0');
+  for (oid_t col_id : column_ids) {
+    used_columns[col_id] = '\1';
+  }
+
+  // Call RuntimeFunctions::GetTileGroupLayout()
+  codegen.Call(RuntimeFunctionsProxy::GetTileGroupLayout,
+               {tile_group_ptr, column_layout_infos, codegen.Const32(num_cols),
+                codegen.ConstStringPtr(used_columns)});
 
   // Collect <start, stride, is_columnar> triplets of all columns
   std::vector<TileGroup::ColumnLayout> layouts;
@@ -25,6 +25,7 @@
 #include "codegen/operator/hash_join_translator.h"
 #include "codegen/operator/hash_translator.h"
 #include "codegen/operator/insert_translator.h"
+#include "codegen/operator/limit_translator.h"
 #include "codegen/expression/negation_translator.h"
 #include "codegen/operator/order_by_translator.h"
 #include "codegen/operator/projection_translator.h"
@@ -43,6 +44,7 @@
 #include "planner/delete_plan.h"
 #include "planner/hash_join_plan.h"
 #include "planner/insert_plan.h"
+#include "planner/limit_plan.h"
 #include "planner/order_by_plan.h"
 #include "planner/projection_plan.h"
 #include "planner/seq_scan_plan.h"
@@ -99,6 +101,11 @@ std::unique_ptr<OperatorTranslator> TranslatorFactory::CreateTranslator(
       translator = new OrderByTranslator(order_by, context, pipeline);
       break;
     }
+    case PlanNodeType::LIMIT: {
+      auto &limit_plan = static_cast<const planner::LimitPlan &>(plan_node);
+      translator = new LimitTranslator(limit_plan, context, pipeline);
+      break;
+    }
     case PlanNodeType::DELETE: {
       auto &delete_plan = static_cast<const planner::DeletePlan &>(plan_node);
       translator = new DeleteTranslator(delete_plan, context, pipeline);
@@ -143,7 +150,11 @@ std::unique_ptr<ExpressionTranslator> TranslatorFactory::CreateTranslator(
     case ExpressionType::COMPARE_LESSTHAN:
     case ExpressionType::COMPARE_GREATERTHAN:
     case ExpressionType::COMPARE_LESSTHANOREQUALTO:
-    case ExpressionType::COMPARE_GREATERTHANOREQUALTO: {
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+    case ExpressionType::COMPARE_LIKE:
+    case ExpressionType::COMPARE_NOTLIKE:
+    case ExpressionType::COMPARE_ILIKE:
+    case ExpressionType::COMPARE_IN: {
       const auto &cmp_exp =
           static_cast<const expression::ComparisonExpression &>(exp);
       translator = new ComparisonTranslator(cmp_exp, context);
@@ -155,6 +155,36 @@ struct Ascii : public TypeSystem::UnaryOperator {
   }
 };
 
+// Pattern matching with LIKE or ILIKE
+struct Like : public TypeSystem::BinaryOperator {
+  explicit Like(bool case_insensitive) : case_insensitive_(case_insensitive) {}
+
+  bool SupportsTypes(const Type &left_type,
+                     const Type &right_type) const override {
+    return left_type.GetSqlType() == Varchar::Instance() &&
+           right_type.GetSqlType() == Varchar::Instance();
+  }
+
+  Type ResultType(UNUSED_ATTRIBUTE const Type &left_type,
+                  UNUSED_ATTRIBUTE const Type &right_type) const override {
+    return Boolean::Instance();
+  }
+
+  Value DoWork(CodeGen &codegen, const Value &left, const Value &right,
+               UNUSED_ATTRIBUTE OnError on_error) const override {
+    PL_ASSERT(SupportsTypes(left.GetType(), right.GetType()));
+    std::vector<llvm::Value *> args = {left.GetValue(), left.GetLength(),
+                                       right.GetValue(), right.GetLength()};
+    llvm::Value *raw_ret =
+        case_insensitive_ ? codegen.Call(StringFunctionsProxy::ILike, args)
+                          : codegen.Call(StringFunctionsProxy::Like, args);
+    return Value{Boolean::Instance(), raw_ret};
+  }
+
+ private:
+  bool case_insensitive_;
+};
+
 //===----------------------------------------------------------------------===//
 // TYPE SYSTEM CONSTRUCTION
 //===----------------------------------------------------------------------===//
@@ -178,7 +208,10 @@ static std::vector<TypeSystem::UnaryOpInfo> kUnaryOperatorTable = {
 };
 
 // Binary operations
-static std::vector<TypeSystem::BinaryOpInfo> kBinaryOperatorTable = {};
+static Like kLike{false};
+static Like kILike{true};
+static std::vector<TypeSystem::BinaryOpInfo> kBinaryOperatorTable = {
+    {OperatorId::Like, kLike}, {OperatorId::ILike, kILike}};
 
 // Nary operations
 static std::vector<TypeSystem::NaryOpInfo> kNaryOperatorTable = {};
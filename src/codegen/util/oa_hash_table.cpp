@@ -14,8 +14,10 @@
 
 #include <string.h>
 
+#include "common/exception.h"
 #include "common/logger.h"
 #include "common/platform.h"
+#include "executor/executor_context.h"
 
 namespace peloton {
 namespace codegen {
@@ -36,7 +38,17 @@ uint32_t OAHashTable::kInitialKVListCapacity = 8;
 // table given the estimate size.
 //===----------------------------------------------------------------------===//
 void OAHashTable::Init(uint64_t key_size, uint64_t value_size,
-                       uint64_t estimated_num_entries) {
+                       uint64_t estimated_num_entries,
+                       executor::ExecutorContext *executor_context) {
+  // Nothing is allocated yet, so the table can be destroyed if the budget is
+  // exhausted right away
+  buckets_ = nullptr;
+  num_entries_ = num_valid_buckets_ = 0;
+  memory_budget_ = executor_context != nullptr
+                       ? &executor_context->GetMemoryBudget()
+                       : nullptr;
+  memory_reserved_ = 0;
+
   // Setup the sizes
   key_size_ = key_size;
   value_size_ = value_size;
@@ -53,14 +65,12 @@ void OAHashTable::Init(uint64_t key_size, uint64_t value_size,
   // Sanity check
   PL_ASSERT((num_buckets_ & bucket_mask_) == 0);
 
-  // No elements in the table right now
-  num_entries_ = num_valid_buckets_ = 0;
-
   // We maintain a load factor of 50% since this is an easy number to compute
   resize_threshold_ = num_buckets_ >> 1;
 
   // Create bucket array. We don't use regular "new" since the size of a
   // HashEntry is known at runtime only.
+  ReserveMemory(entry_size_ * num_buckets_);
   buckets_ = static_cast<HashEntry *>(malloc(entry_size_ * num_buckets_));
 
   // Set status code of all buckets to FREE
@@ -86,6 +96,11 @@ char *OAHashTable::StoreToKeyValueList(KeyValueList **kv_list_p_p) {
   // Size always <= capacity
   PL_ASSERT(kv_list_p->capacity >= kv_list_p->size);
 
+  // Account for a larger list before the list is touched
+  if (kv_list_p->size == kv_list_p->capacity) {
+    ReserveMemory(GetCurrentKeyValueListSize(kv_list_p->capacity));
+  }
+
   // We always need this to compute something
   uint32_t size = kv_list_p->size;
   kv_list_p->size++;
@@ -121,6 +136,7 @@ char *OAHashTable::StoreToKeyValueList(KeyValueList **kv_list_p_p) {
     // Free memory and assign it back to the place where kv_list_p is stored
     free(*kv_list_p_p);
     *kv_list_p_p = kv_list_p;
+    ReleaseMemory(current_length);
   }
 
   return reinterpret_cast<char *>(reinterpret_cast<uint64_t>(kv_list_p) +
@@ -214,6 +230,8 @@ char *OAHashTable::StoreTuple(HashEntry *entry, uint64_t hash) {
   // we allocate one.
   if (!entry->HasKeyValueList()) {
     // Allocate a chunk that contains kv list header and several value slots
+    ReserveMemory(
+        GetCurrentKeyValueListSize(OAHashTable::kInitialKVListCapacity));
     entry->kv_list = static_cast<KeyValueList *>(malloc(
         GetCurrentKeyValueListSize(OAHashTable::kInitialKVListCapacity)));
 
@@ -274,6 +292,9 @@ void OAHashTable::Resize(HashEntry **entry_p_p) {
   // Make it an assertion to prevent potential bugs
   PL_ASSERT(NeedsResize());
 
+  // The new array is allocated before the old one is freed
+  ReserveMemory(entry_size_ * (num_buckets_ << 1));
+
   LOG_DEBUG("Resizing hash-table from %llu buckets to %llu", (unsigned long long) num_buckets_,
             (unsigned long long) num_buckets_ << 1);
 
@@ -355,6 +376,23 @@ void OAHashTable::Resize(HashEntry **entry_p_p) {
   // Free the old array after probing of all elements, and then update
   free(buckets_);
   buckets_ = reinterpret_cast<HashEntry *>(new_buckets);
+  ReleaseMemory(entry_size_ * (num_buckets_ >> 1));
+}
+
+void OAHashTable::ReserveMemory(uint64_t bytes) {
+  if (memory_budget_ == nullptr) return;
+  if (memory_budget_->Reserve(bytes) == false) {
+    throw OutOfMemoryException(
+        "Compiled hash table exceeded the query memory budget of " +
+        std::to_string(memory_budget_->GetLimit()) + " bytes");
+  }
+  memory_reserved_ += bytes;
+}
+
+void OAHashTable::ReleaseMemory(uint64_t bytes) {
+  if (memory_budget_ == nullptr) return;
+  memory_budget_->Release(bytes);
+  memory_reserved_ -= bytes;
 }
 
 //===----------------------------------------------------------------------===//
@@ -389,6 +427,11 @@ void OAHashTable::Destroy() {
 
   // Free main buckets array
   free(buckets_);
+  buckets_ = nullptr;
+  num_valid_buckets_ = 0;
+
+  // Return everything to the budget, kv lists included
+  ReleaseMemory(memory_reserved_);
 }
 
 OAHashTable::Iterator OAHashTable::begin() { return Iterator(*this, true); }
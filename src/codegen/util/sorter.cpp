@@ -12,16 +12,54 @@
 
 #include "codegen/util/sorter.h"
 
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
 #include <cstring>
 
+#include "common/exception.h"
 #include "common/logger.h"
 #include "common/timer.h"
+#include "settings/settings_manager.h"
 #include "storage/backend_manager.h"
+#include "threadpool/parallel_for.h"
 
 namespace peloton {
 namespace codegen {
 namespace util {
 
+//===----------------------------------------------------------------------===//
+// The runs of an external sort and the file-backed buffer they are merged into
+//===----------------------------------------------------------------------===//
+struct Sorter::SpilledRuns {
+  struct Run {
+    FILE *file;
+    uint64_t num_tuples;
+  };
+
+  ~SpilledRuns() {
+    for (auto &run : runs) {
+      fclose(run.file);
+    }
+    if (output != nullptr) {
+      munmap(output, output_size);
+    }
+    if (output_file != nullptr) {
+      fclose(output_file);
+    }
+  }
+
+  // Sorted runs, in the order they were spilled
+  std::vector<Run> runs;
+
+  // The temporary file the merged output is mapped from
+  FILE *output_file = nullptr;
+  char *output = nullptr;
+  uint64_t output_size = 0;
+};
+
 // Constructor doesn't create the buffer space.  The buffer will be created
 // upon initialization.
 Sorter::Sorter()
@@ -29,37 +67,75 @@ Sorter::Sorter()
       buffer_pos_(nullptr),
       buffer_end_(nullptr),
       tuple_size_(std::numeric_limits<uint32_t>::max()),
-      cmp_func_(nullptr) {}
+      cmp_func_(nullptr),
+      prefix_func_(nullptr),
+      top_k_(0),
+      memory_budget_(0),
+      spilled_runs_(nullptr) {}
 
 // Destruction calls the destroy method to clean up the resources.
 Sorter::~Sorter() { Destroy(); }
 
 // It'd be nice if calls could hint the size of the buffer space they'd need
 // when initializing the sorter. Till then ...
-void Sorter::Init(ComparisonFunction func, uint32_t tuple_size) {
+void Sorter::Init(ComparisonFunction func, uint32_t tuple_size,
+                  uint64_t top_k, KeyPrefixFunction prefix_func) {
   LOG_DEBUG("Initializing Sorter ...");
-
   tuple_size_ = tuple_size;
   cmp_func_ = func;
+  prefix_func_ = prefix_func;
+  memory_budget_ = static_cast<uint64_t>(settings::SettingsManager::GetInt(
+                       settings::SettingId::sort_memory_budget)) *
+                   1024;
+  spilled_runs_ = nullptr;
+
+  // A top-k sort needs room for the k tuples, the incoming tuple and one slot
+  // to swap tuples through. If that does not fit the budget, sort everything.
+  uint64_t buffer_size = kInitialBufferSize;
+  top_k_ = 0;
+  if (top_k > 0) {
+    uint64_t top_k_size = (top_k + 2) * tuple_size_;
+    uint64_t max_top_k_size =
+        memory_budget_ != 0 ? memory_budget_ : kMaxTopKBufferSize;
+    if (top_k_size <= max_top_k_size) {
+      top_k_ = top_k;
+      buffer_size = top_k_size;
+    } else {
+      LOG_DEBUG("Top-%llu does not fit into the sort budget, sorting all tuples",
+                (unsigned long long)top_k);
+    }
+  }
 
   auto &backend_manager = storage::BackendManager::GetInstance();
-
   buffer_start_ = reinterpret_cast<char *>(
-      backend_manager.Allocate(BackendType::MM, kInitialBufferSize));
+      backend_manager.Allocate(BackendType::MM, buffer_size));
   buffer_pos_ = buffer_start_;
-  buffer_end_ = buffer_start_ + kInitialBufferSize;
+  buffer_end_ = buffer_start_ + buffer_size;
 
   LOG_INFO("Initialized Sorter with size %llu KB for tuples of size %u...",
-           (unsigned long long)kInitialBufferSize / 1024, tuple_size_);
+           (unsigned long long)buffer_size / 1024, tuple_size_);
 }
 
 // StoreValue a tuple of the given size in this sorter. We return a buffer that
 // has room to store tuple_size bytes.  We should also resize the existing
-// buffer space if we don't have sufficient room for the incoming tuple.
+// buffer space if we don't have sufficient room for the incoming tuple. If
+// the buffer cannot grow any further within the memory budget, its contents
+// are spilled to disk as a sorted run instead.
 char *Sorter::StoreInputTuple() {
-  if (!EnoughSpace(tuple_size_)) {
-    Resize();
+  if (top_k_ != 0) {
+    // The slot is always available since the heap never exceeds k tuples
+    AddToTopK();
+  } else {
+    while (!EnoughSpace(tuple_size_)) {
+      if (memory_budget_ != 0 && GetUsedSpace() > 0 &&
+          GetAllocatedSpace() * 2 > memory_budget_) {
+        SpillRun();
+      } else {
+        Resize();
+      }
+    }
   }
+
   char *ret = buffer_pos_;
   buffer_pos_ += tuple_size_;
   return ret;
@@ -67,8 +143,13 @@ char *Sorter::StoreInputTuple() {
 
 // Sort the buffer
 void Sorter::Sort() {
+  // The last stored tuple has not been considered yet
+  if (top_k_ != 0) {
+    AddToTopK();
+  }
+
   // Nothing to sort if nothing has been stored
-  if (GetUsedSpace() <= 0) {
+  if (GetUsedSpace() <= 0 && spilled_runs_ == nullptr) {
     return;
   }
 
@@ -76,18 +157,15 @@ void Sorter::Sort() {
   Timer<std::ratio<1, 1000>> timer;
   timer.Start();
 
-  uint64_t num_tuples = GetNumTuples();
-
-  LOG_DEBUG("Going to sort %llu tuples in sort buffer",
-            (unsigned long long)num_tuples);
-
-  // Sort the sucker
-  std::qsort(buffer_start_, num_tuples, tuple_size_,
-             reinterpret_cast<int (*)(const void *, const void *)>(cmp_func_));
+  if (spilled_runs_ != nullptr) {
+    MergeSpilledRuns();
+  } else {
+    SortBuffer();
+  }
 
   timer.Stop();
-  LOG_INFO("Sorted %llu tuples in %.2f ms", (unsigned long long)num_tuples,
-           timer.GetDuration());
+  LOG_INFO("Sorted %llu tuples in %.2f ms",
+           (unsigned long long)GetNumTuples(), timer.GetDuration());
 }
 
 // Release any memory we allocated from the storage manager.
@@ -95,10 +173,17 @@ void Sorter::Destroy() {
   if (buffer_start_ != nullptr) {
     LOG_DEBUG("Cleaning up %llu tuples, releasing %.2lf KB",
               (unsigned long long)GetNumTuples(), GetAllocatedSpace() / 1024.0);
-    auto &backend_manager = storage::BackendManager::GetInstance();
-    backend_manager.Release(BackendType::MM, buffer_start_);
+    // After an external sort the buffer is the mapping of the merged runs,
+    // which is released along with the runs
+    if (spilled_runs_ == nullptr || spilled_runs_->output != buffer_start_) {
+      auto &backend_manager = storage::BackendManager::GetInstance();
+      backend_manager.Release(BackendType::MM, buffer_start_);
+    }
   }
   buffer_start_ = buffer_pos_ = buffer_end_ = nullptr;
+
+  delete spilled_runs_;
+  spilled_runs_ = nullptr;
 }
 
 // Resize the buffer by allocating a space that is double its current size.
@@ -122,7 +207,6 @@ void Sorter::Resize() {
             (unsigned long long)next_alloc_size);
 
   auto &backend_manager = storage::BackendManager::GetInstance();
-
   char *new_buffer_start = reinterpret_cast<char *>(
       backend_manager.Allocate(BackendType::MM, next_alloc_size));
 
@@ -140,6 +224,322 @@ void Sorter::Resize() {
   backend_manager.Release(BackendType::MM, old_buffer_start);
 }
 
+//===----------------------------------------------------------------------===//
+// Top-K
+//===----------------------------------------------------------------------===//
+
+// The first k tuples of the buffer form a max-heap on the sort order, so the
+// root is the tuple that is dropped first. A stored tuple is only folded into
+// the heap on the next call to StoreInputTuple() or Sort(), since its contents
+// are written by the caller after we hand out the slot.
+void Sorter::AddToTopK() {
+  uint64_t num_tuples = GetNumTuples();
+  if (num_tuples == 0) {
+    return;
+  }
+
+  char *swap_space = buffer_start_ + (top_k_ + 1) * tuple_size_;
+  auto tuple_at = [this](uint64_t idx) {
+    return buffer_start_ + idx * tuple_size_;
+  };
+
+  if (num_tuples <= top_k_) {
+    // Still filling the heap, sift the new tuple up
+    uint64_t idx = num_tuples - 1;
+    while (idx > 0) {
+      uint64_t parent = (idx - 1) / 2;
+      if (cmp_func_(tuple_at(idx), tuple_at(parent)) <= 0) {
+        break;
+      }
+      PL_MEMCPY(swap_space, tuple_at(idx), tuple_size_);
+      PL_MEMCPY(tuple_at(idx), tuple_at(parent), tuple_size_);
+      PL_MEMCPY(tuple_at(parent), swap_space, tuple_size_);
+      idx = parent;
+    }
+    return;
+  }
+
+  // The heap is full, the new tuple only stays if it sorts before the root
+  PL_ASSERT(num_tuples == top_k_ + 1);
+  char *new_tuple = tuple_at(top_k_);
+  if (cmp_func_(new_tuple, tuple_at(0)) < 0) {
+    PL_MEMCPY(tuple_at(0), new_tuple, tuple_size_);
+    SiftDown(0, top_k_);
+  }
+  buffer_pos_ = new_tuple;
+}
+
+void Sorter::SiftDown(uint64_t root, uint64_t num_tuples) {
+  char *swap_space = buffer_start_ + (top_k_ + 1) * tuple_size_;
+  auto tuple_at = [this](uint64_t idx) {
+    return buffer_start_ + idx * tuple_size_;
+  };
+
+  while (true) {
+    uint64_t largest = root;
+    uint64_t left = 2 * root + 1;
+    uint64_t right = left + 1;
+    if (left < num_tuples && cmp_func_(tuple_at(left), tuple_at(largest)) > 0) {
+      largest = left;
+    }
+    if (right < num_tuples &&
+        cmp_func_(tuple_at(right), tuple_at(largest)) > 0) {
+      largest = right;
+    }
+    if (largest == root) {
+      break;
+    }
+    PL_MEMCPY(swap_space, tuple_at(root), tuple_size_);
+    PL_MEMCPY(tuple_at(root), tuple_at(largest), tuple_size_);
+    PL_MEMCPY(tuple_at(largest), swap_space, tuple_size_);
+    root = largest;
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// In-memory sort
+//===----------------------------------------------------------------------===//
+
+// Sort small entries pointing to the tuples rather than the tuples themselves,
+// so that the sort loop only moves entries around. If the sort has a key
+// prefix function, every entry carries an order-preserving prefix of the
+// first sort key, and the comparison function is only called when two
+// prefixes are equal. Large inputs are cut into runs that are sorted on the
+// worker pool and then merged pairwise (also on the pool) until a single run
+// is left. Finally, the tuples are permuted into sorted order within the
+// buffer itself, following the cycles of the permutation through a single
+// tuple of scratch space.
+void Sorter::SortBuffer() {
+  uint64_t num_tuples = GetNumTuples();
+  if (num_tuples < 2) {
+    return;
+  }
+
+  LOG_DEBUG("Going to sort %llu tuples in sort buffer",
+            (unsigned long long)num_tuples);
+
+  struct SortEntry {
+    uint64_t prefix;
+    const char *tuple;
+  };
+  std::vector<SortEntry> entries(num_tuples);
+
+  ComparisonFunction cmp_func = cmp_func_;
+  KeyPrefixFunction prefix_func = prefix_func_;
+  auto less = [cmp_func](const SortEntry &left, const SortEntry &right) {
+    if (left.prefix != right.prefix) {
+      return left.prefix < right.prefix;
+    }
+    return cmp_func(left.tuple, right.tuple) < 0;
+  };
+
+  uint64_t num_runs = std::max<uint64_t>(
+      1, std::min<uint64_t>(threadpool::GetParallelism(),
+                            num_tuples / kParallelSortThreshold));
+
+  // Run boundaries, run i is [bounds[i], bounds[i+1])
+  std::vector<uint64_t> bounds;
+  for (uint64_t run = 0; run <= num_runs; run++) {
+    bounds.push_back(run * num_tuples / num_runs);
+  }
+
+  threadpool::ParallelFor(num_runs, num_runs, [&](size_t run) {
+    for (uint64_t i = bounds[run]; i < bounds[run + 1]; i++) {
+      const char *tuple = buffer_start_ + i * tuple_size_;
+      entries[i].prefix = prefix_func != nullptr ? prefix_func(tuple) : 0;
+      entries[i].tuple = tuple;
+    }
+    std::sort(entries.begin() + bounds[run], entries.begin() + bounds[run + 1],
+              less);
+  });
+
+  while (bounds.size() > 2) {
+    size_t num_merges = (bounds.size() - 1) / 2;
+    threadpool::ParallelFor(num_merges, num_merges, [&](size_t merge) {
+      size_t run = merge * 2;
+      std::inplace_merge(entries.begin() + bounds[run],
+                         entries.begin() + bounds[run + 1],
+                         entries.begin() + bounds[run + 2], less);
+    });
+
+    std::vector<uint64_t> merged_bounds;
+    for (uint64_t run = 0; run + 1 < bounds.size(); run += 2) {
+      merged_bounds.push_back(bounds[run]);
+    }
+    merged_bounds.push_back(bounds.back());
+    bounds = std::move(merged_bounds);
+  }
+
+  // The tuple at position i belongs at the position whose entry points to it.
+  // Entries are cleared once their position holds the right tuple.
+  std::vector<char> scratch(tuple_size_);
+  auto tuple_at = [this](uint64_t idx) {
+    return buffer_start_ + idx * tuple_size_;
+  };
+  auto source_of = [this, &entries](uint64_t idx) {
+    return static_cast<uint64_t>(entries[idx].tuple - buffer_start_) /
+           tuple_size_;
+  };
+  for (uint64_t start = 0; start < num_tuples; start++) {
+    if (entries[start].tuple == nullptr) {
+      continue;
+    }
+    if (source_of(start) == start) {
+      entries[start].tuple = nullptr;
+      continue;
+    }
+
+    PL_MEMCPY(scratch.data(), tuple_at(start), tuple_size_);
+    uint64_t pos = start;
+    while (true) {
+      uint64_t source = source_of(pos);
+      entries[pos].tuple = nullptr;
+      if (source == start) {
+        PL_MEMCPY(tuple_at(pos), scratch.data(), tuple_size_);
+        break;
+      }
+      PL_MEMCPY(tuple_at(pos), tuple_at(source), tuple_size_);
+      pos = source;
+    }
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// External sort
+//===----------------------------------------------------------------------===//
+
+void Sorter::SpillRun() {
+  SortBuffer();
+
+  if (spilled_runs_ == nullptr) {
+    spilled_runs_ = new SpilledRuns();
+  }
+
+  FILE *file = tmpfile();
+  if (file == nullptr) {
+    throw ExecutorException(std::string("Failed to create sort run file: ") +
+                            strerror(errno));
+  }
+  spilled_runs_->runs.push_back(SpilledRuns::Run{file, GetNumTuples()});
+
+  if (fwrite(buffer_start_, 1, GetUsedSpace(), file) != GetUsedSpace() ||
+      fflush(file) != 0) {
+    throw ExecutorException(std::string("Failed to write sort run: ") +
+                            strerror(errno));
+  }
+
+  LOG_DEBUG("Spilled sorted run %zu of %llu tuples",
+            spilled_runs_->runs.size(), (unsigned long long)GetNumTuples());
+
+  buffer_pos_ = buffer_start_;
+}
+
+// The tuples still in memory form the last run. All runs are merged with a
+// heap over the current tuple of each run into a temporary file that is
+// mapped into memory and replaces the sort buffer. The mapping is backed by
+// the file, so the OS can page the output out instead of it counting against
+// the process's memory.
+void Sorter::MergeSpilledRuns() {
+  SortBuffer();
+
+  uint64_t num_tuples = GetNumTuples();
+  for (const auto &run : spilled_runs_->runs) {
+    num_tuples += run.num_tuples;
+  }
+
+  // Set up the output mapping
+  auto &runs = *spilled_runs_;
+  runs.output_size = num_tuples * tuple_size_;
+  runs.output_file = tmpfile();
+  if (runs.output_file == nullptr ||
+      ftruncate(fileno(runs.output_file), runs.output_size) != 0) {
+    throw ExecutorException(std::string("Failed to create sort output: ") +
+                            strerror(errno));
+  }
+  void *output = mmap(nullptr, runs.output_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fileno(runs.output_file), 0);
+  if (output == MAP_FAILED) {
+    throw ExecutorException(std::string("Failed to map sort output: ") +
+                            strerror(errno));
+  }
+  runs.output = reinterpret_cast<char *>(output);
+
+  // A cursor over each run. Spilled runs are read back in blocks.
+  struct MergeInput {
+    const char *pos;
+    const char *end;
+    FILE *file;
+    std::vector<char> block;
+  };
+  uint64_t block_size =
+      std::max<uint64_t>(1, kMergeBlockSize / tuple_size_) * tuple_size_;
+  auto refill = [](MergeInput &input) {
+    size_t read = fread(input.block.data(), 1, input.block.size(), input.file);
+    input.pos = input.block.data();
+    input.end = input.pos + read;
+  };
+
+  std::vector<MergeInput> inputs(runs.runs.size() + 1);
+  for (uint32_t i = 0; i < runs.runs.size(); i++) {
+    auto &input = inputs[i];
+    input.file = runs.runs[i].file;
+    input.block.resize(block_size);
+    rewind(input.file);
+    refill(input);
+  }
+  inputs.back().pos = buffer_start_;
+  inputs.back().end = buffer_pos_;
+  inputs.back().file = nullptr;
+
+  // Min-heap of inputs on their current tuple
+  ComparisonFunction cmp_func = cmp_func_;
+  auto greater = [&inputs, cmp_func](uint32_t left, uint32_t right) {
+    return cmp_func(inputs[left].pos, inputs[right].pos) > 0;
+  };
+  std::vector<uint32_t> heap;
+  for (uint32_t i = 0; i < inputs.size(); i++) {
+    if (inputs[i].pos < inputs[i].end) {
+      heap.push_back(i);
+    }
+  }
+  std::make_heap(heap.begin(), heap.end(), greater);
+
+  char *out = runs.output;
+  while (!heap.empty()) {
+    std::pop_heap(heap.begin(), heap.end(), greater);
+    auto &input = inputs[heap.back()];
+    PL_MEMCPY(out, input.pos, tuple_size_);
+    out += tuple_size_;
+
+    input.pos += tuple_size_;
+    if (input.pos == input.end && input.file != nullptr) {
+      refill(input);
+    }
+    if (input.pos < input.end) {
+      std::push_heap(heap.begin(), heap.end(), greater);
+    } else {
+      heap.pop_back();
+    }
+  }
+  PL_ASSERT(out == runs.output + runs.output_size);
+
+  LOG_DEBUG("Merged %zu sorted runs into %llu tuples", runs.runs.size() + 1,
+            (unsigned long long)num_tuples);
+
+  // The runs are no longer needed
+  for (auto &run : runs.runs) {
+    fclose(run.file);
+  }
+  runs.runs.clear();
+
+  // From here on, the sorted output is the buffer. It is full, and no more
+  // tuples can be stored.
+  auto &backend_manager = storage::BackendManager::GetInstance();
+  backend_manager.Release(BackendType::MM, buffer_start_);
+  buffer_start_ = runs.output;
+  buffer_pos_ = buffer_end_ = runs.output + runs.output_size;
+}
+
 //===----------------------------------------------------------------------===//
 // Iterators
 //===----------------------------------------------------------------------===//
@@ -18,10 +18,14 @@
 #include "brain/index_tuner.h"
 #include "brain/layout_tuner.h"
 #include "catalog/catalog.h"
+#include "common/numa_topology.h"
 #include "common/thread_pool.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "gc/gc_manager_factory.h"
 #include "settings/settings_manager.h"
+#include "storage/backend_manager.h"
+#include "storage/tile_group_factory.h"
+#include "storage/tile_group_preallocator.h"
 #include "threadpool/mono_queue_pool.h"
 
 namespace peloton {
@@ -35,6 +39,13 @@ void PelotonInit::Initialize() {
   EPOCH_THREAD_COUNT = 1;
   MAX_CONCURRENCY = 10;
 
+  // threads started from here on are placed on the NUMA nodes
+  bool numa_aware =
+      settings::SettingsManager::GetBool(settings::SettingId::numa_aware);
+  NumaTopology::GetInstance().Configure(
+      numa_aware, settings::SettingsManager::GetInt(
+                      settings::SettingId::numa_simulated_nodes));
+
   // set max thread number.
   thread_pool.Initialize(0, std::thread::hardware_concurrency() + 3);
 
@@ -44,6 +55,29 @@ void PelotonInit::Initialize() {
   int parallelism = (std::thread::hardware_concurrency() + 3) / 4;
   storage::DataTable::SetActiveTileGroupCount(parallelism);
   storage::DataTable::SetActiveIndirectionArrayCount(parallelism);
+  storage::DataTable::SetNumaPartitioning(numa_aware);
+
+  // keep a negative setting from wrapping around to a huge reserve
+  int tile_group_reserve = settings::SettingsManager::GetInt(
+      settings::SettingId::tile_group_reserve);
+  int max_tile_group_reserve =
+      storage::TileGroupPreallocator::max_reserve_count;
+  if (tile_group_reserve < 0 || tile_group_reserve > max_tile_group_reserve) {
+    LOG_WARN("tile_group_reserve must be between 0 and %d, not %d",
+             max_tile_group_reserve, tile_group_reserve);
+    tile_group_reserve = std::max(
+        0, std::min(tile_group_reserve, max_tile_group_reserve));
+  }
+  storage::DataTable::SetTileGroupReserveCount(tile_group_reserve);
+
+  // tile groups on SSD or HDD live in the memory-mapped data file
+  storage::BackendManager::GetInstance().ConfigureDataFile(
+      settings::SettingsManager::GetString(
+          settings::SettingId::data_file_directory),
+      settings::SettingsManager::GetInt(settings::SettingId::data_file_size));
+  storage::TileGroupFactory::SetBackendType(StringToBackendType(
+      settings::SettingsManager::GetString(
+          settings::SettingId::tile_group_backend)));
 
   // start epoch.
   concurrency::EpochManagerFactory::GetInstance().StartEpoch();
@@ -0,0 +1,252 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// numa_topology.cpp
+//
+// Identification: src/common/numa_topology.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/numa_topology.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "common/logger.h"
+
+namespace peloton {
+
+#define NUMA_SYSFS_DIR "/sys/devices/system/node/"
+
+// Node the calling thread is pinned to
+static thread_local int pinned_node = NumaTopology::ANY_NODE;
+
+// Node set by the innermost NumaNodeScope of the calling thread
+static thread_local int scope_node = NumaTopology::ANY_NODE;
+
+NumaTopology &NumaTopology::GetInstance() {
+  static NumaTopology numa_topology;
+  return numa_topology;
+}
+
+NumaTopology::NumaTopology() { LoadTopology(); }
+
+std::vector<int> NumaTopology::ParseCpuList(const std::string &cpu_list) {
+  std::vector<int> cpus;
+  std::stringstream ss(cpu_list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty() == true || std::isdigit(range[0]) == false) {
+      continue;
+    }
+    auto dash = range.find('-');
+    int first = std::stoi(range.substr(0, dash));
+    int last = (dash == std::string::npos) ? first
+                                           : std::stoi(range.substr(dash + 1));
+    for (int cpu = first; cpu <= last; cpu++) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+static std::string ReadSysfsLine(const std::string &path) {
+  std::ifstream file(path);
+  std::string line;
+  std::getline(file, line);
+  return line;
+}
+
+void NumaTopology::LoadTopology() {
+  node_cpus_.clear();
+  node_ids_.clear();
+
+  auto node_ids = ParseCpuList(ReadSysfsLine(NUMA_SYSFS_DIR "online"));
+  for (auto node_id : node_ids) {
+    auto cpus = ParseCpuList(ReadSysfsLine(NUMA_SYSFS_DIR "node" +
+                                           std::to_string(node_id) +
+                                           "/cpulist"));
+    // Memory-only nodes do not run threads
+    if (cpus.empty() == false) {
+      node_cpus_.push_back(cpus);
+      node_ids_.push_back(node_id);
+    }
+  }
+
+  // No sysfs, e.g. in a container or on another OS
+  if (node_cpus_.empty() == true) {
+    std::vector<int> cpus;
+    int cpu_count = std::max(1U, std::thread::hardware_concurrency());
+    for (int cpu = 0; cpu < cpu_count; cpu++) {
+      cpus.push_back(cpu);
+    }
+    node_cpus_.push_back(cpus);
+    node_ids_.push_back(0);
+  }
+
+  cpu_nodes_.clear();
+  for (size_t node = 0; node < node_cpus_.size(); node++) {
+    for (auto cpu : node_cpus_[node]) {
+      if (static_cast<size_t>(cpu) >= cpu_nodes_.size()) {
+        cpu_nodes_.resize(cpu + 1, 0);
+      }
+      cpu_nodes_[cpu] = node;
+    }
+  }
+}
+
+void NumaTopology::Configure(bool enabled, size_t simulated_node_count) {
+  LoadTopology();
+  enabled_ = enabled;
+  simulated_ = false;
+  next_node_ = 0;
+
+  if (enabled == false || simulated_node_count == 0) {
+    LOG_INFO("NUMA placement %s, %lu node(s)",
+             enabled ? "enabled" : "disabled", node_cpus_.size());
+    return;
+  }
+
+  // Split all CPUs into equally sized nodes
+  std::vector<int> cpus;
+  for (auto &node_cpus : node_cpus_) {
+    cpus.insert(cpus.end(), node_cpus.begin(), node_cpus.end());
+  }
+  std::sort(cpus.begin(), cpus.end());
+  size_t node_count = std::min(simulated_node_count, cpus.size());
+
+  node_cpus_.assign(node_count, std::vector<int>());
+  node_ids_.assign(node_count, 0);
+  for (size_t cpu_itr = 0; cpu_itr < cpus.size(); cpu_itr++) {
+    size_t node = cpu_itr * node_count / cpus.size();
+    node_cpus_[node].push_back(cpus[cpu_itr]);
+    cpu_nodes_[cpus[cpu_itr]] = node;
+  }
+  simulated_ = true;
+
+  LOG_INFO("NUMA placement enabled, %lu simulated node(s)", node_count);
+}
+
+int NumaTopology::GetCurrentNode() const {
+  if (enabled_ == false) {
+    return ANY_NODE;
+  }
+  if (pinned_node != ANY_NODE) {
+    return pinned_node;
+  }
+
+#ifdef __linux__
+  int cpu = sched_getcpu();
+  if (cpu >= 0 && static_cast<size_t>(cpu) < cpu_nodes_.size()) {
+    return cpu_nodes_[cpu];
+  }
+#endif
+  return 0;
+}
+
+int NumaTopology::GetAllocationNode() const {
+  if (scope_node != ANY_NODE) {
+    return scope_node;
+  }
+  return GetCurrentNode();
+}
+
+bool NumaTopology::PinThread(size_t node) {
+  if (enabled_ == false || node >= node_cpus_.size()) {
+    return false;
+  }
+
+#ifdef __linux__
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  for (auto cpu : node_cpus_[node]) {
+    CPU_SET(cpu, &cpuset);
+  }
+  if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) !=
+      0) {
+    LOG_WARN("Could not pin thread to NUMA node %lu", node);
+    return false;
+  }
+#endif
+
+  pinned_node = static_cast<int>(node);
+  return true;
+}
+
+int NumaTopology::PinThreadToNextNode() {
+  if (enabled_ == false) {
+    return ANY_NODE;
+  }
+
+  size_t node = next_node_.fetch_add(1) % node_cpus_.size();
+  if (PinThread(node) == false) {
+    return ANY_NODE;
+  }
+  return static_cast<int>(node);
+}
+
+void *NumaTopology::AllocateOnNode(size_t size, int node) const {
+  if (enabled_ == false || simulated_ == true || node == ANY_NODE ||
+      static_cast<size_t>(node) >= node_ids_.size() ||
+      node_ids_[node] >= static_cast<int>(sizeof(unsigned long) * 8)) {
+    return nullptr;
+  }
+
+#ifdef __linux__
+  // Fresh pages of our own, so the policy neither comes too late for pages
+  // the heap has touched already nor applies to unrelated heap objects
+  void *address = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (address == MAP_FAILED) {
+    return nullptr;
+  }
+
+  // The pages are placed when they are first touched. The node is only
+  // preferred, so they fall back to other nodes when it is full.
+  unsigned long node_mask = 1UL << node_ids_[node];
+  if (syscall(SYS_mbind, address, size, MPOL_PREFERRED, &node_mask,
+              sizeof(node_mask) * 8, 0) != 0) {
+    LOG_TRACE("Could not bind memory to NUMA node %d", node);
+  }
+  return address;
+#else
+  (void)size;
+  return nullptr;
+#endif
+}
+
+void NumaTopology::FreeOnNode(void *address, size_t size) const {
+#ifdef __linux__
+  // The policy goes away with the mapping
+  if (munmap(address, size) != 0) {
+    LOG_ERROR("Could not unmap NUMA node memory");
+  }
+#else
+  (void)address;
+  (void)size;
+#endif
+}
+
+NumaNodeScope::NumaNodeScope(int node) : previous_node_(scope_node) {
+  scope_node = node;
+}
+
+NumaNodeScope::~NumaNodeScope() { scope_node = previous_node_; }
+
+}  // namespace peloton
@@ -18,6 +18,7 @@
 #include "expression/operator_expression.h"
 #include "expression/parameter_value_expression.h"
 #include "expression/star_expression.h"
+#include "expression/subquery_expression.h"
 #include "expression/tuple_value_expression.h"
 #include "expression/constant_value_expression.h"
 #include "expression/case_expression.h"
@@ -53,6 +54,9 @@ void SqlNodeVisitor::Visit(expression::ParameterValueExpression *expr) {
 void SqlNodeVisitor::Visit(expression::StarExpression *expr) {
   expr->AcceptChildren(this);
 }
+void SqlNodeVisitor::Visit(expression::SubqueryExpression *expr) {
+  expr->AcceptChildren(this);
+}
 void SqlNodeVisitor::Visit(expression::TupleValueExpression *expr) {
   expr->AcceptChildren(this);
 }
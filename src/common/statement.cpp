@@ -15,6 +15,8 @@
 #include <cstdio>
 #include <sstream>
 
+#include <boost/algorithm/string.hpp>
+
 #include "common/logger.h"
 #include "planner/abstract_plan.h"
 
@@ -72,6 +74,23 @@ void Statement::MapToQueryType(const std::string& query_type_string,
   }
 }
 
+bool Statement::ParseExplainAnalyze(const std::string& query_string,
+                                   std::string& analyzed_query_string) {
+  std::stringstream stream(query_string);
+  std::string explain_string, analyze_string;
+  stream >> explain_string >> analyze_string;
+  boost::to_upper(explain_string);
+  boost::to_upper(analyze_string);
+  if (explain_string != "EXPLAIN" ||
+      (analyze_string != "ANALYZE" && analyze_string != "ANALYSE")) {
+    return false;
+  }
+
+  std::getline(stream, analyzed_query_string, '\0');
+  boost::trim(analyzed_query_string);
+  return true;
+}
+
 std::vector<FieldInfo> Statement::GetTupleDescriptor() const {
   return tuple_descriptor_;
 }
@@ -10,17 +10,22 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cinttypes>
 #include "concurrency/timestamp_ordering_transaction_manager.h"
 
 #include "catalog/manager.h"
+#include "common/container_tuple.h"
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/platform.h"
+#include "concurrency/epoch_manager_factory.h"
 #include "concurrency/transaction.h"
 #include "gc/gc_manager_factory.h"
 #include "logging/log_manager_factory.h"
 #include "settings/settings_manager.h"
+#include "storage/data_table.h"
+#include "storage/materialized_view.h"
 
 namespace peloton {
 namespace concurrency {
@@ -499,6 +504,35 @@ void TimestampOrderingTransactionManager::PerformInsert(
   }
 }
 
+// The version being superseded ended its predecessor when it committed, so
+// its begin commit id tells how long the predecessor has been garbage without
+// touching the predecessor's tile group. Long chains mean the GC falls behind
+// the workers, in which case the worker collects a batch of the partition.
+void TimestampOrderingTransactionManager::HelpGarbageCollection(
+    const storage::TileGroupHeader *const tile_group_header,
+    const oid_t tuple_id) {
+  auto &gc_manager = gc::GCManagerFactory::GetInstance();
+  if (gc_manager.GetStatus() == false) {
+    return;
+  }
+
+  ItemPointer older_location = tile_group_header->GetNextItemPointer(tuple_id);
+  if (older_location.IsNull() == true) {
+    return;
+  }
+
+  cid_t begin_cid = tile_group_header->GetBeginCommitId(tuple_id);
+  if (begin_cid == MAX_CID || begin_cid == INVALID_CID) {
+    return;
+  }
+
+  eid_t garbage_eid = begin_cid >> 32;
+  eid_t current_eid = EpochManagerFactory::GetInstance().GetCurrentEpochId();
+  if (garbage_eid + GC_HELP_EPOCH_LAG < current_eid) {
+    gc_manager.HelpCollect(older_location.block);
+  }
+}
+
 void TimestampOrderingTransactionManager::PerformUpdate(
     Transaction *const current_txn, const ItemPointer &location,
     const ItemPointer &new_location) {
@@ -574,6 +608,8 @@ void TimestampOrderingTransactionManager::PerformUpdate(
   // Add the old tuple into the update set
   current_txn->RecordUpdate(old_location);
 
+  HelpGarbageCollection(tile_group_header, old_location.offset);
+
   // Increment table update op stats
   if (settings::SettingsManager::GetInt(settings::SettingId::stats_mode) !=
       STATS_TYPE_INVALID) {
@@ -694,6 +730,8 @@ void TimestampOrderingTransactionManager::PerformDelete(
 
   current_txn->RecordDelete(old_location);
 
+  HelpGarbageCollection(tile_group_header, old_location.offset);
+
   // Increment table delete op stats
   if (settings::SettingsManager::GetInt(settings::SettingId::stats_mode) !=
       STATS_TYPE_INVALID) {
@@ -736,6 +774,80 @@ void TimestampOrderingTransactionManager::PerformDelete(
   }
 }
 
+// table -> materialized views over it
+typedef std::vector<std::shared_ptr<storage::MaterializedView>> ViewList;
+typedef std::unordered_map<storage::DataTable *, ViewList> TableViewMap;
+
+// The materialized views over the tables written by a transaction
+static TableViewMap GetMaterializedViews(const ReadWriteSet &rw_set) {
+  auto &manager = catalog::Manager::GetInstance();
+  TableViewMap table_views;
+  for (auto &tile_group_entry : rw_set) {
+    bool is_written = false;
+    for (auto &tuple_entry : tile_group_entry.second) {
+      if (tuple_entry.second != RWType::READ &&
+          tuple_entry.second != RWType::READ_OWN) {
+        is_written = true;
+        break;
+      }
+    }
+    if (is_written == false) continue;
+
+    auto table = dynamic_cast<storage::DataTable *>(
+        manager.GetTileGroup(tile_group_entry.first)->GetAbstractTable());
+    if (table == nullptr || table->HasMaterializedViews() == false ||
+        table_views.count(table) != 0) {
+      continue;
+    }
+    auto views = table->GetMaterializedViews();
+    if (views.empty() == false) {
+      table_views[table] = std::move(views);
+    }
+  }
+  return table_views;
+}
+
+// Apply the versions a transaction installed, and those it replaced, to the
+// views over their tables
+static void ApplyMaterializedViewDeltas(const ReadWriteSet &rw_set,
+                                        TableViewMap &table_views) {
+  auto &manager = catalog::Manager::GetInstance();
+  for (auto &tile_group_entry : rw_set) {
+    auto tile_group = manager.GetTileGroup(tile_group_entry.first);
+    auto table =
+        dynamic_cast<storage::DataTable *>(tile_group->GetAbstractTable());
+    auto views_itr = table_views.find(table);
+    if (views_itr == table_views.end()) continue;
+    auto tile_group_header = tile_group->GetHeader();
+
+    for (auto &tuple_entry : tile_group_entry.second) {
+      auto tuple_slot = tuple_entry.first;
+      ContainerTuple<storage::TileGroup> old_tuple(tile_group.get(),
+                                                   tuple_slot);
+
+      if (tuple_entry.second == RWType::UPDATE) {
+        ItemPointer new_version =
+            tile_group_header->GetPrevItemPointer(tuple_slot);
+        auto new_tile_group = manager.GetTileGroup(new_version.block);
+        ContainerTuple<storage::TileGroup> new_tuple(new_tile_group.get(),
+                                                     new_version.offset);
+        for (auto &view : views_itr->second) {
+          view->ApplyDelete(&old_tuple);
+          view->ApplyInsert(&new_tuple);
+        }
+      } else if (tuple_entry.second == RWType::DELETE) {
+        for (auto &view : views_itr->second) {
+          view->ApplyDelete(&old_tuple);
+        }
+      } else if (tuple_entry.second == RWType::INSERT) {
+        for (auto &view : views_itr->second) {
+          view->ApplyInsert(&old_tuple);
+        }
+      }
+    }
+  }
+}
+
 ResultType TimestampOrderingTransactionManager::CommitTransaction(
     Transaction *const current_txn) {
   LOG_TRACE("Committing peloton txn : %" PRId64, current_txn->GetTransactionId());
@@ -784,6 +896,25 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
     }
   }
 
+  // Latch the materialized views over the written tables until the versions
+  // are installed and applied to them, so that a view being rebuilt either
+  // sees the versions of this transaction or gets them applied afterwards.
+  // Views are latched in address order, so committers cannot deadlock.
+  TableViewMap table_views;
+  std::vector<storage::MaterializedView *> latched_views;
+  if (storage::MaterializedView::HasAnyViews()) {
+    table_views = GetMaterializedViews(rw_set);
+    for (auto &table_entry : table_views) {
+      for (auto &view : table_entry.second) {
+        latched_views.push_back(view.get());
+      }
+    }
+    std::sort(latched_views.begin(), latched_views.end());
+    for (auto view : latched_views) {
+      view->Lock(end_commit_id);
+    }
+  }
+
   // install everything.
   // 1. install a new version for update operations;
   // 2. install an empty version for delete operations;
@@ -905,6 +1036,13 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
     }
   }
 
+  if (latched_views.empty() == false) {
+    ApplyMaterializedViewDeltas(rw_set, table_views);
+    for (auto view : latched_views) {
+      view->Unlock();
+    }
+  }
+
   ResultType result = current_txn->GetResult();
 
   log_manager.LogEnd();
@@ -0,0 +1,247 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// epoch_reclaimer.cpp
+//
+// Identification: src/container/epoch_reclaimer.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "container/epoch_reclaimer.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "common/exception.h"
+
+namespace peloton {
+
+namespace {
+
+// A deleter the calling thread is running. Deleters can nest, so they form
+// a stack on the call stack, which leaves nothing to destroy at thread exit.
+struct CollectingFrame {
+  const void *slot;
+  const CollectingFrame *outer;
+};
+
+thread_local const CollectingFrame *collecting_frame = nullptr;
+
+}  // namespace
+
+// Releases the slot of a thread when the thread exits
+struct EpochReclaimer::ThreadSlotHandle {
+  ThreadSlot *slot = nullptr;
+
+  ~ThreadSlotHandle() {
+    if (slot != nullptr) {
+      EpochReclaimer::GetInstance().ReleaseThreadSlot(*slot);
+    }
+  }
+};
+
+EpochReclaimer &EpochReclaimer::GetInstance() {
+  static EpochReclaimer reclaimer;
+  return reclaimer;
+}
+
+EpochReclaimer::~EpochReclaimer() {
+  // No other thread can be running at this point. Freeing an object may
+  // retire others, e.g. the tile groups of a table.
+  while (GetGarbageCount() > 0) {
+    size_t slot_count = slot_count_.load();
+    for (size_t slot_itr = 0; slot_itr < slot_count; slot_itr++) {
+      Collect(slots_[slot_itr], QUIESCENT_EPOCH);
+    }
+  }
+}
+
+EpochReclaimer::ThreadSlot &EpochReclaimer::GetThreadSlot() {
+  static thread_local ThreadSlotHandle handle;
+  if (handle.slot != nullptr) {
+    return *handle.slot;
+  }
+
+  for (size_t slot_itr = 0; slot_itr < THREAD_SLOT_COUNT; slot_itr++) {
+    auto &slot = slots_[slot_itr];
+    bool in_use = false;
+    if (slot.in_use.load() == false &&
+        slot.in_use.compare_exchange_strong(in_use, true)) {
+      // Make the slot visible to the scans of other threads
+      size_t slot_count = slot_count_.load();
+      while (slot_count < slot_itr + 1 &&
+             !slot_count_.compare_exchange_weak(slot_count, slot_itr + 1)) {
+      }
+      handle.slot = &slot;
+      return slot;
+    }
+  }
+
+  throw Exception("Epoch reclaimer is out of thread slots");
+}
+
+void EpochReclaimer::ReleaseThreadSlot(ThreadSlot &slot) {
+  PL_ASSERT(slot.nesting == 0);
+  slot.nesting = 0;
+  slot.active_epoch.store(QUIESCENT_EPOCH, std::memory_order_release);
+
+  // Try to leave as little garbage as possible to the next owner
+  Collect(slot, GetSafeEpoch());
+  slot.in_use.store(false, std::memory_order_release);
+}
+
+void EpochReclaimer::Enter() {
+  auto &slot = GetThreadSlot();
+  if (slot.nesting++ > 0) {
+    return;
+  }
+
+  slot.active_epoch.store(global_epoch_.load(std::memory_order_acquire),
+                          std::memory_order_relaxed);
+  // The epoch must be published before any shared object is read
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void EpochReclaimer::Exit() {
+  auto &slot = GetThreadSlot();
+  PL_ASSERT(slot.nesting > 0);
+  if (--slot.nesting > 0) {
+    return;
+  }
+
+  slot.active_epoch.store(QUIESCENT_EPOCH, std::memory_order_release);
+}
+
+bool EpochReclaimer::InCriticalSection() { return GetThreadSlot().nesting > 0; }
+
+void EpochReclaimer::Retire(void *object, Deleter deleter, void *owner) {
+  auto &slot = GetThreadSlot();
+
+  // Ordered after the unlinking of the object by the caller
+  uint64_t epoch = global_epoch_.load(std::memory_order_seq_cst);
+
+  size_t garbage_count;
+  slot.garbage_lock.Lock();
+  slot.garbage.push_back({epoch, object, deleter, owner});
+  garbage_count = slot.garbage.size();
+  slot.garbage_count.store(garbage_count, std::memory_order_relaxed);
+  slot.garbage_lock.Unlock();
+
+  if (garbage_count >= RECLAIM_THRESHOLD) {
+    Reclaim();
+  }
+}
+
+size_t EpochReclaimer::Reclaim() {
+  global_epoch_.fetch_add(1);
+  return Collect(GetThreadSlot(), GetSafeEpoch());
+}
+
+size_t EpochReclaimer::ReclaimAll() {
+  global_epoch_.fetch_add(1);
+  uint64_t safe_epoch = GetSafeEpoch();
+
+  size_t freed_count = 0;
+  size_t slot_count = slot_count_.load();
+  for (size_t slot_itr = 0; slot_itr < slot_count; slot_itr++) {
+    if (slots_[slot_itr].garbage_count.load(std::memory_order_relaxed) > 0) {
+      freed_count += Collect(slots_[slot_itr], safe_epoch);
+    }
+  }
+  return freed_count;
+}
+
+size_t EpochReclaimer::ReclaimOwner(const void *owner) {
+  std::vector<Garbage> owned;
+
+  size_t slot_count = slot_count_.load();
+  for (size_t slot_itr = 0; slot_itr < slot_count; slot_itr++) {
+    auto &slot = slots_[slot_itr];
+    slot.garbage_lock.Lock();
+    auto split = std::stable_partition(
+        slot.garbage.begin(), slot.garbage.end(),
+        [owner](const Garbage &garbage) { return garbage.owner != owner; });
+    owned.insert(owned.end(), split, slot.garbage.end());
+    slot.garbage.erase(split, slot.garbage.end());
+    slot.garbage_count.store(slot.garbage.size(), std::memory_order_relaxed);
+    slot.garbage_lock.Unlock();
+  }
+
+  // Deleters may retire more objects, so they run outside of the latch
+  for (auto &garbage : owned) {
+    garbage.deleter(garbage.object, garbage.owner);
+  }
+
+  // A collection might have taken garbage of the owner off its list before
+  // we got there. The owner must outlive its deleter, so wait for the
+  // collections to finish, except for those of this thread: the owner may
+  // be destroyed by one of their deleters.
+  for (size_t slot_itr = 0; slot_itr < slot_count; slot_itr++) {
+    auto &slot = slots_[slot_itr];
+    size_t own_count = 0;
+    for (auto frame = collecting_frame; frame != nullptr;
+         frame = frame->outer) {
+      if (frame->slot == &slot) own_count++;
+    }
+    while (slot.collecting_count.load() > own_count) {
+      std::this_thread::yield();
+    }
+  }
+  return owned.size();
+}
+
+size_t EpochReclaimer::GetGarbageCount() const {
+  size_t garbage_count = 0;
+  size_t slot_count = slot_count_.load();
+  for (size_t slot_itr = 0; slot_itr < slot_count; slot_itr++) {
+    garbage_count += slots_[slot_itr].garbage_count.load();
+  }
+  return garbage_count;
+}
+
+uint64_t EpochReclaimer::GetSafeEpoch() const {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  uint64_t safe_epoch = QUIESCENT_EPOCH;
+  size_t slot_count = slot_count_.load();
+  for (size_t slot_itr = 0; slot_itr < slot_count; slot_itr++) {
+    safe_epoch = std::min(safe_epoch, slots_[slot_itr].active_epoch.load());
+  }
+  return safe_epoch;
+}
+
+size_t EpochReclaimer::Collect(ThreadSlot &slot, uint64_t safe_epoch) {
+  size_t freed_count = 0;
+
+  // Objects are taken off the list one at a time, so a deleter that
+  // destroys an owner never has garbage of that owner pending behind it
+  while (true) {
+    slot.garbage_lock.Lock();
+    // Garbage is retired in epoch order, so only a prefix can be expired
+    if (slot.garbage.empty() || slot.garbage.front().epoch >= safe_epoch) {
+      slot.garbage_lock.Unlock();
+      break;
+    }
+    Garbage garbage = slot.garbage.front();
+    slot.garbage.pop_front();
+    slot.garbage_count.store(slot.garbage.size(), std::memory_order_relaxed);
+    // Published under the latch, so ReclaimOwner() sees either the garbage
+    // or the collection
+    slot.collecting_count.fetch_add(1);
+    slot.garbage_lock.Unlock();
+
+    CollectingFrame frame{&slot, collecting_frame};
+    collecting_frame = &frame;
+    garbage.deleter(garbage.object, garbage.owner);
+    collecting_frame = frame.outer;
+    slot.collecting_count.fetch_sub(1);
+    freed_count++;
+  }
+  return freed_count;
+}
+
+}  // namespace peloton
@@ -10,10 +10,13 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <chrono>
+
 #include "type/value.h"
 #include "common/logger.h"
 #include "executor/abstract_executor.h"
 #include "executor/executor_context.h"
+#include "executor/query_profile.h"
 #include "planner/abstract_plan.h"
 
 namespace peloton {
@@ -74,6 +77,9 @@ bool AbstractExecutor::Init() {
     return false;
   }
 
+  profiling_ = executor_context_ != nullptr &&
+               executor_context_->GetProfile() != nullptr;
+
   return true;
 }
 
@@ -89,11 +95,38 @@ bool AbstractExecutor::Execute() {
   // TODO In the future, we might want to pass some kind of executor state to
   // GetNextTile. e.g. params for prepared plans.
 
+  if (profiling_ == false) {
+    return DExecute();
+  }
+
+  auto start = std::chrono::steady_clock::now();
   bool status = DExecute();
+  auto end = std::chrono::steady_clock::now();
+
+  profile_calls_++;
+  profile_time_ms_ +=
+      std::chrono::duration<double, std::milli>(end - start).count();
+  if (status == true && output != nullptr) {
+    profile_rows_ += output->GetTupleCount();
+  }
 
   return status;
 }
 
+void AbstractExecutor::CollectProfile() const {
+  if (profiling_ == false) return;
+
+  auto &profile = executor_context_->GetProfile()->GetOperatorProfile(node_);
+  profile.calls += profile_calls_;
+  profile.rows += profile_rows_;
+  profile.time_ms += profile_time_ms_;
+  AddProfileDetails(profile);
+
+  for (auto child : children_) {
+    child->CollectProfile();
+  }
+}
+
 void AbstractExecutor::SetContext(type::Value &value) {
   executor_context_->SetParams(value);
 }
@@ -297,6 +297,8 @@ void AbstractJoinExecutor::BufferRightTile(LogicalTile *right_tile) {
   switch (join_type_) {
     case JoinType::RIGHT:
     case JoinType::OUTER:
+    case JoinType::SEMI:
+    case JoinType::ANTI:
       UpdateRightJoinRowSets();
       break;
     default:
@@ -383,6 +385,11 @@ bool AbstractJoinExecutor::BuildOuterJoinOutput() {
 
     case JoinType::INNER: { return false; }
 
+    // Semi and anti joins return the right rows with and without a match
+    case JoinType::SEMI: { return BuildRightSemiJoinOutput(); }
+
+    case JoinType::ANTI: { return BuildRightJoinOutput(); }
+
     default: {
       throw Exception("Unsupported join type : " + JoinTypeToString(join_type_));
       break;
@@ -476,5 +483,36 @@ bool AbstractJoinExecutor::BuildRightJoinOutput() {
   return false;
 }
 
+/*
+ * build semi join output from the rows of each right tile that found a match,
+ * i.e. the ones missing from its row set
+ */
+bool AbstractJoinExecutor::BuildRightSemiJoinOutput() {
+  while (right_matching_idx < no_matching_right_row_sets_.size()) {
+    auto right_tile = right_result_tiles_[right_matching_idx].get();
+    auto &no_matching_rows = no_matching_right_row_sets_[right_matching_idx];
+    right_matching_idx++;
+
+    // Only columns of the right tile are projected
+    auto output_tile =
+        BuildOutputLogicalTile(nullptr, right_tile, proj_schema_);
+    LogicalTile::PositionListsBuilder pos_lists_builder(
+        nullptr, &(right_tile->GetPositionLists()));
+    for (auto right_row_itr : *right_tile) {
+      if (no_matching_rows.count(right_row_itr) == 0) {
+        pos_lists_builder.AddLeftNullRow(right_row_itr);
+      }
+    }
+    if (pos_lists_builder.Size() == 0) {
+      continue;
+    }
+
+    output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
+    SetOutput(output_tile.release());
+    return true;
+  }
+  return false;
+}
+
 }  // namespace executor
 }  // namespace peloton
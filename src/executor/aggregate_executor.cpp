@@ -10,6 +10,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <sstream>
+
 #include "common/container_tuple.h"
 #include "common/logger.h"
 #include "concurrency/transaction_manager_factory.h"
@@ -17,6 +19,7 @@
 #include "executor/aggregator.h"
 #include "executor/executor_context.h"
 #include "executor/logical_tile_factory.h"
+#include "executor/query_profile.h"
 #include "planner/aggregate_plan.h"
 #include "storage/table_factory.h"
 
@@ -135,7 +138,17 @@ bool AggregateExecutor::DExecute() {
   }
 
   LOG_TRACE("Finalizing..");
-  if (!aggregator.get() || !aggregator->Finalize()) {
+  bool finalized = aggregator.get() != nullptr && aggregator->Finalize();
+
+  // Keep what the hash aggregator went through for EXPLAIN ANALYZE
+  auto hash_aggregator = dynamic_cast<HashAggregator *>(aggregator.get());
+  if (hash_aggregator != nullptr) {
+    peak_memory_used_ = hash_aggregator->GetPeakMemoryUsed();
+    spilled_tuple_count_ = hash_aggregator->GetSpilledTupleCount();
+    max_spill_depth_ = hash_aggregator->GetMaxSpillDepth();
+  }
+
+  if (!finalized) {
     // If there's no tuples and no group-by, count() aggregations should return
     // 0 according to the test in MySQL.
     // TODO: We only checked whether all AggTerms are counts here. If there're
@@ -196,5 +209,17 @@ bool AggregateExecutor::DExecute() {
   return true;
 }
 
+void AggregateExecutor::AddProfileDetails(OperatorProfile &profile) const {
+  const planner::AggregatePlan *node =
+      static_cast<const planner::AggregatePlan *>(GetRawNode());
+  if (node->GetAggregateStrategy() != AggregateType::HASH) return;
+
+  std::ostringstream os;
+  os << "Peak Memory: " << (peak_memory_used_ + 1023) / 1024 << " kB"
+     << "  Spilled Tuples: " << spilled_tuple_count_
+     << "  Spill Depth: " << max_spill_depth_;
+  profile.details.push_back(os.str());
+}
+
 }  // namespace executor
 }  // namespace peloton
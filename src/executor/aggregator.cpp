@@ -12,6 +12,8 @@
 
 #include "executor/aggregator.h"
 
+#include <algorithm>
+
 #include "catalog/manager.h"
 #include "common/logger.h"
 #include "concurrency/transaction_manager_factory.h"
@@ -154,21 +156,11 @@ HashAggregator::HashAggregator(const planner::AggregatePlan *node,
                                executor::ExecutorContext *econtext,
                                size_t num_input_columns)
     : AbstractAggregator(node, output_table, econtext),
-      num_input_columns(num_input_columns) {}
-//  group_by_key_values.resize(node->GetGroupbyColIds().size(),
-//      type::ValueFactory::GetNullValueByType(type::TypeId::INTEGER));
-//}
+      num_input_columns(num_input_columns),
+      memory_budget_(econtext != nullptr ? &econtext->GetMemoryBudget()
+                                         : nullptr) {}
 
-HashAggregator::~HashAggregator() {
-  for (auto entry : aggregates_map) {
-    // Clean up allocated storage
-    for (size_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
-      delete entry.second->aggregates[aggno];
-    }
-    delete[] entry.second->aggregates;
-    delete entry.second;
-  }
-}
+HashAggregator::~HashAggregator() { ClearGroups(); }
 
 bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
   AggregateList *aggregate_list;
@@ -186,6 +178,19 @@ bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
 
   // Group not found. Make a new entry in the hash for this new group.
   if (map_itr == aggregates_map.end()) {
+    // No room for another group, defer it to a later pass. The first group
+    // of a pass always gets in, so that every pass makes progress.
+    size_t group_size = EstimateGroupSize(cur_tuple);
+    if (memory_budget_ != nullptr) {
+      if (memory_used_ == 0 ||
+          spill_depth_ >= HASH_AGGREGATE_MAX_SPILL_DEPTH) {
+        memory_budget_->Charge(group_size);
+      } else if (memory_budget_->Reserve(group_size) == false) {
+        SpillTuple(cur_tuple);
+        return true;
+      }
+    }
+
     LOG_TRACE("Group-by key not found. Start a new group.");
     // Allocate new aggregate list
     aggregate_list = new AggregateList();
@@ -206,6 +211,8 @@ bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
 
     aggregates_map.insert(
         HashAggregateMapType::value_type(group_by_key_values, aggregate_list));
+    memory_used_ += group_size;
+    peak_memory_used_ = std::max(peak_memory_used_, memory_used_);
   }
   // Otherwise, the list is the second item of the pair.
   else {
@@ -228,6 +235,51 @@ bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
 }
 
 bool HashAggregator::Finalize() {
+  if (FlushGroups() == false) {
+    return false;
+  }
+
+  // Aggregate the spilled partitions one at a time, most recently spilled
+  // first, so that at most one level of partitions per pass is on disk.
+  std::vector<std::pair<size_t, std::unique_ptr<SpillFile>>> pending;
+  auto collect_partitions = [this, &pending]() {
+    for (auto &partition : spill_partitions_) {
+      if (partition != nullptr) {
+        pending.emplace_back(spill_depth_ + 1, std::move(partition));
+      }
+    }
+    spill_partitions_.clear();
+  };
+  collect_partitions();
+
+  std::vector<type::Value> values;
+  ContainerTuple<std::vector<type::Value>> spilled_tuple(&values);
+  while (pending.empty() == false) {
+    spill_depth_ = pending.back().first;
+    std::unique_ptr<SpillFile> partition(std::move(pending.back().second));
+    pending.pop_back();
+
+    LOG_TRACE("Aggregating spilled partition of %lu tuples at depth %lu",
+              partition->GetRowCount(), spill_depth_);
+
+    partition->Rewind();
+    while (partition->Next(values)) {
+      if (Advance(&spilled_tuple) == false) {
+        return false;
+      }
+    }
+    partition.reset();
+
+    if (FlushGroups() == false) {
+      return false;
+    }
+    collect_partitions();
+  }
+
+  return true;
+}
+
+bool HashAggregator::FlushGroups() {
   for (auto entry : aggregates_map) {
     // Construct a container for the first tuple
     ContainerTuple<std::vector<type::Value>> first_tuple(
@@ -237,9 +289,82 @@ bool HashAggregator::Finalize() {
       return false;
     }
   }
+
+  ClearGroups();
   return true;
 }
 
+void HashAggregator::ClearGroups() {
+  for (auto entry : aggregates_map) {
+    // Clean up allocated storage
+    for (size_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
+      delete entry.second->aggregates[aggno];
+    }
+    delete[] entry.second->aggregates;
+    delete entry.second;
+  }
+  aggregates_map.clear();
+  if (memory_budget_ != nullptr) {
+    memory_budget_->Release(memory_used_);
+  }
+  memory_used_ = 0;
+}
+
+void HashAggregator::SpillTuple(const AbstractTuple *tuple) {
+  // Mix the key hash with the depth so that a partition that is split again
+  // spreads over all partitions of the next level
+  uint64_t hash = ValueVectorHasher()(group_by_key_values) +
+                  (spill_depth_ + 1) * 0x9e3779b97f4a7c15ULL;
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  size_t partition_idx = hash % HASH_AGGREGATE_SPILL_PARTITIONS;
+
+  if (spill_partitions_.empty()) {
+    spill_partitions_.resize(HASH_AGGREGATE_SPILL_PARTITIONS);
+    max_spill_depth_ = std::max(max_spill_depth_, spill_depth_ + 1);
+    LOG_DEBUG("Hash aggregation exceeded the query memory budget of %lu "
+              "bytes, spilling at depth %lu",
+              memory_budget_->GetLimit(), spill_depth_ + 1);
+  }
+  auto &partition = spill_partitions_[partition_idx];
+  if (partition == nullptr) {
+    partition.reset(new SpillFile());
+  }
+
+  spill_values_.clear();
+  for (size_t col_id = 0; col_id < num_input_columns; col_id++) {
+    spill_values_.push_back(tuple->GetValue(col_id));
+  }
+  partition->Append(spill_values_);
+  spilled_tuple_count_++;
+}
+
+size_t HashAggregator::EstimateGroupSize(const AbstractTuple *tuple) const {
+  // Group key and first tuple values, the aggregate list and the hash table
+  // node. Aggregators are assumed to hold a single value each.
+  size_t num_aggregates = node->GetUniqueAggTerms().size();
+  size_t size = sizeof(AggregateList) + 4 * sizeof(void *) +
+                (group_by_key_values.size() + num_input_columns) *
+                    sizeof(type::Value) +
+                num_aggregates * (sizeof(void *) + sizeof(SumAggregator));
+
+  for (auto &value : group_by_key_values) {
+    if (value.IsInlined() == false && value.IsNull() == false) {
+      size += value.GetLength();
+    }
+  }
+  for (size_t col_id = 0; col_id < num_input_columns; col_id++) {
+    auto value = tuple->GetValue(col_id);
+    if (value.IsInlined() == false && value.IsNull() == false) {
+      size += value.GetLength();
+    }
+  }
+  return size;
+}
+
 //===--------------------------------------------------------------------===//
 // Sort Aggregator
 //===--------------------------------------------------------------------===//
@@ -10,14 +10,54 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+
 #include "common/logger.h"
+#include "concurrency/transaction.h"
+#include "executor/executor_context.h"
 #include "executor/logical_tile.h"
 #include "executor/append_executor.h"
 #include "planner/append_plan.h"
+#include "threadpool/mono_queue_pool.h"
+#include "threadpool/parallel_for.h"
 
 namespace peloton {
 namespace executor {
 
+// Tiles the workers of a parallel append buffer before they wait for the
+// executor to take some
+static const size_t kMaxBufferedTiles = 64;
+
+// Shared by the executor and its workers. Workers that run late hold on to
+// it after the executor is gone, but by then there is no child to claim.
+struct AppendExecutor::ParallelState {
+  explicit ParallelState(const std::vector<AbstractExecutor *> &children)
+      : children(children) {}
+
+  const std::vector<AbstractExecutor *> children;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+
+  // Children are claimed in order, by the workers and the executor
+  size_t next_child_id = 0;
+  size_t done_count = 0;
+
+  // Workers running a child, the executor waits for them before the
+  // children go away
+  size_t running_workers = 0;
+  bool stopped = false;
+
+  std::deque<std::unique_ptr<LogicalTile>> tiles;
+  std::exception_ptr error;
+};
+
+static void NoCallback(UNUSED_ATTRIBUTE void *arg) {}
+
 /**
  * @brief Constructor
  */
@@ -25,21 +65,51 @@ AppendExecutor::AppendExecutor(const planner::AbstractPlan *node,
                                ExecutorContext *executor_context)
     : AbstractExecutor(node, executor_context) {}
 
+AppendExecutor::~AppendExecutor() { StopWorkers(); }
+
 /**
  * @brief Basic checks.
  * @return true on success, false otherwise.
  */
 bool AppendExecutor::DInit() {
-  // should have >= 2 children, otherwise pointless.
-  PL_ASSERT(children_.size() >= 2);
+  // Scans of pruned partitions may leave any number of children
   PL_ASSERT(cur_child_id_ == 0);
 
+  const planner::AppendPlan &node = GetPlanNode<planner::AppendPlan>();
+  auto txn = executor_context_ != nullptr
+                 ? executor_context_->GetTransaction()
+                 : nullptr;
+  parallel_ = node.IsParallel() && children_.size() > 1 && txn != nullptr &&
+              txn->GetIsolationLevel() == IsolationLevelType::READ_ONLY;
+
+  StopWorkers();
+  parallel_state_.reset();
+  own_child_ = nullptr;
+  if (parallel_ == false) {
+    return true;
+  }
+
+  // The executor runs children as well, so one worker less than the
+  // children keeps all of them busy
+  parallel_state_ = std::make_shared<ParallelState>(children_);
+  size_t worker_count =
+      std::min(children_.size(), threadpool::GetParallelism()) - 1;
+  for (size_t worker_itr = 0; worker_itr < worker_count; worker_itr++) {
+    threadpool::MonoQueuePool::GetInstance().SubmitTask(
+        RunWorker, new std::shared_ptr<ParallelState>(parallel_state_),
+        NoCallback, nullptr);
+  }
+
   return true;
 }
 
 bool AppendExecutor::DExecute() {
   LOG_TRACE("Append executor ");
 
+  if (parallel_) {
+    return ExecuteParallel();
+  }
+
   while (cur_child_id_ < children_.size()) {
     if (children_[cur_child_id_]->Execute()) {
       SetOutput(children_[cur_child_id_]->GetOutput());
@@ -51,5 +121,113 @@ bool AppendExecutor::DExecute() {
   return false;
 }
 
+void AppendExecutor::RunWorker(void *arg) {
+  std::unique_ptr<std::shared_ptr<ParallelState>> state_ptr(
+      static_cast<std::shared_ptr<ParallelState> *>(arg));
+  auto &state = **state_ptr;
+
+  std::unique_lock<std::mutex> lock(state.mutex);
+  while (state.next_child_id < state.children.size()) {
+    auto child = state.children[state.next_child_id++];
+    state.running_workers++;
+
+    std::exception_ptr error;
+    while (true) {
+      state.cv.wait(lock, [&] {
+        return state.stopped || state.tiles.size() < kMaxBufferedTiles;
+      });
+      if (state.stopped) break;
+
+      lock.unlock();
+      std::unique_ptr<LogicalTile> tile;
+      bool has_tile = false;
+      try {
+        has_tile = child->Execute();
+        if (has_tile) tile.reset(child->GetOutput());
+      } catch (...) {
+        error = std::current_exception();
+      }
+      lock.lock();
+
+      if (has_tile == false || state.stopped) break;
+      state.tiles.push_back(std::move(tile));
+      state.cv.notify_all();
+    }
+
+    if (error != nullptr && state.error == nullptr) {
+      state.error = error;
+    }
+    state.running_workers--;
+    state.done_count++;
+    state.cv.notify_all();
+  }
+}
+
+bool AppendExecutor::ExecuteParallel() {
+  auto &state = *parallel_state_;
+  while (true) {
+    std::unique_lock<std::mutex> lock(state.mutex);
+    // Claim a child to run here, or wait for the workers if none is left
+    if (own_child_ == nullptr) {
+      if (state.next_child_id < state.children.size()) {
+        own_child_ = state.children[state.next_child_id++];
+      } else {
+        state.cv.wait(lock, [&] {
+          return state.error != nullptr || !state.tiles.empty() ||
+                 state.done_count == state.children.size();
+        });
+      }
+    }
+
+    if (state.error != nullptr) {
+      auto error = state.error;
+      lock.unlock();
+      StopWorkers();
+      std::rethrow_exception(error);
+    }
+
+    // Tiles of the workers go first, so they can keep going
+    if (!state.tiles.empty()) {
+      SetOutput(state.tiles.front().release());
+      state.tiles.pop_front();
+      state.cv.notify_all();
+      return true;
+    }
+
+    if (own_child_ == nullptr) {
+      return false;
+    }
+    lock.unlock();
+
+    bool has_tile;
+    try {
+      has_tile = own_child_->Execute();
+    } catch (...) {
+      StopWorkers();
+      throw;
+    }
+    if (has_tile) {
+      SetOutput(own_child_->GetOutput());
+      return true;
+    }
+
+    own_child_ = nullptr;
+    lock.lock();
+    state.done_count++;
+  }
+}
+
+void AppendExecutor::StopWorkers() {
+  if (parallel_state_ == nullptr) {
+    return;
+  }
+  auto &state = *parallel_state_;
+  std::unique_lock<std::mutex> lock(state.mutex);
+  state.next_child_id = state.children.size();
+  state.stopped = true;
+  state.cv.notify_all();
+  state.cv.wait(lock, [&] { return state.running_workers == 0; });
+}
+
 }  // namespace executor
 }  // namespace peloton
@@ -21,6 +21,16 @@
 #include "network/postgres_protocol_handler.h"
 #include "common/exception.h"
 #include "common/macros.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tuple.h"
+#include "type/ephemeral_pool.h"
+#include "type/value_factory.h"
+#include "index/index.h"
+#include "threadpool/parallel_for.h"
+#include "type/limits.h"
+#include <algorithm>
+#include <cerrno>
 #include <sys/stat.h>
 #include <sys/mman.h>
 
@@ -42,11 +52,35 @@ CopyExecutor::~CopyExecutor() {}
  * @return true on success, false otherwise.
  */
 bool CopyExecutor::DInit() {
-  PL_ASSERT(children_.size() == 1);
-
   // Grab info from plan node and check it
   const planner::CopyPlan &node = GetPlanNode<planner::CopyPlan>();
 
+  if (node.is_import) {
+    PL_ASSERT(children_.size() == 0);
+    import_table_ = node.target_table;
+    if (import_table_ == nullptr) {
+      throw ExecutorException("Target table of COPY FROM does not exist");
+    }
+    delimiter = node.delimiter;
+    import_csv_format_ = node.csv_format;
+
+    // Rows are inserted in primary key order within each chunk, so that
+    // consecutive index inserts hit neighbouring leaves
+    import_key_attrs_.clear();
+    for (oid_t index_itr = 0; index_itr < import_table_->GetIndexCount();
+         index_itr++) {
+      auto index = import_table_->GetIndex(index_itr);
+      if (index != nullptr &&
+          index->GetIndexType() == IndexConstraintType::PRIMARY_KEY) {
+        import_key_attrs_ = index->GetMetadata()->GetKeyAttrs();
+        break;
+      }
+    }
+    return true;
+  }
+
+  PL_ASSERT(children_.size() == 1);
+
   bool success = InitFileHandle(node.file_path.c_str(), "w");
 
   if (success == false) {
@@ -187,6 +221,12 @@ bool CopyExecutor::DExecute() {
     return false;
   }
 
+  const planner::CopyPlan &node = GetPlanNode<planner::CopyPlan>();
+  if (node.is_import) {
+    done = true;
+    return ExecuteImport();
+  }
+
   while (children_[0]->Execute() == true) {
     // Get input a tile
     std::unique_ptr<LogicalTile> logical_tile(children_[0]->GetOutput());
@@ -304,5 +344,412 @@ bool CopyExecutor::DExecute() {
   return true;
 }
 
+//===--------------------------------------------------------------------===//
+// COPY FROM
+//===--------------------------------------------------------------------===//
+
+/**
+ * Import the rows of a file (or of the data the client streamed with
+ * COPY FROM STDIN) into the target table, all within the current
+ * transaction. The input is split into chunks on row boundaries, and the
+ * chunks are parsed into tuples by a set of threads. The tuples of each
+ * chunk are sorted on the primary key. The threads copy the tuples that fill
+ * whole tile groups into new tile groups, which are then added to the table
+ * with their keys inserted into each index as a sorted batch. Only the
+ * remaining tuples of a chunk go through the regular insert path. Chunks
+ * are processed in rounds of one chunk per thread to bound the memory held
+ * by parsed tuples.
+ *
+ * @return true on success, false if a row violates a constraint.
+ */
+bool CopyExecutor::ExecuteImport() {
+  const planner::CopyPlan &node = GetPlanNode<planner::CopyPlan>();
+
+  // Get hold of the input. Files are mapped, not read into a buffer.
+  const char *data = nullptr;
+  size_t size = 0;
+  void *mapped = MAP_FAILED;
+  if (node.IsCopyFromStdin()) {
+    data = node.GetCopyData().data();
+    size = node.GetCopyData().size();
+  } else {
+    bool success = InitFileHandle(node.file_path.c_str(), "r");
+    if (success == false) {
+      throw ExecutorException("Failed to open file " + node.file_path +
+                              ". Try absolute path and make sure you have the "
+                              "permission to access this file.");
+    }
+    struct stat file_stat;
+    if (fstat(file_handle_.fd, &file_stat) != 0) {
+      fclose(file_handle_.file);
+      throw ExecutorException("Failed to stat file " + node.file_path);
+    }
+    size = file_stat.st_size;
+    if (size > 0) {
+      mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file_handle_.fd, 0);
+      if (mapped == MAP_FAILED) {
+        fclose(file_handle_.file);
+        throw ExecutorException("Failed to map file " + node.file_path);
+      }
+      madvise(mapped, size, MADV_SEQUENTIAL);
+      data = static_cast<const char *>(mapped);
+    }
+  }
+
+  auto chunks = SplitImportData(data, size);
+  LOG_DEBUG("Importing %lu bytes in %lu chunks", size, chunks.size());
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto current_txn = executor_context_->GetTransaction();
+  size_t thread_count = threadpool::GetParallelism();
+  std::string error;
+  bool success = true;
+
+  for (size_t round_begin = 0; round_begin < chunks.size() && success &&
+                                   error.empty();
+       round_begin += thread_count) {
+    size_t round_end = std::min(round_begin + thread_count, chunks.size());
+
+    // Parse the chunks of this round in parallel on the worker pool
+    threadpool::ParallelFor(round_end - round_begin, thread_count,
+                            [&](size_t chunk_offset) {
+                              ParseImportChunk(chunks[round_begin +
+                                                      chunk_offset]);
+                            });
+
+    // Insert them in input order
+    for (size_t chunk_itr = round_begin; chunk_itr < round_end; chunk_itr++) {
+      auto &chunk = chunks[chunk_itr];
+      if (chunk.error.empty() == false) {
+        error = chunk.error;
+        break;
+      }
+      if (chunk.violates_constraint) {
+        LOG_TRACE("Constraint violated. Set txn failure.");
+        txn_manager.SetTransactionResult(current_txn, ResultType::FAILURE);
+        success = false;
+        break;
+      }
+
+      for (auto &tile_group : chunk.tile_groups) {
+        if (import_table_->InsertTileGroup(tile_group, current_txn) == false) {
+          LOG_TRACE("Failed to insert tile group. Set txn failure.");
+          txn_manager.SetTransactionResult(current_txn, ResultType::FAILURE);
+          success = false;
+          break;
+        }
+        executor_context_->num_processed += tile_group->GetNextTupleSlot();
+      }
+      chunk.tile_groups.clear();
+      if (success == false) break;
+
+      for (auto &tuple : chunk.tuples) {
+        ItemPointer *index_entry_ptr = nullptr;
+        ItemPointer location =
+            import_table_->InsertTuple(tuple.get(), current_txn,
+                                       &index_entry_ptr);
+        if (location.block == INVALID_OID) {
+          LOG_TRACE("Failed to Insert. Set txn failure.");
+          txn_manager.SetTransactionResult(current_txn, ResultType::FAILURE);
+          success = false;
+          break;
+        }
+        txn_manager.PerformInsert(current_txn, location, index_entry_ptr);
+        executor_context_->num_processed += 1;
+      }
+
+      // Release the parsed tuples as soon as they are in the table
+      chunk.tuples.clear();
+      chunk.pool.reset();
+      if (success == false) break;
+    }
+  }
+
+  if (mapped != MAP_FAILED) {
+    munmap(mapped, size);
+  }
+  if (node.IsCopyFromStdin() == false) {
+    fclose(file_handle_.file);
+  }
+
+  if (error.empty() == false) {
+    txn_manager.SetTransactionResult(current_txn, ResultType::FAILURE);
+    throw ExecutorException("COPY FROM failed: " + error);
+  }
+
+  LOG_DEBUG("Imported %u rows", executor_context_->num_processed);
+  return success;
+}
+
+std::vector<CopyExecutor::ImportChunk> CopyExecutor::SplitImportData(
+    const char *data, size_t size) {
+  std::vector<ImportChunk> chunks;
+  const char *end = data + size;
+  const char *chunk_begin = data;
+  size_t chunk_first_line = 1;
+  size_t line = 1;
+  bool in_quotes = false;
+
+  // A newline only ends a row outside of a quoted csv field, so we have to
+  // track the quotes from the start of the input
+  for (const char *pos = data; pos < end; pos++) {
+    if (import_csv_format_ && *pos == '"') {
+      in_quotes = !in_quotes;
+    } else if (*pos == new_line) {
+      line++;
+      if (in_quotes == false &&
+          static_cast<size_t>(pos + 1 - chunk_begin) >=
+              COPY_IMPORT_CHUNK_SIZE) {
+        chunks.push_back({chunk_begin, pos + 1, chunk_first_line, nullptr,
+                          {}, {}, false, std::string()});
+        chunk_begin = pos + 1;
+        chunk_first_line = line;
+      }
+    }
+  }
+  if (chunk_begin < end) {
+    chunks.push_back({chunk_begin, end, chunk_first_line, nullptr, {}, {},
+                      false, std::string()});
+  }
+  return chunks;
+}
+
+bool CopyExecutor::ParseImportField(const char *&pos, const char *end,
+                                    std::string &field) {
+  field.clear();
+
+  // csv: "quoted, ""escaped"" field", an empty unquoted field is NULL
+  if (import_csv_format_) {
+    if (pos < end && *pos == '"') {
+      pos++;
+      while (pos < end) {
+        if (*pos == '"') {
+          if (pos + 1 < end && pos[1] == '"') {
+            field.push_back('"');
+            pos += 2;
+            continue;
+          }
+          pos++;
+          break;
+        }
+        field.push_back(*pos++);
+      }
+      // Skip anything up to the end of the field
+      while (pos < end && *pos != delimiter && *pos != new_line) pos++;
+      return true;
+    }
+
+    const char *field_begin = pos;
+    while (pos < end && *pos != delimiter && *pos != new_line) pos++;
+    const char *field_end = pos;
+    if (field_end > field_begin && field_end[-1] == '\r') field_end--;
+    field.assign(field_begin, field_end);
+    return field_end != field_begin;
+  }
+
+  // text: backslash escapes, \N is NULL
+  const char *field_begin = pos;
+  while (pos < end && *pos != delimiter && *pos != new_line) {
+    if (*pos == '\r' && pos + 1 < end && pos[1] == new_line) {
+      pos++;
+      break;
+    }
+    if (*pos == '\\' && pos + 1 < end) {
+      pos++;
+      switch (*pos) {
+        case 't':
+          field.push_back('\t');
+          break;
+        case 'n':
+          field.push_back('\n');
+          break;
+        case 'r':
+          field.push_back('\r');
+          break;
+        default:
+          field.push_back(*pos);
+      }
+      pos++;
+      continue;
+    }
+    field.push_back(*pos++);
+  }
+  bool is_null = field == "N" && pos - field_begin >= 2 &&
+                 field_begin[0] == '\\' && field_begin[1] == 'N';
+  return is_null == false;
+}
+
+// Parse a field of the imported data straight into a value of the column
+// type. Types without a textual fast path go through a VARCHAR cast.
+static type::Value ParseImportValue(const std::string &field,
+                                    type::TypeId type_id) {
+  const char *begin = field.c_str();
+  char *end = nullptr;
+  auto check_end = [&] {
+    while (*end == ' ') end++;
+    if (end == begin || *end != '\0') {
+      throw ConversionException("invalid input for type " +
+                                TypeIdToString(type_id) + ": \"" + field +
+                                "\"");
+    }
+  };
+
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT: {
+      errno = 0;
+      long long value = strtoll(begin, &end, 10);
+      check_end();
+      int64_t min = type::PELOTON_INT64_MIN;
+      int64_t max = type::PELOTON_INT64_MAX;
+      if (type_id == type::TypeId::TINYINT) {
+        min = type::PELOTON_INT8_MIN;
+        max = type::PELOTON_INT8_MAX;
+      } else if (type_id == type::TypeId::SMALLINT) {
+        min = type::PELOTON_INT16_MIN;
+        max = type::PELOTON_INT16_MAX;
+      } else if (type_id == type::TypeId::INTEGER) {
+        min = type::PELOTON_INT32_MIN;
+        max = type::PELOTON_INT32_MAX;
+      }
+      if (errno == ERANGE || value < min || value > max) {
+        throw ValueOutOfRangeException(static_cast<int64_t>(value),
+                                       type::TypeId::VARCHAR, type_id);
+      }
+      switch (type_id) {
+        case type::TypeId::TINYINT:
+          return type::ValueFactory::GetTinyIntValue(
+              static_cast<int8_t>(value));
+        case type::TypeId::SMALLINT:
+          return type::ValueFactory::GetSmallIntValue(
+              static_cast<int16_t>(value));
+        case type::TypeId::INTEGER:
+          return type::ValueFactory::GetIntegerValue(
+              static_cast<int32_t>(value));
+        default:
+          return type::ValueFactory::GetBigIntValue(value);
+      }
+    }
+    case type::TypeId::DECIMAL: {
+      errno = 0;
+      double value = strtod(begin, &end);
+      check_end();
+      if (errno == ERANGE) {
+        throw ValueOutOfRangeException(value, type::TypeId::VARCHAR, type_id);
+      }
+      return type::ValueFactory::GetDecimalValue(value);
+    }
+    case type::TypeId::VARCHAR:
+      return type::ValueFactory::GetVarcharValue(field);
+    default:
+      return type::ValueFactory::GetVarcharValue(field).CastAs(type_id);
+  }
+}
+
+void CopyExecutor::ParseImportChunk(ImportChunk &chunk) {
+  auto schema = import_table_->GetSchema();
+  auto column_count = schema->GetColumnCount();
+  chunk.pool.reset(new type::EphemeralPool());
+
+  size_t line = chunk.first_line;
+  std::string field;
+  const char *pos = chunk.begin;
+  try {
+    while (pos < chunk.end) {
+      // Skip empty lines, unless an empty line is a row of one empty field
+      if (column_count > 1 && (*pos == new_line || *pos == '\r')) {
+        if (*pos == new_line) line++;
+        pos++;
+        continue;
+      }
+
+      std::unique_ptr<storage::Tuple> tuple(new storage::Tuple(schema, true));
+      oid_t column_itr = 0;
+      while (true) {
+        bool not_null = ParseImportField(pos, chunk.end, field);
+        if (column_itr >= column_count) {
+          chunk.error = "line " + std::to_string(line) + ": expected " +
+                        std::to_string(column_count) + " columns";
+          return;
+        }
+        if (not_null) {
+          tuple->SetValue(column_itr,
+                          ParseImportValue(field, schema->GetType(column_itr)),
+                          chunk.pool.get());
+        } else {
+          tuple->SetValue(column_itr, type::ValueFactory::GetNullValueByType(
+                                          schema->GetType(column_itr)),
+                          chunk.pool.get());
+        }
+        column_itr++;
+
+        if (pos < chunk.end && *pos == delimiter) {
+          pos++;
+          continue;
+        }
+        break;
+      }
+      if (column_itr != column_count) {
+        chunk.error = "line " + std::to_string(line) + ": expected " +
+                      std::to_string(column_count) + " columns";
+        return;
+      }
+
+      // Step over the newline
+      if (pos < chunk.end) pos++;
+      line++;
+      chunk.tuples.push_back(std::move(tuple));
+    }
+  } catch (Exception &e) {
+    chunk.error = "line " + std::to_string(line) + ": " + e.what();
+    return;
+  }
+
+  // Sort on the primary key
+  if (import_key_attrs_.empty() == false) {
+    const auto &key_attrs = import_key_attrs_;
+    std::stable_sort(
+        chunk.tuples.begin(), chunk.tuples.end(),
+        [&key_attrs](const std::unique_ptr<storage::Tuple> &left,
+                     const std::unique_ptr<storage::Tuple> &right) {
+          for (auto column_id : key_attrs) {
+            auto left_value = left->GetValue(column_id);
+            auto right_value = right->GetValue(column_id);
+            if (left_value.CompareLessThan(right_value) == type::CMP_TRUE) {
+              return true;
+            }
+            if (left_value.CompareGreaterThan(right_value) ==
+                type::CMP_TRUE) {
+              return false;
+            }
+          }
+          return false;
+        });
+  }
+
+  // Copy the tuples that fill whole tile groups into new ones. A partly
+  // filled tile group would never get the rest of its slots used, so the
+  // last tuples are left to the regular insert path.
+  size_t tile_group_size = import_table_->GetTuplesPerTileGroup();
+  size_t bulk_count =
+      chunk.tuples.size() / tile_group_size * tile_group_size;
+  for (size_t tuple_itr = 0; tuple_itr < bulk_count; tuple_itr++) {
+    auto &tuple = chunk.tuples[tuple_itr];
+    if (import_table_->CheckConstraints(tuple.get()) == false) {
+      chunk.violates_constraint = true;
+      return;
+    }
+    if (tuple_itr % tile_group_size == 0) {
+      chunk.tile_groups.push_back(import_table_->NewBulkLoadTileGroup());
+    }
+    chunk.tile_groups.back()->InsertTuple(tuple.get());
+    tuple.reset();
+  }
+  chunk.tuples.erase(chunk.tuples.begin(),
+                     chunk.tuples.begin() + bulk_count);
+}
+
 }  // namespace executor
 }  // namespace peloton
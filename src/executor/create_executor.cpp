@@ -17,16 +17,33 @@
 #include "catalog/trigger_catalog.h"
 #include "catalog/database_catalog.h"
 #include "catalog/table_catalog.h"
+#include "concurrency/epoch_manager_factory.h"
 #include "concurrency/transaction.h"
 #include "executor/executor_context.h"
 #include "planner/create_plan.h"
+#include "storage/data_table.h"
 #include "storage/database.h"
+#include "storage/materialized_view.h"
 #include "storage/storage_manager.h"
 #include "type/value_factory.h"
 
 namespace peloton {
 namespace executor {
 
+// Whether values of the type can be summed
+static bool IsNumericType(type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+    case type::TypeId::DECIMAL:
+      return true;
+    default:
+      return false;
+  }
+}
+
 // Constructor for drop executor
 CreateExecutor::CreateExecutor(const planner::AbstractPlan *node,
                                ExecutorContext *executor_context)
@@ -215,6 +232,77 @@ bool CreateExecutor::DExecute() {
       break;
     }
 
+    // if query was for creating a materialized view
+    case CreateType::MATERIALIZED_VIEW: {
+      std::string database_name = node.GetDatabaseName();
+      std::string view_name = node.GetViewName();
+      auto catalog = catalog::Catalog::GetInstance();
+      auto table = catalog->GetTableWithName(database_name,
+                                             node.GetTableName(), current_txn);
+
+      // Views are not in the catalog, their names are unique among the views
+      // over the tables of the database
+      auto database = catalog->GetDatabaseWithName(database_name, current_txn);
+      for (oid_t table_itr = 0; table_itr < database->GetTableCount();
+           table_itr++) {
+        if (database->GetTable(table_itr)->GetMaterializedView(view_name) !=
+            nullptr) {
+          throw CatalogException("Materialized view " + view_name +
+                                 " already exists");
+        }
+      }
+
+      auto schema = table->GetSchema();
+      std::vector<oid_t> group_column_ids;
+      for (auto &column_name : node.GetViewGroupColumns()) {
+        oid_t column_id = schema->GetColumnID(column_name);
+        if (column_id == INVALID_OID) {
+          throw ExecutorException(StringUtil::Format(
+              "Invalid column name '%s.%s' for materialized view '%s'",
+              table->GetName().c_str(), column_name.c_str(),
+              view_name.c_str()));
+        }
+        group_column_ids.push_back(column_id);
+      }
+
+      std::vector<storage::MaterializedViewAggregate> aggregates;
+      for (auto &aggregate : node.GetViewAggregates()) {
+        if (aggregate.first == ExpressionType::AGGREGATE_COUNT_STAR) {
+          aggregates.emplace_back(aggregate.first, INVALID_OID);
+          continue;
+        }
+        oid_t column_id = schema->GetColumnID(aggregate.second);
+        if (column_id == INVALID_OID) {
+          throw ExecutorException(StringUtil::Format(
+              "Invalid column name '%s.%s' for materialized view '%s'",
+              table->GetName().c_str(), aggregate.second.c_str(),
+              view_name.c_str()));
+        }
+        // Sums are kept in the type of the column
+        if ((aggregate.first == ExpressionType::AGGREGATE_SUM ||
+             aggregate.first == ExpressionType::AGGREGATE_AVG) &&
+            IsNumericType(schema->GetType(column_id)) == false) {
+          throw ExecutorException(StringUtil::Format(
+              "Cannot sum column '%s.%s' for materialized view '%s'",
+              table->GetName().c_str(), aggregate.second.c_str(),
+              view_name.c_str()));
+        }
+        aggregates.emplace_back(aggregate.first, column_id);
+      }
+
+      // The view is built by its first reader, once the transactions that
+      // might commit without maintaining it are gone
+      auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+      table->AddMaterializedView(std::make_shared<storage::MaterializedView>(
+          view_name, table, group_column_ids, aggregates,
+          epoch_manager.GetCurrentEpochId()));
+
+      LOG_TRACE("Created materialized view %s on %s", view_name.c_str(),
+                table->GetName().c_str());
+      current_txn->SetResult(ResultType::SUCCESS);
+      break;
+    }
+
     default: {
       std::string create_type = CreateTypeToString(node.GetCreateType());
       LOG_ERROR("Not supported create type %s", create_type.c_str());
@@ -18,6 +18,8 @@
 #include "concurrency/transaction.h"
 #include "executor/executor_context.h"
 #include "planner/drop_plan.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
 
 namespace peloton {
 namespace executor {
@@ -94,6 +96,26 @@ bool DropExecutor::DExecute() {
       }
       break;
     }
+    case DropType::MATERIALIZED_VIEW: {
+      std::string view_name = node.GetViewName();
+      auto current_txn = context_->GetTransaction();
+      auto database = catalog::Catalog::GetInstance()->GetDatabaseWithName(
+          DEFAULT_DB_NAME, current_txn);
+      bool dropped = false;
+      for (oid_t table_itr = 0;
+           dropped == false && table_itr < database->GetTableCount();
+           table_itr++) {
+        auto table = database->GetTable(table_itr);
+        dropped = table->DropMaterializedView(view_name);
+      }
+      if (dropped == false && node.IsMissing() == false) {
+        throw CatalogException("Materialized view " + view_name +
+                               " does not exist");
+      }
+      current_txn->SetResult(ResultType::SUCCESS);
+      LOG_TRACE("Dropping materialized view %s succeeded!", view_name.c_str());
+      break;
+    }
     default: {
       throw NotImplementedException(
           StringUtil::Format("Drop type %d not supported yet.\n", dropType));
@@ -13,17 +13,26 @@
 #include "type/value.h"
 #include "executor/executor_context.h"
 #include "concurrency/transaction.h"
+#include "settings/settings_manager.h"
 
 namespace peloton {
 namespace executor {
 
+// The budget setting is in KB
+static size_t GetQueryMemoryBudget() {
+  return static_cast<size_t>(settings::SettingsManager::GetInt(
+             settings::SettingId::query_memory_budget)) *
+         1024;
+}
+
 ExecutorContext::ExecutorContext(concurrency::Transaction *transaction)
-    : transaction_(transaction) {}
+    : transaction_(transaction), memory_budget_(GetQueryMemoryBudget()) {}
 
 ExecutorContext::ExecutorContext(concurrency::Transaction *transaction,
                                  const std::vector<type::Value> &params)
     : transaction_(transaction),
-      params_(params) {}
+      params_(params),
+      memory_budget_(GetQueryMemoryBudget()) {}
 
 ExecutorContext::~ExecutorContext() {
   // params will be freed automatically
@@ -10,12 +10,17 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <sstream>
+
 #include "common/logger.h"
 #include "type/value.h"
 #include "executor/logical_tile.h"
 #include "executor/hash_executor.h"
+#include "executor/query_profile.h"
 #include "planner/hash_plan.h"
 #include "expression/tuple_value_expression.h"
+#include "executor/executor_context.h"
 
 namespace peloton {
 namespace executor {
@@ -25,7 +30,16 @@ namespace executor {
  */
 HashExecutor::HashExecutor(const planner::AbstractPlan *node,
                            ExecutorContext *executor_context)
-    : AbstractExecutor(node, executor_context) {}
+    : AbstractExecutor(node, executor_context),
+      memory_budget_(executor_context != nullptr
+                         ? &executor_context->GetMemoryBudget()
+                         : nullptr) {}
+
+HashExecutor::~HashExecutor() {
+  if (memory_budget_ != nullptr) {
+    memory_budget_->Release(memory_used_);
+  }
+}
 
 /**
  * @brief Do some basic checks and initialize executor state.
@@ -47,16 +61,6 @@ bool HashExecutor::DExecute() {
   if (done_ == false) {
     const planner::HashPlan &node = GetPlanNode<planner::HashPlan>();
 
-    // First, get all the input logical tiles
-    while (children_[0]->Execute()) {
-      child_tiles_.emplace_back(children_[0]->GetOutput());
-    }
-
-    if (child_tiles_.size() == 0) {
-      LOG_TRACE("Hash Executor : false -- no child tiles ");
-      return false;
-    }
-
     /* *
      * HashKeys is a vector of TupleValue expr
      * from which we construct a vector of column ids that represent the
@@ -66,6 +70,7 @@ bool HashExecutor::DExecute() {
     auto &hashkeys = node.GetHashKeys();
 
     // Construct a logical tile
+    column_ids_.clear();
     for (auto &hashkey : hashkeys) {
       PL_ASSERT(hashkey->GetExpressionType() == ExpressionType::VALUE_TUPLE);
       auto tuple_value =
@@ -74,28 +79,34 @@ bool HashExecutor::DExecute() {
       column_ids_.push_back(tuple_value->GetColumnId());
     }
 
-    // Construct the hash table by going over each child logical tile and
-    // hashing
-    for (size_t child_tile_itr = 0; child_tile_itr < child_tiles_.size();
-         child_tile_itr++) {
-      auto tile = child_tiles_[child_tile_itr].get();
-
-      // Go over all tuples in the logical tile
-      for (oid_t tuple_id : *tile) {
-        // Key : container tuple with a subset of tuple attributes
-        // Value : < child_tile offset, tuple offset >
-        auto key = HashMapType::key_type(tile, tuple_id, &column_ids_);
-        if (hash_table_.find(key) != hash_table_.end()){
-           //If data is already present, remove from output
-           //but leave data for hash joins.
-           tile->RemoveVisibility(tuple_id);
+    // Construct the hash table by hashing each input logical tile as it
+    // arrives, until the table does not fit into the budget
+    while (children_[0]->Execute()) {
+      std::unique_ptr<LogicalTile> tile(children_[0]->GetOutput());
+      if (spilled_ == true) {
+        for (oid_t tuple_id : *tile) {
+          SpillRow(tile.get(), tuple_id);
         }
-        hash_table_[key].insert(
-                    std::make_pair(child_tile_itr, tuple_id));
+        continue;
+      }
+
+      child_tiles_.push_back(std::move(tile));
+      size_t tile_memory = HashTile(child_tiles_.size() - 1);
+
+      if (memory_budget_ != nullptr &&
+          memory_budget_->Reserve(tile_memory) == false) {
+        SpillHashTable();
+      } else {
+        memory_used_ += tile_memory;
       }
     }
 
     done_ = true;
+
+    if (child_tiles_.size() == 0) {
+      LOG_TRACE("Hash Executor : false -- no child tiles ");
+      return false;
+    }
   }
 
   // Return logical tiles one at a time
@@ -114,5 +125,119 @@ bool HashExecutor::DExecute() {
   return false;
 }
 
+size_t HashExecutor::HashTile(size_t child_tile_itr) {
+  auto tile = child_tiles_[child_tile_itr].get();
+  size_t memory_used = 0;
+
+  // A row location in the set of its key, and its entries in the position
+  // lists of the tile
+  size_t row_size = sizeof(std::pair<size_t, oid_t>) + 2 * sizeof(void *) +
+                    tile->GetPositionLists().size() * sizeof(oid_t);
+
+  // Go over all tuples in the logical tile
+  for (oid_t tuple_id : *tile) {
+    // Key : container tuple with a subset of tuple attributes
+    // Value : < child_tile offset, tuple offset >
+    auto key = HashMapType::key_type(tile, tuple_id, &column_ids_);
+    if (hash_table_.find(key) != hash_table_.end()) {
+      // If data is already present, remove from output
+      // but leave data for hash joins.
+      tile->RemoveVisibility(tuple_id);
+    } else {
+      memory_used += sizeof(HashMapType::value_type) + 3 * sizeof(void *);
+    }
+    hash_table_[key].insert(std::make_pair(child_tile_itr, tuple_id));
+    memory_used += row_size;
+  }
+  return memory_used;
+}
+
+void HashExecutor::SpillHashTable() {
+  LOG_DEBUG("Hash join build side exceeded the query memory budget of %lu "
+            "bytes, spilling",
+            memory_budget_->GetLimit());
+  spilled_ = true;
+  spill_partitions_.resize(HASH_JOIN_SPILL_PARTITIONS);
+
+  // The hash table still knows the rows that were hidden as duplicates
+  for (auto &entry : hash_table_) {
+    for (auto &location : entry.second) {
+      SpillRow(child_tiles_[location.first].get(), location.second);
+    }
+  }
+
+  hash_table_.clear();
+  child_tiles_.clear();
+  memory_budget_->Release(memory_used_);
+  memory_used_ = 0;
+}
+
+void HashExecutor::SpillRow(LogicalTile *tile, oid_t tuple_id) {
+  spill_values_.clear();
+  for (oid_t column_itr = 0; column_itr < tile->GetColumnCount();
+       column_itr++) {
+    spill_values_.push_back(tile->GetValue(tuple_id, column_itr));
+  }
+  spill_key_values_.clear();
+  for (auto column_id : column_ids_) {
+    spill_key_values_.push_back(spill_values_[column_id]);
+  }
+
+  auto &partition =
+      spill_partitions_[GetSpillPartition(spill_key_values_, 0)];
+  if (partition == nullptr) {
+    partition.reset(new SpillFile());
+  }
+  partition->Append(spill_values_);
+  spilled_row_count_++;
+}
+
+size_t HashExecutor::GetSpillPartition(
+    const std::vector<type::Value> &key_values, size_t depth) {
+  size_t seed = 0;
+  for (auto &value : key_values) {
+    value.HashCombine(seed);
+  }
+
+  // Mix the key hash with the depth so that a partition that is split again
+  // spreads over all partitions of the next level
+  uint64_t hash = seed + (depth + 1) * 0x9e3779b97f4a7c15ULL;
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash % HASH_JOIN_SPILL_PARTITIONS;
+}
+
+void HashExecutor::AddProfileDetails(OperatorProfile &profile) const {
+  size_t row_count = 0;
+  for (auto &entry : hash_table_) {
+    row_count += entry.second.size();
+  }
+
+  size_t longest_chain = 0;
+  for (size_t bucket = 0; bucket < hash_table_.bucket_count(); bucket++) {
+    longest_chain = std::max(longest_chain, hash_table_.bucket_size(bucket));
+  }
+
+  // Rough estimate of the memory held by the table: the bucket array, one
+  // node per key and one node per row location
+  size_t memory_used =
+      hash_table_.bucket_count() * sizeof(void *) +
+      hash_table_.size() * sizeof(HashMapType::value_type) +
+      row_count * (sizeof(std::pair<size_t, oid_t>) + 2 * sizeof(void *));
+
+  std::ostringstream os;
+  os << "Hash Keys: " << hash_table_.size() << "  Rows: " << row_count
+     << "  Buckets: " << hash_table_.bucket_count()
+     << "  Longest Chain: " << longest_chain
+     << "  Memory: " << (memory_used + 1023) / 1024 << " kB";
+  if (spilled_ == true) {
+    os << "  Spilled Rows: " << spilled_row_count_;
+  }
+  profile.details.push_back(os.str());
+}
+
 }  // namespace executor
 }  // namespace peloton
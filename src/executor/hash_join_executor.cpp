@@ -10,13 +10,20 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <sstream>
+
 #include "type/types.h"
+#include "type/value_factory.h"
 #include "common/logger.h"
+#include "executor/executor_context.h"
 #include "executor/logical_tile_factory.h"
 #include "executor/hash_join_executor.h"
+#include "executor/query_profile.h"
 #include "expression/abstract_expression.h"
 #include "expression/tuple_value_expression.h"
 #include "common/container_tuple.h"
+#include "storage/tile.h"
 
 namespace peloton {
 namespace executor {
@@ -40,6 +47,17 @@ bool HashJoinExecutor::DInit() {
 
   hash_executor_ = reinterpret_cast<HashExecutor *>(children_[1]);
 
+  std::vector<const expression::AbstractExpression *> left_hashed_cols;
+  GetPlanNode<planner::HashJoinPlan>().GetLeftHashKeys(left_hashed_cols);
+  left_hashed_col_ids_.clear();
+  for (auto &hashkey : left_hashed_cols) {
+    PL_ASSERT(hashkey->GetExpressionType() == ExpressionType::VALUE_TUPLE);
+    auto tuple_value =
+        reinterpret_cast<const expression::TupleValueExpression *>(hashkey);
+    left_hashed_col_ids_.push_back(tuple_value->GetColumnId());
+  }
+  null_aware_ = GetPlanNode<planner::HashJoinPlan>().IsNullAware();
+
   return true;
 }
 
@@ -63,6 +81,10 @@ bool HashJoinExecutor::DExecute() {
 
     // Build outer join output when done
     if (left_child_done_ == true) {
+      if (null_aware_ == true && null_aware_done_ == false) {
+        ApplyNullAwareness();
+        null_aware_done_ = true;
+      }
       return BuildOuterJoinOutput();
     }
 
@@ -78,6 +100,11 @@ bool HashJoinExecutor::DExecute() {
       right_child_done_ = true;
     }
 
+    // The build side did not fit into memory, join partition by partition
+    if (hash_executor_->IsSpilled() == true) {
+      return ExecuteSpilled();
+    }
+
     // Get next tile from LEFT child
     if (children_[0]->Execute() == false) {
       LOG_TRACE("Did not get left tile \n");
@@ -101,30 +128,29 @@ bool HashJoinExecutor::DExecute() {
 
     // Get the hash table from the hash executor
     auto &hash_table = hash_executor_->GetHashTable();
-    std::vector<const expression::AbstractExpression *> left_hashed_cols;
-    this->GetPlanNode<planner::HashJoinPlan>().GetLeftHashKeys(left_hashed_cols);
-
-    std::vector<oid_t> left_hashed_col_ids;
-    for (auto &hashkey : left_hashed_cols) {
-      PL_ASSERT(hashkey->GetExpressionType() == ExpressionType::VALUE_TUPLE);
-      auto tuple_value =
-          reinterpret_cast<const expression::TupleValueExpression *>(hashkey);
-      left_hashed_col_ids.push_back(tuple_value->GetColumnId());
-    }
 
     oid_t prev_tile = INVALID_OID;
     std::unique_ptr<LogicalTile> output_tile;
     LogicalTile::PositionListsBuilder pos_lists_builder;
 
+    // Semi and anti joins only record which right rows found a match
+    if (join_type_ == JoinType::SEMI || join_type_ == JoinType::ANTI) {
+      ProbeSemiJoin(left_tile);
+      continue;
+    }
+
     // Go over the left tile
     for (auto left_tile_itr : *left_tile) {
       const ContainerTuple<executor::LogicalTile> left_tuple(
-          left_tile, left_tile_itr, &left_hashed_col_ids);
+          left_tile, left_tile_itr, &left_hashed_col_ids_);
 
       // Find matching tuples in the hash table built on top of the right table
       auto right_tuples = hash_table.find(left_tuple);
+      probe_count_++;
 
       if (right_tuples != hash_table.end()) {
+        probe_match_count_++;
+
     	// Not yet supported due to assertion in gettomg right_tuples->first
     	if (predicate_ != nullptr) {
     		auto eval = predicate_->Evaluate(&left_tuple, &right_tuples->first,
@@ -193,5 +219,408 @@ bool HashJoinExecutor::DExecute() {
   }
 }
 
+void HashJoinExecutor::ProbeSemiJoin(LogicalTile *left_tile) {
+  auto &hash_table = hash_executor_->GetHashTable();
+
+  for (auto left_tile_itr : *left_tile) {
+    probe_has_rows_ = true;
+
+    // A NULL key equals nothing, not even another NULL
+    bool has_null_key = false;
+    for (auto column_id : left_hashed_col_ids_) {
+      if (left_tile->GetValue(left_tile_itr, column_id).IsNull()) {
+        has_null_key = true;
+        break;
+      }
+    }
+    if (has_null_key == true) {
+      probe_has_null_key_ = true;
+      continue;
+    }
+
+    const ContainerTuple<executor::LogicalTile> left_tuple(
+        left_tile, left_tile_itr, &left_hashed_col_ids_);
+    auto right_tuples = hash_table.find(left_tuple);
+    probe_count_++;
+    if (right_tuples == hash_table.end()) {
+      continue;
+    }
+    probe_match_count_++;
+
+    for (auto &location : right_tuples->second) {
+      if (predicate_ != nullptr) {
+        const ContainerTuple<executor::LogicalTile> right_tuple(
+            right_result_tiles_[location.first].get(), location.second);
+        auto eval =
+            predicate_->Evaluate(&left_tuple, &right_tuple, executor_context_);
+        if (eval.IsFalse()) continue;
+      }
+      RecordMatchedRightRow(location.first, location.second);
+    }
+  }
+}
+
+bool HashJoinExecutor::IsNullAwareMatch(bool build_key_is_null) const {
+  // x NOT IN (...) is NULL, i.e. no row qualifies, if the list has a NULL,
+  // and so is NULL NOT IN (...) unless the list is empty
+  return probe_has_null_key_ == true ||
+         (probe_has_rows_ == true && build_key_is_null == true);
+}
+
+void HashJoinExecutor::ApplyNullAwareness() {
+  auto &right_hashed_col_ids = hash_executor_->GetHashKeyIds();
+  for (size_t tile_itr = 0; tile_itr < no_matching_right_row_sets_.size();
+       tile_itr++) {
+    auto &no_matching_rows = no_matching_right_row_sets_[tile_itr];
+    auto right_tile = right_result_tiles_[tile_itr].get();
+    for (auto row_itr = no_matching_rows.begin();
+         row_itr != no_matching_rows.end();) {
+      bool has_null_key = false;
+      for (auto column_id : right_hashed_col_ids) {
+        if (right_tile->GetValue(*row_itr, column_id).IsNull()) {
+          has_null_key = true;
+          break;
+        }
+      }
+      if (IsNullAwareMatch(has_null_key) == true) {
+        row_itr = no_matching_rows.erase(row_itr);
+      } else {
+        ++row_itr;
+      }
+    }
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Spilled Join
+//===----------------------------------------------------------------------===//
+
+bool HashJoinExecutor::ExecuteSpilled() {
+  if (probe_side_partitioned_ == false) {
+    PartitionProbeSide();
+    probe_side_partitioned_ = true;
+
+    // A NULL on the left side of NOT IN leaves nothing to return
+    if (null_aware_ == true && probe_has_null_key_ == true) {
+      pending_partitions_.clear();
+    }
+  }
+
+  for (;;) {
+    if (buffered_output_tiles.empty() == false) {
+      SetOutput(buffered_output_tiles.front());
+      buffered_output_tiles.pop_front();
+      return true;
+    }
+
+    if (partition_loaded_ == true) {
+      // Probe until a tile worth of rows is joined
+      if (probe_partition_ != nullptr &&
+          probe_partition_->Next(spill_values_) == true) {
+        ProbeSpilledRow(spill_values_);
+        continue;
+      }
+
+      // The build rows of the partition that found no match, or the ones
+      // that did for a semi join
+      if (join_type_ == JoinType::RIGHT || join_type_ == JoinType::OUTER ||
+          join_type_ == JoinType::ANTI) {
+        auto &right_hashed_col_ids = hash_executor_->GetHashKeyIds();
+        for (size_t row_itr = 0; row_itr < build_rows_.size(); row_itr++) {
+          auto &build_row = build_rows_[row_itr];
+          if (build_row_matched_[row_itr] == true ||
+              (null_aware_ == true &&
+               IsNullAwareMatch(GetSpilledKey(build_row, right_hashed_col_ids,
+                                              spill_key_values_) == false))) {
+            continue;
+          }
+          AddSpilledOutputRow(nullptr, &build_row);
+        }
+      } else if (join_type_ == JoinType::SEMI) {
+        for (size_t row_itr = 0; row_itr < build_rows_.size(); row_itr++) {
+          if (build_row_matched_[row_itr] == true) {
+            AddSpilledOutputRow(nullptr, &build_rows_[row_itr]);
+          }
+        }
+      }
+      FlushSpilledOutput();
+
+      build_rows_.clear();
+      build_row_matched_.clear();
+      build_table_.clear();
+      probe_partition_.reset();
+      ReleasePartitionMemory();
+      partition_loaded_ = false;
+      continue;
+    }
+
+    if (pending_partitions_.empty() == true) {
+      return false;
+    }
+    LoadSpilledPartition();
+  }
+}
+
+void HashJoinExecutor::PartitionProbeSide() {
+  auto &build_partitions = hash_executor_->GetSpillPartitions();
+  std::vector<std::unique_ptr<SpillFile>> probe_partitions(
+      HASH_JOIN_SPILL_PARTITIONS);
+
+  // Rows that cannot match are only needed if they are returned unmatched
+  bool keep_unmatched =
+      join_type_ == JoinType::LEFT || join_type_ == JoinType::OUTER;
+
+  while (children_[0]->Execute()) {
+    std::unique_ptr<LogicalTile> tile(children_[0]->GetOutput());
+    for (oid_t tuple_id : *tile) {
+      spill_values_.clear();
+      for (oid_t column_itr = 0; column_itr < tile->GetColumnCount();
+           column_itr++) {
+        spill_values_.push_back(tile->GetValue(tuple_id, column_itr));
+      }
+
+      bool has_key =
+          GetSpilledKey(spill_values_, left_hashed_col_ids_, spill_key_values_);
+      probe_has_rows_ = true;
+      if (has_key == false) probe_has_null_key_ = true;
+      size_t partition_idx =
+          HashExecutor::GetSpillPartition(spill_key_values_, 0);
+      if (keep_unmatched == false &&
+          (has_key == false || build_partitions[partition_idx] == nullptr)) {
+        continue;
+      }
+
+      auto &partition = probe_partitions[partition_idx];
+      if (partition == nullptr) {
+        partition.reset(new SpillFile());
+      }
+      partition->Append(spill_values_);
+      spilled_probe_row_count_++;
+    }
+  }
+
+  for (size_t partition_idx = 0; partition_idx < HASH_JOIN_SPILL_PARTITIONS;
+       partition_idx++) {
+    SpilledPartition partition;
+    partition.build = std::move(build_partitions[partition_idx]);
+    partition.probe = std::move(probe_partitions[partition_idx]);
+    if (HasSpilledOutput(partition) == true) {
+      pending_partitions_.push_back(std::move(partition));
+    }
+  }
+}
+
+bool HashJoinExecutor::HasSpilledOutput(
+    const SpilledPartition &partition) const {
+  bool left_outer =
+      join_type_ == JoinType::LEFT || join_type_ == JoinType::OUTER;
+  bool right_outer = join_type_ == JoinType::RIGHT ||
+                     join_type_ == JoinType::OUTER ||
+                     join_type_ == JoinType::ANTI;
+  if (partition.build != nullptr && partition.probe != nullptr) {
+    return true;
+  }
+  return (partition.build != nullptr && right_outer) ||
+         (partition.probe != nullptr && left_outer);
+}
+
+void HashJoinExecutor::ReleasePartitionMemory() {
+  if (executor_context_ != nullptr) {
+    executor_context_->GetMemoryBudget().Release(partition_memory_);
+  }
+  partition_memory_ = 0;
+}
+
+void HashJoinExecutor::LoadSpilledPartition() {
+  SpilledPartition partition = std::move(pending_partitions_.back());
+  pending_partitions_.pop_back();
+  max_spill_depth_ = std::max(max_spill_depth_, partition.depth);
+
+  auto &right_hashed_col_ids = hash_executor_->GetHashKeyIds();
+  auto memory_budget = hash_executor_->GetMemoryBudget();
+
+  // A build partition that does not fit into the budget of the query is
+  // split again together with its probe partition. The serialized size is a
+  // lower bound of the size in memory. Past the maximum depth the partition
+  // is loaded over the budget.
+  size_t partition_memory =
+      partition.build != nullptr ? partition.build->GetByteCount() : 0;
+  if (partition.build != nullptr && memory_budget != nullptr &&
+      partition.depth + 1 < HASH_JOIN_MAX_SPILL_DEPTH &&
+      memory_budget->Reserve(partition_memory) == false) {
+    LOG_TRACE("Splitting spilled partition of %lu rows at depth %lu",
+              partition.build->GetRowCount(), partition.depth);
+
+    std::vector<SpilledPartition> splits(HASH_JOIN_SPILL_PARTITIONS);
+    auto split_file = [&](SpillFile *file, const std::vector<oid_t> &key_ids,
+                          bool is_build) {
+      file->Rewind();
+      while (file->Next(spill_values_) == true) {
+        GetSpilledKey(spill_values_, key_ids, spill_key_values_);
+        auto &split = splits[HashExecutor::GetSpillPartition(
+            spill_key_values_, partition.depth + 1)];
+        auto &target = is_build ? split.build : split.probe;
+        if (target == nullptr) {
+          target.reset(new SpillFile());
+        }
+        target->Append(spill_values_);
+      }
+    };
+    split_file(partition.build.get(), right_hashed_col_ids, true);
+    if (partition.probe != nullptr) {
+      split_file(partition.probe.get(), left_hashed_col_ids_, false);
+    }
+
+    for (auto &split : splits) {
+      split.depth = partition.depth + 1;
+      if (HasSpilledOutput(split) == true) {
+        pending_partitions_.push_back(std::move(split));
+      }
+    }
+    return;
+  }
+  if (memory_budget != nullptr &&
+      partition.depth + 1 >= HASH_JOIN_MAX_SPILL_DEPTH) {
+    memory_budget->Charge(partition_memory);
+  }
+  partition_memory_ = partition_memory;
+
+  if (partition.build != nullptr) {
+    partition.build->Rewind();
+    std::vector<type::Value> values;
+    while (partition.build->Next(values) == true) {
+      // Rows with a null key never match, but may be returned unmatched
+      if (GetSpilledKey(values, right_hashed_col_ids, spill_key_values_)) {
+        build_table_[spill_key_values_].push_back(build_rows_.size());
+      }
+      build_rows_.push_back(std::move(values));
+    }
+    build_row_matched_.assign(build_rows_.size(), false);
+  }
+
+  if (partition.probe != nullptr) {
+    partition.probe->Rewind();
+  }
+  probe_partition_ = std::move(partition.probe);
+  partition_loaded_ = true;
+}
+
+void HashJoinExecutor::ProbeSpilledRow(std::vector<type::Value> &left_values) {
+  bool matched = false;
+  probe_count_++;
+
+  if (GetSpilledKey(left_values, left_hashed_col_ids_, spill_key_values_)) {
+    auto build_entry = build_table_.find(spill_key_values_);
+    if (build_entry != build_table_.end()) {
+      probe_match_count_++;
+
+      ContainerTuple<std::vector<type::Value>> left_tuple(&left_values);
+      for (auto row_itr : build_entry->second) {
+        auto &right_values = build_rows_[row_itr];
+        if (predicate_ != nullptr) {
+          ContainerTuple<std::vector<type::Value>> right_tuple(&right_values);
+          auto eval = predicate_->Evaluate(&left_tuple, &right_tuple,
+                                           executor_context_);
+          if (eval.IsFalse()) continue;
+        }
+
+        matched = true;
+        build_row_matched_[row_itr] = true;
+        // Semi and anti joins return build rows once the partition is done
+        if (join_type_ != JoinType::SEMI && join_type_ != JoinType::ANTI) {
+          AddSpilledOutputRow(&left_values, &right_values);
+        }
+      }
+    }
+  }
+
+  if (matched == false &&
+      (join_type_ == JoinType::LEFT || join_type_ == JoinType::OUTER)) {
+    AddSpilledOutputRow(&left_values, nullptr);
+  }
+}
+
+void HashJoinExecutor::AddSpilledOutputRow(
+    const std::vector<type::Value> *left_values,
+    const std::vector<type::Value> *right_values) {
+  PL_ASSERT(proj_schema_ != nullptr);
+  size_t column_count = proj_schema_->GetColumnCount();
+
+  auto get_value = [&](oid_t side, oid_t column_id,
+                       oid_t output_column_id) -> type::Value {
+    auto values = side == 0 ? left_values : right_values;
+    if (values == nullptr) {
+      return type::ValueFactory::GetNullValueByType(
+          proj_schema_->GetType(output_column_id));
+    }
+    return (*values)[column_id];
+  };
+
+  std::vector<type::Value> row(column_count);
+  if (proj_info_ == nullptr) {
+    // All left columns followed by all right columns
+    size_t left_column_count = left_values != nullptr
+                                   ? left_values->size()
+                                   : column_count - right_values->size();
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      row[column_itr] =
+          column_itr < left_column_count
+              ? get_value(0, column_itr, column_itr)
+              : get_value(1, column_itr - left_column_count, column_itr);
+    }
+  } else {
+    PL_ASSERT(!proj_info_->isNonTrivial());
+    for (auto &entry : proj_info_->GetDirectMapList()) {
+      row[entry.first] =
+          get_value(entry.second.first, entry.second.second, entry.first);
+    }
+  }
+  spilled_output_rows_.push_back(std::move(row));
+
+  if (spilled_output_rows_.size() >= size_t(DEFAULT_TUPLES_PER_TILEGROUP)) {
+    FlushSpilledOutput();
+  }
+}
+
+void HashJoinExecutor::FlushSpilledOutput() {
+  if (spilled_output_rows_.empty() == true) return;
+
+  std::shared_ptr<storage::Tile> ptile(storage::TileFactory::GetTile(
+      BackendType::MM, INVALID_OID, INVALID_OID, INVALID_OID, INVALID_OID,
+      nullptr, *proj_schema_, nullptr, spilled_output_rows_.size()));
+  for (oid_t tuple_itr = 0; tuple_itr < spilled_output_rows_.size();
+       tuple_itr++) {
+    auto &row = spilled_output_rows_[tuple_itr];
+    for (oid_t column_itr = 0; column_itr < row.size(); column_itr++) {
+      ptile->SetValue(row[column_itr], tuple_itr, column_itr);
+    }
+  }
+
+  buffered_output_tiles.push_back(LogicalTileFactory::WrapTiles({ptile}));
+  spilled_output_rows_.clear();
+}
+
+bool HashJoinExecutor::GetSpilledKey(const std::vector<type::Value> &values,
+                                     const std::vector<oid_t> &key_ids,
+                                     std::vector<type::Value> &key_values) {
+  bool has_key = true;
+  key_values.clear();
+  for (auto key_id : key_ids) {
+    key_values.push_back(values[key_id]);
+    if (values[key_id].IsNull()) has_key = false;
+  }
+  return has_key;
+}
+
+void HashJoinExecutor::AddProfileDetails(OperatorProfile &profile) const {
+  std::ostringstream os;
+  os << "Probes: " << probe_count_ << "  Key Hits: " << probe_match_count_;
+  if (hash_executor_ != nullptr && hash_executor_->IsSpilled() == true) {
+    os << "  Spilled Probe Rows: " << spilled_probe_row_count_
+       << "  Spill Depth: " << max_spill_depth_ + 1;
+  }
+  profile.details.push_back(os.str());
+}
+
 }  // namespace executor
 }  // namespace peloton
@@ -22,6 +22,8 @@
 #include "expression/abstract_expression.h"
 #include "index/index.h"
 #include "planner/index_scan_plan.h"
+#include "settings/settings_manager.h"
+#include "statistics/backend_stats_context.h"
 #include "storage/data_table.h"
 #include "storage/masked_tuple.h"
 #include "storage/tile_group.h"
@@ -201,6 +203,13 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
   std::vector<ItemPointer> visible_tuple_locations;
   std::map<oid_t, std::vector<oid_t>> visible_tuples;
 
+  // Version chain lengths are only recorded when stats are collected
+  stats::BackendStatsContext *backend_stats = nullptr;
+  if (settings::SettingsManager::GetInt(settings::SettingId::stats_mode) !=
+      STATS_TYPE_INVALID) {
+    backend_stats = stats::BackendStatsContext::GetInstance();
+  }
+
 #ifdef LOG_TRACE_ENABLED
   int num_tuples_examined = 0;
 #endif
@@ -314,6 +323,9 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
       }
     }
     LOG_TRACE("Traverse length: %d\n", (int)chain_length);
+    if (backend_stats != nullptr) {
+      backend_stats->RecordVersionChainLength(chain_length);
+    }
   }
   LOG_TRACE("Examined %d tuples from index %s", num_tuples_examined,
             index_->GetName().c_str());
@@ -410,6 +422,13 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
 
   std::vector<ItemPointer> visible_tuple_locations;
   std::map<oid_t, std::vector<oid_t>> visible_tuples;
+
+  // Version chain lengths are only recorded when stats are collected
+  stats::BackendStatsContext *backend_stats = nullptr;
+  if (settings::SettingsManager::GetInt(settings::SettingId::stats_mode) !=
+      STATS_TYPE_INVALID) {
+    backend_stats = stats::BackendStatsContext::GetInstance();
+  }
   auto &manager = catalog::Manager::GetInstance();
 
   // Quickie Hack
@@ -561,6 +580,9 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
       }
     }
     LOG_TRACE("Traverse length: %d\n", (int)chain_length);
+    if (backend_stats != nullptr) {
+      backend_stats->RecordVersionChainLength(chain_length);
+    }
   }
   LOG_TRACE("Examined %d tuples from index %s [num_blocks_reused=%d]",
             num_tuples_examined, index_->GetName().c_str(), num_blocks_reused);
@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// materialized_view_scan_executor.cpp
+//
+// Identification: src/executor/materialized_view_scan_executor.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/materialized_view_scan_executor.h"
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "executor/executor_context.h"
+#include "executor/logical_tile_factory.h"
+#include "planner/materialized_view_scan_plan.h"
+#include "storage/materialized_view.h"
+#include "storage/table_factory.h"
+#include "storage/tuple.h"
+
+namespace peloton {
+namespace executor {
+
+MaterializedViewScanExecutor::MaterializedViewScanExecutor(
+    const planner::AbstractPlan *node, ExecutorContext *executor_context)
+    : AbstractExecutor(node, executor_context) {}
+
+bool MaterializedViewScanExecutor::DInit() {
+  PL_ASSERT(children_.empty());
+
+  const planner::MaterializedViewScanPlan &node =
+      GetPlanNode<planner::MaterializedViewScanPlan>();
+
+  result_.clear();
+  result_itr_ = 0;
+  done_ = false;
+
+  // The view may have gone since the plan was made, with its table
+  auto view = node.GetView();
+  if (view->IsDetached()) {
+    throw CatalogException("Materialized view " + view->GetName() +
+                           " was dropped, the statement must be planned "
+                           "again");
+  }
+  auto txn = executor_context_->GetTransaction();
+  use_view_ = view->IsUsable() && storage::MaterializedView::CanRead(txn);
+  output_table_.reset(storage::TableFactory::GetTempTable(
+      const_cast<catalog::Schema *>(node.GetOutputSchema()), false));
+  return true;
+}
+
+bool MaterializedViewScanExecutor::DExecute() {
+  if (done_ == false) {
+    const planner::MaterializedViewScanPlan &node =
+        GetPlanNode<planner::MaterializedViewScanPlan>();
+
+    auto view = node.GetView();
+    auto txn = executor_context_->GetTransaction();
+    auto rows = use_view_ ? view->GetRows(txn, node.GetColumns(),
+                                          node.GetKeyOffsets(),
+                                          node.GetKeyValues())
+                          : view->ScanRows(txn, node.GetColumns(),
+                                           node.GetKeyOffsets(),
+                                           node.GetKeyValues());
+    LOG_TRACE("Read %lu groups of %s from the %s", rows.size(),
+              view->GetName().c_str(), use_view_ ? "view" : "table");
+
+    auto executor_pool = executor_context_->GetPool();
+    for (auto &row : rows) {
+      std::unique_ptr<storage::Tuple> tuple(
+          new storage::Tuple(output_table_->GetSchema(), true));
+      for (oid_t column_itr = 0; column_itr < row.size(); column_itr++) {
+        tuple->SetValue(column_itr, row[column_itr], executor_pool);
+      }
+      UNUSED_ATTRIBUTE auto location = output_table_->InsertTuple(tuple.get());
+      PL_ASSERT(location.block != INVALID_OID);
+    }
+
+    auto tile_group_count = output_table_->GetTileGroupCount();
+    for (oid_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+         tile_group_itr++) {
+      auto tile_group = output_table_->GetTileGroup(tile_group_itr);
+      result_.push_back(LogicalTileFactory::WrapTileGroup(tile_group));
+    }
+    done_ = true;
+  }
+
+  if (result_itr_ == result_.size()) return false;
+  SetOutput(result_[result_itr_++]);
+  return true;
+}
+
+}  // namespace executor
+}  // namespace peloton
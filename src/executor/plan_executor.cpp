@@ -17,9 +17,12 @@
 #include "codegen/query_compiler.h"
 #include "codegen/query.h"
 #include "concurrency/transaction_manager_factory.h"
+#include "common/exception.h"
 #include "common/logger.h"
+#include "common/timer.h"
 #include "executor/executor_context.h"
 #include "executor/executors.h"
+#include "executor/query_profile.h"
 #include "storage/tuple_iterator.h"
 #include "settings/settings_manager.h"
 
@@ -32,6 +35,106 @@ executor::AbstractExecutor *BuildExecutorTree(executor::AbstractExecutor *root,
 
 void CleanExecutorTree(executor::AbstractExecutor *root);
 
+/**
+ * @brief Replace the result of an EXPLAIN ANALYZE with the rendered profile.
+ */
+static void SetProfileResult(const QueryProfile &profile,
+                             const planner::AbstractPlan *plan,
+                             std::vector<StatementResult> &result) {
+  result.clear();
+  for (auto &line : profile.GetInfo(plan)) {
+    auto res = StatementResult();
+    PlanExecutor::copyFromTo(line, res.second);
+    result.push_back(std::move(res));
+  }
+}
+
+/**
+ * @brief Execute a plan with the interpreted executors. The engine is named
+ * in the summary of an EXPLAIN ANALYZE.
+ */
+static void ExecutePlanInterpreted(const planner::AbstractPlan *plan,
+                                   executor::ExecutorContext *executor_context,
+                                   std::vector<StatementResult> &result,
+                                   const std::vector<int> &result_format,
+                                   executor::ExecuteResult &p_status,
+                                   bool explain_analyze,
+                                   const std::string &engine) {
+  bool status;
+  std::unique_ptr<executor::AbstractExecutor> executor_tree(
+      BuildExecutorTree(nullptr, plan, executor_context));
+
+  Timer<std::ratio<1, 1000>> timer;
+  timer.Start();
+
+  status = executor_tree->Init();
+  if (status != true) {
+    p_status.m_result = ResultType::FAILURE;
+    p_status.m_result_slots = nullptr;
+    CleanExecutorTree(executor_tree.get());
+    return;
+  }
+
+  // Execute the tree until we get result tiles from root node
+  while (status == true) {
+    status = executor_tree->Execute();
+    std::unique_ptr<executor::LogicalTile> tile(executor_tree->GetOutput());
+
+    // Some executors don't return logical tiles (e.g., Update).
+    if (tile.get() != nullptr && !explain_analyze) {
+      LOG_TRACE("Final Answer: %s", tile->GetInfo().c_str());
+      std::vector<std::vector<std::string>> tuples;
+      tuples = tile->GetAllValuesAsStrings(result_format, false);
+
+      // Construct the returned results
+      for (auto &tuple : tuples) {
+        for (unsigned int i = 0; i < tile->GetColumnCount(); i++) {
+          auto res = StatementResult();
+          PlanExecutor::copyFromTo(tuple[i], res.second);
+          result.push_back(std::move(res));
+          LOG_TRACE("column content: %s",
+                    tuple[i].c_str() != nullptr ?  tuple[i].c_str() : "-emptry-");
+        }
+      }
+    }
+  }
+  if (explain_analyze) {
+    timer.Stop();
+    executor_tree->CollectProfile();
+    auto profile = executor_context->GetProfile();
+    profile->AddSummary("Engine: " + engine);
+    profile->AddSummary("Execution Time: " +
+                        std::to_string(timer.GetDuration()) + " ms");
+    SetProfileResult(*profile, plan, result);
+  }
+  p_status.m_processed = executor_context->num_processed;
+  p_status.m_result = ResultType::SUCCESS;
+  p_status.m_result_slots = nullptr;
+  CleanExecutorTree(executor_tree.get());
+}
+
+/**
+ * @brief Whether a plan leaves the database as it found it, so that it can
+ * be executed again after it failed halfway through.
+ */
+static bool IsReadOnlyPlan(const planner::AbstractPlan *plan) {
+  switch (plan->GetPlanNodeType()) {
+    case PlanNodeType::INSERT:
+    case PlanNodeType::UPDATE:
+    case PlanNodeType::DELETE:
+    case PlanNodeType::COPY:
+      return false;
+    default:
+      break;
+  }
+  for (auto &child : plan->GetChildren()) {
+    if (IsReadOnlyPlan(child.get()) == false) {
+      return false;
+    }
+  }
+  return true;
+}
+
 /**
  * @brief Build a executor tree and execute it.
  * Use std::vector<type::Value> as params to make it more elegant for
@@ -45,7 +148,7 @@ void PlanExecutor::ExecutePlan(
     concurrency::Transaction *txn, const std::vector<type::Value> &params,
     std::vector<StatementResult> &result,
     const std::vector<int> &result_format,
-    executor::ExecuteResult &p_status) {
+    executor::ExecuteResult &p_status, bool explain_analyze) {
   PL_ASSERT(plan != nullptr && txn != nullptr);
   LOG_TRACE("PlanExecutor Start (Txn ID=%" PRId64")", txn->GetTransactionId());
 
@@ -53,47 +156,18 @@ void PlanExecutor::ExecutePlan(
   std::unique_ptr<executor::ExecutorContext> executor_context(
       new executor::ExecutorContext(txn, params));
 
+  // The operators record their statistics here for EXPLAIN ANALYZE
+  std::unique_ptr<QueryProfile> profile;
+  if (explain_analyze) {
+    profile.reset(new QueryProfile());
+    executor_context->SetProfile(profile.get());
+  }
+
   if (!settings::SettingsManager::GetBool(settings::SettingId::codegen)
       || !codegen::QueryCompiler::IsSupported(*plan)) {
-    bool status;
-    std::unique_ptr<executor::AbstractExecutor> executor_tree(
-        BuildExecutorTree(nullptr, plan.get(), executor_context.get()));
-
-    status = executor_tree->Init();
-    if (status != true) {
-      p_status.m_result = ResultType::FAILURE;
-      p_status.m_result_slots = nullptr;
-      CleanExecutorTree(executor_tree.get());
-      return;
-    }
-
-    // Execute the tree until we get result tiles from root node
-    while (status == true) {
-      status = executor_tree->Execute();
-      std::unique_ptr<executor::LogicalTile> tile(executor_tree->GetOutput());
-
-      // Some executors don't return logical tiles (e.g., Update).
-      if (tile.get() != nullptr) {
-        LOG_TRACE("Final Answer: %s", tile->GetInfo().c_str());
-        std::vector<std::vector<std::string>> tuples;
-        tuples = tile->GetAllValuesAsStrings(result_format, false);
-
-        // Construct the returned results
-        for (auto &tuple : tuples) {
-          for (unsigned int i = 0; i < tile->GetColumnCount(); i++) {
-            auto res = StatementResult();
-            PlanExecutor::copyFromTo(tuple[i], res.second);
-            result.push_back(std::move(res));
-            LOG_TRACE("column content: %s",
-                      tuple[i].c_str() != nullptr ?  tuple[i].c_str() : "-emptry-");
-          }
-        }
-      }
-    }
-    p_status.m_processed = executor_context->num_processed;
-    p_status.m_result = ResultType::SUCCESS;
-    p_status.m_result_slots = nullptr;
-    CleanExecutorTree(executor_tree.get());
+    ExecutePlanInterpreted(plan.get(), executor_context.get(), result,
+                           result_format, p_status, explain_analyze,
+                           "interpreted");
     return;
   }
 
@@ -109,9 +183,60 @@ void PlanExecutor::ExecutePlan(
 
   // Compile & execute the query
   codegen::QueryCompiler compiler;
-  auto query = compiler.Compile(*plan, consumer);
-  query->Execute(*txn, executor_context.get(),
-                 reinterpret_cast<char *>(consumer.GetState()));
+  codegen::QueryCompiler::CompileStats compile_stats;
+  codegen::Query::RuntimeStats runtime_stats;
+  auto query = compiler.Compile(*plan, consumer,
+                                explain_analyze ? &compile_stats : nullptr,
+                                explain_analyze);
+  try {
+    query->Execute(*txn, executor_context.get(),
+                   reinterpret_cast<char *>(consumer.GetState()),
+                   explain_analyze ? &runtime_stats : nullptr);
+  } catch (OutOfMemoryException &e) {
+    // The compiled hash tables cannot spill. A plan that has not written
+    // anything runs again with the interpreted operators, which can.
+    if (IsReadOnlyPlan(plan.get()) == false) {
+      throw;
+    }
+    LOG_DEBUG("Compiled plan exceeded the query memory budget, running it "
+              "interpreted: %s",
+              e.what());
+    executor_context.reset(new executor::ExecutorContext(txn, params));
+    if (explain_analyze) {
+      profile.reset(new QueryProfile());
+      executor_context->SetProfile(profile.get());
+    }
+    ExecutePlanInterpreted(
+        plan.get(), executor_context.get(), result, result_format, p_status,
+        explain_analyze,
+        "interpreted (the compiled plan exceeded the query memory budget)");
+    return;
+  }
+
+  // Compiled operators only count their rows, the time is per query
+  if (explain_analyze) {
+    profile->CollectRowCounters(query->GetProfiledOperators());
+    profile->AddSummary("Engine: codegen");
+    profile->AddSummary(
+        "Compilation Time: " +
+        std::to_string(compile_stats.setup_ms + compile_stats.ir_gen_ms +
+                       compile_stats.jit_ms) +
+        " ms (setup=" + std::to_string(compile_stats.setup_ms) +
+        " ir=" + std::to_string(compile_stats.ir_gen_ms) +
+        " jit=" + std::to_string(compile_stats.jit_ms) + ")");
+    profile->AddSummary(
+        "Execution Time: " +
+        std::to_string(runtime_stats.init_ms + runtime_stats.plan_ms +
+                       runtime_stats.tear_down_ms) +
+        " ms (init=" + std::to_string(runtime_stats.init_ms) +
+        " plan=" + std::to_string(runtime_stats.plan_ms) +
+        " teardown=" + std::to_string(runtime_stats.tear_down_ms) + ")");
+    SetProfileResult(*profile, plan.get(), result);
+    p_status.m_processed = executor_context->num_processed;
+    p_status.m_result = ResultType::SUCCESS;
+    p_status.m_result_slots = nullptr;
+    return;
+  }
 
   // Iterate over results
   const auto &results = consumer.GetOutputTuples();
@@ -295,6 +420,13 @@ executor::AbstractExecutor *BuildExecutorTree(executor::AbstractExecutor *root,
       child_executor =
           new executor::PopulateIndexExecutor(plan, executor_context);
       break;
+    case PlanNodeType::APPEND:
+      child_executor = new executor::AppendExecutor(plan, executor_context);
+      break;
+    case PlanNodeType::MATERIALIZED_VIEW_SCAN:
+      child_executor =
+          new executor::MaterializedViewScanExecutor(plan, executor_context);
+      break;
     default:
       LOG_ERROR("Unsupported plan node type : %s",
                 PlanNodeTypeToString(plan_node_type).c_str());
@@ -325,14 +457,23 @@ executor::AbstractExecutor *BuildExecutorTree(executor::AbstractExecutor *root,
  * @param The current executor tree
  * @return none.
  */
+// Delete an executor before its children, a parallel append waits for the
+// workers running its children when it is deleted
+static void DeleteExecutorTree(executor::AbstractExecutor *executor) {
+  auto children = executor->GetChildren();
+  delete executor;
+  for (auto child : children) {
+    DeleteExecutorTree(child);
+  }
+}
+
 void CleanExecutorTree(executor::AbstractExecutor *root) {
   if (root == nullptr) return;
 
   // Recurse
   auto children = root->GetChildren();
   for (auto child : children) {
-    CleanExecutorTree(child);
-    delete child;
+    DeleteExecutorTree(child);
   }
 }
 
@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// query_profile.cpp
+//
+// Identification: src/executor/query_profile.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/query_profile.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include "planner/abstract_plan.h"
+
+namespace peloton {
+namespace executor {
+
+uint64_t *QueryProfile::GetRowCounters(uint32_t operator_count) {
+  row_counters_.assign(operator_count, 0);
+  return row_counters_.data();
+}
+
+void QueryProfile::CollectRowCounters(
+    const std::vector<const planner::AbstractPlan *> &operators) {
+  PL_ASSERT(operators.size() == row_counters_.size());
+  for (size_t operator_itr = 0; operator_itr < operators.size();
+       operator_itr++) {
+    GetOperatorProfile(operators[operator_itr]).rows =
+        row_counters_[operator_itr];
+  }
+}
+
+std::vector<std::string> QueryProfile::GetInfo(
+    const planner::AbstractPlan *root) const {
+  std::vector<std::string> lines;
+  GetInfo(root, 0, lines);
+  lines.insert(lines.end(), summaries_.begin(), summaries_.end());
+  return lines;
+}
+
+void QueryProfile::GetInfo(const planner::AbstractPlan *plan, size_t depth,
+                           std::vector<std::string> &lines) const {
+  if (plan == nullptr) return;
+
+  std::string indent(depth * 2, ' ');
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(3);
+  os << indent << (depth > 0 ? "->  " : "")
+     << PlanNodeTypeToString(plan->GetPlanNodeType());
+
+  auto iter = operator_profiles_.find(plan);
+  if (iter != operator_profiles_.end()) {
+    auto &profile = iter->second;
+    os << "  (rows=" << profile.rows;
+    if (profile.calls > 0) {
+      // Report the time spent in this operator alone as well
+      double children_time_ms = 0.0;
+      for (auto &child : plan->GetChildren()) {
+        auto child_iter = operator_profiles_.find(child.get());
+        if (child_iter != operator_profiles_.end()) {
+          children_time_ms += child_iter->second.time_ms;
+        }
+      }
+      os << " calls=" << profile.calls << " time=" << profile.time_ms
+         << " ms self=" << std::max(profile.time_ms - children_time_ms, 0.0)
+         << " ms";
+    }
+    os << ")";
+    lines.push_back(os.str());
+
+    for (auto &detail : profile.details) {
+      lines.push_back(indent + (depth > 0 ? "      " : "  ") + detail);
+    }
+  } else {
+    lines.push_back(os.str());
+  }
+
+  for (auto &child : plan->GetChildren()) {
+    GetInfo(child.get(), depth + 1, lines);
+  }
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -27,6 +27,8 @@
 #include "storage/data_table.h"
 #include "storage/tile_group_header.h"
 #include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "storage/zone_map.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "common/logger.h"
 
@@ -59,6 +61,9 @@ bool SeqScanExecutor::DInit() {
 
   old_predicate_ = predicate_;
 
+  ExtractZoneMapPredicates();
+  SplitPredicate();
+
   if (target_table_ != nullptr) {
     table_tile_group_count_ = target_table_->GetTileGroupCount();
 
@@ -154,51 +159,44 @@ bool SeqScanExecutor::DExecute() {
     while (current_tile_group_offset_ < table_tile_group_count_) {
       auto tile_group =
           target_table_->GetTileGroup(current_tile_group_offset_++);
+
+      // Skip tile groups whose value ranges cannot satisfy the predicate
+      if (zone_map_predicates_.empty() == false &&
+          tile_group->ShouldScan(zone_map_predicates_.data(),
+                                 zone_map_predicates_.size()) == false) {
+        LOG_TRACE("Zone map prunes tile group %u",
+                  tile_group->GetTileGroupId());
+        continue;
+      }
+
       auto tile_group_header = tile_group->GetHeader();
 
       oid_t active_tuple_count = tile_group->GetNextTupleSlot();
 
       // Construct position list by looping through tile group
-      // and applying the predicate.
+      // and applying the predicate to the visible tuples.
       std::vector<oid_t> position_list;
       for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
-        ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
-
         auto visibility = transaction_manager.IsVisible(
             current_txn, tile_group_header, tuple_id);
 
         // check transaction visibility
         if (visibility == VisibilityType::OK) {
-          // if the tuple is visible, then perform predicate evaluation.
-          if (predicate_ == nullptr) {
-            position_list.push_back(tuple_id);
-            auto res = transaction_manager.PerformRead(current_txn, location,
-                                                       acquire_owner);
-            if (!res) {
-              transaction_manager.SetTransactionResult(current_txn,
-                                                       ResultType::FAILURE);
-              return res;
-            }
-          } else {
-            ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
-                                                     tuple_id);
-            LOG_TRACE("Evaluate predicate for a tuple");
-            auto eval =
-                predicate_->Evaluate(&tuple, nullptr, executor_context_);
-            LOG_TRACE("Evaluation result: %s", eval.GetInfo().c_str());
-            if (eval.IsTrue()) {
-              position_list.push_back(tuple_id);
-              auto res = transaction_manager.PerformRead(current_txn, location,
-                                                         acquire_owner);
-              if (!res) {
-                transaction_manager.SetTransactionResult(current_txn,
-                                                         ResultType::FAILURE);
-                return res;
-              } else {
-                LOG_TRACE("Sequential Scan Predicate Satisfied");
-              }
-            }
-          }
+          position_list.push_back(tuple_id);
+        }
+      }
+      if (predicate_ != nullptr) {
+        FilterTuples(tile_group.get(), position_list);
+      }
+
+      for (auto tuple_id : position_list) {
+        ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
+        auto res = transaction_manager.PerformRead(current_txn, location,
+                                                   acquire_owner);
+        if (!res) {
+          transaction_manager.SetTransactionResult(current_txn,
+                                                   ResultType::FAILURE);
+          return res;
         }
       }
 
@@ -254,6 +252,98 @@ void SeqScanExecutor::UpdatePredicate(const std::vector<oid_t> &column_ids,
   // we should eventually make prediate_ a unique_ptr
   new_predicate_.reset(new_predicate);
   predicate_ = new_predicate;
+
+  ExtractZoneMapPredicates();
+  SplitPredicate();
+}
+
+// Collect the conjuncts of the current predicate that zone maps can check
+void SeqScanExecutor::ExtractZoneMapPredicates() {
+  const std::vector<type::Value> *params =
+      executor_context_ != nullptr ? &executor_context_->GetParams() : nullptr;
+  zone_map_predicates_.clear();
+  storage::ZoneMap::ExtractPredicates(predicate_, params,
+                                      zone_map_predicates_);
+}
+
+// Split the AND of the current predicate into the conjuncts that are
+// filtered in batches and the rest
+void SeqScanExecutor::SplitPredicate() {
+  batch_predicates_.clear();
+  row_predicates_.clear();
+  if (predicate_ == nullptr) {
+    return;
+  }
+
+  std::vector<const expression::AbstractExpression *> stack = {predicate_};
+  while (stack.empty() == false) {
+    auto expr = stack.back();
+    stack.pop_back();
+    if (expr->GetExpressionType() == ExpressionType::CONJUNCTION_AND) {
+      for (size_t i = expr->GetChildrenSize(); i > 0; i--) {
+        stack.push_back(expr->GetChild(i - 1));
+      }
+      continue;
+    }
+    auto comparison =
+        dynamic_cast<const expression::ComparisonExpression *>(expr);
+    if (comparison != nullptr && comparison->IsBatchFilter()) {
+      batch_predicates_.push_back(comparison);
+    } else {
+      row_predicates_.push_back(expr);
+    }
+  }
+}
+
+// Keep the tuples of a tile group the predicate is true for. The batch
+// conjuncts go first, over all tuples at once, then the rest one tuple after
+// the other.
+void SeqScanExecutor::FilterTuples(storage::TileGroup *tile_group,
+                                   std::vector<oid_t> &tuple_ids) {
+  std::vector<ContainerTuple<storage::TileGroup>> tuples;
+  std::vector<const AbstractTuple *> tuple_ptrs;
+  tuples.reserve(tuple_ids.size());
+  tuple_ptrs.reserve(tuple_ids.size());
+  for (auto tuple_id : tuple_ids) {
+    tuples.emplace_back(tile_group, tuple_id);
+    tuple_ptrs.push_back(&tuples.back());
+  }
+
+  std::vector<uint32_t> sel(tuple_ids.size());
+  for (auto predicate : batch_predicates_) {
+    if (tuple_ids.empty()) {
+      return;
+    }
+    uint32_t count = predicate->FilterBatch(
+        tuple_ptrs.data(), tuple_ptrs.size(), sel.data(), executor_context_);
+    for (uint32_t i = 0; i < count; i++) {
+      tuple_ptrs[i] = tuple_ptrs[sel[i]];
+      tuple_ids[i] = tuple_ids[sel[i]];
+    }
+    tuple_ptrs.resize(count);
+    tuple_ids.resize(count);
+  }
+
+  if (row_predicates_.empty()) {
+    return;
+  }
+  size_t selected = 0;
+  for (size_t i = 0; i < tuple_ids.size(); i++) {
+    bool satisfied = true;
+    for (auto predicate : row_predicates_) {
+      LOG_TRACE("Evaluate predicate for a tuple");
+      auto eval = predicate->Evaluate(tuple_ptrs[i], nullptr,
+                                      executor_context_);
+      if (eval.IsTrue() == false) {
+        satisfied = false;
+        break;
+      }
+    }
+    if (satisfied) {
+      tuple_ids[selected++] = tuple_ids[i];
+    }
+  }
+  tuple_ids.resize(selected);
 }
 
 // Transfer a list of equality predicate
@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// spill_file.cpp
+//
+// Identification: src/executor/spill_file.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/spill_file.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace executor {
+
+// Rows are handed to the OS once this many bytes have been buffered
+#define SPILL_FILE_WRITE_BUFFER_SIZE (256 * 1024)
+
+SpillFile::SpillFile() {
+  file_ = tmpfile();
+  if (file_ == nullptr) {
+    throw ExecutorException(std::string("Failed to create spill file: ") +
+                            strerror(errno));
+  }
+}
+
+SpillFile::~SpillFile() { fclose(file_); }
+
+void SpillFile::Append(const std::vector<type::Value> &values) {
+  // Reserve room for the row length and patch it in afterwards
+  size_t row_start = write_buffer_.Position();
+  write_buffer_.WriteInt(0);
+  for (auto &value : values) {
+    write_buffer_.WriteEnumInSingleByte(static_cast<int>(value.GetTypeId()));
+    value.SerializeTo(write_buffer_);
+  }
+  size_t row_length = write_buffer_.Position() - row_start - sizeof(int32_t);
+  write_buffer_.WriteIntAt(row_start, static_cast<int32_t>(row_length));
+
+  row_count_++;
+  byte_count_ += row_length + sizeof(int32_t);
+
+  if (write_buffer_.Size() >= SPILL_FILE_WRITE_BUFFER_SIZE) {
+    FlushWriteBuffer();
+  }
+}
+
+void SpillFile::FlushWriteBuffer() {
+  if (write_buffer_.Size() == 0) return;
+
+  if (fwrite(write_buffer_.Data(), 1, write_buffer_.Size(), file_) !=
+      write_buffer_.Size()) {
+    throw ExecutorException(std::string("Failed to write spill file: ") +
+                            strerror(errno));
+  }
+  write_buffer_.Reset();
+}
+
+void SpillFile::Rewind() {
+  FlushWriteBuffer();
+  if (fflush(file_) != 0 || fseek(file_, 0, SEEK_SET) != 0) {
+    throw ExecutorException(std::string("Failed to rewind spill file: ") +
+                            strerror(errno));
+  }
+}
+
+bool SpillFile::Next(std::vector<type::Value> &values) {
+  values.clear();
+
+  int32_t row_length;
+  if (fread(&row_length, sizeof(row_length), 1, file_) != 1) {
+    return false;
+  }
+
+  read_buffer_.resize(row_length);
+  if (row_length > 0 &&
+      fread(read_buffer_.data(), 1, row_length, file_) !=
+          static_cast<size_t>(row_length)) {
+    throw ExecutorException("Spill file is truncated");
+  }
+
+  ReferenceSerializeInput input(read_buffer_.data(), row_length);
+  size_t consumed = 0;
+  while (consumed < static_cast<size_t>(row_length)) {
+    auto type_id = static_cast<type::TypeId>(input.ReadEnumInSingleByte());
+    auto value = type::Value::DeserializeFrom(input, type_id);
+
+    // Variable length values point into the read buffer, which is reused for
+    // the next row
+    if (type_id == type::TypeId::VARCHAR && value.IsNull() == false) {
+      value = type::ValueFactory::GetVarcharValue(value.GetData(),
+                                                  value.GetLength(), true);
+    } else if (type_id == type::TypeId::VARBINARY && value.IsNull() == false) {
+      value = type::ValueFactory::GetVarbinaryValue(
+          reinterpret_cast<const unsigned char *>(value.GetData()),
+          value.GetLength(), true);
+    }
+    values.push_back(std::move(value));
+
+    consumed = static_cast<size_t>(
+        static_cast<const char *>(input.getRawPointer(0)) -
+        read_buffer_.data());
+  }
+
+  return true;
+}
+
+}  // namespace executor
+}  // namespace peloton
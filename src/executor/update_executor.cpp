@@ -20,6 +20,7 @@
 #include "concurrency/transaction.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "storage/data_table.h"
+#include "storage/tile_group.h"
 #include "storage/tile_group_header.h"
 #include "storage/tile.h"
 
@@ -237,6 +238,7 @@ bool UpdateExecutor::DExecute() {
         // Execute the projections
         project_info_->Evaluate(&old_tuple, &old_tuple, nullptr,
                                 executor_context_);
+        tile_group->UpdateZoneMap(physical_tuple_id);
 
         transaction_manager.PerformUpdate(current_txn, old_location);
       }
@@ -301,6 +303,7 @@ bool UpdateExecutor::DExecute() {
           // another version.
           project_info_->Evaluate(&new_tuple, &old_tuple, nullptr,
                                   executor_context_);
+          new_tile_group->UpdateZoneMap(new_location.offset);
 
           // get indirection.
           ItemPointer *indirection =
@@ -0,0 +1,155 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// in_list_set.cpp
+//
+// Identification: src/function/in_list_set.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "function/in_list_set.h"
+
+#include <algorithm>
+
+namespace peloton {
+namespace function {
+
+// Bits the bitmap may spend on every value of the list, and in total
+static const int64_t kBitmapBitsPerValue = 64;
+static const int64_t kMaxBitmapBits = 1 << 16;
+
+static bool IsInteger(type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static int64_t GetInteger(const type::Value &value) {
+  switch (value.GetTypeId()) {
+    case type::TypeId::TINYINT:
+      return value.GetAs<int8_t>();
+    case type::TypeId::SMALLINT:
+      return value.GetAs<int16_t>();
+    case type::TypeId::INTEGER:
+      return value.GetAs<int32_t>();
+    default:
+      return value.GetAs<int64_t>();
+  }
+}
+
+static std::string GetString(const type::Value &value) {
+  auto length = value.GetLength();
+  return std::string(value.GetAs<const char *>(), length > 0 ? length - 1 : 0);
+}
+
+InListSet::InListSet(const std::vector<type::Value> &values)
+    : has_null_(false),
+      all_integers_(true),
+      all_strings_(true),
+      min_(0) {
+  for (auto &value : values) {
+    if (value.IsNull()) {
+      has_null_ = true;
+      continue;
+    }
+    all_integers_ &= IsInteger(value.GetTypeId());
+    all_strings_ &= value.GetTypeId() == type::TypeId::VARCHAR;
+    values_.push_back(value.Copy());
+  }
+
+  if (values_.empty()) {
+    all_integers_ = all_strings_ = false;
+  } else if (all_integers_) {
+    std::vector<int64_t> integers;
+    for (auto &value : values_) {
+      integers.push_back(GetInteger(value));
+    }
+    auto minmax = std::minmax_element(integers.begin(), integers.end());
+    int64_t min = *minmax.first, max = *minmax.second;
+    // Subtract as unsigned, the range of a list can overflow int64_t
+    uint64_t range = static_cast<uint64_t>(max) - static_cast<uint64_t>(min);
+    if (range < static_cast<uint64_t>(kMaxBitmapBits) &&
+        range < static_cast<uint64_t>(kBitmapBitsPerValue * integers.size())) {
+      min_ = min;
+      bitmap_.resize(range + 1);
+      for (auto integer : integers) {
+        bitmap_[integer - min_] = true;
+      }
+    } else {
+      integers_.insert(integers.begin(), integers.end());
+    }
+  } else if (all_strings_) {
+    for (auto &value : values_) {
+      strings_.insert(GetString(value));
+    }
+  }
+}
+
+bool InListSet::ContainsInteger(int64_t value) const {
+  PL_ASSERT(all_integers_);
+  if (HasBitmap()) {
+    uint64_t offset =
+        static_cast<uint64_t>(value) - static_cast<uint64_t>(min_);
+    return offset < bitmap_.size() && bitmap_[offset];
+  }
+  return integers_.count(value) > 0;
+}
+
+bool InListSet::ContainsString(const char *str, uint32_t length) const {
+  PL_ASSERT(all_strings_);
+  if (str == nullptr) {
+    return false;
+  }
+  if (length > 0 && str[length - 1] == '\0') {
+    length--;
+  }
+  return strings_.count(std::string(str, length)) > 0;
+}
+
+type::CmpBool InListSet::Find(const type::Value &value) const {
+  if (value.IsNull()) {
+    return type::CMP_NULL;
+  }
+
+  bool found = false;
+  if (all_integers_ && IsInteger(value.GetTypeId())) {
+    found = ContainsInteger(GetInteger(value));
+  } else if (all_strings_ && value.GetTypeId() == type::TypeId::VARCHAR) {
+    found = strings_.count(GetString(value)) > 0;
+  } else {
+    for (auto &candidate : values_) {
+      if (value.CompareEquals(candidate) == type::CMP_TRUE) {
+        found = true;
+        break;
+      }
+    }
+  }
+
+  if (found) {
+    return type::CMP_TRUE;
+  }
+  return has_null_ ? type::CMP_NULL : type::CMP_FALSE;
+}
+
+uint32_t InListSet::FindBatch(const int64_t *values, uint32_t count,
+                              uint32_t *sel) const {
+  PL_ASSERT(all_integers_);
+  uint32_t matched = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    sel[matched] = i;
+    matched += ContainsInteger(values[i]);
+  }
+  return matched;
+}
+
+}  // namespace function
+}  // namespace peloton
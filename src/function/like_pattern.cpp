@@ -0,0 +1,252 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// like_pattern.cpp
+//
+// Identification: src/function/like_pattern.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "function/like_pattern.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <vector>
+
+namespace peloton {
+namespace function {
+
+static const char kAnyString = '%';
+static const char kAnyChar = '_';
+static const char kEscape = '\\';
+
+static inline bool CharEquals(char a, char b, bool case_insensitive) {
+  return a == b ||
+         (case_insensitive &&
+          std::tolower(static_cast<unsigned char>(a)) ==
+              std::tolower(static_cast<unsigned char>(b)));
+}
+
+static inline bool BytesEqual(const char *a, const char *b, uint32_t length,
+                              bool case_insensitive) {
+  if (!case_insensitive) {
+    return std::memcmp(a, b, length) == 0;
+  }
+  for (uint32_t i = 0; i < length; i++) {
+    if (!CharEquals(a[i], b[i], true)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Match a string against a pattern that is a single literal
+static bool MatchLiteral(LikePattern::Kind kind, const char *str,
+                         uint32_t length, const char *literal,
+                         uint32_t literal_length, bool case_insensitive) {
+  switch (kind) {
+    case LikePattern::Kind::EXACT:
+      return length == literal_length &&
+             BytesEqual(str, literal, length, case_insensitive);
+    case LikePattern::Kind::PREFIX:
+      return length >= literal_length &&
+             BytesEqual(str, literal, literal_length, case_insensitive);
+    case LikePattern::Kind::SUFFIX:
+      return length >= literal_length &&
+             BytesEqual(str + length - literal_length, literal, literal_length,
+                        case_insensitive);
+    case LikePattern::Kind::CONTAINS: {
+      if (literal_length == 0) {
+        return true;
+      }
+      if (!case_insensitive) {
+        // glibc vectorizes memmem, which beats a byte-wise search
+        return memmem(str, length, literal, literal_length) != nullptr;
+      }
+      auto end = str + length;
+      return std::search(str, end, literal, literal + literal_length,
+                         [](char a, char b) {
+                           return CharEquals(a, b, true);
+                         }) != end;
+    }
+    default:
+      return false;
+  }
+}
+
+// Backtracking wildcard matcher, it only returns to the most recent '%'
+static bool MatchWildcards(const char *str, uint32_t length,
+                           const char *pattern, uint32_t pattern_length,
+                           bool case_insensitive) {
+  uint32_t s = 0, p = 0;
+  uint32_t star_p = pattern_length + 1, star_s = 0;
+  while (s < length) {
+    if (p < pattern_length) {
+      char pc = pattern[p];
+      if (pc == kAnyString) {
+        star_p = ++p;
+        star_s = s;
+        continue;
+      }
+      uint32_t next = p + 1;
+      if (pc == kEscape && p + 1 < pattern_length) {
+        pc = pattern[p + 1];
+        next = p + 2;
+      } else if (pc == kAnyChar) {
+        s++;
+        p = next;
+        continue;
+      }
+      if (CharEquals(pc, str[s], case_insensitive)) {
+        s++;
+        p = next;
+        continue;
+      }
+    }
+    if (star_p > pattern_length) {
+      return false;
+    }
+    p = star_p;
+    s = ++star_s;
+  }
+  while (p < pattern_length && pattern[p] == kAnyString) {
+    p++;
+  }
+  return p == pattern_length;
+}
+
+LikePattern::LikePattern(const char *pattern, uint32_t length,
+                         bool case_insensitive)
+    : kind_(Kind::GENERIC),
+      case_insensitive_(case_insensitive),
+      pattern_(pattern, length) {
+  // Split the pattern into characters, marking the wildcards
+  std::string chars;
+  std::vector<bool> is_wildcard;
+  for (uint32_t i = 0; i < length; i++) {
+    if (pattern[i] == kEscape && i + 1 < length) {
+      chars.push_back(pattern[++i]);
+      is_wildcard.push_back(false);
+    } else {
+      chars.push_back(pattern[i]);
+      is_wildcard.push_back(pattern[i] == kAnyString ||
+                            pattern[i] == kAnyChar);
+    }
+  }
+
+  size_t first_wildcard = 0;
+  while (first_wildcard < chars.size() && !is_wildcard[first_wildcard]) {
+    first_wildcard++;
+  }
+  if (!case_insensitive) {
+    prefix_ = chars.substr(0, first_wildcard);
+  }
+
+  // A literal surrounded by nothing but '%'
+  size_t begin = 0, end = chars.size();
+  while (begin < end && is_wildcard[begin] && chars[begin] == kAnyString) {
+    begin++;
+  }
+  while (end > begin && is_wildcard[end - 1] && chars[end - 1] == kAnyString) {
+    end--;
+  }
+  for (size_t i = begin; i < end; i++) {
+    if (is_wildcard[i]) {
+      return;
+    }
+  }
+  literal_ = chars.substr(begin, end - begin);
+  bool leading = begin > 0, trailing = end < chars.size();
+  if (leading && (trailing || literal_.empty())) {
+    kind_ = Kind::CONTAINS;
+  } else if (leading) {
+    kind_ = Kind::SUFFIX;
+  } else if (trailing) {
+    kind_ = Kind::PREFIX;
+  } else {
+    kind_ = Kind::EXACT;
+  }
+}
+
+bool LikePattern::Match(const char *str, uint32_t length) const {
+  if (kind_ == Kind::GENERIC) {
+    return MatchGeneric(str, length);
+  }
+  return MatchLiteral(kind_, str, length, literal_.data(), literal_.size(),
+                      case_insensitive_);
+}
+
+bool LikePattern::MatchString(const char *str, uint32_t length) const {
+  if (str == nullptr) {
+    return false;
+  }
+  if (length > 0 && str[length - 1] == '\0') {
+    length--;
+  }
+  return Match(str, length);
+}
+
+uint32_t LikePattern::MatchBatch(const char *const *strs,
+                                 const uint32_t *lengths, uint32_t count,
+                                 uint32_t *sel) const {
+  // Dispatch on the kind once for the whole batch
+  uint32_t matched = 0;
+  if (kind_ == Kind::GENERIC) {
+    for (uint32_t i = 0; i < count; i++) {
+      sel[matched] = i;
+      matched += MatchGeneric(strs[i], lengths[i]);
+    }
+    return matched;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    sel[matched] = i;
+    matched += MatchLiteral(kind_, strs[i], lengths[i], literal_.data(),
+                            literal_.size(), case_insensitive_);
+  }
+  return matched;
+}
+
+bool LikePattern::MatchGeneric(const char *str, uint32_t length) const {
+  return MatchWildcards(str, length, pattern_.data(), pattern_.size(),
+                        case_insensitive_);
+}
+
+bool LikePattern::Match(const char *str, uint32_t length, const char *pattern,
+                        uint32_t pattern_length, bool case_insensitive) {
+  // Take the fast paths for patterns without escapes, that needs no copy of
+  // the literal
+  uint32_t begin = 0, end = pattern_length;
+  while (begin < end && pattern[begin] == kAnyString) {
+    begin++;
+  }
+  while (end > begin && pattern[end - 1] == kAnyString) {
+    end--;
+  }
+  const char *literal = pattern + begin;
+  uint32_t literal_length = end - begin;
+  if (std::find_if(literal, literal + literal_length, [](char c) {
+        return c == kAnyString || c == kAnyChar || c == kEscape;
+      }) != literal + literal_length) {
+    return MatchWildcards(str, length, pattern, pattern_length,
+                          case_insensitive);
+  }
+
+  bool leading = begin > 0, trailing = end < pattern_length;
+  Kind kind = Kind::EXACT;
+  if (leading && (trailing || literal_length == 0)) {
+    kind = Kind::CONTAINS;
+  } else if (leading) {
+    kind = Kind::SUFFIX;
+  } else if (trailing) {
+    kind = Kind::PREFIX;
+  }
+  return MatchLiteral(kind, str, length, literal, literal_length,
+                      case_insensitive);
+}
+
+}  // namespace function
+}  // namespace peloton
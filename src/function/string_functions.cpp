@@ -13,6 +13,8 @@
 #include <string>
 
 #include "function/string_functions.h"
+
+#include "function/like_pattern.h"
 #include "type/value_factory.h"
 
 namespace peloton {
@@ -34,6 +36,25 @@ type::Value StringFunctions::_Ascii(const std::vector<type::Value> &args) {
   return type::ValueFactory::GetIntegerValue(ret);
 }
 
+// The lengths of varchars count their NUL terminator
+static inline uint32_t StringLength(const char *str, uint32_t length) {
+  return (length > 0 && str[length - 1] == '\0') ? length - 1 : length;
+}
+
+bool StringFunctions::Like(const char *str, uint32_t length,
+                           const char *pattern, uint32_t pattern_length) {
+  PL_ASSERT(str != nullptr && pattern != nullptr);
+  return LikePattern::Match(str, StringLength(str, length), pattern,
+                            StringLength(pattern, pattern_length));
+}
+
+bool StringFunctions::ILike(const char *str, uint32_t length,
+                            const char *pattern, uint32_t pattern_length) {
+  PL_ASSERT(str != nullptr && pattern != nullptr);
+  return LikePattern::Match(str, StringLength(str, length), pattern,
+                            StringLength(pattern, pattern_length), true);
+}
+
 // Get Character from integer
 type::Value StringFunctions::Chr(const std::vector<type::Value> &args) {
   PL_ASSERT(args.size() == 1);
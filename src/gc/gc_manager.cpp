@@ -26,8 +26,8 @@ void GCManager::CheckAndReclaimVarlenColumns(storage::TileGroup *tg, oid_t tuple
     oid_t tile_count = tg->tile_count;
     oid_t tile_col_count;
     type::TypeId type_id;
-    char *tuple_location;
-    char *field_location;
+    alignas(uint64_t) char field_buffer[sizeof(uint64_t)];
+    const char *field_location;
     char *varlen_ptr;
 
       for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
@@ -46,9 +46,10 @@ void GCManager::CheckAndReclaimVarlenColumns(storage::TileGroup *tg, oid_t tuple
                   continue;
               }
             // Get the raw varlen pointer
-              tuple_location = tile->GetTupleLocation(tuple_id);
-            field_location = tuple_location + schema.GetOffset(tile_col_itr);
-            varlen_ptr = type::Value::GetDataFromStorage(type_id, field_location);
+            field_location = tile->GetFieldLocation(tuple_id, tile_col_itr,
+                                                    field_buffer);
+            varlen_ptr = type::Value::GetDataFromStorage(
+                type_id, const_cast<char *>(field_location));
             // Call the corresponding varlen pool free
               if (varlen_ptr != nullptr) {
                 tile->pool->Free(varlen_ptr);
@@ -14,6 +14,7 @@
 
 #include "catalog/manager.h"
 #include "common/container_tuple.h"
+#include "container/epoch_reclaimer.h"
 #include "concurrency/epoch_manager_factory.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "storage/database.h"
@@ -47,6 +48,58 @@ bool TransactionLevelGCManager::ResetTuple(const ItemPointer &location) {
   return true;
 }
 
+void TransactionLevelGCManager::ResetPartitions() {
+  partitions_.clear();
+  partitions_.resize(gc_thread_count_ * GC_MAX_PARTITIONS_PER_THREAD);
+  allocated_partition_count_ = 0;
+
+  size_t partition_count = gc_thread_count_ * GC_PARTITIONS_PER_THREAD;
+  AllocatePartitions(partition_count);
+  partition_count_ = partition_count;
+  active_thread_count_ = gc_thread_count_;
+}
+
+void TransactionLevelGCManager::AllocatePartitions(size_t partition_count) {
+  if (partition_count <= allocated_partition_count_.load()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(partition_mutex_);
+  size_t allocated_count = allocated_partition_count_.load();
+  for (size_t i = allocated_count; i < partition_count; ++i) {
+    partitions_[i].reset(new GCPartition());
+  }
+  if (partition_count > allocated_count) {
+    allocated_partition_count_.store(partition_count,
+                                     std::memory_order_release);
+  }
+}
+
+void TransactionLevelGCManager::ResizePartitions() {
+  size_t table_count = GetTableCount();
+  size_t tile_group_count =
+      catalog::Manager::GetInstance().GetTileGroupCount();
+
+  size_t partition_count = std::max(
+      table_count, tile_group_count / GC_TILE_GROUPS_PER_PARTITION);
+  partition_count = std::max<size_t>(partition_count, 1);
+  partition_count = std::min(partition_count, partitions_.size());
+
+  int thread_count = static_cast<int>(
+      (partition_count + GC_PARTITIONS_PER_THREAD - 1) /
+      GC_PARTITIONS_PER_THREAD);
+  thread_count = std::min(thread_count, gc_thread_count_);
+
+  // The partitions have to exist before garbage is sent to them
+  AllocatePartitions(partition_count);
+  if (partition_count != partition_count_.load()) {
+    LOG_DEBUG("Resizing the GC to %lu partitions and %d threads for %lu "
+              "tables and %lu tile groups",
+              partition_count, thread_count, table_count, tile_group_count);
+  }
+  partition_count_.store(partition_count, std::memory_order_release);
+  active_thread_count_.store(thread_count);
+}
+
 void TransactionLevelGCManager::Running(const int &thread_id) {
   PL_ASSERT(is_running_ == true);
   uint32_t backoff_shifts = 0;
@@ -61,16 +114,31 @@ void TransactionLevelGCManager::Running(const int &thread_id) {
       continue;
     }
 
-    int reclaimed_count = Reclaim(thread_id, expired_eid);
+    if (thread_id == 0) {
+      ResizePartitions();
+    }
 
-    int unlinked_count = Unlink(thread_id, expired_eid);
+    int reclaimed_count = 0;
+    int unlinked_count = 0;
+    if (thread_id < active_thread_count_.load()) {
+      // Tables and tile groups dropped concurrently stay valid until the
+      // guard is released
+      EpochGuard guard;
+      reclaimed_count = Reclaim(thread_id, expired_eid);
+      unlinked_count = Unlink(thread_id, expired_eid);
+    }
+
+    // Free the memory retired by the indexes and the storage layer, which
+    // bounds the delay between the retirement of an object and its freeing
+    size_t freed_count = EpochReclaimer::GetInstance().ReclaimAll();
 
     if (is_running_ == false) {
       return;
     }
-    if (reclaimed_count == 0 && unlinked_count == 0) {
-      // sleep at most 0.8192 s
-      if (backoff_shifts < 13) {
+    if (reclaimed_count == 0 && unlinked_count == 0 && freed_count == 0) {
+      // sleep at most 51.2 ms, about one epoch, so that the garbage of an
+      // update-heavy workload does not pile up while we sleep
+      if (backoff_shifts < 9) {
         ++backoff_shifts;
       }
       uint64_t sleep_duration = 1UL << backoff_shifts;
@@ -85,22 +153,113 @@ void TransactionLevelGCManager::Running(const int &thread_id) {
 void TransactionLevelGCManager::RecycleTransaction(
     std::shared_ptr<GCSet> gc_set, std::shared_ptr<GCObjectSet> gc_object_set,
     const eid_t &epoch_id, const size_t &thread_id) {
-  // Add the garbage context to the lock-free queue
-  std::shared_ptr<GarbageContext> gc_context(
-      new GarbageContext(gc_set, gc_object_set, epoch_id));
-  unlink_queues_[HashToThread(thread_id)]->Enqueue(gc_context);
+  // Dropped objects are collected by the partition of the worker thread
+  size_t object_partition = HashToPartition(thread_id);
+
+  // Most transactions only touch tile groups of a single partition, in
+  // which case the garbage is queued as it is
+  size_t partition = object_partition;
+  if (gc_set->empty() == false) {
+    partition = HashToPartition(gc_set->begin()->first);
+  }
+  bool single_partition =
+      (partition == object_partition || gc_object_set->empty() == true);
+  for (auto &entry : *gc_set) {
+    if (single_partition == false) {
+      break;
+    }
+    single_partition = (HashToPartition(entry.first) == partition);
+  }
+
+  if (single_partition == true) {
+    std::shared_ptr<GarbageContext> gc_context(
+        new GarbageContext(gc_set, gc_object_set, epoch_id));
+    partitions_[partition]->unlink_queue_.Enqueue(gc_context);
+    return;
+  }
+
+  // Otherwise split the versions by partition, so that the GC threads
+  // collect them in parallel
+  std::unordered_map<size_t, std::shared_ptr<GCSet>> partition_gc_sets;
+  for (auto &entry : *gc_set) {
+    auto &partition_gc_set = partition_gc_sets[HashToPartition(entry.first)];
+    if (partition_gc_set == nullptr) {
+      partition_gc_set.reset(new GCSet());
+    }
+    partition_gc_set->insert(entry);
+  }
+
+  std::shared_ptr<GCObjectSet> empty_object_set(new GCObjectSet());
+  for (auto &partition_entry : partition_gc_sets) {
+    auto &partition_object_set =
+        (partition_entry.first == object_partition ? gc_object_set
+                                                   : empty_object_set);
+    std::shared_ptr<GarbageContext> gc_context(new GarbageContext(
+        partition_entry.second, partition_object_set, epoch_id));
+    partitions_[partition_entry.first]->unlink_queue_.Enqueue(gc_context);
+  }
+
+  if (gc_object_set->empty() == false &&
+      partition_gc_sets.count(object_partition) == 0) {
+    std::shared_ptr<GarbageContext> gc_context(new GarbageContext(
+        std::shared_ptr<GCSet>(new GCSet()), gc_object_set, epoch_id));
+    partitions_[object_partition]->unlink_queue_.Enqueue(gc_context);
+  }
+}
+
+bool TransactionLevelGCManager::HelpCollect(const oid_t &tile_group_id) {
+  if (is_running_ == false) {
+    return false;
+  }
+
+  auto &partition = *partitions_[HashToPartition(tile_group_id)];
+
+  // Someone is already collecting this partition
+  if (partition.lock_.TryLock() == false) {
+    return false;
+  }
+
+  auto expired_eid =
+      concurrency::EpochManagerFactory::GetInstance().GetExpiredEpochId();
+  if (expired_eid != MAX_EID) {
+    EpochGuard guard;
+    ReclaimPartition(partition, expired_eid, GC_HELP_BATCH_SIZE);
+    UnlinkPartition(partition, expired_eid, GC_HELP_BATCH_SIZE);
+  }
+
+  partition.lock_.Unlock();
+  return true;
 }
 
 int TransactionLevelGCManager::Unlink(const int &thread_id,
                                       const eid_t &expired_eid) {
   int tuple_counter = 0;
 
+  size_t partition_count =
+      allocated_partition_count_.load(std::memory_order_acquire);
+  size_t thread_count = std::max(active_thread_count_.load(), 1);
+  for (size_t i = thread_id; i < partition_count; i += thread_count) {
+    auto &partition = *partitions_[i];
+    partition.lock_.Lock();
+    tuple_counter += UnlinkPartition(partition, expired_eid, MAX_ATTEMPT_COUNT);
+    partition.lock_.Unlock();
+  }
+
+  LOG_TRACE("Marked %d tuples as garbage", tuple_counter);
+  return tuple_counter;
+}
+
+int TransactionLevelGCManager::UnlinkPartition(GCPartition &partition,
+                                               const eid_t &expired_eid,
+                                               const size_t &max_count) {
+  int tuple_counter = 0;
+
   // check if any garbage can be unlinked from indexes.
-  // every time we garbage collect at most MAX_ATTEMPT_COUNT tuples.
+  // every time we garbage collect at most max_count tuples.
   std::vector<std::shared_ptr<GarbageContext>> garbages;
 
   // First iterate the local unlink queue
-  local_unlink_queues_[thread_id].remove_if(
+  partition.local_unlink_queue_.remove_if(
       [&garbages, &tuple_counter, expired_eid, this](
           const std::shared_ptr<GarbageContext> &garbage_ctx) -> bool {
         bool res = garbage_ctx->epoch_id_ <= expired_eid;
@@ -114,10 +273,10 @@ int TransactionLevelGCManager::Unlink(const int &thread_id,
         return res;
       });
 
-  for (size_t i = 0; i < MAX_ATTEMPT_COUNT; ++i) {
+  for (size_t i = 0; i < max_count; ++i) {
     std::shared_ptr<GarbageContext> garbage_ctx;
     // if there's no more tuples in the queue, then break.
-    if (unlink_queues_[thread_id]->Dequeue(garbage_ctx) == false) {
+    if (partition.unlink_queue_.Dequeue(garbage_ctx) == false) {
       break;
     }
 
@@ -135,7 +294,7 @@ int TransactionLevelGCManager::Unlink(const int &thread_id,
 
     } else {
       // if a tuple cannot be reclaimed, then add it back to the list.
-      local_unlink_queues_[thread_id].push_back(garbage_ctx);
+      partition.local_unlink_queue_.push_back(garbage_ctx);
     }
   }  // end for
 
@@ -146,37 +305,56 @@ int TransactionLevelGCManager::Unlink(const int &thread_id,
       concurrency::EpochManagerFactory::GetInstance().GetCurrentEpochId();
 
   for (auto &item : garbages) {
-    reclaim_maps_[thread_id].insert(std::make_pair(safe_expired_eid, item));
+    partition.reclaim_queue_.emplace_back(safe_expired_eid, item);
   }
-  LOG_TRACE("Marked %d tuples as garbage", tuple_counter);
   return tuple_counter;
 }
 
-// executed by a single thread. so no synchronization is required.
 int TransactionLevelGCManager::Reclaim(const int &thread_id,
                                        const eid_t &expired_eid) {
   int gc_counter = 0;
 
+  size_t partition_count =
+      allocated_partition_count_.load(std::memory_order_acquire);
+  size_t thread_count = std::max(active_thread_count_.load(), 1);
+  for (size_t i = thread_id; i < partition_count; i += thread_count) {
+    auto &partition = *partitions_[i];
+    partition.lock_.Lock();
+    gc_counter += ReclaimPartition(partition, expired_eid, MAX_ATTEMPT_COUNT);
+    partition.lock_.Unlock();
+  }
+
+  LOG_TRACE("Marked %d txn contexts as recycled", gc_counter);
+  return gc_counter;
+}
+
+// executed by the thread holding the partition's lock, so no further
+// synchronization is required.
+int TransactionLevelGCManager::ReclaimPartition(GCPartition &partition,
+                                                const eid_t &expired_eid,
+                                                const size_t &max_count) {
+  int gc_counter = 0;
+
   // we delete garbage in the free list
-  auto garbage_ctx_entry = reclaim_maps_[thread_id].begin();
-  while (garbage_ctx_entry != reclaim_maps_[thread_id].end()) {
-    const eid_t garbage_eid = garbage_ctx_entry->first;
-    auto garbage_ctx = garbage_ctx_entry->second;
+  auto &reclaim_queue = partition.reclaim_queue_;
+  while (reclaim_queue.empty() == false &&
+         static_cast<size_t>(gc_counter) < max_count) {
+    const eid_t garbage_eid = reclaim_queue.front().first;
 
     // if the global expired epoch id is no less than the garbage version's
     // epoch id, then recycle the garbage version
     if (garbage_eid <= expired_eid) {
-      AddToRecycleMap(garbage_ctx);
+      auto garbage_ctx = std::move(reclaim_queue.front().second);
 
-      // Remove from the original map
-      garbage_ctx_entry = reclaim_maps_[thread_id].erase(garbage_ctx_entry);
+      // Remove from the original queue
+      reclaim_queue.pop_front();
+      AddToRecycleMap(garbage_ctx);
       gc_counter++;
     } else {
-      // Early break since we use an ordered map
+      // Early break since the queue is ordered by epoch
       break;
     }
   }
-  LOG_TRACE("Marked %d txn contexts as recycled", gc_counter);
   return gc_counter;
 }
 
@@ -199,8 +377,9 @@ void TransactionLevelGCManager::AddToRecycleMap(
         dynamic_cast<storage::DataTable *>(tile_group->GetAbstractTable());
     PL_ASSERT(table != nullptr);
 
-    oid_t table_id = table->GetOid();
+    bool is_registered = registered_tables_.Contains(table->GetOid());
 
+    std::vector<oid_t> free_slots;
     for (auto &element : entry.second) {
       // as this transaction has been committed, we should reclaim older
       // versions.
@@ -210,10 +389,12 @@ void TransactionLevelGCManager::AddToRecycleMap(
       if (ResetTuple(location) == false) {
         continue;
       }
-      // if the entry for table_id exists.
-      if (recycle_queue_map_.find(table_id) != recycle_queue_map_.end()) {
-        recycle_queue_map_[table_id]->Enqueue(location);
-      }
+      free_slots.push_back(element.first);
+    }
+
+    // hand the slots of the tile group over to the table in one batch
+    if (is_registered == true) {
+      table->GetRecycledSlotAllocator().Recycle(entry.first, free_slots);
     }
   }
 
@@ -242,35 +423,27 @@ void TransactionLevelGCManager::AddToRecycleMap(
   }
 }
 
-// this function returns a free tuple slot, if one exists
-// called by data_table.
-ItemPointer TransactionLevelGCManager::ReturnFreeSlot(const oid_t &table_id) {
-  // for catalog tables, we directly return invalid item pointer.
-  if (recycle_queue_map_.find(table_id) == recycle_queue_map_.end()) {
-    return INVALID_ITEMPOINTER;
-  }
-  ItemPointer location;
-  PL_ASSERT(recycle_queue_map_.find(table_id) != recycle_queue_map_.end());
-  auto recycle_queue = recycle_queue_map_[table_id];
-
-  if (recycle_queue->Dequeue(location) == true) {
-    LOG_TRACE("Reuse tuple(%u, %u) in table %u", location.block,
-              location.offset, table_id);
-    return location;
-  }
-  return INVALID_ITEMPOINTER;
-}
-
 void TransactionLevelGCManager::ClearGarbage(int thread_id) {
-  while (!unlink_queues_[thread_id]->IsEmpty() ||
-         !local_unlink_queues_[thread_id].empty()) {
-    Unlink(thread_id, MAX_CID);
-  }
+  // Idle threads clear their share of the partitions as well
+  size_t partition_count =
+      allocated_partition_count_.load(std::memory_order_acquire);
+  for (size_t i = thread_id; i < partition_count; i += gc_thread_count_) {
+    auto &partition = *partitions_[i];
+    partition.lock_.Lock();
+    while (!partition.unlink_queue_.IsEmpty() ||
+           !partition.local_unlink_queue_.empty()) {
+      UnlinkPartition(partition, MAX_CID, MAX_ATTEMPT_COUNT);
+    }
 
-  while (reclaim_maps_[thread_id].size() != 0) {
-    Reclaim(thread_id, MAX_CID);
+    while (partition.reclaim_queue_.size() != 0) {
+      ReclaimPartition(partition, MAX_CID, MAX_ATTEMPT_COUNT);
+    }
+    partition.lock_.Unlock();
   }
 
+  // Free the tables and tile groups dropped by the garbage
+  EpochReclaimer::GetInstance().ReclaimAll();
+
   return;
 }
 
@@ -0,0 +1,270 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// open_loop.h
+//
+// Identification: src/include/benchmark/open_loop.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark_common.h"
+#include "common/logger.h"
+#include "statistics/latency_histogram.h"
+
+namespace peloton {
+namespace benchmark {
+
+// How the arrivals of an open loop are spaced
+enum class ArrivalType {
+  FIXED = 0,    // evenly
+  POISSON = 1,  // exponentially distributed gaps
+};
+
+//===--------------------------------------------------------------------===//
+// Open Loop Driver
+//
+// Issues transactions at a target arrival rate however long they take.
+// In a closed loop a slow transaction holds back the ones behind it and the
+// wait is never measured; here every worker owns an equal share of the
+// rate and its own schedule of arrivals, and a latency counts from the
+// scheduled arrival rather than from when the worker got to it, so the time
+// spent queued behind slow transactions is part of it.
+//
+// A transaction still aborting and retrying when the run ends records the
+// time from its arrival to the end, and is counted as censored.
+//
+// Latencies are kept per transaction type for the whole run and per
+// interval for a time series. Each worker writes only its own histograms,
+// which are read once all workers are done.
+//===--------------------------------------------------------------------===//
+
+class OpenLoopDriver {
+ public:
+  // Picks the type of the next transaction, an index into the type names
+  typedef std::function<size_t()> ChooseFunction;
+
+  // Runs a transaction of the given type once, false if it aborted
+  typedef std::function<bool(size_t)> RunFunction;
+
+  OpenLoopDriver(double arrival_rate, ArrivalType arrival_type,
+                 double duration, double interval, size_t worker_count,
+                 const std::vector<std::string> &type_names)
+      : arrival_rate_(arrival_rate),
+        arrival_type_(arrival_type),
+        duration_(ToDuration(duration)),
+        interval_(interval),
+        interval_count_(
+            std::max<size_t>(1, (size_t)std::ceil(duration / interval))),
+        type_names_(type_names) {
+    for (size_t worker_id = 0; worker_id < worker_count; worker_id++) {
+      workers_.emplace_back(
+          new WorkerStats(type_names.size(), interval_count_));
+    }
+  }
+
+  // Starts the clock, right before the workers are launched
+  void Start() {
+    start_ = Clock::now();
+    end_ = start_ + duration_;
+  }
+
+  // The loop of a worker thread, until the duration is over. An aborted
+  // transaction is retried, with exponential backoff if asked for.
+  void RunWorker(size_t worker_id, const ChooseFunction &choose,
+                 const RunFunction &run, bool exp_backoff) {
+    auto &stats = *workers_[worker_id];
+    FastRandom rng(rand());
+    double mean_gap = workers_.size() / arrival_rate_;
+    auto next_gap = [&]() {
+      return ToDuration(arrival_type_ == ArrivalType::FIXED
+                            ? mean_gap
+                            : -mean_gap * std::log(1.0 - rng.NextUniform()));
+    };
+
+    // Fixed arrivals are staggered across the workers
+    Clock::time_point arrival = start_;
+    if (arrival_type_ == ArrivalType::FIXED) {
+      arrival += ToDuration(mean_gap * worker_id / workers_.size());
+    } else {
+      arrival += next_gap();
+    }
+
+    uint32_t backoff_shifts = 0;
+    while (arrival < end_ && Clock::now() < end_) {
+      std::this_thread::sleep_until(arrival);
+
+      size_t type = choose();
+      bool committed;
+      while ((committed = run(type)) == false) {
+        stats.interval_aborts[GetInterval(Clock::now())]++;
+        if (Clock::now() >= end_) {
+          break;
+        }
+        if (exp_backoff) {
+          if (backoff_shifts < 13) {
+            ++backoff_shifts;
+          }
+          uint64_t sleep_duration = 1UL << backoff_shifts;
+          sleep_duration *= 100;
+          std::this_thread::sleep_for(
+              std::chrono::microseconds(sleep_duration));
+        }
+      }
+      backoff_shifts >>= 1;
+
+      // A transaction still retrying at the end is censored: its latency
+      // is at least the time from its arrival to the end, and recording
+      // that keeps the tail from hiding the transactions that never got in
+      auto completion = committed ? Clock::now() : end_;
+      uint64_t latency = std::chrono::duration_cast<std::chrono::microseconds>(
+                             completion - arrival).count();
+      size_t interval = GetInterval(completion);
+      stats.type_latencies[type]->Record(latency);
+      stats.interval_latencies[interval]->Record(latency);
+      if (!committed) {
+        stats.censored++;
+      }
+
+      arrival += next_gap();
+    }
+
+    // Arrivals the worker was too far behind to start before the end
+    while (arrival < end_) {
+      stats.dropped++;
+      arrival += next_gap();
+    }
+  }
+
+  // Logs the latency percentiles of every transaction type, and writes
+  // them with the time series of every interval to the file
+  void WriteOutput(const std::string &file_name) const {
+    std::ofstream out(file_name);
+
+    uint64_t dropped = 0, censored = 0;
+    for (auto &worker : workers_) {
+      dropped += worker->dropped;
+      censored += worker->censored;
+    }
+
+    LOG_INFO("----------------------------------------------------------");
+    LOG_INFO("open loop :: %lf txn/s %s arrivals, %lu dropped, %lu censored",
+             arrival_rate_,
+             arrival_type_ == ArrivalType::FIXED ? "fixed" : "poisson",
+             dropped, censored);
+    out << "type count p50 p95 p99 p99.9 max (us)\n";
+    for (size_t type = 0; type < type_names_.size(); type++) {
+      stats::LatencyHistogram latencies;
+      for (auto &worker : workers_) {
+        latencies.Merge(*worker->type_latencies[type]);
+      }
+      LOG_INFO("%s :: %lu :: p50 %lu p95 %lu p99 %lu p99.9 %lu max %lu us",
+               type_names_[type].c_str(), latencies.GetCount(),
+               latencies.GetPercentile(0.5), latencies.GetPercentile(0.95),
+               latencies.GetPercentile(0.99), latencies.GetPercentile(0.999),
+               latencies.GetMax());
+      out << type_names_[type] << " " << latencies.GetCount() << " "
+          << latencies.GetPercentile(0.5) << " "
+          << latencies.GetPercentile(0.95) << " "
+          << latencies.GetPercentile(0.99) << " "
+          << latencies.GetPercentile(0.999) << " " << latencies.GetMax()
+          << "\n";
+    }
+    out << "dropped " << dropped << "\n";
+    out << "censored " << censored << "\n";
+
+    // Per interval: commits/s, aborts/s, p50, p99 and p99.9
+    for (size_t interval = 0; interval < interval_count_; interval++) {
+      stats::LatencyHistogram latencies;
+      uint64_t aborts = 0;
+      for (auto &worker : workers_) {
+        latencies.Merge(*worker->interval_latencies[interval]);
+        aborts += worker->interval_aborts[interval];
+      }
+      out << "[" << std::setw(3) << std::left << interval_ * interval
+          << " - " << std::setw(3) << std::left << interval_ * (interval + 1)
+          << " s]: " << latencies.GetCount() / interval_ << " "
+          << aborts / interval_ << " " << latencies.GetPercentile(0.5) << " "
+          << latencies.GetPercentile(0.99) << " "
+          << latencies.GetPercentile(0.999) << "\n";
+    }
+    out.flush();
+    out.close();
+  }
+
+ private:
+  typedef std::chrono::steady_clock Clock;
+
+  struct WorkerStats {
+    WorkerStats(size_t type_count, size_t interval_count)
+        : interval_aborts(interval_count, 0), dropped(0), censored(0) {
+      for (size_t type = 0; type < type_count; type++) {
+        type_latencies.emplace_back(new stats::LatencyHistogram());
+      }
+      for (size_t interval = 0; interval < interval_count; interval++) {
+        interval_latencies.emplace_back(new stats::LatencyHistogram());
+      }
+    }
+
+    std::vector<std::unique_ptr<stats::LatencyHistogram>> type_latencies;
+
+    std::vector<std::unique_ptr<stats::LatencyHistogram>> interval_latencies;
+
+    std::vector<uint64_t> interval_aborts;
+
+    uint64_t dropped;
+
+    // Transactions still retrying at the end, recorded as lower bounds
+    uint64_t censored;
+  };
+
+  static inline Clock::duration ToDuration(double seconds) {
+    return std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(seconds));
+  }
+
+  inline size_t GetInterval(Clock::time_point time) const {
+    double elapsed = std::chrono::duration<double>(time - start_).count();
+    size_t interval = elapsed > 0 ? (size_t)(elapsed / interval_) : 0;
+    return std::min(interval, interval_count_ - 1);
+  }
+
+ private:
+  // Transactions per second over all workers
+  double arrival_rate_;
+
+  ArrivalType arrival_type_;
+
+  Clock::duration duration_;
+
+  // Length of an interval of the time series (in s)
+  double interval_;
+
+  size_t interval_count_;
+
+  std::vector<std::string> type_names_;
+
+  std::vector<std::unique_ptr<WorkerStats>> workers_;
+
+  Clock::time_point start_;
+
+  Clock::time_point end_;
+};
+
+}  // namespace benchmark
+}  // namespace peloton
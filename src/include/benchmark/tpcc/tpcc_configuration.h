@@ -19,6 +19,7 @@
 #include <sys/time.h>
 #include <iostream>
 
+#include "benchmark/open_loop.h"
 #include "type/types.h"
 
 namespace peloton {
@@ -173,6 +174,9 @@ class configuration {
   // num of warehouses
   int warehouse_count;
 
+  // num of warehouse range partitions of the warehouse keyed tables
+  int partition_count;
+
   // item count
   int item_count;
 
@@ -197,6 +201,12 @@ class configuration {
   // number of loaders
   int loader_count;
 
+  // open loop arrival rate (in txn/s), 0 runs a closed loop
+  double arrival_rate;
+
+  // spacing of the open loop arrivals
+  ArrivalType arrival_type;
+
   // throughput
   double throughput = 0;
 
@@ -229,8 +239,12 @@ void ValidateBackendCount(const configuration &state);
 
 void ValidateWarehouseCount(const configuration &state);
 
+void ValidatePartitionCount(const configuration &state);
+
 void ValidateGCBackendCount(const configuration &state);
 
+void ValidateArrivalRate(const configuration &state);
+
 void WriteOutput();
 
 }  // namespace tpcc
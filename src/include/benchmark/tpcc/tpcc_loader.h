@@ -21,6 +21,7 @@ namespace peloton {
 namespace storage {
 class Database;
 class DataTable;
+class PartitionedTable;
 class Tuple;
 }
 
@@ -41,15 +42,19 @@ void LoadTPCCDatabase();
 
 extern storage::Database* tpcc_database;
 
-extern storage::DataTable* warehouse_table;
-extern storage::DataTable* district_table;
+extern storage::PartitionedTable* warehouse_table;
+extern storage::PartitionedTable* district_table;
 extern storage::DataTable* item_table;
-extern storage::DataTable* customer_table;
-extern storage::DataTable* history_table;
-extern storage::DataTable* stock_table;
-extern storage::DataTable* orders_table;
-extern storage::DataTable* new_order_table;
-extern storage::DataTable* order_line_table;
+extern storage::PartitionedTable* customer_table;
+extern storage::PartitionedTable* history_table;
+extern storage::PartitionedTable* stock_table;
+extern storage::PartitionedTable* orders_table;
+extern storage::PartitionedTable* new_order_table;
+extern storage::PartitionedTable* order_line_table;
+
+// The partition of a warehouse keyed table holding the given warehouse
+storage::DataTable* GetPartition(storage::PartitionedTable* table,
+                                 int warehouse_id);
 
 /////////////////////////////////////////////////////////
 // Constants
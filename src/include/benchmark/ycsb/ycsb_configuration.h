@@ -20,6 +20,7 @@
 #include <sys/time.h>
 #include <iostream>
 
+#include "benchmark/open_loop.h"
 #include "type/types.h"
 
 namespace peloton {
@@ -82,6 +83,16 @@ class configuration {
   // number of loaders
   int loader_count;
 
+  // open loop arrival rate (in txn/s), 0 runs a closed loop
+  double arrival_rate;
+
+  // spacing of the open loop arrivals
+  ArrivalType arrival_type;
+
+  // port of a server on the local host to run the workload against over
+  // the network, 0 runs it in the embedded engine
+  int server_port;
+
   // throughput
   double throughput = 0;
 
@@ -122,6 +133,10 @@ void ValidateZipfTheta(const configuration &state);
 
 void ValidateGCBackendCount(const configuration &state);
 
+void ValidateArrivalRate(const configuration &state);
+
+void ValidateServerPort(const configuration &state);
+
 void WriteOutput();
 
 }  // namespace ycsb
@@ -0,0 +1,41 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// ycsb_network.h
+//
+// Identification: src/include/benchmark/ycsb/ycsb_network.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+
+#include <pqxx/pqxx> /* libpqxx is used to instantiate C++ client */
+
+#include "benchmark/benchmark_common.h"
+#include "benchmark/ycsb/ycsb_configuration.h"
+
+namespace peloton {
+namespace benchmark {
+namespace ycsb {
+
+/////////////////////////////////////////////////////////
+// The workload as SQL, sent to a server on the local host
+/////////////////////////////////////////////////////////
+
+std::unique_ptr<pqxx::connection> ConnectToServer();
+
+void CreateNetworkDatabase();
+
+void LoadNetworkDatabase();
+
+bool RunNetworkMixed(pqxx::connection &connection, ZipfDistribution &zipf,
+                     FastRandom &rng);
+
+}  // namespace ycsb
+}  // namespace benchmark
+}  // namespace peloton
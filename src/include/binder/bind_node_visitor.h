@@ -20,6 +20,7 @@ namespace peloton {
 namespace expression {
 class CaseExpression;
 class ConstantExpression;
+class SubqueryExpression;
 class TupleValueExpression;
 }  // namespace expression
 
@@ -55,6 +56,7 @@ class BindNodeVisitor : public SqlNodeVisitor {
   void Visit(parser::AnalyzeStatement *) override;
 
   void Visit(expression::CaseExpression *expr) override;
+  void Visit(expression::SubqueryExpression *expr) override;
   // void Visit(const expression::ConstantValueExpression *expr) override;
   void Visit(expression::TupleValueExpression *expr) override;
   void SetTxn(concurrency::Transaction *txn) {
@@ -15,6 +15,7 @@
 #include <atomic>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "brain/clusterer.h"
@@ -72,6 +73,9 @@ class LayoutTuner {
   // Tables whose layout must be tuned
   std::vector<storage::DataTable *> tables;
 
+  // Offset of the next tile group to reorganize in each table
+  std::unordered_map<storage::DataTable *, oid_t> tile_group_cursors;
+
   std::mutex layout_tuner_mutex;
 
   // Stop signal
@@ -90,9 +94,16 @@ class LayoutTuner {
   // of a existing tilegroup and the desired schema, and normalizes this difference
   // with respect to the column count, so that it falls within [0, 1]
   // Theta should not be set to zero, otherwise it will always trigger
-  // DataTable::TransformTileGroup, even if the schema is the same.
+  // DataTable::ReorganizeTileGroup, even if the schema is the same.
   double theta = 0.0001;
 
+  // Cold tile groups with a smaller fraction of live tuples are merged into
+  // the active tile groups
+  double compaction_threshold = 0.25;
+
+  // Tile groups nobody wrote to for this long (in ms) are cold
+  uint64_t cold_period = 1000;
+
   // Sleeping period (in us)
   oid_t sleep_duration = 100;
 
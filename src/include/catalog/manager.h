@@ -64,6 +64,9 @@ class Manager {
 
   void ClearTileGroup(void);
 
+  // Approximate number of tile groups registered with the manager
+  size_t GetTileGroupCount() const { return tile_group_count_.load(); }
+
 
   //===--------------------------------------------------------------------===//
   // INDIRECTION ARRAY ALLOCATION
@@ -96,6 +99,8 @@ class Manager {
 
   LockFreeArray<std::shared_ptr<storage::TileGroup>> tile_group_locator_;
 
+  std::atomic<size_t> tile_group_count_ = ATOMIC_VAR_INIT(0);
+
   static std::shared_ptr<storage::TileGroup> empty_tile_group_;
 
   //===--------------------------------------------------------------------===//
@@ -49,7 +49,8 @@ class CompilationContext {
 
  public:
   // Constructor
-  CompilationContext(Query &query, QueryResultConsumer &result_consumer);
+  CompilationContext(Query &query, QueryResultConsumer &result_consumer,
+                     bool profile_operators = false);
 
   // Prepare a translator in this context
   void Prepare(const planner::AbstractPlan &op, Pipeline &pipeline);
@@ -84,6 +85,9 @@ class CompilationContext {
   // Get a pointer to the executor context instance
   llvm::Value *GetExecutorContextPtr();
 
+  // Is the query counting the rows each of its operators produces?
+  bool IsProfilingOperators() const { return profile_operators_; }
+
  private:
   // Generate any auxiliary helper functions that the query needs
   void GenerateHelperFunctions();
@@ -97,6 +101,11 @@ class CompilationContext {
   // Generate the tearDown() function of the query
   llvm::Function *GenerateTearDownFunction();
 
+  // Add the given number of rows to the row counter of the given operator,
+  // if the query is profiled
+  void CountOperatorRows(const OperatorTranslator *translator,
+                         llvm::Value *num_rows);
+
   // Get the registered translator for the given operator/expression
   ExpressionTranslator *GetTranslator(
       const expression::AbstractExpression &exp) const;
@@ -123,6 +132,14 @@ class CompilationContext {
   RuntimeState::StateID catalog_state_id_;
   RuntimeState::StateID executor_context_state_id_;
 
+  // Whether the rows of every operator are counted for EXPLAIN ANALYZE, and
+  // the runtime state holding the array of counters
+  bool profile_operators_;
+  RuntimeState::StateID row_counters_state_id_;
+
+  // The index of the row counter of every operator's translator
+  std::unordered_map<const OperatorTranslator *, uint32_t> row_counter_ids_;
+
   // The mapping of an operator in the tree to its translator
   std::unordered_map<const planner::AbstractPlan *,
                      std::unique_ptr<OperatorTranslator>> op_translators_;
@@ -64,6 +64,11 @@ class OAHashTable : public HashTable {
 
   void Init(CodeGen &codegen, llvm::Value *ht_ptr) const override;
 
+  // Initialize the hash-table so that it takes its memory out of the memory
+  // budget of the query the executor context belongs to
+  void Init(CodeGen &codegen, llvm::Value *exec_ctx_ptr,
+            llvm::Value *ht_ptr) const;
+
   llvm::Value *HashKey(CodeGen &codegen,
                        const std::vector<codegen::Value> &key) const;
 
@@ -93,6 +98,13 @@ class OAHashTable : public HashTable {
                const std::vector<codegen::Value> &key,
                HashTable::IterateCallback &callback) const override;
 
+  // Generate code that invokes the callback for the first value stored under
+  // the given key only, if the key exists. Probing stops as soon as the key is
+  // found, so this is cheaper than FindAll() for existence checks.
+  void FindFirst(CodeGen &codegen, llvm::Value *ht_ptr,
+                 const std::vector<codegen::Value> &key,
+                 HashTable::IterateCallback &callback) const;
+
   // An enum class indicating the type of prefetch (i.e., read or write)
   enum class PrefetchType : uint32_t { Read = 0, Write = 0 };
 
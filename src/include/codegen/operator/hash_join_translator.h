@@ -77,6 +77,22 @@ class HashJoinTranslator : public OperatorTranslator {
   void CodegenHashProbe(ConsumerContext &context, RowBatch::Row &row,
                         std::vector<codegen::Value> &key) const;
 
+  // Send every build-side tuple that never found a join partner up the
+  // pipeline, padded with NULLs for the probe side. Used by LEFT/OUTER joins.
+  void ProduceUnmatchedLeft() const;
+
+  // Register NULLs for all the build-side attributes in the given row
+  void RegisterNullLeftAttributes(CodeGen &codegen, RowBatch::Row &row) const;
+
+  // Does this join emit build-side tuples that have no join partner?
+  bool PreservesLeft() const;
+
+  // Does this join emit probe-side tuples that have no join partner?
+  bool PreservesRight() const;
+
+  // Is this a SEMI or ANTI join, i.e., does it only filter the probe side?
+  bool IsSemiOrAntiJoin() const;
+
   // Estimate the size of the constructed hash table
   uint64_t EstimateHashTableSize() const;
 
@@ -97,12 +113,19 @@ class HashJoinTranslator : public OperatorTranslator {
     // Constructor
     ProbeRight(const HashJoinTranslator &join_translator,
                ConsumerContext &context, RowBatch::Row &row,
-               const std::vector<codegen::Value> &right_key);
+               const std::vector<codegen::Value> &right_key,
+               llvm::Value *matched = nullptr);
 
     // Process the given key and associated data area
     void ProcessEntry(CodeGen &codegen, const std::vector<codegen::Value> &key,
                       llvm::Value *data_area) const override;
 
+   private:
+    // Register the values of the entry in the row and handle the match if the
+    // predicate holds
+    void ProcessMatch(CodeGen &codegen, const std::vector<codegen::Value> &key,
+                      llvm::Value *data_area) const;
+
    private:
     // The translator (we need lots of its state)
     const HashJoinTranslator &join_translator_;
@@ -110,6 +133,46 @@ class HashJoinTranslator : public OperatorTranslator {
     ConsumerContext &context_;
     RowBatch::Row &row_;
     const std::vector<codegen::Value> &right_key_;
+    // If not null, a pointer to a flag that is set once the probe row has
+    // found a join partner
+    llvm::Value *matched_;
+  };
+
+  //===--------------------------------------------------------------------===//
+  // The callback used to find the build-side tuples that were never matched
+  // after the probe phase of a LEFT or OUTER join
+  //===--------------------------------------------------------------------===//
+  class ProduceUnmatched : public OAHashTable::IterateCallback {
+   public:
+    // Constructor
+    explicit ProduceUnmatched(const HashJoinTranslator &join_translator);
+
+    // Process the given key and associated data area
+    void ProcessEntry(CodeGen &codegen, const std::vector<codegen::Value> &key,
+                      llvm::Value *data_area) const override;
+
+   private:
+    // The translator
+    const HashJoinTranslator &join_translator_;
+  };
+
+  //===--------------------------------------------------------------------===//
+  // An accessor into a vector of already computed attribute values
+  //===--------------------------------------------------------------------===//
+  class ValueAccess : public RowBatch::AttributeAccess {
+   public:
+    // Constructor
+    ValueAccess(const std::vector<codegen::Value> &vals, uint32_t index)
+        : vals_(vals), index_(index) {}
+
+    Value Access(CodeGen &, RowBatch::Row &) override { return vals_[index_]; }
+
+   private:
+    // All the vals
+    const std::vector<codegen::Value> &vals_;
+
+    // The value this accessor is for
+    uint32_t index_;
   };
 
   //===--------------------------------------------------------------------===//
@@ -120,7 +183,7 @@ class HashJoinTranslator : public OperatorTranslator {
    public:
     // Constructor
     InsertLeft(const CompactStorage &storage,
-               const std::vector<codegen::Value> &values);
+               const std::vector<codegen::Value> &values, bool track_matches);
     // StoreValue the input tuple in the given data space
     void StoreValue(CodeGen &codegen, llvm::Value *data_space) const override;
     llvm::Value *GetValueSize(CodeGen &codegen) const override;
@@ -130,6 +193,8 @@ class HashJoinTranslator : public OperatorTranslator {
     const CompactStorage storage_;
     // The attribute values from the left side
     const std::vector<codegen::Value> &values_;
+    // Whether a match flag follows the values in the data space
+    bool track_matches_;
   };
 
  private:
@@ -164,6 +229,19 @@ class HashJoinTranslator : public OperatorTranslator {
   // The ID of the prefetch vector, if we're prefetching
   RuntimeState::StateID prefetch_vector_id_;
 
+  // The ID of the flag tracking whether the current probe row found a join
+  // partner. Only used by RIGHT, OUTER, SEMI and ANTI joins.
+  RuntimeState::StateID probe_matched_id_;
+
+  // The ID of the selection vector used to send unmatched build-side tuples
+  // up the pipeline. Only used by LEFT and OUTER joins.
+  RuntimeState::StateID output_vector_id_;
+
+  // The IDs of the flags recording whether the build side had any tuples,
+  // and any with a NULL key. Only used by null-aware ANTI joins.
+  RuntimeState::StateID build_has_rows_id_;
+  RuntimeState::StateID build_has_null_key_id_;
+
   // Does this join need an output vector
   bool needs_output_vector_;
 };
@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// limit_translator.h
+//
+// Identification: src/include/codegen/operator/limit_translator.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/compilation_context.h"
+#include "codegen/operator/operator_translator.h"
+#include "codegen/pipeline.h"
+
+namespace peloton {
+
+namespace planner {
+class LimitPlan;
+}  // namespace planner
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// A translator for LIMIT and OFFSET. It counts the rows that pass through and
+// only sends those between the offset and the end of the limit to the parent.
+// A sort below the limit only keeps that many rows to begin with, since the
+// limit is pushed into the OrderBy plan.
+//===----------------------------------------------------------------------===//
+class LimitTranslator : public OperatorTranslator {
+ public:
+  // Constructor
+  LimitTranslator(const planner::LimitPlan &plan, CompilationContext &context,
+                  Pipeline &pipeline);
+
+  // Reset the row count
+  void InitializeState() override;
+
+  // No helper functions
+  void DefineAuxiliaryFunctions() override {}
+
+  // Produce!
+  void Produce() const override;
+
+  // Consume!
+  void Consume(ConsumerContext &context, RowBatch::Row &row) const override;
+
+  // No state to tear down
+  void TearDownState() override {}
+
+  // Get the stringified name of this translator
+  std::string GetName() const override;
+
+ private:
+  // The plan
+  const planner::LimitPlan &plan_;
+
+  // The ID of the number of rows seen so far in the runtime state
+  RuntimeState::StateID row_count_id_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -34,6 +34,9 @@ class OrderByTranslator : public OperatorTranslator {
 
   void DefineAuxiliaryFunctions() override;
 
+  // Define the key prefix function, if the first sort key has one
+  void DefineKeyPrefixFunction();
+
   void Produce() const override;
 
   void Consume(ConsumerContext &context, RowBatch::Row &row) const override;
@@ -98,6 +101,9 @@ class OrderByTranslator : public OperatorTranslator {
   // The comparison function
   llvm::Function *compare_func_;
 
+  // The function computing a prefix of the first sort key, or NULL
+  llvm::Function *key_prefix_func_;
+
   // The ID of the output vector (for vectorized scans) in the runtime state
   RuntimeState::StateID output_vector_id_;
 
@@ -43,12 +43,22 @@ class Pipeline {
 
   bool AtStageBoundary() const;
 
+  // Get the current operator in this pipeline
+  const OperatorTranslator *GetCurrentStep() const {
+    return pipeline_[pipeline_index_];
+  }
+
   // Get the child of the current operator in this pipeline
   const OperatorTranslator *GetChild() const;
 
   // Move to the next step in this pipeline
   const OperatorTranslator *NextStep();
 
+  // Reposition the pipeline at the given translator. Operators that send rows
+  // to their parent from more than one place in the generated code use this
+  // to restart the walk up the pipeline from themselves.
+  void MoveTo(const OperatorTranslator *translator);
+
   uint32_t GetNumStages() const;
   uint32_t GetTranslatorStage(const OperatorTranslator *translator) const;
 
@@ -0,0 +1,34 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// in_list_set_proxy.h
+//
+// Identification: src/include/codegen/proxy/in_list_set_proxy.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/proxy/proxy.h"
+#include "codegen/proxy/type_builder.h"
+#include "function/in_list_set.h"
+
+namespace peloton {
+namespace codegen {
+
+PROXY(InListSet) {
+  /// IN lists are only ever passed through to C++ code
+  DECLARE_MEMBER(0, char[sizeof(function::InListSet)], opaque);
+  DECLARE_TYPE;
+
+  DECLARE_METHOD(ContainsInteger);
+  DECLARE_METHOD(ContainsString);
+};
+
+TYPE_BUILDER(InListSet, function::InListSet);
+
+}  // namespace codegen
+}  // namespace peloton
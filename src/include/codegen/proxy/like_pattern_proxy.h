@@ -0,0 +1,33 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// like_pattern_proxy.h
+//
+// Identification: src/include/codegen/proxy/like_pattern_proxy.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/proxy/proxy.h"
+#include "codegen/proxy/type_builder.h"
+#include "function/like_pattern.h"
+
+namespace peloton {
+namespace codegen {
+
+PROXY(LikePattern) {
+  /// LIKE patterns are only ever passed through to C++ code
+  DECLARE_MEMBER(0, char[sizeof(function::LikePattern)], opaque);
+  DECLARE_TYPE;
+
+  DECLARE_METHOD(MatchString);
+};
+
+TYPE_BUILDER(LikePattern, function::LikePattern);
+
+}  // namespace codegen
+}  // namespace peloton
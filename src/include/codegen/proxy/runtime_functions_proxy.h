@@ -15,6 +15,7 @@
 #include "codegen/proxy/proxy.h"
 #include "codegen/proxy/type_builder.h"
 #include "codegen/runtime_functions.h"
+#include "storage/zone_map.h"
 
 namespace peloton {
 namespace codegen {
@@ -26,15 +27,24 @@ PROXY(ColumnLayoutInfo) {
   DECLARE_TYPE;
 };
 
+PROXY(ZoneMapPredicate) {
+  /// Zone map predicates are only ever passed through to C++ code
+  DECLARE_MEMBER(0, char[sizeof(storage::ZoneMapPredicate)], opaque);
+  DECLARE_TYPE;
+};
+
 PROXY(RuntimeFunctions) {
   DECLARE_METHOD(HashCrc64);
   DECLARE_METHOD(GetTileGroup);
   DECLARE_METHOD(GetTileGroupLayout);
+  DECLARE_METHOD(ShouldScanTileGroup);
+  DECLARE_METHOD(GetOperatorRowCounters);
   DECLARE_METHOD(ThrowDivideByZeroException);
   DECLARE_METHOD(ThrowOverflowException);
 };
 
 TYPE_BUILDER(ColumnLayoutInfo, codegen::RuntimeFunctions::ColumnLayoutInfo);
+TYPE_BUILDER(ZoneMapPredicate, storage::ZoneMapPredicate);
 
 }  // namespace codegen
 }  // namespace peloton
\ No newline at end of file
@@ -25,6 +25,10 @@ PROXY(Sorter) {
   DECLARE_MEMBER(2, char *, buffer_end);
   DECLARE_MEMBER(3, uint32_t, tuple_size);
   DECLARE_MEMBER(4, char *, comp_fn);
+  DECLARE_MEMBER(5, char *, prefix_fn);
+  DECLARE_MEMBER(6, uint64_t, top_k);
+  DECLARE_MEMBER(7, uint64_t, memory_budget);
+  DECLARE_MEMBER(8, char *, spilled_runs);
   DECLARE_TYPE;
 
   // Proxy Init(), StoreInputTuple(), Sort(), and Destroy()
@@ -20,6 +20,8 @@ namespace codegen {
 PROXY(StringFunctions) {
   // Proxy everything in function::StringFunctions
   DECLARE_METHOD(Ascii);
+  DECLARE_METHOD(Like);
+  DECLARE_METHOD(ILike);
 };
 
 }  // namespace codegen
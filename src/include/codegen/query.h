@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "codegen/code_context.h"
 #include "codegen/runtime_state.h"
 
@@ -68,6 +70,20 @@ class Query {
   // The class tracking all the state needed by this query
   RuntimeState &GetRuntimeState() { return runtime_state_; }
 
+  // Register an operator whose output rows the query counts, returning the
+  // index of its row counter
+  uint32_t AddProfiledOperator(const planner::AbstractPlan &op) {
+    profiled_operators_.push_back(&op);
+    return static_cast<uint32_t>(profiled_operators_.size()) - 1;
+  }
+
+  // The operators with a row counter, in the order of their counters. Empty
+  // unless the query was compiled for profiling.
+  const std::vector<const planner::AbstractPlan *> &GetProfiledOperators()
+      const {
+    return profiled_operators_;
+  }
+
  private:
   friend class QueryCompiler;
 
@@ -90,6 +106,9 @@ class Query {
   compiled_function_t plan_func_;
   compiled_function_t tear_down_func_;
 
+  // The operators with a row counter
+  std::vector<const planner::AbstractPlan *> profiled_operators_;
+
  private:
   // This class cannot be copy or move-constructed
   DISALLOW_COPY_AND_MOVE(Query);
@@ -52,10 +52,12 @@ class QueryCompiler {
   // Compile the provided query, returning the compiled plan that can be invoked
   // to return results. Callers can also pass in an (optional) CompileStats
   // object pointer if they want to collect statistics on the compilation
-  // process.
+  // process. If profile_operators is set, the query counts the rows every
+  // operator produces into the query profile of its executor context.
   std::unique_ptr<Query> Compile(const planner::AbstractPlan &query_plan,
                                  QueryResultConsumer &consumer,
-                                 CompileStats *stats = nullptr);
+                                 CompileStats *stats = nullptr,
+                                 bool profile_operators = false);
 
   // Get the next available query plan ID
   uint64_t NextId() { return next_id_++; }
@@ -18,9 +18,14 @@
 
 namespace peloton {
 
+namespace executor {
+class ExecutorContext;
+}  // namespace executor
+
 namespace storage {
 class DataTable;
 class TileGroup;
+struct ZoneMapPredicate;
 }  // namespace storage
 
 namespace codegen {
@@ -56,9 +61,22 @@ class RuntimeFunctions {
     bool is_columnar;
   };
 
-  // Get the column configuration for every column in the tile group
+  // Get the column configuration for every column in the tile group. Frozen
+  // columns are only decoded if their byte in used_columns is set.
   static void GetTileGroupLayout(const storage::TileGroup *tile_group,
-                                 ColumnLayoutInfo *infos, uint32_t num_cols);
+                                 ColumnLayoutInfo *infos, uint32_t num_cols,
+                                 const char *used_columns);
+
+  // Check whether any tuple in the tile group can satisfy the given zone map
+  // predicates, i.e., whether the tile group needs to be scanned at all
+  static bool ShouldScanTileGroup(const storage::TileGroup *tile_group,
+                                  const storage::ZoneMapPredicate *predicates,
+                                  uint32_t num_predicates);
+
+  // Get the row counters of a query compiled for EXPLAIN ANALYZE, one per
+  // operator
+  static uint64_t *GetOperatorRowCounters(
+      executor::ExecutorContext *executor_context, uint32_t num_operators);
 
   static void ThrowDivideByZeroException();
 
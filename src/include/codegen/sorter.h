@@ -95,9 +95,12 @@ class Sorter {
   Sorter();
   Sorter(CodeGen &codegen, const std::vector<type::Type> &row_desc);
 
-  // Initialize the given sorter instance with the comparison function
+  // Initialize the given sorter instance with the comparison function. If
+  // top_k is non-zero, only the first top_k tuples of the sort are retained.
+  // The key prefix function may be NULL.
   void Init(CodeGen &codegen, llvm::Value *sorter_ptr,
-            llvm::Value *comparison_func) const;
+            llvm::Value *comparison_func, uint64_t top_k = 0,
+            llvm::Function *key_prefix_func = nullptr) const;
 
   // Append the given tuple into the sorter instance
   void Append(CodeGen &codegen, llvm::Value *sorter_ptr,
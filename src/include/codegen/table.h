@@ -20,6 +20,7 @@ namespace peloton {
 
 namespace storage {
 class DataTable;
+struct ZoneMapPredicate;
 }  // namespace storage
 
 namespace codegen {
@@ -38,9 +39,15 @@ class Table {
 
   // Generate code to perform a scan over the given table. The table pointer
   // is provided as the second argument. The scan consumer (third argument)
-  // should be notified when ready to generate the scan loop body.
-  void GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
-                    uint32_t batch_size, ScanCallback &consumer) const;
+  // should be notified when ready to generate the scan loop body. Tile groups
+  // whose zone maps rule out the given predicates are skipped entirely. The
+  // predicates must outlive the generated code. Only the columns in
+  // column_ids are decoded from frozen tile groups.
+  void GenerateScan(
+      CodeGen &codegen, llvm::Value *table_ptr, uint32_t batch_size,
+      ScanCallback &consumer,
+      const std::vector<storage::ZoneMapPredicate> &zone_map_predicates,
+      const std::vector<oid_t> &column_ids) const;
 
   // Given a table instance, return the number of tile groups in the table.
   llvm::Value *GetTileGroupCount(CodeGen &codegen,
@@ -51,6 +58,11 @@ class Table {
   llvm::Value *GetTileGroup(CodeGen &codegen, llvm::Value *table_ptr,
                             llvm::Value *tile_group_id) const;
 
+  // Check the zone map of the given tile group against the predicates
+  llvm::Value *ShouldScanTileGroup(
+      CodeGen &codegen, llvm::Value *tile_group_ptr,
+      const std::vector<storage::ZoneMapPredicate> &zone_map_predicates) const;
+
  private:
   // The table associated with this generator
   storage::DataTable &table_;
@@ -37,10 +37,12 @@ class TileGroup {
   // Constructor
   TileGroup(const catalog::Schema &schema);
 
-  // Generate code that performs a sequential scan over the provided tile group
+  // Generate code that performs a sequential scan over the provided tile
+  // group. Only the given columns are read.
   void GenerateTidScan(CodeGen &codegen, llvm::Value *tile_group_ptr,
-                       llvm::Value *column_layouts, uint32_t batch_size,
-                       ScanCallback &consumer) const;
+                       llvm::Value *column_layouts,
+                       const std::vector<oid_t> &column_ids,
+                       uint32_t batch_size, ScanCallback &consumer) const;
 
   llvm::Value *GetNumTuples(CodeGen &codegen, llvm::Value *tile_group) const;
 
@@ -88,7 +90,8 @@ class TileGroup {
 
   std::vector<TileGroup::ColumnLayout> GetColumnLayouts(
       CodeGen &codegen, llvm::Value *tile_group_ptr,
-      llvm::Value *column_layout_infos) const;
+      llvm::Value *column_layout_infos,
+      const std::vector<oid_t> &column_ids) const;
 
   // Access a given column for the row with the given tid
   codegen::Value LoadColumn(CodeGen &codegen, llvm::Value *tid,
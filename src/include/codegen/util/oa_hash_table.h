@@ -15,6 +15,12 @@
 #include <functional>
 
 namespace peloton {
+
+namespace executor {
+class ExecutorContext;
+class QueryMemoryBudget;
+}  // namespace executor
+
 namespace codegen {
 namespace util {
 
@@ -30,6 +36,10 @@ namespace util {
 // key-value pair is stored inside the HashEntry itself to make common case
 // fast; all other values are stored sequentially in an external KeyValueList
 // structure, also in the form of key-value pair.
+//
+// The bucket array and the kv lists take their memory out of the memory budget
+// of the query. The table cannot spill, so it throws OutOfMemoryException when
+// the budget is exhausted.
 //===----------------------------------------------------------------------===//
 class OAHashTable {
  public:
@@ -104,9 +114,11 @@ class OAHashTable {
   // MODIFIERS
   //===--------------------------------------------------------------------===//
 
-  // Perform some initialization
+  // Perform some initialization. Without an executor context the table is not
+  // bounded by a memory budget.
   void Init(uint64_t key_size, uint64_t value_size,
-            uint64_t estimated_num_entries = kDefaultInitialSize);
+            uint64_t estimated_num_entries = kDefaultInitialSize,
+            executor::ExecutorContext *executor_context = nullptr);
 
   // This function inserts a key-value pair into the hash-table. This function
   // isn't used from actual query execution code, but is more for testing.
@@ -196,6 +208,13 @@ class OAHashTable {
   // Does the hash-table need resizing?
   bool NeedsResize() const { return num_valid_buckets_ == resize_threshold_; }
 
+  // Take memory out of the budget of the query before allocating it, throws
+  // OutOfMemoryException if it does not fit
+  void ReserveMemory(uint64_t bytes);
+
+  // Return memory to the budget of the query once it is freed
+  void ReleaseMemory(uint64_t bytes);
+
  private:
   // XXX: Remember, if you alter any of the field below, you'll need to modify
   //      HashTableProxy. Hopefully, you'll get a compile-time error about this.
@@ -231,6 +250,12 @@ class OAHashTable {
 
   // The size of the value itself
   uint64_t value_size_;
+
+  // The memory budget of the query, null if unbounded
+  executor::QueryMemoryBudget *memory_budget_;
+
+  // Memory of the bucket array and the kv lists taken from the budget
+  uint64_t memory_reserved_;
 };
 
 template <typename Key, typename Value>
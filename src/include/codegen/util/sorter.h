@@ -36,23 +36,56 @@ namespace util {
 //    tuples and let clients worry about serializing types into the allocated
 //    space. We would accept a Serializer type as part of the Init(..) function,
 //    but we don't need it at this moment.
+//
+// Sorting comes in three flavours:
+//
+// 1) If only the first K tuples of the sort are needed (e.g., ORDER BY with a
+//    LIMIT), the sorter only ever holds K tuples in a max-heap. Every incoming
+//    tuple is compared against the largest of the K and either replaces it or
+//    is dropped.
+// 2) Large in-memory inputs are split into runs that are sorted in parallel
+//    on the worker pool and then merged. The sorted tuples are permuted into
+//    place within the buffer.
+// 3) If the buffer would grow beyond the sort memory budget, its contents are
+//    sorted and spilled to a temporary file as a run. Sort() merges all runs
+//    into a file-backed mapping that replaces the in-memory buffer, so that
+//    the sorted output is still contiguous.
 //===----------------------------------------------------------------------===//
 class Sorter {
  private:
   // We (arbitrarily) allocate 32KB of buffer space upon initialization
   static constexpr uint64_t kInitialBufferSize = 32 * 1024;
 
+  // Inputs with fewer tuples are sorted on the calling thread
+  static constexpr uint64_t kParallelSortThreshold = 64 * 1024;
+
+  // Largest top-k heap if the sort has no memory budget
+  static constexpr uint64_t kMaxTopKBufferSize = 64 * 1024 * 1024;
+
+  // Runs are read back from disk in blocks of this size during merging
+  static constexpr uint64_t kMergeBlockSize = 256 * 1024;
+
+  // State of an external sort, only allocated once a run is spilled
+  struct SpilledRuns;
+
  public:
   typedef int (*ComparisonFunction)(const char *left_tuple,
                                     const char *right_tuple);
 
+  // Maps a tuple to a prefix of its sort key, such that a smaller prefix
+  // always sorts first. Tuples with equal prefixes are compared in full.
+  typedef uint64_t (*KeyPrefixFunction)(const char *tuple);
+
   // Constructor
   Sorter();
   // Destructor
   ~Sorter();
 
-  // Initialize this sorter with the given comparison function
-  void Init(ComparisonFunction func, uint32_t tuple_size);
+  // Initialize this sorter with the given comparison function. If top_k is
+  // non-zero, only the first top_k tuples in sort order are retained. The key
+  // prefix function is optional.
+  void Init(ComparisonFunction func, uint32_t tuple_size, uint64_t top_k = 0,
+            KeyPrefixFunction prefix_func = nullptr);
 
   // StoreValue an input tuple whose size is _equivalent_ to the size of tuple
   // provided at initialization time.
@@ -104,6 +137,21 @@ class Sorter {
   // Resize the given array to a larger size
   void Resize();
 
+  // Fold the most recently stored tuple into the top-k heap
+  void AddToTopK();
+
+  // Restore the heap property of the top-k heap from the root downwards
+  void SiftDown(uint64_t root, uint64_t num_tuples);
+
+  // Sort the tuples in the buffer in place
+  void SortBuffer();
+
+  // Sort the buffer and write it out to a temporary file as a sorted run
+  void SpillRun();
+
+  // Merge all spilled runs into a file-backed output buffer
+  void MergeSpilledRuns();
+
  private:
   // The contiguous buffer space where tuples are stored.
   //
@@ -122,6 +170,18 @@ class Sorter {
 
   // The comparison function
   ComparisonFunction cmp_func_;
+
+  // The key prefix function, NULL if the sort key has no usable prefix
+  KeyPrefixFunction prefix_func_;
+
+  // The number of tuples to retain, or zero if all tuples are retained
+  uint64_t top_k_;
+
+  // The maximum size the buffer may grow to before a run is spilled
+  uint64_t memory_budget_;
+
+  // Runs spilled to disk, NULL if everything fits in memory
+  SpilledRuns *spilled_runs_;
 };
 
 }  // namespace util
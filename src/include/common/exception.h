@@ -55,7 +55,8 @@ enum ExceptionType {
   EXCEPTION_TYPE_STAT = 20,              // stat related
   EXCEPTION_TYPE_CONNECTION = 21,        // connection related
   EXCEPTION_TYPE_SYNTAX = 22,            // syntax related
-  EXCEPTION_TYPE_SETTINGS = 23      // settings related
+  EXCEPTION_TYPE_SETTINGS = 23,     // settings related
+  EXCEPTION_TYPE_OUT_OF_MEMORY = 24  // out of memory
 };
 
 class Exception : public std::runtime_error {
@@ -124,6 +125,8 @@ class Exception : public std::runtime_error {
         return "Syntax";
       case EXCEPTION_TYPE_SETTINGS:
         return "Settings";
+      case EXCEPTION_TYPE_OUT_OF_MEMORY:
+        return "Out of Memory";
       default:
         return "Unknown";
     }
@@ -439,4 +442,12 @@ class SettingsException : public Exception {
       : Exception(EXCEPTION_TYPE_SETTINGS, msg) {}
 };
 
+class OutOfMemoryException : public Exception {
+  OutOfMemoryException() = delete;
+
+ public:
+  OutOfMemoryException(std::string msg)
+      : Exception(EXCEPTION_TYPE_OUT_OF_MEMORY, msg) {}
+};
+
 }  // namespace peloton
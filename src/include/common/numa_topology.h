@@ -0,0 +1,133 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// numa_topology.h
+//
+// Identification: src/include/common/numa_topology.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace peloton {
+
+//===--------------------------------------------------------------------===//
+// NUMA Topology
+//===--------------------------------------------------------------------===//
+
+/**
+ * The NUMA nodes of the machine and the CPUs that belong to them, read from
+ * sysfs at startup.
+ *
+ * While disabled, which is the default, every call is a no-op: threads float
+ * and memory is placed wherever it is first touched. Once enabled, long-lived
+ * threads pin themselves to a node with PinThreadToNextNode(), and memory
+ * allocated through the BackendManager prefers the node of the allocating
+ * thread, or the node of an enclosing NumaNodeScope. Allocations of at
+ * least a page are mapped separately and bound before they are touched.
+ *
+ * A machine with a single node can simulate several by splitting its CPUs.
+ * Threads are then pinned as on a real machine, but memory placement is left
+ * to the kernel.
+ */
+class NumaTopology {
+ public:
+  // Node of a thread that is not pinned, or of memory without a preference
+  static constexpr int ANY_NODE = -1;
+
+  static NumaTopology &GetInstance();
+
+  // Enable placement. A simulated node count larger than 0 splits the CPUs
+  // into that many nodes instead of using the real topology.
+  void Configure(bool enabled, size_t simulated_node_count = 0);
+
+  bool IsEnabled() const { return enabled_; }
+
+  bool IsSimulated() const { return simulated_; }
+
+  size_t GetNodeCount() const { return node_cpus_.size(); }
+
+  const std::vector<int> &GetNodeCpus(size_t node) const {
+    return node_cpus_[node];
+  }
+
+  // Node the calling thread is pinned to, or the node of the CPU it is
+  // currently running on. ANY_NODE if placement is disabled.
+  int GetCurrentNode() const;
+
+  // Node memory allocated by the calling thread should be placed on
+  int GetAllocationNode() const;
+
+  // Pin the calling thread to the CPUs of the given node
+  bool PinThread(size_t node);
+
+  // Pin the calling thread to the nodes in round robin order. Returns the
+  // node, or ANY_NODE if placement is disabled.
+  int PinThreadToNextNode();
+
+  // Map size bytes of untouched memory whose pages prefer the given node.
+  // Returns nullptr if placement is disabled or simulated, or the mapping
+  // failed.
+  void *AllocateOnNode(size_t size, int node) const;
+
+  // Unmap memory returned by AllocateOnNode()
+  void FreeOnNode(void *address, size_t size) const;
+
+  // Parses a sysfs CPU list such as "0-3,8,10-11"
+  static std::vector<int> ParseCpuList(const std::string &cpu_list);
+
+ private:
+  friend class NumaNodeScope;
+
+  NumaTopology();
+
+  DISALLOW_COPY_AND_MOVE(NumaTopology);
+
+  // Read the real topology, or a single node if it is not available
+  void LoadTopology();
+
+  bool enabled_ = false;
+
+  bool simulated_ = false;
+
+  // CPUs of each node
+  std::vector<std::vector<int>> node_cpus_;
+
+  // Kernel id of each node, the nodes of the machine may not be numbered
+  // contiguously
+  std::vector<int> node_ids_;
+
+  // Node of each CPU
+  std::vector<int> cpu_nodes_;
+
+  // Next node PinThreadToNextNode() pins to
+  std::atomic<size_t> next_node_{0};
+};
+
+//===--------------------------------------------------------------------===//
+// NUMA Node Scope -- Allocations of the calling thread go to a given node
+//===--------------------------------------------------------------------===//
+
+class NumaNodeScope {
+ public:
+  explicit NumaNodeScope(int node);
+
+  ~NumaNodeScope();
+
+ private:
+  DISALLOW_COPY_AND_MOVE(NumaNodeScope);
+
+  int previous_node_;
+};
+
+}  // namespace peloton
@@ -47,6 +47,7 @@ class TupleValueExpression;
 class FunctionExpression;
 class OperatorUnaryMinusExpression;
 class CaseExpression;
+class SubqueryExpression;
 }
 
 //===--------------------------------------------------------------------===//
@@ -87,6 +88,7 @@ class SqlNodeVisitor {
   virtual void Visit(expression::OperatorUnaryMinusExpression *expr);
   virtual void Visit(expression::ParameterValueExpression *expr);
   virtual void Visit(expression::StarExpression *expr);
+  virtual void Visit(expression::SubqueryExpression *expr);
   virtual void Visit(expression::TupleValueExpression *expr);
 
 };
@@ -53,6 +53,11 @@ class Statement : public Printable {
   static void MapToQueryType(const std::string& query_type_string,
                              QueryType& query_type);
 
+  // Check whether the query is an EXPLAIN ANALYZE, and if so, extract the
+  // query to be profiled
+  static bool ParseExplainAnalyze(const std::string& query_string,
+                                  std::string& analyzed_query_string);
+
   std::vector<FieldInfo> GetTupleDescriptor() const;
 
   void SetStatementName(const std::string& statement_name);
@@ -85,6 +90,13 @@ class Statement : public Printable {
 
   inline void SetNeedsPlan(bool replan) { needs_replan_ = replan; }
 
+  // Whether executing the statement returns the profile of its plan
+  inline bool IsExplainAnalyze() const { return explain_analyze_; }
+
+  inline void SetExplainAnalyze(bool explain_analyze) {
+    explain_analyze_ = explain_analyze;
+  }
+
   // Get a string representation for debugging
   const std::string GetInfo() const;
 
@@ -119,6 +131,9 @@ class Statement : public Printable {
   // If this flag is true, then somebody wants us to replan this query
   bool needs_replan_ = false;
 
+  // If this flag is true, the plan is profiled instead of returning its rows
+  bool explain_analyze_ = false;
+
   // containing pairs of <query_type_string, query_type>
   // use map to speed up searching
   static std::unordered_map<std::string, QueryType> query_type_map_;
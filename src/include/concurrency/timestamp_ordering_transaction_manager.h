@@ -123,6 +123,12 @@ private:
   void InitTupleReserved(
       const storage::TileGroupHeader *const tile_group_header,
       const oid_t tuple_id);
+
+  // Let the GC collect the tile group of the version superseded by the
+  // given one if the version has been garbage for a while
+  void HelpGarbageCollection(
+      const storage::TileGroupHeader *const tile_group_header,
+      const oid_t tuple_id);
 };
 }
 }
@@ -0,0 +1,174 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// epoch_reclaimer.h
+//
+// Identification: src/include/container/epoch_reclaimer.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+
+#include "common/macros.h"
+#include "common/platform.h"
+
+namespace peloton {
+
+//===--------------------------------------------------------------------===//
+// Epoch Reclaimer
+//===--------------------------------------------------------------------===//
+
+/**
+ * Epoch-based reclamation of memory that concurrent readers may still see.
+ *
+ * A thread brackets every access to shared objects with Enter()/Exit() or an
+ * EpochGuard. Unlinked objects are handed to Retire() and freed once every
+ * thread that could still hold a reference has left its critical section.
+ *
+ * All state is kept in per-thread slots, so entering and leaving an epoch is
+ * a store to a cache line owned by the calling thread. A thread claims a slot
+ * on first use and releases it when it exits; garbage it has not freed yet is
+ * inherited by the next thread that claims the slot, or freed by
+ * ReclaimAll().
+ */
+class EpochReclaimer {
+ public:
+  // Frees a retired object. The owner is the value passed to Retire().
+  typedef void (*Deleter)(void *object, void *owner);
+
+  // Maximum number of threads that can use the reclaimer at the same time
+  static constexpr size_t THREAD_SLOT_COUNT = 1024;
+
+  // Number of retired objects a thread accumulates before freeing them
+  static constexpr size_t RECLAIM_THRESHOLD = 1024;
+
+  // Epoch a thread publishes while it is outside any critical section
+  static constexpr uint64_t QUIESCENT_EPOCH = UINT64_MAX;
+
+  EpochReclaimer(const EpochReclaimer &) = delete;
+  EpochReclaimer &operator=(const EpochReclaimer &) = delete;
+
+  // Frees everything that is still retired
+  ~EpochReclaimer();
+
+  static EpochReclaimer &GetInstance();
+
+  // Enter and leave a critical section. Calls may be nested.
+  void Enter();
+
+  void Exit();
+
+  // Is the calling thread inside a critical section
+  bool InCriticalSection();
+
+  // Defer deleter(object, owner) until no thread can reference the object.
+  // The object must already be unreachable for threads entering from now on.
+  void Retire(void *object, Deleter deleter, void *owner = nullptr);
+
+  template <typename T>
+  void Retire(T *object) {
+    Retire(object, &DeleteObject<T>);
+  }
+
+  // Advance the epoch and free the garbage of the calling thread that no
+  // thread can reference anymore. Returns the number of objects freed.
+  size_t Reclaim();
+
+  // Same as Reclaim() but for the garbage of every thread
+  size_t ReclaimAll();
+
+  // Free all garbage retired with the given owner right away, regardless of
+  // the epoch. The caller guarantees no thread still accesses it. Returns
+  // once no other thread is running a deleter for the owner either.
+  size_t ReclaimOwner(const void *owner);
+
+  // Number of objects retired but not freed yet
+  size_t GetGarbageCount() const;
+
+  uint64_t GetCurrentEpoch() const {
+    return global_epoch_.load(std::memory_order_acquire);
+  }
+
+ private:
+  struct ThreadSlotHandle;
+
+  struct Garbage {
+    // Epoch in which the object was retired
+    uint64_t epoch;
+    void *object;
+    Deleter deleter;
+    void *owner;
+  };
+
+  struct CACHE_ALIGNED ThreadSlot {
+    // Epoch the owner entered its critical section in, or QUIESCENT_EPOCH
+    std::atomic<uint64_t> active_epoch{QUIESCENT_EPOCH};
+
+    std::atomic<bool> in_use{false};
+
+    // Nesting depth of Enter() calls, only accessed by the owner
+    uint32_t nesting = 0;
+
+    // Protects garbage against concurrent ReclaimAll()/ReclaimOwner()
+    Spinlock garbage_lock;
+
+    // Retired objects ordered by epoch
+    std::deque<Garbage> garbage;
+
+    std::atomic<size_t> garbage_count{0};
+
+    // Number of objects taken off the list whose deleter is still running
+    std::atomic<size_t> collecting_count{0};
+  };
+
+  EpochReclaimer() = default;
+
+  template <typename T>
+  static void DeleteObject(void *object, void *owner UNUSED_ATTRIBUTE) {
+    delete static_cast<T *>(object);
+  }
+
+  ThreadSlot &GetThreadSlot();
+
+  void ReleaseThreadSlot(ThreadSlot &slot);
+
+  // Smallest epoch a thread is active in. Garbage retired before it is safe.
+  uint64_t GetSafeEpoch() const;
+
+  size_t Collect(ThreadSlot &slot, uint64_t safe_epoch);
+
+  std::atomic<uint64_t> global_epoch_{1};
+
+  // Number of slots that have ever been claimed
+  std::atomic<size_t> slot_count_{0};
+
+  ThreadSlot slots_[THREAD_SLOT_COUNT];
+};
+
+//===--------------------------------------------------------------------===//
+// Epoch Guard -- Critical section for the lifetime of the object
+//===--------------------------------------------------------------------===//
+
+class EpochGuard {
+ public:
+  EpochGuard() : reclaimer_(EpochReclaimer::GetInstance()) {
+    reclaimer_.Enter();
+  }
+
+  ~EpochGuard() { reclaimer_.Exit(); }
+
+  EpochGuard(const EpochGuard &) = delete;
+  EpochGuard &operator=(const EpochGuard &) = delete;
+
+ private:
+  EpochReclaimer &reclaimer_;
+};
+
+}  // namespace peloton
@@ -24,6 +24,7 @@ class AbstractPlan;
 
 namespace executor {
 class ExecutorContext;
+struct OperatorProfile;
 }
 
 namespace executor {
@@ -77,6 +78,10 @@ class AbstractExecutor {
   // Used to reset the state. For now it's overloaded by index scan executor
   virtual void ResetState() {}
 
+  // Adds the statistics of this executor and its children to the profile of
+  // the executor context. Only meaningful after a profiled execution.
+  void CollectProfile() const;
+
  protected:
   // NOTE: The reason why we keep the plan node separate from the executor
   // context is because we might want to reuse the plan multiple times
@@ -92,6 +97,13 @@ class AbstractExecutor {
 
   void SetOutput(LogicalTile *val);
 
+  /**
+   * @brief Adds executor specific statistics, e.g. the size of a hash table,
+   *        to the profile of an EXPLAIN ANALYZE.
+   */
+  virtual void AddProfileDetails(OperatorProfile &profile UNUSED_ATTRIBUTE)
+      const {}
+
   /**
    * @brief Convenience method to return plan node corresponding to this
    *        executor, appropriately type-casted.
@@ -116,6 +128,12 @@ class AbstractExecutor {
   /** @brief Plan node corresponding to this executor. */
   const planner::AbstractPlan *node_ = nullptr;
 
+  // Statistics recorded in Execute() when the query is profiled
+  bool profiling_ = false;
+  uint64_t profile_calls_ = 0;
+  uint64_t profile_rows_ = 0;
+  double profile_time_ms_ = 0.0;
+
  protected:
   // Executor context
   ExecutorContext *executor_context_ = nullptr;
@@ -42,6 +42,10 @@ class AbstractJoinExecutor : public AbstractExecutor {
         return "JoinType::INNER";
       case JoinType::OUTER:
         return "JoinType::OUTER";
+      case JoinType::SEMI:
+        return "JoinType::SEMI";
+      case JoinType::ANTI:
+        return "JoinType::ANTI";
       case JoinType::INVALID:
       default:
         return "JoinType::INVALID";
@@ -146,6 +150,8 @@ class AbstractJoinExecutor : public AbstractExecutor {
     switch (join_type_) {
       case JoinType::RIGHT:
       case JoinType::OUTER:
+      case JoinType::SEMI:
+      case JoinType::ANTI:
         no_matching_right_row_sets_[tile_idx].erase(row_idx);
         break;
       default:
@@ -156,6 +162,7 @@ class AbstractJoinExecutor : public AbstractExecutor {
   bool BuildOuterJoinOutput();
   bool BuildLeftJoinOutput();
   bool BuildRightJoinOutput();
+  bool BuildRightSemiJoinOutput();
 
   //===--------------------------------------------------------------------===//
   // Executor State
@@ -53,6 +53,8 @@ class AggregateExecutor : public AbstractExecutor {
 
   bool DExecute();
 
+  void AddProfileDetails(OperatorProfile &profile) const override;
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -68,6 +70,11 @@ class AggregateExecutor : public AbstractExecutor {
 
   /** @brief Output table. */
   storage::AbstractTable *output_table = nullptr;
+
+  /** @brief Statistics of the hash aggregation, for EXPLAIN ANALYZE */
+  size_t peak_memory_used_ = 0;
+  size_t spilled_tuple_count_ = 0;
+  size_t max_spill_depth_ = 0;
 };
 
 }  // namespace executor
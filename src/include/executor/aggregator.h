@@ -12,13 +12,17 @@
 
 #pragma once
 
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 
 #include "common/container_tuple.h"
 #include "executor/abstract_executor.h"
+#include "executor/query_memory_budget.h"
+#include "executor/spill_file.h"
 #include "planner/aggregate_plan.h"
 #include "type/value_factory.h"
+#include "type/value_kernels.h"
 #include "type/value_peeker.h"
 
 //===--------------------------------------------------------------------===//
@@ -33,6 +37,12 @@ class AbstractTable;
 
 namespace executor {
 
+// Number of partitions a hash aggregation spills into at each level
+#define HASH_AGGREGATE_SPILL_PARTITIONS 16
+
+// Levels of re-partitioning before a hash aggregation gives up on its budget
+#define HASH_AGGREGATE_MAX_SPILL_DEPTH 4
+
 /*
  * Base class for an individual aggregate that aggregates a specific
  * column for a group
@@ -72,6 +82,10 @@ class SumAggregator : public AbstractAttributeAggregator {
     if (!have_advanced) {
       aggregate = val.Copy();
       have_advanced = true;
+      add_kernel = type::ValueKernels::GetArithmetic(
+          ExpressionType::OPERATOR_PLUS, val.GetTypeId(), val.GetTypeId());
+    } else if (add_kernel.Matches(aggregate, val)) {
+      aggregate = add_kernel(aggregate, val);
     } else {
       aggregate = aggregate.Add(val);
     }
@@ -87,6 +101,9 @@ class SumAggregator : public AbstractAttributeAggregator {
   type::Value aggregate;
 
   bool have_advanced;
+
+  /** @brief resolved for the type of the column on first advance */
+  type::ArithmeticKernel add_kernel;
 };
 
 class AvgAggregator : public AbstractAttributeAggregator {
@@ -104,18 +121,30 @@ class AvgAggregator : public AbstractAttributeAggregator {
 
     // Weighted average
     if (is_weighted) {
-      type::Value weighted_val = val.Multiply(delta);
+      if (count == 0) {
+        multiply_kernel = type::ValueKernels::GetArithmetic(
+            ExpressionType::OPERATOR_MULTIPLY, val.GetTypeId(),
+            delta.GetTypeId());
+      }
+      type::Value weighted_val = multiply_kernel.Matches(val, delta)
+                                     ? multiply_kernel(val, delta)
+                                     : val.Multiply(delta);
       if (count == 0) {
         aggregate = weighted_val;
+        add_kernel = type::ValueKernels::GetArithmetic(
+            ExpressionType::OPERATOR_PLUS, aggregate.GetTypeId(),
+            aggregate.GetTypeId());
       } else {
-        aggregate = aggregate.Add(weighted_val);
+        Add(weighted_val);
       }
       count += type::ValuePeeker::PeekInteger(delta);
     } else {
       if (count == 0) {
         aggregate = val.Copy();
+        add_kernel = type::ValueKernels::GetArithmetic(
+            ExpressionType::OPERATOR_PLUS, val.GetTypeId(), val.GetTypeId());
       } else {
-        aggregate = aggregate.Add(val);
+        Add(val);
       }
       count += 1;
     }
@@ -130,10 +159,23 @@ class AvgAggregator : public AbstractAttributeAggregator {
     return final_result;
   }
 
+ private:
+  void Add(const type::Value &val) {
+    if (add_kernel.Matches(aggregate, val)) {
+      aggregate = add_kernel(aggregate, val);
+    } else {
+      aggregate = aggregate.Add(val);
+    }
+  }
+
  private:
   /** @brief aggregate initialized on first advance. */
   type::Value aggregate;
 
+  /** @brief resolved for the types of the values on first advance */
+  type::ArithmeticKernel add_kernel;
+  type::ArithmeticKernel multiply_kernel;
+
   /** @brief  default delta for weighted average */
   type::Value default_delta;
 
@@ -186,6 +228,9 @@ class MaxAggregator : public AbstractAttributeAggregator {
     if (!have_advanced) {
       aggregate = val.Copy();
       have_advanced = true;
+      max_kernel = type::ValueKernels::GetMax(val.GetTypeId());
+    } else if (max_kernel.Matches(aggregate, val)) {
+      aggregate = max_kernel(aggregate, val);
     } else {
       aggregate = aggregate.Max(val);
     }
@@ -197,6 +242,9 @@ class MaxAggregator : public AbstractAttributeAggregator {
   type::Value aggregate;
 
   bool have_advanced;
+
+  /** @brief resolved for the type of the column on first advance */
+  type::ArithmeticKernel max_kernel;
 };
 
 class MinAggregator : public AbstractAttributeAggregator {
@@ -213,6 +261,9 @@ class MinAggregator : public AbstractAttributeAggregator {
     if (!have_advanced) {
       aggregate = val.Copy();
       have_advanced = true;
+      min_kernel = type::ValueKernels::GetMin(val.GetTypeId());
+    } else if (min_kernel.Matches(aggregate, val)) {
+      aggregate = min_kernel(aggregate, val);
     } else {
       aggregate = aggregate.Min(val);
     }
@@ -224,6 +275,9 @@ class MinAggregator : public AbstractAttributeAggregator {
   type::Value aggregate;
 
   bool have_advanced;
+
+  /** @brief resolved for the type of the column on first advance */
+  type::ArithmeticKernel min_kernel;
 };
 
 /** brief Create an instance of an aggregator for the specified aggregate */
@@ -263,12 +317,22 @@ class AbstractAggregator {
 /**
  * @brief Used when input is NOT sorted.
  * Will maintain an internal hash table.
+ *
+ * The hash table takes the memory of its groups out of the memory budget of
+ * the query, and stops admitting new groups once the budget is exhausted,
+ * e.g. by other operators of the query. Tuples of groups that are already in
+ * the table keep being aggregated in memory, while tuples of new groups are
+ * hash partitioned into spill files. Finalize() first emits the in-memory
+ * groups and then aggregates every spill file on its own, partitioning it
+ * again with a different hash seed if it does not fit either (hybrid hash
+ * aggregation).
  */
 class HashAggregator : public AbstractAggregator {
  public:
   HashAggregator(const planner::AggregatePlan *node,
                  storage::AbstractTable *output_table,
-                 executor::ExecutorContext *econtext, size_t num_input_columns);
+                 executor::ExecutorContext *econtext,
+                 size_t num_input_columns);
 
   bool Advance(AbstractTuple *next_tuple) override;
 
@@ -276,9 +340,51 @@ class HashAggregator : public AbstractAggregator {
 
   ~HashAggregator();
 
+  /** @brief Number of input tuples that were written to spill files */
+  size_t GetSpilledTupleCount() const { return spilled_tuple_count_; }
+
+  /** @brief Deepest level of re-partitioning that was needed */
+  size_t GetMaxSpillDepth() const { return max_spill_depth_; }
+
+  /** @brief Largest estimated memory the groups in the hash table used */
+  size_t GetPeakMemoryUsed() const { return peak_memory_used_; }
+
  private:
+  /** @brief Emit the results of all in-memory groups and free them */
+  bool FlushGroups();
+
+  /** @brief Free all in-memory groups */
+  void ClearGroups();
+
+  /** @brief Write a tuple of a group that does not fit into a spill file */
+  void SpillTuple(const AbstractTuple *tuple);
+
+  /** @brief Estimated memory footprint of a newly created group */
+  size_t EstimateGroupSize(const AbstractTuple *tuple) const;
+
   const size_t num_input_columns;
 
+  /** @brief Budget of the query, null means unbounded */
+  QueryMemoryBudget *const memory_budget_;
+
+  /** @brief Estimated memory used by the groups in the hash table */
+  size_t memory_used_ = 0;
+
+  size_t peak_memory_used_ = 0;
+
+  /** @brief Partitioning level of the input currently being aggregated */
+  size_t spill_depth_ = 0;
+
+  /** @brief Spill files of the current level, indexed by partition */
+  std::vector<std::unique_ptr<SpillFile>> spill_partitions_;
+
+  /** @brief Values of the tuple being spilled */
+  std::vector<type::Value> spill_values_;
+
+  size_t spilled_tuple_count_ = 0;
+
+  size_t max_spill_depth_ = 0;
+
   /** List of aggregates for a specific group. */
   struct AggregateList {
     // Keep a deep copy of the first tuple we met of this group
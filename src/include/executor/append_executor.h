@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include "type/types.h"
 #include "executor/abstract_executor.h"
 #include "executor/logical_tile.h"
@@ -23,6 +25,13 @@ namespace executor {
  * @brief Append executor.
  * Trivially concatenate input tiles from the children.
  * No check on the schemas of children.
+ *
+ * A parallel append runs its children on the shared worker pool when the
+ * transaction is read only, and hands out their tiles as they are produced.
+ * The executing thread runs children too, so the append makes progress even
+ * when every worker is busy. Other transactions record what they read in
+ * their read set, which is not safe to do from several threads, so they run
+ * the children one after the other.
  */
 class AppendExecutor : public AbstractExecutor {
  public:
@@ -34,12 +43,35 @@ class AppendExecutor : public AbstractExecutor {
   explicit AppendExecutor(const planner::AbstractPlan *node,
                           ExecutorContext *executor_context);
 
+  // Waits for the workers still running children
+  ~AppendExecutor();
+
  protected:
   bool DInit();
   bool DExecute();
 
+ private:
+  struct ParallelState;
+
+  // Run children of a parallel append on a worker until none are left
+  static void RunWorker(void *arg);
+
+  // Next tile of a parallel append, from a worker or a child run here
+  bool ExecuteParallel();
+
+  // Let no worker start another child, and wait for the running ones
+  void StopWorkers();
+
  private:
   size_t cur_child_id_ = 0;
+
+  bool parallel_ = false;
+
+  // Shared with the workers of a parallel append
+  std::shared_ptr<ParallelState> parallel_state_;
+
+  // The child the executing thread runs, or nullptr
+  AbstractExecutor *own_child_ = nullptr;
 };
 }
 }
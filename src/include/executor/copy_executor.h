@@ -17,8 +17,21 @@
 
 #define COPY_BUFFER_SIZE 65536
 #define INVALID_COL_ID -1
+// Target size of the input chunks parsed in parallel by COPY FROM
+#define COPY_IMPORT_CHUNK_SIZE (4 * 1024 * 1024)
 
 namespace peloton {
+
+namespace storage {
+class DataTable;
+class TileGroup;
+class Tuple;
+}
+
+namespace type {
+class EphemeralPool;
+}
+
 namespace executor {
 
 class CopyExecutor : public AbstractExecutor {
@@ -53,6 +66,39 @@ class CopyExecutor : public AbstractExecutor {
   // Copy and escape the content of column to local buffer
   void Copy(const char *data, int len, bool end_of_line);
 
+  //===--------------------------------------------------------------------===//
+  // COPY FROM
+  //===--------------------------------------------------------------------===//
+
+  // A range of the input that holds whole rows, and the rows parsed from it.
+  // The rows that fill whole tile groups are in tile_groups, the rest in
+  // tuples.
+  struct ImportChunk {
+    const char *begin;
+    const char *end;
+    // Line number of the first row, for error messages
+    size_t first_line;
+    std::unique_ptr<type::EphemeralPool> pool;
+    std::vector<std::unique_ptr<storage::Tuple>> tuples;
+    std::vector<std::shared_ptr<storage::TileGroup>> tile_groups;
+    // A row violates a NOT NULL or CHECK constraint
+    bool violates_constraint;
+    std::string error;
+  };
+
+  // Parse the input in parallel and insert the rows into the target table
+  bool ExecuteImport();
+
+  // Split the input into chunks that end on a row boundary
+  std::vector<ImportChunk> SplitImportData(const char *data, size_t size);
+
+  // Parse all the rows of a chunk into tuples, sorted on the primary key,
+  // and copy those that fill whole tile groups into new tile groups
+  void ParseImportChunk(ImportChunk &chunk);
+
+  // Parse the next field of a row, returns false if it is NULL
+  bool ParseImportField(const char *&pos, const char *end, std::string &field);
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -81,6 +127,11 @@ class CopyExecutor : public AbstractExecutor {
   // Total number of bytes written
   size_t total_bytes_written = 0;
 
+  // COPY FROM: the table to insert into and its primary key columns
+  storage::DataTable *import_table_ = nullptr;
+  std::vector<oid_t> import_key_attrs_;
+  bool import_csv_format_ = true;
+
   // The special column ids in query_metric table
   unsigned int num_param_col_id =
       catalog::QueryMetricsCatalog::ColumnId::NUM_PARAMS;
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include "executor/query_memory_budget.h"
 #include "type/ephemeral_pool.h"
 #include "type/value.h"
 
@@ -25,6 +26,8 @@ class Transaction;
 
 namespace executor {
 
+class QueryProfile;
+
 //===--------------------------------------------------------------------===//
 // Executor Context
 //===--------------------------------------------------------------------===//
@@ -54,6 +57,14 @@ class ExecutorContext {
   // Get a pool
   type::EphemeralPool *GetPool();
 
+  // Profile to record operator statistics into, if the query is profiled
+  QueryProfile *GetProfile() const { return profile_; }
+
+  void SetProfile(QueryProfile *profile) { profile_ = profile; }
+
+  // Memory the hash tables of the query share, see query_memory_budget
+  QueryMemoryBudget &GetMemoryBudget() { return memory_budget_; }
+
   // num of tuple processed
   uint32_t num_processed = 0;
 
@@ -71,6 +82,11 @@ class ExecutorContext {
   // pool
   std::unique_ptr<type::EphemeralPool> pool_;
 
+  // profile of an EXPLAIN ANALYZE, not owned
+  QueryProfile *profile_ = nullptr;
+
+  QueryMemoryBudget memory_budget_;
+
 };
 
 }  // namespace executor
@@ -30,6 +30,7 @@
 #include "executor/insert_executor.h"
 #include "executor/limit_executor.h"
 #include "executor/materialization_executor.h"
+#include "executor/materialized_view_scan_executor.h"
 #include "executor/merge_join_executor.h"
 #include "executor/nested_loop_join_executor.h"
 #include "executor/order_by_executor.h"
@@ -12,11 +12,14 @@
 
 #pragma once
 
+#include <memory>
 #include <unordered_map>
 
 #include "type/types.h"
 #include "executor/abstract_executor.h"
 #include "executor/logical_tile.h"
+#include "executor/query_memory_budget.h"
+#include "executor/spill_file.h"
 #include "common/container_tuple.h"
 
 #include <boost/functional/hash.hpp>
@@ -24,9 +27,21 @@
 namespace peloton {
 namespace executor {
 
+// Number of partitions a hash join spills its inputs into at each level
+#define HASH_JOIN_SPILL_PARTITIONS 16
+
+// Levels of re-partitioning before a hash join gives up on its budget
+#define HASH_JOIN_MAX_SPILL_DEPTH 4
+
 /**
  * @brief Hash executor.
  *
+ * Builds the hash table of a hash join. The table and the buffered input
+ * take their memory out of the memory budget of the query. If the budget is
+ * exhausted, the executor gives the table up: every row is written to one of
+ * HASH_JOIN_SPILL_PARTITIONS spill files by the hash of its key, and so is
+ * the rest of the input. The hash join then partitions its probe side the
+ * same way and joins the partitions pair by pair.
  */
 class HashExecutor : public AbstractExecutor {
  public:
@@ -38,6 +53,8 @@ class HashExecutor : public AbstractExecutor {
   explicit HashExecutor(const planner::AbstractPlan *node,
                         ExecutorContext *executor_context);
 
+  ~HashExecutor();
+
   /** @brief Type definitions for hash table */
   typedef std::unordered_map<
       ContainerTuple<LogicalTile>,
@@ -52,12 +69,44 @@ class HashExecutor : public AbstractExecutor {
     return this->column_ids_;
   }
 
+  /** @brief Budget of the query, null means unbounded */
+  QueryMemoryBudget *GetMemoryBudget() const { return memory_budget_; }
+
+  /** @brief Whether the hash table exceeded the budget and was spilled */
+  bool IsSpilled() const { return spilled_; }
+
+  /**
+   * @brief The spill files of the input, indexed by partition. A row holds
+   * every column of the child's output. Partitions without rows are null.
+   */
+  std::vector<std::unique_ptr<SpillFile>> &GetSpillPartitions() {
+    return spill_partitions_;
+  }
+
+  /** @brief The partition of a join key at a level of partitioning */
+  static size_t GetSpillPartition(const std::vector<type::Value> &key_values,
+                                  size_t depth);
+
  protected:
   bool DInit();
 
   bool DExecute();
 
+  void AddProfileDetails(OperatorProfile &profile) const override;
+
  private:
+  /**
+   * @brief Add the rows of a buffered child tile to the hash table, returns
+   * the estimated memory they take
+   */
+  size_t HashTile(size_t child_tile_itr);
+
+  /** @brief Move the hash table and all buffered rows to spill files */
+  void SpillHashTable();
+
+  /** @brief Write a row of a child tile to its spill file */
+  void SpillRow(LogicalTile *tile, oid_t tuple_id);
+
   /** @brief Hash table */
   HashMapType hash_table_;
 
@@ -69,6 +118,25 @@ class HashExecutor : public AbstractExecutor {
   bool done_ = false;
 
   size_t result_itr = 0;
+
+  QueryMemoryBudget *const memory_budget_;
+
+  /**
+   * @brief Estimated memory used by the hash table and the buffered rows, as
+   * reserved from the budget
+   */
+  size_t memory_used_ = 0;
+
+  bool spilled_ = false;
+
+  /** @brief Spill files of the input, indexed by partition */
+  std::vector<std::unique_ptr<SpillFile>> spill_partitions_;
+
+  /** @brief Values and key of the row being spilled */
+  std::vector<type::Value> spill_values_;
+  std::vector<type::Value> spill_key_values_;
+
+  size_t spilled_row_count_ = 0;
 };
 
 }  // namespace executor
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "executor/abstract_join_executor.h"
@@ -21,6 +23,16 @@
 namespace peloton {
 namespace executor {
 
+/**
+ * If the build side does not fit into its memory budget, the hash executor
+ * spills it into partitions, and the join partitions the probe side the same
+ * way. Each pair of partitions is then joined on its own, from values read
+ * back from the spill files, and the results are returned as materialized
+ * tiles. A build partition that does not fit either is split again together
+ * with its probe partition, up to HASH_JOIN_MAX_SPILL_DEPTH levels deep.
+ * Past that depth the join exceeds the budget rather than fail. The budget is
+ * the memory budget of the query, shared with its other operators.
+ */
 class HashJoinExecutor : public AbstractJoinExecutor {
   HashJoinExecutor(const HashJoinExecutor &) = delete;
   HashJoinExecutor &operator=(const HashJoinExecutor &) = delete;
@@ -29,22 +41,143 @@ class HashJoinExecutor : public AbstractJoinExecutor {
   explicit HashJoinExecutor(const planner::AbstractPlan *node,
                             ExecutorContext *executor_context);
 
+  ~HashJoinExecutor() { ReleasePartitionMemory(); }
+
  protected:
   bool DInit();
 
   bool DExecute();
 
+  void AddProfileDetails(OperatorProfile &profile) const override;
+
  private:
+  /** @brief Record the right rows a tile of left rows matches */
+  void ProbeSemiJoin(LogicalTile *left_tile);
+
+  /**
+   * @brief Whether a right row of a null-aware anti join is filtered out by
+   * NULLs rather than by a match
+   */
+  bool IsNullAwareMatch(bool build_key_is_null) const;
+
+  /** @brief Drop the unmatched right rows NULLs filter out */
+  void ApplyNullAwareness();
+
+  //===--------------------------------------------------------------------===//
+  // Spilled Join
+  //===--------------------------------------------------------------------===//
+
+  /** @brief A build partition and the probe partition it joins with */
+  struct SpilledPartition {
+    size_t depth = 0;
+    std::unique_ptr<SpillFile> build;
+    std::unique_ptr<SpillFile> probe;
+  };
+
+  struct ValueVectorHasher {
+    size_t operator()(const std::vector<type::Value> &values) const {
+      size_t seed = 0;
+      for (auto &value : values) {
+        value.HashCombine(seed);
+      }
+      return seed;
+    }
+  };
+
+  struct ValueVectorCmp {
+    bool operator()(const std::vector<type::Value> &lhs,
+                    const std::vector<type::Value> &rhs) const {
+      for (size_t i = 0; i < lhs.size(); i++) {
+        if (lhs[i].CompareEquals(rhs[i]) != type::CMP_TRUE) return false;
+      }
+      return true;
+    }
+  };
+
+  /** @brief Join the spilled partitions, returns a tile at a time */
+  bool ExecuteSpilled();
+
+  /** @brief Write the probe side into partitions like the build side */
+  void PartitionProbeSide();
+
+  /** @brief Whether joining a pair of partitions can produce any rows */
+  bool HasSpilledOutput(const SpilledPartition &partition) const;
+
+  /** @brief Load the next build partition, or split it if it is too big */
+  void LoadSpilledPartition();
+
+  /** @brief Return the memory of the loaded build partition to the budget */
+  void ReleasePartitionMemory();
+
+  /** @brief Join a row of the probe side with the loaded build partition */
+  void ProbeSpilledRow(std::vector<type::Value> &left_values);
+
+  /** @brief Add a joined row, a null side is padded with nulls */
+  void AddSpilledOutputRow(const std::vector<type::Value> *left_values,
+                           const std::vector<type::Value> *right_values);
+
+  /** @brief Turn the buffered joined rows into an output tile */
+  void FlushSpilledOutput();
+
+  /** @brief Key of a spilled row, returns false if a key value is null */
+  static bool GetSpilledKey(const std::vector<type::Value> &values,
+                            const std::vector<oid_t> &key_ids,
+                            std::vector<type::Value> &key_values);
+
   HashExecutor *hash_executor_ = nullptr;
 
+  /** @brief Columns of the left child's output that form the join key */
+  std::vector<oid_t> left_hashed_col_ids_;
+
   bool hashed_ = false;
 
+  /** @brief NOT IN semantics for an anti join, see HashJoinPlan */
+  bool null_aware_ = false;
+  bool null_aware_done_ = false;
+
+  /** @brief Whether the left side had any rows, and any with a NULL key */
+  bool probe_has_rows_ = false;
+  bool probe_has_null_key_ = false;
+
   std::deque<LogicalTile *> buffered_output_tiles;
   std::vector<std::unique_ptr<LogicalTile>> right_tiles_;
 
   // logical tile iterators
   size_t left_logical_tile_itr_ = 0;
   size_t right_logical_tile_itr_ = 0;
+
+  // Number of left tuples looked up in the hash table, and how many of them
+  // found a match
+  uint64_t probe_count_ = 0;
+  uint64_t probe_match_count_ = 0;
+
+  bool probe_side_partitioned_ = false;
+
+  /** @brief Partitions waiting to be joined, the last one is next */
+  std::vector<SpilledPartition> pending_partitions_;
+
+  /** @brief Probe partition being read, null if none is loaded */
+  std::unique_ptr<SpillFile> probe_partition_;
+
+  bool partition_loaded_ = false;
+
+  /** @brief Rows of the loaded build partition and their keys */
+  std::vector<std::vector<type::Value>> build_rows_;
+  std::vector<bool> build_row_matched_;
+  std::unordered_map<std::vector<type::Value>, std::vector<size_t>,
+                     ValueVectorHasher, ValueVectorCmp> build_table_;
+
+  /** @brief Joined rows not yet returned in a tile */
+  std::vector<std::vector<type::Value>> spilled_output_rows_;
+
+  std::vector<type::Value> spill_values_;
+  std::vector<type::Value> spill_key_values_;
+
+  size_t spilled_probe_row_count_ = 0;
+  size_t max_spill_depth_ = 0;
+
+  /** @brief Memory of the loaded build partition taken from the budget */
+  size_t partition_memory_ = 0;
 };
 
 }  // namespace executor
@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// materialized_view_scan_executor.h
+//
+// Identification: src/include/executor/materialized_view_scan_executor.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "executor/abstract_executor.h"
+
+namespace peloton {
+
+namespace storage {
+class AbstractTable;
+}
+
+namespace executor {
+
+/**
+ * @brief Materialized view scan executor.
+ * Outputs the rows of the groups of a materialized view selected by the
+ * plan, in tiles of a temporary table like the aggregate executor does.
+ *
+ * A plan may run in another transaction than it was made for. If the view
+ * cannot serve this one, the rows are aggregated from the table instead.
+ * If the view was dropped, the plan is rejected and must be made again.
+ */
+class MaterializedViewScanExecutor : public AbstractExecutor {
+ public:
+  MaterializedViewScanExecutor(const MaterializedViewScanExecutor &) = delete;
+  MaterializedViewScanExecutor &operator=(
+      const MaterializedViewScanExecutor &) = delete;
+  MaterializedViewScanExecutor(MaterializedViewScanExecutor &&) = delete;
+  MaterializedViewScanExecutor &operator=(MaterializedViewScanExecutor &&) =
+      delete;
+
+  MaterializedViewScanExecutor(const planner::AbstractPlan *node,
+                               ExecutorContext *executor_context);
+
+ protected:
+  bool DInit();
+
+  bool DExecute();
+
+ private:
+  /** @brief Tiles of the rows read from the view */
+  std::vector<LogicalTile *> result_;
+
+  /** @brief Next tile to output */
+  oid_t result_itr_ = 0;
+
+  /** @brief Read the view */
+  bool done_ = false;
+
+  /** @brief Whether to read the view, or to aggregate the table */
+  bool use_view_ = false;
+
+  /** @brief Output table */
+  std::unique_ptr<storage::AbstractTable> output_table_;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -70,13 +70,16 @@ class PlanExecutor {
    * for network
    * Before ExecutePlan, a node first receives value list, so we should
    * pass value list directly rather than passing Postgres's ParamListInfo
+   * If explain_analyze is set, the result is the per-operator profile of the
+   * execution, one text row per line, instead of the rows of the plan
    */
   static void ExecutePlan(std::shared_ptr<planner::AbstractPlan> plan,
                                    concurrency::Transaction* txn,
                                    const std::vector<type::Value> &params,
                                    std::vector<StatementResult> &result,
                                    const std::vector<int> &result_format,
-                                   executor::ExecuteResult &p_status);
+                                   executor::ExecuteResult &p_status,
+                                   bool explain_analyze = false);
 
   /*
    * @brief When a peloton node recvs a query plan, this function is invoked
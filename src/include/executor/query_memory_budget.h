@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// query_memory_budget.h
+//
+// Identification: src/include/executor/query_memory_budget.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace peloton {
+namespace executor {
+
+//===--------------------------------------------------------------------===//
+// Query Memory Budget
+//===--------------------------------------------------------------------===//
+
+/**
+ * The memory the hash aggregations and hash joins of a query may hold
+ * together, in bytes.
+ *
+ * Operators take memory out of the budget as their tables grow and return it
+ * once they free them. An interpreted operator that cannot get its memory
+ * spills to disk. A compiled hash table cannot spill and throws
+ * OutOfMemoryException instead, upon which the plan executor runs a
+ * read-only plan again with the interpreted operators. Operators of a query
+ * may run on several threads at once, so all of it is thread-safe.
+ */
+class QueryMemoryBudget {
+ public:
+  explicit QueryMemoryBudget(size_t limit) : limit_(limit), used_(0) {}
+
+  // Take memory out of the budget, unless it does not fit. An unlimited
+  // budget always has room.
+  bool Reserve(size_t bytes) {
+    size_t used = used_.load(std::memory_order_relaxed);
+    do {
+      if (limit_ != 0 && used + bytes > limit_) return false;
+    } while (used_.compare_exchange_weak(used, used + bytes,
+                                         std::memory_order_relaxed) == false);
+    return true;
+  }
+
+  // Take memory out of the budget whether it fits or not, for an operator
+  // that cannot make progress otherwise
+  void Charge(size_t bytes) {
+    used_.fetch_add(bytes, std::memory_order_relaxed);
+  }
+
+  void Release(size_t bytes) {
+    used_.fetch_sub(bytes, std::memory_order_relaxed);
+  }
+
+  size_t GetUsed() const { return used_.load(std::memory_order_relaxed); }
+
+  // 0 means unlimited
+  size_t GetLimit() const { return limit_; }
+
+  void SetLimit(size_t limit) { limit_ = limit; }
+
+ private:
+  size_t limit_;
+
+  std::atomic<size_t> used_;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// query_profile.h
+//
+// Identification: src/include/executor/query_profile.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace peloton {
+
+namespace planner {
+class AbstractPlan;
+}
+
+namespace executor {
+
+//===--------------------------------------------------------------------===//
+// Operator Profile
+//===--------------------------------------------------------------------===//
+
+/**
+ * Runtime statistics of one operator of a query, as shown by EXPLAIN ANALYZE.
+ */
+struct OperatorProfile {
+  // Number of times the operator was asked for output. Compiled queries do
+  // not call their operators, so this stays 0 for them.
+  uint64_t calls = 0;
+
+  // Number of tuples the operator produced
+  uint64_t rows = 0;
+
+  // Time spent in the operator, including its children
+  double time_ms = 0.0;
+
+  // Operator specific statistics, e.g. the size of a hash table
+  std::vector<std::string> details;
+};
+
+//===--------------------------------------------------------------------===//
+// Query Profile
+//===--------------------------------------------------------------------===//
+
+/**
+ * Collects the per-operator statistics of one execution of a query plan.
+ *
+ * The interpreted executors fill in their OperatorProfile themselves. A
+ * compiled query instead bumps one row counter per operator from generated
+ * code, the counters are handed out by GetRowCounters().
+ */
+class QueryProfile {
+ public:
+  QueryProfile() {}
+
+  OperatorProfile &GetOperatorProfile(const planner::AbstractPlan *plan) {
+    return operator_profiles_[plan];
+  }
+
+  // Returns zeroed space for one row counter per given operator
+  uint64_t *GetRowCounters(uint32_t operator_count);
+
+  // Copies the row counters into the profiles of the given operators, which
+  // must be in the order their counters were assigned in
+  void CollectRowCounters(
+      const std::vector<const planner::AbstractPlan *> &operators);
+
+  // Adds a line shown after the operator tree, e.g. compilation time
+  void AddSummary(const std::string &summary) {
+    summaries_.push_back(summary);
+  }
+
+  // Renders the profile of the given plan, one line per operator detail
+  std::vector<std::string> GetInfo(const planner::AbstractPlan *root) const;
+
+ private:
+  DISALLOW_COPY_AND_MOVE(QueryProfile);
+
+  void GetInfo(const planner::AbstractPlan *plan, size_t depth,
+               std::vector<std::string> &lines) const;
+
+ private:
+  std::unordered_map<const planner::AbstractPlan *, OperatorProfile>
+      operator_profiles_;
+
+  // Row counters of a compiled query
+  std::vector<uint64_t> row_counters_;
+
+  std::vector<std::string> summaries_;
+};
+
+}  // namespace executor
+}  // namespace peloton
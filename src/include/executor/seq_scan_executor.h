@@ -14,8 +14,14 @@
 
 #include "planner/seq_scan_plan.h"
 #include "executor/abstract_scan_executor.h"
+#include "storage/zone_map.h"
 
 namespace peloton {
+
+namespace expression {
+class ComparisonExpression;
+}
+
 namespace executor {
 
 class SeqScanExecutor : public AbstractScanExecutor {
@@ -50,6 +56,13 @@ class SeqScanExecutor : public AbstractScanExecutor {
   expression::AbstractExpression *ColumnValueToCmpExpr(
       const oid_t column_id, const type::Value &value);
 
+  void ExtractZoneMapPredicates();
+
+  void SplitPredicate();
+
+  void FilterTuples(storage::TileGroup *tile_group,
+                    std::vector<oid_t> &tuple_ids);
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -76,6 +89,18 @@ class SeqScanExecutor : public AbstractScanExecutor {
   // The original predicate, if it's not nullptr
   // we need to combine it with the undated predicate 
   const expression::AbstractExpression *old_predicate_;
+
+  /** @brief Conjuncts of the predicate used to skip tile groups. */
+  std::vector<storage::ZoneMapPredicate> zone_map_predicates_;
+
+  /**
+   * @brief Conjuncts of the predicate filtered a tile group at a time, LIKE
+   * against constant patterns and IN over constant integer lists.
+   */
+  std::vector<const expression::ComparisonExpression *> batch_predicates_;
+
+  /** @brief The other conjuncts, evaluated tuple by tuple. */
+  std::vector<const expression::AbstractExpression *> row_predicates_;
 };
 
 }  // namespace executor
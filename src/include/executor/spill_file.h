@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// spill_file.h
+//
+// Identification: src/include/executor/spill_file.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdio>
+#include <vector>
+
+#include "common/macros.h"
+#include "type/serializeio.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace executor {
+
+//===--------------------------------------------------------------------===//
+// Spill File
+//===--------------------------------------------------------------------===//
+
+/**
+ * An anonymous temporary file that rows of values can be appended to and read
+ * back from in order. Operators that exceed their memory budget use it to
+ * move partitions of their input out of memory.
+ *
+ * Every row is written as its length followed by the type and serialized form
+ * of each value, so rows with differing types can share a file. The file is
+ * removed by the OS once it is closed.
+ */
+class SpillFile {
+ public:
+  // Throws ExecutorException if the temporary file cannot be created
+  SpillFile();
+
+  ~SpillFile();
+
+  // Append a row. Must not be called after Rewind().
+  void Append(const std::vector<type::Value> &values);
+
+  // Flush buffered rows and position the file at the first row
+  void Rewind();
+
+  // Read the next row into values. Returns false once all rows have been
+  // read. The returned values own their data.
+  bool Next(std::vector<type::Value> &values);
+
+  size_t GetRowCount() const { return row_count_; }
+
+  size_t GetByteCount() const { return byte_count_; }
+
+ private:
+  DISALLOW_COPY_AND_MOVE(SpillFile);
+
+  void FlushWriteBuffer();
+
+ private:
+  FILE *file_ = nullptr;
+
+  // Rows are staged here and written out in large chunks
+  CopySerializeOutput write_buffer_;
+
+  // Holds the row being read
+  std::vector<char> read_buffer_;
+
+  size_t row_count_ = 0;
+
+  size_t byte_count_ = 0;
+};
+
+}  // namespace executor
+}  // namespace peloton
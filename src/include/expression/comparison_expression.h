@@ -12,9 +12,17 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "common/sql_node_visitor.h"
 #include "expression/abstract_expression.h"
+#include "expression/constant_value_expression.h"
+#include "function/in_list_set.h"
+#include "function/like_pattern.h"
 #include "type/value_factory.h"
+#include "type/value_kernels.h"
 
 namespace peloton {
 namespace expression {
@@ -33,15 +41,34 @@ class ComparisonExpression : public AbstractExpression {
 
   ComparisonExpression(ExpressionType type, AbstractExpression *left,
                        AbstractExpression *right)
-      : AbstractExpression(type, type::TypeId::BOOLEAN, left, right) {}
+      : AbstractExpression(type, type::TypeId::BOOLEAN, left, right) {
+    Compile();
+  }
+
+  // left IN (list), the list becomes the children after the left one
+  ComparisonExpression(ExpressionType type, AbstractExpression *left,
+                       const std::vector<AbstractExpression *> &list)
+      : AbstractExpression(type, type::TypeId::BOOLEAN) {
+    SetChild(0, left);
+    for (size_t i = 0; i < list.size(); i++) {
+      SetChild(i + 1, list[i]);
+    }
+    Compile();
+  }
 
   type::Value Evaluate(
       const AbstractTuple *tuple1,
       const AbstractTuple *tuple2,
       executor::ExecutorContext *context) const override {
+    if (exp_type_ == ExpressionType::COMPARE_IN) {
+      return EvaluateIn(tuple1, tuple2, context);
+    }
     PL_ASSERT(children_.size() == 2);
     auto vl = children_[0]->Evaluate(tuple1, tuple2, context);
     auto vr = children_[1]->Evaluate(tuple1, tuple2, context);
+    if (compare_kernel_.Matches(vl, vr)) {
+      return type::ValueFactory::GetBooleanValue(compare_kernel_(vl, vr));
+    }
     switch (exp_type_) {
       case (ExpressionType::COMPARE_EQUAL):
         return type::ValueFactory::GetBooleanValue(vl.CompareEquals(vr));
@@ -66,6 +93,16 @@ class ComparisonExpression : public AbstractExpression {
         }
         return type::ValueFactory::GetBooleanValue(true);
       }
+      case (ExpressionType::COMPARE_LIKE):
+      case (ExpressionType::COMPARE_NOTLIKE):
+      case (ExpressionType::COMPARE_ILIKE): {
+        if (vl.IsNull() || vr.IsNull()) {
+          return type::ValueFactory::GetNullValueByType(type::TypeId::BOOLEAN);
+        }
+        bool match = EvaluateLike(vl, vr);
+        return type::ValueFactory::GetBooleanValue(
+            exp_type_ == ExpressionType::COMPARE_NOTLIKE ? !match : match);
+      }
       default:
         throw Exception("Invalid comparison expression type.");
     }
@@ -75,11 +112,254 @@ class ComparisonExpression : public AbstractExpression {
     return new ComparisonExpression(*this);
   }
 
+  void DeduceExpressionType() override { Compile(); }
+
   virtual void Accept(SqlNodeVisitor *v) override { v->Visit(this); }
 
+  // The compiled LIKE pattern or IN list, if the pattern or the list are
+  // constants
+  const function::LikePattern *GetLikePattern() const {
+    return IsCompiled() ? like_pattern_.get() : nullptr;
+  }
+  const function::InListSet *GetInListSet() const {
+    return IsCompiled() ? in_list_set_.get() : nullptr;
+  }
+
+  // Whether FilterBatch can evaluate the comparison: a LIKE against a
+  // constant pattern, or an integer IN a list of integer constants
+  bool IsBatchFilter() const {
+    if (IsCompiled() == false) {
+      return false;
+    }
+    if (exp_type_ != ExpressionType::COMPARE_IN) {
+      return true;
+    }
+    return in_list_set_->IsAllIntegers() &&
+           IsInteger(GetChild(0)->GetValueType());
+  }
+
+  // Filter a batch of tuples through the compiled pattern or list, which
+  // looks at the whole batch at once rather than one value at a time. The
+  // positions of the tuples the comparison is true for are written to sel,
+  // in order, and their number is returned.
+  uint32_t FilterBatch(const AbstractTuple *const *tuples, uint32_t count,
+                       uint32_t *sel,
+                       executor::ExecutorContext *context) const {
+    PL_ASSERT(IsBatchFilter());
+
+    // A NULL on the left is never true
+    std::vector<type::Value> values;
+    std::vector<uint32_t> rows;
+    values.reserve(count);
+    rows.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+      auto value = children_[0]->Evaluate(tuples[i], nullptr, context);
+      if (value.IsNull() == false) {
+        values.push_back(std::move(value));
+        rows.push_back(i);
+      }
+    }
+    uint32_t row_count = rows.size();
+    std::vector<uint32_t> matches(row_count);
+    uint32_t match_count;
+
+    if (exp_type_ == ExpressionType::COMPARE_IN) {
+      std::vector<int64_t> integers(row_count);
+      bool all_integers = true;
+      for (uint32_t i = 0; i < row_count && all_integers; i++) {
+        all_integers = IsInteger(values[i].GetTypeId());
+        integers[i] = all_integers ? GetInteger(values[i]) : 0;
+      }
+      if (all_integers) {
+        match_count = in_list_set_->FindBatch(integers.data(), row_count,
+                                              matches.data());
+      } else {
+        // Values of another type than the one the child declares
+        match_count = 0;
+        for (uint32_t i = 0; i < row_count; i++) {
+          if (in_list_set_->Find(values[i]) == type::CMP_TRUE) {
+            matches[match_count++] = i;
+          }
+        }
+      }
+    } else {
+      // Match the bytes of varchars in place, other types by their text
+      std::vector<std::string> texts;
+      std::vector<const char *> strs(row_count);
+      std::vector<uint32_t> lengths(row_count);
+      texts.reserve(row_count);
+      for (uint32_t i = 0; i < row_count; i++) {
+        if (values[i].GetTypeId() == type::TypeId::VARCHAR) {
+          strs[i] = values[i].GetAs<const char *>();
+          lengths[i] =
+              values[i].GetLength() > 0 ? values[i].GetLength() - 1 : 0;
+        } else {
+          texts.push_back(values[i].ToString());
+          strs[i] = texts.back().data();
+          lengths[i] = texts.back().size();
+        }
+      }
+      match_count = like_pattern_->MatchBatch(strs.data(), lengths.data(),
+                                              row_count, matches.data());
+    }
+
+    // NOT LIKE keeps the non-NULL values that did not match
+    uint32_t selected = 0;
+    if (exp_type_ == ExpressionType::COMPARE_NOTLIKE) {
+      uint32_t match_itr = 0;
+      for (uint32_t i = 0; i < row_count; i++) {
+        if (match_itr < match_count && matches[match_itr] == i) {
+          match_itr++;
+        } else {
+          sel[selected++] = rows[i];
+        }
+      }
+      return selected;
+    }
+    for (uint32_t i = 0; i < match_count; i++) {
+      sel[selected++] = rows[matches[i]];
+    }
+    return selected;
+  }
+
  protected:
   ComparisonExpression(const ComparisonExpression &other)
-      : AbstractExpression(other) {}
+      : AbstractExpression(other),
+        like_pattern_(other.like_pattern_),
+        in_list_set_(other.in_list_set_),
+        compare_kernel_(other.compare_kernel_) {
+    if (other.IsCompiled()) {
+      compiled_child_ = GetChild(1);
+    }
+  }
+
+ private:
+  // The compiled state is for the children it was built from, a replaced
+  // child falls back to evaluating the values
+  bool IsCompiled() const {
+    return compiled_child_ != nullptr && compiled_child_ == GetChild(1);
+  }
+
+  void Compile() {
+    compiled_child_ = nullptr;
+    like_pattern_.reset();
+    in_list_set_.reset();
+    if (children_.size() < 2) {
+      return;
+    }
+    compare_kernel_ = type::ValueKernels::GetCompare(
+        exp_type_, GetChild(0)->GetValueType(), GetChild(1)->GetValueType());
+
+    switch (exp_type_) {
+      case ExpressionType::COMPARE_LIKE:
+      case ExpressionType::COMPARE_NOTLIKE:
+      case ExpressionType::COMPARE_ILIKE: {
+        if (GetChild(1)->GetExpressionType() !=
+            ExpressionType::VALUE_CONSTANT) {
+          return;
+        }
+        auto pattern =
+            static_cast<const ConstantValueExpression *>(GetChild(1))
+                ->GetValue();
+        if (pattern.IsNull() || pattern.GetTypeId() != type::TypeId::VARCHAR) {
+          return;
+        }
+        like_pattern_ = std::make_shared<function::LikePattern>(
+            pattern.ToString(), exp_type_ == ExpressionType::COMPARE_ILIKE);
+        break;
+      }
+      case ExpressionType::COMPARE_IN: {
+        std::vector<type::Value> values;
+        for (size_t i = 1; i < children_.size(); i++) {
+          if (GetChild(i)->GetExpressionType() !=
+              ExpressionType::VALUE_CONSTANT) {
+            return;
+          }
+          values.push_back(
+              static_cast<const ConstantValueExpression *>(GetChild(i))
+                  ->GetValue());
+        }
+        in_list_set_ = std::make_shared<function::InListSet>(values);
+        break;
+      }
+      default:
+        return;
+    }
+    compiled_child_ = GetChild(1);
+  }
+
+  static bool IsInteger(type::TypeId type_id) {
+    switch (type_id) {
+      case type::TypeId::TINYINT:
+      case type::TypeId::SMALLINT:
+      case type::TypeId::INTEGER:
+      case type::TypeId::BIGINT:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  static int64_t GetInteger(const type::Value &value) {
+    switch (value.GetTypeId()) {
+      case type::TypeId::TINYINT:
+        return value.GetAs<int8_t>();
+      case type::TypeId::SMALLINT:
+        return value.GetAs<int16_t>();
+      case type::TypeId::INTEGER:
+        return value.GetAs<int32_t>();
+      default:
+        return value.GetAs<int64_t>();
+    }
+  }
+
+  bool EvaluateLike(const type::Value &vl, const type::Value &vr) const {
+    // Match the bytes of a varchar in place, other types by their text
+    std::string text;
+    const char *str;
+    uint32_t length;
+    if (vl.GetTypeId() == type::TypeId::VARCHAR) {
+      str = vl.GetAs<const char *>();
+      length = vl.GetLength() > 0 ? vl.GetLength() - 1 : 0;
+    } else {
+      text = vl.ToString();
+      str = text.data();
+      length = text.size();
+    }
+    if (IsCompiled()) {
+      return like_pattern_->Match(str, length);
+    }
+    std::string pattern = vr.ToString();
+    return function::LikePattern::Match(
+        str, length, pattern.data(), pattern.size(),
+        exp_type_ == ExpressionType::COMPARE_ILIKE);
+  }
+
+  type::Value EvaluateIn(const AbstractTuple *tuple1,
+                         const AbstractTuple *tuple2,
+                         executor::ExecutorContext *context) const {
+    auto vl = children_[0]->Evaluate(tuple1, tuple2, context);
+    if (IsCompiled()) {
+      return type::ValueFactory::GetBooleanValue(in_list_set_->Find(vl));
+    }
+    std::vector<type::Value> values;
+    for (size_t i = 1; i < children_.size(); i++) {
+      values.push_back(children_[i]->Evaluate(tuple1, tuple2, context));
+    }
+    return type::ValueFactory::GetBooleanValue(
+        function::InListSet(values).Find(vl));
+  }
+
+ private:
+  // Built when the plan is, shared by the copies of the expression
+  std::shared_ptr<const function::LikePattern> like_pattern_;
+  std::shared_ptr<const function::InListSet> in_list_set_;
+
+  const AbstractExpression *compiled_child_ = nullptr;
+
+  // Resolved for the value types of the children, only used on values of
+  // exactly those types
+  type::CompareKernel compare_kernel_;
 };
 
 }  // namespace expression
@@ -15,7 +15,7 @@
 #include "expression/abstract_expression.h"
 #include "common/sql_node_visitor.h"
 #include "type/value_factory.h"
-
+#include "type/value_kernels.h"
 
 namespace peloton {
 namespace expression {
@@ -31,7 +31,9 @@ class OperatorExpression : public AbstractExpression {
 
   OperatorExpression(ExpressionType type, type::TypeId type_id,
                      AbstractExpression *left, AbstractExpression *right)
-      : AbstractExpression(type, type_id, left, right) {}
+      : AbstractExpression(type, type_id, left, right) {
+    ResolveKernel();
+  }
 
   type::Value Evaluate(
       UNUSED_ATTRIBUTE const AbstractTuple *tuple1,
@@ -51,6 +53,9 @@ class OperatorExpression : public AbstractExpression {
     PL_ASSERT(children_.size() == 2);
     type::Value vl = children_[0]->Evaluate(tuple1, tuple2, context);
     type::Value vr = children_[1]->Evaluate(tuple1, tuple2, context);
+    if (kernel_.Matches(vl, vr)) {
+      return kernel_(vl, vr);
+    }
 
     switch (exp_type_) {
       case (ExpressionType::OPERATOR_PLUS):
@@ -72,7 +77,8 @@ class OperatorExpression : public AbstractExpression {
     // if we are a decimal or int we should take the highest type id of both
     // children
     // This relies on a particular order in types.h
-    if (exp_type_ == ExpressionType::OPERATOR_NOT) {
+    if (exp_type_ == ExpressionType::OPERATOR_NOT ||
+        exp_type_ == ExpressionType::OPERATOR_EXISTS) {
       return_value_type_ = type::TypeId::BOOLEAN;
       return;
     }
@@ -80,6 +86,7 @@ class OperatorExpression : public AbstractExpression {
         std::max(children_[0]->GetValueType(), children_[1]->GetValueType());
     PL_ASSERT(type <= type::TypeId::DECIMAL);
     return_value_type_ = type;
+    ResolveKernel();
   }
 
   AbstractExpression *Copy() const override {
@@ -90,7 +97,21 @@ class OperatorExpression : public AbstractExpression {
 
  protected:
   OperatorExpression(const OperatorExpression &other)
-      : AbstractExpression(other) {}
+      : AbstractExpression(other), kernel_(other.kernel_) {}
+
+ private:
+  void ResolveKernel() {
+    if (children_.size() == 2) {
+      kernel_ = type::ValueKernels::GetArithmetic(
+          exp_type_, children_[0]->GetValueType(),
+          children_[1]->GetValueType());
+    }
+  }
+
+ private:
+  // Resolved for the value types of the children, only used on values of
+  // exactly those types
+  type::ArithmeticKernel kernel_;
 };
 
 class OperatorUnaryMinusExpression : public AbstractExpression {
@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// subquery_expression.h
+//
+// Identification: src/include/expression/subquery_expression.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+
+#include "common/exception.h"
+#include "common/sql_node_visitor.h"
+#include "expression/abstract_expression.h"
+#include "parser/select_statement.h"
+
+namespace peloton {
+namespace expression {
+
+//===----------------------------------------------------------------------===//
+// SubqueryExpression
+//===----------------------------------------------------------------------===//
+
+/**
+ * A SELECT nested in an expression, the right side of [NOT] IN or the
+ * operand of [NOT] EXISTS. It is never evaluated, the planner turns the
+ * predicate around it into a semi or anti join.
+ */
+class SubqueryExpression : public AbstractExpression {
+ public:
+  explicit SubqueryExpression(parser::SelectStatement *select)
+      : AbstractExpression(ExpressionType::ROW_SUBQUERY), select_(select) {}
+
+  type::Value Evaluate(
+      UNUSED_ATTRIBUTE const AbstractTuple *tuple1,
+      UNUSED_ATTRIBUTE const AbstractTuple *tuple2,
+      UNUSED_ATTRIBUTE executor::ExecutorContext *context) const override {
+    throw NotImplementedException("Subqueries cannot be evaluated");
+  }
+
+  bool Equals(AbstractExpression *expr) const override {
+    return expr->GetExpressionType() == ExpressionType::ROW_SUBQUERY &&
+           static_cast<SubqueryExpression *>(expr)->select_ == select_;
+  }
+
+  AbstractExpression *Copy() const override {
+    return new SubqueryExpression(*this);
+  }
+
+  virtual void Accept(SqlNodeVisitor *v) override { v->Visit(this); }
+
+  parser::SelectStatement *GetSubSelect() const { return select_.get(); }
+
+ protected:
+  // Copies share the statement
+  SubqueryExpression(const SubqueryExpression &other)
+      : AbstractExpression(other), select_(other.select_) {}
+
+ private:
+  std::shared_ptr<parser::SelectStatement> select_;
+};
+
+}  // namespace expression
+}  // namespace peloton
@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// in_list_set.h
+//
+// Identification: src/include/function/in_list_set.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "type/value.h"
+
+namespace peloton {
+namespace function {
+
+//===----------------------------------------------------------------------===//
+// InListSet
+//
+// The constants of an IN list, built once for probing every tuple. Integer
+// lists with values close together become a bitmap, which is a perfect
+// hash, other integer and string lists a hash set. Any other type is
+// compared one value after the other.
+//===----------------------------------------------------------------------===//
+
+class InListSet {
+ public:
+  explicit InListSet(const std::vector<type::Value> &values);
+
+  // The result of "value IN (list)" under SQL's three valued logic
+  type::CmpBool Find(const type::Value &value) const;
+
+  // Probe a batch of integers against a list of integers, writing the
+  // positions of the ones in the set to sel. Returns the number of matches.
+  uint32_t FindBatch(const int64_t *values, uint32_t count,
+                     uint32_t *sel) const;
+
+  // Whether a non-NULL integer or string is in a list of only integers or
+  // only strings, for the probes compiled queries make. A string is given by
+  // its bytes and length, a trailing NUL does not count.
+  bool ContainsInteger(int64_t value) const;
+  bool ContainsString(const char *str, uint32_t length) const;
+
+  bool HasNull() const { return has_null_; }
+  bool IsAllIntegers() const { return all_integers_; }
+  bool IsAllStrings() const { return all_strings_; }
+
+  bool HasBitmap() const { return !bitmap_.empty(); }
+
+ private:
+  // The list contained a NULL
+  bool has_null_;
+
+  // All values of the list are integers or all are strings
+  bool all_integers_;
+  bool all_strings_;
+
+  // Integers in [min_, min_ + bitmap_.size())
+  int64_t min_;
+  std::vector<bool> bitmap_;
+
+  std::unordered_set<int64_t> integers_;
+
+  std::unordered_set<std::string> strings_;
+
+  std::vector<type::Value> values_;
+};
+
+}  // namespace function
+}  // namespace peloton
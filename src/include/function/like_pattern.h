@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// like_pattern.h
+//
+// Identification: src/include/function/like_pattern.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace peloton {
+namespace function {
+
+//===----------------------------------------------------------------------===//
+// LikePattern
+//
+// A LIKE pattern compiled once for matching many strings. Patterns that are
+// a literal with at most a leading and a trailing '%' are matched by a
+// comparison or a substring search, everything else goes to a general
+// wildcard matcher. '\' escapes the next character of the pattern.
+//
+// Strings are given by their bytes and a length that does not include any
+// NUL terminator.
+//===----------------------------------------------------------------------===//
+
+class LikePattern {
+ public:
+  enum class Kind { EXACT, PREFIX, SUFFIX, CONTAINS, GENERIC };
+
+  LikePattern(const char *pattern, uint32_t length, bool case_insensitive);
+
+  explicit LikePattern(const std::string &pattern,
+                       bool case_insensitive = false)
+      : LikePattern(pattern.data(), pattern.size(), case_insensitive) {}
+
+  bool Match(const char *str, uint32_t length) const;
+
+  // Match a string of a compiled query, whose length may count a NUL
+  // terminator
+  bool MatchString(const char *str, uint32_t length) const;
+
+  // Match a batch of strings, writing the positions of the matching ones to
+  // sel. Returns the number of matches.
+  uint32_t MatchBatch(const char *const *strs, const uint32_t *lengths,
+                      uint32_t count, uint32_t *sel) const;
+
+  Kind GetKind() const { return kind_; }
+
+  // The unescaped literal of a non-generic pattern
+  const std::string &GetLiteral() const { return literal_; }
+
+  // The literal every matching string starts with, empty if there is none.
+  // A case insensitive pattern has no usable prefix.
+  const std::string &GetPrefix() const { return prefix_; }
+
+  // Match without compiling the pattern first
+  static bool Match(const char *str, uint32_t length, const char *pattern,
+                    uint32_t pattern_length, bool case_insensitive = false);
+
+ private:
+  bool MatchGeneric(const char *str, uint32_t length) const;
+
+ private:
+  Kind kind_;
+
+  bool case_insensitive_;
+
+  // The pattern as given for the general matcher
+  std::string pattern_;
+
+  std::string literal_;
+
+  std::string prefix_;
+};
+
+}  // namespace function
+}  // namespace peloton
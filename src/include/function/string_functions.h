@@ -25,6 +25,12 @@ class StringFunctions {
   static uint32_t Ascii(const char *str, uint32_t length);
   static type::Value _Ascii(const std::vector<type::Value> &args);
 
+  // Whether the string matches the LIKE (ILIKE) pattern
+  static bool Like(const char *str, uint32_t length, const char *pattern,
+                   uint32_t pattern_length);
+  static bool ILike(const char *str, uint32_t length, const char *pattern,
+                    uint32_t pattern_length);
+
   // Get Character from integer
   static type::Value Chr(const std::vector<type::Value> &args);
 
@@ -61,10 +61,6 @@ class GCManager {
 
   virtual void StopGC() {}
 
-  virtual ItemPointer ReturnFreeSlot(const oid_t &table_id UNUSED_ATTRIBUTE) {
-    return INVALID_ITEMPOINTER;
-  }
-
   virtual void RegisterTable(const oid_t &table_id UNUSED_ATTRIBUTE) {}
 
   virtual void DeregisterTable(const oid_t &table_id UNUSED_ATTRIBUTE) {}
@@ -77,6 +73,13 @@ class GCManager {
       const eid_t &epoch_id UNUSED_ATTRIBUTE,
       const size_t &thread_id UNUSED_ATTRIBUTE) {}
 
+  // Called by worker threads that run into expired versions the GC has not
+  // collected yet. Collects some garbage of the tile group's partition if no
+  // other thread is doing so, and returns whether it did.
+  virtual bool HelpCollect(const oid_t &tile_group_id UNUSED_ATTRIBUTE) {
+    return false;
+  }
+
  protected:
   void CheckAndReclaimVarlenColumns(storage::TileGroup *tg, oid_t tuple_id);
 
@@ -12,18 +12,22 @@
 
 #pragma once
 
+#include <atomic>
+#include <deque>
+#include <mutex>
 #include <list>
-#include <map>
 #include <thread>
 #include <unordered_map>
 #include <vector>
 
 #include "common/init.h"
 #include "common/logger.h"
+#include "common/platform.h"
 #include "common/thread_pool.h"
 #include "gc/gc_manager.h"
 #include "type/types.h"
 
+#include "container/cuckoo_map.h"
 #include "container/lock_free_queue.h"
 
 namespace peloton {
@@ -44,39 +48,60 @@ struct GarbageContext {
   eid_t epoch_id_;
 };
 
+// Partitions per GC thread. Garbage is spread over partitions by tile group,
+// and a worker helping the GC only blocks the partition it works on. The GC
+// starts with this many partitions for each of its threads and then sizes
+// them from the database: one partition per table, or per
+// GC_TILE_GROUPS_PER_PARTITION live tile groups if that is more, capped at
+// GC_MAX_PARTITIONS_PER_THREAD per thread. One GC thread runs for every
+// GC_PARTITIONS_PER_THREAD partitions, the others idle.
+#define GC_PARTITIONS_PER_THREAD 4
+
+#define GC_MAX_PARTITIONS_PER_THREAD 16
+
+#define GC_TILE_GROUPS_PER_PARTITION 16
+
+// Garbage contexts a worker thread processes when it helps the GC
+#define GC_HELP_BATCH_SIZE 64
+
+// Epochs a superseded version must be old before a worker helps the GC
+#define GC_HELP_EPOCH_LAG 8
+
+// Garbage of one partition, processed by one thread at a time
+struct GCPartition {
+  GCPartition() : unlink_queue_(MAX_QUEUE_LENGTH) {}
+
+  // Held by the GC thread owning the partition or a worker helping it
+  Spinlock lock_;
+
+  // to-be-unlinked garbage, filled by committing transactions
+  LockFreeQueue<std::shared_ptr<GarbageContext>> unlink_queue_;
+
+  // to-be-unlinked garbage whose epoch has not expired yet
+  std::list<std::shared_ptr<GarbageContext>> local_unlink_queue_;
+
+  // to-be-reclaimed garbage.
+  // The first element is the epoch when the garbage is unlinked, the second
+  // is the metadata of the garbage. Epochs only grow, so the queue is
+  // ordered by them.
+  std::deque<std::pair<eid_t, std::shared_ptr<GarbageContext>>>
+      reclaim_queue_;
+};
+
 class TransactionLevelGCManager : public GCManager {
  public:
   TransactionLevelGCManager(const int thread_count)
-      : gc_thread_count_(thread_count), reclaim_maps_(thread_count) {
-    unlink_queues_.reserve(thread_count);
-    for (int i = 0; i < gc_thread_count_; ++i) {
-      std::shared_ptr<LockFreeQueue<std::shared_ptr<GarbageContext>>>
-          unlink_queue(new LockFreeQueue<std::shared_ptr<GarbageContext>>(
-              MAX_QUEUE_LENGTH));
-      unlink_queues_.push_back(unlink_queue);
-      local_unlink_queues_.emplace_back();
-    }
+      : gc_thread_count_(thread_count) {
+    ResetPartitions();
   }
 
   virtual ~TransactionLevelGCManager() {}
 
   // this function cleans up all the member variables in the class object.
   virtual void Reset() override {
-    unlink_queues_.clear();
-    local_unlink_queues_.clear();
+    ResetPartitions();
 
-    unlink_queues_.reserve(gc_thread_count_);
-    for (int i = 0; i < gc_thread_count_; ++i) {
-      std::shared_ptr<LockFreeQueue<std::shared_ptr<GarbageContext>>>
-          unlink_queue(new LockFreeQueue<std::shared_ptr<GarbageContext>>(
-              MAX_QUEUE_LENGTH));
-      unlink_queues_.push_back(unlink_queue);
-      local_unlink_queues_.emplace_back();
-    }
-
-    reclaim_maps_.clear();
-    reclaim_maps_.resize(gc_thread_count_);
-    recycle_queue_map_.clear();
+    registered_tables_.Clear();
 
     is_running_ = false;
   }
@@ -116,39 +141,59 @@ class TransactionLevelGCManager : public GCManager {
                                   const eid_t &epoch_id,
                                   const size_t &thread_id) override;
 
-  virtual ItemPointer ReturnFreeSlot(const oid_t &table_id) override;
-
   virtual void RegisterTable(const oid_t &table_id) override {
-    // Insert a new entry for the table
-    if (recycle_queue_map_.find(table_id) == recycle_queue_map_.end()) {
-      std::shared_ptr<LockFreeQueue<ItemPointer>> recycle_queue(
-          new LockFreeQueue<ItemPointer>(MAX_QUEUE_LENGTH));
-      recycle_queue_map_[table_id] = recycle_queue;
-    }
+    registered_tables_.Insert(table_id, table_id);
   }
 
   virtual void DeregisterTable(const oid_t &table_id) override {
     // Remove dropped tables
-    if (recycle_queue_map_.find(table_id) != recycle_queue_map_.end()) {
-      recycle_queue_map_.erase(table_id);
-    }
+    registered_tables_.Erase(table_id);
   }
 
-  virtual size_t GetTableCount() override { return recycle_queue_map_.size(); }
+  virtual size_t GetTableCount() override {
+    return registered_tables_.GetSize();
+  }
 
+  virtual bool HelpCollect(const oid_t &tile_group_id) override;
+
+  // Unlink and reclaim the garbage in the partitions of the given GC thread.
+  // Both return the number of garbage contexts processed.
   int Unlink(const int &thread_id, const eid_t &expired_eid);
 
   int Reclaim(const int &thread_id, const eid_t &expired_eid);
 
+  // Number of partitions new garbage is spread over
+  size_t GetPartitionCount() const { return partition_count_.load(); }
+
+  size_t GetMaxPartitionCount() const { return partitions_.size(); }
+
+  // Number of GC threads collecting garbage
+  int GetActiveThreadCount() const { return active_thread_count_.load(); }
+
+  // Size the partitions and the GC threads from the number of tables and of
+  // live tile groups. Run by the first GC thread every time it wakes up.
+  void ResizePartitions();
+
  private:
-  inline unsigned int HashToThread(const size_t &thread_id) {
-    return (unsigned int)thread_id % gc_thread_count_;
+  inline size_t HashToPartition(const size_t &id) const {
+    return id % partition_count_.load(std::memory_order_acquire);
   }
 
+  // Make sure the first partition_count partitions exist
+  void AllocatePartitions(size_t partition_count);
+
+  void ResetPartitions();
+
   void ClearGarbage(int thread_id);
 
   void Running(const int &thread_id);
 
+  int UnlinkPartition(GCPartition &partition, const eid_t &expired_eid,
+                      const size_t &max_count);
+
+  int ReclaimPartition(GCPartition &partition, const eid_t &expired_eid,
+                       const size_t &max_count);
+
   void AddToRecycleMap(std::shared_ptr<GarbageContext> gc_ctx);
 
   bool ResetTuple(const ItemPointer &);
@@ -166,30 +211,33 @@ class TransactionLevelGCManager : public GCManager {
   // Data members
   //===--------------------------------------------------------------------===//
 
+  // gc threads started, the most that may be active
   int gc_thread_count_;
 
-  // queues for to-be-unlinked tuples.
-  // # unlink_queues == # gc_threads
-  std::vector<
-      std::shared_ptr<peloton::LockFreeQueue<std::shared_ptr<GarbageContext>>>>
-      unlink_queues_;
-
-  // local queues for to-be-unlinked tuples.
-  // # local_unlink_queues == # gc_threads
-  std::vector<std::list<std::shared_ptr<GarbageContext>>> local_unlink_queues_;
-
-  // multimaps for to-be-reclaimed tuples.
-  // The key is the timestamp when the garbage is identified, value is the
-  // metadata of the garbage.
-  // # reclaim_maps == # gc_threads
-  std::vector<std::multimap<cid_t, std::shared_ptr<GarbageContext>>>
-      reclaim_maps_;
-
-  // queues for to-be-reused tuples.
-  // # recycle_queue_maps == # tables
-  std::unordered_map<oid_t,
-                     std::shared_ptr<peloton::LockFreeQueue<ItemPointer>>>
-      recycle_queue_map_;
+  // gc threads collecting garbage, the others idle
+  std::atomic<int> active_thread_count_;
+
+  // partitions of the garbage, selected by tile group id.
+  // partition p is processed by gc thread p % active_thread_count_.
+  // the vector has room for gc_thread_count_ * GC_MAX_PARTITIONS_PER_THREAD
+  // partitions, which are allocated as the partition count grows. it is never
+  // resized, so threads may read it while partitions are added.
+  std::vector<std::unique_ptr<GCPartition>> partitions_;
+
+  // partitions new garbage goes to
+  std::atomic<size_t> partition_count_;
+
+  // partitions allocated so far. garbage left in partitions beyond
+  // partition_count_ after it shrank is still collected.
+  std::atomic<size_t> allocated_partition_count_;
+
+  // serializes the allocation of partitions
+  std::mutex partition_mutex_;
+
+  // tables whose older versions are recycled for reuse, catalog tables are
+  // not. the free slots themselves are kept by the tables. the map is looked
+  // up by every gc thread, so it is sharded rather than behind one latch.
+  CuckooMap<oid_t, oid_t> registered_tables_;
 };
 }
 }  // namespace peloton
@@ -56,6 +56,8 @@
 
 #endif
 
+#include "container/epoch_reclaimer.h"
+
 // This must be declared before all include directives
 using NodeID = uint64_t;
 
@@ -83,11 +85,6 @@ using NodeID = uint64_t;
  */
 #define ALL_PUBLIC
 
-/*
- * USE_OLD_EPOCH - This flag switches between old epoch and new epoch mechanism
- */
-#define USE_OLD_EPOCH
-
 /*
  * BWTREE_TEMPLATE_ARGUMENTS - Save some key strokes
  */
@@ -139,10 +136,6 @@ extern bool print_flag;
 // The NodeID for the first leaf is fixed, which is 2
 #define FIRST_LEAF_NODE_ID ((NodeID)2UL)
 
-// This is the value we use in epoch manager to make sure
-// no thread sneaking in while GC decision is being made
-#define MAX_THREAD_COUNT ((int)0x7FFFFFFF)
-
 // The maximum number of nodes we could map in this index
 #define MAPPING_TABLE_SIZE ((size_t)(1 << 20))
 
@@ -185,394 +178,6 @@ extern bool print_flag;
                                                         sizeof(T)) \
                                                     ) T{__VA_ARGS__} ))
 
-/*
- * class BwTreeBase - Base class of BwTree that stores some common members
- */
-class BwTreeBase {
-public:
-  // This is the presumed size of cache line
-  static constexpr size_t CACHE_LINE_SIZE = 64;
-  
-  // This is the mask we used for address alignment (AND with this)
-  static constexpr size_t CACHE_LINE_MASK = ~(CACHE_LINE_SIZE - 1);
-  
-  // We invoke the GC procedure after this has been reached
-  static constexpr size_t GC_NODE_COUNT_THREADHOLD = 1024;
-  
-  /*
-   * class GarbageNode - Garbage node used to represent delayed allocation
-   *
-   * Note that since we could not know the actual definition of BaseNode here,
-   * all garbage pointer to BaseNode should be represented as void *, and are
-   * casted to appropriate type manually
-   */
-  class GarbageNode {
-   public:
-    // The epoch that this node is unlinked
-    // This do not have to be exact - just make sure it is no earlier than the
-    // actual epoch it is unlinked from the data structure
-    uint64_t delete_epoch;
-    void *node_p;
-    GarbageNode *next_p;
-    
-    /*
-     * Constructor
-     */
-    GarbageNode(uint64_t p_delete_epoch, void *p_node_p) :
-      delete_epoch{p_delete_epoch},
-      node_p{p_node_p},
-      next_p{nullptr}
-    {}
-    
-    GarbageNode() :
-      delete_epoch{0UL},
-      node_p{nullptr},
-      next_p{nullptr}
-    {}
-  };
-  
-  /*
-   * class GCMetaData - Metadata for performing GC on per-thread basis
-   */
-  class GCMetaData {
-   public: 
-    // This is the last active epoch counter; all garbages before this counter
-    // are guaranteed to be not being used by this thread
-    // So if we take a global minimum of this value, that minimum could be
-    // be used as the global epoch value to decide whether a garbage node could
-    // be recycled
-    uint64_t last_active_epoch;
-    
-    // We only need a pointer
-    GarbageNode header; 
-    
-    // This points to the last node in the garbage node linked list
-    // We always append new nodes to this pointer, and thus inside one
-    // node's context these garbage nodes are always sorted, from low
-    // epoch to high epoch. This facilitates memory reclaimation since we
-    // just start from the lowest epoch garbage and traverse the linked list
-    // until we see an epoch >= GC epoch
-    GarbageNode *last_p;
-    
-    // The number of nodes inside this GC context
-    // We use this as a threshold to trigger GC
-    uint64_t node_count;
-    
-    /*
-     * Default constructor
-     */
-    GCMetaData() :
-      last_active_epoch{0UL},
-      header{},
-      last_p{&header},
-      node_count{0UL}
-    {}
-  };
-  
-  // Make sure class Data does not exceed one cache line
-  static_assert(sizeof(GCMetaData) < CACHE_LINE_SIZE,
-                "class Data size exceeds cache line length!");
-  
-  /*
-   * class PaddedData - Padded data to the length of a cache line 
-   */
-  template<typename DataType, size_t Alignment> 
-  class PaddedData {
-   public: 
-    // This is the alignment of padded data - we adjust its alignment
-    // after malloc() a chunk of memory
-    static constexpr size_t ALIGNMENT = Alignment;
-    
-    // This is where real data goes
-    DataType data;
-    
-    /*
-     * Default constructor - This is called if DataType could be initialized
-     *                       without any constructor
-     */
-    PaddedData() :
-      data{}
-    {}
-    
-   private:
-    char padding[ALIGNMENT - sizeof(DataType)];  
-  };
-  
-  using PaddedGCMetadata = PaddedData<GCMetaData, CACHE_LINE_SIZE>;
-  
-  static_assert(sizeof(PaddedGCMetadata) == PaddedGCMetadata::ALIGNMENT, 
-                "class PaddedGCMetadata size does"
-                " not conform to the alignment!");
-
-public:
-  // This is used as the garbage collection ID, and is maintained in a per
-  // thread level
-  // This is initialized to -1 in order to distinguish between registered 
-  // threads and unregistered threads
-  static thread_local int gc_id;
-
-private:
-  // This is used to count the number of threads participating GC process
-  // We use this number to initialize GC data structure
-  static std::atomic<size_t> total_thread_num;
-  
-  // This is the array being allocated for performing GC
-  // The allocation aligns its address to cache line boundary
-  PaddedGCMetadata *gc_metadata_p;
-  
-  // We use this to compute aligned memory address to be
-  // used as the gc metadata array
-  unsigned char *original_p;
-  
-  // This is the number of thread that this instance could support
-  size_t thread_num;
-  
-  // This is current epoch
-  // We need to make it atomic since multiple threads might try to modify it
-  uint64_t epoch;
-  
- public:
-   
-  /*
-   * DestroyThreadLocal() - Destroies thread local
-   *
-   * This function calls destructor for each metadata element and then
-   * frees the memory
-   *
-   * NOTE: We should also free all garbage nodes before this is called. However
-   * since we do not know the type of garbage nodes yet, we should call the
-   * function inside BwTree destructor
-   *
-   * This function must be called when the garbage pool is empty
-   */
-  void DestroyThreadLocal() {
-    bwt_printf("Destroy %lu thread local slots\n", thread_num);
-    
-    // There must already be metadata allocated
-    assert(original_p != nullptr);
-    
-    // Manually call destructor
-    for(size_t i = 0;i < thread_num;i++) {
-      assert((gc_metadata_p + i)->data.header.next_p == nullptr);
-      
-      (gc_metadata_p + i)->~PaddedGCMetadata();
-    }
-    
-    // Free memory using original pointer rather than adjusted pointer
-    free(original_p);
-    
-    return;
-  }
-  
-  /*
-   * PrepareThreadLocal() - Initialize thread local variables
-   *
-   * This function uses thread_num to initialize number of threads
-   */
-  void PrepareThreadLocal() {
-    bwt_printf("Preparing %lu thread local slots\n", thread_num);
-    
-    // This is the unaligned base address
-    // We allocate one more element than requested as the buffer
-    // for doing alignment
-    original_p = static_cast<unsigned char *>(
-      malloc(CACHE_LINE_SIZE * (thread_num + 1)));
-    assert(original_p != nullptr);
-    
-    // Align the address to cache line boundary
-    gc_metadata_p = reinterpret_cast<PaddedGCMetadata *>(
-      (reinterpret_cast<size_t>(original_p) + CACHE_LINE_SIZE - 1) & \
-        CACHE_LINE_MASK);
-    
-    // Make sure it is aligned
-    assert(((size_t)gc_metadata_p % CACHE_LINE_SIZE) == 0);
-    
-    // Make sure we do not overflow the chunk of memory
-    assert(((size_t)gc_metadata_p + thread_num * CACHE_LINE_SIZE) <= \
-             ((size_t)original_p + (thread_num + 1) * CACHE_LINE_SIZE));
-    
-    // At last call constructor of the class; we use placement new
-    for(size_t i = 0;i < thread_num;i++) {
-      new (gc_metadata_p + i) PaddedGCMetadata{};
-    }
-    
-    return; 
-  } 
-  
-  /*
-   * SetThreadNum() - Sets number of threads manually
-   */
-  void SetThreadNum(size_t p_thread_num) {
-    thread_num = p_thread_num;
-    
-    return;
-  }
-  
- public: 
-
-  /*
-   * Constructor - Initialize GC data structure
-   */
-  BwTreeBase() :
-    gc_metadata_p{nullptr},
-    original_p{nullptr},
-    thread_num{total_thread_num.load()},
-    epoch{0UL} {
-    
-    // Allocate memory for thread local data structure
-    PrepareThreadLocal();
-    
-    return;
-  }
-  
-  /*
-   * Destructor - Manually call destructor and then frees the memory 
-   */
-  ~BwTreeBase() {
-    // Frees all metadata
-    DestroyThreadLocal();
-    
-    bwt_printf("Finished destroying class BwTreeBase\n")
-    
-    return;
-  }
-    
-  /*
-   * GetThreadNum() - Returns the number of thread currently this instance of
-   *                  BwTree is serving
-   */
-  inline size_t GetThreadNum() {
-    return thread_num; 
-  }
-  
-  /*
-   * AssignGCID() - Assigns a gc_id manually
-   *
-   * This is mainly used for debugging
-   */
-  inline void AssignGCID(int p_gc_id) {
-    gc_id = p_gc_id;
-    
-    return;
-  }
-  
-  /*
-   * RegisterThread() - Registers a thread for GC for all instances of BwTree
-   *                    in the current process's address space
-   *
-   * This function assigns an ID to a thread starting from 0, which could be 
-   * used as thread ID for the garbage collection process. 
-   *
-   * Also note that only threads registered before an instance is created will
-   * be considered as being eligible for GC for that thread
-   *
-   * This function does not return any value, and instead it uses an atomic 
-   * counter to counter the number of threads currently in this system, and
-   * assigns the thread ID to a thread local variable called gc_id decleared
-   * inside this class
-   *
-   * Each thread being allocated a GC ID has a context for garbage collection
-   * that is aligned to cache lines. The context will be allocated for every
-   * thread being registered, even if it has already exited. Therefore, this
-   * approach is only suitable for thread pools where the number of threads
-   * is fixed at startup time.
-   */
-  static void RegisterThread() {
-    gc_id = total_thread_num.fetch_add(1);
-    
-    return;
-  }
-  
-  /*
-   * IncreaseEpoch() - Go to the next epoch by increasing the counter
-   *
-   * Note that this should not be called by worker threads since 
-   * it will cause contention
-   */
-  inline void IncreaseEpoch() {
-    epoch++;
-    
-    return;
-  }
-  
-  /*
-   * UpdateLastActiveEpoch() - Updates the last active epoch field of thread 
-   *                           local storage
-   *
-   * This is the core of GC algorithm. Its implication is that all garbage nodes
-   * unlinked before this epoch could be safely collected since at the time 
-   * the thread local counter is updated, we know all references to shared
-   * resources have been released
-   */
-  inline void UpdateLastActiveEpoch() {
-    GetCurrentGCMetaData()->last_active_epoch = GetGlobalEpoch();
-    
-    return;
-  }
-  
-  /*
-   * UnregisterThread() - Unregisters a thread by setting its epoch to 
-   *                      0xFFFFFFFFFFFFFFFF such that it will not be considered
-   *                      for GC
-   */
-  inline void UnregisterThread(int thread_id) {
-    GetGCMetaData(thread_id)->last_active_epoch = static_cast<uint64_t>(-1);
-  }
-  
-  /*
-   * GetGlobalEpoch() - Returns the current global epoch counter
-   *
-   * Note that this function might return a stale value, which does not affect
-   * correctness as long as unlinking the node form data structure is atomic
-   * since all refreshing operations will read the same or smaller value
-   * when it reads the counter
-   */
-  inline uint64_t GetGlobalEpoch() {
-    return epoch; 
-  }
-  
-  /*
-   * GetGCMetaData() - Returns the thread-local metadata for GC for a specified
-   *                   thread
-   */
-  inline GCMetaData *GetGCMetaData(int thread_id) {
-    // The thread ID must be within the range
-    assert(thread_id >= 0 && thread_id < static_cast<int>(thread_num));
-    
-    return &(gc_metadata_p + thread_id)->data;
-  }
-  
-  /*
-   * GetCurrentGCMetaData() - Returns the metadata for the current thread
-   */
-  inline GCMetaData *GetCurrentGCMetaData() {
-    return GetGCMetaData(gc_id); 
-  }
-  
-  /*
-   * SummarizeGCEpoch() - Returns the minimum epochs among the current epoch
-   *                      counters of all threads
-   *
-   * Note that if this is called then it must be true that there are at least
-   * one thread participating into the GC process
-   */
-  uint64_t SummarizeGCEpoch() {
-    assert(thread_num >= 1);
-    
-    // Use the first metadata's epoch as min and update it on the fly
-    uint64_t min_epoch = GetGCMetaData(0)->last_active_epoch;
-    
-    // This might not be executed if there is only one thread
-    for(int i = 1;i < static_cast<int>(thread_num);i++) {
-      // This will be compiled into using CMOV which is more efficient
-      // than CMP and JMP
-      min_epoch = std::min(GetGCMetaData(i)->last_active_epoch, min_epoch);
-    }
-    
-    return min_epoch;
-  }
-};
-
 /*
  * class BwTree - Lock-free BwTree index implementation
  *
@@ -623,7 +228,7 @@ template <typename KeyType,
           typename KeyHashFunc = std::hash<KeyType>,
           typename ValueEqualityChecker = std::equal_to<ValueType>,
           typename ValueHashFunc = std::hash<ValueType>>
-class BwTree : public BwTreeBase {
+class BwTree {
  /*
   * Private & Public declaration
   */
@@ -2638,7 +2243,6 @@ class BwTree : public BwTreeBase {
          KeyHashFunc p_key_hash_obj = KeyHashFunc{},
          ValueEqualityChecker p_value_eq_obj = ValueEqualityChecker{},
          ValueHashFunc p_value_hash_obj = ValueHashFunc{}) :
-      BwTreeBase(),
       // Key comparator, equality checker and hasher
       key_cmp_obj{p_key_cmp_obj},
       key_eq_obj{p_key_eq_obj},
@@ -2708,9 +2312,10 @@ class BwTree : public BwTreeBase {
     bwt_printf("Next node ID at exit: %lu\n", next_unused_node_id.load());
     bwt_printf("Destructor: Free tree nodes\n");
 
-    // Clear all garbage nodes awaiting cleaning
-    // First of all it should set all last active epoch counter to -1
-    ClearThreadLocalGarbage();
+    // Free all garbage nodes awaiting cleaning. No other thread could
+    // access the tree at this point
+    epoch_manager.StopThread();
+    epoch_manager.ClearGarbage();
 
     // Free all nodes recursively
     size_t node_count = FreeNodeByNodeID(root_id.load());
@@ -2720,57 +2325,6 @@ class BwTree : public BwTreeBase {
     return;
   }
   
-  /*
-   * ClearThreadLocalGarbage() - Clears all thread local garbage
-   *
-   * This must be called under single threaded environment
-   */
-  void ClearThreadLocalGarbage() {
-    // First of all we should set all last active counter to -1 to
-    // guarantee progress to clear all epoches
-    for(size_t i = 0;i < GetThreadNum();i++) {
-      UnregisterThread(i);
-    }
-    
-    for(size_t i = 0;i < GetThreadNum();i++) {
-      // Here all epoch counters have been set to 0xFFFFFFFFFFFFFFFF
-      // so GC should always succeed
-      PerformGC(i);
-      
-      // This will collect all nodes since we have adjusted the currenr thread
-      // GC ID
-      assert(GetGCMetaData(i)->node_count == 0);
-    }
-    
-    return;
-  }
-  
-  /*
-   * UpdateThreadLocal() - Frees all memorys currently existing and then 
-   *                       reallocate a chunk of memory to represent the 
-   *                       thread local variables
-   *
-   * This function is majorly used for debugging pruposes. The argument is
-   * the new number of threads we want to support here for doing experiments
-   */
-  void UpdateThreadLocal(size_t p_thread_num) {
-    bwt_printf("Updating thread-local array to length %lu......\n", 
-               p_thread_num);
-    
-    // 1. Frees all pending memory chunks
-    // 2. Frees the thread local array
-    ClearThreadLocalGarbage(); 
-    DestroyThreadLocal();
-    
-    SetThreadNum(p_thread_num);
-    
-    // 3. Allocate a new array based on the new given size
-    // Here all epoches are restored to 0
-    PrepareThreadLocal();
-    
-    return;
-  }
-
   /*
    * FreeNodeByNodeID() - Given a NodeID, free all nodes and its children
    *
@@ -7678,12 +7232,11 @@ before_switch:
    * time GC was called, then GC is unnecessary since read operation does not
    * modify any data structure
    *
-   * Currently we just leave the interface as a placeholder, which returns true
-   * everytime to force GC thred to at least take a look into the epoch
-   * counter.
+   * Garbage is kept by the reclaimer shared with the other structures, so
+   * this returns true as long as any retired node has not been freed
    */
   bool NeedGarbageCollection() {
-    return true;
+    return peloton::EpochReclaimer::GetInstance().GetGarbageCount() > 0;
   }
   
   /*
@@ -7696,8 +7249,8 @@ before_switch:
    * interface for external threads to do garbage collection.
    */
   void PerformGarbageCollection() {
-    // This function creates a new epoch node, and then checks
-    // epoch counter for exiatsing nodes.
+    // This advances the epoch and frees nodes retired before the
+    // oldest epoch any thread is still in
     epoch_manager.PerformGarbageCollection();
 
     return;
@@ -7774,10 +7327,14 @@ before_switch:
  public:
 
   /*
-   * class EpochManager - Maintains a linked list of deleted nodes
-   *                      for threads to access until all threads
-   *                      entering epochs before the deletion of
-   *                      nodes have exited
+   * class EpochManager - Defers freeing deleted nodes until all threads
+   *                      that might still be accessing them have exited
+   *
+   * Epochs are tracked by the EpochReclaimer that is shared with the
+   * garbage collector and the storage layer, which keeps the epoch state
+   * of each thread in its own cache line. Retired delta chains are freed
+   * by the worker thread that retires too many of them, by the GC threads,
+   * or when the tree is destroyed.
    */
   class EpochManager {
    public:
@@ -7787,50 +7344,15 @@ before_switch:
     constexpr static int GC_INTERVAL = 50;
 
     /*
-     * struct GarbageNode - A linked list of garbages
-     */
-    struct GarbageNode {
-      const BaseNode *node_p;
-
-      // This does not have to be atomic, since we only
-      // insert at the head of garbage list
-      GarbageNode *next_p;
-    };
-
-    /*
-     * struct EpochNode - A linked list of epoch node that records thread count
+     * struct EpochNode - Handle returned by JoinEpoch()
      *
-     * This struct is also the head of garbage node linked list, which must
-     * be made atomic since different worker threads will contend to insert
-     * garbage into the head of the list
+     * The reclaimer remembers the epoch of each thread itself, so this
+     * carries no state. It is kept to pair JoinEpoch() and LeaveEpoch()
      */
-    struct EpochNode {
-      // We need this to be atomic in order to accurately
-      // count the number of threads
-      std::atomic<int> active_thread_count;
-
-      // We need this to be atomic to be able to
-      // add garbage nodes without any race condition
-      // i.e. GC nodes are CASed onto this pointer
-      std::atomic<GarbageNode *> garbage_list_p;
-
-      // This does not need to be atomic since it is
-      // only maintained by the epoch thread
-      EpochNode *next_p;
-    };
-
-    // The head pointer does not need to be atomic
-    // since it is only accessed by epoch manager
-    EpochNode *head_epoch_p;
-
-    // This does not need to be atomic because it is only written
-    // by the epoch manager and read by worker threads. But it is
-    // acceptable that allocations are delayed to the next epoch
-    EpochNode *current_epoch_p;
+    struct EpochNode {};
 
     // This flag indicates whether the destructor is running
-    // If it is true then GC thread should not clean
-    // Therefore, strict ordering is required
+    // If it is true then GC thread should stop
     std::atomic<bool> exited_flag;
 
     // If GC is done with external thread then this should be set
@@ -7840,334 +7362,115 @@ before_switch:
 
     // The counter that counts how many free is called
     // inside the epoch manager
-    // NOTE: We cannot precisely count the size of memory freed
-    // since sizeof(Node) does not reflect the true size, since
-    // some nodes are embedded with complicated data structure that
-    // maintains its own memory
+    // NOTE: Nodes might be freed by any thread reclaiming an epoch
     #ifdef BWTREE_DEBUG
     // Number of nodes we have freed
-    size_t freed_count;
+    std::atomic<size_t> freed_count;
 
     // Number of NodeID we have freed
-    size_t freed_id_count;
-
-    // These two are used for debugging
-    size_t epoch_created;
-    size_t epoch_freed;
-
-    std::atomic<size_t> epoch_join;
-    std::atomic<size_t> epoch_leave;
+    std::atomic<size_t> freed_id_count;
     #endif
 
     /*
-     * Constructor - Initialize the epoch list to be a single node
+     * Constructor - Initialize the epoch manager
      *
      * NOTE: We do not start thread here since the init of bw-tree itself
      * might take a long time
      */
     EpochManager(BwTree *p_tree_p) :
-      tree_p{p_tree_p} {
-      current_epoch_p = new EpochNode{};
-
-      // These two are atomic variables but we could
-      // simply assign to them
-      current_epoch_p->active_thread_count = 0;
-      current_epoch_p->garbage_list_p = nullptr;
-
-      current_epoch_p->next_p = nullptr;
-
-      head_epoch_p = current_epoch_p;
-
-      // We allocate and run this later
-      thread_p = nullptr;
-
-      // This is used to notify the cleaner thread that it has ended
-      exited_flag.store(false);
-
-      // Initialize atomic counter to record how many
-      // freed has been called inside epoch manager
+      tree_p{p_tree_p},
+      exited_flag{false},
+      thread_p{nullptr} {
       #ifdef BWTREE_DEBUG
       freed_count = 0UL;
       freed_id_count = 0UL;
-
-      // It is not 0UL since we create an initial epoch on initialization
-      epoch_created = 1UL;
-      epoch_freed = 0UL;
-
-      epoch_join = 0UL;
-      epoch_leave = 0UL;
       #endif
 
       return;
     }
 
     /*
-     * Destructor - Stop the worker thread and cleanup resources not freed
-     *
-     * This function waits for the worker thread using join() method. After the
-     * worker thread has exited, it synchronously clears all epochs that have
-     * not been recycled by calling ClearEpoch()
-     *
-     * NOTE: If no internal GC is started then thread_p would be a nullptr
-     * and we neither wait nor free the pointer.
+     * Destructor - Stop the worker thread and free garbage not freed yet
      */
     ~EpochManager() {
-      // Set stop flag and let thread terminate
-      // Also if there is an external GC thread then it should
-      // check this flag everytime it does cleaning since otherwise
-      // the un-thread-safe function ClearEpoch() would be ran
-      // by more than 1 threads
-      exited_flag.store(true);
+      StopThread();
+      ClearGarbage();
 
-      // If thread pointer is nullptr then we know the GC thread
-      // is not started. In this case do not wait for the thread, and just
-      // call destructor
-      //
-      // NOTE: The destructor routine is not thread-safe, so if an external
-      // GC thread is being used then that thread should check for
-      // exited_flag everytime it wants to do GC
-      //
-      // If the external thread calls ThreadFunc() then it is safe
-      if(thread_p != nullptr) {
-        bwt_printf("Waiting for thread\n");
-        
-        thread_p->join();
-
-        // Free memory
-        delete thread_p;
-        
-        bwt_printf("Thread stops\n");
-      }
-
-      // So that in the following function the comparison
-      // would always fail, until we have cleaned all epoch nodes
-      current_epoch_p = nullptr;
-
-      // If all threads has exited then all thread counts are
-      // 0, and therefore this should proceed way to the end
-      ClearEpoch();
-
-      // If we have a bug (currently there is one) then as a temporary
-      // measure just force cleaning all epoches no matter whether they
-      // are cleared or not
-      if(head_epoch_p != nullptr) {
-        bwt_printf("ERROR: After cleanup there is still epoch left\n");
-        bwt_printf("==============================================\n");
-        bwt_printf("DUMP\n");
-
-        for(EpochNode *epoch_node_p = head_epoch_p;
-            epoch_node_p != nullptr;
-            epoch_node_p = epoch_node_p->next_p) {
-          bwt_printf("Active thread count: %d\n",
-                 epoch_node_p->active_thread_count.load());
-          epoch_node_p->active_thread_count = 0;
-        }
-
-        bwt_printf("RETRY CLEANING...\n");
-        ClearEpoch();
-      }
-
-      assert(head_epoch_p == nullptr);
       bwt_printf("Garbage Collector has finished freeing all garbage nodes\n");
 
       #ifdef BWTREE_DEBUG
       bwt_printf("Stat: Freed %lu nodes and %lu NodeID by epoch manager\n",
-                 freed_count,
-                 freed_id_count);
-
-      bwt_printf("      Epoch created = %lu; epoch freed = %lu\n",
-                 epoch_created,
-                 epoch_freed);
-
-      bwt_printf("      Epoch join = %lu; epoch leave = %lu\n",
-                 epoch_join.load(),
-                 epoch_leave.load());
+                 freed_count.load(),
+                 freed_id_count.load());
       #endif
 
       return;
     }
 
     /*
-     * CreateNewEpoch() - Create a new epoch node
+     * AddGarbageNode() - Retire a delta chain that has been unlinked
      *
-     * This functions does not have to consider race conditions
+     * The chain is freed once all threads that joined an epoch before it was
+     * retired have left their epoch
      */
-    void CreateNewEpoch() {
-      bwt_printf("Creating new epoch...\n");
-
-      EpochNode *epoch_node_p = new EpochNode{};
-
-      epoch_node_p->active_thread_count = 0;
-      epoch_node_p->garbage_list_p = nullptr;
-
-      // We always append to the tail of the linked list
-      // so this field for new node is always nullptr
-      epoch_node_p->next_p = nullptr;
-
-      // Update its previous node (current tail)
-      current_epoch_p->next_p = epoch_node_p;
-
-      // And then switch current epoch pointer
-      current_epoch_p = epoch_node_p;
-
-      #ifdef BWTREE_DEBUG
-      epoch_created++;
-      #endif
+    inline void AddGarbageNode(const BaseNode *node_p) {
+      peloton::EpochReclaimer::GetInstance().Retire(
+          const_cast<BaseNode *>(node_p), &FreeGarbageNode, this);
 
       return;
     }
 
-#ifdef USE_OLD_EPOCH 
-
     /*
-     * AddGarbageNode() - Add garbage node into the current epoch
-     *
-     * NOTE: This function is called by worker threads so it has
-     * to consider race conditions
+     * JoinEpoch() - Protect the nodes reachable from now on from being freed
      */
-    void AddGarbageNode(const BaseNode *node_p) {
-      // We need to keep a copy of current epoch node
-      // in case that this pointer is increased during
-      // the execution of this function
-      //
-      // NOTE: Current epoch must not be recycled, since
-      // the current thread calling this function must
-      // come from an epoch <= current epoch
-      // in which case all epochs before that one should
-      // remain valid
-      EpochNode *epoch_p = current_epoch_p;
-
-      // These two could be predetermined
-      GarbageNode *garbage_node_p = new GarbageNode;
-      garbage_node_p->node_p = node_p;
-
-      garbage_node_p->next_p = epoch_p->garbage_list_p.load();
-
-      while(1) {
-        // Then CAS previous node with new garbage node
-        // If this fails, then garbage_node_p->next_p is the actual value
-        // of garbage_list_p, in which case we do not need to load it again
-        bool ret = \
-          epoch_p->garbage_list_p.compare_exchange_strong(garbage_node_p->next_p,
-                                                          garbage_node_p);
-
-        // If CAS succeeds then just return
-        if(ret == true) {
-          break;
-        } else {
-          bwt_printf("Add garbage node CAS failed. Retry\n");
-        }
-      } // while 1
+    inline EpochNode *JoinEpoch() {
+      peloton::EpochReclaimer::GetInstance().Enter();
 
-      return;
+      return nullptr;
     }
 
     /*
-     * JoinEpoch() - Let current thread join this epoch
-     *
-     * The effect is that all memory deallocated on and after
-     * current epoch will not be freed before current thread leaves
-     *
-     * NOTE: It is possible that prev_count < 0, because in ClearEpoch()
-     * the cleaner thread will decrease the epoch counter by a large amount
-     * to prevent this function using an epoch currently being recycled
+     * LeaveEpoch() - Leave the epoch joined by JoinEpoch()
      */
-    inline EpochNode *JoinEpoch() {
-try_join_again:
-      // We must make sure the epoch we join and the epoch we
-      // return are the same one because the current point
-      // could change in the middle of this function
-      EpochNode *epoch_p = current_epoch_p;
-
-      int64_t prev_count = epoch_p->active_thread_count.fetch_add(1);
-
-      // We know epoch_p is now being cleaned, so need to read the
-      // current epoch again because it must have been moved
-      if(prev_count < 0) {
-        // Consider the following sequence:
-        //   0. Start with counter = 0
-        //   1. Worker thread 1 fetch_add() -> return 0, OK
-        //   2. GC thread fetch_sub() -> return positive, abort!
-        //   3. Worker thread 2 fetch_add() -> return negative, retry!
-        //   4. GC thread fetch_add() and aborts
-        //   5. Worker thread 2 retries, and fetch_add() -> return 1, OK
-        // This way the second worker thread actually incremented the epoch
-        // counter twice
-        epoch_p->active_thread_count.fetch_sub(1);
-        
-        goto try_join_again;
-      }
-
-      #ifdef BWTREE_DEBUG
-      epoch_join.fetch_add(1);
-      #endif
+    inline void LeaveEpoch(EpochNode *epoch_p) {
+      peloton::EpochReclaimer::GetInstance().Exit();
 
-      return epoch_p;
+      (void)epoch_p;
+      return;
     }
 
     /*
-     * LeaveEpoch() - Leave epoch a thread has once joined
+     * PerformGarbageCollection() - Advance the epoch and free all retired
+     *                              nodes no thread could access anymore
      *
-     * After an epoch has been cleared all memories allocated on
-     * and before that epoch could safely be deallocated
+     * This frees garbage of other structures sharing the reclaimer as well
      */
-    inline void LeaveEpoch(EpochNode *epoch_p) {
-      // This might return a negative value if the current epoch
-      // is being cleaned
-      epoch_p->active_thread_count.fetch_sub(1);
-
-      #ifdef BWTREE_DEBUG
-      epoch_leave.fetch_add(1);
-      #endif
+    inline void PerformGarbageCollection() {
+      peloton::EpochReclaimer::GetInstance().ReclaimAll();
 
       return;
     }
-    
+
     /*
-     * PerformGarbageCollection() - Actual job of GC is done here
+     * ClearGarbage() - Free all garbage nodes of this tree right away
      *
-     * We need to separate the GC loop and actual GC routine to enable
-     * external threads calling the function while also allows BwTree maintains
-     * its own GC thread using the loop
+     * This must be called when no thread accesses the tree anymore
      */
-    void PerformGarbageCollection() {
-      ClearEpoch();
-      CreateNewEpoch();
-      
+    void ClearGarbage() {
+      peloton::EpochReclaimer::GetInstance().ReclaimOwner(this);
+
       return;
     }
 
-#else  // #ifdef USE_OLD_EPOCH
-
     /*
-     * AddGarbageNode() - This encapsulates BwTree::AddGarbageNode()
+     * FreeGarbageNode() - Callback of the reclaimer to free a retired chain
      */
-    inline void AddGarbageNode(const BaseNode *node_p) {
-      tree_p->AddGarbageNode(node_p); 
-      
-      return;
-    }
-    
-    inline EpochNode *JoinEpoch() {
-      tree_p->UpdateLastActiveEpoch();
-      
-      return nullptr;
-    }
-    
-    inline void LeaveEpoch(EpochNode *epoch_p) {
-      tree_p->UpdateLastActiveEpoch();
-      
-      (void)epoch_p;
-      return;
-    }
-    
-    inline void PerformGarbageCollection() {
-      tree_p->IncreaseEpoch();
-      
+    static void FreeGarbageNode(void *node_p, void *epoch_manager_p) {
+      static_cast<EpochManager *>(epoch_manager_p)->FreeEpochDeltaChain(
+          static_cast<const BaseNode *>(node_p));
+
       return;
     }
-    
-#endif // #ifdef USE_OLD_EPOCH
 
     /*
      * FreeEpochDeltaChain() - Free a delta chain (used by EpochManager)
@@ -8352,100 +7655,6 @@ try_join_again:
       return;
     }
 
-    /*
-     * ClearEpoch() - Sweep the chain of epoch and free memory
-     *
-     * The minimum number of epoch we must maintain is 1 which means
-     * when current epoch is the head epoch we should stop scanning
-     *
-     * NOTE: There is no race condition in this function since it is
-     * only called by the cleaner thread
-     */
-    void ClearEpoch() {
-      bwt_printf("Start to clear epoch\n");
-
-      while(1) {
-        // Even if current_epoch_p is nullptr, this should work
-        if(head_epoch_p == current_epoch_p) {
-          bwt_printf("Current epoch is head epoch. Do not clean\n");
-
-          break;
-        }
-
-        // Since it could only be acquired and released by worker thread
-        // the value must be >= 0
-        int active_thread_count = head_epoch_p->active_thread_count.load();
-        assert(active_thread_count >= 0);
-
-        // If we have seen an epoch whose count is not zero then all
-        // epochs after that are protected and we stop
-        if(active_thread_count != 0) {
-          bwt_printf("Head epoch is not empty. Return\n");
-
-          break;
-        }
-
-        // If some thread joins the epoch between the previous branch
-        // and the following fetch_sub(), then fetch_sub() returns a positive
-        // number, which is the number of threads that have joined the epoch
-        // since last epoch counter testing.
-
-        if(head_epoch_p->active_thread_count.fetch_sub(MAX_THREAD_COUNT) > 0) {
-          bwt_printf("Some thread sneaks in after we have decided"
-                     " to clean. Return\n");
-
-          // Must add it back to let the next round of cleaning correctly
-          // identify empty epoch
-          head_epoch_p->active_thread_count.fetch_add(MAX_THREAD_COUNT);
-
-          break;
-        }
-
-        // After this point all fetch_add() on the epoch counter would return
-        // a negative value which will cause re-read of current_epoch_p
-        // to prevent joining an epoch that is being deleted
-
-        // If the epoch has cleared we just loop through its garbage chain
-        // and then free each delta chain
-
-        const GarbageNode *next_garbage_node_p = nullptr;
-
-        // Walk through its garbage chain
-        for(const GarbageNode *garbage_node_p = head_epoch_p->garbage_list_p.load();
-            garbage_node_p != nullptr;
-            garbage_node_p = next_garbage_node_p) {
-          FreeEpochDeltaChain(garbage_node_p->node_p);
-
-          // Save the next pointer so that we could
-          // delete current node directly
-          next_garbage_node_p = garbage_node_p->next_p;
-
-          // This invalidates any further reference to its
-          // members (so we saved next pointer above)
-          delete garbage_node_p;
-        } // for
-
-        // First need to save this in order to delete current node
-        // safely
-        EpochNode *next_epoch_node_p = head_epoch_p->next_p;
-
-        delete head_epoch_p;
-
-        #ifdef BWTREE_DEBUG
-        epoch_freed++;
-        #endif
-
-        // Then advance to the next epoch
-        // It is possible that head_epoch_p becomes nullptr
-        // this happens during destruction, and should not
-        // cause any problem since that case we also set current epoch
-        // pointer to nullptr
-        head_epoch_p = next_epoch_node_p;
-      } // while(1) through epoch nodes
-
-      return;
-    }
-
     /*
      * ThreadFunc() - The cleaner thread executes this every GC_INTERVAL ms
      *
@@ -8482,6 +7691,27 @@ try_join_again:
       return;
     }
 
+    /*
+     * StopThread() - Stop the cleaner thread if it has been started
+     */
+    void StopThread() {
+      exited_flag.store(true);
+
+      if(thread_p != nullptr) {
+        bwt_printf("Waiting for thread\n");
+
+        thread_p->join();
+
+        // Free memory
+        delete thread_p;
+        thread_p = nullptr;
+
+        bwt_printf("Thread stops\n");
+      }
+
+      return;
+    }
+
   }; // Epoch manager
 
   /*
@@ -9370,88 +8600,6 @@ try_join_again:
       return;
     }
   }; // ForwardIterator
-  
-  /*
-   * AddGarbageNode() - Adds a garbage node into the thread-local GC context
-   *
-   * Since the thread local GC context is only accessed by this thread, this
-   * process does not require any atomicity 
-   *
-   * This is always called by the thread owning thread local data, so we
-   * do not have to worry about thread identity issues
-   */
-  void AddGarbageNode(const BaseNode *node_p) {
-    GarbageNode *garbage_node_p = \
-      new GarbageNode{GetGlobalEpoch(), (void *)(node_p)};
-    assert(garbage_node_p != nullptr);
-    
-    // Link this new node to the end of the linked list
-    // and then update last_p
-    GetCurrentGCMetaData()->last_p->next_p = garbage_node_p;
-    GetCurrentGCMetaData()->last_p = garbage_node_p;
-    
-    // Update the counter 
-    GetCurrentGCMetaData()->node_count++;
-    
-    // It is possible that we could not free enough number of nodes to
-    // make it less than this threshold
-    // So it is important to let the epoch counter be constantly increased
-    // to guarantee progress
-    if(GetCurrentGCMetaData()->node_count > GC_NODE_COUNT_THREADHOLD) {
-      // Use current thread's gc id to perform GC
-      PerformGC(gc_id);
-    }
-    
-    return;
-  }
-  
-  /*
-   * PerformGC() - This function performs GC on the current thread's garbage 
-   *               chain using the call back function
-   *
-   * Note that this function only collects for the current thread. Therefore
-   * this function does not have to be atomic since its 
-   *
-   * Note that this function should be used with thread_id, since it will
-   * also be called inside the destructor - so we could not rely on
-   * GetCurrentGCMetaData()
-   */
-  void PerformGC(int thread_id) {
-    // First of all get the minimum epoch of all active threads
-    // This is the upper bound for deleted epoch in garbage node
-    uint64_t min_epoch = SummarizeGCEpoch();
-    
-    // This is the pointer we use to perform GC
-    // Note that we only fetch the metadata using the current thread-local id
-    GarbageNode *header_p = &GetGCMetaData(thread_id)->header; 
-    GarbageNode *first_p = header_p->next_p;
-    
-    // Then traverse the linked list
-    // Only reclaim memory when the deleted epoch < min epoch
-    while(first_p != nullptr && \
-          first_p->delete_epoch < min_epoch) {
-      // First unlink the current node from the linked list
-      // This could set it to nullptr
-      header_p->next_p = first_p->next_p;
-      
-      // Then free memory
-      epoch_manager.FreeEpochDeltaChain((const BaseNode *)first_p->node_p);
-      
-      delete first_p;
-      assert(GetGCMetaData(thread_id)->node_count != 0UL);
-      GetGCMetaData(thread_id)->node_count--;
-      
-      first_p = header_p->next_p;
-    }
-    
-    // If we have freed all nodes in the linked list we should 
-    // reset last_p to the header
-    if(first_p == nullptr) {
-      GetGCMetaData(thread_id)->last_p = header_p;
-    }
-    
-    return;
-  }
 
 }; // class BwTree
 
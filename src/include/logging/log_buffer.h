@@ -30,15 +30,10 @@ private:
   const static size_t log_buffer_capacity_ = 1024 * 1024 * 32; // 32 MB
 
 public:
-  LogBuffer(const size_t thread_id, const size_t eid) : 
-      thread_id_(thread_id), eid_(eid), size_(0){
-    data_ = new char[log_buffer_capacity_];
-    PL_MEMSET(data_, 0, log_buffer_capacity_);
-  }
-  ~LogBuffer() {
-    delete[] data_;
-    data_ = nullptr;
-  }
+  // The buffer is placed on the NUMA node of the worker that creates it
+  LogBuffer(const size_t thread_id, const size_t eid);
+
+  ~LogBuffer();
 
   inline void Reset() { size_ = 0; eid_ = INVALID_EID; }
 
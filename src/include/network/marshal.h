@@ -21,21 +21,40 @@
 
 #define BUFFER_INIT_SIZE 100
 
+// Most socket buffers a network thread keeps for its connections to reuse
+#define BUFFER_POOL_SIZE 64
+
+// Size at which a packet of batched messages, such as the data rows of a
+// result, is queued and a new one is started
+#define RESPONSE_BATCH_SIZE (64 * 1024)
+
 namespace peloton {
 namespace network {
 
-// Buffers used to batch messages at the socket
+// Buffers used to batch messages at the socket. The memory of the buffer is
+// only held while the connection has data in flight, an idle connection
+// gives it back to the pool of its network thread.
 struct Buffer {
   size_t buf_ptr;        // buffer cursor
   size_t buf_size;       // buffer size
   size_t buf_flush_ptr;  // buffer cursor for write
   ByteBuf buf;
 
-  inline Buffer() : buf_ptr(0), buf_size(0), buf_flush_ptr(0) {
-    // capacity of the buffer
-    buf.reserve(SOCKET_BUFFER_SIZE);
+  inline Buffer() : buf_ptr(0), buf_size(0), buf_flush_ptr(0) {}
+
+  // Make sure the buffer has its memory before it is used
+  inline void Acquire() {
+    if (buf.capacity() == 0) {
+      AcquireMemory();
+    }
   }
 
+  // Reset the buffer and give its memory back to the pool
+  void Release();
+
+  // Bytes of memory held by the buffer
+  inline size_t GetMemoryUsage() const { return buf.capacity(); }
+
   inline void Reset() {
     buf_ptr = 0;
     buf_size = 0;
@@ -62,6 +81,10 @@ struct Buffer {
   inline bool IsReadDataAvailable(size_t bytes) {
     return ((buf_ptr - 1) + bytes < buf_size);
   }
+
+ private:
+  // Take memory from the pool of the calling thread, or allocate it
+  void AcquireMemory();
 };
 
 class InputPacket {
@@ -95,7 +118,8 @@ class InputPacket {
     is_initialized = header_parsed = is_extended = false;
     len = ptr = 0;
     msg_type = NetworkMessageType::NULL_COMMAND;
-    extended_buffer_.clear();
+    // packets rarely need it, so do not keep the memory around
+    ByteBuf().swap(extended_buffer_);
   }
 
   inline void ReserveExtendedBuffer() {
@@ -130,6 +154,9 @@ class InputPacket {
   ByteBuf::const_iterator Begin() { return begin; }
 
   ByteBuf::const_iterator End() { return end; }
+
+  // Bytes of memory held by the packet
+  inline size_t GetMemoryUsage() const { return extended_buffer_.capacity(); }
 };
 
 struct OutputPacket {
@@ -184,6 +211,15 @@ extern void PacketPutCbytes(OutputPacket *pkt, const uchar *b, int len);
 /* packet_put_bytes - used to write a uchar vector into a packet */
 extern void PacketPutBytes(OutputPacket *pkt, const std::vector<uchar> &data);
 
+/* packet_begin_message - used to start a complete message (type, size,
+ * contents) inside a packet whose header is not written. Returns the offset
+ * of the size field for PacketEndMessage. */
+extern size_t PacketBeginMessage(OutputPacket *pkt, NetworkMessageType type);
+
+/* packet_end_message - used to fill in the size of a message once all of
+ * its contents are in the packet */
+extern void PacketEndMessage(OutputPacket *pkt, size_t size_offset);
+
 /*
 * Unmarshallers
 */
@@ -67,6 +67,7 @@ class NetworkConnection {
   unsigned int next_response_ = 0;  // The next response in the response buffer
   Client client_;
   bool ssl_sent_ = false;
+  short registered_flags_ = 0;      // Flags the network event is added with
 
 
  public:
@@ -100,6 +101,10 @@ class NetworkConnection {
 
   void Reset();
 
+  // Approximate bytes of memory held by the connection. The prepared
+  // statements and their plans are not counted.
+  size_t GetMemoryUsage() const;
+
   static void TriggerStateMachine(void* arg);
 
   /* Runs the state machine for the protocol. Invoked by event handler callback */
@@ -110,6 +115,9 @@ class NetworkConnection {
 
   ProcessResult ProcessInitial();
 
+  // Give the memory of the socket buffers back while they are empty
+  void ReleaseIdleBuffers();
+
   // Extracts the header of a Postgres start up packet from the read socket buffer
   static bool ReadStartupPacketHeader(Buffer &rbuf, InputPacket &rpkt);
 
@@ -129,8 +137,11 @@ class NetworkConnection {
   WriteState BufferWriteBytesContent(OutputPacket *pkt);
 
   // Used to invoke a write into the Socket, returns false if the socket is not
-  // ready for write
-  WriteState FlushWriteBuffer();
+  // ready for write. The next pkt_bytes of the packet's content are written
+  // after the buffered bytes in the same call. If more data follows, the
+  // kernel may hold back a partial segment until the final flush.
+  WriteState FlushWriteBuffer(OutputPacket *pkt = nullptr,
+                              size_t pkt_bytes = 0, bool more_data = false);
 
   /* Set the socket to non-blocking mode */
   inline void SetNonBlocking(evutil_socket_t fd) {
@@ -28,8 +28,7 @@ class NetworkMasterThread : public NetworkThread {
  private:
   const int num_threads_;
 
-  // TODO: have a smarter dispatch scheduler
-  std::atomic<int> next_thread_id_;  // next thread we dispatched to
+  std::atomic<int> next_thread_id_;  // first thread tried by the next dispatch
 
  public:
   NetworkMasterThread(const int num_threads, struct event_base *libevent_base);
@@ -22,6 +22,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <atomic>
 #include <vector>
 
 #include <sys/file.h>
@@ -58,6 +59,9 @@ class NetworkThread {
   bool is_closed = false;
   int sock_fd = -1;
 
+  // Number of open connections dispatched to this thread
+  std::atomic<int> connection_count_{0};
+
  public:
   NetworkThread(const int thread_id, struct event_base *libevent_base)
       : thread_id_(thread_id), libevent_base_(libevent_base) {
@@ -86,6 +90,12 @@ class NetworkThread {
   int GetThreadSockFd() { return sock_fd; }
 
   void SetThreadSockFd(int fd) { this->sock_fd = fd; }
+
+  int GetConnectionCount() const { return connection_count_.load(); }
+
+  void AddConnection() { connection_count_++; }
+
+  void RemoveConnection() { connection_count_--; }
 };
 
 }  // namespace network
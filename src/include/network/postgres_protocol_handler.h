@@ -30,6 +30,10 @@
 
 namespace peloton {
 
+namespace planner {
+class CopyPlan;
+}
+
 namespace network {
 
 typedef std::vector<std::unique_ptr<OutputPacket>> ResponseBuffer;
@@ -43,6 +47,8 @@ class PostgresProtocolHandler: public ProtocolHandler {
 
   ProcessResult Process(Buffer &rbuf, const size_t thread_id);
 
+  size_t GetMemoryUsage() const;
+
   /* Main switch case wrapper to process every packet apart from the startup
    * packet. Avoid flushing the response for extended protocols. */
   ProcessResult ProcessPacket(InputPacket* pkt, const size_t thread_id);
@@ -147,12 +153,29 @@ class PostgresProtocolHandler: public ProtocolHandler {
   /* Process the EXECUTE message of the extended query protocol */
   ProcessResult ExecExecuteMessage(InputPacket* pkt, const size_t thread_id);
 
+  /* Run the EXECUTE messages queued since the last run as one pipeline */
+  ProcessResult ExecPipeline(const size_t thread_id);
+
   /* Process the optional CLOSE message of the extended query protocol */
   void ExecCloseMessage(InputPacket* pkt);
 
+  /* Ask the client to stream the data of a COPY FROM STDIN */
+  void SendCopyInResponse(const planner::CopyPlan* copy_plan);
+
+  /* Buffer a chunk of COPY FROM STDIN data */
+  void ExecCopyDataMessage(InputPacket* pkt);
+
+  /* Run the pending COPY FROM STDIN once all the data is in */
+  ProcessResult ExecCopyDoneMessage(const size_t thread_id);
+
+  /* Abort the pending COPY FROM STDIN on the client's request */
+  void ExecCopyFailMessage(InputPacket* pkt);
+
   void ExecExecuteMessageGetResult(ResultType status);
 
   void ExecQueryMessageGetResult(ResultType status);
+
+  void ExecPipelineGetResult();
   //===--------------------------------------------------------------------===//
   // MEMBERS
   //===--------------------------------------------------------------------===//
@@ -168,6 +191,10 @@ class PostgresProtocolHandler: public ProtocolHandler {
   // global txn state
   NetworkTransactionStateType txn_state_;
 
+  // Set when a message of the extended protocol fails. The client discards
+  // everything up to its SYNC, so the messages until then are ignored.
+  bool ignore_until_sync_ = false;
+
   // state to mang skipped queries
   bool skipped_stmt_ = false;
   std::string skipped_query_string_;
@@ -218,6 +245,22 @@ class PostgresProtocolHandler: public ProtocolHandler {
   //TODO: should this stay in traffic_cop?
   std::string query_;
 
+  // Statements of the EXECUTE messages queued for the next pipeline
+  std::vector<tcop::PipelinedStatement> pipeline_;
+
+  // Number of responses buffered when each statement of the pipeline was
+  // queued, its results go right after them
+  std::vector<size_t> pipeline_offsets_;
+
+  // Whether we are receiving the data of a COPY FROM STDIN
+  bool copy_in_progress_ = false;
+
+  // Data received so far for the pending COPY FROM STDIN
+  std::string copy_data_;
+
+  // The COPY FROM STDIN being executed, which holds on to the data
+  planner::CopyPlan *copy_plan_ = nullptr;
+
   //===--------------------------------------------------------------------===//
   // STATIC DATA
   //===--------------------------------------------------------------------===//
@@ -43,6 +43,9 @@ class ProtocolHandler {
 
   virtual void GetResult();
 
+  // Bytes of memory held by the handler
+  virtual size_t GetMemoryUsage() const;
+
   // Should we send the buffered packets right away?
   bool force_flush = false;
 
@@ -50,11 +53,28 @@ class ProtocolHandler {
   // so that we don't have to new packet each time
   ResponseBuffer responses;
 
+  /* Get an empty packet for a batch of complete messages. Its header is not
+   * written, and its buffer is reused from a previous batch of the thread if
+   * possible. */
+  std::unique_ptr<OutputPacket> GetBatchPacket();
+
+  /* Drop the responses after they have been written, keeping the buffers of
+   * batch packets for reuse */
+  void RecycleResponses();
+
   InputPacket request;                // Used for reading a single request
 
   // The traffic cop used for this connection
   tcop::TrafficCop* traffic_cop_;
 
+ protected:
+  // Bytes of memory held by the buffered responses and the request
+  size_t GetBufferMemoryUsage() const;
+
+ private:
+  // Most batch packets a thread keeps for reuse
+  static const size_t MAX_BATCH_PACKET_POOL_SIZE = 8;
+
 };
 
 }  // namespace network
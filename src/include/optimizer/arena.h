@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// arena.h
+//
+// Identification: src/include/optimizer/arena.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace peloton {
+namespace optimizer {
+
+//===--------------------------------------------------------------------===//
+// Arena
+//===--------------------------------------------------------------------===//
+
+/**
+ * Bump allocator for the objects of one optimization.
+ *
+ * Objects are carved out of large blocks and are never freed one by one.
+ * Reset() runs their destructors and releases all memory at once, except
+ * for the first block, which the next optimization reuses. Not thread-safe.
+ */
+class Arena {
+ public:
+  static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+  Arena();
+
+  ~Arena();
+
+  // Construct an object in the arena. It lives until the next Reset().
+  template <typename T, typename... Args>
+  T *New(Args &&... args) {
+    void *address = Allocate(sizeof(T), alignof(T));
+    T *object = new (address) T(std::forward<Args>(args)...);
+    if (std::is_trivially_destructible<T>::value == false) {
+      destructors_.emplace_back(object, &Destroy<T>);
+    }
+    return object;
+  }
+
+  // Uninitialized memory with the given alignment
+  void *Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+  // Destroy all objects and release all memory but the first block
+  void Reset();
+
+  // Bytes handed out since the last Reset()
+  size_t GetAllocatedBytes() const { return allocated_bytes_; }
+
+  size_t GetBlockCount() const {
+    return blocks_.size() + (first_block_ != nullptr ? 1 : 0);
+  }
+
+ private:
+  DISALLOW_COPY_AND_MOVE(Arena);
+
+  template <typename T>
+  static void Destroy(void *object) {
+    static_cast<T *>(object)->~T();
+  }
+
+  // A block to continue allocating from
+  char *NextBlock();
+
+  // The first regular block, kept across resets. Large allocations never
+  // take its place.
+  std::unique_ptr<char[]> first_block_;
+
+  // All other blocks, released on Reset()
+  std::vector<std::unique_ptr<char[]>> blocks_;
+
+  // Unused part of the current block
+  char *current_ = nullptr;
+
+  size_t remaining_ = 0;
+
+  // Whether the first block is handed out since the last Reset()
+  bool first_block_used_ = false;
+
+  // Objects to destroy on Reset(), in construction order
+  std::vector<std::pair<void *, void (*)(void *)>> destructors_;
+
+  size_t allocated_bytes_ = 0;
+};
+
+}  // namespace optimizer
+}  // namespace peloton
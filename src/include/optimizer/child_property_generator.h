@@ -29,8 +29,7 @@ class ChildPropertyGenerator : public OperatorVisitor {
   ChildPropertyGenerator(ColumnManager &manager) : manager_(manager) {}
 
   std::vector<std::pair<PropertySet, std::vector<PropertySet>>> GetProperties(
-      std::shared_ptr<GroupExpression> gexpr, PropertySet requirements,
-      Memo *memo);
+      GroupExpression *gexpr, const PropertySet &requirements, Memo *memo);
 
   void Visit(const DummyScan *) override;
   void Visit(const PhysicalSeqScan *) override;
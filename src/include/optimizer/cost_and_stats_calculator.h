@@ -28,8 +28,7 @@ class CostAndStatsCalculator : public OperatorVisitor {
   CostAndStatsCalculator(ColumnManager &manager) : manager_(manager) {}
 
   void CalculateCostAndStats(
-      std::shared_ptr<GroupExpression> gexpr,
-      const PropertySet *output_properties,
+      GroupExpression *gexpr, const PropertySet *output_properties,
       const std::vector<PropertySet> *input_properties_list,
       std::vector<std::shared_ptr<Stats>> child_stats,
       std::vector<double> child_costs);
@@ -70,7 +69,7 @@ class CostAndStatsCalculator : public OperatorVisitor {
 
   // We cannot use reference here because otherwise we have to initialize them
   // when constructing the class
-  std::shared_ptr<GroupExpression> gexpr_;
+  GroupExpression *gexpr_;
   const PropertySet *output_properties_;
   const std::vector<PropertySet> *input_properties_list_;
   std::vector<std::shared_ptr<Stats>> child_stats_;
@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// fast_path_planner.h
+//
+// Identification: src/include/optimizer/fast_path_planner.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+namespace peloton {
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace expression {
+class AbstractExpression;
+}
+
+namespace parser {
+class DeleteStatement;
+class SelectStatement;
+class SQLStatement;
+class UpdateStatement;
+}
+
+namespace planner {
+class AbstractPlan;
+}
+
+namespace storage {
+class DataTable;
+}
+
+namespace optimizer {
+
+//===--------------------------------------------------------------------===//
+// Fast Path Planner
+//===--------------------------------------------------------------------===//
+
+/**
+ * Plans the point and range statements of OLTP workloads without a search.
+ *
+ * A single-table SELECT of plain columns, UPDATE or DELETE qualifies if its
+ * WHERE clause is a conjunction of comparisons between a column and a
+ * constant or parameter, and constrains the first key column of an index.
+ * It gets the same index scan the optimizer builds, below an update or
+ * delete if needed. Every other statement is left to the optimizer.
+ */
+class FastPathPlanner {
+ public:
+  explicit FastPathPlanner(concurrency::Transaction *txn) : txn_(txn) {}
+
+  // Plan of a bound statement, or nullptr if it does not qualify
+  std::unique_ptr<planner::AbstractPlan> BuildPlan(parser::SQLStatement *tree);
+
+  // Whether a predicate only consists of ANDed comparisons between a column
+  // and a constant or parameter
+  static bool IsSimplePredicate(
+      const expression::AbstractExpression *predicate);
+
+ private:
+  std::unique_ptr<planner::AbstractPlan> BuildSelectPlan(
+      parser::SelectStatement *select_stmt);
+
+  std::unique_ptr<planner::AbstractPlan> BuildUpdatePlan(
+      parser::UpdateStatement *update_stmt);
+
+  std::unique_ptr<planner::AbstractPlan> BuildDeletePlan(
+      parser::DeleteStatement *delete_stmt);
+
+  // Index scan satisfying the required properties of the statement, or
+  // nullptr if the predicate does not match an index prefix
+  std::unique_ptr<planner::AbstractPlan> BuildIndexScanPlan(
+      storage::DataTable *table, const std::string &table_alias,
+      expression::AbstractExpression *predicate, bool is_for_update,
+      parser::SQLStatement *tree);
+
+  concurrency::Transaction *txn_;
+};
+
+}  // namespace optimizer
+}  // namespace peloton
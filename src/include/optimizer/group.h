@@ -37,14 +37,19 @@ class Group {
   // If the GroupExpression is generated by applying a
   // property enforcer, we add them to enforced_exprs_
   // which will not be enumerated during OptimizeExpression
-  void AddExpression(std::shared_ptr<GroupExpression> expr, bool enforced);
+  void AddExpression(GroupExpression *expr, bool enforced);
 
-  void SetExpressionCost(std::shared_ptr<GroupExpression> expr, double cost,
-                         PropertySet properties);
+  void SetExpressionCost(GroupExpression *expr, double cost,
+                         const PropertySet &properties);
 
-  std::shared_ptr<GroupExpression> GetBestExpression(PropertySet properties);
+  GroupExpression *GetBestExpression(const PropertySet &properties);
 
-  const std::vector<std::shared_ptr<GroupExpression>> &GetExpressions() const;
+  const std::vector<GroupExpression *> &GetExpressions() const;
+
+  // Whether an implementation rule has produced a physical expression
+  inline bool HasPhysicalExpressions() const {
+    return has_physical_expressions_;
+  }
 
   inline const std::unordered_set<std::string> &GetTableAliases() const {
     return table_aliases_;
@@ -61,10 +66,10 @@ class Group {
   // All the table alias this group represents. This will not change once create
   std::unordered_set<std::string> table_aliases_;
   std::vector<Operator> items_;
-  std::vector<std::shared_ptr<GroupExpression>> expressions_;
-  std::vector<std::shared_ptr<GroupExpression>> enforced_exprs_;
-  std::unordered_map<PropertySet,
-                     std::tuple<double, std::shared_ptr<GroupExpression>>>
+  // The expressions are owned by the arena of the memo
+  std::vector<GroupExpression *> expressions_;
+  std::vector<GroupExpression *> enforced_exprs_;
+  std::unordered_map<PropertySet, std::tuple<double, GroupExpression *>>
       lowest_cost_expressions_;
 
   // Whether equivalent logical expressions have been explored for this group
@@ -72,6 +77,8 @@ class Group {
 
   // Whether physical operators have been implemented for this group
   bool has_implemented_;
+
+  bool has_physical_expressions_;
 };
 
 } // namespace optimizer
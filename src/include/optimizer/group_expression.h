@@ -40,11 +40,12 @@ class GroupExpression {
 
   Operator Op() const;
 
-  std::shared_ptr<Stats> GetStats(PropertySet requirements) const;
+  std::shared_ptr<Stats> GetStats(const PropertySet &requirements) const;
 
-  double GetCost(PropertySet requirements) const;
+  double GetCost(const PropertySet &requirements) const;
 
-  std::vector<PropertySet> GetInputProperties(PropertySet requirements) const;
+  const std::vector<PropertySet> &GetInputProperties(
+      const PropertySet &requirements) const;
 
   void SetLocalHashTable(const PropertySet &output_properties,
                          const std::vector<PropertySet> &input_properties_list,
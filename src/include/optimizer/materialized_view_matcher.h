@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// materialized_view_matcher.h
+//
+// Identification: src/include/optimizer/materialized_view_matcher.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+
+namespace catalog {
+class Schema;
+}
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace expression {
+class AbstractExpression;
+}
+
+namespace parser {
+class SelectStatement;
+class SQLStatement;
+}
+
+namespace planner {
+class AbstractPlan;
+}
+
+namespace storage {
+class MaterializedView;
+}
+
+namespace optimizer {
+
+//===--------------------------------------------------------------------===//
+// Materialized View Matcher
+//===--------------------------------------------------------------------===//
+
+/**
+ * Answers aggregate queries from the materialized views over their table.
+ *
+ * A single-table SELECT qualifies if it groups by exactly the group columns
+ * of a view, has no HAVING, DISTINCT, ORDER BY or LIMIT, selects only group
+ * columns and aggregates the view keeps, and its WHERE clause, if any, is a
+ * conjunction of equalities between group columns and constants or
+ * parameters. It then reads the matching groups of the view instead of
+ * scanning and aggregating the table.
+ *
+ * Only transactions that MaterializedView::CanRead() views are answered
+ * from them: READ COMMITTED and snapshot transactions that have not written
+ * anything. Others are left to the optimizer.
+ */
+class MaterializedViewMatcher {
+ public:
+  explicit MaterializedViewMatcher(concurrency::Transaction *txn)
+      : txn_(txn) {}
+
+  // Plan of a bound statement, or nullptr if no view answers it
+  std::unique_ptr<planner::AbstractPlan> BuildPlan(parser::SQLStatement *tree);
+
+ private:
+  // Plan reading the given view, or nullptr if it cannot answer the query
+  std::unique_ptr<planner::AbstractPlan> BuildViewScanPlan(
+      parser::SelectStatement *select_stmt,
+      std::shared_ptr<storage::MaterializedView> view,
+      const catalog::Schema *schema);
+
+  // Collect the group offsets and values of the equalities of a WHERE
+  // clause. Returns false if it is anything else.
+  static bool GetKeys(const expression::AbstractExpression *predicate,
+                      const catalog::Schema *schema,
+                      const storage::MaterializedView *view,
+                      std::vector<oid_t> &key_offsets,
+                      std::vector<type::Value> &key_values);
+
+ private:
+  concurrency::Transaction *txn_;
+};
+
+}  // namespace optimizer
+}  // namespace peloton
@@ -17,20 +17,19 @@
 #include <vector>
 
 #include "operator_expression.h"
+#include "optimizer/arena.h"
 #include "optimizer/group.h"
 
 namespace peloton {
 namespace optimizer {
 
 struct GExprPtrHash {
-  std::size_t operator()(std::shared_ptr<GroupExpression> const& s) const {
-    return s->Hash();
-  }
+  std::size_t operator()(GroupExpression* const& s) const { return s->Hash(); }
 };
 
 struct GExprPtrEq {
-  bool operator()(std::shared_ptr<GroupExpression> const& t1,
-                  std::shared_ptr<GroupExpression> const& t2) const {
+  bool operator()(GroupExpression* const& t1,
+                  GroupExpression* const& t2) const {
     return *t1 == *t2;
   }
 };
@@ -38,6 +37,8 @@ struct GExprPtrEq {
 //===--------------------------------------------------------------------===//
 // Memo
 //===--------------------------------------------------------------------===//
+// Groups and group expressions are allocated from an arena and freed all at
+// once by Reset(), so pointers to them stay valid for a whole optimization.
 class Memo {
  public:
   Memo();
@@ -45,28 +46,40 @@ class Memo {
   /* InsertExpression - adds a group expression into the proper group in the
    * memo, checking for duplicates
    *
-   * expr: the new expression to add
+   * gexpr: the candidate expression, its group id is set to the group it
+   *     belongs to. A new expression is moved into the memo.
    * enforced: if the new expression is created by enforcer
    * target_group: an optional target group to insert expression into
-   * return: existing expression if found. Otherwise, return the new expr
+   * inserted: set to whether the expression was new
+   * return: the expression in the memo, nullptr for a leaf
    */
-  std::shared_ptr<GroupExpression> InsertExpression(
-      std::shared_ptr<GroupExpression> gexpr, bool enforced);
+  GroupExpression* InsertExpression(GroupExpression* gexpr, bool enforced);
+
+  GroupExpression* InsertExpression(GroupExpression* gexpr,
+                                    GroupID target_group, bool enforced);
 
-  std::shared_ptr<GroupExpression> InsertExpression(
-      std::shared_ptr<GroupExpression> gexpr, GroupID target_group,
-      bool enforced);
+  GroupExpression* InsertExpression(GroupExpression* gexpr,
+                                    GroupID target_group, bool enforced,
+                                    bool& inserted);
 
-  const std::vector<Group>& Groups() const;
+  const std::vector<Group*>& Groups() const;
 
   Group* GetGroupByID(GroupID id);
 
+  // Drop all groups and expressions
+  void Reset();
+
+  // Memory used by the groups and expressions
+  size_t GetAllocatedBytes() const { return arena_.GetAllocatedBytes(); }
+
  private:
-  GroupID AddNewGroup(std::shared_ptr<GroupExpression> gexpr);
+  GroupID AddNewGroup(GroupExpression* gexpr);
+
+  Arena arena_;
 
-  std::unordered_set<std::shared_ptr<GroupExpression>, GExprPtrHash, GExprPtrEq>
+  std::unordered_set<GroupExpression*, GExprPtrHash, GExprPtrEq>
       group_expressions_;
-  std::vector<Group> groups_;
+  std::vector<Group*> groups_;
 };
 
 } // namespace optimizer
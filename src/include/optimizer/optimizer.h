@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 
 #include "optimizer/abstract_optimizer.h"
@@ -63,6 +64,9 @@ class Optimizer : public AbstractOptimizer {
 
   void Reset() override;
 
+  // Rule applications of the last optimization
+  size_t GetRuleApplicationCount() const { return rule_application_count_; }
+
  private:
   /* HandleDDLStatement - Check and handle DDL statment (currently only support
    *CREATE), set
@@ -80,8 +84,8 @@ class Optimizer : public AbstractOptimizer {
    * tree: a peloton query tree representing a select query
    * return: the root group expression for the inserted query
    */
-  std::shared_ptr<GroupExpression> InsertQueryTree(parser::SQLStatement *tree,
-                                                   concurrency::Transaction *txn);
+  GroupExpression *InsertQueryTree(parser::SQLStatement *tree,
+                                   concurrency::Transaction *txn);
 
   /* GetQueryTreeRequiredProperties - get the required physical properties for
    * a peloton query tree.
@@ -125,7 +129,7 @@ class Optimizer : public AbstractOptimizer {
    * requirements: the set of requirements the optimal physical operator tree
    *     must fulfill
    */
-  void OptimizeGroup(GroupID id, PropertySet requirements);
+  void OptimizeGroup(GroupID id, const PropertySet &requirements);
 
   /* OptimizeExpression - produce all equivalent logical and physical
    *     operators for this expression by applying transformation rules that
@@ -138,21 +142,21 @@ class Optimizer : public AbstractOptimizer {
    * requirements: the set of requirements the most optimal expression produced
    *     must fulfill
    */
-  void OptimizeExpression(std::shared_ptr<GroupExpression> gexpr,
-                          PropertySet requirements);
+  void OptimizeExpression(GroupExpression *gexpr,
+                          const PropertySet &requirements);
 
   /*
    * Get alternatives of the <output properties, input child property list> pair
    */
   std::vector<std::pair<PropertySet, std::vector<PropertySet>>>
-  DeriveChildProperties(std::shared_ptr<GroupExpression> gexpr,
-                        PropertySet requirements);
+  DeriveChildProperties(GroupExpression *gexpr,
+                        const PropertySet &requirements);
 
   /*
    * Derive the cost and stats for a group expression given the input/output
    * properties and the children's stats and costs
    */
-  void DeriveCostAndStats(std::shared_ptr<GroupExpression> gexpr,
+  void DeriveCostAndStats(GroupExpression *gexpr,
                           const PropertySet &output_properties,
                           const std::vector<PropertySet> &input_properties_list,
                           std::vector<std::shared_ptr<Stats>> child_stats,
@@ -167,9 +171,10 @@ class Optimizer : public AbstractOptimizer {
    *
    * return: the new group expression that has the enforced property
    */
-  std::shared_ptr<GroupExpression> EnforceProperty(
-      std::shared_ptr<GroupExpression> gexpr, PropertySet &output_properties,
-      const std::shared_ptr<Property> property, PropertySet &requirements);
+  GroupExpression *EnforceProperty(GroupExpression *gexpr,
+                                   PropertySet &output_properties,
+                                   const std::shared_ptr<Property> property,
+                                   const PropertySet &requirements);
 
   /* ExploreGroup - exploration equivalent of OptimizeGroup.
    *
@@ -184,7 +189,7 @@ class Optimizer : public AbstractOptimizer {
    *
    * gexpr: the group expression to apply rules to
    */
-  void ExploreExpression(std::shared_ptr<GroupExpression> gexpr);
+  void ExploreExpression(GroupExpression *gexpr);
 
   /* ImplementGroup - Implement physical operators of a group
    *
@@ -196,16 +201,23 @@ class Optimizer : public AbstractOptimizer {
    *
    * gexpr: the group expression to apply rules to
    */
-  void ImplementExpression(std::shared_ptr<GroupExpression> gexpr);
+  void ImplementExpression(GroupExpression *gexpr);
 
   //////////////////////////////////////////////////////////////////////////////
   /// Rule application
-  std::vector<std::shared_ptr<GroupExpression>> TransformExpression(
-      std::shared_ptr<GroupExpression> gexpr, const Rule &rule);
+  std::vector<GroupExpression *> TransformExpression(GroupExpression *gexpr,
+                                                    const Rule &rule);
+
+  /* BudgetExceeded - whether the current optimization has used up its time
+   *     or rule application budget
+   */
+  bool BudgetExceeded() const;
 
   //////////////////////////////////////////////////////////////////////////////
   /// Memo insertion
-  std::shared_ptr<GroupExpression> MakeGroupExpression(
+
+  // The returned expression is not in the memo, its children are
+  GroupExpression MakeGroupExpression(
       std::shared_ptr<OperatorExpression> expr);
 
   std::vector<GroupID> MemoTransformedChildren(
@@ -213,16 +225,17 @@ class Optimizer : public AbstractOptimizer {
 
   GroupID MemoTransformedExpression(std::shared_ptr<OperatorExpression> expr);
 
+  // Returns whether the expression is new to the memo
   bool RecordTransformedExpression(std::shared_ptr<OperatorExpression> expr,
-                                   std::shared_ptr<GroupExpression> &gexpr);
+                                   GroupExpression *&gexpr);
 
   bool RecordTransformedExpression(std::shared_ptr<OperatorExpression> expr,
-                                   std::shared_ptr<GroupExpression> &gexpr,
+                                   GroupExpression *&gexpr,
                                    GroupID target_group);
 
   //////////////////////////////////////////////////////////////////////////////
   /// Other Helper functions
-  Property *GenerateNewPropertyCols(PropertySet requirements);
+  Property *GenerateNewPropertyCols(const PropertySet &requirements);
 
   //////////////////////////////////////////////////////////////////////////////
   /// Member variables
@@ -234,6 +247,13 @@ class Optimizer : public AbstractOptimizer {
 
   // Rules to transform logical plan to physical implementation
   std::vector<std::unique_ptr<Rule>> physical_implementation_rules_;
+
+  // Search budget of the current optimization, 0 for no limit. Once over
+  // budget, only what is needed to produce a plan is implemented and costed.
+  int time_budget_ms_ = 0;
+  int rule_budget_ = 0;
+  std::chrono::steady_clock::time_point search_start_;
+  size_t rule_application_count_ = 0;
 };
 
 } // namespace optimizer
@@ -31,9 +31,10 @@ class PropertyEnforcer : public PropertyVisitor {
  public:
   PropertyEnforcer(ColumnManager &manager) : manager_(manager) {}
 
-  std::shared_ptr<GroupExpression> EnforceProperty(
-      std::shared_ptr<GroupExpression> gexpr, PropertySet *properties,
-      std::shared_ptr<Property> property);
+  // The returned expression is not in the memo yet
+  GroupExpression EnforceProperty(GroupExpression *gexpr,
+                                  PropertySet *properties,
+                                  std::shared_ptr<Property> property);
 
   virtual void Visit(const PropertyColumns *) override;
   virtual void Visit(const PropertySort *) override;
@@ -43,8 +44,9 @@ class PropertyEnforcer : public PropertyVisitor {
 
  private:
   ColumnManager &manager_;
-  std::shared_ptr<GroupExpression> input_gexpr_;
-  std::shared_ptr<GroupExpression> output_gexpr_;
+  GroupExpression *input_gexpr_;
+  // Operator of the enforcer expression
+  Operator output_op_;
   PropertySet *input_properties_;
 };
 
@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// semi_join_planner.h
+//
+// Identification: src/include/optimizer/semi_join_planner.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "type/types.h"
+
+namespace peloton {
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace expression {
+class AbstractExpression;
+}
+
+namespace parser {
+class SelectStatement;
+class SQLStatement;
+class TableRef;
+}
+
+namespace planner {
+class AbstractPlan;
+}
+
+namespace storage {
+class DataTable;
+}
+
+namespace optimizer {
+
+//===--------------------------------------------------------------------===//
+// Semi Join Planner
+//===--------------------------------------------------------------------===//
+
+/**
+ * Plans single-table SELECTs filtered by a subquery as semi and anti hash
+ * joins, which the optimizer cannot produce.
+ *
+ * The SELECT must output plain columns of its table, and its WHERE clause
+ * must be a conjunction with exactly one of
+ *
+ *   x [NOT] IN (SELECT y FROM s [WHERE ...])
+ *   [NOT] EXISTS (SELECT ... FROM s WHERE s.y = x [AND ...])
+ *
+ * where the other conjuncts and the WHERE clause of the subquery only refer
+ * to their own table, except for the equalities correlating EXISTS. The
+ * subquery table is the left child of the join, the outer table the right
+ * one, so the join returns right rows. NOT IN gets a null-aware anti join.
+ */
+class SemiJoinPlanner {
+ public:
+  explicit SemiJoinPlanner(concurrency::Transaction *txn) : txn_(txn) {}
+
+  // Plan of a bound statement, or nullptr if it does not qualify
+  std::unique_ptr<planner::AbstractPlan> BuildPlan(parser::SQLStatement *tree);
+
+  // Whether any expression of a statement has a subquery
+  static bool HasSubquery(parser::SQLStatement *tree);
+
+ private:
+  // One side of the join: a table, the conjuncts that only refer to it and
+  // its join key columns
+  struct JoinSide {
+    parser::TableRef *table_ref = nullptr;
+    storage::DataTable *table = nullptr;
+    std::vector<expression::AbstractExpression *> predicates;
+    std::vector<oid_t> key_column_ids;
+  };
+
+  // The table a SELECT without aggregation, sorting, limit or set operation
+  // reads, or nullptr
+  storage::DataTable *GetBaseTable(parser::SelectStatement *select_stmt,
+                                   parser::TableRef *&table_ref);
+
+  // Join keys of a correlated EXISTS subquery, false if its WHERE clause
+  // has other references to the outer table
+  bool GetCorrelation(parser::SelectStatement *sub_select, JoinSide &outer,
+                      JoinSide &inner);
+
+  // Sequential scan of the key columns, or all columns, of a side
+  std::unique_ptr<planner::AbstractPlan> BuildScanPlan(
+      const JoinSide &side, const std::vector<oid_t> &column_ids);
+
+  concurrency::Transaction *txn_;
+};
+
+}  // namespace optimizer
+}  // namespace peloton
@@ -52,6 +52,13 @@ void SetUnion (std::unordered_set<T>& new_set, std::unordered_set<T>& old_set) {
     new_set.insert(element);
 }
 
+// The index range of a "column LIKE 'prefix%'" predicate: the strings
+// starting with the prefix, or the one string when the pattern has no
+// wildcard. Returns false if the pattern has no prefix to search.
+bool GetLikePrefixRange(const expression::AbstractExpression *expression,
+                        std::vector<ExpressionType> &expr_types,
+                        std::vector<type::Value> &values);
+
 // get the column IDs evaluated in a predicate
 void GetPredicateColumns(const catalog::Schema *schema,
                                 expression::AbstractExpression *expression,
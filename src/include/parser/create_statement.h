@@ -15,6 +15,7 @@
 #include <memory>
 #include "common/sql_node_visitor.h"
 #include "expression/abstract_expression.h"
+#include "parser/select_statement.h"
 #include "parser/sql_statement.h"
 #include "type/types.h"
 
@@ -140,7 +141,7 @@ struct ColumnDefinition {
  */
 class CreateStatement : public TableRefStatement {
  public:
-  enum CreateType { kTable, kDatabase, kIndex, kTrigger };
+  enum CreateType { kTable, kDatabase, kIndex, kTrigger, kMaterializedView };
 
   CreateStatement(CreateType type)
       : TableRefStatement(StatementType::CREATE),
@@ -171,6 +172,9 @@ class CreateStatement : public TableRefStatement {
   std::unique_ptr<expression::AbstractExpression> trigger_when;
   int16_t trigger_type;  // information about row, timing, events, access by
                          // pg_trigger
+
+  // the aggregate query of a materialized view, named by the table info
+  std::unique_ptr<SelectStatement> view_query;
 };
 
 }  // namespace parser
@@ -43,6 +43,27 @@ typedef struct BoolExpr {
   int location; /* token location, or -1 if unknown */
 } BoolExpr;
 
+typedef enum SubLinkType {
+  EXISTS_SUBLINK,
+  ALL_SUBLINK,
+  ANY_SUBLINK,
+  ROWCOMPARE_SUBLINK,
+  EXPR_SUBLINK,
+  MULTIEXPR_SUBLINK,
+  ARRAY_SUBLINK,
+  CTE_SUBLINK /* for SubPlans only */
+} SubLinkType;
+
+typedef struct SubLink {
+  Expr xpr;
+  SubLinkType subLinkType; /* see above */
+  int subLinkId;           /* ID (1..n); 0 if not MULTIEXPR */
+  Node *testexpr;          /* outer-query test for ALL/ANY/ROWCOMPARE */
+  List *operName;          /* originally specified operator name */
+  Node *subselect;         /* subselect as Query* or raw parsetree */
+  int location;            /* token location, or -1 if unknown */
+} SubLink;
+
 typedef enum A_Expr_Kind {
   AEXPR_OP,              /* normal operator */
   AEXPR_OP_ANY,          /* scalar op ANY (array) */
@@ -557,6 +578,15 @@ typedef struct DropStmt {
   bool concurrent;       /* drop index concurrently? */
 } DropStmt;
 
+typedef struct CreateTableAsStmt {
+  NodeTag type;
+  Node *query;         /* the query */
+  IntoClause *into;    /* destination table */
+  ObjectType relkind;  /* OBJECT_TABLE or OBJECT_MATVIEW */
+  bool is_select_into; /* it was written as SELECT INTO */
+  bool if_not_exists;  /* just do nothing if it already exists? */
+} CreateTableAsStmt;
+
 typedef struct TruncateStmt {
   NodeTag type;
   List *relations;       /* relations (RangeVars) to be truncated */
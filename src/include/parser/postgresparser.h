@@ -117,6 +117,12 @@ class PostgresParser {
   // transform helper for A_Expr nodes
   static expression::AbstractExpression* AExprTransform(A_Expr* root);
 
+  // transform helper for IN lists
+  static expression::AbstractExpression* InListTransform(A_Expr* root);
+
+  // transform helper for subqueries
+  static expression::AbstractExpression* SubLinkTransform(SubLink* root);
+
   // transform helper for BoolExpr nodes
   static expression::AbstractExpression* BoolExprTransform(BoolExpr* root);
 
@@ -165,6 +171,10 @@ class PostgresParser {
   // transform helper for create db statement
   static parser::SQLStatement* CreateDbTransform(CreatedbStmt* root);
 
+  // transform helper for create materialized view statements
+  static parser::SQLStatement* CreateMaterializedViewTransform(
+      CreateTableAsStmt* root);
+
   // transform helper for column name (for insert statement)
   static std::vector<std::string>* ColumnNameTransform(List* root);
 
@@ -202,6 +212,9 @@ class PostgresParser {
   // transform helper for drop trigger statement
   static parser::DropStatement* DropTriggerTransform(DropStmt* root);
 
+  // transform helper for drop materialized view statement
+  static parser::DropStatement* DropMaterializedViewTransform(DropStmt* root);
+
   // transform helper for truncate statement
   static parser::DeleteStatement* TruncateTransform(TruncateStmt* root);
 
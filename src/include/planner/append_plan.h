@@ -20,19 +20,29 @@ namespace planner {
 
 /**
  * @brief Plan node for append.
+ *
+ * A parallel append may run its children concurrently, e.g. the scans of the
+ * partitions of a table.
  */
 class AppendPlan : public AbstractPlan {
  public:
-  AppendPlan() {}
+  explicit AppendPlan(bool parallel = false) : parallel_(parallel) {}
 
   inline PlanNodeType GetPlanNodeType() const { return PlanNodeType::APPEND; }
 
-  const std::string GetInfo() const { return "Append"; }
+  const std::string GetInfo() const {
+    return parallel_ ? "Parallel Append" : "Append";
+  }
+
+  bool IsParallel() const { return parallel_; }
 
   std::unique_ptr<AbstractPlan> Copy() const {
-    return std::unique_ptr<AbstractPlan>(new AppendPlan());
+    return std::unique_ptr<AbstractPlan>(new AppendPlan(parallel_));
   }
 
+ private:
+  bool parallel_;
+
  private:
   DISALLOW_COPY_AND_MOVE(AppendPlan);
 };
@@ -37,6 +37,18 @@ class CopyPlan : public AbstractPlan {
     LOG_DEBUG("Creating a Copy Plan");
   }
 
+  // Plan for importing (COPY FROM) a file, or the data streamed by the client
+  // if the file path is empty, into the target table
+  CopyPlan(storage::DataTable *target_table, std::string file_path,
+           char delimiter, bool csv_format)
+      : file_path(file_path),
+        is_import(true),
+        target_table(target_table),
+        delimiter(delimiter),
+        csv_format(csv_format) {
+    LOG_DEBUG("Creating a Copy Plan for import");
+  }
+
   inline PlanNodeType GetPlanNodeType() const { return PlanNodeType::COPY; }
 
   const std::string GetInfo() const { return "CopyPlan"; }
@@ -50,8 +62,34 @@ class CopyPlan : public AbstractPlan {
   // Whether the copying requires deserialization of parameters
   bool deserialize_parameters = false;
 
+  // Whether this is a COPY FROM
+  bool is_import = false;
+
+  // The table to import into
+  storage::DataTable *target_table = nullptr;
+
+  // Field delimiter of the imported data
+  char delimiter = ',';
+
+  // Whether the imported data is csv (quoted fields) or text (backslash
+  // escapes)
+  bool csv_format = true;
+
+  // Data received from the client for a COPY FROM STDIN
+  void SetCopyData(std::string &&data) { copy_data_ = std::move(data); }
+
+  const std::string &GetCopyData() const { return copy_data_; }
+
+  // Release the data once the statement ran, the plan may be cached
+  void ClearCopyData() { std::string().swap(copy_data_); }
+
+  // Whether the data comes from the client instead of a file
+  bool IsCopyFromStdin() const { return is_import && file_path.empty(); }
+
  private:
   DISALLOW_COPY_AND_MOVE(CopyPlan);
+
+  std::string copy_data_;
 };
 
 }  // namespace planner
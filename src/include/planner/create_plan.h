@@ -108,12 +108,31 @@ class CreatePlan : public AbstractPlan {
 
   int16_t GetTriggerType() const { return trigger_type; }
 
+  // interfaces for materialized views
+
+  std::string GetViewName() const { return view_name; }
+
+  std::vector<std::string> GetViewGroupColumns() const {
+    return view_group_columns;
+  }
+
+  // The aggregates of the view, with the name of the aggregated column or an
+  // empty name for COUNT(*)
+  const std::vector<std::pair<ExpressionType, std::string>> &
+  GetViewAggregates() const {
+    return view_aggregates;
+  }
+
 protected:
     // This is a helper method for extracting foreign key information
     // and storing it in an internal struct.
     void ProcessForeignKeyConstraint(const std::string &table_name,
                                      const parser::ColumnDefinition *col);
 
+    // Extract the table, group columns and aggregates of the query of a
+    // materialized view, which must be a plain GROUP BY over one table
+    void ProcessMaterializedViewQuery(parser::SelectStatement *view_query);
+
  private:
   // Table Name
   std::string table_name;
@@ -150,6 +169,11 @@ protected:
   int16_t trigger_type;  // information about row, timing, events, access by
                          // pg_trigger
 
+  // materialized view over table_name
+  std::string view_name;
+  std::vector<std::string> view_group_columns;
+  std::vector<std::pair<ExpressionType, std::string>> view_aggregates;
+
  private:
   DISALLOW_COPY_AND_MOVE(CreatePlan);
 };
@@ -52,6 +52,8 @@ class DropPlan : public AbstractPlan {
 
   std::string GetTriggerName() const { return trigger_name; }
 
+  std::string GetViewName() const { return view_name; }
+
   DropType GetDropType() const { return drop_type; }
 
   bool IsMissing() const { return missing; }
@@ -63,6 +65,7 @@ class DropPlan : public AbstractPlan {
   // storage::DataTable *target_table_ = nullptr;
   std::string table_name;
   std::string trigger_name;
+  std::string view_name;
   bool missing;
 
  private:
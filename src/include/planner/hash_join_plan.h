@@ -64,6 +64,13 @@ class HashJoinPlan : public AbstractJoinPlan {
   
   void SetBloomFilterFlag(bool flag) { build_bloomfilter_ = flag; }
 
+  // An ANTI join with NOT IN semantics: a NULL key on the left side filters
+  // out every right row, and a right row with a NULL key only survives if
+  // the left side is empty
+  bool IsNullAware() const { return null_aware_; }
+
+  void SetNullAware(bool null_aware) { null_aware_ = null_aware; }
+
   const std::string GetInfo() const override { return "HashJoin"; }
 
   const std::vector<oid_t> &GetOuterHashIds() const {
@@ -84,15 +91,7 @@ class HashJoinPlan : public AbstractJoinPlan {
     }
   }
 
-  std::unique_ptr<AbstractPlan> Copy() const override {
-    std::unique_ptr<const expression::AbstractExpression> predicate_copy(GetPredicate() ? GetPredicate()->Copy() : nullptr);
-    std::shared_ptr<const catalog::Schema> schema_copy(
-        catalog::Schema::CopySchema(GetSchema()));
-    HashJoinPlan *new_plan = new HashJoinPlan(
-        GetJoinType(), std::move(predicate_copy), GetProjInfo()->Copy(),
-        schema_copy, outer_column_ids_, build_bloomfilter_);
-    return std::unique_ptr<AbstractPlan>(new_plan);
-  }
+  std::unique_ptr<AbstractPlan> Copy() const override;
 
  private:
   std::vector<oid_t> outer_column_ids_;
@@ -105,6 +104,8 @@ class HashJoinPlan : public AbstractJoinPlan {
   
   bool build_bloomfilter_;
 
+  bool null_aware_ = false;
+
  private:
   DISALLOW_COPY_AND_MOVE(HashJoinPlan);
 };
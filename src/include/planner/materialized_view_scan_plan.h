@@ -0,0 +1,100 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// materialized_view_scan_plan.h
+//
+// Identification: src/include/planner/materialized_view_scan_plan.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "planner/abstract_plan.h"
+#include "storage/materialized_view.h"
+#include "type/types.h"
+
+namespace peloton {
+namespace planner {
+
+/**
+ * @brief Plan node reading the groups of a materialized view, in place of
+ * the aggregation over its table the query asked for.
+ *
+ * Only the groups whose group columns at the key offsets equal the key
+ * values are read; a key value may be a parameter offset, bound by
+ * SetParameterValues(). A key covering every group column is a lookup.
+ */
+class MaterializedViewScanPlan : public AbstractPlan {
+ public:
+  MaterializedViewScanPlan(
+      std::shared_ptr<storage::MaterializedView> view,
+      const std::vector<storage::MaterializedViewColumn> &columns,
+      std::shared_ptr<const catalog::Schema> output_schema,
+      const std::vector<oid_t> &key_offsets,
+      const std::vector<type::Value> &key_values);
+
+  inline PlanNodeType GetPlanNodeType() const {
+    return PlanNodeType::MATERIALIZED_VIEW_SCAN;
+  }
+
+  const std::string GetInfo() const {
+    return "MaterializedViewScan(" + view_->GetName() + ")";
+  }
+
+  storage::MaterializedView *GetView() const { return view_.get(); }
+
+  const std::vector<storage::MaterializedViewColumn> &GetColumns() const {
+    return columns_;
+  }
+
+  const catalog::Schema *GetOutputSchema() const {
+    return output_schema_.get();
+  }
+
+  const std::vector<oid_t> &GetKeyOffsets() const { return key_offsets_; }
+
+  const std::vector<type::Value> &GetKeyValues() const { return key_values_; }
+
+  void SetParameterValues(std::vector<type::Value> *values);
+
+  void GetOutputColumns(std::vector<oid_t> &columns) const {
+    columns.resize(columns_.size());
+    for (oid_t column_itr = 0; column_itr < columns_.size(); column_itr++) {
+      columns[column_itr] = column_itr;
+    }
+  }
+
+  std::unique_ptr<AbstractPlan> Copy() const {
+    return std::unique_ptr<AbstractPlan>(new MaterializedViewScanPlan(
+        view_, columns_, output_schema_, key_offsets_,
+        key_values_with_params_));
+  }
+
+ private:
+  std::shared_ptr<storage::MaterializedView> view_;
+
+  std::vector<storage::MaterializedViewColumn> columns_;
+
+  std::shared_ptr<const catalog::Schema> output_schema_;
+
+  std::vector<oid_t> key_offsets_;
+
+  // Key values as planned, with parameter offsets
+  std::vector<type::Value> key_values_with_params_;
+
+  // Key values with the parameters bound
+  std::vector<type::Value> key_values_;
+
+ private:
+  DISALLOW_COPY_AND_MOVE(MaterializedViewScanPlan);
+};
+
+}  // namespace planner
+}  // namespace peloton
@@ -76,8 +76,12 @@ class OrderByPlan : public AbstractPlan {
   uint64_t GetLimitOffset() const { return limit_offset_; }
 
   std::unique_ptr<AbstractPlan> Copy() const override {
-    return std::unique_ptr<AbstractPlan>(
-        new OrderByPlan(sort_keys_, descend_flags_, output_column_ids_));
+    OrderByPlan *new_plan =
+        new OrderByPlan(sort_keys_, descend_flags_, output_column_ids_);
+    new_plan->SetLimit(limit_);
+    new_plan->SetLimitNumber(limit_number_);
+    new_plan->SetLimitOffset(limit_offset_);
+    return std::unique_ptr<AbstractPlan>(new_plan);
   }
 
  private:
@@ -21,6 +21,7 @@
 #include "type/serializer.h"
 #include "type/types.h"
 #include "expression/abstract_expression.h"
+#include "storage/zone_map.h"
 
 namespace peloton {
 
@@ -42,6 +43,9 @@ class SeqScanPlan : public AbstractScan {
     LOG_TRACE("Creating a Sequential Scan Plan");
 
     SetForUpdateFlag(is_for_update);
+
+    storage::ZoneMap::ExtractPredicates(predicate, nullptr,
+                                        zone_map_predicates_);
   }
 
   SeqScanPlan() : AbstractScan() {}
@@ -63,12 +67,21 @@ class SeqScanPlan : public AbstractScan {
 
   oid_t GetColumnID(std::string col_name);
 
+  // The conjuncts of the predicate that can be checked against tile group
+  // zone maps. Only comparisons against constants are included here.
+  const std::vector<storage::ZoneMapPredicate> &GetZoneMapPredicates() const {
+    return zone_map_predicates_;
+  }
+
   std::unique_ptr<AbstractPlan> Copy() const {
     AbstractPlan *new_plan = new SeqScanPlan(
         this->GetTable(), this->GetPredicate()->Copy(), this->GetColumnIds());
     return std::unique_ptr<AbstractPlan>(new_plan);
   }
 
+ private:
+  std::vector<storage::ZoneMapPredicate> zone_map_predicates_;
+
  private:
   DISALLOW_COPY_AND_MOVE(SeqScanPlan);
 };
@@ -58,6 +58,68 @@ SETTING_string(certificate_file,
 // RESOURCE USAGE
 //===----------------------------------------------------------------------===//
 
+// Number of tile groups allocated ahead of time for each table
+SETTING_int(tile_group_reserve,
+           "Number of tile groups to preallocate per table (default: 2)",
+           2,
+           false, false)
+
+// Tile groups without writes for this long are compressed by the layout tuner
+SETTING_int(tile_group_freeze_period,
+           "Seconds without writes after which a tile group is compressed, "
+           "0 to never compress (default: 300)",
+           300,
+           true, true)
+
+// Pin worker threads to NUMA nodes and keep their memory and inserts local
+SETTING_bool(numa_aware,
+            "Pin threads to NUMA nodes and place memory and inserts on the "
+            "local node (default: false)",
+            false,
+            false, false)
+
+// Split a single-node machine into this many nodes, for testing placement
+SETTING_int(numa_simulated_nodes,
+           "Number of NUMA nodes to simulate, 0 to use the real topology "
+           "(default: 0)",
+           0,
+           false, false)
+
+// Backend tile groups are stored on
+SETTING_string(tile_group_backend,
+              "Backend of tile groups, MM for memory or SSD/HDD for the "
+              "memory-mapped data file (default: MM)",
+              "MM",
+              false, false)
+
+// Directory of the data file of SSD and HDD tile groups
+SETTING_string(data_file_directory,
+              "Directory of the data file, empty to use the first existing "
+              "of /data1/, /data/ and /tmp/ (default: empty)",
+              "",
+              false, false)
+
+// Initial size of the data file of SSD and HDD tile groups
+SETTING_int(data_file_size,
+           "Initial size of the data file in MB, it grows when it is full "
+           "(default: 512)",
+           512,
+           false, false)
+
+// Memory the hash aggregations and hash joins of a query may use together
+// before they spill to disk
+SETTING_int(query_memory_budget,
+           "Memory budget of the hash tables of a query in KB, 0 for "
+           "unbounded (default: 262144)",
+           262144,
+           true, true)
+
+// Memory a sort may use before it spills sorted runs to disk
+SETTING_int(sort_memory_budget,
+           "Memory budget of a sort in KB, 0 for unbounded (default: 262144)",
+           262144,
+           true, true)
+
 //===----------------------------------------------------------------------===//
 // WRITE AHEAD LOG
 //===----------------------------------------------------------------------===//
@@ -102,6 +164,40 @@ SETTING_bool(layout_tuner,
             false,
             true, true)
 
+//===----------------------------------------------------------------------===//
+// OPTIMIZER
+//===----------------------------------------------------------------------===//
+
+// Plan single-table statements on an index without the optimizer search
+SETTING_bool(fast_path_planner,
+            "Plan single-table point and range queries on an index without "
+            "the cost-based search (default: true)",
+            true,
+            true, true)
+
+// Read the groups of a matching materialized view instead of aggregating.
+// Only READ COMMITTED and snapshot transactions that have not written read
+// views; the executor aggregates the table for any other reader.
+SETTING_bool(materialized_view_rewrite,
+            "Answer GROUP BY queries a materialized view matches from the "
+            "view (default: true)",
+            true,
+            true, true)
+
+// Once the search runs over either budget, the optimizer stops exploring
+// alternatives and settles for the cheapest plan it has found
+SETTING_int(optimizer_search_budget,
+           "Milliseconds the optimizer searches for a plan, 0 for no limit "
+           "(default: 0)",
+           0,
+           true, true)
+
+SETTING_int(optimizer_rule_budget,
+           "Number of rule applications per optimization, 0 for no limit "
+           "(default: 0)",
+           0,
+           true, true)
+
 //===----------------------------------------------------------------------===//
 // CODEGEN
 //===----------------------------------------------------------------------===//
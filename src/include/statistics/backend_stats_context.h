@@ -20,6 +20,7 @@
 #include "common/platform.h"
 #include "statistics/table_metric.h"
 #include "statistics/index_metric.h"
+#include "statistics/latency_histogram.h"
 #include "statistics/latency_metric.h"
 #include "statistics/database_metric.h"
 #include "statistics/query_metric.h"
@@ -47,7 +48,7 @@ class BackendStatsContext {
  public:
   static BackendStatsContext* GetInstance();
 
-  BackendStatsContext(size_t max_latency_history, bool regiser_to_aggregator);
+  BackendStatsContext(bool regiser_to_aggregator);
   ~BackendStatsContext();
 
   //===--------------------------------------------------------------------===//
@@ -78,6 +79,29 @@ class BackendStatsContext {
   // Returns the latency metric
   LatencyMetric& GetTxnLatencyMetric();
 
+  // Returns the latency metric of the given kind of query
+  LatencyMetric& GetQueryLatencyMetric(QueryLatencyType latency_type);
+
+  // Returns the lengths of the version chains traversed by index lookups
+  LatencyHistogram& GetVersionChainLengths() { return version_chain_lengths_; }
+
+  // Record the number of versions an index lookup traversed
+  inline void RecordVersionChainLength(size_t chain_length) {
+    version_chain_lengths_.Record(chain_length);
+  }
+
+  // Returns the planning latencies of statements planned by the fast path
+  // planner, or by the optimizer search
+  LatencyHistogram& GetPlanningLatencies(bool fast_path) {
+    return fast_path ? fast_path_planning_latencies_
+                     : optimizer_planning_latencies_;
+  }
+
+  // Record how many microseconds planning a statement took
+  inline void RecordPlanningLatency(bool fast_path, uint64_t latency) {
+    GetPlanningLatencies(fast_path).Record(latency);
+  }
+
   // Increment the read stat for given tile group
   void IncrementTableReads(oid_t tile_group_id);
 
@@ -172,6 +196,18 @@ class BackendStatsContext {
   // Latencies recorded by this worker
   LatencyMetric txn_latencies_;
 
+  // Latencies of the queries completed by this worker, by kind of query
+  std::unique_ptr<LatencyMetric> query_latencies_[QUERY_LATENCY_TYPE_COUNT];
+
+  // Version chain lengths seen by this worker. Long chains mean the GC falls
+  // behind the updates.
+  LatencyHistogram version_chain_lengths_;
+
+  // Planning latencies of this worker, by planner
+  LatencyHistogram fast_path_planning_latencies_;
+
+  LatencyHistogram optimizer_planning_latencies_;
+
   // Whether this context is registered to the global aggregator
   bool is_registered_to_aggregator_;
 
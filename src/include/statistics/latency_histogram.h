@@ -0,0 +1,155 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// latency_histogram.h
+//
+// Identification: src/include/statistics/latency_histogram.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "common/macros.h"
+
+namespace peloton {
+namespace stats {
+
+//===--------------------------------------------------------------------===//
+// Latency Histogram
+//===--------------------------------------------------------------------===//
+
+/**
+ * A log-linear histogram of latencies in microseconds, in the spirit of
+ * HdrHistogram.
+ *
+ * Values below 2^SUB_BUCKET_BITS get a bucket each. Every larger power of
+ * two is split into 2^SUB_BUCKET_BITS equally wide buckets, so a bucket is
+ * never wider than 1/32 of the values it holds and a percentile is
+ * reported within about 1.6% of the exact one. Values beyond MAX_VALUE are
+ * counted in the last bucket; the exact minimum and maximum are kept
+ * separately.
+ *
+ * Record() must only be called by the thread that owns the histogram. It
+ * neither takes a lock nor issues an atomic read-modify-write, yet another
+ * thread may read the histogram or merge it into its own at any time; it
+ * just might not see the latest few values yet. Merging into a histogram
+ * must not race with recording into it.
+ *
+ * The stats aggregator reports latencies per interval. It uses Collect(),
+ * which hands over only what was counted since the last call, as if the
+ * owner had reset the histogram in between.
+ */
+class LatencyHistogram {
+ public:
+  // Number of linear sub-buckets per power of two, as a power of two
+  static constexpr uint32_t SUB_BUCKET_BITS = 5;
+
+  static constexpr uint32_t SUB_BUCKET_COUNT = 1u << SUB_BUCKET_BITS;
+
+  // The largest value that gets a bucket of its own, about 12 days
+  static constexpr uint32_t MAX_VALUE_BITS = 40;
+
+  static constexpr uint64_t MAX_VALUE = (1ull << MAX_VALUE_BITS) - 1;
+
+  static constexpr uint32_t BUCKET_COUNT =
+      SUB_BUCKET_COUNT * (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1);
+
+  LatencyHistogram() { Reset(); }
+
+  // Count one latency of the given number of microseconds
+  inline void Record(uint64_t value) {
+    Increment(buckets_[GetBucketIndex(value)], 1);
+    Increment(count_, 1);
+    Increment(sum_, value);
+    if (value < min_.load(std::memory_order_relaxed)) {
+      min_.store(value, std::memory_order_relaxed);
+    }
+    if (value > max_.load(std::memory_order_relaxed)) {
+      max_.store(value, std::memory_order_relaxed);
+    }
+  }
+
+  // Add every latency counted by the source histogram to this one
+  void Merge(const LatencyHistogram &source);
+
+  // Add the latencies counted since the previous call to the target. Only
+  // one thread may collect from a histogram, but it may do so while the
+  // owner is recording. The minimum and maximum handed over are only exact
+  // to the bucket.
+  void Collect(LatencyHistogram &target);
+
+  void Reset();
+
+  // Number of latencies counted
+  uint64_t GetCount() const { return count_.load(std::memory_order_relaxed); }
+
+  // The following return microseconds, or 0 if nothing has been counted
+  uint64_t GetMin() const;
+
+  uint64_t GetMax() const;
+
+  double GetMean() const;
+
+  // The latency that the given fraction of all latencies does not exceed,
+  // e.g. 0.99 for the 99th percentile
+  uint64_t GetPercentile(double fraction) const;
+
+  // Bucket helpers
+  static inline uint32_t GetBucketIndex(uint64_t value) {
+    if (value < SUB_BUCKET_COUNT) {
+      return static_cast<uint32_t>(value);
+    }
+    if (value > MAX_VALUE) {
+      return BUCKET_COUNT - 1;
+    }
+    // The highest SUB_BUCKET_BITS + 1 bits of the value pick the bucket
+    uint32_t shift = 63 - __builtin_clzll(value) - SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKET_COUNT +
+           static_cast<uint32_t>(value >> shift) - SUB_BUCKET_COUNT;
+  }
+
+  static uint64_t GetBucketLowerBound(uint32_t bucket_index);
+
+  static uint64_t GetBucketUpperBound(uint32_t bucket_index);
+
+ private:
+  DISALLOW_COPY_AND_MOVE(LatencyHistogram);
+
+  // Only the owning thread writes, so a plain load and store is enough
+  static inline void Increment(std::atomic<uint64_t> &counter,
+                               uint64_t delta) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta,
+                  std::memory_order_relaxed);
+  }
+
+  // Lower min_ or raise max_ from a thread other than the owner
+  void MergeMin(uint64_t value);
+
+  void MergeMax(uint64_t value);
+
+ private:
+  std::atomic<uint64_t> buckets_[BUCKET_COUNT];
+
+  std::atomic<uint64_t> count_;
+
+  // Sum of all latencies, for the mean
+  std::atomic<uint64_t> sum_;
+
+  std::atomic<uint64_t> min_;
+
+  std::atomic<uint64_t> max_;
+
+  // What Collect() has handed over so far, only touched by the collector
+  uint64_t collected_buckets_[BUCKET_COUNT];
+
+  uint64_t collected_sum_;
+};
+
+}  // namespace stats
+}  // namespace peloton
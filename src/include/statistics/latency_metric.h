@@ -19,9 +19,8 @@
 #include "common/macros.h"
 #include "type/types.h"
 #include "common/exception.h"
-#include "container/circular_buffer.h"
 #include "statistics/abstract_metric.h"
-#include <mutex>
+#include "statistics/latency_histogram.h"
 
 namespace peloton {
 namespace stats {
@@ -35,22 +34,26 @@ struct LatencyMeasurements {
   double perc_25th_ = 0.0;
   double perc_75th_ = 0.0;
   double perc_99th_ = 0.0;
+  double perc_99_9th_ = 0.0;
 };
 
 /**
- * Metric for storing raw latency values and computing
+ * Metric for counting latencies in a histogram and computing
  * latency measurements.
+ *
+ * Only the thread that owns this metric may record latencies, but any
+ * thread may aggregate it at the same time.
  */
 class LatencyMetric : public AbstractMetric {
  public:
-  LatencyMetric(MetricType type, size_t max_history);
+  LatencyMetric(MetricType type);
 
   //===--------------------------------------------------------------------===//
   // HELPER METHODS
   //===--------------------------------------------------------------------===//
 
   inline void Reset() {
-    latencies_.Clear();
+    latencies_.Reset();
     timer_ms_.Reset();
   }
 
@@ -63,57 +66,46 @@ class LatencyMetric : public AbstractMetric {
   // Stops the latency timer and records the total time elapsed
   inline void RecordLatency() {
     timer_ms_.Stop();
-    double latency_value = timer_ms_.GetDuration();
-    // Record this latency only if we can do so without blocking.
-    // Occasionally losing single latency measurements is fine.
-    {
-      std::unique_lock<std::mutex> lock(latency_mutex_, std::defer_lock);
-      if (lock.try_lock()) {
-        latencies_.PushBack(latency_value);
-      }
-    }
+    RecordLatency(timer_ms_.GetDuration());
   }
 
-  // Returns the first latency value recorded
-  inline double GetFirstLatencyValue() {
-    PL_ASSERT(latencies_.begin() != latencies_.end());
-    return *(latencies_.begin());
+  // Records a latency measured elsewhere, in milliseconds
+  inline void RecordLatency(double latency_ms) {
+    latencies_.Record(static_cast<uint64_t>(latency_ms * 1000));
   }
 
+  // Returns the number of latencies recorded
+  inline uint64_t GetLatencyCount() const { return latencies_.GetCount(); }
+
   // Computes the latency measurements using the latencies
   // collected so far.
   void ComputeLatencies();
 
-  // Combines the source latency metric with this latency metric
+  // Returns the result of the last call to ComputeLatencies()
+  inline const LatencyMeasurements &GetLatencyMeasurements() const {
+    return latency_measurements_;
+  }
+
+  // Adds the latencies the source recorded since it was last aggregated to
+  // this latency metric. A source must only be aggregated by one thread.
   void Aggregate(AbstractMetric &source);
 
   // Returns a string representation of this latency metric
   const std::string GetInfo() const;
 
-  // Returns a copy of the latencies collected
-  CircularBuffer<double> Copy();
-
  private:
   //===--------------------------------------------------------------------===//
   // MEMBERS
   //===--------------------------------------------------------------------===//
 
-  // Circular buffer with capacity N that stores the <= N
-  // most recent latencies collected
-  CircularBuffer<double> latencies_;
+  // Histogram of all latencies recorded, in microseconds
+  LatencyHistogram latencies_;
 
   // Timer for timing individual latencies
   Timer<std::ratio<1, 1000>> timer_ms_;
 
   // Stores result of last call to ComputeLatencies()
   LatencyMeasurements latency_measurements_;
-
-  // The maximum number of latencies that can be stored
-  // (the capacity size N of the circular buffer)
-  size_t max_history_;
-
-  // Protects accesses to the circular buffer
-  std::mutex latency_mutex_;
 };
 
 }  // namespace stats
@@ -15,10 +15,10 @@
 #include <string>
 #include <sstream>
 #include <vector>
+#include "common/timer.h"
 #include "type/types.h"
 #include "statistics/abstract_metric.h"
 #include "statistics/access_metric.h"
-#include "statistics/latency_metric.h"
 #include "statistics/processor_metric.h"
 
 namespace peloton {
@@ -28,6 +28,18 @@ namespace stats {
 // Same type defined in network/marshal.h
 typedef unsigned char uchar;
 
+// The kinds of queries whose latencies are tracked separately, told apart
+// by the first keyword of the query
+enum class QueryLatencyType {
+  SELECT = 0,
+  INSERT = 1,
+  UPDATE = 2,
+  DELETE = 3,
+  OTHER = 4
+};
+
+#define QUERY_LATENCY_TYPE_COUNT 5
+
 /**
  * Metric for the access of a query
  */
@@ -64,7 +76,8 @@ class QueryMetric : public AbstractMetric {
 
   QueryMetric(MetricType type, const std::string &query_name,
               std::shared_ptr<QueryParams> query_params,
-              const oid_t database_id);
+              const oid_t database_id,
+              QueryLatencyType latency_type = QueryLatencyType::OTHER);
 
   //===--------------------------------------------------------------------===//
   // ACCESSORS
@@ -72,7 +85,18 @@ class QueryMetric : public AbstractMetric {
 
   inline AccessMetric &GetQueryAccess() { return query_access_; }
 
-  inline LatencyMetric &GetQueryLatency() { return latency_metric_; }
+  // Stops the latency timer and records the time elapsed since the query
+  // started
+  inline void RecordLatency() {
+    latency_timer_.Stop();
+    latency_ = latency_timer_.GetDuration();
+    latency_timer_.Reset();
+  }
+
+  // Returns the last latency recorded, in milliseconds
+  inline double GetLatency() const { return latency_; }
+
+  inline QueryLatencyType GetLatencyType() const { return latency_type_; }
 
   inline ProcessorMetric &GetProcessorMetric() { return processor_metric_; }
 
@@ -90,6 +114,11 @@ class QueryMetric : public AbstractMetric {
 
   inline void Reset() { query_access_.Reset(); }
 
+  // Returns the kind of query whose first keyword is given in upper case
+  static QueryLatencyType GetLatencyType(const std::string &query_type_string);
+
+  static std::string LatencyTypeToString(QueryLatencyType latency_type);
+
   void Aggregate(AbstractMetric &source);
 
   inline const std::string GetInfo() const {
@@ -118,8 +147,14 @@ class QueryMetric : public AbstractMetric {
   // The number of tuple accesses
   AccessMetric query_access_{ACCESS_METRIC};
 
-  // Latency metric
-  LatencyMetric latency_metric_{LATENCY_METRIC, 2};
+  // The kind of this query
+  QueryLatencyType latency_type_;
+
+  // Timer for the latency of this query, in milliseconds
+  Timer<std::ratio<1, 1000>> latency_timer_;
+
+  // The last latency recorded
+  double latency_ = 0.0;
 
   // Processor metric
   ProcessorMetric processor_metric_{PROCESSOR_METRIC};
@@ -12,7 +12,11 @@
 
 #pragma once
 
+#include <map>
 #include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
 
 #include "common/platform.h"
 #include "type/types.h"
@@ -35,7 +39,21 @@ namespace storage {
 // Storage Manager
 //===--------------------------------------------------------------------===//
 
-/// Stores data on different backends
+/**
+ * Stores data on different backends.
+ *
+ * MM and NVM data lives on the heap. SSD and HDD data lives in a sparse data
+ * file that is mapped into memory on first use, so the page cache decides
+ * which pages stay resident and the rest can be evicted to the device.
+ * Released ranges of the file are reused and their pages are given back to
+ * the file system. The file grows in place when it is full.
+ *
+ * The file outlives the process. Allocations made with a key are recorded
+ * in the file, and after a restart their owner takes them back with
+ * Attach(). Allocations without a key are released when the file is opened
+ * again. Data pointing into the file itself stays valid only if the file is
+ * mapped at its previous address, which is requested but not guaranteed.
+ */
 class BackendManager {
  public:
   // global singleton
@@ -44,12 +62,32 @@ class BackendManager {
   BackendManager();
   ~BackendManager();
 
-  void *Allocate(BackendType type, size_t size);
+  // A non-zero key makes an SSD or HDD allocation survive a restart. Keys
+  // must be unique among the allocations in the data file.
+  void *Allocate(BackendType type, size_t size, uint64_t key = 0);
 
   void Release(BackendType type, void *address);
 
+  // Take back the allocation with the given key that the data file held
+  // when it was opened. Returns nullptr if there is none, otherwise sets the
+  // size of the allocation. It belongs to the caller again, who releases it
+  // like any other.
+  void *Attach(BackendType type, uint64_t key, size_t &size);
+
+  // Write the given range back to the device. A null address syncs all of
+  // the data file.
   void Sync(BackendType type, void *address, size_t length);
 
+  // Directory and initial size of the data file. Only takes effect before
+  // the first SSD or HDD allocation. An empty directory picks the first
+  // existing of SSD_DIR, HDD_DIR and TMP_DIR.
+  void ConfigureDataFile(const std::string &directory, size_t size_mb);
+
+  // Bytes of the data file that are currently allocated
+  size_t GetDataFileUsage();
+
+  size_t GetDataFileLength() const { return data_file_len; }
+
   size_t GetMsyncCount() const { return msync_count; }
 
   size_t GetClflushCount() const { return clflush_count; }
@@ -57,18 +95,65 @@ class BackendManager {
   size_t GetAllocationCount() const { return allocation_count; }
 
  private:
-  // data file address
+  // Map the data file, creating it or reattaching to its allocations.
+  // Called with the data file lock held.
+  void OpenDataFile();
+
+  // Sync and unmap the data file, which is kept for the next start
+  void CloseDataFile();
+
+  // Rebuild the allocations from the extent headers of a reopened file
+  void LoadExtents();
+
+  // Grow the file to hold at least the given length. Called with the data
+  // file lock held.
+  void GrowDataFile(size_t min_length);
+
+  // Add an extent to the free lists, merging it with its neighbours
+  void AddFreeExtent(size_t offset, size_t length);
+
+  void RemoveFreeExtent(std::map<size_t, size_t>::iterator extent);
+
+  // Write the header of an extent and of the file
+  void WriteExtentHeader(size_t offset, size_t length, uint64_t key,
+                         bool allocated);
+
+  void WriteFileHeader();
+
+  // data file address, the start of a reservation the file grows into
   void *data_file_address;
 
+  // data file descriptor, kept open to grow and lock the file
+  int data_file_fd = -1;
+
   // data file lock
   Spinlock data_file_spinlock;
 
   // data file len
   size_t data_file_len;
 
-  // data offset
+  // data offset, the file beyond it has never been allocated
   size_t data_file_offset;
 
+  // data file directory, empty if not configured
+  std::string data_file_directory;
+
+  // data file path
+  std::string data_file_name;
+
+  // released extents below the data offset, offset -> length
+  std::map<size_t, size_t> free_extents;
+
+  // the same extents ordered by length, for a best fit
+  std::set<std::pair<size_t, size_t>> free_extent_lengths;
+
+  // allocated extents, offset -> length
+  std::unordered_map<size_t, size_t> allocated_extents;
+
+  // keyed extents found when the file was opened and not attached yet,
+  // key -> offset
+  std::unordered_map<uint64_t, size_t> attachable_extents;
+
   // stats
   size_t msync_count = 0;
 
@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// backend_pool.h
+//
+// Identification: src/include/storage/backend_pool.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <unordered_set>
+
+#include "common/platform.h"
+#include "storage/backend_manager.h"
+#include "type/abstract_pool.h"
+#include "type/types.h"
+
+namespace peloton {
+namespace storage {
+
+// A memory pool whose chunks live on a backend of the BackendManager, so
+// that the varlen data of a tile stays on the same backend as the tile
+class BackendPool : public type::AbstractPool {
+ public:
+  explicit BackendPool(BackendType backend_type)
+      : backend_type_(backend_type) {}
+
+  // Destroy this pool, and release all memory it owns
+  ~BackendPool() {
+    auto &backend_manager = BackendManager::GetInstance();
+    pool_lock_.Lock();
+    for (auto location : locations_) {
+      backend_manager.Release(backend_type_, location);
+    }
+    pool_lock_.Unlock();
+  }
+
+  void *Allocate(size_t size) override {
+    auto location =
+        BackendManager::GetInstance().Allocate(backend_type_, size);
+
+    pool_lock_.Lock();
+    locations_.insert(location);
+    pool_lock_.Unlock();
+
+    return location;
+  }
+
+  void Free(void *ptr) override {
+    pool_lock_.Lock();
+    locations_.erase(ptr);
+    pool_lock_.Unlock();
+
+    BackendManager::GetInstance().Release(backend_type_, ptr);
+  }
+
+ private:
+  BackendType backend_type_;
+
+  // Locations handed out and not freed yet
+  std::unordered_set<void *> locations_;
+
+  // Spin lock protecting location list
+  Spinlock pool_lock_;
+};
+
+}  // namespace storage
+}  // namespace peloton
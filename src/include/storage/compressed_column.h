@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// compressed_column.h
+//
+// Identification: src/include/storage/compressed_column.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/macros.h"
+#include "type/types.h"
+
+namespace peloton {
+namespace storage {
+
+//===--------------------------------------------------------------------===//
+// Compressed Column
+//===--------------------------------------------------------------------===//
+
+/**
+ * An immutable, compressed copy of one column of a tile.
+ *
+ * Every slot holds the raw inlined bytes of the column, at most eight of
+ * them. Varlen columns therefore keep their pointers into the tile's pool.
+ * The bytes are encoded with whichever of these schemes is smallest:
+ *
+ *  - PLAIN:      the values stored back to back
+ *  - DICTIONARY: the sorted distinct values, plus a bit-packed code per slot
+ *  - RUN_LENGTH: one value per run of equal values, plus where the run ends
+ *  - BIT_PACKED: frame of reference, i.e. the minimum plus a bit-packed
+ *                offset per slot
+ *
+ * Small integer types are sign-extended before encoding, so small negative
+ * values pack as tightly as small positive ones.
+ */
+class CompressedColumn {
+ public:
+  enum class Encoding { PLAIN, DICTIONARY, RUN_LENGTH, BIT_PACKED };
+
+  // Encode count values of the given width. Each value is found stride
+  // bytes after the previous one, starting at base.
+  CompressedColumn(type::TypeId type_id, size_t width, const char *base,
+                   size_t stride, size_t count);
+
+  // Copy the raw bytes of the given slot to out, which must hold GetWidth()
+  // bytes
+  void Decode(oid_t slot, char *out) const;
+
+  // Decode every slot to out, one value after another
+  void DecodeAll(char *out) const;
+
+  // Returns false only if no slot holds exactly the given raw bytes
+  bool MayContain(const char *value) const;
+
+  Encoding GetEncoding() const { return encoding_; }
+
+  size_t GetWidth() const { return width_; }
+
+  size_t GetCount() const { return count_; }
+
+  // Number of bytes used by the encoded values
+  size_t GetSize() const;
+
+  // Can values of this width be compressed?
+  static bool CanEncode(size_t width) { return width <= sizeof(uint64_t); }
+
+  // Is comparing raw bytes the same as comparing values of this type? Only
+  // then can predicates be checked with MayContain().
+  static bool HasExactEncoding(type::TypeId type_id);
+
+  static std::string EncodingToString(Encoding encoding);
+
+ private:
+  DISALLOW_COPY_AND_MOVE(CompressedColumn);
+
+  // Widen the raw bytes of a value to a 64-bit key and back
+  uint64_t LoadKey(const char *value) const;
+
+  void StoreKey(uint64_t key, char *out) const;
+
+  uint64_t GetKey(oid_t slot) const;
+
+  // Bit-packed array helpers
+  static uint32_t GetBitWidth(uint64_t max_value);
+
+  uint64_t GetPacked(oid_t slot) const;
+
+  void Pack(const std::vector<uint64_t> &values);
+
+ private:
+  type::TypeId type_id_;
+
+  size_t width_;
+
+  size_t count_;
+
+  Encoding encoding_ = Encoding::PLAIN;
+
+  // PLAIN: the raw bytes of every slot
+  std::vector<char> plain_;
+
+  // DICTIONARY: the sorted distinct keys. RUN_LENGTH: the key of each run.
+  std::vector<uint64_t> keys_;
+
+  // RUN_LENGTH: the slot following each run
+  std::vector<oid_t> run_ends_;
+
+  // The smallest and largest key, as signed numbers. BIT_PACKED stores
+  // offsets from min_key_.
+  int64_t min_key_ = 0;
+
+  int64_t max_key_ = 0;
+
+  // DICTIONARY: the codes. BIT_PACKED: the offsets from min_key_.
+  std::vector<uint64_t> packed_;
+
+  uint32_t bit_width_ = 0;
+};
+
+}  // namespace storage
+}  // namespace peloton
@@ -17,6 +17,8 @@
 #include <mutex>
 #include <queue>
 #include <set>
+#include <utility>
+#include <vector>
 
 #include "common/item_pointer.h"
 #include "common/platform.h"
@@ -24,6 +26,7 @@
 #include "index/index.h"
 #include "storage/abstract_table.h"
 #include "storage/indirection_array.h"
+#include "storage/recycled_slot_allocator.h"
 #include "trigger/trigger.h"
 
 //===--------------------------------------------------------------------===//
@@ -59,6 +62,8 @@ namespace storage {
 class Tuple;
 class TileGroup;
 class IndirectionArray;
+class MaterializedView;
+class TileGroupPreallocator;
 
 //===--------------------------------------------------------------------===//
 // DataTable
@@ -77,6 +82,7 @@ class DataTable : public AbstractTable {
   friend class TileGroup;
   friend class TileGroupFactory;
   friend class TableFactory;
+  friend class TileGroupPreallocator;
   friend class logging::LogManager;
 
   DataTable() = delete;
@@ -126,6 +132,29 @@ class DataTable : public AbstractTable {
   bool InsertTuple(const AbstractTuple *tuple, ItemPointer location,
       concurrency::Transaction *transaction, ItemPointer **index_entry_ptr);
 
+  // check the NOT NULL and CHECK constraints of a tuple
+  bool CheckConstraints(const storage::Tuple *tuple) const;
+
+  //===--------------------------------------------------------------------===//
+  // BULK LOAD
+  //===--------------------------------------------------------------------===//
+
+  // Allocate a tile group with the current default layout that is not part
+  // of the table yet. A bulk load fills it with TileGroup::InsertTuple, off
+  // the insert path and without any index work, and then adds it with
+  // InsertTileGroup.
+  std::shared_ptr<TileGroup> NewBulkLoadTileGroup();
+
+  // Add a tile group filled by a bulk load to the table, as inserts of the
+  // transaction, and insert its tuples into the indexes. Each index gets
+  // all the keys of the tile group in slot order from a thread of its own.
+  // Returns false if a tuple violates a unique or foreign key constraint, in
+  // which case the transaction has to abort.
+  bool InsertTileGroup(const std::shared_ptr<TileGroup> &tile_group,
+                       concurrency::Transaction *transaction);
+
+  size_t GetTuplesPerTileGroup() const { return tuples_per_tilegroup_; }
+
   //===--------------------------------------------------------------------===//
   // TILE GROUP
   //===--------------------------------------------------------------------===//
@@ -204,6 +233,23 @@ class DataTable : public AbstractTable {
 
   void RemoveForeignKeySource(const std::string &source_table_name);
 
+  //===--------------------------------------------------------------------===//
+  // MATERIALIZED VIEWS
+  //===--------------------------------------------------------------------===//
+
+  // Attach a view to be maintained as transactions writing this table commit
+  void AddMaterializedView(std::shared_ptr<MaterializedView> view);
+
+  // Detach the view of the given name, returns false if there is none
+  bool DropMaterializedView(const std::string &view_name);
+
+  std::shared_ptr<MaterializedView> GetMaterializedView(
+      const std::string &view_name);
+
+  std::vector<std::shared_ptr<MaterializedView>> GetMaterializedViews();
+
+  bool HasMaterializedViews() const { return has_materialized_views_; }
+
   //===--------------------------------------------------------------------===//
   // TRANSFORMERS
   //===--------------------------------------------------------------------===//
@@ -211,6 +257,27 @@ class DataTable : public AbstractTable {
   storage::TileGroup *TransformTileGroup(const oid_t &tile_group_offset,
                                          const double &theta);
 
+  // Move the live tuples of a cold tile group into the active tile groups,
+  // which use the current default layout, and retire it. A tile group is
+  // cold when no transaction has written to it for cold_period milliseconds,
+  // and it is moved when its layout differs from the default layout by at
+  // least theta, or when less than fill_threshold of its slots hold live
+  // tuples. Tuples are moved as MVCC updates in a transaction of their own,
+  // so it is safe to call while the table is in use. Tuples that are busy
+  // are skipped and moved by a later call. Once a retired tile group has
+  // drained and its old versions are unreachable, a later call frees it.
+  // Returns true if every live tuple got moved.
+  bool ReorganizeTileGroup(const oid_t &tile_group_offset, const double &theta,
+                           const double &fill_threshold,
+                           const uint64_t &cold_period);
+
+  // Compress a tile group whose data has not changed for quiet_period
+  // milliseconds, as observed by earlier calls, and make it immutable. Once
+  // every transaction that might have read the uncompressed tiles is gone,
+  // a later call frees them. Returns true if the tile group got frozen.
+  bool FreezeTileGroup(const oid_t &tile_group_offset,
+                       const uint64_t &quiet_period);
+
   //===--------------------------------------------------------------------===//
   // STATS
   //===--------------------------------------------------------------------===//
@@ -285,6 +352,30 @@ class DataTable : public AbstractTable {
     default_active_indirection_array_count_ = active_indirection_array_count;
   }
 
+  // Split the active tile groups of tables created afterwards among the NUMA
+  // nodes, so that inserts go to tile groups on the inserter's node
+  static void SetNumaPartitioning(const bool numa_partitioning) {
+    default_numa_partitioning_ = numa_partitioning;
+  }
+
+  // Number of NUMA nodes the active tile groups are split among
+  size_t GetNumaNodeCount() const { return numa_node_count_; }
+
+  // Number of tile groups to keep preallocated per table, at most
+  // TileGroupPreallocator::max_reserve_count. 0 disables preallocation for
+  // tables created afterwards.
+  static void SetTileGroupReserveCount(const size_t tile_group_reserve_count);
+
+  // Returns nullptr if preallocation is disabled for this table
+  const TileGroupPreallocator *GetTileGroupPreallocator() const {
+    return tile_group_preallocator_.get();
+  }
+
+  // Tuple slots reset by the GC, reused before new slots are claimed
+  RecycledSlotAllocator &GetRecycledSlotAllocator() {
+    return recycled_slot_allocator_;
+  }
+
   // Claim a tuple slot in a tile group
   ItemPointer GetEmptyTupleSlot(const storage::Tuple *tuple,
                                 bool check_constraint = true);
@@ -304,8 +395,6 @@ class DataTable : public AbstractTable {
 
   // bool CheckExp(const storage::Tuple *tuple, oid_t column_idx) const;
 
-  bool CheckConstraints(const storage::Tuple *tuple) const;
-
   // add a tile group to the table
   oid_t AddDefaultTileGroup();
   // add a tile group to the table. replace the active_tile_group_id-th active
@@ -314,13 +403,34 @@ class DataTable : public AbstractTable {
 
   oid_t AddDefaultIndirectionArray(const size_t &active_indirection_array_id);
 
+  // active tile group an insert of the calling thread goes to
+  size_t GetActiveTileGroupId() const;
+
+  // allocate a tile group with the current default layout and register it in
+  // the locator, without adding it to the table
+  std::shared_ptr<TileGroup> PrepareDefaultTileGroup();
+
+  // allocate an indirection array and register it in the locator, without
+  // adding it to the table
+  std::shared_ptr<IndirectionArray> PrepareDefaultIndirectionArray();
+
   // Drop all tile groups of the table. Used by recovery
   void DropTileGroups();
 
+  // Swap a drained retired tile group for an empty one once none of its
+  // versions can be reached anymore
+  void ReleaseRetiredTileGroup(const std::shared_ptr<TileGroup> &tile_group);
+
+  // Free the released tile groups no scan can be reading anymore
+  void FreeReleasedTileGroups();
+
   //===--------------------------------------------------------------------===//
   // INDEX HELPERS
   //===--------------------------------------------------------------------===//
 
+  // Take an entry of an active indirection array and point it at location
+  ItemPointer *AllocateIndirection(const ItemPointer &location);
+
   bool InsertInSecondaryIndexes(const AbstractTuple *tuple,
                                 const TargetList *targets_ptr,
                                 concurrency::Transaction *transaction,
@@ -334,6 +444,10 @@ class DataTable : public AbstractTable {
 
   static size_t default_active_indirection_array_count_;
 
+  static size_t default_tile_group_reserve_count_;
+
+  static bool default_numa_partitioning_;
+
  private:
   //===--------------------------------------------------------------------===//
   // MEMBERS
@@ -342,6 +456,10 @@ class DataTable : public AbstractTable {
   size_t active_tilegroup_count_;
   size_t active_indirection_array_count_;
 
+  // active tile groups [i * n, (i + 1) * n) belong to NUMA node i, where
+  // n = active_tilegroup_count_ / numa_node_count_
+  size_t numa_node_count_ = 1;
+
   const oid_t database_oid;
 
   // deprecated, use catalog::TableCatalog::GetInstance()->GetTableName()
@@ -357,6 +475,18 @@ class DataTable : public AbstractTable {
 
   std::atomic<size_t> tile_group_count_ = ATOMIC_VAR_INIT(0);
 
+  // retired tile groups swapped out of the catalog, with the epoch of the
+  // swap
+  std::vector<std::pair<eid_t, std::shared_ptr<storage::TileGroup>>>
+      released_tile_groups_;
+  std::mutex released_tile_groups_mutex_;
+
+  // reserve of ready tile groups and indirection arrays for rollover
+  std::unique_ptr<TileGroupPreallocator> tile_group_preallocator_;
+
+  // tuple slots of older versions recycled by the GC
+  RecycledSlotAllocator recycled_slot_allocator_;
+
   // INDIRECTIONS
   std::vector<std::shared_ptr<storage::IndirectionArray>>
       active_indirection_arrays_;
@@ -376,6 +506,10 @@ class DataTable : public AbstractTable {
   // names of tables for which this table's PK is the foreign key sink
   std::vector<std::string> foreign_key_sources_;
 
+  // materialized views over this table
+  std::vector<std::shared_ptr<MaterializedView>> materialized_views_;
+  std::atomic<bool> has_materialized_views_ = ATOMIC_VAR_INIT(false);
+
   // has a primary key ?
   std::atomic<bool> has_primary_key_ = ATOMIC_VAR_INIT(false);
 
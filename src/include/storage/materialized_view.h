@@ -0,0 +1,326 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// materialized_view.h
+//
+// Identification: src/include/storage/materialized_view.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/abstract_tuple.h"
+#include "common/printable.h"
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace storage {
+
+class DataTable;
+
+// An aggregate a materialized view keeps for every group
+struct MaterializedViewAggregate {
+  MaterializedViewAggregate(ExpressionType aggregate_type, oid_t column_id)
+      : aggregate_type(aggregate_type), column_id(column_id) {}
+
+  // COUNT, COUNT_STAR, SUM, MIN, MAX or AVG
+  ExpressionType aggregate_type;
+
+  // The aggregated column of the table, INVALID_OID for COUNT(*)
+  oid_t column_id;
+};
+
+// A column of the rows read from a materialized view: the group column at
+// offset in the group key if aggregate_type is INVALID, otherwise the
+// aggregate of that type computed from the aggregate at offset
+struct MaterializedViewColumn {
+  MaterializedViewColumn(ExpressionType aggregate_type, oid_t offset)
+      : aggregate_type(aggregate_type), offset(offset) {}
+
+  ExpressionType aggregate_type;
+
+  oid_t offset;
+};
+
+//===--------------------------------------------------------------------===//
+// Materialized View
+//===--------------------------------------------------------------------===//
+
+/**
+ * The result of "SELECT <group columns>, <aggregates> FROM table GROUP BY
+ * <group columns>", kept up to date as transactions modifying the table
+ * commit. The transaction manager applies the inserted, updated and deleted
+ * versions of a committing transaction under the view latch, so the view
+ * always reflects exactly the committed state of the table.
+ *
+ * Every aggregate keeps the count of its non-NULL values, and the running sum
+ * (SUM and AVG) or the extreme value (MIN and MAX), so COUNT and AVG of a
+ * column can be answered from any aggregate over it. Deleting the extreme
+ * value of a group cannot be undone from the extreme alone: the view is then
+ * marked stale and rebuilt from the table by the next reader.
+ *
+ * A rebuild scans the table into new groups without holding the view latch,
+ * and swaps them in at the end. Transactions that began before the scan
+ * wait for it before they commit, so it sees all of their versions or none.
+ * Later ones commit right away, and their changes are applied to the new
+ * groups before the swap.
+ *
+ * The view is populated lazily, and only once every transaction that may
+ * have committed without seeing it attached to the table is gone.
+ *
+ * The view also remembers the highest commit id it has applied. A snapshot
+ * reader reads the view if that is not past its snapshot, since every
+ * commit up to the snapshot is then applied and none after it is.
+ */
+class MaterializedView : public Printable {
+  MaterializedView() = delete;
+  MaterializedView(MaterializedView const &) = delete;
+
+ public:
+  MaterializedView(const std::string &view_name, DataTable *table,
+                   const std::vector<oid_t> &group_column_ids,
+                   const std::vector<MaterializedViewAggregate> &aggregates,
+                   eid_t attach_epoch_id);
+
+  ~MaterializedView();
+
+  std::string GetName() const { return view_name_; }
+
+  DataTable *GetTable() const { return table_; }
+
+  const std::vector<oid_t> &GetGroupColumnIds() const {
+    return group_column_ids_;
+  }
+
+  const std::vector<MaterializedViewAggregate> &GetAggregates() const {
+    return aggregates_;
+  }
+
+  // The offset of the aggregate of the given type over the column, or
+  // INVALID_OID if the view does not keep it
+  oid_t GetAggregateOffset(ExpressionType aggregate_type,
+                           oid_t column_id) const;
+
+  // Whether a query can read the view instead of the table: it must not be
+  // dropped, and every transaction that may have committed before it was
+  // attached must be gone
+  bool IsUsable() const;
+
+  bool IsDetached() const { return detached_; }
+
+  // Whether a transaction may read views: it must not have written anything,
+  // and read either the latest committed state (READ COMMITTED) or a
+  // snapshot (SNAPSHOT and READ ONLY). Serializable transactions must record
+  // the versions they read, which reading the view does not do.
+  static bool CanRead(concurrency::Transaction *txn);
+
+  // Whether any materialized view exists, so commits of transactions can
+  // skip looking for views to maintain
+  static bool HasAnyViews() { return view_count_.load() > 0; }
+
+  //===--------------------------------------------------------------------===//
+  // Maintenance
+  //===--------------------------------------------------------------------===//
+
+  // Latch the view while applying the changes of a committing transaction.
+  // A transaction that began before a running rebuild waits for it first.
+  // A commit id of MAX_CID keeps snapshot readers off the view for good.
+  void Lock(cid_t commit_id = MAX_CID);
+
+  void Unlock() { view_mutex_.unlock(); }
+
+  // Add a committed version of a tuple of the table to its group. The caller
+  // holds the view latch.
+  void ApplyInsert(const AbstractTuple *tuple);
+
+  // Remove a version that is no longer current from its group. The caller
+  // holds the view latch.
+  void ApplyDelete(const AbstractTuple *tuple);
+
+  // Rebuild every group from the tuples of the table visible to a new
+  // transaction
+  void Refresh();
+
+  // Detach the view from its table, when the table or the view is dropped
+  void Detach();
+
+  //===--------------------------------------------------------------------===//
+  // Reading
+  //===--------------------------------------------------------------------===//
+
+  // The given columns of the groups whose group columns at key_offsets are
+  // equal to the key values. The view is populated or rebuilt first if
+  // needed.
+  std::vector<std::vector<type::Value>> GetRows(
+      const std::vector<MaterializedViewColumn> &columns,
+      const std::vector<oid_t> &key_offsets,
+      const std::vector<type::Value> &key_values);
+
+  // The same rows as a transaction that CanRead() views sees them. A
+  // snapshot older than the view is aggregated from the table instead.
+  std::vector<std::vector<type::Value>> GetRows(
+      concurrency::Transaction *txn,
+      const std::vector<MaterializedViewColumn> &columns,
+      const std::vector<oid_t> &key_offsets,
+      const std::vector<type::Value> &key_values);
+
+  // The same rows, aggregated from the tuples of the table the transaction
+  // sees, for readers that cannot use the view
+  std::vector<std::vector<type::Value>> ScanRows(
+      concurrency::Transaction *txn,
+      const std::vector<MaterializedViewColumn> &columns,
+      const std::vector<oid_t> &key_offsets,
+      const std::vector<type::Value> &key_values) const;
+
+  size_t GetGroupCount();
+
+  // Get a string representation for debugging
+  const std::string GetInfo() const;
+
+ private:
+  // What is kept for an aggregate of a group
+  struct AggregateState {
+    // Number of non-NULL values
+    int64_t count = 0;
+
+    // Sum of the values for SUM and AVG, extreme value for MIN and MAX
+    type::Value value;
+  };
+
+  struct Group {
+    // Number of tuples in the group
+    int64_t row_count = 0;
+
+    std::vector<AggregateState> aggregates;
+  };
+
+  struct KeyHasher {
+    size_t operator()(const std::vector<type::Value> &key) const {
+      size_t seed = 0;
+      for (auto &value : key) {
+        value.HashCombine(seed);
+      }
+      return seed;
+    }
+  };
+
+  struct KeyComparator {
+    bool operator()(const std::vector<type::Value> &lhs,
+                    const std::vector<type::Value> &rhs) const {
+      if (lhs.size() != rhs.size()) return false;
+      for (size_t key_itr = 0; key_itr < lhs.size(); key_itr++) {
+        if (lhs[key_itr].IsNull() || rhs[key_itr].IsNull()) {
+          if (lhs[key_itr].IsNull() != rhs[key_itr].IsNull()) return false;
+        } else if (lhs[key_itr].CompareEquals(rhs[key_itr]) !=
+                   type::CMP_TRUE) {
+          return false;
+        }
+      }
+      return true;
+    }
+  };
+
+  typedef std::unordered_map<std::vector<type::Value>, Group, KeyHasher,
+                             KeyComparator> GroupMap;
+
+  // A change committed while the groups are rebuilt
+  struct Delta {
+    bool is_insert;
+    std::vector<type::Value> key;
+    std::vector<type::Value> values;
+  };
+
+  std::vector<type::Value> GetGroupKey(const AbstractTuple *tuple) const;
+
+  // The values of the aggregated columns of a tuple, in aggregate order
+  std::vector<type::Value> GetAggregateValues(const AbstractTuple *tuple) const;
+
+  // Add values to or remove them from their group. Returns false if the
+  // groups went stale.
+  bool AddToGroup(GroupMap &groups, const std::vector<type::Value> &key,
+                  const std::vector<type::Value> &values) const;
+  bool RemoveFromGroup(GroupMap &groups, const std::vector<type::Value> &key,
+                       const std::vector<type::Value> &values) const;
+
+  // Aggregate the tuples of the table the transaction sees. Returns false if
+  // an aggregate is out of range.
+  bool BuildGroups(concurrency::Transaction *txn, GroupMap &groups) const;
+
+  // Populate the view if it never was, or rebuild it if it went stale. The
+  // caller holds the view latch, which is released during a rebuild.
+  void Validate(std::unique_lock<std::mutex> &lock);
+
+  void RebuildGroups(std::unique_lock<std::mutex> &lock);
+
+  std::vector<std::vector<type::Value>> ReadRows(
+      const GroupMap &groups,
+      const std::vector<MaterializedViewColumn> &columns,
+      const std::vector<oid_t> &key_offsets,
+      const std::vector<type::Value> &key_values) const;
+
+  type::Value GetValue(const std::vector<type::Value> &key, const Group &group,
+                       const MaterializedViewColumn &column) const;
+
+ private:
+  std::string view_name_;
+
+  DataTable *table_;
+
+  std::vector<oid_t> group_column_ids_;
+
+  std::vector<MaterializedViewAggregate> aggregates_;
+
+  // Types of the group columns and of the aggregated columns
+  std::vector<type::TypeId> group_types_;
+  std::vector<type::TypeId> aggregate_types_;
+
+  // Epoch in which the view got attached to the table
+  eid_t attach_epoch_id_;
+
+  // Set once the groups are built, until then maintenance is skipped
+  bool populated_ = false;
+
+  // Set when an extreme value got deleted, until the groups are rebuilt
+  bool stale_ = false;
+
+  // The highest commit id applied to the groups, or the id of the scan
+  // they were last rebuilt with if higher
+  cid_t maintained_cid_ = 0;
+
+  std::atomic<bool> detached_ = ATOMIC_VAR_INIT(false);
+
+  GroupMap groups_;
+
+  // Set while a reader scans the table for new groups. Transactions with a
+  // commit id below rebuild_cid_ wait for it to finish, the changes of the
+  // others are kept in pending_.
+  bool rebuilding_ = false;
+  cid_t rebuild_cid_ = 0;
+  std::vector<Delta> pending_;
+
+  std::mutex view_mutex_;
+
+  std::condition_variable rebuild_cv_;
+
+  // Number of views alive
+  static std::atomic<size_t> view_count_;
+};
+
+}  // namespace storage
+}  // namespace peloton
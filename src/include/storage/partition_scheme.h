@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// partition_scheme.h
+//
+// Identification: src/include/storage/partition_scheme.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "common/abstract_tuple.h"
+#include "common/printable.h"
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+
+namespace expression {
+class AbstractExpression;
+}
+
+namespace storage {
+
+struct ZoneMapPredicate;
+
+enum class PartitionType {
+  HASH = 0,   // by the hash of the key
+  RANGE = 1,  // by ranges of keys between bounds
+};
+
+//===--------------------------------------------------------------------===//
+// Partition Scheme
+//===--------------------------------------------------------------------===//
+
+/**
+ * How the tuples of a partitioned table are spread over its partitions, by
+ * the value of a single partition key column.
+ *
+ * A HASH scheme puts a key in partition hash(key) % partition count. Integer
+ * keys hash by their value whatever their width, so a predicate constant of
+ * another integer type still finds the partition of the key.
+ *
+ * A RANGE scheme is given the lower bound of every partition but the first,
+ * in increasing order: partition i holds the keys in [bounds[i - 1],
+ * bounds[i]), the first one everything below bounds[0] and the last one
+ * everything from the last bound up.
+ *
+ * NULL keys always go to the first partition.
+ */
+class PartitionScheme : public Printable {
+ public:
+  // A hash scheme over the given number of partitions
+  PartitionScheme(oid_t column_id, type::TypeId key_type,
+                  size_t partition_count);
+
+  // A range scheme split at the given bounds
+  PartitionScheme(oid_t column_id, const std::vector<type::Value> &bounds);
+
+  PartitionType GetPartitionType() const { return partition_type_; }
+
+  oid_t GetColumnId() const { return column_id_; }
+
+  type::TypeId GetKeyType() const { return key_type_; }
+
+  size_t GetPartitionCount() const { return partition_count_; }
+
+  //===--------------------------------------------------------------------===//
+  // Routing
+  //===--------------------------------------------------------------------===//
+
+  // The partition holding the given key
+  oid_t GetPartition(const type::Value &key) const;
+
+  // The partition holding the given tuple, by its partition key column
+  oid_t GetPartition(const AbstractTuple *tuple) const {
+    return GetPartition(tuple->GetValue(column_id_));
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Pruning
+  //===--------------------------------------------------------------------===//
+
+  // The partitions that may hold tuples satisfying all of the given
+  // predicates, in increasing order. Predicates on other columns, and those
+  // the scheme cannot tell anything from, keep every partition.
+  std::vector<oid_t> Prune(
+      const std::vector<ZoneMapPredicate> &predicates) const;
+
+  // The partitions that may hold tuples satisfying the scan predicate. Its
+  // conjuncts comparing the partition key with a constant, or with a
+  // parameter if parameter values are given, prune partitions, and so does
+  // an IN list of those.
+  std::vector<oid_t> Prune(const expression::AbstractExpression *predicate,
+                           const std::vector<type::Value> *params) const;
+
+  // Get a string representation for debugging
+  const std::string GetInfo() const;
+
+ private:
+  // Whether a key of this type lands in the same partition as an equal key
+  // of the partition key type
+  bool IsRoutable(type::TypeId type_id) const;
+
+  // Restrict the candidates to the partitions that may hold keys satisfying
+  // "key <comparison> value"
+  void Restrict(ExpressionType comparison, const type::Value &value,
+                std::vector<bool> &candidates) const;
+
+  // Restrict the candidates to the partitions of the values of an IN list
+  void RestrictToList(const std::vector<type::Value> &values,
+                      std::vector<bool> &candidates) const;
+
+  // Collect the IN lists of the partition key among the conjuncts
+  void ExtractLists(const expression::AbstractExpression *expr,
+                    const std::vector<type::Value> *params,
+                    std::vector<std::vector<type::Value>> &lists) const;
+
+ private:
+  PartitionType partition_type_;
+
+  oid_t column_id_;
+
+  type::TypeId key_type_;
+
+  size_t partition_count_;
+
+  // Lower bounds of the partitions after the first, for a range scheme
+  std::vector<type::Value> bounds_;
+};
+
+}  // namespace storage
+}  // namespace peloton
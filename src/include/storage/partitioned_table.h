@@ -0,0 +1,147 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// partitioned_table.h
+//
+// Identification: src/include/storage/partitioned_table.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/item_pointer.h"
+#include "common/printable.h"
+#include "storage/partition_scheme.h"
+#include "type/types.h"
+
+namespace peloton {
+
+namespace catalog {
+class Schema;
+}
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace storage {
+
+class DataTable;
+class Tuple;
+
+//===--------------------------------------------------------------------===//
+// Partitioned Table
+//===--------------------------------------------------------------------===//
+
+/**
+ * A table split into partitions by a partition scheme. Every partition is a
+ * DataTable of its own, with the same schema, its own tile groups and its
+ * own (local) indexes, so each index only covers the tuples of a partition.
+ * A unique index therefore only enforces uniqueness within a partition,
+ * which is uniqueness over the table when the partition key is part of the
+ * index key.
+ *
+ * Writes go to the partition of the tuple's key, and scans only need to
+ * visit the partitions left after pruning them with the scan predicate.
+ *
+ * A partitioned table is not in the catalog, so SQL statements and the
+ * optimizer never see it; it is used through this interface, as the TPC-C
+ * driver does, and each of its partitions is an ordinary table.
+ */
+class PartitionedTable : public Printable {
+  PartitionedTable() = delete;
+  PartitionedTable(PartitionedTable const &) = delete;
+
+ public:
+  // The partitions are deleted with the table if own_partitions is set,
+  // otherwise they belong to the database they were added to like any other
+  // table
+  PartitionedTable(const std::string &table_name, PartitionScheme *scheme,
+                   const std::vector<DataTable *> &partitions,
+                   bool own_partitions);
+
+  ~PartitionedTable();
+
+  std::string GetName() const { return table_name_; }
+
+  // The schema shared by all partitions
+  catalog::Schema *GetSchema() const;
+
+  const PartitionScheme *GetPartitionScheme() const { return scheme_.get(); }
+
+  size_t GetPartitionCount() const { return partitions_.size(); }
+
+  DataTable *GetPartition(oid_t partition_id) const {
+    return partitions_[partition_id];
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Routing
+  //===--------------------------------------------------------------------===//
+
+  // The partition holding the given partition key
+  DataTable *GetPartitionForKey(const type::Value &key) const {
+    return partitions_[scheme_->GetPartition(key)];
+  }
+
+  // The partition the given tuple belongs to
+  DataTable *GetPartitionForTuple(const AbstractTuple *tuple) const {
+    return partitions_[scheme_->GetPartition(tuple)];
+  }
+
+  // Insert the tuple into its partition, see DataTable::InsertTuple()
+  ItemPointer InsertTuple(const Tuple *tuple,
+                          concurrency::Transaction *transaction,
+                          ItemPointer **index_entry_ptr = nullptr);
+
+  //===--------------------------------------------------------------------===//
+  // Indexes
+  //===--------------------------------------------------------------------===//
+
+  // Build an index of the given definition on every partition. The local
+  // indexes share the index oid, so the index of a partition is found with
+  // GetIndexWithOid() on it as with any table.
+  void AddIndex(const std::string &index_name, oid_t index_oid,
+                IndexType index_type, IndexConstraintType constraint_type,
+                const std::vector<oid_t> &key_attrs, bool unique_keys);
+
+  //===--------------------------------------------------------------------===//
+  // Pruning
+  //===--------------------------------------------------------------------===//
+
+  // The ids of the partitions a scan with the given predicate has to visit
+  std::vector<oid_t> PrunePartitions(
+      const expression::AbstractExpression *predicate,
+      const std::vector<type::Value> *params = nullptr) const {
+    return scheme_->Prune(predicate, params);
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Utilities
+  //===--------------------------------------------------------------------===//
+
+  // The number of tuples over all partitions
+  size_t GetTupleCount() const;
+
+  // Get a string representation for debugging
+  const std::string GetInfo() const;
+
+ private:
+  std::string table_name_;
+
+  std::unique_ptr<PartitionScheme> scheme_;
+
+  std::vector<DataTable *> partitions_;
+
+  bool own_partitions_;
+};
+
+}  // namespace storage
+}  // namespace peloton
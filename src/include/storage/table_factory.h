@@ -17,6 +17,7 @@
 #include "catalog/manager.h"
 #include "type/types.h"
 #include "storage/data_table.h"
+#include "storage/partitioned_table.h"
 #include "storage/temp_table.h"
 
 namespace peloton {
@@ -36,6 +37,18 @@ class TableFactory {
                                  size_t tuples_per_tile_group_count,
                                  bool own_schema, bool adapt_table, bool is_catalog = false);
 
+  /**
+   * Instantiate a table split into partitions by the given scheme, which
+   * the table takes over. Every partition is a DataTable with a copy of the
+   * schema, named after the table and the partition and with consecutive
+   * oids from first_table_id on. Like the tables of GetDataTable(), they
+   * are the caller's to add to a database unless own_partitions is set.
+   */
+  static PartitionedTable *GetPartitionedTable(
+      oid_t database_id, oid_t first_table_id, const catalog::Schema *schema,
+      std::string table_name, size_t tuples_per_tile_group_count,
+      PartitionScheme *scheme, bool own_partitions);
+
   static TempTable *GetTempTable(catalog::Schema *schema, bool own_schema);
 
   /**
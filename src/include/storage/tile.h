@@ -12,11 +12,15 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 #include "catalog/manager.h"
 #include "catalog/schema.h"
 #include "common/item_pointer.h"
+#include "common/macros.h"
 #include "common/printable.h"
 #include "type/abstract_pool.h"
 #include "type/serializeio.h"
@@ -38,6 +42,7 @@ class Tuple;
 class TileGroup;
 class TileGroupHeader;
 class TupleIterator;
+class CompressedColumn;
 
 /**
  * Represents a Tile.
@@ -110,6 +115,11 @@ class Tile : public Printable {
                     const size_t column_offset, const bool is_inlined,
                     const size_t column_length);
 
+  // Returns where the raw inlined bytes of a field can be read. For a frozen
+  // tile they are decoded to buffer, which must hold sizeof(uint64_t) bytes.
+  const char *GetFieldLocation(const oid_t tuple_offset, const oid_t column_id,
+                               char *buffer) const;
+
   // Get tuple at location
   static Tuple *GetTuple(catalog::Manager *catalog,
                          const ItemPointer *tuple_location);
@@ -117,6 +127,29 @@ class Tile : public Printable {
   // Copy current tile in given backend and return new tile
   Tile *CopyTile(BackendType backend_type);
 
+  //===--------------------------------------------------------------------===//
+  // Compression
+  //===--------------------------------------------------------------------===//
+
+  // Compress every column of the tile. From then on values are read from the
+  // compressed columns and the tile must not be written to. Returns false if
+  // the tile is already frozen or has a column that cannot be compressed.
+  bool Freeze();
+
+  bool IsFrozen() const { return frozen.load(); }
+
+  // Free the uncompressed slots of a frozen tile. The caller must make sure
+  // that no reader that saw the tile before it was frozen is still running.
+  void ReleaseUncompressedData();
+
+  bool HasUncompressedData() const { return data != nullptr; }
+
+  // Returns nullptr unless the tile is frozen
+  const CompressedColumn *GetCompressedColumn(const oid_t column_id) const;
+
+  // Bytes used by the compressed columns
+  size_t GetCompressedSize() const;
+
   //===--------------------------------------------------------------------===//
   // Size Stats
   //===--------------------------------------------------------------------===//
@@ -147,6 +180,8 @@ class Tile : public Printable {
 
   oid_t GetTileId() const { return tile_id; }
 
+  BackendType GetBackendType() const { return backend_type; }
+
   // Compare two tiles
   bool operator==(const Tile &other) const;
   bool operator!=(const Tile &other) const;
@@ -228,11 +263,19 @@ class Tile : public Printable {
    * This is maintained by shared Tile Header.
    */
   TileGroupHeader *tile_group_header;
+
+  // the compressed copy of every column, built when the tile is frozen
+  std::vector<std::unique_ptr<CompressedColumn>> compressed_columns;
+
+  // set once compressed_columns is complete
+  std::atomic<bool> frozen = ATOMIC_VAR_INIT(false);
 };
 
 // Returns a pointer to the tuple requested. No checks are done that the index
-// is valid.
+// is valid. Frozen tiles may have released their slots, values have to be
+// read through GetValue() or GetFieldLocation() instead.
 inline char *Tile::GetTupleLocation(const oid_t tuple_offset) const {
+  PL_ASSERT(data != nullptr);
   char *tuple_location = data + (tuple_offset * tuple_length);
 
   return tuple_location;
@@ -52,6 +52,8 @@ class TileGroupHeader;
 class AbstractTable;
 class TileGroupIterator;
 class RollbackSegment;
+class ZoneMap;
+struct ZoneMapPredicate;
 
 typedef std::map<oid_t, std::pair<oid_t, oid_t>> column_map_type;
 
@@ -182,6 +184,69 @@ class TileGroup : public Printable {
 
   double GetSchemaDifference(const storage::column_map_type &new_column_map);
 
+  // A retired tile group had all of its live tuples moved elsewhere by the
+  // data table. It only holds old versions and its slots are never reused.
+  bool IsRetired() const { return retired.load(); }
+
+  void SetRetired(bool is_retired) { retired.store(is_retired); }
+
+  // Epoch in which a retired tile group was found drained, 0 until then
+  eid_t GetRetireEpochId() const { return retire_epoch_id; }
+
+  void SetRetireEpochId(const eid_t &epoch_id) { retire_epoch_id = epoch_id; }
+
+  //===--------------------------------------------------------------------===//
+  // Compression
+  //===--------------------------------------------------------------------===//
+
+  // Turn a full tile group into an immutable one whose tiles are compressed.
+  // Fails if any slot is empty or owned by a transaction, since either may
+  // still be written to. The epoch is remembered for
+  // ReleaseUncompressedData().
+  bool Freeze(const eid_t &epoch_id);
+
+  // A frozen tile group is never written to again and its recycled slots
+  // are not reused
+  bool IsFrozen() const { return frozen.load(); }
+
+  eid_t GetFreezeEpochId() const { return freeze_epoch_id; }
+
+  // Free the uncompressed tiles once no reader from before Freeze() is left
+  void ReleaseUncompressedData();
+
+  bool HasUncompressedData() const;
+
+  // Bytes used by the compressed tiles
+  size_t GetCompressedSize() const;
+
+  // Milliseconds since the data of the tile group last changed, as seen by
+  // successive calls. The first call only starts the clock. Must only be
+  // called from a single thread.
+  uint64_t GetQuietPeriod();
+
+  //===--------------------------------------------------------------------===//
+  // Scan Pruning
+  //===--------------------------------------------------------------------===//
+
+  // Returns false only if no tuple in the tile group can satisfy all of the
+  // given predicates. Besides the zone map, equality predicates are checked
+  // against the dictionaries and runs of frozen tiles.
+  bool ShouldScan(const ZoneMapPredicate *predicates,
+                  size_t num_predicates) const;
+
+  //===--------------------------------------------------------------------===//
+  // Zone Map
+  //===--------------------------------------------------------------------===//
+
+  ZoneMap *GetZoneMap() const { return zone_map.get(); }
+
+  // Fold the current contents of the given slot into the zone map. Must be
+  // called by writers that fill a slot without going through this class.
+  void UpdateZoneMap(const oid_t &tuple_slot_id);
+
+  // Recompute the zone map from all allocated slots
+  void RebuildZoneMap();
+
   // Sync the contents
   void Sync();
 
@@ -221,6 +286,24 @@ class TileGroup : public Printable {
   // column to tile mapping :
   // <column offset> to <tile offset, tile column offset>
   column_map_type column_map;
+
+  // per-column value ranges used for scan pruning
+  std::unique_ptr<ZoneMap> zone_map;
+
+  // set once the live tuples have been relocated out of this tile group
+  std::atomic<bool> retired = ATOMIC_VAR_INIT(false);
+
+  eid_t retire_epoch_id = 0;
+
+  // set once the tile group stops accepting writes to be compressed
+  std::atomic<bool> frozen = ATOMIC_VAR_INIT(false);
+
+  eid_t freeze_epoch_id = 0;
+
+  // zone map version and time at which GetQuietPeriod() last saw a write
+  uint64_t quiet_version = 0;
+
+  uint64_t quiet_since = 0;
 };
 
 }  // namespace storage
@@ -34,6 +34,17 @@ class TileGroupFactory {
                                  const std::vector<catalog::Schema> &schemas,
                                  const column_map_type &column_map,
                                  int tuple_count);
+
+  // Backend new tile groups are allocated on. SSD and HDD tile groups live in
+  // the memory-mapped data file of the BackendManager.
+  static void SetBackendType(BackendType backend_type) {
+    backend_type_ = backend_type;
+  }
+
+  static BackendType GetBackendType() { return backend_type_; }
+
+ private:
+  static BackendType backend_type_;
 };
 
 }  // namespace storage
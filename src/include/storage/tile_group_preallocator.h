@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_preallocator.h
+//
+// Identification: src/include/storage/tile_group_preallocator.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include "common/macros.h"
+#include "storage/tile_group.h"
+
+namespace peloton {
+namespace storage {
+
+class DataTable;
+class IndirectionArray;
+class TileGroupRefiller;
+
+//===--------------------------------------------------------------------===//
+// Tile Group Preallocator
+//===--------------------------------------------------------------------===//
+
+/**
+ * Keeps a small reserve of ready-to-use tile groups and indirection arrays for
+ * a table, so that an inserter that fills up an active tile group only has to
+ * swap in a pointer instead of allocating, zeroing and registering a new one
+ * on the insert path.
+ *
+ * The reserves of all tables are refilled by one shared background thread,
+ * which is started the first time anything is taken from a reserve. Reserved
+ * tile groups and indirection arrays are already registered in the catalog
+ * manager's locator, but are not part of the table until they are handed out.
+ * Reserved tile groups have the layout new tile groups had at the time they
+ * were allocated; when the layout changes they are dropped and reallocated.
+ * If the reserve is empty the caller is expected to fall back to allocating
+ * synchronously; these misses are counted so that an undersized reserve shows
+ * up.
+ */
+class TileGroupPreallocator {
+  friend class TileGroupRefiller;
+
+ public:
+  // Largest reserve a table may keep
+  static const size_t max_reserve_count = 64;
+
+  TileGroupPreallocator(DataTable *table, size_t reserve_count);
+
+  // Waits for a refill in progress and releases everything still in reserve
+  ~TileGroupPreallocator();
+
+  // Take a tile group with the given layout from the reserve. Returns nullptr
+  // if the reserve is currently empty. If the reserved tile groups have
+  // another layout, they are dropped and reallocated with the new one.
+  std::shared_ptr<TileGroup> TakeTileGroup(const column_map_type &layout);
+
+  // Take an indirection array from the reserve. Returns nullptr if the
+  // reserve is currently empty.
+  std::shared_ptr<IndirectionArray> TakeIndirectionArray();
+
+  //===--------------------------------------------------------------------===//
+  // Statistics
+  //===--------------------------------------------------------------------===//
+
+  // Number of rollovers served from the reserve
+  size_t GetTileGroupHitCount() const { return tile_group_hits_.load(); }
+
+  // Number of rollovers that had to allocate synchronously
+  size_t GetTileGroupMissCount() const { return tile_group_misses_.load(); }
+
+  size_t GetIndirectionArrayHitCount() const {
+    return indirection_array_hits_.load();
+  }
+
+  size_t GetIndirectionArrayMissCount() const {
+    return indirection_array_misses_.load();
+  }
+
+ private:
+  DISALLOW_COPY_AND_MOVE(TileGroupPreallocator);
+
+  // Queue the table for the refill thread. Caller must hold the mutex.
+  void RequestRefill();
+
+  // Drop the reserved tile groups, which have an outdated layout. Caller
+  // must hold the mutex.
+  void DiscardTileGroups();
+
+  // Fill up the reserve. Runs on the refill thread.
+  void Refill();
+
+ private:
+  DataTable *table_;
+
+  // Number of tile groups (and indirection arrays) to keep around
+  const size_t reserve_count_;
+
+  std::deque<std::shared_ptr<TileGroup>> tile_groups_;
+  std::deque<std::shared_ptr<IndirectionArray>> indirection_arrays_;
+
+  // Bumped when the layout changes, so that a tile group allocated with the
+  // previous layout while the mutex was released is not kept
+  size_t layout_generation_ = 0;
+
+  std::mutex mutex_;
+  bool stopped_ = false;
+
+  std::atomic<size_t> tile_group_hits_ = ATOMIC_VAR_INIT(0);
+  std::atomic<size_t> tile_group_misses_ = ATOMIC_VAR_INIT(0);
+  std::atomic<size_t> indirection_array_hits_ = ATOMIC_VAR_INIT(0);
+  std::atomic<size_t> indirection_array_misses_ = ATOMIC_VAR_INIT(0);
+};
+
+}  // namespace storage
+}  // namespace peloton
@@ -0,0 +1,172 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// zone_map.h
+//
+// Identification: src/include/storage/zone_map.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <vector>
+
+#include "common/platform.h"
+#include "common/printable.h"
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+
+class AbstractTuple;
+
+namespace catalog {
+class Schema;
+}
+
+namespace expression {
+class AbstractExpression;
+}
+
+namespace storage {
+
+class TileGroup;
+
+//===--------------------------------------------------------------------===//
+// Zone Map Predicate
+//===--------------------------------------------------------------------===//
+
+/**
+ * A simple predicate of the form <column> <comparison> <value> that can be
+ * checked against the per-column ranges kept in a zone map. A scan predicate
+ * is turned into a list of these (one per AND-ed comparison); anything that
+ * does not fit this shape is simply ignored for pruning purposes.
+ */
+struct ZoneMapPredicate {
+  ZoneMapPredicate(oid_t column_id, ExpressionType comparison,
+                   const type::Value &value)
+      : column_id(column_id),
+        comparison(comparison),
+        // IS NULL has no value to copy
+        value(value.GetTypeId() == type::TypeId::INVALID ? value
+                                                         : value.Copy()) {}
+
+  oid_t column_id;
+  ExpressionType comparison;
+  type::Value value;
+};
+
+//===--------------------------------------------------------------------===//
+// Zone Map
+//===--------------------------------------------------------------------===//
+
+/**
+ * Per tile group summary of the values stored in each column: the minimum and
+ * maximum non-null value and the number of nulls written. Scans consult it to
+ * skip tile groups whose ranges cannot satisfy the scan predicate.
+ *
+ * The map is maintained by widening: every write that goes through the tile
+ * group (insert, recycled slot reuse, in-place update, new version) folds the
+ * written values into the ranges. This keeps the map a superset of every
+ * physical version in the tile group -- visible or not -- so pruning never
+ * drops a qualifying tuple. Rebuild() recomputes the ranges from scratch for
+ * tile groups that were filled without going through those paths (e.g. by a
+ * layout transformation) or to tighten a map after in-place updates.
+ *
+ * Only fixed-width, orderable types are tracked. Predicates over other
+ * columns never cause a tile group to be skipped.
+ */
+class ZoneMap : public Printable {
+  ZoneMap() = delete;
+  ZoneMap(ZoneMap const &) = delete;
+
+ public:
+  // Build an (empty) zone map for a tile group with the given tile schemas
+  // and column layout
+  ZoneMap(const std::vector<catalog::Schema> &tile_schemas,
+          const std::map<oid_t, std::pair<oid_t, oid_t>> &column_map);
+
+  //===--------------------------------------------------------------------===//
+  // Maintenance
+  //===--------------------------------------------------------------------===//
+
+  // Fold all the values of the given tuple into the map
+  void UpdateWithTuple(const AbstractTuple *tuple);
+
+  // Fold a single value of the given column into the map
+  void UpdateWithValue(oid_t column_id, const type::Value &value);
+
+  // Recompute the ranges from all the slots allocated in the tile group
+  void Rebuild(TileGroup *tile_group);
+
+  // Changes whenever a write is folded into the map
+  uint64_t GetVersion() const {
+    return version_.load(std::memory_order_acquire);
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Pruning
+  //===--------------------------------------------------------------------===//
+
+  // Returns false only if no tuple in the tile group can satisfy all of the
+  // given predicates
+  bool ShouldScan(const ZoneMapPredicate *predicates,
+                  size_t num_predicates) const;
+
+  bool ShouldScan(const std::vector<ZoneMapPredicate> &predicates) const {
+    return ShouldScan(predicates.data(), predicates.size());
+  }
+
+  // Retrieve the statistics of a column. Returns false if the column is not
+  // tracked or has not seen a non-null value yet.
+  bool GetColumnRange(oid_t column_id, type::Value &min, type::Value &max,
+                      size_t &null_count) const;
+
+  // Can columns of this type be tracked in a zone map?
+  static bool IsTrackedType(type::TypeId type_id);
+
+  // Collect the zone-map-checkable conjuncts of the given scan predicate.
+  // Parameter expressions are resolved through the given parameter values,
+  // or ignored if none are provided.
+  static void ExtractPredicates(const expression::AbstractExpression *expr,
+                                const std::vector<type::Value> *params,
+                                std::vector<ZoneMapPredicate> &predicates);
+
+  // Get a string representation for debugging
+  const std::string GetInfo() const;
+
+ private:
+  struct ColumnRange {
+    // Is this column tracked at all?
+    bool tracked = false;
+    // Has a non-null value been folded in?
+    bool has_values = false;
+    type::Value min;
+    type::Value max;
+    size_t null_count = 0;
+  };
+
+  // Fold a value into the given range. Caller must hold the lock.
+  static void Widen(ColumnRange &range, const type::Value &value);
+
+  // Can any value in the given range satisfy the predicate?
+  static bool MayMatch(const ColumnRange &range,
+                       const ZoneMapPredicate &predicate);
+
+ private:
+  std::vector<ColumnRange> columns_;
+
+  // Bumped on every widening so that a concurrent Rebuild() can detect that
+  // it raced with a writer and must not install its (possibly stale) ranges
+  std::atomic<uint64_t> version_;
+
+  mutable Spinlock lock_;
+};
+
+}  // namespace storage
+}  // namespace peloton
@@ -11,6 +11,9 @@
 //===----------------------------------------------------------------------===//
 
 #pragma once
+#include <atomic>
+#include <mutex>
+
 #include "task_queue.h"
 #include "worker_pool.h"
 
@@ -47,8 +50,12 @@ class MonoQueuePool {
 
   void SubmitTask(void (*task_ptr)(void *), void *task_arg,
                   void (*callback_ptr)(void *), void *callback_arg) {
-    if (startup_ == false)
-      Startup();
+    // Queries submit from many threads, only one of them may start the pool
+    if (startup_ == false) {
+      std::lock_guard<std::mutex> lock(startup_mutex_);
+      if (startup_ == false)
+        Startup();
+    }
     task_queue_.Enqueue(task_ptr, task_arg, callback_ptr, callback_arg);
   }
 
@@ -60,7 +67,8 @@ class MonoQueuePool {
  private:
   TaskQueue task_queue_;
   WorkerPool worker_pool_;
-  bool startup_;
+  std::atomic<bool> startup_;
+  std::mutex startup_mutex_;
 };
 
 } // namespace threadpool
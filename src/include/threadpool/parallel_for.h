@@ -0,0 +1,39 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// parallel_for.h
+//
+// Identification: src/include/threadpool/parallel_for.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace peloton {
+namespace threadpool {
+
+/**
+ * Run task(0) ... task(count - 1) on the shared worker pool.
+ *
+ * The calling thread works on the items as well, and helpers that get to run
+ * only after everything is done return right away. This means a task running
+ * on a worker, like query execution, can call ParallelFor without waiting on
+ * the other workers, and without deadlocking when all of them are busy. At
+ * most max_parallelism threads, the caller included, work on the items at a
+ * time. Returns once every item is done. If a task throws, the remaining
+ * items are skipped and the first exception is rethrown.
+ */
+void ParallelFor(size_t count, size_t max_parallelism,
+                 const std::function<void(size_t)> &task);
+
+// Number of threads ParallelFor can put to work, the caller included
+size_t GetParallelism();
+
+}  // namespace threadpool
+}  // namespace peloton
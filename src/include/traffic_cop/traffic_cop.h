@@ -33,6 +33,8 @@ namespace peloton {
 //void ExecutePlanWrapper(void *arg_ptr);
 namespace tcop {
 
+struct PipelinedStatement;
+
 //===--------------------------------------------------------------------===//
 // TRAFFIC COP
 //===--------------------------------------------------------------------===//
@@ -69,12 +71,13 @@ class TrafficCop {
       std::string &error_message, const size_t thread_id = 0);
 
   // ExecutePrepStmt - Helper to handle txn-specifics for the plan-tree of a
-  // statement
+  // statement. With explain_analyze, the result is the profile of the plan.
   executor::ExecuteResult ExecuteStatementPlan(
       std::shared_ptr<planner::AbstractPlan> plan,
       const std::vector<type::Value> &params,
       std::vector<StatementResult> &result,
-      const std::vector<int> &result_format, const size_t thread_id = 0);
+      const std::vector<int> &result_format, const size_t thread_id = 0,
+      bool explain_analyze = false);
 
   // InitBindPrepStmt - Prepare and bind a query from a query string
   std::shared_ptr<Statement> PrepareStatement(const std::string &statement_name,
@@ -106,6 +109,13 @@ class TrafficCop {
 
   static void ExecutePlanWrapper(void *arg_ptr);
 
+  // Queue a pipeline of bound statements as a single task, the worker runs
+  // them back-to-back and stops at the first statement that fails
+  ResultType ExecutePipeline(std::vector<PipelinedStatement> &pipeline,
+                             const size_t thread_id = 0);
+
+  static void ExecutePipelineWrapper(void *arg_ptr);
+
   void SetTaskCallback(void(* task_callback)(void*), void *task_callback_arg) {
     task_callback_ = task_callback;
     task_callback_arg_ = task_callback_arg;
@@ -125,12 +135,13 @@ class TrafficCop {
   // Default database name
   std::string default_database_name_ = DEFAULT_DB_NAME;
 
-  // The optimizer used for this connection
-  std::unique_ptr<optimizer::AbstractOptimizer> optimizer_;
-
   // flag of single statement txn
   bool single_statement_txn_;
 
+  // flag of running plans on the calling thread, set while a worker runs
+  // a pipeline
+  bool execute_inline_ = false;
+
   // flag of psql protocol
   // executePlan arguments
 
@@ -140,10 +151,16 @@ class TrafficCop {
 //  IOTrigger io_trigger_;
 
   // pair of txn ptr and the result so-far for that txn
-  // use a stack to support nested-txns
+  // use a stack to support nested-txns, over a vector that allocates nothing
+  // until the connection runs a statement
   typedef std::pair<concurrency::Transaction *, ResultType> TcopTxnState;
 
-  std::stack<TcopTxnState> tcop_txn_state_;
+  typedef std::stack<TcopTxnState, std::vector<TcopTxnState>> TcopTxnStack;
+
+  TcopTxnStack tcop_txn_state_;
+
+  // The optimizer of the calling thread, shared by its connections
+  static optimizer::AbstractOptimizer &GetOptimizer();
 
   static TcopTxnState &GetDefaultTxnState();
 
@@ -177,13 +194,15 @@ struct ExecutePlanArg {
                         const std::vector<type::Value> &params,
                         std::vector<StatementResult> &result,
                         const std::vector<int> &result_format,
-                        executor::ExecuteResult &p_status) :
+                        executor::ExecuteResult &p_status,
+                        bool explain_analyze = false) :
       plan_(plan),
       txn_(txn),
       params_(params),
       result_(result),
       result_format_(result_format),
-      p_status_(p_status) {}
+      p_status_(p_status),
+      explain_analyze_(explain_analyze) {}
 //      event_(event) {}
 //      io_trigger_(io_trigger) { }
 
@@ -194,9 +213,46 @@ struct ExecutePlanArg {
   std::vector<StatementResult> &result_;
   const std::vector<int> &result_format_;
   executor::ExecuteResult &p_status_;
+  bool explain_analyze_;
 //  struct event* event_;
 //  IOTrigger *io_trigger_;
 };
 
+//===--------------------------------------------------------------------===//
+// TrafficCop: A bound statement of a pipeline and the result of running it
+//===--------------------------------------------------------------------===//
+struct PipelinedStatement {
+  // Whether the statement failed, which ends its pipeline
+  bool Failed() const {
+    return status_ == ResultType::FAILURE ||
+           (status_ == ResultType::ABORTED &&
+            statement_->GetQueryType() != QueryType::QUERY_ROLLBACK);
+  }
+
+  std::shared_ptr<Statement> statement_;
+  std::vector<type::Value> params_;
+  std::shared_ptr<stats::QueryMetric::QueryParams> param_stats_;
+  std::vector<int> result_format_;
+  std::vector<StatementResult> results_;
+  int rows_changed_ = 0;
+  std::string error_message_;
+  // INVALID if the statement was not run
+  ResultType status_ = ResultType::INVALID;
+};
+
+//===--------------------------------------------------------------------===//
+// TrafficCop: Wrapper struct ExecutePipeline argument
+//===--------------------------------------------------------------------===//
+struct ExecutePipelineArg {
+  inline ExecutePipelineArg(TrafficCop *tcop,
+                            std::vector<PipelinedStatement> &pipeline,
+                            const size_t thread_id)
+      : tcop_(tcop), pipeline_(pipeline), thread_id_(thread_id) {}
+
+  TrafficCop *tcop_;
+  std::vector<PipelinedStatement> &pipeline_;
+  size_t thread_id_;
+};
+
 }  // namespace tcop
 }  // namespace peloton
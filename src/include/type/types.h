@@ -176,6 +176,8 @@ enum class ExpressionType {
   COMPARE_IN = 19,
   // IS DISTINCT FROM operator
   COMPARE_DISTINCT_FROM = 20,
+  // ILIKE operator (left ILIKE right). Both children must be string.
+  COMPARE_ILIKE = 21,
 
   // -----------------------------
   // Conjunction Operators
@@ -328,6 +330,7 @@ enum class NetworkMessageType : unsigned char {
   READY_FOR_QUERY = 'Z',
   ROW_DESCRIPTION = 'T',
   DATA_ROW = 'D',
+  COPY_IN_RESPONSE = 'G',
   // Errors
   HUMAN_READABLE_ERROR = 'M',
   SQLSTATE_CODE_ERROR = 'C',
@@ -340,6 +343,10 @@ enum class NetworkMessageType : unsigned char {
   PARSE_COMMAND = 'P',
   SIMPLE_QUERY_COMMAND = 'Q',
   CLOSE_COMMAND = 'C',
+  // Copy sub-protocol
+  COPY_DATA_COMMAND = 'd',
+  COPY_DONE_COMMAND = 'c',
+  COPY_FAIL_COMMAND = 'f',
   // SSL willingness
   SSL_YES = 'S',
   SSL_NO = 'N',
@@ -558,6 +565,7 @@ enum class PlanNodeType {
   ABSTRACT_SCAN = 10,
   SEQSCAN = 11,
   INDEXSCAN = 12,
+  MATERIALIZED_VIEW_SCAN = 13,
 
   // Join Nodes
   NESTLOOP = 20,
@@ -615,7 +623,8 @@ enum class CreateType {
   TABLE = 2,                  // table create type
   INDEX = 3,                  // index create type
   CONSTRAINT = 4,             // constraint create type
-  TRIGGER = 5                 // trigger create type
+  TRIGGER = 5,                // trigger create type
+  MATERIALIZED_VIEW = 6       // materialized view create type
 };
 std::string CreateTypeToString(CreateType type);
 CreateType StringToCreateType(const std::string &str);
@@ -631,7 +640,8 @@ enum class DropType {
   TABLE = 2,                  // table drop type
   INDEX = 3,                  // index drop type
   CONSTRAINT = 4,             // constraint drop type
-  TRIGGER = 5                 // trigger drop type
+  TRIGGER = 5,                // trigger drop type
+  MATERIALIZED_VIEW = 6       // materialized view drop type
 };
 std::string DropTypeToString(DropType type);
 DropType StringToDropType(const std::string &str);
@@ -698,7 +708,8 @@ enum class JoinType {
   RIGHT = 2,                  // right
   INNER = 3,                  // inner
   OUTER = 4,                  // outer
-  SEMI = 5                    // IN+Subquery is SEMI
+  SEMI = 5,                   // IN+Subquery is SEMI
+  ANTI = 6                    // NOT IN+Subquery is ANTI
 };
 std::string JoinTypeToString(JoinType type);
 JoinType StringToJoinType(const std::string &str);
@@ -1044,6 +1055,8 @@ enum class OperatorId : uint32_t {
   Sqrt,
   Extract,
   Floor,
+  Like,
+  ILike,
 
   // Add more operators here, before the last "Invalid" entry
 
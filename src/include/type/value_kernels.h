@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// value_kernels.h
+//
+// Identification: src/include/type/value_kernels.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace type {
+
+//===--------------------------------------------------------------------===//
+// Value Kernels
+//
+// Comparison and arithmetic on fixed-width values without going through the
+// virtual methods of Type. A kernel is resolved once for the types of both
+// sides, e.g. when an expression is planned, and may only be called on
+// values of exactly those types, which Matches() checks. Overflow and
+// division by zero are handed back to the generic Value methods, so the
+// results and the errors are the same as theirs.
+//===--------------------------------------------------------------------===//
+
+template <class Result>
+class ValueKernel {
+ public:
+  typedef Result (*Function)(const Value &left, const Value &right);
+
+  ValueKernel()
+      : left_(TypeId::INVALID), right_(TypeId::INVALID), function_(nullptr) {}
+
+  ValueKernel(TypeId left, TypeId right, Function function)
+      : left_(left), right_(right), function_(function) {}
+
+  bool IsValid() const { return function_ != nullptr; }
+
+  // Whether the kernel can be called on these values
+  inline bool Matches(const Value &left, const Value &right) const {
+    return function_ != nullptr && left.GetTypeId() == left_ &&
+           right.GetTypeId() == right_;
+  }
+
+  inline Result operator()(const Value &left, const Value &right) const {
+    return function_(left, right);
+  }
+
+ private:
+  TypeId left_;
+  TypeId right_;
+  Function function_;
+};
+
+typedef ValueKernel<CmpBool> CompareKernel;
+typedef ValueKernel<Value> ArithmeticKernel;
+
+class ValueKernels {
+ public:
+  // The kernel of a COMPARE_* expression type on values of the given types.
+  // The kernel is invalid if the types have none.
+  static CompareKernel GetCompare(ExpressionType type, TypeId left,
+                                  TypeId right);
+
+  // The kernel of an OPERATOR_* expression type on values of the given types
+  static ArithmeticKernel GetArithmetic(ExpressionType type, TypeId left,
+                                        TypeId right);
+
+  // The kernels of Value::Min and Value::Max on two values of the same type
+  static ArithmeticKernel GetMin(TypeId type_id);
+  static ArithmeticKernel GetMax(TypeId type_id);
+};
+
+}  // namespace type
+}  // namespace peloton
@@ -13,10 +13,24 @@
 
 #include "common/macros.h"
 #include "logging/log_buffer.h"
+#include "storage/backend_manager.h"
 
 namespace peloton {
 namespace logging {
 
+LogBuffer::LogBuffer(const size_t thread_id, const size_t eid)
+    : thread_id_(thread_id), eid_(eid), size_(0) {
+  data_ = reinterpret_cast<char *>(storage::BackendManager::GetInstance()
+                                       .Allocate(BackendType::MM,
+                                                 log_buffer_capacity_));
+  PL_MEMSET(data_, 0, log_buffer_capacity_);
+}
+
+LogBuffer::~LogBuffer() {
+  storage::BackendManager::GetInstance().Release(BackendType::MM, data_);
+  data_ = nullptr;
+}
+
 bool LogBuffer::WriteData(const char *data, size_t len) {
   if (unlikely_branch(size_ + len > log_buffer_capacity_)) {
     return false;
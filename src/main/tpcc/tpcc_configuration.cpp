@@ -32,12 +32,15 @@ void Usage(FILE *out) {
           "   -p --profile_duration  :  profile duration \n"
           "   -b --backend_count     :  # of backends \n"
           "   -w --warehouse_count   :  # of warehouses \n"
+          "   -c --partition_count   :  # of warehouse range partitions per table \n"
           "   -e --exp_backoff       :  enable exponential backoff \n"
           "   -a --affinity          :  enable client affinity \n"
           "   -g --gc_mode           :  enable garbage collection \n"
           "   -n --gc_backend_count  :  # of gc backends \n"
           "   -l --loader_count      :  # of loaders \n"
           "   -y --epoch             :  epoch type: centralized or decentralized \n"
+          "   -r --arrival_rate      :  open loop arrivals per second (0: closed loop) \n"
+          "   -t --arrival           :  open loop arrivals: poisson (default) or fixed \n"
   );
 }
 
@@ -48,12 +51,15 @@ static struct option opts[] = {
     { "profile_duration", optional_argument, NULL, 'p' },
     { "backend_count", optional_argument, NULL, 'b' },
     { "warehouse_count", optional_argument, NULL, 'w' },
+    { "partition_count", optional_argument, NULL, 'c' },
     { "exp_backoff", no_argument, NULL, 'e' },
     { "affinity", no_argument, NULL, 'a' },
     { "gc_mode", no_argument, NULL, 'g' },
     { "gc_backend_count", optional_argument, NULL, 'n' },
     { "loader_count", optional_argument, NULL, 'n' },
     { "epoch", optional_argument, NULL, 'y' },
+    { "arrival_rate", optional_argument, NULL, 'r' },
+    { "arrival", optional_argument, NULL, 't' },
     { NULL, 0, NULL, 0 }
 };
 
@@ -109,6 +115,16 @@ void ValidateWarehouseCount(const configuration &state) {
   LOG_TRACE("%s : %d", "warehouse_count", state.warehouse_count);
 }
 
+void ValidatePartitionCount(const configuration &state) {
+  if (state.partition_count <= 0 ||
+      state.partition_count > state.warehouse_count) {
+    LOG_ERROR("Invalid partition_count :: %d", state.partition_count);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %d", "partition_count", state.partition_count);
+}
+
 void ValidateGCBackendCount(const configuration &state) {
   if (state.gc_backend_count <= 0) {
     LOG_ERROR("Invalid gc_backend_count :: %d", state.gc_backend_count);
@@ -118,6 +134,14 @@ void ValidateGCBackendCount(const configuration &state) {
   LOG_TRACE("%s : %d", "gc_backend_count", state.gc_backend_count);
 }
 
+void ValidateArrivalRate(const configuration &state) {
+  if (state.arrival_rate < 0) {
+    LOG_ERROR("Invalid arrival_rate :: %lf", state.arrival_rate);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %lf", "arrival_rate", state.arrival_rate);
+}
 
 void ParseArguments(int argc, char *argv[], configuration &state) {
   // Default Values
@@ -128,17 +152,20 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
   state.profile_duration = 1;
   state.backend_count = 2;
   state.warehouse_count = 2;
+  state.partition_count = 1;
   state.exp_backoff = false;
   state.affinity = false;
   state.gc_mode = false;
   state.gc_backend_count = 1;
   state.loader_count = 1;
+  state.arrival_rate = 0;
+  state.arrival_type = ArrivalType::POISSON;
 
 
   // Parse args
   while (1) {
     int idx = 0;
-    int c = getopt_long(argc, argv, "heagi:k:d:p:b:w:n:l:y:", opts, &idx);
+    int c = getopt_long(argc, argv, "heagi:k:d:p:b:w:c:n:l:y:r:t:", opts, &idx);
 
     if (c == -1) break;
 
@@ -163,9 +190,24 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
         }
         break;
       }
+      case 't': {
+        char *arrival = optarg;
+        if (strcmp(arrival, "poisson") == 0) {
+          state.arrival_type = ArrivalType::POISSON;
+        } else if (strcmp(arrival, "fixed") == 0) {
+          state.arrival_type = ArrivalType::FIXED;
+        } else {
+          LOG_ERROR("Unknown arrival: %s", arrival);
+          exit(EXIT_FAILURE);
+        }
+        break;
+      }
       case 'l':
         state.loader_count = atoi(optarg);
         break;
+      case 'r':
+        state.arrival_rate = atof(optarg);
+        break;
       case 'k':
         state.scale_factor = atof(optarg);
         break;
@@ -181,6 +223,9 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
       case 'w':
         state.warehouse_count = atoi(optarg);
         break;
+      case 'c':
+        state.partition_count = atoi(optarg);
+        break;
       case 'e':
         state.exp_backoff = true;
         break;
@@ -219,7 +264,9 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
   ValidateProfileDuration(state);
   ValidateBackendCount(state);
   ValidateWarehouseCount(state);
+  ValidatePartitionCount(state);
   ValidateGCBackendCount(state);
+  ValidateArrivalRate(state);
 
   LOG_TRACE("%s : %d", "Run client affinity", state.affinity);
   LOG_TRACE("%s : %d", "Run exponential backoff", state.exp_backoff);
@@ -80,6 +80,7 @@
 #include "planner/delete_plan.h"
 
 #include "storage/data_table.h"
+#include "storage/partitioned_table.h"
 #include "storage/table_factory.h"
 
 
@@ -142,13 +143,13 @@ bool RunDelivery(const size_t &thread_id){
     new_order_key_values.push_back(type::ValueFactory::GetIntegerValue(-1).Copy());
 
     // Get the index
-    auto new_order_pkey_index = new_order_table->GetIndexWithOid(new_order_table_pkey_index_oid);
+    auto new_order_pkey_index = GetPartition(new_order_table, warehouse_id)->GetIndexWithOid(new_order_table_pkey_index_oid);
 
     planner::IndexScanPlan::IndexScanDesc new_order_idex_scan_desc(
       new_order_pkey_index, new_order_key_column_ids, new_order_expr_types,
       new_order_key_values, runtime_keys);
 
-    planner::IndexScanPlan new_order_idex_scan_node(new_order_table,
+    planner::IndexScanPlan new_order_idex_scan_node(GetPartition(new_order_table, warehouse_id),
       nullptr, new_order_column_ids, new_order_idex_scan_desc);
 
     executor::IndexScanExecutor new_order_index_scan_executor(&new_order_idex_scan_node, context.get());
@@ -200,14 +201,14 @@ bool RunDelivery(const size_t &thread_id){
     orders_key_values.push_back(type::ValueFactory::GetIntegerValue(warehouse_id).Copy());
 
     // Get the index
-    auto orders_pkey_index = orders_table->GetIndexWithOid(orders_table_pkey_index_oid);
+    auto orders_pkey_index = GetPartition(orders_table, warehouse_id)->GetIndexWithOid(orders_table_pkey_index_oid);
     
     planner::IndexScanPlan::IndexScanDesc orders_index_scan_desc(
       orders_pkey_index, orders_key_column_ids, orders_expr_types,
       orders_key_values, runtime_keys);
 
     // Create the index scan plan node
-    planner::IndexScanPlan orders_index_scan_node(orders_table,
+    planner::IndexScanPlan orders_index_scan_node(GetPartition(orders_table, warehouse_id),
       nullptr, orders_column_ids, orders_index_scan_desc);
 
     // Create the executors
@@ -245,12 +246,12 @@ bool RunDelivery(const size_t &thread_id){
     order_line_key_values.push_back(type::ValueFactory::GetIntegerValue(d_id).Copy());
     order_line_key_values.push_back(type::ValueFactory::GetIntegerValue(warehouse_id).Copy());
     
-    auto order_line_pkey_index = order_line_table->GetIndexWithOid(order_line_table_pkey_index_oid);
+    auto order_line_pkey_index = GetPartition(order_line_table, warehouse_id)->GetIndexWithOid(order_line_table_pkey_index_oid);
     planner::IndexScanPlan::IndexScanDesc order_line_index_scan_desc(
       order_line_pkey_index, order_line_key_column_ids, order_line_expr_types,
       order_line_key_values, runtime_keys);
 
-    planner::IndexScanPlan order_line_index_scan_node(order_line_table,
+    planner::IndexScanPlan order_line_index_scan_node(GetPartition(order_line_table, warehouse_id),
       nullptr, order_line_column_ids, order_line_index_scan_desc);
 
     executor::IndexScanExecutor order_line_index_scan_executor(&order_line_index_scan_node, context.get());
@@ -295,14 +296,14 @@ bool RunDelivery(const size_t &thread_id){
       new_order_delete_key_values, runtime_keys);
 
     // Create index scan plan node
-    planner::IndexScanPlan new_order_delete_idex_scan_node(new_order_table,
+    planner::IndexScanPlan new_order_delete_idex_scan_node(GetPartition(new_order_table, warehouse_id),
       nullptr, new_order_delete_column_ids, new_order_delete_idex_scan_desc);
 
     // Create executors
     executor::IndexScanExecutor new_order_delete_index_scan_executor(&new_order_delete_idex_scan_node, context.get());
 
     // Construct delete executor
-    planner::DeletePlan new_order_delete_node(new_order_table);
+    planner::DeletePlan new_order_delete_node(GetPartition(new_order_table, warehouse_id));
 
     executor::DeleteExecutor new_order_delete_executor(&new_order_delete_node, context.get());
 
@@ -336,7 +337,7 @@ bool RunDelivery(const size_t &thread_id){
 
     // Reuse the index scan desc created above since nothing different
     planner::IndexScanPlan orders_update_index_scan_node(
-      orders_table, nullptr, orders_update_column_ids, orders_update_index_scan_desc);
+      GetPartition(orders_table, warehouse_id), nullptr, orders_update_column_ids, orders_update_index_scan_desc);
 
     executor::IndexScanExecutor orders_update_index_scan_executor(&orders_update_index_scan_node, context.get());
 
@@ -360,7 +361,7 @@ bool RunDelivery(const size_t &thread_id){
     std::unique_ptr<const planner::ProjectInfo> orders_project_info(
       new planner::ProjectInfo(std::move(orders_target_list),
                                std::move(orders_direct_map_list)));
-    planner::UpdatePlan orders_update_node(orders_table, std::move(orders_project_info));
+    planner::UpdatePlan orders_update_node(GetPartition(orders_table, warehouse_id), std::move(orders_project_info));
 
     executor::UpdateExecutor orders_update_executor(&orders_update_node, context.get());
 
@@ -393,7 +394,7 @@ bool RunDelivery(const size_t &thread_id){
       order_line_update_key_values, runtime_keys);
 
     planner::IndexScanPlan order_line_update_index_scan_node(
-      order_line_table, nullptr, order_line_update_column_ids, order_line_update_index_scan_desc);
+      GetPartition(order_line_table, warehouse_id), nullptr, order_line_update_column_ids, order_line_update_index_scan_desc);
 
     executor::IndexScanExecutor order_line_update_index_scan_executor(&order_line_update_index_scan_node, context.get());
 
@@ -416,7 +417,7 @@ bool RunDelivery(const size_t &thread_id){
     std::unique_ptr<const planner::ProjectInfo> order_line_project_info(
      new planner::ProjectInfo(std::move(order_line_target_list),
                               std::move(order_line_direct_map_list)));
-    planner::UpdatePlan order_line_update_node(order_line_table, std::move(order_line_project_info));
+    planner::UpdatePlan order_line_update_node(GetPartition(order_line_table, warehouse_id), std::move(order_line_project_info));
 
     executor::UpdateExecutor order_line_update_executor(&order_line_update_node, context.get());
 
@@ -448,12 +449,12 @@ bool RunDelivery(const size_t &thread_id){
     customer_key_values.push_back(type::ValueFactory::GetIntegerValue(d_id).Copy());
     customer_key_values.push_back(type::ValueFactory::GetIntegerValue(warehouse_id).Copy());
     
-    auto customer_pkey_index = customer_table->GetIndexWithOid(customer_table_pkey_index_oid);
+    auto customer_pkey_index = GetPartition(customer_table, warehouse_id)->GetIndexWithOid(customer_table_pkey_index_oid);
 
     planner::IndexScanPlan::IndexScanDesc customer_index_scan_desc(customer_pkey_index, customer_key_column_ids, customer_expr_types,
       customer_key_values, runtime_keys);
 
-    planner::IndexScanPlan customer_index_scan_node(customer_table, nullptr,
+    planner::IndexScanPlan customer_index_scan_node(GetPartition(customer_table, warehouse_id), nullptr,
       customer_column_ids, customer_index_scan_desc);
 
     executor::IndexScanExecutor customer_index_scan_executor(&customer_index_scan_node, context.get());
@@ -488,7 +489,7 @@ bool RunDelivery(const size_t &thread_id){
     std::unique_ptr<const planner::ProjectInfo> customer_project_info(
       new planner::ProjectInfo(std::move(customer_target_list), 
                                std::move(customer_direct_map_list)));
-    planner::UpdatePlan customer_update_node(customer_table, std::move(customer_project_info));
+    planner::UpdatePlan customer_update_node(GetPartition(customer_table, warehouse_id), std::move(customer_project_info));
 
     executor::UpdateExecutor customer_update_executor(&customer_update_node, context.get());
 
@@ -36,6 +36,7 @@
 #include "storage/tile.h"
 #include "storage/tile_group.h"
 #include "storage/data_table.h"
+#include "storage/partitioned_table.h"
 #include "storage/table_factory.h"
 #include "storage/database.h"
 #include "type/types.h"
@@ -137,15 +138,15 @@ NURandConstant nu_rand_const;
 /////////////////////////////////////////////////////////
 
 storage::Database *tpcc_database;
-storage::DataTable *warehouse_table;
-storage::DataTable *district_table;
+storage::PartitionedTable *warehouse_table;
+storage::PartitionedTable *district_table;
 storage::DataTable *item_table;
-storage::DataTable *customer_table;
-storage::DataTable *history_table;
-storage::DataTable *stock_table;
-storage::DataTable *orders_table;
-storage::DataTable *new_order_table;
-storage::DataTable *order_line_table;
+storage::PartitionedTable *customer_table;
+storage::PartitionedTable *history_table;
+storage::PartitionedTable *stock_table;
+storage::PartitionedTable *orders_table;
+storage::PartitionedTable *new_order_table;
+storage::PartitionedTable *order_line_table;
 
 const bool own_schema = true;
 const bool adapt_table = false;
@@ -153,6 +154,40 @@ const bool is_inlined = false;
 const bool unique_index = false;
 const bool allocate = true;
 
+storage::DataTable *GetPartition(storage::PartitionedTable *table,
+                                 int warehouse_id) {
+  return table->GetPartitionForKey(
+      type::ValueFactory::GetIntegerValue(warehouse_id));
+}
+
+// Create a table keyed by warehouse, range partitioned on its warehouse id
+// column into state.partition_count runs of consecutive warehouses, and add
+// its partitions to the database
+storage::PartitionedTable *CreateWarehouseKeyedTable(
+    oid_t table_oid, const catalog::Schema *table_schema,
+    const std::string &table_name, oid_t warehouse_column_id) {
+  std::vector<type::Value> bounds;
+  for (int partition_itr = 1; partition_itr < state.partition_count;
+       partition_itr++) {
+    bounds.push_back(type::ValueFactory::GetIntegerValue(
+        state.warehouse_count * partition_itr / state.partition_count));
+  }
+
+  // An unpartitioned table keeps the oid of the table
+  oid_t first_table_oid =
+      (state.partition_count == 1) ? table_oid : (table_oid << 16);
+  auto table = storage::TableFactory::GetPartitionedTable(
+      tpcc_database_oid, first_table_oid, table_schema, table_name,
+      DEFAULT_TUPLES_PER_TILEGROUP,
+      new storage::PartitionScheme(warehouse_column_id, bounds), false);
+
+  for (oid_t partition_itr = 0; partition_itr < table->GetPartitionCount();
+       partition_itr++) {
+    tpcc_database->AddTable(table->GetPartition(partition_itr));
+  }
+  return table;
+}
+
 void CreateWarehouseTable() {
   /*
    CREATE TABLE WAREHOUSE (
@@ -201,33 +236,17 @@ void CreateWarehouseTable() {
       type::TypeId::DECIMAL, type::Type::GetTypeSize(type::TypeId::DECIMAL), "W_YTD", is_inlined);
   warehouse_columns.push_back(w_ytd_column);
 
-  catalog::Schema *table_schema = new catalog::Schema(warehouse_columns);
+  std::unique_ptr<catalog::Schema> table_schema(
+      new catalog::Schema(warehouse_columns));
   std::string table_name("WAREHOUSE");
 
-  warehouse_table = storage::TableFactory::GetDataTable(
-      tpcc_database_oid, warehouse_table_oid, table_schema, table_name,
-      DEFAULT_TUPLES_PER_TILEGROUP, own_schema, adapt_table);
-
-  tpcc_database->AddTable(warehouse_table);
+  warehouse_table = CreateWarehouseKeyedTable(
+      warehouse_table_oid, table_schema.get(), table_name, 0);
 
   // Primary index on W_ID
-  std::vector<oid_t> key_attrs = {0};
-
-  auto tuple_schema = warehouse_table->GetSchema();
-  catalog::Schema *key_schema =
-      catalog::Schema::CopySchema(tuple_schema, key_attrs);
-  key_schema->SetIndexedColumns(key_attrs);
-  bool unique = true;
-
-  index::IndexMetadata *index_metadata = new index::IndexMetadata(
-    "warehouse_pkey", warehouse_table_pkey_index_oid, warehouse_table_oid,
-    tpcc_database_oid, state.index, IndexConstraintType::PRIMARY_KEY,
-    tuple_schema, key_schema, key_attrs, unique);
-
-  std::shared_ptr<index::Index> pkey_index(
-      index::IndexFactory::GetIndex(index_metadata));
-
-  warehouse_table->AddIndex(pkey_index);
+  warehouse_table->AddIndex(
+      "warehouse_pkey", warehouse_table_pkey_index_oid, state.index,
+      IndexConstraintType::PRIMARY_KEY, {0}, true);
 }
 
 void CreateDistrictTable() {
@@ -287,34 +306,17 @@ void CreateDistrictTable() {
                       "D_NEXT_O_ID", is_inlined);
   district_columns.push_back(d_next_o_id_column);
 
-  catalog::Schema *table_schema = new catalog::Schema(district_columns);
+  std::unique_ptr<catalog::Schema> table_schema(
+      new catalog::Schema(district_columns));
   std::string table_name("DISTRICT");
 
-  district_table = storage::TableFactory::GetDataTable(
-      tpcc_database_oid, district_table_oid, table_schema, table_name,
-      DEFAULT_TUPLES_PER_TILEGROUP, own_schema, adapt_table);
-
-  tpcc_database->AddTable(district_table);
+  district_table = CreateWarehouseKeyedTable(
+      district_table_oid, table_schema.get(), table_name, 1);
 
   // Primary index on D_ID, D_W_ID
-  std::vector<oid_t> key_attrs = {0, 1};
-
-  auto tuple_schema = district_table->GetSchema();
-  catalog::Schema *key_schema =
-      catalog::Schema::CopySchema(tuple_schema, key_attrs);
-  key_schema->SetIndexedColumns(key_attrs);
-  bool unique = true;
-
-  index::IndexMetadata *index_metadata = new index::IndexMetadata(
-      "district_pkey", district_table_pkey_index_oid,
-      district_table_pkey_index_oid, district_table_oid, state.index,
-      IndexConstraintType::PRIMARY_KEY, tuple_schema, key_schema, key_attrs,
-      unique);
-
-  std::shared_ptr<index::Index> pkey_index(
-      index::IndexFactory::GetIndex(index_metadata));
-
-  district_table->AddIndex(pkey_index);
+  district_table->AddIndex(
+      "district_pkey", district_table_pkey_index_oid, state.index,
+      IndexConstraintType::PRIMARY_KEY, {0, 1}, true);
 }
 
 void CreateItemTable() {
@@ -485,47 +487,22 @@ void CreateCustomerTable() {
       catalog::Column(type::TypeId::VARCHAR, data_length, "C_DATA", is_inlined);
   customer_columns.push_back(c_data_column);
 
-  catalog::Schema *table_schema = new catalog::Schema(customer_columns);
+  std::unique_ptr<catalog::Schema> table_schema(
+      new catalog::Schema(customer_columns));
   std::string table_name("CUSTOMER");
 
-  customer_table = storage::TableFactory::GetDataTable(
-      tpcc_database_oid, customer_table_oid, table_schema, table_name,
-      DEFAULT_TUPLES_PER_TILEGROUP, own_schema, adapt_table);
-
-  tpcc_database->AddTable(customer_table);
-
-  auto tuple_schema = customer_table->GetSchema();
-  std::vector<oid_t> key_attrs;
-  catalog::Schema *key_schema = nullptr;
-  index::IndexMetadata *index_metadata = nullptr;
+  customer_table = CreateWarehouseKeyedTable(
+      customer_table_oid, table_schema.get(), table_name, 2);
 
   // Primary index on C_ID, C_D_ID, C_W_ID
-  key_attrs = {0, 1, 2};
-  key_schema = catalog::Schema::CopySchema(tuple_schema, key_attrs);
-  key_schema->SetIndexedColumns(key_attrs);
-
-  index_metadata = new index::IndexMetadata(
-    "customer_pkey", customer_table_pkey_index_oid, customer_table_oid,
-    tpcc_database_oid, state.index, IndexConstraintType::PRIMARY_KEY,
-    tuple_schema, key_schema, key_attrs, true);
-
-  std::shared_ptr<index::Index> pkey_index(
-      index::IndexFactory::GetIndex(index_metadata));
-  customer_table->AddIndex(pkey_index);
+  customer_table->AddIndex(
+      "customer_pkey", customer_table_pkey_index_oid, state.index,
+      IndexConstraintType::PRIMARY_KEY, {0, 1, 2}, true);
 
   // Secondary index on C_W_ID, C_D_ID, C_LAST
-  key_attrs = {1, 2, 5};
-  key_schema = catalog::Schema::CopySchema(tuple_schema, key_attrs);
-  key_schema->SetIndexedColumns(key_attrs);
-
-  index_metadata = new index::IndexMetadata(
-      "customer_skey", customer_table_skey_index_oid, customer_table_oid,
-      tpcc_database_oid, state.index, IndexConstraintType::INVALID,
-      tuple_schema, key_schema, key_attrs, false);
-
-  std::shared_ptr<index::Index> skey_index(
-      index::IndexFactory::GetIndex(index_metadata));
-  customer_table->AddIndex(skey_index);
+  customer_table->AddIndex(
+      "customer_skey", customer_table_skey_index_oid, state.index,
+      IndexConstraintType::INVALID, {1, 2, 5}, false);
 }
 
 void CreateHistoryTable() {
@@ -581,14 +558,12 @@ void CreateHistoryTable() {
                                        "H_DATA", is_inlined);
   history_columns.push_back(h_data_column);
 
-  catalog::Schema *table_schema = new catalog::Schema(history_columns);
+  std::unique_ptr<catalog::Schema> table_schema(
+      new catalog::Schema(history_columns));
   std::string table_name("HISTORY");
 
-  history_table = storage::TableFactory::GetDataTable(
-      tpcc_database_oid, history_table_oid, table_schema, table_name,
-      DEFAULT_TUPLES_PER_TILEGROUP, own_schema, adapt_table);
-
-  tpcc_database->AddTable(history_table);
+  history_table = CreateWarehouseKeyedTable(
+      history_table_oid, table_schema.get(), table_name, 4);
 }
 
 void CreateStockTable() {
@@ -675,32 +650,17 @@ void CreateStockTable() {
       catalog::Column(type::TypeId::VARCHAR, data_length, "S_DATA", is_inlined);
   stock_columns.push_back(s_data_column);
 
-  catalog::Schema *table_schema = new catalog::Schema(stock_columns);
+  std::unique_ptr<catalog::Schema> table_schema(
+      new catalog::Schema(stock_columns));
   std::string table_name("STOCK");
 
-  stock_table = storage::TableFactory::GetDataTable(
-      tpcc_database_oid, stock_table_oid, table_schema, table_name,
-      DEFAULT_TUPLES_PER_TILEGROUP, own_schema, adapt_table);
-
-  tpcc_database->AddTable(stock_table);
+  stock_table = CreateWarehouseKeyedTable(
+      stock_table_oid, table_schema.get(), table_name, 1);
 
   // Primary index on S_I_ID, S_W_ID
-  std::vector<oid_t> key_attrs = {0, 1};
-
-  auto tuple_schema = stock_table->GetSchema();
-  catalog::Schema *key_schema =
-      catalog::Schema::CopySchema(tuple_schema, key_attrs);
-  key_schema->SetIndexedColumns(key_attrs);
-  bool unique = true;
-
-  index::IndexMetadata *index_metadata = new index::IndexMetadata(
-      "stock_pkey", stock_table_pkey_index_oid, stock_table_oid,
-      tpcc_database_oid, state.index, IndexConstraintType::PRIMARY_KEY,
-      tuple_schema, key_schema, key_attrs, unique);
-
-  std::shared_ptr<index::Index> pkey_index(
-      index::IndexFactory::GetIndex(index_metadata));
-  stock_table->AddIndex(pkey_index);
+  stock_table->AddIndex(
+      "stock_pkey", stock_table_pkey_index_oid, state.index,
+      IndexConstraintType::PRIMARY_KEY, {0, 1}, true);
 }
 
 void CreateOrdersTable() {
@@ -757,48 +717,22 @@ void CreateOrdersTable() {
                       "O_ALL_LOCAL", is_inlined);
   orders_columns.push_back(o_all_local_column);
 
-  catalog::Schema *table_schema = new catalog::Schema(orders_columns);
+  std::unique_ptr<catalog::Schema> table_schema(
+      new catalog::Schema(orders_columns));
   std::string table_name("ORDERS");
 
-  orders_table = storage::TableFactory::GetDataTable(
-      tpcc_database_oid, orders_table_oid, table_schema, table_name,
-      DEFAULT_TUPLES_PER_TILEGROUP, own_schema, adapt_table);
-
-  tpcc_database->AddTable(orders_table);
-
-  auto tuple_schema = customer_table->GetSchema();
-  std::vector<oid_t> key_attrs;
-  catalog::Schema *key_schema = nullptr;
-  index::IndexMetadata *index_metadata = nullptr;
+  orders_table = CreateWarehouseKeyedTable(
+      orders_table_oid, table_schema.get(), table_name, 3);
 
   // Primary index on O_ID, O_D_ID, O_W_ID
-  key_attrs = {0, 2, 3};
-  key_schema = catalog::Schema::CopySchema(tuple_schema, key_attrs);
-  key_schema->SetIndexedColumns(key_attrs);
-
-  index_metadata = new index::IndexMetadata(
-      "orders_pkey", orders_table_pkey_index_oid, orders_table_oid,
-      tpcc_database_oid, state.index, IndexConstraintType::PRIMARY_KEY,
-      tuple_schema, key_schema, key_attrs, true);
-
-
-  std::shared_ptr<index::Index> pkey_index(
-      index::IndexFactory::GetIndex(index_metadata));
-  orders_table->AddIndex(pkey_index);
+  orders_table->AddIndex(
+      "orders_pkey", orders_table_pkey_index_oid, state.index,
+      IndexConstraintType::PRIMARY_KEY, {0, 2, 3}, true);
 
   // Secondary index on O_C_ID, O_D_ID, O_W_ID
-  key_attrs = {1, 2, 3};
-  key_schema = catalog::Schema::CopySchema(tuple_schema, key_attrs);
-  key_schema->SetIndexedColumns(key_attrs);
-
-  index_metadata = new index::IndexMetadata(
-      "orders_skey", orders_table_skey_index_oid, orders_table_oid,
-      tpcc_database_oid, state.index, IndexConstraintType::INVALID,
-      tuple_schema, key_schema, key_attrs, false);
-
-  std::shared_ptr<index::Index> skey_index(
-      index::IndexFactory::GetIndex(index_metadata));
-  orders_table->AddIndex(skey_index);
+  orders_table->AddIndex(
+      "orders_skey", orders_table_skey_index_oid, state.index,
+      IndexConstraintType::INVALID, {1, 2, 3}, false);
 }
 
 void CreateNewOrderTable() {
@@ -829,32 +763,17 @@ void CreateNewOrderTable() {
                       "NO_W_ID", is_inlined);
   new_order_columns.push_back(no_w_id_column);
 
-  catalog::Schema *table_schema = new catalog::Schema(new_order_columns);
+  std::unique_ptr<catalog::Schema> table_schema(
+      new catalog::Schema(new_order_columns));
   std::string table_name("NEW_ORDER");
 
-  new_order_table = storage::TableFactory::GetDataTable(
-      tpcc_database_oid, new_order_table_oid, table_schema, table_name,
-      DEFAULT_TUPLES_PER_TILEGROUP, own_schema, adapt_table);
-
-  tpcc_database->AddTable(new_order_table);
+  new_order_table = CreateWarehouseKeyedTable(
+      new_order_table_oid, table_schema.get(), table_name, 2);
 
   // Primary index on NO_O_ID, NO_D_ID, NO_W_ID
-  std::vector<oid_t> key_attrs = {0, 1, 2};
-
-  auto tuple_schema = new_order_table->GetSchema();
-  catalog::Schema *key_schema =
-      catalog::Schema::CopySchema(tuple_schema, key_attrs);
-  key_schema->SetIndexedColumns(key_attrs);
-  bool unique = true;
-
-  index::IndexMetadata *index_metadata = new index::IndexMetadata(
-    "new_order_pkey", new_order_table_pkey_index_oid, new_order_table_oid,
-    tpcc_database_oid, state.index, IndexConstraintType::PRIMARY_KEY,
-    tuple_schema, key_schema, key_attrs, unique);
-
-  std::shared_ptr<index::Index> pkey_index(
-      index::IndexFactory::GetIndex(index_metadata));
-  new_order_table->AddIndex(pkey_index);
+  new_order_table->AddIndex(
+      "new_order_pkey", new_order_table_pkey_index_oid, state.index,
+      IndexConstraintType::PRIMARY_KEY, {0, 1, 2}, true);
 }
 
 void CreateOrderLineTable() {
@@ -923,54 +842,36 @@ void CreateOrderLineTable() {
                       "OL_DIST_INFO", is_inlined);
   order_line_columns.push_back(ol_dist_info_column);
 
-  catalog::Schema *table_schema = new catalog::Schema(order_line_columns);
+  std::unique_ptr<catalog::Schema> table_schema(
+      new catalog::Schema(order_line_columns));
   std::string table_name("ORDER_LINE");
 
-  order_line_table = storage::TableFactory::GetDataTable(
-      tpcc_database_oid, order_line_table_oid, table_schema, table_name,
-      DEFAULT_TUPLES_PER_TILEGROUP, own_schema, adapt_table);
-
-  tpcc_database->AddTable(order_line_table);
-
-  auto tuple_schema = order_line_table->GetSchema();
-  std::vector<oid_t> key_attrs;
-  catalog::Schema *key_schema = nullptr;
-  index::IndexMetadata *index_metadata = nullptr;
+  order_line_table = CreateWarehouseKeyedTable(
+      order_line_table_oid, table_schema.get(), table_name, 2);
 
   // Primary index on OL_O_ID, OL_D_ID, OL_W_ID, OL_NUMBER
-  key_attrs = {0, 1, 2, 3};
-  key_schema = catalog::Schema::CopySchema(tuple_schema, key_attrs);
-  key_schema->SetIndexedColumns(key_attrs);
-
-  index_metadata = new index::IndexMetadata(
-      "order_line_pkey", order_line_table_pkey_index_oid, order_line_table_oid,
-      tpcc_database_oid, state.index, IndexConstraintType::PRIMARY_KEY,
-      tuple_schema, key_schema, key_attrs, true);
-
-
-  std::shared_ptr<index::Index> pkey_index(
-      index::IndexFactory::GetIndex(index_metadata));
-  order_line_table->AddIndex(pkey_index);
+  order_line_table->AddIndex(
+      "order_line_pkey", order_line_table_pkey_index_oid, state.index,
+      IndexConstraintType::PRIMARY_KEY, {0, 1, 2, 3}, true);
 
   // Secondary index on OL_O_ID, OL_D_ID, OL_W_ID
-  key_attrs = {0, 1, 2};
-  key_schema = catalog::Schema::CopySchema(tuple_schema, key_attrs);
-  key_schema->SetIndexedColumns(key_attrs);
-
-  index_metadata = new index::IndexMetadata(
-      "order_line_skey", order_line_table_skey_index_oid, order_line_table_oid,
-      tpcc_database_oid, state.index, IndexConstraintType::INVALID,
-      tuple_schema, key_schema, key_attrs, false);
-
-  std::shared_ptr<index::Index> skey_index(
-      index::IndexFactory::GetIndex(index_metadata));
-  order_line_table->AddIndex(skey_index);
+  order_line_table->AddIndex(
+      "order_line_skey", order_line_table_skey_index_oid, state.index,
+      IndexConstraintType::INVALID, {0, 1, 2}, false);
 }
 
 void CreateTPCCDatabase() {
-  // Clean up
+  // Clean up, the partitions go with the database
   delete tpcc_database;
   tpcc_database = nullptr;
+  delete warehouse_table;
+  delete district_table;
+  delete customer_table;
+  delete history_table;
+  delete stock_table;
+  delete orders_table;
+  delete new_order_table;
+  delete order_line_table;
   warehouse_table = nullptr;
   district_table = nullptr;
   item_table = nullptr;
@@ -1585,8 +1486,9 @@ void LoadWarehouses(const int &warehouse_from, const int &warehouse_to) {
     context.reset(new executor::ExecutorContext(txn));
 
     auto warehouse_tuple = BuildWarehouseTuple(warehouse_itr, pool);
-    planner::InsertPlan warehouse_node(warehouse_table,
-                                       std::move(warehouse_tuple));
+    planner::InsertPlan warehouse_node(
+        GetPartition(warehouse_table, warehouse_itr),
+        std::move(warehouse_tuple));
     executor::InsertExecutor warehouse_executor(&warehouse_node, context.get());
     warehouse_executor.Execute();
 
@@ -1600,8 +1502,9 @@ void LoadWarehouses(const int &warehouse_from, const int &warehouse_to) {
 
       auto district_tuple =
           BuildDistrictTuple(district_itr, warehouse_itr, pool);
-      planner::InsertPlan district_node(district_table,
-                                        std::move(district_tuple));
+      planner::InsertPlan district_node(
+          GetPartition(district_table, warehouse_itr),
+          std::move(district_tuple));
       executor::InsertExecutor district_executor(&district_node, context.get());
       district_executor.Execute();
 
@@ -1615,8 +1518,9 @@ void LoadWarehouses(const int &warehouse_from, const int &warehouse_to) {
 
         auto customer_tuple =
             BuildCustomerTuple(customer_itr, district_itr, warehouse_itr, pool);
-        planner::InsertPlan customer_node(customer_table,
-                                          std::move(customer_tuple));
+        planner::InsertPlan customer_node(
+            GetPartition(customer_table, warehouse_itr),
+            std::move(customer_tuple));
         executor::InsertExecutor customer_executor(&customer_node,
                                                    context.get());
         customer_executor.Execute();
@@ -1628,8 +1532,9 @@ void LoadWarehouses(const int &warehouse_from, const int &warehouse_to) {
         auto history_tuple =
             BuildHistoryTuple(customer_itr, district_itr, warehouse_itr,
                               history_district_id, history_warehouse_id, pool);
-        planner::InsertPlan history_node(history_table,
-                                         std::move(history_tuple));
+        planner::InsertPlan history_node(
+            GetPartition(history_table, history_warehouse_id),
+            std::move(history_tuple));
         executor::InsertExecutor history_executor(&history_node, context.get());
         history_executor.Execute();
 
@@ -1651,7 +1556,9 @@ void LoadWarehouses(const int &warehouse_from, const int &warehouse_to) {
 
         auto orders_tuple = BuildOrdersTuple(
             orders_itr, district_itr, warehouse_itr, new_order, o_ol_cnt);
-        planner::InsertPlan orders_node(orders_table, std::move(orders_tuple));
+        planner::InsertPlan orders_node(
+            GetPartition(orders_table, warehouse_itr),
+            std::move(orders_tuple));
         executor::InsertExecutor orders_executor(&orders_node, context.get());
         orders_executor.Execute();
 
@@ -1659,8 +1566,9 @@ void LoadWarehouses(const int &warehouse_from, const int &warehouse_to) {
         if (new_order) {
           auto new_order_tuple =
               BuildNewOrderTuple(orders_itr, district_itr, warehouse_itr);
-          planner::InsertPlan new_order_node(new_order_table,
-                                             std::move(new_order_tuple));
+          planner::InsertPlan new_order_node(
+              GetPartition(new_order_table, warehouse_itr),
+              std::move(new_order_tuple));
           executor::InsertExecutor new_order_executor(&new_order_node,
                                                       context.get());
           new_order_executor.Execute();
@@ -1673,8 +1581,9 @@ void LoadWarehouses(const int &warehouse_from, const int &warehouse_to) {
           auto order_line_tuple = BuildOrderLineTuple(
               orders_itr, district_itr, warehouse_itr, order_line_itr,
               ol_supply_w_id, new_order, pool);
-          planner::InsertPlan order_line_node(order_line_table,
-                                              std::move(order_line_tuple));
+          planner::InsertPlan order_line_node(
+              GetPartition(order_line_table, warehouse_itr),
+              std::move(order_line_tuple));
           executor::InsertExecutor order_line_executor(&order_line_node,
                                                        context.get());
           order_line_executor.Execute();
@@ -1692,7 +1601,8 @@ void LoadWarehouses(const int &warehouse_from, const int &warehouse_to) {
 
       int s_w_id = warehouse_itr;
       auto stock_tuple = BuildStockTuple(stock_itr, s_w_id, pool);
-      planner::InsertPlan stock_node(stock_table, std::move(stock_tuple));
+      planner::InsertPlan stock_node(GetPartition(stock_table, s_w_id),
+                                     std::move(stock_tuple));
       executor::InsertExecutor stock_executor(&stock_node, context.get());
       stock_executor.Execute();
 
@@ -71,6 +71,7 @@
 #include "planner/index_scan_plan.h"
 
 #include "storage/data_table.h"
+#include "storage/partitioned_table.h"
 #include "storage/table_factory.h"
 
 
@@ -195,7 +196,7 @@ bool RunNewOrder(const size_t &thread_id){
 
   warehouse_key_values.push_back(type::ValueFactory::GetIntegerValue(warehouse_id).Copy());
 
-  auto warehouse_pkey_index = warehouse_table->GetIndexWithOid(
+  auto warehouse_pkey_index = GetPartition(warehouse_table, warehouse_id)->GetIndexWithOid(
       warehouse_table_pkey_index_oid);
 
   planner::IndexScanPlan::IndexScanDesc warehouse_index_scan_desc(
@@ -204,7 +205,7 @@ bool RunNewOrder(const size_t &thread_id){
 
   std::vector<oid_t> warehouse_column_ids = {7}; // W_TAX
 
-  planner::IndexScanPlan warehouse_index_scan_node(warehouse_table, nullptr,
+  planner::IndexScanPlan warehouse_index_scan_node(GetPartition(warehouse_table, warehouse_id), nullptr,
                                                    warehouse_column_ids,
                                                    warehouse_index_scan_desc);
 
@@ -240,7 +241,7 @@ bool RunNewOrder(const size_t &thread_id){
   district_expr_types.push_back(
       ExpressionType::COMPARE_EQUAL);
   
-  auto district_pkey_index = district_table->GetIndexWithOid(
+  auto district_pkey_index = GetPartition(district_table, warehouse_id)->GetIndexWithOid(
       district_table_pkey_index_oid);
 
   std::vector<type::Value > district_key_values;
@@ -254,7 +255,7 @@ bool RunNewOrder(const size_t &thread_id){
   std::vector<oid_t> district_column_ids = {8, 10}; // D_TAX, D_NEXT_O_ID
 
   // Create plan node.
-  planner::IndexScanPlan district_index_scan_node(district_table, nullptr,
+  planner::IndexScanPlan district_index_scan_node(GetPartition(district_table, warehouse_id), nullptr,
                                                   district_column_ids,
                                                   district_index_scan_desc);
 
@@ -300,7 +301,7 @@ bool RunNewOrder(const size_t &thread_id){
   customer_key_values.push_back(type::ValueFactory::GetIntegerValue(district_id).Copy());
   customer_key_values.push_back(type::ValueFactory::GetIntegerValue(warehouse_id).Copy());
   
-  auto customer_pkey_index = customer_table->GetIndexWithOid(
+  auto customer_pkey_index = GetPartition(customer_table, warehouse_id)->GetIndexWithOid(
       customer_table_pkey_index_oid);
 
   planner::IndexScanPlan::IndexScanDesc customer_index_scan_desc(
@@ -310,7 +311,7 @@ bool RunNewOrder(const size_t &thread_id){
   std::vector<oid_t> customer_column_ids = {5, 13, 15}; // C_LAST, C_CREDIT, C_DISCOUNT
 
   // Create plan node.
-  planner::IndexScanPlan customer_index_scan_node(customer_table, nullptr,
+  planner::IndexScanPlan customer_index_scan_node(GetPartition(customer_table, warehouse_id), nullptr,
                                                   customer_column_ids,
                                                   customer_index_scan_desc);
 
@@ -352,7 +353,7 @@ bool RunNewOrder(const size_t &thread_id){
       district_update_key_values, runtime_keys);
 
   // Create plan node.
-  planner::IndexScanPlan district_update_index_scan_node(district_table, nullptr,
+  planner::IndexScanPlan district_update_index_scan_node(GetPartition(district_table, warehouse_id), nullptr,
                                                   district_update_column_ids,
                                                   district_update_index_scan_desc);
 
@@ -375,7 +376,7 @@ bool RunNewOrder(const size_t &thread_id){
   std::unique_ptr<const planner::ProjectInfo> district_project_info(
       new planner::ProjectInfo(std::move(district_target_list),
                                std::move(district_direct_map_list)));
-  planner::UpdatePlan district_update_node(district_table, std::move(district_project_info));
+  planner::UpdatePlan district_update_node(GetPartition(district_table, warehouse_id), std::move(district_project_info));
 
   executor::UpdateExecutor district_update_executor(&district_update_node, context.get());
 
@@ -412,7 +413,7 @@ bool RunNewOrder(const size_t &thread_id){
   // O_ALL_LOCAL
   orders_tuple->SetValue(7, type::ValueFactory::GetIntegerValue(o_all_local), nullptr);
 
-  planner::InsertPlan orders_node(orders_table, std::move(orders_tuple));
+  planner::InsertPlan orders_node(GetPartition(orders_table, warehouse_id), std::move(orders_tuple));
   executor::InsertExecutor orders_executor(&orders_node, context.get());
   orders_executor.Execute();
 
@@ -434,7 +435,7 @@ bool RunNewOrder(const size_t &thread_id){
   // NO_W_ID
   new_order_tuple->SetValue(2, type::ValueFactory::GetIntegerValue(warehouse_id), nullptr);
 
-  planner::InsertPlan new_order_node(new_order_table, std::move(new_order_tuple));
+  planner::InsertPlan new_order_node(GetPartition(new_order_table, warehouse_id), std::move(new_order_tuple));
   executor::InsertExecutor new_order_executor(&new_order_node, context.get());
   new_order_executor.Execute();
 
@@ -457,9 +458,6 @@ bool RunNewOrder(const size_t &thread_id){
       ExpressionType::COMPARE_EQUAL);
 
 
-  auto stock_pkey_index = stock_table->GetIndexWithOid(
-      stock_table_pkey_index_oid);
-  
   // S_QUANTITY, S_DIST_%02d, S_YTD, S_ORDER_CNT, S_REMOTE_CNT, S_DATA
   std::vector<oid_t> stock_column_ids = {2, oid_t(3 + district_id), 13, 14, 15, 16}; 
 
@@ -469,6 +467,10 @@ bool RunNewOrder(const size_t &thread_id){
     int item_id = i_ids.at(i);
     int ol_w_id = ol_w_ids.at(i);
     int ol_qty = ol_qtys.at(i);
+
+    // The stock of the supplying warehouse, in its partition
+    auto stock_pkey_index = GetPartition(stock_table, ol_w_id)->GetIndexWithOid(
+        stock_table_pkey_index_oid);
     
     LOG_TRACE("getStockInfo: SELECT S_QUANTITY, S_DATA, S_YTD, S_ORDER_CNT, S_REMOTE_CNT, S_DIST_? FROM STOCK WHERE S_I_ID = %d AND S_W_ID = %d", item_id, ol_w_id);
     
@@ -492,7 +494,7 @@ bool RunNewOrder(const size_t &thread_id){
 
 
     // Create plan node.
-    planner::IndexScanPlan stock_index_scan_node(stock_table, nullptr,
+    planner::IndexScanPlan stock_index_scan_node(GetPartition(stock_table, ol_w_id), nullptr,
                                                  stock_column_ids,
                                                  stock_index_scan_desc);
 
@@ -534,7 +536,7 @@ bool RunNewOrder(const size_t &thread_id){
     LOG_TRACE("updateStock: UPDATE STOCK SET S_QUANTITY = ?, S_YTD = ?, S_ORDER_CNT = ?, S_REMOTE_CNT = ? WHERE S_I_ID = ? AND S_W_ID = ?");
 
     // Create plan node.
-    planner::IndexScanPlan stock_update_index_scan_node(stock_table, nullptr,
+    planner::IndexScanPlan stock_update_index_scan_node(GetPartition(stock_table, ol_w_id), nullptr,
                                                         stock_update_column_ids,
                                                         stock_update_index_scan_desc);
     
@@ -570,7 +572,7 @@ bool RunNewOrder(const size_t &thread_id){
     std::unique_ptr<const planner::ProjectInfo> stock_project_info(
         new planner::ProjectInfo(std::move(stock_target_list),
                                  std::move(stock_direct_map_list)));
-    planner::UpdatePlan stock_update_node(stock_table, std::move(stock_project_info));
+    planner::UpdatePlan stock_update_node(GetPartition(stock_table, ol_w_id), std::move(stock_project_info));
 
     executor::UpdateExecutor stock_update_executor(&stock_update_node, context.get());
 
@@ -617,7 +619,7 @@ bool RunNewOrder(const size_t &thread_id){
     // OL_DIST_INFO
     order_line_tuple->SetValue(9, s_data, nullptr);
 
-    planner::InsertPlan order_line_node(order_line_table, std::move(order_line_tuple));
+    planner::InsertPlan order_line_node(GetPartition(order_line_table, warehouse_id), std::move(order_line_tuple));
     executor::InsertExecutor order_line_executor(&order_line_node, context.get());
     order_line_executor.Execute();
 
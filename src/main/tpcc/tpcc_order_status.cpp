@@ -75,6 +75,7 @@
 #include "planner/limit_plan.h"
 
 #include "storage/data_table.h"
+#include "storage/partitioned_table.h"
 #include "storage/table_factory.h"
 
 
@@ -134,13 +135,13 @@ bool RunOrderStatus(const size_t &thread_id){
       ExpressionType::COMPARE_EQUAL);
     customer_key_values.push_back(type::ValueFactory::GetIntegerValue(c_id).Copy());
 
-    auto customer_pkey_index = customer_table->GetIndexWithOid(customer_table_pkey_index_oid);
+    auto customer_pkey_index = GetPartition(customer_table, w_id)->GetIndexWithOid(customer_table_pkey_index_oid);
 
     planner::IndexScanPlan::IndexScanDesc customer_index_scan_desc(customer_pkey_index, customer_key_column_ids, customer_expr_types,
       customer_key_values, runtime_keys);
 
     auto predicate = nullptr;
-    planner::IndexScanPlan customer_index_scan_node(customer_table, predicate,
+    planner::IndexScanPlan customer_index_scan_node(GetPartition(customer_table, w_id), predicate,
       customer_column_ids, customer_index_scan_desc);
 
     executor::IndexScanExecutor customer_index_scan_executor(&customer_index_scan_node, context.get());
@@ -179,13 +180,13 @@ bool RunOrderStatus(const size_t &thread_id){
       ExpressionType::COMPARE_EQUAL);
     customer_key_values.push_back(type::ValueFactory::GetVarcharValue(c_last).Copy());
 
-    auto customer_skey_index = customer_table->GetIndexWithOid(customer_table_skey_index_oid);
+    auto customer_skey_index = GetPartition(customer_table, w_id)->GetIndexWithOid(customer_table_skey_index_oid);
 
     planner::IndexScanPlan::IndexScanDesc customer_index_scan_desc(customer_skey_index, customer_key_column_ids, customer_expr_types,
       customer_key_values, runtime_keys);
 
     auto predicate = nullptr;
-    planner::IndexScanPlan customer_index_scan_node(customer_table, predicate,
+    planner::IndexScanPlan customer_index_scan_node(GetPartition(customer_table, w_id), predicate,
       customer_column_ids, customer_index_scan_desc);
 
     executor::IndexScanExecutor customer_index_scan_executor(&customer_index_scan_node, context.get());
@@ -238,14 +239,14 @@ bool RunOrderStatus(const size_t &thread_id){
   orders_key_values.push_back(type::ValueFactory::GetIntegerValue(c_id).Copy());
 
   // Get the index
-  auto orders_skey_index = orders_table->GetIndexWithOid(orders_table_skey_index_oid);
+  auto orders_skey_index = GetPartition(orders_table, w_id)->GetIndexWithOid(orders_table_skey_index_oid);
   planner::IndexScanPlan::IndexScanDesc orders_index_scan_desc(
     orders_skey_index, orders_key_column_ids, orders_expr_types,
     orders_key_values, runtime_keys);
 
   auto predicate = nullptr;
 
-  planner::IndexScanPlan orders_index_scan_node(orders_table,
+  planner::IndexScanPlan orders_index_scan_node(GetPartition(orders_table, w_id),
     predicate, orders_column_ids, orders_index_scan_desc);
 
   executor::IndexScanExecutor orders_index_scan_executor(
@@ -290,14 +291,14 @@ bool RunOrderStatus(const size_t &thread_id){
     order_line_expr_types.push_back(ExpressionType::COMPARE_EQUAL);
     order_line_key_values.push_back(orders[0][0]);
 
-    auto order_line_skey_index = order_line_table->GetIndexWithOid(order_line_table_skey_index_oid);
+    auto order_line_skey_index = GetPartition(order_line_table, w_id)->GetIndexWithOid(order_line_table_skey_index_oid);
     planner::IndexScanPlan::IndexScanDesc order_line_index_scan_desc(
       order_line_skey_index, order_line_key_column_ids, order_line_expr_types,
       order_line_key_values, runtime_keys);
 
     predicate = nullptr;
 
-    planner::IndexScanPlan order_line_index_scan_node(order_line_table,
+    planner::IndexScanPlan order_line_index_scan_node(GetPartition(order_line_table, w_id),
       predicate, order_line_column_ids, order_line_index_scan_desc);
 
     executor::IndexScanExecutor order_line_index_scan_executor(&order_line_index_scan_node, context.get());
@@ -71,6 +71,7 @@
 #include "planner/index_scan_plan.h"
 
 #include "storage/data_table.h"
+#include "storage/partitioned_table.h"
 #include "storage/table_factory.h"
 
 
@@ -172,13 +173,13 @@ bool RunPayment(const size_t &thread_id){
     customer_pkey_values.push_back(type::ValueFactory::GetIntegerValue(district_id).Copy());
     customer_pkey_values.push_back(type::ValueFactory::GetIntegerValue(warehouse_id).Copy());
 
-    auto customer_pkey_index = customer_table->GetIndexWithOid(customer_table_pkey_index_oid);
+    auto customer_pkey_index = GetPartition(customer_table, warehouse_id)->GetIndexWithOid(customer_table_pkey_index_oid);
 
     planner::IndexScanPlan::IndexScanDesc customer_pindex_scan_desc(
       customer_pkey_index, customer_pkey_column_ids, customer_pexpr_types,
       customer_pkey_values, runtime_keys);
     
-    planner::IndexScanPlan customer_pindex_scan_node(customer_table, nullptr,
+    planner::IndexScanPlan customer_pindex_scan_node(GetPartition(customer_table, warehouse_id), nullptr,
       customer_column_ids, 
       customer_pindex_scan_desc);
 
@@ -221,14 +222,14 @@ bool RunPayment(const size_t &thread_id){
     customer_key_values.push_back(type::ValueFactory::GetIntegerValue(warehouse_id).Copy());
     customer_key_values.push_back(type::ValueFactory::GetVarcharValue(customer_lastname).Copy());
 
-    auto customer_skey_index = customer_table->GetIndexWithOid(customer_table_skey_index_oid);
+    auto customer_skey_index = GetPartition(customer_table, warehouse_id)->GetIndexWithOid(customer_table_skey_index_oid);
     PL_ASSERT(customer_skey_index != nullptr);
 
     planner::IndexScanPlan::IndexScanDesc customer_index_scan_desc(
       customer_skey_index, customer_key_column_ids, customer_expr_types,
       customer_key_values, runtime_keys);
 
-    planner::IndexScanPlan customer_index_scan_node(customer_table, nullptr,
+    planner::IndexScanPlan customer_index_scan_node(GetPartition(customer_table, warehouse_id), nullptr,
       customer_column_ids, 
       customer_index_scan_desc);
 
@@ -265,7 +266,7 @@ bool RunPayment(const size_t &thread_id){
 
   warehouse_key_values.push_back(type::ValueFactory::GetIntegerValue(warehouse_id).Copy());
 
-  auto warehouse_pkey_index = warehouse_table->GetIndexWithOid(warehouse_table_pkey_index_oid);
+  auto warehouse_pkey_index = GetPartition(warehouse_table, warehouse_id)->GetIndexWithOid(warehouse_table_pkey_index_oid);
 
   planner::IndexScanPlan::IndexScanDesc warehouse_index_scan_desc(
     warehouse_pkey_index, warehouse_key_column_ids, warehouse_expr_types,
@@ -273,7 +274,7 @@ bool RunPayment(const size_t &thread_id){
 
   std::vector<oid_t> warehouse_column_ids = {1, 2, 3, 4, 5, 6, 8};
 
-  planner::IndexScanPlan warehouse_index_scan_node(warehouse_table, nullptr,
+  planner::IndexScanPlan warehouse_index_scan_node(GetPartition(warehouse_table, warehouse_id), nullptr,
     warehouse_column_ids, 
     warehouse_index_scan_desc);
 
@@ -310,7 +311,7 @@ bool RunPayment(const size_t &thread_id){
   district_key_values.push_back(type::ValueFactory::GetIntegerValue(district_id).Copy());
   district_key_values.push_back(type::ValueFactory::GetIntegerValue(warehouse_id).Copy());
   
-  auto district_pkey_index = district_table->GetIndexWithOid(district_table_pkey_index_oid);
+  auto district_pkey_index = GetPartition(district_table, warehouse_id)->GetIndexWithOid(district_table_pkey_index_oid);
   
   planner::IndexScanPlan::IndexScanDesc district_index_scan_desc(
     district_pkey_index, district_key_column_ids, district_expr_types,
@@ -318,7 +319,7 @@ bool RunPayment(const size_t &thread_id){
 
   std::vector<oid_t> district_column_ids = {2, 3, 4, 5, 6, 7, 9};
   
-  planner::IndexScanPlan district_index_scan_node(district_table, nullptr,
+  planner::IndexScanPlan district_index_scan_node(GetPartition(district_table, warehouse_id), nullptr,
     district_column_ids, 
     district_index_scan_desc);
 
@@ -354,7 +355,7 @@ bool RunPayment(const size_t &thread_id){
     warehouse_pkey_index, warehouse_key_column_ids, warehouse_expr_types,
     warehouse_update_key_values, runtime_keys);
 
-  planner::IndexScanPlan warehouse_update_index_scan_node(warehouse_table, nullptr,
+  planner::IndexScanPlan warehouse_update_index_scan_node(GetPartition(warehouse_table, warehouse_id), nullptr,
     warehouse_update_column_ids,
     warehouse_update_index_scan_desc);
 
@@ -377,7 +378,7 @@ bool RunPayment(const size_t &thread_id){
   std::unique_ptr<const planner::ProjectInfo> warehouse_project_info(
     new planner::ProjectInfo(std::move(warehouse_target_list),
                              std::move(warehouse_direct_map_list)));
-  planner::UpdatePlan warehouse_update_node(warehouse_table, std::move(warehouse_project_info));
+  planner::UpdatePlan warehouse_update_node(GetPartition(warehouse_table, warehouse_id), std::move(warehouse_project_info));
 
   executor::UpdateExecutor warehouse_update_executor(&warehouse_update_node, context.get());
 
@@ -412,7 +413,7 @@ bool RunPayment(const size_t &thread_id){
     district_pkey_index, district_key_column_ids, district_expr_types,
     district_update_key_values, runtime_keys);
 
-  planner::IndexScanPlan district_update_index_scan_node(district_table, nullptr,
+  planner::IndexScanPlan district_update_index_scan_node(GetPartition(district_table, warehouse_id), nullptr,
     district_update_column_ids, district_update_index_scan_desc);
 
   executor::IndexScanExecutor district_update_index_scan_executor(&district_update_index_scan_node, context.get());
@@ -435,7 +436,7 @@ bool RunPayment(const size_t &thread_id){
   std::unique_ptr<const planner::ProjectInfo> district_project_info(
     new planner::ProjectInfo(std::move(district_target_list),
                              std::move(district_direct_map_list)));
-  planner::UpdatePlan district_update_node(district_table, std::move(district_project_info));
+  planner::UpdatePlan district_update_node(GetPartition(district_table, warehouse_id), std::move(district_project_info));
   
   executor::UpdateExecutor district_update_executor(&district_update_node, context.get());
 
@@ -483,7 +484,7 @@ bool RunPayment(const size_t &thread_id){
     customer_pkey_values.push_back(type::ValueFactory::GetIntegerValue(customer_district_id).Copy());
     customer_pkey_values.push_back(type::ValueFactory::GetIntegerValue(customer_warehouse_id).Copy());
 
-    auto customer_pkey_index = customer_table->GetIndexWithOid(customer_table_pkey_index_oid);
+    auto customer_pkey_index = GetPartition(customer_table, customer_warehouse_id)->GetIndexWithOid(customer_table_pkey_index_oid);
 
     planner::IndexScanPlan::IndexScanDesc customer_pindex_scan_desc(
       customer_pkey_index, customer_pkey_column_ids, customer_pexpr_types,
@@ -493,7 +494,7 @@ bool RunPayment(const size_t &thread_id){
     std::vector<oid_t> customer_update_bc_column_ids = {16, 17, 18, 20};
 
     // Create update executor
-    planner::IndexScanPlan customer_update_bc_index_scan_node(customer_table, nullptr, 
+    planner::IndexScanPlan customer_update_bc_index_scan_node(GetPartition(customer_table, customer_warehouse_id), nullptr, 
       customer_update_bc_column_ids,
       customer_pindex_scan_desc);
 
@@ -532,7 +533,7 @@ bool RunPayment(const size_t &thread_id){
       )
     );
 
-    planner::UpdatePlan customer_update_bc_node(customer_table, std::move(customer_bc_project_info));
+    planner::UpdatePlan customer_update_bc_node(GetPartition(customer_table, customer_warehouse_id), std::move(customer_bc_project_info));
 
     executor::UpdateExecutor customer_update_bc_executor(&customer_update_bc_node, context.get());
 
@@ -561,7 +562,7 @@ bool RunPayment(const size_t &thread_id){
     customer_pkey_values.push_back(type::ValueFactory::GetIntegerValue(customer_district_id).Copy());
     customer_pkey_values.push_back(type::ValueFactory::GetIntegerValue(customer_warehouse_id).Copy());
 
-    auto customer_pkey_index = customer_table->GetIndexWithOid(customer_table_pkey_index_oid);
+    auto customer_pkey_index = GetPartition(customer_table, customer_warehouse_id)->GetIndexWithOid(customer_table_pkey_index_oid);
 
     planner::IndexScanPlan::IndexScanDesc customer_pindex_scan_desc(
       customer_pkey_index, customer_pkey_column_ids, customer_pexpr_types,
@@ -570,7 +571,7 @@ bool RunPayment(const size_t &thread_id){
     std::vector<oid_t> customer_update_gc_column_ids = {16, 17, 18};
 
     // Create update executor
-    planner::IndexScanPlan customer_update_gc_index_scan_node(customer_table, nullptr, 
+    planner::IndexScanPlan customer_update_gc_index_scan_node(GetPartition(customer_table, customer_warehouse_id), nullptr, 
       customer_update_gc_column_ids,
       customer_pindex_scan_desc);
 
@@ -605,7 +606,7 @@ bool RunPayment(const size_t &thread_id){
       )
     );
 
-    planner::UpdatePlan customer_update_gc_node(customer_table, std::move(customer_gc_project_info));
+    planner::UpdatePlan customer_update_gc_node(GetPartition(customer_table, customer_warehouse_id), std::move(customer_gc_project_info));
     
     executor::UpdateExecutor customer_update_gc_executor(&customer_update_gc_node, context.get());
 
@@ -643,7 +644,7 @@ bool RunPayment(const size_t &thread_id){
   // Note: workaround
   history_tuple->SetValue(7, type::ValueFactory::GetVarcharValue(data_constant), context.get()->GetPool());
 
-  planner::InsertPlan history_insert_node(history_table, std::move(history_tuple));
+  planner::InsertPlan history_insert_node(GetPartition(history_table, warehouse_id), std::move(history_tuple));
   executor::InsertExecutor history_insert_executor(&history_insert_node, context.get());
 
   // Execute
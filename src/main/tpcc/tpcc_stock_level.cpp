@@ -76,6 +76,7 @@
 #include "planner/aggregate_plan.h"
 
 #include "storage/data_table.h"
+#include "storage/partitioned_table.h"
 #include "storage/table_factory.h"
 
 
@@ -115,7 +116,7 @@ bool RunStockLevel(const size_t &thread_id) {
   district_expr_types.push_back(ExpressionType::COMPARE_EQUAL);
   district_key_values.push_back(type::ValueFactory::GetIntegerValue(d_id).Copy());
 
-  auto district_pkey_index = district_table->GetIndexWithOid(district_table_pkey_index_oid);
+  auto district_pkey_index = GetPartition(district_table, w_id)->GetIndexWithOid(district_table_pkey_index_oid);
   planner::IndexScanPlan::IndexScanDesc district_index_scan_desc(
     district_pkey_index, district_key_column_ids, district_expr_types,
     district_key_values, runtime_keys
@@ -123,7 +124,7 @@ bool RunStockLevel(const size_t &thread_id) {
 
   expression::AbstractExpression *predicate = nullptr;
   planner::IndexScanPlan district_index_scan_node(
-    district_table, predicate,
+    GetPartition(district_table, w_id), predicate,
     district_column_ids, district_index_scan_desc
   );
   executor::IndexScanExecutor district_index_scan_executor(&district_index_scan_node, context.get());
@@ -153,7 +154,7 @@ bool RunStockLevel(const size_t &thread_id) {
   order_line_expr_types.push_back(ExpressionType::COMPARE_EQUAL);
   order_line_expr_types.push_back(ExpressionType::COMPARE_EQUAL);
 
-  auto order_line_skey_index = order_line_table->GetIndexWithOid(order_line_table_skey_index_oid);
+  auto order_line_skey_index = GetPartition(order_line_table, w_id)->GetIndexWithOid(order_line_table_skey_index_oid);
   
   //////////////////////////////////////////////////////////////
   std::vector<oid_t> stock_column_ids = {COL_IDX_S_QUANTITY};
@@ -162,7 +163,7 @@ bool RunStockLevel(const size_t &thread_id) {
   stock_expr_types.push_back(ExpressionType::COMPARE_EQUAL);
   stock_expr_types.push_back(ExpressionType::COMPARE_EQUAL);
   
-  auto stock_pkey_index = stock_table->GetIndexWithOid(stock_table_pkey_index_oid);
+  auto stock_pkey_index = GetPartition(stock_table, w_id)->GetIndexWithOid(stock_table_pkey_index_oid);
 
 
   //////////////////////////////////////////////////////////////
@@ -183,7 +184,7 @@ bool RunStockLevel(const size_t &thread_id) {
       order_line_skey_index, order_line_key_column_ids, order_line_expr_types,
       order_line_key_values, runtime_keys);
 
-    planner::IndexScanPlan order_line_index_scan_node(order_line_table,
+    planner::IndexScanPlan order_line_index_scan_node(GetPartition(order_line_table, w_id),
       nullptr, order_line_column_ids, order_line_index_scan_desc);
 
     executor::IndexScanExecutor order_line_index_scan_executor(&order_line_index_scan_node, context.get());
@@ -219,7 +220,7 @@ bool RunStockLevel(const size_t &thread_id) {
         stock_key_values, runtime_keys);
 
     // Add predicate S_QUANTITY < threshold
-    planner::IndexScanPlan stock_index_scan_node(stock_table, nullptr,
+    planner::IndexScanPlan stock_index_scan_node(GetPartition(stock_table, w_id), nullptr,
                                                  stock_column_ids,
                                                  stock_index_scan_desc);
 
@@ -93,6 +93,9 @@ volatile bool is_running = true;
 PadInt *abort_counts;
 PadInt *commit_counts;
 
+// Set when the transactions arrive at a fixed rate instead of back to back
+OpenLoopDriver *open_loop_driver = nullptr;
+
 size_t GenerateWarehouseId(const size_t &thread_id) {
   if (state.affinity) {
     if (state.warehouse_count <= state.backend_count) {
@@ -123,6 +126,40 @@ void PinToCore(size_t UNUSED_ATTRIBUTE core) {
 #endif
 }
 
+// The transaction types of the mix, in the order of their ratios
+static const std::vector<std::string> transaction_names = {
+    "stock_level", "order_status", "payment", "new_order", "delivery"};
+
+static size_t ChooseTransaction(FastRandom &rng) {
+  auto rng_val = rng.NextUniform();
+  if (rng_val <= STOCK_LEVEL_RATIO) {
+    return 0;
+  } else if (rng_val <= ORDER_STATUS_RATIO + STOCK_LEVEL_RATIO) {
+    return 1;
+  } else if (rng_val <= PAYMENT_RATIO + ORDER_STATUS_RATIO + STOCK_LEVEL_RATIO) {
+    return 2;
+  } else if (rng_val <= PAYMENT_RATIO + ORDER_STATUS_RATIO + STOCK_LEVEL_RATIO + NEW_ORDER_RATIO) {
+    return 3;
+  } else {
+    return 4;
+  }
+}
+
+static bool RunTransaction(const size_t type, const size_t &thread_id) {
+  switch (type) {
+    case 0:
+      return RunStockLevel(thread_id);
+    case 1:
+      return RunOrderStatus(thread_id);
+    case 2:
+      return RunPayment(thread_id);
+    case 3:
+      return RunNewOrder(thread_id);
+    default:
+      return RunDelivery(thread_id);
+  }
+}
+
 void RunBackend(const size_t thread_id) {
 
   PinToCore(thread_id);
@@ -135,6 +172,23 @@ void RunBackend(const size_t thread_id) {
 
   PadInt &execution_count_ref = abort_counts[thread_id];
   PadInt &transaction_count_ref = commit_counts[thread_id];
+
+  if (open_loop_driver != nullptr) {
+    FastRandom rng(rand());
+    open_loop_driver->RunWorker(
+        thread_id, [&]() { return ChooseTransaction(rng); },
+        [&](size_t type) {
+          bool committed = RunTransaction(type, thread_id);
+          if (committed) {
+            transaction_count_ref.data++;
+          } else {
+            execution_count_ref.data++;
+          }
+          return committed;
+        },
+        state.exp_backoff);
+    return;
+  }
   
   // backoff
   uint32_t backoff_shifts = 0;
@@ -147,86 +201,20 @@ void RunBackend(const size_t thread_id) {
 
     FastRandom rng(rand());
     
-    auto rng_val = rng.NextUniform();
-    if (rng_val <= STOCK_LEVEL_RATIO) {
-      while (RunStockLevel(thread_id) == false) {
-        if (is_running == false) {
-          break;
-        }
-        execution_count_ref.data++;
-        // backoff
-        if (state.exp_backoff) {
-          if (backoff_shifts < 13) {
-            ++backoff_shifts;
-          }
-          uint64_t sleep_duration = 1UL << backoff_shifts;
-          sleep_duration *= 100;
-          std::this_thread::sleep_for(std::chrono::microseconds(sleep_duration));
-        }
-      }
-    } else if (rng_val <= ORDER_STATUS_RATIO + STOCK_LEVEL_RATIO) {
-      while (RunOrderStatus(thread_id) == false) {
-        if (is_running == false) {
-          break;
-        }
-        execution_count_ref.data++;
-        // backoff
-        if (state.exp_backoff) {
-          if (backoff_shifts < 13) {
-            ++backoff_shifts;
-          }
-          uint64_t sleep_duration = 1UL << backoff_shifts;
-          sleep_duration *= 100;
-          std::this_thread::sleep_for(std::chrono::microseconds(sleep_duration));
-        }
+    size_t type = ChooseTransaction(rng);
+    while (RunTransaction(type, thread_id) == false) {
+      if (is_running == false) {
+        break;
       }
-    } else if (rng_val <= PAYMENT_RATIO + ORDER_STATUS_RATIO + STOCK_LEVEL_RATIO) {
-      while (RunPayment(thread_id) == false) {
-        if (is_running == false) {
-          break;
-        }
-        execution_count_ref.data++;
-        // backoff
-        if (state.exp_backoff) {
-          if (backoff_shifts < 13) {
-            ++backoff_shifts;
-          }
-          uint64_t sleep_duration = 1UL << backoff_shifts;
-          sleep_duration *= 100;
-          std::this_thread::sleep_for(std::chrono::microseconds(sleep_duration));
-        }
-      }
-    } else if (rng_val <= PAYMENT_RATIO + ORDER_STATUS_RATIO + STOCK_LEVEL_RATIO + NEW_ORDER_RATIO) {
-      while (RunNewOrder(thread_id) == false) {
-        if (is_running == false) {
-          break;
-        }
-        execution_count_ref.data++;
-        // backoff
-        if (state.exp_backoff) {
-          if (backoff_shifts < 13) {
-            ++backoff_shifts;
-          }
-          uint64_t sleep_duration = 1UL << backoff_shifts;
-          sleep_duration *= 100;
-          std::this_thread::sleep_for(std::chrono::microseconds(sleep_duration));
-        }
-      }
-    } else {
-      while (RunDelivery(thread_id) == false) {
-        if (is_running == false) {
-          break;
-        }
-        execution_count_ref.data++;
-        // backoff
-        if (state.exp_backoff) {
-          if (backoff_shifts < 13) {
-            ++backoff_shifts;
-          }
-          uint64_t sleep_duration = 1UL << backoff_shifts;
-          sleep_duration *= 100;
-          std::this_thread::sleep_for(std::chrono::microseconds(sleep_duration));
+      execution_count_ref.data++;
+      // backoff
+      if (state.exp_backoff) {
+        if (backoff_shifts < 13) {
+          ++backoff_shifts;
         }
+        uint64_t sleep_duration = 1UL << backoff_shifts;
+        sleep_duration *= 100;
+        std::this_thread::sleep_for(std::chrono::microseconds(sleep_duration));
       }
     }
 
@@ -260,6 +248,13 @@ void RunWorkload() {
     commit_counts_profiles[round_id] = new PadInt[num_threads];
   }
 
+  if (state.arrival_rate > 0) {
+    open_loop_driver = new OpenLoopDriver(
+        state.arrival_rate, state.arrival_type, state.duration,
+        state.profile_duration, num_threads, transaction_names);
+    open_loop_driver->Start();
+  }
+
   for (size_t thread_itr = 0; thread_itr < num_threads; ++thread_itr) {
     thread_group.push_back(std::thread(RunBackend, thread_itr));
   }
@@ -292,6 +287,12 @@ void RunWorkload() {
     thread_group[thread_itr].join();
   }
 
+  if (open_loop_driver != nullptr) {
+    open_loop_driver->WriteOutput("outputfile.latency");
+    delete open_loop_driver;
+    open_loop_driver = nullptr;
+  }
+
   // calculate the throughput and abort rate for the first round.
   uint64_t total_commit_count = 0;
   for (size_t i = 0; i < num_threads; ++i) {
@@ -17,6 +17,7 @@
 #include "common/logger.h"
 #include "benchmark/ycsb/ycsb_configuration.h"
 #include "benchmark/ycsb/ycsb_loader.h"
+#include "benchmark/ycsb/ycsb_network.h"
 #include "benchmark/ycsb/ycsb_workload.h"
 
 #include "gc/gc_manager_factory.h"
@@ -31,6 +32,15 @@ configuration state;
 // Main Entry Point
 void RunBenchmark() {
 
+  // Against a server the engine, its GC and its epochs are the server's
+  if (state.server_port != 0) {
+    CreateNetworkDatabase();
+    LoadNetworkDatabase();
+    RunWorkload();
+    WriteOutput();
+    return;
+  }
+
   if (state.gc_mode == false) {
     gc::GCManagerFactory::Configure(0);
   } else {
@@ -42,6 +42,9 @@ void Usage(FILE *out) {
           "   -n --gc_backend_count  :  # of gc backends \n"
           "   -l --loader_count      :  # of loaders \n"
           "   -y --epoch             :  epoch type: centralized or decentralized \n"
+          "   -r --arrival_rate      :  open loop arrivals per second (0: closed loop) \n"
+          "   -t --arrival           :  open loop arrivals: poisson (default) or fixed \n"
+          "   -s --server_port       :  run against the server on this local port \n"
   );
 }
 
@@ -61,6 +64,9 @@ static struct option opts[] = {
     { "gc_backend_count", optional_argument, NULL, 'n' },
     { "loader_count", optional_argument, NULL, 'n' },
     { "epoch", optional_argument, NULL, 'y' },
+    { "arrival_rate", optional_argument, NULL, 'r' },
+    { "arrival", optional_argument, NULL, 't' },
+    { "server_port", optional_argument, NULL, 's' },
     { NULL, 0, NULL, 0 }
 };
 
@@ -152,6 +158,24 @@ void ValidateGCBackendCount(const configuration &state) {
   LOG_TRACE("%s : %d", "gc_backend_count", state.gc_backend_count);
 }
 
+void ValidateArrivalRate(const configuration &state) {
+  if (state.arrival_rate < 0) {
+    LOG_ERROR("Invalid arrival_rate :: %lf", state.arrival_rate);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %lf", "arrival_rate", state.arrival_rate);
+}
+
+void ValidateServerPort(const configuration &state) {
+  if (state.server_port < 0 || state.server_port > 65535) {
+    LOG_ERROR("Invalid server_port :: %d", state.server_port);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %d", "server_port", state.server_port);
+}
+
 void ParseArguments(int argc, char *argv[], configuration &state) {
   // Default Values
   state.index = IndexType::BWTREE;
@@ -169,11 +193,14 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
   state.gc_mode = false;
   state.gc_backend_count = 1;
   state.loader_count = 1;
+  state.arrival_rate = 0;
+  state.arrival_type = ArrivalType::POISSON;
+  state.server_port = 0;
 
   // Parse args
   while (1) {
     int idx = 0;
-    int c = getopt_long(argc, argv, "hemgi:k:d:p:b:c:o:u:z:n:l:y:", opts, &idx);
+    int c = getopt_long(argc, argv, "hemgi:k:d:p:b:c:o:u:z:n:l:y:r:t:s:", opts, &idx);
 
     if (c == -1) break;
 
@@ -198,9 +225,27 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
         }
         break;
       }
+      case 't': {
+        char *arrival = optarg;
+        if (strcmp(arrival, "poisson") == 0) {
+          state.arrival_type = ArrivalType::POISSON;
+        } else if (strcmp(arrival, "fixed") == 0) {
+          state.arrival_type = ArrivalType::FIXED;
+        } else {
+          LOG_ERROR("Unknown arrival: %s", arrival);
+          exit(EXIT_FAILURE);
+        }
+        break;
+      }
       case 'l':
         state.loader_count = atoi(optarg);
         break;
+      case 'r':
+        state.arrival_rate = atof(optarg);
+        break;
+      case 's':
+        state.server_port = atoi(optarg);
+        break;
       case 'k':
         state.scale_factor = atoi(optarg);
         break;
@@ -262,6 +307,8 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
   ValidateUpdateRatio(state);
   ValidateZipfTheta(state);
   ValidateGCBackendCount(state);
+  ValidateArrivalRate(state);
+  ValidateServerPort(state);
 
   LOG_TRACE("%s : %d", "Run exponential backoff", state.exp_backoff);
   LOG_TRACE("%s : %d", "Run string mode", state.string_mode);
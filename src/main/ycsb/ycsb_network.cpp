@@ -0,0 +1,143 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// ycsb_network.cpp
+//
+// Identification: src/main/ycsb/ycsb_network.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark/ycsb/ycsb_network.h"
+
+#include "common/logger.h"
+#include "util/string_util.h"
+
+namespace peloton {
+namespace benchmark {
+namespace ycsb {
+
+std::unique_ptr<pqxx::connection> ConnectToServer() {
+  // forcing the factory to generate psql protocol handler
+  return std::unique_ptr<pqxx::connection>(
+      new pqxx::connection(StringUtil::Format(
+          "host=127.0.0.1 port=%d user=postgres sslmode=disable "
+          "application_name=psql",
+          state.server_port)));
+}
+
+// The value every field of a row is loaded with, and set to by an update
+static std::string GetFieldValue(const int rowid) {
+  if (state.string_mode == true) {
+    return "'" + std::string(100, 'z') + "'";
+  }
+  return std::to_string(rowid);
+}
+
+void CreateNetworkDatabase() {
+  std::string sql = "CREATE TABLE usertable(ycsb_key INT PRIMARY KEY";
+  for (int col_itr = 1; col_itr <= state.column_count; col_itr++) {
+    sql += ", field" + std::to_string(col_itr);
+    sql += state.string_mode ? " VARCHAR(100)" : " INT";
+  }
+  sql += ");";
+
+  auto connection = ConnectToServer();
+  pqxx::work txn(*connection);
+  txn.exec("DROP TABLE IF EXISTS usertable;");
+  txn.exec(sql);
+  txn.commit();
+}
+
+static void LoadNetworkRows(const int begin_rowid, const int end_rowid) {
+  auto connection = ConnectToServer();
+  pqxx::work txn(*connection);
+
+  for (int rowid = begin_rowid; rowid < end_rowid; rowid++) {
+    std::string value = GetFieldValue(rowid);
+    std::string sql = "INSERT INTO usertable VALUES (" + std::to_string(rowid);
+    for (int col_itr = 1; col_itr <= state.column_count; col_itr++) {
+      sql += ", " + value;
+    }
+    sql += ");";
+    txn.exec(sql);
+  }
+
+  txn.commit();
+}
+
+void LoadNetworkDatabase() {
+  std::chrono::steady_clock::time_point start_time =
+      std::chrono::steady_clock::now();
+
+  const int tuple_count = state.scale_factor * 1000;
+  int row_per_thread = tuple_count / state.loader_count;
+
+  std::vector<std::unique_ptr<std::thread>> load_threads(state.loader_count);
+  for (int thread_id = 0; thread_id < state.loader_count; ++thread_id) {
+    int begin_rowid = row_per_thread * thread_id;
+    int end_rowid = (thread_id == state.loader_count - 1)
+                        ? tuple_count
+                        : row_per_thread * (thread_id + 1);
+    load_threads[thread_id].reset(
+        new std::thread(LoadNetworkRows, begin_rowid, end_rowid));
+  }
+  for (auto &load_thread : load_threads) {
+    load_thread->join();
+  }
+
+  std::chrono::steady_clock::time_point end_time =
+      std::chrono::steady_clock::now();
+  double diff = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    end_time - start_time).count();
+  LOG_INFO("database table loading time = %lf ms", diff);
+}
+
+bool RunNetworkMixed(pqxx::connection &connection, ZipfDistribution &zipf,
+                     FastRandom &rng) {
+  // The server reports a conflict as an error of the statement or of the
+  // commit, and the transaction is rolled back when txn goes out of scope
+  try {
+    pqxx::work txn(connection);
+
+    for (int i = 0; i < state.operation_count; i++) {
+      auto rng_val = rng.NextUniform();
+      auto lookup_key = std::to_string(zipf.GetNextNumber());
+
+      if (rng_val < state.update_ratio) {
+        txn.exec("UPDATE usertable SET field1 = " + GetFieldValue(1) +
+                 " WHERE ycsb_key = " + lookup_key + ";");
+      } else {
+        txn.exec("SELECT * FROM usertable WHERE ycsb_key = " + lookup_key +
+                 ";");
+      }
+    }
+
+    txn.commit();
+    return true;
+  } catch (const pqxx::sql_error &e) {
+    LOG_TRACE("transaction aborted: %s", e.what());
+    return false;
+  } catch (const pqxx::broken_connection &e) {
+    // The server dropped the connection: count an abort and reconnect, so
+    // that the retry runs instead of failing the same way until the end
+    LOG_TRACE("connection lost: %s", e.what());
+    try {
+      connection.activate();
+    } catch (const pqxx::broken_connection &reconnect_error) {
+      LOG_TRACE("reconnect failed: %s", reconnect_error.what());
+    }
+    return false;
+  }
+}
+
+}  // namespace ycsb
+}  // namespace benchmark
+}  // namespace peloton
@@ -27,6 +27,7 @@
 #include "benchmark/ycsb/ycsb_workload.h"
 #include "benchmark/ycsb/ycsb_configuration.h"
 #include "benchmark/ycsb/ycsb_loader.h"
+#include "benchmark/ycsb/ycsb_network.h"
 
 #include "catalog/manager.h"
 #include "catalog/schema.h"
@@ -84,6 +85,9 @@ volatile bool is_running = true;
 PadInt *abort_counts;
 PadInt *commit_counts;
 
+// Set when the transactions arrive at a fixed rate instead of back to back
+OpenLoopDriver *open_loop_driver = nullptr;
+
 #ifndef __APPLE__
 void PinToCore(size_t core) {
   cpu_set_t cpuset;
@@ -110,6 +114,35 @@ void RunBackend(const size_t thread_id) {
 
   FastRandom rng(rand());
 
+  // Over the network every backend is a client with its own connection
+  std::unique_ptr<pqxx::connection> connection;
+  if (state.server_port != 0) {
+    connection = ConnectToServer();
+  }
+  auto run_mixed = [&]() {
+    if (connection != nullptr) {
+      return RunNetworkMixed(*connection, zipf, rng);
+    }
+    return RunMixed(thread_id, zipf, rng);
+  };
+
+  if (open_loop_driver != nullptr) {
+    // YCSB has a single transaction type
+    open_loop_driver->RunWorker(
+        thread_id, []() { return 0; },
+        [&](size_t) {
+          bool committed = run_mixed();
+          if (committed) {
+            transaction_count_ref.data++;
+          } else {
+            execution_count_ref.data++;
+          }
+          return committed;
+        },
+        state.exp_backoff);
+    return;
+  }
+
   // backoff
   uint32_t backoff_shifts = 0;
 
@@ -117,7 +150,7 @@ void RunBackend(const size_t thread_id) {
     if (is_running == false) {
       break;
     }
-    while (RunMixed(thread_id, zipf, rng) == false) {
+    while (run_mixed() == false) {
       if (is_running == false) {
         break;
       }
@@ -160,6 +193,13 @@ void RunWorkload() {
     commit_counts_profiles[round_id] = new PadInt[num_threads];
   }
 
+  if (state.arrival_rate > 0) {
+    open_loop_driver = new OpenLoopDriver(
+        state.arrival_rate, state.arrival_type, state.duration,
+        state.profile_duration, num_threads, {"mixed"});
+    open_loop_driver->Start();
+  }
+
   // Launch a group of threads
   for (size_t thread_itr = 0; thread_itr < num_threads; ++thread_itr) {
     thread_group.push_back(std::thread(RunBackend, thread_itr));
@@ -193,6 +233,12 @@ void RunWorkload() {
     thread_group[thread_itr].join();
   }
 
+  if (open_loop_driver != nullptr) {
+    open_loop_driver->WriteOutput("outputfile.latency");
+    delete open_loop_driver;
+    open_loop_driver = nullptr;
+  }
+
   // calculate the throughput and abort rate for the first round.
   uint64_t total_commit_count = 0;
   for (size_t i = 0; i < num_threads; ++i) {
@@ -27,6 +27,32 @@ inline void CheckOverflow(UNUSED_ATTRIBUTE InputPacket *rpkt,
   PL_ASSERT(rpkt->ptr + size - 1 < rpkt->len);
 }
 
+// Memory of the socket buffers released by the connections of this thread
+static thread_local std::vector<ByteBuf> buffer_pool;
+
+void Buffer::AcquireMemory() {
+  if (buffer_pool.empty() == false) {
+    buf.swap(buffer_pool.back());
+    buffer_pool.pop_back();
+  } else {
+    // capacity of the buffer
+    buf.reserve(SOCKET_BUFFER_SIZE);
+  }
+}
+
+void Buffer::Release() {
+  Reset();
+  if (buf.capacity() == 0) {
+    return;
+  }
+  if (buffer_pool.size() < BUFFER_POOL_SIZE) {
+    buffer_pool.emplace_back();
+    buffer_pool.back().swap(buf);
+  } else {
+    ByteBuf().swap(buf);
+  }
+}
+
 size_t Buffer::GetUInt32BigEndian() {
   size_t num = 0;
   // directly converts from network byte order to little-endian
@@ -171,5 +197,19 @@ void PacketPutCbytes(OutputPacket *pkt, const uchar *b, int len) {
   pkt->len += len;
 }
 
+size_t PacketBeginMessage(OutputPacket *pkt, NetworkMessageType type) {
+  PacketPutByte(pkt, static_cast<uchar>(type));
+  size_t size_offset = pkt->buf.size();
+  // placeholder for the size, which is only known at the end
+  PacketPutInt(pkt, 0, 4);
+  return size_offset;
+}
+
+void PacketEndMessage(OutputPacket *pkt, size_t size_offset) {
+  // the size includes the size field but not the type
+  uint32_t size_nb = htonl(pkt->buf.size() - size_offset);
+  PL_MEMCPY(&pkt->buf[size_offset], &size_nb, sizeof(size_nb));
+}
+
 }  // namespace network
 }  // namespace peloton
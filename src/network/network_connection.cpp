@@ -10,7 +10,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
+
+#include <algorithm>
+
 #include <include/network/postgres_protocol_handler.h>
 #include "network/network_connection.h"
 #include "network/protocol_handler_factory.h"
@@ -18,6 +23,14 @@
 #define SSL_MESSAGE_VERNO 80877103
 #define PROTO_MAJOR_VERSION(x) x >> 16
 #define UNUSED(x) (void)(x)
+
+// Tell the kernel that more data follows a write
+#ifdef MSG_MORE
+#define SOCKET_MORE_DATA_FLAG MSG_MORE
+#else
+#define SOCKET_MORE_DATA_FLAG 0
+#endif
+
 namespace peloton {
 namespace network {
 
@@ -73,6 +86,7 @@ void NetworkConnection::Init(short event_flags, NetworkThread *thread,
 
   event_add(network_event, nullptr);
   event_add(workpool_event, nullptr);
+  registered_flags_ = event_flags;
 
   //TODO:: should put the initialization else where.. check correctness first.
   traffic_cop_.SetTaskCallback(TriggerStateMachine, workpool_event);
@@ -108,6 +122,7 @@ bool NetworkConnection::UpdateEvent(short flags) {
   }
 
   event_flags = flags;
+  registered_flags_ = flags;
 
   if (event_add(network_event, nullptr) == -1) {
     LOG_ERROR("Failed to add event");
@@ -123,6 +138,10 @@ bool NetworkConnection::UpdateEvent(short flags) {
  */
 
 WriteState NetworkConnection::WritePackets() {
+  if (next_response_ < protocol_handler_->responses.size()) {
+    wbuf_.Acquire();
+  }
+
   // iterate through all the packets
   for (; next_response_ < protocol_handler_->responses.size(); next_response_++) {
     auto pkt = protocol_handler_->responses[next_response_].get();
@@ -135,7 +154,7 @@ WriteState NetworkConnection::WritePackets() {
   }
 
   // Done writing all packets. clear packets
-  protocol_handler_->responses.clear();
+  protocol_handler_->RecycleResponses();
   next_response_ = 0;
 
   if (protocol_handler_->force_flush == true) {
@@ -149,6 +168,8 @@ ReadState NetworkConnection::FillReadBuffer() {
   ssize_t bytes_read = 0;
   bool done = false;
 
+  rbuf_.Acquire();
+
   // reset buffer if all the contents have been read
   if (rbuf_.buf_ptr == rbuf_.buf_size) rbuf_.Reset();
 
@@ -247,19 +268,42 @@ ReadState NetworkConnection::FillReadBuffer() {
   return result;
 }
 
-WriteState NetworkConnection::FlushWriteBuffer() {
+WriteState NetworkConnection::FlushWriteBuffer(OutputPacket *pkt,
+                                               size_t pkt_bytes,
+                                               bool more_data) {
   ssize_t written_bytes = 0;
   // while we still have outstanding bytes to write
-  while (wbuf_.buf_size > 0) {
+  while (wbuf_.buf_ptr > wbuf_.buf_flush_ptr || pkt_bytes > 0) {
+    // The buffered bytes go first, followed by the packet contents that are
+    // written without copying them into the buffer
+    struct iovec iov[2];
+    int iovcnt = 0;
+    if (wbuf_.buf_ptr > wbuf_.buf_flush_ptr) {
+      iov[iovcnt].iov_base = &wbuf_.buf[wbuf_.buf_flush_ptr];
+      iov[iovcnt].iov_len = wbuf_.buf_ptr - wbuf_.buf_flush_ptr;
+      iovcnt++;
+    }
+    if (pkt_bytes > 0) {
+      iov[iovcnt].iov_base = &pkt->buf[pkt->write_ptr];
+      iov[iovcnt].iov_len = pkt_bytes;
+      iovcnt++;
+    }
+
     written_bytes = 0;
     while (written_bytes <= 0) {
       if (conn_SSL_context != nullptr) {
         written_bytes =
-            SSL_write(conn_SSL_context, &wbuf_.buf[wbuf_.buf_flush_ptr], wbuf_.buf_size);
+            SSL_write(conn_SSL_context, iov[0].iov_base, iov[0].iov_len);
       }
       else {
+        // Hold back a partial segment while more data follows, like
+        // TCP_CORK, so that it leaves with the rest of the response
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = iovcnt;
         written_bytes =
-           write(sock_fd, &wbuf_.buf[wbuf_.buf_flush_ptr], wbuf_.buf_size);
+            sendmsg(sock_fd, &msg, more_data ? SOCKET_MORE_DATA_FLAG : 0);
       }
       // Write failed
       if (written_bytes < 0) {
@@ -322,22 +366,31 @@ WriteState NetworkConnection::FlushWriteBuffer() {
       }
 
       // weird edge case?
-      if (written_bytes == 0 && wbuf_.buf_size != 0) {
+      if (written_bytes == 0) {
         LOG_DEBUG("Not all data is written");
         continue;
       }
     }
 
-    // update book keeping
-    wbuf_.buf_flush_ptr += written_bytes;
-    wbuf_.buf_size -= written_bytes;
+    // update book keeping, the buffered bytes were written first
+    size_t buffered_bytes =
+        std::min(static_cast<size_t>(written_bytes),
+                 wbuf_.buf_ptr - wbuf_.buf_flush_ptr);
+    wbuf_.buf_flush_ptr += buffered_bytes;
+    wbuf_.buf_size = wbuf_.buf_ptr - wbuf_.buf_flush_ptr;
+    pkt_bytes -= written_bytes - buffered_bytes;
+    if (pkt != nullptr) {
+      pkt->write_ptr += written_bytes - buffered_bytes;
+    }
   }
 
   // buffer is empty
   wbuf_.Reset();
 
-  // we have flushed, disable force flush now
-  protocol_handler_->force_flush = false;
+  // we have flushed the whole response, disable force flush now
+  if (more_data == false) {
+    protocol_handler_->force_flush = false;
+  }
 
   // we are ok
   return WriteState::WRITE_COMPLETE;
@@ -503,7 +556,7 @@ WriteState NetworkConnection::BufferWriteBytesHeader(OutputPacket *pkt) {
   // check if we have enough space in the buffer
   if (wbuf_.GetMaxSize() - wbuf_.buf_ptr < 1 + sizeof(int32_t)) {
     // buffer needs to be flushed before adding header
-    auto result = FlushWriteBuffer();
+    auto result = FlushWriteBuffer(nullptr, 0, true);
     if (result == WriteState::WRITE_NOT_READY || result == WriteState::WRITE_ERROR) {
       // Socket is not ready for write
       return result;
@@ -526,7 +579,7 @@ WriteState NetworkConnection::BufferWriteBytesHeader(OutputPacket *pkt) {
 
   // move the write buffer pointer and update size of the socket buffer
   wbuf_.buf_ptr += sizeof(int32_t);
-  wbuf_.buf_size = wbuf_.buf_ptr;
+  wbuf_.buf_size = wbuf_.buf_ptr - wbuf_.buf_flush_ptr;
 
   // Header is written to socket buf. No need to write it in the future
   pkt->skip_header_write = true;
@@ -536,59 +589,70 @@ WriteState NetworkConnection::BufferWriteBytesHeader(OutputPacket *pkt) {
 // Writes a packet's content into the write buffer
 // Return false when the socket is not ready for write
 WriteState NetworkConnection::BufferWriteBytesContent(OutputPacket *pkt) {
-  // the packet content to write
-  ByteBuf &pkt_buf = pkt->buf;
   // the length of remaining content to write
-  size_t len = pkt->len;
+  size_t len = pkt->len - pkt->write_ptr;
   // window is the size of remaining space in socket's wbuf
-  size_t window = 0;
-
-  // fill the contents
-  while (len) {
-    // calculate the remaining space in wbuf
-    window = wbuf_.GetMaxSize() - wbuf_.buf_ptr;
-    if (len <= window) {
-      // contents fit in the window, range copy "len" bytes
-      std::copy(std::begin(pkt_buf) + pkt->write_ptr,
-                std::begin(pkt_buf) + pkt->write_ptr + len,
-                std::begin(wbuf_.buf) + wbuf_.buf_ptr);
-
-      // Move the cursor and update size of socket buffer
-      wbuf_.buf_ptr += len;
-      wbuf_.buf_size = wbuf_.buf_ptr;
-      LOG_TRACE("Content fit in window. Write content successful");
-      return WriteState::WRITE_COMPLETE;
-    } else {
-      // contents longer than socket buffer size, fill up the socket buffer
-      // with "window" bytes
-
-      std::copy(std::begin(pkt_buf) + pkt->write_ptr,
-                std::begin(pkt_buf) + pkt->write_ptr + window,
-                std::begin(wbuf_.buf) + wbuf_.buf_ptr);
-
-      // move the packet's cursor
-      pkt->write_ptr += window;
-      len -= window;
-      // Now the wbuf is full
-      wbuf_.buf_size = wbuf_.GetMaxSize();
-
-      LOG_TRACE("Content doesn't fit in window. Try flushing");
-      auto result = FlushWriteBuffer();
-      // flush before write the remaining content
-      if (result == WriteState::WRITE_NOT_READY || result == WriteState::WRITE_ERROR) {
-        // need to retry or close connection
-        return result;
-      }
+  size_t window = wbuf_.GetMaxSize() - wbuf_.buf_ptr;
+
+  if (len > window) {
+    // Contents longer than the window are written straight from the packet,
+    // together with what is in the socket buffer. Only the tail is copied,
+    // so that it is written with the packets that follow.
+    size_t tail = len % wbuf_.GetMaxSize();
+    if (tail == 0) tail = wbuf_.GetMaxSize();
+
+    LOG_TRACE("Content doesn't fit in window. Writing %lu bytes directly",
+              len - tail);
+    auto result = FlushWriteBuffer(pkt, len - tail, true);
+    if (result == WriteState::WRITE_NOT_READY ||
+        result == WriteState::WRITE_ERROR) {
+      // need to retry or close connection
+      return result;
     }
+    len = tail;
   }
+
+  // contents fit in the window, range copy "len" bytes
+  std::copy(std::begin(pkt->buf) + pkt->write_ptr,
+            std::begin(pkt->buf) + pkt->write_ptr + len,
+            std::begin(wbuf_.buf) + wbuf_.buf_ptr);
+
+  // Move the cursors and update size of socket buffer
+  pkt->write_ptr += len;
+  wbuf_.buf_ptr += len;
+  wbuf_.buf_size = wbuf_.buf_ptr - wbuf_.buf_flush_ptr;
+  LOG_TRACE("Content fit in window. Write content successful");
   return WriteState::WRITE_COMPLETE;
 }
 
+void NetworkConnection::ReleaseIdleBuffers() {
+  if (rbuf_.buf_ptr == rbuf_.buf_size) {
+    rbuf_.Release();
+  }
+  if (wbuf_.buf_ptr == wbuf_.buf_flush_ptr) {
+    wbuf_.Release();
+  }
+}
+
+size_t NetworkConnection::GetMemoryUsage() const {
+  size_t bytes = sizeof(*this) + rbuf_.GetMemoryUsage() +
+                 wbuf_.GetMemoryUsage() + 2 * event_get_struct_event_size();
+  if (protocol_handler_ != nullptr) {
+    bytes += protocol_handler_->GetMemoryUsage();
+  }
+  return bytes;
+}
+
 void NetworkConnection::CloseSocket() {
   LOG_DEBUG("Attempt to close the connection %d", sock_fd);
+  // The connection no longer loads its thread
+  if (state != ConnState::CONN_LISTENING) {
+    thread->RemoveConnection();
+  }
   // Remove listening event
   event_del(network_event);
   event_del(workpool_event);
+  registered_flags_ = 0;
   // event_free(event);
   TransitState(ConnState::CONN_CLOSED);
   Reset();
@@ -608,8 +672,8 @@ void NetworkConnection::CloseSocket() {
 
 void NetworkConnection::Reset() {
   client_.Reset();
-  rbuf_.Reset();
-  wbuf_.Reset();
+  rbuf_.Release();
+  wbuf_.Release();
   // The listening connection do not have protocol handler
   if (protocol_handler_ != nullptr) {
     protocol_handler_->Reset();
@@ -667,7 +731,12 @@ void NetworkConnection::StateMachine(NetworkConnection *conn) {
       }
 
       case ConnState::CONN_WAIT: {
-        if (conn->UpdateEvent(EV_READ | EV_PERSIST) == false) {
+        // Everything read has been processed, release what the connection
+        // does not need while it waits
+        conn->ReleaseIdleBuffers();
+
+        if (conn->registered_flags_ != (EV_READ | EV_PERSIST) &&
+            conn->UpdateEvent(EV_READ | EV_PERSIST) == false) {
           LOG_ERROR("Failed to update event, closing");
           conn->TransitState(ConnState::CONN_CLOSING);
           break;
@@ -767,7 +836,9 @@ void NetworkConnection::StateMachine(NetworkConnection *conn) {
         // examine write packets result
         switch (conn->WritePackets()) {
           case WriteState::WRITE_COMPLETE: {
-            if (!conn->UpdateEvent(EV_READ | EV_PERSIST)) {
+            // Only a write that could not complete changes the event
+            if (conn->registered_flags_ != (EV_READ | EV_PERSIST) &&
+                !conn->UpdateEvent(EV_READ | EV_PERSIST)) {
               LOG_ERROR("Failed to update event, closing");
               conn->TransitState(ConnState::CONN_CLOSING);
               break;
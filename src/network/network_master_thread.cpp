@@ -13,6 +13,8 @@
 
 #include "network/network_master_thread.h"
 
+#include "common/numa_topology.h"
+
 #define MASTER_THREAD_ID -1
 
 namespace peloton {
@@ -92,6 +94,7 @@ void NetworkMasterThread::Stop() {
  * Start with worker event loop
  */
 void NetworkMasterThread::StartWorker(NetworkWorkerThread *worker_thread) {
+  NumaTopology::GetInstance().PinThreadToNextNode();
   event_base_loop(worker_thread->GetEventBase(), 0);
   // Set worker thread's close flag to false to indicate loop has exited
   worker_thread->SetThreadIsClosed(false);
@@ -110,8 +113,8 @@ void NetworkMasterThread::StartWorker(NetworkWorkerThread *worker_thread) {
 }
 
 /*
-* Dispatch a new connection event to a random worker thread by
-* writing to the worker's pipe
+* Dispatch a new connection event to the worker thread with the fewest open
+* connections by writing to the worker's pipe
 */
 void NetworkMasterThread::DispatchConnection(int new_conn_fd,
                                               short event_flags) {
@@ -119,13 +122,22 @@ void NetworkMasterThread::DispatchConnection(int new_conn_fd,
   buf[0] = 'c';
   auto &threads = GetWorkerThreads();
 
-  // Dispatch by rand number
-  int thread_id = next_thread_id_;
+  // Threads with as many connections are picked in round robin order
+  int first_thread_id = next_thread_id_;
+  int thread_id = first_thread_id;
+  for (int offset = 1; offset < num_threads_; offset++) {
+    int candidate = (first_thread_id + offset) % num_threads_;
+    if (threads[candidate]->GetConnectionCount() <
+        threads[thread_id]->GetConnectionCount()) {
+      thread_id = candidate;
+    }
+  }
 
   // update next threadID
-  next_thread_id_ = (next_thread_id_ + 1) % num_threads_;
+  next_thread_id_ = (thread_id + 1) % num_threads_;
 
   std::shared_ptr<NetworkWorkerThread> worker_thread = threads[thread_id];
+  worker_thread->AddConnection();
   LOG_DEBUG("Dispatching connection to worker %d", thread_id);
 
   std::shared_ptr<NewConnQueueItem> item(
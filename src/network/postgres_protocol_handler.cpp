@@ -19,6 +19,7 @@
 #include "common/macros.h"
 #include "common/portal.h"
 #include "planner/abstract_plan.h"
+#include "planner/copy_plan.h"
 #include "planner/delete_plan.h"
 #include "planner/insert_plan.h"
 #include "planner/update_plan.h"
@@ -145,13 +146,19 @@ void PostgresProtocolHandler::SendDataRows(std::vector<StatementResult> &results
 
   size_t numrows = results.size() / colcount;
 
-  // 1 packet per row
+  // Rows are encoded as complete messages into large packets, so that a
+  // result needs a handful of packets and writes instead of one per row
+  std::unique_ptr<OutputPacket> pkt;
   for (size_t i = 0; i < numrows; i++) {
-    std::unique_ptr<OutputPacket> pkt(new OutputPacket());
-    pkt->msg_type = NetworkMessageType::DATA_ROW;
+    if (pkt == nullptr) {
+      pkt = GetBatchPacket();
+      pkt->msg_type = NetworkMessageType::DATA_ROW;
+    }
+    auto size_offset =
+        PacketBeginMessage(pkt.get(), NetworkMessageType::DATA_ROW);
     PacketPutInt(pkt.get(), colcount, 2);
     for (int j = 0; j < colcount; j++) {
-      auto content = results[i * colcount + j].second;
+      const auto &content = results[i * colcount + j].second;
       if (content.size() == 0) {
         // content is NULL
         PacketPutInt(pkt.get(), NULL_CONTENT_SIZE, 4);
@@ -163,9 +170,19 @@ void PostgresProtocolHandler::SendDataRows(std::vector<StatementResult> &results
         PacketPutBytes(pkt.get(), content);
       }
     }
+    PacketEndMessage(pkt.get(), size_offset);
+
+    if (pkt->len >= RESPONSE_BATCH_SIZE) {
+      responses.push_back(std::move(pkt));
+    }
+  }
+  if (pkt != nullptr) {
     responses.push_back(std::move(pkt));
   }
   rows_affected = numrows;
+
+  // The rows are encoded, do not hold on to them while the connection idles
+  std::vector<StatementResult>().swap(results);
 }
 
 void PostgresProtocolHandler::CompleteCommand(const std::string &query, const QueryType& query_type, int rows) {
@@ -371,6 +388,17 @@ ProcessResult PostgresProtocolHandler::ExecQueryMessage(InputPacket *pkt, const
           SendReadyForQuery(NetworkTransactionStateType::IDLE);
           return ProcessResult::COMPLETE;
         }
+        // COPY FROM STDIN runs once the client has streamed all the data
+        if (statement_->GetPlanTree() != nullptr &&
+            statement_->GetPlanTree()->GetPlanNodeType() ==
+                PlanNodeType::COPY) {
+          auto copy_plan = static_cast<const planner::CopyPlan *>(
+              statement_->GetPlanTree().get());
+          if (copy_plan->IsCopyFromStdin()) {
+            SendCopyInResponse(copy_plan);
+            return ProcessResult::COMPLETE;
+          }
+        }
         // ExecuteStatment
         std::vector<type::Value> param_values;
         param_values_ = param_values;
@@ -413,6 +441,12 @@ ProcessResult PostgresProtocolHandler::ExecQueryMessage(InputPacket *pkt, const
 }
 
 void PostgresProtocolHandler::ExecQueryMessageGetResult(ResultType status) {
+  // The statement may stay cached, but the data of a COPY FROM STDIN is done
+  if (copy_plan_ != nullptr) {
+    copy_plan_->ClearCopyData();
+    copy_plan_ = nullptr;
+  }
+
   std::vector<FieldInfo> tuple_descriptor;
   if (status == ResultType::SUCCESS) {
     tuple_descriptor = statement_->GetTupleDescriptor();
@@ -435,6 +469,76 @@ void PostgresProtocolHandler::ExecQueryMessageGetResult(ResultType status) {
   SendReadyForQuery(NetworkTransactionStateType::IDLE);
 }
 
+/*
+ * send_copy_in_response - Switch the connection into the copy-in sub-protocol
+ *  for a COPY FROM STDIN. All columns are transferred in text format.
+ */
+void PostgresProtocolHandler::SendCopyInResponse(
+    const planner::CopyPlan *copy_plan) {
+  int column_count = copy_plan->target_table->GetSchema()->GetColumnCount();
+
+  std::unique_ptr<OutputPacket> pkt(new OutputPacket());
+  pkt->msg_type = NetworkMessageType::COPY_IN_RESPONSE;
+  PacketPutByte(pkt.get(), 0);
+  PacketPutInt(pkt.get(), column_count, 2);
+  for (int column_itr = 0; column_itr < column_count; column_itr++) {
+    PacketPutInt(pkt.get(), 0, 2);
+  }
+  responses.push_back(std::move(pkt));
+
+  copy_in_progress_ = true;
+  copy_data_.clear();
+}
+
+void PostgresProtocolHandler::ExecCopyDataMessage(InputPacket *pkt) {
+  if (copy_in_progress_ == false) {
+    LOG_ERROR("Received copy data outside of COPY FROM STDIN");
+    return;
+  }
+  copy_data_.append(pkt->Begin(), pkt->End());
+}
+
+ProcessResult PostgresProtocolHandler::ExecCopyDoneMessage(
+    const size_t thread_id) {
+  if (copy_in_progress_ == false) {
+    LOG_ERROR("Received copy done outside of COPY FROM STDIN");
+    return ProcessResult::COMPLETE;
+  }
+  copy_in_progress_ = false;
+
+  // Hand the data over to the plan and execute the statement as usual
+  auto copy_plan =
+      static_cast<planner::CopyPlan *>(statement_->GetPlanTree().get());
+  copy_plan->SetCopyData(std::move(copy_data_));
+  copy_data_.clear();
+  copy_plan_ = copy_plan;
+
+  std::vector<type::Value> param_values;
+  param_values_ = param_values;
+  bool unnamed = false;
+  std::vector<int> result_format(statement_->GetTupleDescriptor().size(), 0);
+  result_format_ = result_format;
+  auto status = traffic_cop_->ExecuteStatement(
+      statement_, param_values_, unnamed, nullptr, result_format_, results_,
+      rows_affected_, error_message_, thread_id);
+  if (traffic_cop_->is_queuing_) {
+    return ProcessResult::PROCESSING;
+  }
+  ExecQueryMessageGetResult(status);
+  return ProcessResult::COMPLETE;
+}
+
+void PostgresProtocolHandler::ExecCopyFailMessage(InputPacket *pkt) {
+  std::string reason;
+  PacketGetString(pkt, pkt->len, reason);
+  copy_in_progress_ = false;
+  copy_data_.clear();
+
+  SendErrorResponse({{NetworkMessageType::HUMAN_READABLE_ERROR,
+                      "COPY FROM STDIN failed: " + reason}});
+  SendReadyForQuery(NetworkTransactionStateType::IDLE);
+}
+
 /*
  * exec_parse_message - handle PARSE message
  */
@@ -472,6 +576,7 @@ void PostgresProtocolHandler::ExecParseMessage(InputPacket *pkt) {
                                              error_message);
   if (statement.get() == nullptr) {
     skipped_stmt_ = true;
+    ignore_until_sync_ = true;
     SendErrorResponse(
         {{NetworkMessageType::HUMAN_READABLE_ERROR, error_message}});
     LOG_TRACE("ExecParse Error");
@@ -546,6 +651,7 @@ void PostgresProtocolHandler::ExecBindMessage(InputPacket *pkt) {
   int num_params = PacketGetInt(pkt, 2);
   // error handling
   if (num_params_format != num_params) {
+    ignore_until_sync_ = true;
     std::string error_message =
         "Malformed request: num_params_format is not equal to num_params";
     SendErrorResponse(
@@ -564,6 +670,7 @@ void PostgresProtocolHandler::ExecBindMessage(InputPacket *pkt) {
 
     // Check unnamed statement
     if (statement.get() == nullptr) {
+      ignore_until_sync_ = true;
       std::string error_message = "Invalid unnamed statement";
       LOG_ERROR("%s", error_message.c_str());
       SendErrorResponse(
@@ -579,6 +686,7 @@ void PostgresProtocolHandler::ExecBindMessage(InputPacket *pkt) {
     }
     // Did not find statement with same name
     else {
+      ignore_until_sync_ = true;
       std::string error_message = "The prepared statement does not exist";
       LOG_ERROR("%s", error_message.c_str());
       SendErrorResponse(
@@ -850,8 +958,8 @@ ProcessResult PostgresProtocolHandler::ExecDescribeMessage(InputPacket *pkt) {
   return ProcessResult::COMPLETE;
 }
 
-ProcessResult PostgresProtocolHandler::ExecExecuteMessage(InputPacket *pkt,
-                                       const size_t thread_id) {
+ProcessResult PostgresProtocolHandler::ExecExecuteMessage(
+    InputPacket *pkt, UNUSED_ATTRIBUTE const size_t thread_id) {
   // EXECUTE message
   protocol_type_ = NetworkProtocolType::POSTGRES_JDBC;
   std::string error_message, portal_name;
@@ -893,18 +1001,57 @@ ProcessResult PostgresProtocolHandler::ExecExecuteMessage(InputPacket *pkt,
     return ProcessResult::TERMINATE;
   }
 
-  auto statement_name = statement_->GetStatementName();
-  bool unnamed = statement_name.empty();
-  param_values_ = portal->GetParameters();
+  // Queue the statement, it runs with the ones of the following EXECUTE
+  // messages once the pipeline ends
+  tcop::PipelinedStatement pipelined;
+  pipelined.statement_ = statement_;
+  pipelined.params_ = portal->GetParameters();
+  pipelined.param_stats_ = param_stat;
+  pipelined.result_format_ = result_format_;
+  pipeline_.push_back(std::move(pipelined));
+  pipeline_offsets_.push_back(responses.size());
+  return ProcessResult::COMPLETE;
+}
 
-  auto status = traffic_cop_->ExecuteStatement(
-      statement_, param_values_, unnamed, param_stat, result_format_, results_,
-      rows_affected_, error_message_, thread_id);
-  if (traffic_cop_->is_queuing_) {
-    return ProcessResult::PROCESSING;
+ProcessResult PostgresProtocolHandler::ExecPipeline(const size_t thread_id) {
+  LOG_TRACE("Execute pipeline of %lu statements", pipeline_.size());
+  traffic_cop_->ExecutePipeline(pipeline_, thread_id);
+  return ProcessResult::PROCESSING;
+}
+
+void PostgresProtocolHandler::ExecPipelineGetResult() {
+  // Put the results of every statement right after the responses of the
+  // messages that came before its EXECUTE
+  ResponseBuffer buffered;
+  buffered.swap(responses);
+  size_t next_response = 0;
+  for (size_t pipeline_idx = 0; pipeline_idx < pipeline_.size();
+       pipeline_idx++) {
+    auto &pipelined = pipeline_[pipeline_idx];
+    for (; next_response < pipeline_offsets_[pipeline_idx]; next_response++) {
+      responses.push_back(std::move(buffered[next_response]));
+    }
+
+    statement_ = pipelined.statement_;
+    results_ = std::move(pipelined.results_);
+    rows_affected_ = pipelined.rows_changed_;
+    error_message_ = pipelined.error_message_;
+    ExecExecuteMessageGetResult(pipelined.status_);
+
+    // After an error the client discards everything up to the SYNC, so
+    // the rest of the pipeline gets no response. The failed result set
+    // ignore_until_sync_ for the messages that are still to come.
+    if (pipelined.Failed() == true) {
+      next_response = buffered.size();
+      break;
+    }
   }
-  ExecExecuteMessageGetResult(status);
-  return ProcessResult::COMPLETE;
+  for (; next_response < buffered.size(); next_response++) {
+    responses.push_back(std::move(buffered[next_response]));
+  }
+
+  pipeline_.clear();
+  pipeline_offsets_.clear();
 }
 
 void PostgresProtocolHandler::ExecExecuteMessageGetResult(ResultType status) {
@@ -912,12 +1059,14 @@ void PostgresProtocolHandler::ExecExecuteMessageGetResult(ResultType status) {
   switch (status) {
     case ResultType::FAILURE:
       LOG_ERROR("Failed to execute: %s", error_message_.c_str());
+      ignore_until_sync_ = true;
       SendErrorResponse(
           {{NetworkMessageType::HUMAN_READABLE_ERROR, error_message_}});
       return;
     case ResultType::ABORTED:
       if (query_type != QueryType::QUERY_ROLLBACK) {
         LOG_DEBUG("Failed to execute: Conflicting txn aborted");
+        ignore_until_sync_ = true;
         // Send an error response if the abort is not due to ROLLBACK query
         SendErrorResponse({{NetworkMessageType::SQLSTATE_CODE_ERROR,
                             SqlStateErrorCodeToString(
@@ -935,6 +1084,11 @@ void PostgresProtocolHandler::ExecExecuteMessageGetResult(ResultType status) {
 }
 
 void PostgresProtocolHandler::GetResult() {
+  if (pipeline_.empty() == false) {
+    LOG_TRACE("Pipeline result");
+    ExecPipelineGetResult();
+    return;
+  }
   traffic_cop_->ExecuteStatementPlanGetResult();
   auto status = traffic_cop_->ExecuteStatementGetResult(rows_affected_);
   switch (protocol_type_) {
@@ -1056,29 +1210,55 @@ bool PostgresProtocolHandler::ReadPacket(Buffer &rbuf, InputPacket &rpkt) {
   return true;
 }
 
+// Processes every complete packet in the read buffer, so that the responses
+// to a pipeline of messages are written together
 ProcessResult PostgresProtocolHandler::Process(Buffer &rbuf, const size_t thread_id) {
-  if (request.header_parsed == false) {
-    // parse out the header first
-    if (ReadPacketHeader(rbuf, request) == false) {
-      // need more data
-      return ProcessResult::MORE_DATA_REQUIRED;
+  bool processed = false;
+  while (true) {
+    if (request.header_parsed == false) {
+      // parse out the header first
+      if (ReadPacketHeader(rbuf, request) == false) {
+        // need more data
+        break;
+      }
     }
-  }
-  PL_ASSERT(request.header_parsed == true);
+    PL_ASSERT(request.header_parsed == true);
 
-  if (request.is_initialized == false) {
-    // packet needs to be initialized with rest of the contents
-    if (PostgresProtocolHandler::ReadPacket(rbuf, request) == false) {
-      // need more data
-      return ProcessResult::MORE_DATA_REQUIRED;
+    if (request.is_initialized == false) {
+      // packet needs to be initialized with rest of the contents
+      if (PostgresProtocolHandler::ReadPacket(rbuf, request) == false) {
+        // need more data
+        break;
+      }
     }
-  }
 
-  auto process_status = ProcessPacket(&request, thread_id);
+    // Only BIND, DESCRIBE and EXECUTE messages extend a pipeline. Run it
+    // first and keep the packet until its results are in
+    if (pipeline_.empty() == false &&
+        request.msg_type != NetworkMessageType::BIND_COMMAND &&
+        request.msg_type != NetworkMessageType::DESCRIBE_COMMAND &&
+        request.msg_type != NetworkMessageType::EXECUTE_COMMAND) {
+      return ExecPipeline(thread_id);
+    }
 
-  request.Reset();
+    auto process_status = ProcessPacket(&request, thread_id);
 
-  return process_status;
+    request.Reset();
+
+    if (process_status != ProcessResult::COMPLETE) {
+      return process_status;
+    }
+    processed = true;
+  }
+
+  // Do not wait for more messages to run the pipeline
+  if (pipeline_.empty() == false) {
+    return ExecPipeline(thread_id);
+  }
+  if (processed == true) {
+    return ProcessResult::COMPLETE;
+  }
+  return ProcessResult::MORE_DATA_REQUIRED;
 }
 
 
@@ -1091,6 +1271,22 @@ ProcessResult PostgresProtocolHandler::ProcessPacket(InputPacket *pkt, const siz
   // We don't set force_flush to true for `PBDE` messages because they're
   // part of the extended protocol. Buffer responses and don't flush until
   // we see a SYNC
+  // After a failed message of the extended protocol, skip the others until
+  // the SYNC
+  if (ignore_until_sync_ == true) {
+    switch (pkt->msg_type) {
+      case NetworkMessageType::PARSE_COMMAND:
+      case NetworkMessageType::BIND_COMMAND:
+      case NetworkMessageType::DESCRIBE_COMMAND:
+      case NetworkMessageType::EXECUTE_COMMAND:
+      case NetworkMessageType::CLOSE_COMMAND:
+        LOG_TRACE("Ignoring message until SYNC");
+        return ProcessResult::COMPLETE;
+      default:
+        break;
+    }
+  }
+
   switch (pkt->msg_type) {
     case NetworkMessageType::SIMPLE_QUERY_COMMAND: {
       LOG_TRACE("SIMPLE_QUERY_COMMAND");
@@ -1115,6 +1311,7 @@ ProcessResult PostgresProtocolHandler::ProcessPacket(InputPacket *pkt, const siz
     }
     case NetworkMessageType::SYNC_COMMAND: {
       LOG_TRACE("SYNC_COMMAND");
+      ignore_until_sync_ = false;
       SendReadyForQuery(txn_state_);
       force_flush = true;
     } break;
@@ -1122,6 +1319,20 @@ ProcessResult PostgresProtocolHandler::ProcessPacket(InputPacket *pkt, const siz
       LOG_TRACE("CLOSE_COMMAND");
       ExecCloseMessage(pkt);
     } break;
+    case NetworkMessageType::COPY_DATA_COMMAND: {
+      LOG_TRACE("COPY_DATA_COMMAND");
+      ExecCopyDataMessage(pkt);
+    } break;
+    case NetworkMessageType::COPY_DONE_COMMAND: {
+      LOG_TRACE("COPY_DONE_COMMAND");
+      force_flush = true;
+      return ExecCopyDoneMessage(thread_id);
+    }
+    case NetworkMessageType::COPY_FAIL_COMMAND: {
+      LOG_TRACE("COPY_FAIL_COMMAND");
+      force_flush = true;
+      ExecCopyFailMessage(pkt);
+    } break;
     case NetworkMessageType::TERMINATE_COMMAND: {
       LOG_TRACE("TERMINATE_COMMAND");
       force_flush = true;
@@ -1171,6 +1382,13 @@ void PostgresProtocolHandler::SendReadyForQuery(NetworkTransactionStateType txn_
   responses.push_back(std::move(pkt));
 }
 
+size_t PostgresProtocolHandler::GetMemoryUsage() const {
+  return sizeof(*this) + GetBufferMemoryUsage() +
+         results_.capacity() * sizeof(StatementResult) +
+         param_values_.capacity() * sizeof(type::Value) +
+         result_format_.capacity() * sizeof(int) + copy_data_.capacity();
+}
+
 void PostgresProtocolHandler::Reset() {
   ProtocolHandler::Reset();
 
@@ -1179,12 +1397,18 @@ void PostgresProtocolHandler::Reset() {
   results_.clear();
   param_values_.clear();
   txn_state_ = NetworkTransactionStateType::IDLE;
+  ignore_until_sync_ = false;
   skipped_stmt_ = false;
   skipped_query_string_.clear();
+  copy_in_progress_ = false;
+  copy_data_.clear();
+  copy_plan_ = nullptr;
 
   statement_cache_.clear();
   table_statement_cache_.clear();
   portals_.clear();
+  pipeline_.clear();
+  pipeline_offsets_.clear();
 }
 
 }  // namespace network
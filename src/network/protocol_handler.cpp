@@ -16,6 +16,10 @@
 namespace peloton {
 namespace network {
 
+  // Batch packets kept for reuse by the connections of this thread, so an
+  // idle connection holds none
+  static thread_local ResponseBuffer batch_packet_pool;
+
   ProtocolHandler::ProtocolHandler(tcop::TrafficCop *traffic_cop) {
     this->traffic_cop_ = traffic_cop;
   }
@@ -38,6 +42,46 @@ namespace network {
     responses.clear();
     request.Reset();
   }
+
+  std::unique_ptr<OutputPacket> ProtocolHandler::GetBatchPacket() {
+    std::unique_ptr<OutputPacket> pkt;
+    if (batch_packet_pool.empty() == false) {
+      pkt = std::move(batch_packet_pool.back());
+      batch_packet_pool.pop_back();
+      pkt->buf.clear();
+      pkt->len = pkt->ptr = pkt->write_ptr = 0;
+    } else {
+      pkt.reset(new OutputPacket());
+      // leave room for the message that crosses the batch size
+      pkt->buf.reserve(RESPONSE_BATCH_SIZE + SOCKET_BUFFER_SIZE);
+    }
+    pkt->msg_type = NetworkMessageType::NULL_COMMAND;
+    pkt->skip_header_write = true;
+    return pkt;
+  }
+
+  void ProtocolHandler::RecycleResponses() {
+    for (auto &pkt : responses) {
+      if (batch_packet_pool.size() < MAX_BATCH_PACKET_POOL_SIZE &&
+          pkt->buf.capacity() >= RESPONSE_BATCH_SIZE) {
+        batch_packet_pool.push_back(std::move(pkt));
+      }
+    }
+    responses.clear();
+  }
+
+  size_t ProtocolHandler::GetMemoryUsage() const {
+    return sizeof(*this) + GetBufferMemoryUsage();
+  }
+
+  size_t ProtocolHandler::GetBufferMemoryUsage() const {
+    size_t bytes = request.GetMemoryUsage() +
+                   responses.capacity() * sizeof(std::unique_ptr<OutputPacket>);
+    for (auto &pkt : responses) {
+      bytes += sizeof(OutputPacket) + pkt->buf.capacity();
+    }
+    return bytes;
+  }
   
   void ProtocolHandler::GetResult() {}
 }  // namespace network
@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// arena.cpp
+//
+// Identification: src/optimizer/arena.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/arena.h"
+
+#include <cstdint>
+
+namespace peloton {
+namespace optimizer {
+
+Arena::Arena() {}
+
+Arena::~Arena() { Reset(); }
+
+static char *AlignUp(char *address, size_t alignment) {
+  uintptr_t aligned = (reinterpret_cast<uintptr_t>(address) + alignment - 1) &
+                      ~(static_cast<uintptr_t>(alignment) - 1);
+  return reinterpret_cast<char *>(aligned);
+}
+
+void *Arena::Allocate(size_t size, size_t alignment) {
+  PL_ASSERT((alignment & (alignment - 1)) == 0);
+  allocated_bytes_ += size;
+
+  // Large allocations get a block of their own, so that the current block
+  // keeps its free space
+  if (size > BLOCK_SIZE / 4) {
+    blocks_.emplace_back(new char[size + alignment]);
+    return AlignUp(blocks_.back().get(), alignment);
+  }
+
+  char *address = AlignUp(current_, alignment);
+  if (current_ == nullptr ||
+      static_cast<size_t>(address - current_) + size > remaining_) {
+    current_ = NextBlock();
+    remaining_ = BLOCK_SIZE;
+    address = AlignUp(current_, alignment);
+  }
+
+  remaining_ -= (address - current_) + size;
+  current_ = address + size;
+  return address;
+}
+
+char *Arena::NextBlock() {
+  // The first block survives a reset
+  if (first_block_used_ == false) {
+    first_block_used_ = true;
+    if (first_block_ == nullptr) {
+      first_block_.reset(new char[BLOCK_SIZE]);
+    }
+    return first_block_.get();
+  }
+  blocks_.emplace_back(new char[BLOCK_SIZE]);
+  return blocks_.back().get();
+}
+
+void Arena::Reset() {
+  for (auto itr = destructors_.rbegin(); itr != destructors_.rend(); ++itr) {
+    itr->second(itr->first);
+  }
+  destructors_.clear();
+
+  // Keep the first regular block for the next optimization
+  blocks_.clear();
+  first_block_used_ = false;
+  current_ = nullptr;
+  remaining_ = 0;
+  allocated_bytes_ = 0;
+}
+
+}  // namespace optimizer
+}  // namespace peloton
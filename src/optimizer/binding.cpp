@@ -41,10 +41,10 @@ GroupBindingIterator::GroupBindingIterator(Optimizer &optimizer, GroupID id,
   // current pattern. However, because our rules don't currently expose the
   // structure of the output they produce after a transformation, we must be
   // conservative and apply all rules
-  const std::vector<std::shared_ptr<GroupExpression>> gexprs =
-      target_group_->GetExpressions();
+  // Exploring may add expressions to the group, so only the ones present
+  // now are visited
   for (size_t i = 0; i < num_group_items_; ++i) {
-    optimizer.ExploreExpression(gexprs[i]);
+    optimizer.ExploreExpression(target_group_->GetExpressions()[i]);
   }
 }
 
@@ -93,7 +93,7 @@ std::shared_ptr<OperatorExpression> GroupBindingIterator::Next() {
 // Item Binding Iterator
 //===--------------------------------------------------------------------===//
 ItemBindingIterator::ItemBindingIterator(Optimizer &optimizer,
-                                         std::shared_ptr<GroupExpression> gexpr,
+                                         GroupExpression *gexpr,
                                          std::shared_ptr<Pattern> pattern)
     : BindingIterator(optimizer),
       gexpr_(gexpr),
@@ -29,8 +29,9 @@ namespace peloton {
 namespace optimizer {
 
 vector<pair<PropertySet, vector<PropertySet>>>
-ChildPropertyGenerator::GetProperties(shared_ptr<GroupExpression> gexpr,
-                                      PropertySet requirements, Memo *memo) {
+ChildPropertyGenerator::GetProperties(GroupExpression *gexpr,
+                                      const PropertySet &requirements,
+                                      Memo *memo) {
   requirements_ = requirements;
 
   for (auto child_group_id : gexpr->GetChildGroupIDs())
@@ -145,8 +145,7 @@ double getCostOfChildren(std::vector<double> &child_costs) {
 }
 
 void CostAndStatsCalculator::CalculateCostAndStats(
-    std::shared_ptr<GroupExpression> gexpr,
-    const PropertySet *output_properties,
+    GroupExpression *gexpr, const PropertySet *output_properties,
     const std::vector<PropertySet> *input_properties_list,
     std::vector<std::shared_ptr<Stats>> child_stats,
     std::vector<double> child_costs) {
@@ -0,0 +1,212 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// fast_path_planner.cpp
+//
+// Identification: src/optimizer/fast_path_planner.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/fast_path_planner.h"
+
+#include <algorithm>
+
+#include "catalog/catalog.h"
+#include "index/index.h"
+#include "optimizer/column_manager.h"
+#include "optimizer/operator_expression.h"
+#include "optimizer/operator_to_plan_transformer.h"
+#include "optimizer/operators.h"
+#include "optimizer/query_property_extractor.h"
+#include "optimizer/util.h"
+#include "parser/statements.h"
+#include "planner/abstract_plan.h"
+#include "storage/data_table.h"
+
+namespace peloton {
+namespace optimizer {
+
+// Convert a physical operator to a plan the way the optimizer does once it
+// has chosen the operator
+static std::unique_ptr<planner::AbstractPlan> ConvertOperator(
+    Operator op, PropertySet &requirements,
+    std::unique_ptr<planner::AbstractPlan> child_plan) {
+  std::vector<PropertySet> required_input_props;
+  std::vector<std::unique_ptr<planner::AbstractPlan>> children_plans;
+  std::vector<ExprMap> children_expr_map;
+  if (child_plan != nullptr) {
+    children_plans.push_back(std::move(child_plan));
+    children_expr_map.emplace_back();
+  }
+
+  ExprMap output_expr_map;
+  OperatorToPlanTransformer transformer;
+  return transformer.ConvertOpExpression(
+      std::make_shared<OperatorExpression>(op), &requirements,
+      &required_input_props, children_plans, children_expr_map,
+      &output_expr_map);
+}
+
+std::unique_ptr<planner::AbstractPlan> FastPathPlanner::BuildPlan(
+    parser::SQLStatement *tree) {
+  switch (tree->GetType()) {
+    case StatementType::SELECT:
+      return BuildSelectPlan(static_cast<parser::SelectStatement *>(tree));
+    case StatementType::UPDATE:
+      return BuildUpdatePlan(static_cast<parser::UpdateStatement *>(tree));
+    case StatementType::DELETE:
+      return BuildDeletePlan(static_cast<parser::DeleteStatement *>(tree));
+    default:
+      return nullptr;
+  }
+}
+
+bool FastPathPlanner::IsSimplePredicate(
+    const expression::AbstractExpression *predicate) {
+  switch (predicate->GetExpressionType()) {
+    case ExpressionType::CONJUNCTION_AND:
+      return IsSimplePredicate(predicate->GetChild(0)) &&
+             IsSimplePredicate(predicate->GetChild(1));
+
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO: {
+      // The index scan expects the column on the left
+      auto right_type = predicate->GetChild(1)->GetExpressionType();
+      return predicate->GetChild(0)->GetExpressionType() ==
+                 ExpressionType::VALUE_TUPLE &&
+             (right_type == ExpressionType::VALUE_CONSTANT ||
+              right_type == ExpressionType::VALUE_PARAMETER);
+    }
+
+    case ExpressionType::COMPARE_LIKE: {
+      // Only a pattern with a prefix turns into an index range
+      std::vector<ExpressionType> expr_types;
+      std::vector<type::Value> values;
+      return predicate->GetChild(0)->GetExpressionType() ==
+                 ExpressionType::VALUE_TUPLE &&
+             predicate->GetChild(0)->GetValueType() ==
+                 type::TypeId::VARCHAR &&
+             util::GetLikePrefixRange(predicate, expr_types, values);
+    }
+
+    default:
+      return false;
+  }
+}
+
+std::unique_ptr<planner::AbstractPlan> FastPathPlanner::BuildSelectPlan(
+    parser::SelectStatement *select_stmt) {
+  // No aggregation, sorting, limit or set operation
+  if (select_stmt->group_by != nullptr || select_stmt->order != nullptr ||
+      select_stmt->limit != nullptr || select_stmt->union_select != nullptr ||
+      select_stmt->select_distinct == true) {
+    return nullptr;
+  }
+
+  // A single base table
+  auto table_ref = select_stmt->from_table.get();
+  if (table_ref != nullptr && table_ref->list.size() == 1) {
+    table_ref = table_ref->list.at(0).get();
+  }
+  if (table_ref == nullptr || table_ref->select != nullptr ||
+      table_ref->join != nullptr || table_ref->list.empty() == false) {
+    return nullptr;
+  }
+
+  // Only columns the scan can output without a projection
+  auto &select_list = select_stmt->select_list;
+  for (auto &expr : select_list) {
+    auto expr_type = expr->GetExpressionType();
+    if (expr_type != ExpressionType::VALUE_TUPLE &&
+        (expr_type != ExpressionType::STAR || select_list.size() > 1)) {
+      return nullptr;
+    }
+  }
+
+  auto table = catalog::Catalog::GetInstance()->GetTableWithName(
+      table_ref->GetDatabaseName(), table_ref->GetTableName(), txn_);
+  return BuildIndexScanPlan(table, table_ref->GetTableAlias(),
+                            select_stmt->where_clause.get(),
+                            select_stmt->is_for_update, select_stmt);
+}
+
+std::unique_ptr<planner::AbstractPlan> FastPathPlanner::BuildUpdatePlan(
+    parser::UpdateStatement *update_stmt) {
+  auto table = catalog::Catalog::GetInstance()->GetTableWithName(
+      update_stmt->table->GetDatabaseName(),
+      update_stmt->table->GetTableName(), txn_);
+  auto scan_plan = BuildIndexScanPlan(table, update_stmt->table->GetTableName(),
+                                      update_stmt->where.get(), true,
+                                      update_stmt);
+  if (scan_plan == nullptr) {
+    return nullptr;
+  }
+
+  PropertySet requirements;
+  return ConvertOperator(PhysicalUpdate::make(table, &update_stmt->updates),
+                         requirements, std::move(scan_plan));
+}
+
+std::unique_ptr<planner::AbstractPlan> FastPathPlanner::BuildDeletePlan(
+    parser::DeleteStatement *delete_stmt) {
+  auto table = catalog::Catalog::GetInstance()->GetTableWithName(
+      delete_stmt->GetDatabaseName(), delete_stmt->GetTableName(), txn_);
+  auto scan_plan =
+      BuildIndexScanPlan(table, delete_stmt->GetTableName(),
+                         delete_stmt->expr.get(), false, delete_stmt);
+  if (scan_plan == nullptr) {
+    return nullptr;
+  }
+
+  PropertySet requirements;
+  return ConvertOperator(PhysicalDelete::make(table), requirements,
+                         std::move(scan_plan));
+}
+
+std::unique_ptr<planner::AbstractPlan> FastPathPlanner::BuildIndexScanPlan(
+    storage::DataTable *table, const std::string &table_alias,
+    expression::AbstractExpression *predicate, bool is_for_update,
+    parser::SQLStatement *tree) {
+  if (table == nullptr || predicate == nullptr ||
+      IsSimplePredicate(predicate) == false) {
+    return nullptr;
+  }
+
+  // The index the scan will use must have its first key column constrained,
+  // otherwise the scan would go over the whole index
+  std::vector<oid_t> key_column_ids;
+  std::vector<ExpressionType> expr_types;
+  std::vector<type::Value> values;
+  oid_t index_id;
+  if (util::CheckIndexSearchable(table, predicate, key_column_ids, expr_types,
+                                 values, index_id) == false) {
+    return nullptr;
+  }
+  auto &key_attrs = table->GetIndex(index_id)->GetMetadata()->GetKeyAttrs();
+  if (key_attrs.empty() == true ||
+      std::find(key_column_ids.begin(), key_column_ids.end(), key_attrs[0]) ==
+          key_column_ids.end()) {
+    return nullptr;
+  }
+
+  LOG_TRACE("Fast path plan for table %s on index %u",
+            table->GetName().c_str(), index_id);
+
+  // Output columns and predicate of the scan
+  ColumnManager column_manager;
+  QueryPropertyExtractor property_extractor(column_manager);
+  PropertySet requirements = property_extractor.GetProperties(tree);
+
+  return ConvertOperator(
+      PhysicalIndexScan::make(table, table_alias, is_for_update), requirements,
+      nullptr);
+}
+
+}  // namespace optimizer
+}  // namespace peloton
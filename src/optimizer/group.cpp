@@ -24,23 +24,25 @@ Group::Group(GroupID id, std::unordered_set<std::string> table_aliases)
     : id_(id), table_aliases_(std::move(table_aliases)) {
   has_explored_ = false;
   has_implemented_ = false;
+  has_physical_expressions_ = false;
 }
 void Group::add_item(Operator op) {
   // TODO(abpoms): do duplicate checking
   items_.push_back(op);
 }
-void Group::AddExpression(std::shared_ptr<GroupExpression> expr,
-                          bool enforced) {
+void Group::AddExpression(GroupExpression *expr, bool enforced) {
   // Do duplicate detection
   expr->SetGroupID(id_);
-  if (enforced)
+  if (enforced) {
     enforced_exprs_.push_back(expr);
-  else
+  } else {
     expressions_.push_back(expr);
+    if (expr->Op().IsPhysical()) has_physical_expressions_ = true;
+  }
 }
 
-void Group::SetExpressionCost(std::shared_ptr<GroupExpression> expr,
-                              double cost, PropertySet properties) {
+void Group::SetExpressionCost(GroupExpression *expr, double cost,
+                              const PropertySet &properties) {
   LOG_TRACE("Adding expression cost on group %d with op %s", expr->GetGroupID(),
             expr->Op().name().c_str());
   auto it = lowest_cost_expressions_.find(properties);
@@ -56,8 +58,7 @@ void Group::SetExpressionCost(std::shared_ptr<GroupExpression> expr,
   }
 }
 
-std::shared_ptr<GroupExpression> Group::GetBestExpression(
-    PropertySet properties) {
+GroupExpression *Group::GetBestExpression(const PropertySet &properties) {
   auto it = lowest_cost_expressions_.find(properties);
   if (it != lowest_cost_expressions_.end()) {
     return std::get<1>(it->second);
@@ -66,8 +67,7 @@ std::shared_ptr<GroupExpression> Group::GetBestExpression(
   return nullptr;
 }
 
-const std::vector<std::shared_ptr<GroupExpression>> &Group::GetExpressions()
-    const {
+const std::vector<GroupExpression *> &Group::GetExpressions() const {
   return expressions_;
 }
 
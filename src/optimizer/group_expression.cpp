@@ -33,16 +33,16 @@ const std::vector<GroupID> &GroupExpression::GetChildGroupIDs() const {
 Operator GroupExpression::Op() const { return op; }
 
 std::shared_ptr<Stats> GroupExpression::GetStats(
-    PropertySet requirements) const {
+    const PropertySet &requirements) const {
   return std::get<1>(lowest_cost_table_.find(requirements)->second);
 }
 
-double GroupExpression::GetCost(PropertySet requirements) const {
+double GroupExpression::GetCost(const PropertySet &requirements) const {
   return std::get<0>(lowest_cost_table_.find(requirements)->second);
 }
 
-std::vector<PropertySet> GroupExpression::GetInputProperties(
-    PropertySet requirements) const {
+const std::vector<PropertySet> &GroupExpression::GetInputProperties(
+    const PropertySet &requirements) const {
   return std::get<2>(lowest_cost_table_.find(requirements)->second);
 }
 
@@ -0,0 +1,230 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// materialized_view_matcher.cpp
+//
+// Identification: src/optimizer/materialized_view_matcher.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/materialized_view_matcher.h"
+
+#include <algorithm>
+
+#include "catalog/catalog.h"
+#include "catalog/schema.h"
+#include "common/logger.h"
+#include "expression/constant_value_expression.h"
+#include "expression/parameter_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "parser/statements.h"
+#include "planner/materialized_view_scan_plan.h"
+#include "storage/data_table.h"
+#include "storage/materialized_view.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace optimizer {
+
+// The column of the table a column reference refers to, or INVALID_OID
+static oid_t GetColumnId(const expression::AbstractExpression *expr,
+                         const catalog::Schema *schema) {
+  if (expr->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+    return INVALID_OID;
+  }
+  return schema->GetColumnID(
+      static_cast<const expression::TupleValueExpression *>(expr)
+          ->GetColumnName());
+}
+
+// The offset of a column in the group key of a view, or INVALID_OID
+static oid_t GetGroupOffset(const storage::MaterializedView *view,
+                            oid_t column_id) {
+  auto &group_column_ids = view->GetGroupColumnIds();
+  auto column_itr = std::find(group_column_ids.begin(), group_column_ids.end(),
+                              column_id);
+  if (column_id == INVALID_OID || column_itr == group_column_ids.end()) {
+    return INVALID_OID;
+  }
+  return column_itr - group_column_ids.begin();
+}
+
+std::unique_ptr<planner::AbstractPlan> MaterializedViewMatcher::BuildPlan(
+    parser::SQLStatement *tree) {
+  if (tree->GetType() != StatementType::SELECT) return nullptr;
+  auto select_stmt = static_cast<parser::SelectStatement *>(tree);
+
+  // A plain aggregation
+  if (select_stmt->group_by == nullptr ||
+      select_stmt->group_by->having != nullptr ||
+      select_stmt->order != nullptr || select_stmt->limit != nullptr ||
+      select_stmt->union_select != nullptr ||
+      select_stmt->select_distinct == true ||
+      select_stmt->is_for_update == true) {
+    return nullptr;
+  }
+
+  // over a single base table
+  auto table_ref = select_stmt->from_table.get();
+  if (table_ref != nullptr && table_ref->list.size() == 1) {
+    table_ref = table_ref->list.at(0).get();
+  }
+  if (table_ref == nullptr || table_ref->select != nullptr ||
+      table_ref->join != nullptr || table_ref->list.empty() == false) {
+    return nullptr;
+  }
+
+  auto table = catalog::Catalog::GetInstance()->GetTableWithName(
+      table_ref->GetDatabaseName(), table_ref->GetTableName(), txn_);
+  if (table == nullptr || table->HasMaterializedViews() == false ||
+      storage::MaterializedView::CanRead(txn_) == false) {
+    return nullptr;
+  }
+
+  // The group columns, in any order
+  auto schema = table->GetSchema();
+  std::vector<oid_t> group_column_ids;
+  for (auto &column : select_stmt->group_by->columns) {
+    oid_t column_id = GetColumnId(column.get(), schema);
+    if (column_id == INVALID_OID) return nullptr;
+    group_column_ids.push_back(column_id);
+  }
+  std::sort(group_column_ids.begin(), group_column_ids.end());
+
+  for (auto &view : table->GetMaterializedViews()) {
+    auto view_column_ids = view->GetGroupColumnIds();
+    std::sort(view_column_ids.begin(), view_column_ids.end());
+    if (view_column_ids != group_column_ids || view->IsUsable() == false) {
+      continue;
+    }
+
+    auto plan = BuildViewScanPlan(select_stmt, view, schema);
+    if (plan != nullptr) {
+      LOG_TRACE("Reading materialized view %s for table %s",
+                view->GetName().c_str(), table->GetName().c_str());
+      return plan;
+    }
+  }
+  return nullptr;
+}
+
+std::unique_ptr<planner::AbstractPlan>
+MaterializedViewMatcher::BuildViewScanPlan(
+    parser::SelectStatement *select_stmt,
+    std::shared_ptr<storage::MaterializedView> view,
+    const catalog::Schema *schema) {
+  std::vector<oid_t> key_offsets;
+  std::vector<type::Value> key_values;
+  if (select_stmt->where_clause != nullptr &&
+      GetKeys(select_stmt->where_clause.get(), schema, view.get(), key_offsets,
+              key_values) == false) {
+    return nullptr;
+  }
+
+  std::vector<storage::MaterializedViewColumn> columns;
+  std::vector<catalog::Column> output_columns;
+  for (auto &expr : select_stmt->select_list) {
+    auto expr_type = expr->GetExpressionType();
+    if (expr_type == ExpressionType::VALUE_TUPLE) {
+      oid_t offset =
+          GetGroupOffset(view.get(), GetColumnId(expr.get(), schema));
+      if (offset == INVALID_OID) return nullptr;
+      columns.emplace_back(ExpressionType::INVALID, offset);
+    } else if (expr_type == ExpressionType::AGGREGATE_COUNT_STAR) {
+      columns.emplace_back(expr_type, 0);
+    } else {
+      switch (expr_type) {
+        case ExpressionType::AGGREGATE_COUNT:
+        case ExpressionType::AGGREGATE_SUM:
+        case ExpressionType::AGGREGATE_MIN:
+        case ExpressionType::AGGREGATE_MAX:
+        case ExpressionType::AGGREGATE_AVG:
+          break;
+        default:
+          return nullptr;
+      }
+      if (expr->distinct_ == true || expr->GetChildrenSize() != 1) {
+        return nullptr;
+      }
+      oid_t column_id = GetColumnId(expr->GetChild(0), schema);
+      if (column_id == INVALID_OID) return nullptr;
+      oid_t offset = view->GetAggregateOffset(expr_type, column_id);
+      if (offset == INVALID_OID) return nullptr;
+      columns.emplace_back(expr_type, offset);
+    }
+
+    // Same output columns as the aggregation would have
+    expr->DeduceExpressionType();
+    expr->DeduceExpressionName();
+    output_columns.emplace_back(expr->GetValueType(),
+                                type::Type::GetTypeSize(expr->GetValueType()),
+                                expr->GetExpressionName());
+  }
+
+  std::shared_ptr<const catalog::Schema> output_schema(
+      new catalog::Schema(output_columns));
+  return std::unique_ptr<planner::AbstractPlan>(
+      new planner::MaterializedViewScanPlan(view, columns, output_schema,
+                                            key_offsets, key_values));
+}
+
+bool MaterializedViewMatcher::GetKeys(
+    const expression::AbstractExpression *predicate,
+    const catalog::Schema *schema, const storage::MaterializedView *view,
+    std::vector<oid_t> &key_offsets, std::vector<type::Value> &key_values) {
+  switch (predicate->GetExpressionType()) {
+    case ExpressionType::CONJUNCTION_AND:
+      return GetKeys(predicate->GetChild(0), schema, view, key_offsets,
+                     key_values) &&
+             GetKeys(predicate->GetChild(1), schema, view, key_offsets,
+                     key_values);
+
+    case ExpressionType::COMPARE_EQUAL: {
+      auto column = predicate->GetChild(0);
+      auto value = predicate->GetChild(1);
+      if (column->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+        std::swap(column, value);
+      }
+      oid_t offset = GetGroupOffset(view, GetColumnId(column, schema));
+      if (offset == INVALID_OID) return false;
+
+      // Keep the offsets in increasing order, so a full key is a lookup
+      auto offset_itr =
+          std::lower_bound(key_offsets.begin(), key_offsets.end(), offset);
+      if (offset_itr != key_offsets.end() && *offset_itr == offset) {
+        return false;
+      }
+      auto value_itr = key_values.begin() + (offset_itr - key_offsets.begin());
+
+      switch (value->GetExpressionType()) {
+        case ExpressionType::VALUE_CONSTANT:
+          key_values.insert(
+              value_itr,
+              static_cast<const expression::ConstantValueExpression *>(value)
+                  ->GetValue()
+                  .Copy());
+          break;
+        case ExpressionType::VALUE_PARAMETER:
+          key_values.insert(
+              value_itr,
+              type::ValueFactory::GetParameterOffsetValue(
+                  static_cast<const expression::ParameterValueExpression *>(
+                      value)->GetValueIdx()).Copy());
+          break;
+        default:
+          return false;
+      }
+      key_offsets.insert(offset_itr, offset);
+      return true;
+    }
+
+    default:
+      return false;
+  }
+}
+
+}  // namespace optimizer
+}  // namespace peloton
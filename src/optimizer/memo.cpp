@@ -21,14 +21,22 @@ namespace optimizer {
 //===--------------------------------------------------------------------===//
 Memo::Memo() {}
 
-std::shared_ptr<GroupExpression> Memo::InsertExpression(
-    std::shared_ptr<GroupExpression> gexpr, bool enforced) {
+GroupExpression *Memo::InsertExpression(GroupExpression *gexpr,
+                                        bool enforced) {
   return InsertExpression(gexpr, UNDEFINED_GROUP, enforced);
 }
 
-std::shared_ptr<GroupExpression> Memo::InsertExpression(
-    std::shared_ptr<GroupExpression> gexpr, GroupID target_group,
-    bool enforced) {
+GroupExpression *Memo::InsertExpression(GroupExpression *gexpr,
+                                        GroupID target_group, bool enforced) {
+  bool inserted;
+  return InsertExpression(gexpr, target_group, enforced, inserted);
+}
+
+GroupExpression *Memo::InsertExpression(GroupExpression *gexpr,
+                                        GroupID target_group, bool enforced,
+                                        bool &inserted) {
+  inserted = false;
+
   // If leaf, then just return
   if (gexpr->Op().type() == OpType::Leaf) {
     const LeafOperator *leaf = gexpr->Op().As<LeafOperator>();
@@ -47,7 +55,6 @@ std::shared_ptr<GroupExpression> Memo::InsertExpression(
     gexpr->SetGroupID((*it)->GetGroupID());
     return *it;
   } else {
-    group_expressions_.insert(gexpr);
     // New expression, so try to insert into an existing group or
     // create a new group if none specified
     GroupID group_id;
@@ -56,17 +63,28 @@ std::shared_ptr<GroupExpression> Memo::InsertExpression(
     } else {
       group_id = target_group;
     }
+    gexpr->SetGroupID(group_id);
+
+    auto memo_gexpr = arena_.New<GroupExpression>(std::move(*gexpr));
+    group_expressions_.insert(memo_gexpr);
     Group *group = GetGroupByID(group_id);
-    group->AddExpression(gexpr, enforced);
-    return gexpr;
+    group->AddExpression(memo_gexpr, enforced);
+    inserted = true;
+    return memo_gexpr;
   }
 }
 
-const std::vector<Group> &Memo::Groups() const { return groups_; }
+const std::vector<Group *> &Memo::Groups() const { return groups_; }
+
+Group *Memo::GetGroupByID(GroupID id) { return groups_[id]; }
 
-Group *Memo::GetGroupByID(GroupID id) { return &(groups_[id]); }
+void Memo::Reset() {
+  group_expressions_.clear();
+  groups_.clear();
+  arena_.Reset();
+}
 
-GroupID Memo::AddNewGroup(std::shared_ptr<GroupExpression> gexpr) {
+GroupID Memo::AddNewGroup(GroupExpression *gexpr) {
   GroupID new_group_id = groups_.size();
   // Find out the table alias that this group represents
   std::unordered_set<std::string> table_aliases;
@@ -83,7 +101,8 @@ GroupID Memo::AddNewGroup(std::shared_ptr<GroupExpression> gexpr) {
       }
     }
   }
-  groups_.emplace_back(new_group_id, std::move(table_aliases));
+  groups_.push_back(
+      arena_.New<Group>(new_group_id, std::move(table_aliases)));
   return new_group_id;
 }
 
@@ -199,6 +199,16 @@ void OperatorToPlanTransformer::Visit(const PhysicalLimit *) {
   // Limit Operator does not change the column mapping
   *output_expr_map_ = children_expr_map_[0];
 
+  // Let a sort below know that only the first offset + limit tuples are
+  // needed, so that it can keep just those instead of sorting its whole input
+  if (children_plans_[0]->GetPlanNodeType() == PlanNodeType::ORDERBY) {
+    auto order_by_plan =
+        static_cast<planner::OrderByPlan *>(children_plans_[0].get());
+    order_by_plan->SetLimit(true);
+    order_by_plan->SetLimitNumber(limit_prop->GetLimit());
+    order_by_plan->SetLimitOffset(limit_prop->GetOffset());
+  }
+
   unique_ptr<planner::AbstractPlan> limit_plan(
       new planner::LimitPlan(limit_prop->GetLimit(), limit_prop->GetOffset()));
   limit_plan->AddChild(move(children_plans_[0]));
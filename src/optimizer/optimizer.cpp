@@ -17,10 +17,13 @@
 #include "catalog/column_catalog.h"
 #include "catalog/table_catalog.h"
 #include "catalog/manager.h"
+#include "common/timer.h"
 
 #include "optimizer/binding.h"
 #include "optimizer/child_property_generator.h"
 #include "optimizer/cost_and_stats_calculator.h"
+#include "optimizer/fast_path_planner.h"
+#include "optimizer/materialized_view_matcher.h"
 #include "optimizer/operator_to_plan_transformer.h"
 #include "optimizer/operator_visitor.h"
 #include "optimizer/properties.h"
@@ -28,6 +31,7 @@
 #include "optimizer/query_property_extractor.h"
 #include "optimizer/query_to_operator_transformer.h"
 #include "optimizer/rule_impls.h"
+#include "optimizer/semi_join_planner.h"
 #include "parser/create_statement.h"
 
 #include "planner/analyze_plan.h"
@@ -38,6 +42,8 @@
 #include "planner/projection_plan.h"
 #include "planner/seq_scan_plan.h"
 
+#include "settings/settings_manager.h"
+#include "statistics/backend_stats_context.h"
 #include "storage/data_table.h"
 
 #include "binder/bind_node_visitor.h"
@@ -53,6 +59,17 @@ using std::make_shared;
 namespace peloton {
 namespace optimizer {
 
+// Record how long planning a statement took, if stats are collected
+static void RecordPlanningLatency(Timer<std::micro> &timer, bool fast_path) {
+  if (settings::SettingsManager::GetInt(settings::SettingId::stats_mode) ==
+      STATS_TYPE_INVALID) {
+    return;
+  }
+  timer.Stop();
+  stats::BackendStatsContext::GetInstance()->RecordPlanningLatency(
+      fast_path, static_cast<uint64_t>(timer.GetDuration()));
+}
+
 //===--------------------------------------------------------------------===//
 // Optimizer
 //===--------------------------------------------------------------------===//
@@ -88,6 +105,9 @@ shared_ptr<planner::AbstractPlan> Optimizer::BuildPelotonPlanTree(
 
   unique_ptr<planner::AbstractPlan> child_plan = nullptr;
 
+  Timer<std::micro> planning_timer;
+  planning_timer.Start();
+
   auto parse_tree = parse_tree_list->GetStatements().at(0).get();
 
   // Run binder
@@ -101,8 +121,47 @@ shared_ptr<planner::AbstractPlan> Optimizer::BuildPelotonPlanTree(
     return move(ddl_plan);
   }
 
+  // Point and range queries on a single table do not need a search
+  if (settings::SettingsManager::GetBool(
+          settings::SettingId::fast_path_planner)) {
+    auto fast_path_plan = FastPathPlanner(txn).BuildPlan(parse_tree);
+    if (fast_path_plan != nullptr) {
+      RecordPlanningLatency(planning_timer, true);
+      return move(fast_path_plan);
+    }
+  }
+
+  // So are aggregations a materialized view keeps
+  if (settings::SettingsManager::GetBool(
+          settings::SettingId::materialized_view_rewrite)) {
+    auto view_plan = MaterializedViewMatcher(txn).BuildPlan(parse_tree);
+    if (view_plan != nullptr) {
+      RecordPlanningLatency(planning_timer, true);
+      return move(view_plan);
+    }
+  }
+
+  // The search does not handle subqueries, they are planned as semi joins
+  auto semi_join_plan = SemiJoinPlanner(txn).BuildPlan(parse_tree);
+  if (semi_join_plan != nullptr) {
+    RecordPlanningLatency(planning_timer, true);
+    return move(semi_join_plan);
+  }
+  if (SemiJoinPlanner::HasSubquery(parse_tree)) {
+    throw NotImplementedException(
+        "Only [NOT] IN and [NOT] EXISTS subqueries in the WHERE clause of a "
+        "single-table SELECT are supported");
+  }
+
+  time_budget_ms_ = settings::SettingsManager::GetInt(
+      settings::SettingId::optimizer_search_budget);
+  rule_budget_ = settings::SettingsManager::GetInt(
+      settings::SettingId::optimizer_rule_budget);
+  search_start_ = std::chrono::steady_clock::now();
+  rule_application_count_ = 0;
+
   // Generate initial operator tree from query tree
-  shared_ptr<GroupExpression> gexpr = InsertQueryTree(parse_tree, txn);
+  GroupExpression *gexpr = InsertQueryTree(parse_tree, txn);
   GroupID root_id = gexpr->GetGroupID();
   // Get the physical properties the final plan must output
   PropertySet properties = GetQueryRequiredProperties(parse_tree);
@@ -120,8 +179,11 @@ shared_ptr<planner::AbstractPlan> Optimizer::BuildPelotonPlanTree(
     ExprMap output_expr_map;
     auto best_plan = ChooseBestPlan(root_id, properties, &output_expr_map);
     if (best_plan == nullptr) return nullptr;
+    LOG_TRACE("Optimization applied %lu rules, memo used %lu bytes",
+              rule_application_count_, memo_.GetAllocatedBytes());
     // Reset memo after finishing the optimization
     Reset();
+    RecordPlanningLatency(planning_timer, false);
     //  return shared_ptr<planner::AbstractPlan>(best_plan.release());
     return move(best_plan);
   } catch (Exception &e) {
@@ -131,7 +193,7 @@ shared_ptr<planner::AbstractPlan> Optimizer::BuildPelotonPlanTree(
 }
 
 void Optimizer::Reset() {
-  memo_ = Memo();
+  memo_.Reset();
   column_manager_ = move(ColumnManager());
 }
 
@@ -215,12 +277,12 @@ unique_ptr<planner::AbstractPlan> Optimizer::HandleDDLStatement(
   return ddl_plan;
 }
 
-shared_ptr<GroupExpression> Optimizer::InsertQueryTree(
-    parser::SQLStatement *tree, concurrency::Transaction *txn) {
+GroupExpression *Optimizer::InsertQueryTree(parser::SQLStatement *tree,
+                                            concurrency::Transaction *txn) {
   QueryToOperatorTransformer converter(txn);
   shared_ptr<OperatorExpression> initial =
       converter.ConvertToOpExpression(tree);
-  shared_ptr<GroupExpression> gexpr;
+  GroupExpression *gexpr;
   RecordTransformedExpression(initial, gexpr);
   return gexpr;
 }
@@ -244,7 +306,7 @@ unique_ptr<planner::AbstractPlan> Optimizer::OptimizerPlanToPlannerPlan(
 unique_ptr<planner::AbstractPlan> Optimizer::ChooseBestPlan(
     GroupID id, PropertySet requirements, ExprMap *output_expr_map) {
   Group *group = memo_.GetGroupByID(id);
-  shared_ptr<GroupExpression> gexpr = group->GetBestExpression(requirements);
+  GroupExpression *gexpr = group->GetBestExpression(requirements);
 
   LOG_TRACE("Choosing best plan for group %d with op %s", gexpr->GetGroupID(),
             gexpr->Op().name().c_str());
@@ -280,7 +342,7 @@ unique_ptr<planner::AbstractPlan> Optimizer::ChooseBestPlan(
   return plan;
 }
 
-void Optimizer::OptimizeGroup(GroupID id, PropertySet requirements) {
+void Optimizer::OptimizeGroup(GroupID id, const PropertySet &requirements) {
   LOG_TRACE("Optimizing group %d with req %s", id,
             requirements.ToString().c_str());
   Group *group = memo_.GetGroupByID(id);
@@ -288,14 +350,19 @@ void Optimizer::OptimizeGroup(GroupID id, PropertySet requirements) {
   // Whether required properties have already been optimized for the group
   if (group->GetBestExpression(requirements) != nullptr) return;
 
-  const vector<shared_ptr<GroupExpression>> exprs = group->GetExpressions();
-  for (size_t i = 0; i < exprs.size(); ++i) {
+  const vector<GroupExpression *> &exprs = group->GetExpressions();
+  size_t num_exprs = exprs.size();
+  for (size_t i = 0; i < num_exprs; ++i) {
     if (exprs[i]->Op().IsPhysical()) OptimizeExpression(exprs[i], requirements);
+
+    // Over budget, the first plan that fulfills the requirements will do
+    if (BudgetExceeded() && group->GetBestExpression(requirements) != nullptr)
+      break;
   }
 }
 
-void Optimizer::OptimizeExpression(shared_ptr<GroupExpression> gexpr,
-                                   PropertySet requirements) {
+void Optimizer::OptimizeExpression(GroupExpression *gexpr,
+                                   const PropertySet &requirements) {
   LOG_TRACE("Optimizing expression of group %d with op %s", gexpr->GetGroupID(),
             gexpr->Op().name().c_str());
 
@@ -307,7 +374,7 @@ void Optimizer::OptimizeExpression(shared_ptr<GroupExpression> gexpr,
 
   size_t num_property_pairs = output_input_property_pairs.size();
 
-  auto child_group_ids = gexpr->GetChildGroupIDs();
+  const auto &child_group_ids = gexpr->GetChildGroupIDs();
 
   for (size_t pair_offset = 0; pair_offset < num_property_pairs;
        ++pair_offset) {
@@ -324,7 +391,7 @@ void Optimizer::OptimizeExpression(shared_ptr<GroupExpression> gexpr,
       OptimizeGroup(child_group_id, input_properties);
 
       // Find best child expression
-      shared_ptr<GroupExpression> best_expression =
+      GroupExpression *best_expression =
           memo_.GetGroupByID(child_group_id)
               ->GetBestExpression(input_properties);
       // TODO(abpoms): we should allow for failure in the case where no
@@ -379,7 +446,8 @@ void Optimizer::OptimizeExpression(shared_ptr<GroupExpression> gexpr,
   LOG_TRACE("Optimizing expression finishes");
 }
 
-Property *Optimizer::GenerateNewPropertyCols(PropertySet requirements) {
+Property *Optimizer::GenerateNewPropertyCols(
+    const PropertySet &requirements) {
   auto cols_prop = requirements.GetPropertyOfType(PropertyType::COLUMNS)
                        ->As<PropertyColumns>();
   auto sort_prop =
@@ -416,9 +484,9 @@ Property *Optimizer::GenerateNewPropertyCols(PropertySet requirements) {
   }
 }
 
-shared_ptr<GroupExpression> Optimizer::EnforceProperty(
-    shared_ptr<GroupExpression> gexpr, PropertySet &output_properties,
-    const shared_ptr<Property> property, PropertySet &requirements) {
+GroupExpression *Optimizer::EnforceProperty(
+    GroupExpression *gexpr, PropertySet &output_properties,
+    const shared_ptr<Property> property, const PropertySet &requirements) {
   // new child input is the old output
   auto child_input_properties = vector<PropertySet>();
   child_input_properties.push_back(output_properties);
@@ -429,13 +497,13 @@ shared_ptr<GroupExpression> Optimizer::EnforceProperty(
   child_costs.push_back(gexpr->GetCost(output_properties));
 
   PropertyEnforcer enforcer(column_manager_);
-  auto enforced_gexpr =
+  auto enforcer_gexpr =
       enforcer.EnforceProperty(gexpr, &output_properties, property);
 
   // the new enforced gexpr have the same GrouID as the parent expr
   // The enforced expression may already exist
-  enforced_gexpr =
-      memo_.InsertExpression(enforced_gexpr, gexpr->GetGroupID(), true);
+  auto enforced_gexpr =
+      memo_.InsertExpression(&enforcer_gexpr, gexpr->GetGroupID(), true);
 
   // For orderby, Restore the PropertyColumn back to the original one so that
   // orderby does not output the additional columns only used in order by
@@ -465,13 +533,13 @@ shared_ptr<GroupExpression> Optimizer::EnforceProperty(
 }
 
 vector<pair<PropertySet, vector<PropertySet>>> Optimizer::DeriveChildProperties(
-    shared_ptr<GroupExpression> gexpr, PropertySet requirements) {
+    GroupExpression *gexpr, const PropertySet &requirements) {
   ChildPropertyGenerator converter(column_manager_);
   return converter.GetProperties(gexpr, requirements, &memo_);
 }
 
 void Optimizer::DeriveCostAndStats(
-    shared_ptr<GroupExpression> gexpr, const PropertySet &output_properties,
+    GroupExpression *gexpr, const PropertySet &output_properties,
     const vector<PropertySet> &input_properties_list,
     vector<shared_ptr<Stats>> child_stats, vector<double> child_costs) {
   CostAndStatsCalculator calculator(column_manager_);
@@ -487,14 +555,17 @@ void Optimizer::ExploreGroup(GroupID id) {
   LOG_TRACE("Exploring group %d", id);
   if (memo_.GetGroupByID(id)->HasExplored()) return;
 
-  for (shared_ptr<GroupExpression> gexpr :
-       memo_.GetGroupByID(id)->GetExpressions()) {
-    ExploreExpression(gexpr);
+  // Expressions added to the group by exploring are explored by the rule
+  // application that adds them
+  Group *group = memo_.GetGroupByID(id);
+  size_t num_exprs = group->GetExpressions().size();
+  for (size_t i = 0; i < num_exprs; ++i) {
+    ExploreExpression(group->GetExpressions()[i]);
   }
-  memo_.GetGroupByID(id)->SetExplorationFlag();
+  group->SetExplorationFlag();
 }
 
-void Optimizer::ExploreExpression(shared_ptr<GroupExpression> gexpr) {
+void Optimizer::ExploreExpression(GroupExpression *gexpr) {
   LOG_TRACE("Exploring expression of group %d with op %s", gexpr->GetGroupID(),
             gexpr->Op().name().c_str());
 
@@ -502,15 +573,18 @@ void Optimizer::ExploreExpression(shared_ptr<GroupExpression> gexpr) {
 
   // Explore logically equivalent plans by applying transformation rules
   for (const unique_ptr<Rule> &rule : logical_transformation_rules_) {
+    // Over budget, the plans found so far will do
+    if (BudgetExceeded()) break;
+
     // Apply all rules to operator which match. We apply all rules to one
     // operator before moving on to the next operator in the group because
     // then we avoid missing the application of a rule e.g. an application
     // of some rule creates a match for a previously applied rule, but it is
     // missed because the prev rule was already checked
-    vector<shared_ptr<GroupExpression>> candidates =
+    vector<GroupExpression *> candidates =
         TransformExpression(gexpr, *(rule.get()));
 
-    for (shared_ptr<GroupExpression> candidate : candidates) {
+    for (GroupExpression *candidate : candidates) {
       // Explore the expression
       ExploreExpression(candidate);
     }
@@ -526,19 +600,26 @@ void Optimizer::ImplementGroup(GroupID id) {
   LOG_TRACE("Implementing group %d", id);
   if (memo_.GetGroupByID(id)->HasImplemented()) return;
 
-  for (shared_ptr<GroupExpression> gexpr :
-       memo_.GetGroupByID(id)->GetExpressions()) {
+  // Implementing only adds physical expressions to the group
+  Group *group = memo_.GetGroupByID(id);
+  size_t num_exprs = group->GetExpressions().size();
+  for (size_t i = 0; i < num_exprs; ++i) {
+    GroupExpression *gexpr = group->GetExpressions()[i];
     if (gexpr->Op().IsLogical()) ImplementExpression(gexpr);
   }
-  memo_.GetGroupByID(id)->SetImplementationFlag();
+  group->SetImplementationFlag();
 }
 
-void Optimizer::ImplementExpression(shared_ptr<GroupExpression> gexpr) {
+void Optimizer::ImplementExpression(GroupExpression *gexpr) {
   LOG_TRACE("Implementing expression of group %d with op %s",
             gexpr->GetGroupID(), gexpr->Op().name().c_str());
 
   // Explore implement physical expressions
+  Group *group = memo_.GetGroupByID(gexpr->GetGroupID());
   for (const unique_ptr<Rule> &rule : physical_implementation_rules_) {
+    // Over budget, one implementation of the group will do
+    if (BudgetExceeded() && group->HasPhysicalExpressions()) break;
+
     TransformExpression(gexpr, *(rule.get()));
   }
 
@@ -551,11 +632,11 @@ void Optimizer::ImplementExpression(shared_ptr<GroupExpression> gexpr) {
 
 //////////////////////////////////////////////////////////////////////////////
 /// Rule application
-vector<shared_ptr<GroupExpression>> Optimizer::TransformExpression(
-    shared_ptr<GroupExpression> gexpr, const Rule &rule) {
+vector<GroupExpression *> Optimizer::TransformExpression(
+    GroupExpression *gexpr, const Rule &rule) {
   shared_ptr<Pattern> pattern = rule.GetMatchPattern();
 
-  vector<shared_ptr<GroupExpression>> output_plans;
+  vector<GroupExpression *> output_plans;
   ItemBindingIterator iterator(*this, gexpr, pattern);
   while (iterator.HasNext()) {
     shared_ptr<OperatorExpression> plan = iterator.Next();
@@ -569,12 +650,13 @@ vector<shared_ptr<GroupExpression>> Optimizer::TransformExpression(
       // the newly applied rule
       vector<shared_ptr<OperatorExpression>> transformed_plans;
       rule.Transform(plan, transformed_plans);
+      rule_application_count_++;
 
       // Integrate transformed plans back into groups and explore/cost if new
       for (shared_ptr<OperatorExpression> plan : transformed_plans) {
         LOG_TRACE("Trying to integrate expression with op %s",
                   plan->Op().name().c_str());
-        shared_ptr<GroupExpression> new_gexpr;
+        GroupExpression *new_gexpr;
         bool new_expression =
             RecordTransformedExpression(plan, new_gexpr, gexpr->GetGroupID());
         if (new_expression) {
@@ -588,29 +670,43 @@ vector<shared_ptr<GroupExpression>> Optimizer::TransformExpression(
   return output_plans;
 }
 
+bool Optimizer::BudgetExceeded() const {
+  if (rule_budget_ > 0 &&
+      rule_application_count_ >= static_cast<size_t>(rule_budget_)) {
+    return true;
+  }
+  if (time_budget_ms_ > 0) {
+    auto elapsed = std::chrono::steady_clock::now() - search_start_;
+    return elapsed >= std::chrono::milliseconds(time_budget_ms_);
+  }
+  return false;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 /// Memo insertion
-shared_ptr<GroupExpression> Optimizer::MakeGroupExpression(
+GroupExpression Optimizer::MakeGroupExpression(
     shared_ptr<OperatorExpression> expr) {
   vector<GroupID> child_groups;
   for (auto &child : expr->Children()) {
     auto gexpr = MakeGroupExpression(child);
-    memo_.InsertExpression(gexpr, false);
-    child_groups.push_back(gexpr->GetGroupID());
+    memo_.InsertExpression(&gexpr, false);
+    child_groups.push_back(gexpr.GetGroupID());
   }
-  return make_shared<GroupExpression>(expr->Op(), child_groups);
+  return GroupExpression(expr->Op(), move(child_groups));
 }
 
-bool Optimizer::RecordTransformedExpression(
-    shared_ptr<OperatorExpression> expr, shared_ptr<GroupExpression> &gexpr) {
+bool Optimizer::RecordTransformedExpression(shared_ptr<OperatorExpression> expr,
+                                            GroupExpression *&gexpr) {
   return RecordTransformedExpression(expr, gexpr, UNDEFINED_GROUP);
 }
 
 bool Optimizer::RecordTransformedExpression(shared_ptr<OperatorExpression> expr,
-                                            shared_ptr<GroupExpression> &gexpr,
+                                            GroupExpression *&gexpr,
                                             GroupID target_group) {
-  gexpr = MakeGroupExpression(expr);
-  return memo_.InsertExpression(gexpr, target_group, false) != gexpr;
+  auto candidate = MakeGroupExpression(expr);
+  bool inserted;
+  gexpr = memo_.InsertExpression(&candidate, target_group, false, inserted);
+  return inserted;
 }
 
 }  // namespace optimizer
@@ -19,38 +19,30 @@
 namespace peloton {
 namespace optimizer {
 
-std::shared_ptr<GroupExpression> PropertyEnforcer::EnforceProperty(
-    std::shared_ptr<GroupExpression> gexpr, PropertySet *properties,
+GroupExpression PropertyEnforcer::EnforceProperty(
+    GroupExpression *gexpr, PropertySet *properties,
     std::shared_ptr<Property> property) {
   input_gexpr_ = gexpr;
   input_properties_ = properties;
   property->Accept(this);
-  return output_gexpr_;
+  std::vector<GroupID> child_groups(1, input_gexpr_->GetGroupID());
+  return GroupExpression(output_op_, child_groups);
 }
 
 void PropertyEnforcer::Visit(const PropertyColumns *) {
-  std::vector<GroupID> child_groups(1, input_gexpr_->GetGroupID());
-
-  output_gexpr_ =
-      std::make_shared<GroupExpression>(PhysicalProject::make(), child_groups);
+  output_op_ = PhysicalProject::make();
 }
 
 void PropertyEnforcer::Visit(const PropertySort *) {
-  std::vector<GroupID> child_groups(1, input_gexpr_->GetGroupID());
-  output_gexpr_ =
-      std::make_shared<GroupExpression>(PhysicalOrderBy::make(), child_groups);
+  output_op_ = PhysicalOrderBy::make();
 }
 
 void PropertyEnforcer::Visit(const PropertyDistinct *) {
-  std::vector<GroupID> child_groups(1, input_gexpr_->GetGroupID());
-  output_gexpr_ =
-      std::make_shared<GroupExpression>(PhysicalDistinct::make(), child_groups);
+  output_op_ = PhysicalDistinct::make();
 }
   
 void PropertyEnforcer::Visit(const PropertyLimit *) {
-  std::vector<GroupID> child_groups(1, input_gexpr_->GetGroupID());
-  output_gexpr_ =
-    std::make_shared<GroupExpression>(PhysicalLimit::make(), child_groups);
+  output_op_ = PhysicalLimit::make();
 }
   
 void PropertyEnforcer::Visit(const PropertyPredicate *) {}
@@ -0,0 +1,354 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// semi_join_planner.cpp
+//
+// Identification: src/optimizer/semi_join_planner.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/semi_join_planner.h"
+
+#include <numeric>
+
+#include "catalog/catalog.h"
+#include "catalog/schema.h"
+#include "common/logger.h"
+#include "expression/expression_util.h"
+#include "expression/subquery_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "optimizer/util.h"
+#include "parser/statements.h"
+#include "planner/hash_join_plan.h"
+#include "planner/hash_plan.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/data_table.h"
+
+namespace peloton {
+namespace optimizer {
+
+static bool ContainsSubquery(const expression::AbstractExpression *expr) {
+  if (expr == nullptr) return false;
+  if (expr->GetExpressionType() == ExpressionType::ROW_SUBQUERY) return true;
+  for (size_t child_itr = 0; child_itr < expr->GetChildrenSize();
+       child_itr++) {
+    if (ContainsSubquery(expr->GetChild(child_itr))) return true;
+  }
+  return false;
+}
+
+// The column of a table a column reference refers to, or INVALID_OID. Two
+// references to the same table are told apart by their alias.
+static oid_t GetColumnId(const expression::AbstractExpression *expr,
+                         const storage::DataTable *table,
+                         const std::string &alias) {
+  if (expr->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+    return INVALID_OID;
+  }
+  auto tv_expr = static_cast<const expression::TupleValueExpression *>(expr);
+  if (tv_expr->GetIsBound() == false ||
+      std::get<1>(tv_expr->GetBoundOid()) != table->GetOid() ||
+      tv_expr->GetTableName() != alias) {
+    return INVALID_OID;
+  }
+  return std::get<2>(tv_expr->GetBoundOid());
+}
+
+// Whether every column reference of an expression refers to the table
+static bool RefersOnlyTo(const expression::AbstractExpression *expr,
+                         const storage::DataTable *table,
+                         const std::string &alias) {
+  if (expr->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+    return GetColumnId(expr, table, alias) != INVALID_OID;
+  }
+  for (size_t child_itr = 0; child_itr < expr->GetChildrenSize();
+       child_itr++) {
+    if (RefersOnlyTo(expr->GetChild(child_itr), table, alias) == false) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::unique_ptr<planner::AbstractPlan> SemiJoinPlanner::BuildPlan(
+    parser::SQLStatement *tree) {
+  if (tree->GetType() != StatementType::SELECT) return nullptr;
+  auto select_stmt = static_cast<parser::SelectStatement *>(tree);
+  if (select_stmt->where_clause == nullptr ||
+      select_stmt->select_distinct == true ||
+      select_stmt->is_for_update == true) {
+    return nullptr;
+  }
+
+  JoinSide outer;
+  outer.table = GetBaseTable(select_stmt, outer.table_ref);
+  if (outer.table == nullptr) return nullptr;
+  auto outer_alias = outer.table_ref->GetTableAlias();
+  auto outer_schema = outer.table->GetSchema();
+
+  // Plain columns of the outer table
+  std::vector<oid_t> output_column_ids;
+  auto &select_list = select_stmt->select_list;
+  for (auto &expr : select_list) {
+    if (expr->GetExpressionType() == ExpressionType::STAR &&
+        select_list.size() == 1) {
+      output_column_ids.resize(outer_schema->GetColumnCount());
+      std::iota(output_column_ids.begin(), output_column_ids.end(), 0);
+      break;
+    }
+    oid_t column_id = GetColumnId(expr.get(), outer.table, outer_alias);
+    if (column_id == INVALID_OID) return nullptr;
+    output_column_ids.push_back(column_id);
+  }
+
+  // Exactly one conjunct filters by a subquery
+  std::vector<expression::AbstractExpression *> conjuncts;
+  util::SplitPredicates(select_stmt->where_clause.get(), conjuncts);
+  expression::AbstractExpression *subquery_predicate = nullptr;
+  for (auto conjunct : conjuncts) {
+    if (ContainsSubquery(conjunct) == true) {
+      if (subquery_predicate != nullptr) return nullptr;
+      subquery_predicate = conjunct;
+    } else if (RefersOnlyTo(conjunct, outer.table, outer_alias) == true) {
+      outer.predicates.push_back(conjunct);
+    } else {
+      return nullptr;
+    }
+  }
+  if (subquery_predicate == nullptr) return nullptr;
+
+  bool is_negated = false;
+  if (subquery_predicate->GetExpressionType() ==
+      ExpressionType::OPERATOR_NOT) {
+    is_negated = true;
+    subquery_predicate = subquery_predicate->GetModifiableChild(0);
+  }
+
+  // The subquery must be the direct operand of IN or EXISTS
+  bool is_in;
+  const expression::AbstractExpression *subquery;
+  switch (subquery_predicate->GetExpressionType()) {
+    case ExpressionType::COMPARE_IN:
+      if (subquery_predicate->GetChildrenSize() != 2) return nullptr;
+      is_in = true;
+      subquery = subquery_predicate->GetChild(1);
+      break;
+    case ExpressionType::OPERATOR_EXISTS:
+      is_in = false;
+      subquery = subquery_predicate->GetChild(0);
+      break;
+    default:
+      return nullptr;
+  }
+  if (subquery->GetExpressionType() != ExpressionType::ROW_SUBQUERY) {
+    return nullptr;
+  }
+  auto sub_select =
+      static_cast<const expression::SubqueryExpression *>(subquery)
+          ->GetSubSelect();
+
+  JoinSide inner;
+  inner.table = GetBaseTable(sub_select, inner.table_ref);
+  if (inner.table == nullptr) return nullptr;
+  auto inner_alias = inner.table_ref->GetTableAlias();
+  auto inner_schema = inner.table->GetSchema();
+
+  if (is_in == true) {
+    // x IN (SELECT y ...) joins on x = y
+    oid_t outer_column_id = GetColumnId(subquery_predicate->GetChild(0),
+                                        outer.table, outer_alias);
+    if (outer_column_id == INVALID_OID || sub_select->select_list.size() != 1) {
+      return nullptr;
+    }
+    oid_t inner_column_id = GetColumnId(sub_select->select_list[0].get(),
+                                        inner.table, inner_alias);
+    if (inner_column_id == INVALID_OID) return nullptr;
+    outer.key_column_ids.push_back(outer_column_id);
+    inner.key_column_ids.push_back(inner_column_id);
+
+    if (sub_select->where_clause != nullptr) {
+      util::SplitPredicates(sub_select->where_clause.get(), inner.predicates);
+      for (auto predicate : inner.predicates) {
+        if (ContainsSubquery(predicate) == true ||
+            RefersOnlyTo(predicate, inner.table, inner_alias) == false) {
+          return nullptr;
+        }
+      }
+    }
+  } else if (GetCorrelation(sub_select, outer, inner) == false) {
+    return nullptr;
+  }
+
+  // The hash table compares keys of the same type
+  for (size_t key_itr = 0; key_itr < outer.key_column_ids.size(); key_itr++) {
+    if (outer_schema->GetType(outer.key_column_ids[key_itr]) !=
+        inner_schema->GetType(inner.key_column_ids[key_itr])) {
+      return nullptr;
+    }
+  }
+
+  LOG_TRACE("Planning %s subquery on table %s as a semi join",
+            is_in ? "IN" : "EXISTS", inner.table->GetName().c_str());
+
+  // The subquery side only needs its keys, the outer side all columns
+  std::vector<oid_t> all_column_ids(outer_schema->GetColumnCount());
+  std::iota(all_column_ids.begin(), all_column_ids.end(), 0);
+  auto left_plan = BuildScanPlan(inner, inner.key_column_ids);
+  auto right_plan = BuildScanPlan(outer, all_column_ids);
+
+  std::vector<std::unique_ptr<const expression::AbstractExpression>>
+      left_hash_keys, right_hash_keys, hash_keys;
+  for (size_t key_itr = 0; key_itr < outer.key_column_ids.size(); key_itr++) {
+    oid_t column_id = outer.key_column_ids[key_itr];
+    auto type = outer_schema->GetType(column_id);
+    left_hash_keys.emplace_back(
+        new expression::TupleValueExpression(type, 0, key_itr));
+    right_hash_keys.emplace_back(
+        new expression::TupleValueExpression(type, 0, column_id));
+    hash_keys.emplace_back(
+        new expression::TupleValueExpression(type, 0, column_id));
+  }
+
+  // The output consists of right columns only
+  DirectMapList dml;
+  std::vector<catalog::Column> columns;
+  for (oid_t output_itr = 0; output_itr < output_column_ids.size();
+       output_itr++) {
+    oid_t column_id = output_column_ids[output_itr];
+    auto &column = outer_schema->GetColumn(column_id);
+    dml.emplace_back(output_itr, std::make_pair(1, column_id));
+    columns.emplace_back(column.GetType(),
+                         type::Type::GetTypeSize(column.GetType()),
+                         column.GetName());
+  }
+  std::unique_ptr<const planner::ProjectInfo> proj_info(
+      new planner::ProjectInfo(TargetList(), std::move(dml)));
+  std::shared_ptr<const catalog::Schema> schema(new catalog::Schema(columns));
+
+  std::unique_ptr<planner::HashJoinPlan> join_plan(new planner::HashJoinPlan(
+      is_negated ? JoinType::ANTI : JoinType::SEMI, nullptr,
+      std::move(proj_info), schema, left_hash_keys, right_hash_keys, false));
+  join_plan->SetNullAware(is_negated && is_in);
+
+  std::unique_ptr<planner::HashPlan> hash_plan(
+      new planner::HashPlan(hash_keys));
+  hash_plan->AddChild(std::move(right_plan));
+  join_plan->AddChild(std::move(left_plan));
+  join_plan->AddChild(std::move(hash_plan));
+  return std::unique_ptr<planner::AbstractPlan>(join_plan.release());
+}
+
+bool SemiJoinPlanner::HasSubquery(parser::SQLStatement *tree) {
+  switch (tree->GetType()) {
+    case StatementType::SELECT: {
+      auto select_stmt = static_cast<parser::SelectStatement *>(tree);
+      for (auto &expr : select_stmt->select_list) {
+        if (ContainsSubquery(expr.get())) return true;
+      }
+      return ContainsSubquery(select_stmt->where_clause.get()) ||
+             (select_stmt->group_by != nullptr &&
+              ContainsSubquery(select_stmt->group_by->having.get()));
+    }
+    case StatementType::UPDATE: {
+      auto update_stmt = static_cast<parser::UpdateStatement *>(tree);
+      for (auto &update : update_stmt->updates) {
+        if (ContainsSubquery(update->value.get())) return true;
+      }
+      return ContainsSubquery(update_stmt->where.get());
+    }
+    case StatementType::DELETE:
+      return ContainsSubquery(
+          static_cast<parser::DeleteStatement *>(tree)->expr.get());
+    default:
+      return false;
+  }
+}
+
+storage::DataTable *SemiJoinPlanner::GetBaseTable(
+    parser::SelectStatement *select_stmt, parser::TableRef *&table_ref) {
+  if (select_stmt->group_by != nullptr || select_stmt->order != nullptr ||
+      select_stmt->limit != nullptr || select_stmt->union_select != nullptr) {
+    return nullptr;
+  }
+
+  table_ref = select_stmt->from_table.get();
+  if (table_ref != nullptr && table_ref->list.size() == 1) {
+    table_ref = table_ref->list.at(0).get();
+  }
+  if (table_ref == nullptr || table_ref->select != nullptr ||
+      table_ref->join != nullptr || table_ref->list.empty() == false) {
+    return nullptr;
+  }
+  return catalog::Catalog::GetInstance()->GetTableWithName(
+      table_ref->GetDatabaseName(), table_ref->GetTableName(), txn_);
+}
+
+bool SemiJoinPlanner::GetCorrelation(parser::SelectStatement *sub_select,
+                                     JoinSide &outer, JoinSide &inner) {
+  if (sub_select->where_clause == nullptr) return false;
+  auto outer_alias = outer.table_ref->GetTableAlias();
+  auto inner_alias = inner.table_ref->GetTableAlias();
+
+  std::vector<expression::AbstractExpression *> conjuncts;
+  util::SplitPredicates(sub_select->where_clause.get(), conjuncts);
+  for (auto conjunct : conjuncts) {
+    if (ContainsSubquery(conjunct) == true) return false;
+    if (RefersOnlyTo(conjunct, inner.table, inner_alias) == true) {
+      inner.predicates.push_back(conjunct);
+      continue;
+    }
+
+    // inner.y = outer.x in either order
+    if (conjunct->GetExpressionType() != ExpressionType::COMPARE_EQUAL) {
+      return false;
+    }
+    auto inner_expr = conjunct->GetChild(0);
+    auto outer_expr = conjunct->GetChild(1);
+    if (GetColumnId(inner_expr, inner.table, inner_alias) == INVALID_OID) {
+      std::swap(inner_expr, outer_expr);
+    }
+    oid_t inner_column_id = GetColumnId(inner_expr, inner.table, inner_alias);
+    oid_t outer_column_id = GetColumnId(outer_expr, outer.table, outer_alias);
+    if (inner_column_id == INVALID_OID || outer_column_id == INVALID_OID) {
+      return false;
+    }
+    inner.key_column_ids.push_back(inner_column_id);
+    outer.key_column_ids.push_back(outer_column_id);
+  }
+
+  // Without a correlation the subquery is a constant
+  return inner.key_column_ids.empty() == false;
+}
+
+std::unique_ptr<planner::AbstractPlan> SemiJoinPlanner::BuildScanPlan(
+    const JoinSide &side, const std::vector<oid_t> &column_ids) {
+  // Map the columns of the table to their offsets in the scanned tuple
+  ExprMap table_expr_map;
+  auto alias = side.table_ref->GetTableAlias();
+  auto schema = side.table->GetSchema();
+  for (oid_t column_id = 0; column_id < schema->GetColumnCount();
+       column_id++) {
+    auto column_expr = std::make_shared<expression::TupleValueExpression>(
+        "", alias.c_str());
+    column_expr->SetValueType(schema->GetColumn(column_id).GetType());
+    column_expr->SetBoundOid(side.table->GetDatabaseOid(), side.table->GetOid(),
+                             column_id);
+    table_expr_map[column_expr] = column_id;
+  }
+
+  std::vector<expression::AbstractExpression *> predicates;
+  for (auto predicate : side.predicates) {
+    predicates.push_back(predicate->Copy());
+  }
+  auto predicate = util::CombinePredicates(predicates);
+  expression::ExpressionUtil::EvaluateExpression({table_expr_map}, predicate);
+
+  return std::unique_ptr<planner::AbstractPlan>(
+      new planner::SeqScanPlan(side.table, predicate, column_ids));
+}
+
+}  // namespace optimizer
+}  // namespace peloton
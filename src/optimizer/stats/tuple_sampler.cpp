@@ -99,12 +99,9 @@ bool TupleSampler::GetTupleInTileGroup(storage::TileGroup *tile_group,
 
     storage::Tile *tile = tile_group->GetTile(tile_itr);
 
-    char *tile_tuple_location = tile->GetTupleLocation(tuple_offset);
-    storage::Tuple tile_tuple(&schema, tile_tuple_location);
-
     for (oid_t tile_column_itr = 0; tile_column_itr < tile_column_count;
          tile_column_itr++) {
-      type::Value val = (tile_tuple.GetValue(tile_column_itr));
+      type::Value val = (tile->GetValue(tuple_offset, tile_column_itr));
       tuple->SetValue(tuple_column_itr, val, pool_.get());
       tuple_column_itr++;
     }
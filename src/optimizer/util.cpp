@@ -14,6 +14,7 @@
 
 #include "concurrency/transaction_manager_factory.h"
 #include "catalog/query_metrics_catalog.h"
+#include "expression/comparison_expression.h"
 #include "expression/expression_util.h"
 #include "planner/copy_plan.h"
 #include "planner/seq_scan_plan.h"
@@ -110,6 +111,41 @@ bool CheckIndexSearchable(storage::DataTable* target_table,
  * This function replaces all COLUMN_REF expressions with TupleValue
  * expressions
  */
+bool GetLikePrefixRange(const expression::AbstractExpression* expression,
+                        std::vector<ExpressionType>& expr_types,
+                        std::vector<type::Value>& values) {
+  if (expression->GetExpressionType() != ExpressionType::COMPARE_LIKE) {
+    return false;
+  }
+  auto pattern = static_cast<const expression::ComparisonExpression*>(
+                     expression)->GetLikePattern();
+  if (pattern == nullptr || pattern->GetPrefix().empty()) {
+    return false;
+  }
+
+  auto& prefix = pattern->GetPrefix();
+  if (pattern->GetKind() == function::LikePattern::Kind::EXACT) {
+    expr_types.push_back(ExpressionType::COMPARE_EQUAL);
+    values.push_back(type::ValueFactory::GetVarcharValue(prefix));
+    return true;
+  }
+  expr_types.push_back(ExpressionType::COMPARE_GREATERTHANOREQUALTO);
+  values.push_back(type::ValueFactory::GetVarcharValue(prefix));
+
+  // The smallest string after all the ones starting with the prefix, there
+  // is none if the prefix is all 0xFF bytes
+  std::string upper = prefix;
+  while (!upper.empty() && static_cast<unsigned char>(upper.back()) == 0xFF) {
+    upper.pop_back();
+  }
+  if (!upper.empty()) {
+    upper.back()++;
+    expr_types.push_back(ExpressionType::COMPARE_LESSTHAN);
+    values.push_back(type::ValueFactory::GetVarcharValue(upper));
+  }
+  return true;
+}
+
 void GetPredicateColumns(const catalog::Schema* schema,
                          expression::AbstractExpression* expression,
                          std::vector<oid_t>& column_ids,
@@ -141,6 +177,17 @@ void GetPredicateColumns(const catalog::Schema* schema,
       std::string col_name(expr->GetColumnName());
       LOG_TRACE("Column name: %s", col_name.c_str());
       auto column_id = schema->GetColumnID(col_name);
+
+      // LIKE 'prefix%' scans the strings starting with the prefix, the
+      // predicate still filters what the range lets through
+      auto range_size = expr_types.size();
+      if (schema->GetColumn(column_id).GetType() == type::TypeId::VARCHAR &&
+          GetLikePrefixRange(expression, expr_types, values)) {
+        column_ids.resize(column_ids.size() + expr_types.size() - range_size,
+                          column_id);
+        return;
+      }
+
       column_ids.push_back(column_id);
       expr_types.push_back(expression->GetExpressionType());
 
@@ -329,9 +376,6 @@ std::unique_ptr<planner::AbstractPlan> CreateCopyPlan(
     deserialize_parameters = true;
   }
 
-  std::unique_ptr<planner::AbstractPlan> copy_plan(
-      new planner::CopyPlan(copy_stmt->file_path, deserialize_parameters));
-
   auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
   auto txn = txn_manager.BeginTransaction();
   auto target_table = catalog::Catalog::GetInstance()->GetTableWithName(
@@ -339,6 +383,17 @@ std::unique_ptr<planner::AbstractPlan> CreateCopyPlan(
       copy_stmt->cpy_table->GetTableName(), txn);
   txn_manager.CommitTransaction(txn);
 
+  // COPY FROM inserts directly into the table and has no child
+  if (copy_stmt->type == CopyType::IMPORT_CSV ||
+      copy_stmt->type == CopyType::IMPORT_TSV) {
+    return std::unique_ptr<planner::AbstractPlan>(new planner::CopyPlan(
+        target_table, copy_stmt->file_path, copy_stmt->delimiter,
+        copy_stmt->type == CopyType::IMPORT_CSV));
+  }
+
+  std::unique_ptr<planner::AbstractPlan> copy_plan(
+      new planner::CopyPlan(copy_stmt->file_path, deserialize_parameters));
+
   std::unique_ptr<planner::SeqScanPlan> select_plan(
       new planner::SeqScanPlan(target_table, nullptr, {}, false));
 
@@ -196,6 +196,9 @@ std::string ParserUtils::GetCreateStatementInfo(CreateStatement* stmt,
     os << "\n";
   } else if (stmt->type == CreateStatement::CreateType::kTable) {
     os << indent(num_indent + 1) << stmt->GetTableName() << "\n";
+  } else if (stmt->type == CreateStatement::CreateType::kMaterializedView) {
+    os << indent(num_indent + 1) << stmt->GetTableName() << "\n";
+    os << GetSelectStatementInfo(stmt->view_query.get(), num_indent + 1);
   }
 
   if (!stmt->columns.empty()) {
@@ -25,6 +25,7 @@
 #include "expression/function_expression.h"
 #include "expression/operator_expression.h"
 #include "expression/star_expression.h"
+#include "expression/subquery_expression.h"
 #include "expression/tuple_value_expression.h"
 #include "parser/pg_query.h"
 #include "parser/pg_trigger.h"
@@ -539,6 +540,45 @@ expression::AbstractExpression* PostgresParser::FuncCallTransform(
   return result;
 }
 
+// This function takes in a Postgres SubLink parsenode and transfers it into
+// a Peloton COMPARE_IN comparison with a SubqueryExpression for IN and
+// = ANY, or an OPERATOR_EXISTS over one for EXISTS. NOT IN and NOT EXISTS
+// arrive as a NOT around the SubLink.
+expression::AbstractExpression* PostgresParser::SubLinkTransform(
+    SubLink* root) {
+  bool is_in = false;
+  if (root->subLinkType == ANY_SUBLINK && root->operName != nullptr) {
+    const char* name =
+        (reinterpret_cast<value*>(root->operName->head->data.ptr_value))
+            ->val.str;
+    is_in = std::string(name) == "=";
+  }
+  if (is_in == false && root->subLinkType != EXISTS_SUBLINK) {
+    throw NotImplementedException(StringUtil::Format(
+        "Subquery of type %d not supported yet...\n", root->subLinkType));
+  }
+
+  auto subquery = new expression::SubqueryExpression(
+      reinterpret_cast<parser::SelectStatement*>(
+          SelectTransform(reinterpret_cast<SelectStmt*>(root->subselect))));
+  if (is_in == false) {
+    return new expression::OperatorExpression(ExpressionType::OPERATOR_EXISTS,
+                                              type::TypeId::BOOLEAN, subquery,
+                                              nullptr);
+  }
+
+  expression::AbstractExpression* left_expr = nullptr;
+  try {
+    left_expr = ExprTransform(root->testexpr);
+  } catch (NotImplementedException e) {
+    delete subquery;
+    throw NotImplementedException(
+        StringUtil::Format("Exception thrown in IN subquery:\n%s", e.what()));
+  }
+  return new expression::ComparisonExpression(ExpressionType::COMPARE_IN,
+                                              left_expr, subquery);
+}
+
 // This function takes in the whereClause part of a Postgres SelectStmt
 // parsenode and transfers it into the select_list of a Peloton SelectStatement.
 // It checks the type of each target and call the corresponding helpers.
@@ -644,6 +684,10 @@ expression::AbstractExpression* PostgresParser::ExprTransform(Node* node) {
       expr = CaseExprTransform(reinterpret_cast<CaseExpr*>(node));
       break;
     }
+    case T_SubLink: {
+      expr = SubLinkTransform(reinterpret_cast<SubLink*>(node));
+      break;
+    }
     default: {
       throw NotImplementedException(StringUtil::Format(
           "Expr of type %d not supported yet...\n", node->type));
@@ -667,8 +711,18 @@ expression::AbstractExpression* PostgresParser::AExprTransform(A_Expr* root) {
   UNUSED_ATTRIBUTE ExpressionType target_type;
   const char* name =
       (reinterpret_cast<value*>(root->name->head->data.ptr_value))->val.str;
+  if (root->kind == AEXPR_IN) {
+    return InListTransform(root);
+  }
+
+  // NOT ILIKE has no expression type of its own
+  bool negate = false;
   if ((root->kind) != AEXPR_DISTINCT) {
     target_type = StringToExpressionType(std::string(name));
+    if (root->kind == AEXPR_ILIKE && std::string(name) == "!~~*") {
+      target_type = ExpressionType::COMPARE_ILIKE;
+      negate = true;
+    }
   } else {
     target_type = StringToExpressionType("COMPARE_DISTINCT_FROM");
   }
@@ -698,7 +752,8 @@ expression::AbstractExpression* PostgresParser::AExprTransform(A_Expr* root) {
   if (type_id <= 6) {
     result = new expression::OperatorExpression(
         target_type, StringToTypeId("INVALID"), left_expr, right_expr);
-  } else if (((10 <= type_id) && (type_id <= 17)) || (type_id == 20)) {
+  } else if (((10 <= type_id) && (type_id <= 17)) || (type_id == 20) ||
+             (type_id == 21)) {
     result = new expression::ComparisonExpression(target_type, left_expr,
                                                   right_expr);
   } else {
@@ -707,6 +762,51 @@ expression::AbstractExpression* PostgresParser::AExprTransform(A_Expr* root) {
     throw NotImplementedException(StringUtil::Format(
         "A_Expr Transform for type %d is not implemented yet...\n", type_id));
   }
+  if (negate) {
+    result = new expression::OperatorExpression(
+        ExpressionType::OPERATOR_NOT, StringToTypeId("INVALID"), result,
+        nullptr);
+  }
+  return result;
+}
+
+// This function takes in a Postgres A_Expr parsenode of kind AEXPR_IN and
+// transfers it into a Peloton ComparisonExpression of type COMPARE_IN,
+// whose children after the first one are the list.
+expression::AbstractExpression* PostgresParser::InListTransform(A_Expr* root) {
+  if (root->rexpr == nullptr || root->rexpr->type != T_List) {
+    throw NotImplementedException("IN with a subquery not supported yet...\n");
+  }
+  const char* name =
+      (reinterpret_cast<value*>(root->name->head->data.ptr_value))->val.str;
+
+  expression::AbstractExpression* left_expr = nullptr;
+  std::vector<expression::AbstractExpression*> list;
+  try {
+    left_expr = ExprTransform(root->lexpr);
+    for (auto cell = reinterpret_cast<List*>(root->rexpr)->head;
+         cell != nullptr; cell = cell->next) {
+      list.push_back(
+          ExprTransform(reinterpret_cast<Node*>(cell->data.ptr_value)));
+    }
+  } catch (NotImplementedException e) {
+    delete left_expr;
+    for (auto expr : list) {
+      delete expr;
+    }
+    throw NotImplementedException(
+        StringUtil::Format("Exception thrown in IN list:\n%s", e.what()));
+  }
+
+  expression::AbstractExpression* result =
+      new expression::ComparisonExpression(ExpressionType::COMPARE_IN,
+                                           left_expr, list);
+  // NOT IN is named "<>"
+  if (std::string(name) == "<>") {
+    result = new expression::OperatorExpression(
+        ExpressionType::OPERATOR_NOT, StringToTypeId("INVALID"), result,
+        nullptr);
+  }
   return result;
 }
 
@@ -1025,12 +1125,37 @@ parser::SQLStatement* PostgresParser::CreateDbTransform(CreatedbStmt* root) {
   return result;
 }
 
+// This function takes in a Postgres CreateTableAsStmt parsenode of a
+// CREATE MATERIALIZED VIEW and transfers into a Peloton CreateStatement
+// parsenode. CREATE TABLE AS and SELECT INTO are not supported.
+parser::SQLStatement* PostgresParser::CreateMaterializedViewTransform(
+    CreateTableAsStmt* root) {
+  if (root->relkind != ObjectType::OBJECT_MATVIEW) {
+    throw NotImplementedException("CREATE TABLE AS not supported yet...\n");
+  }
+  if (root->query == nullptr || root->query->type != T_SelectStmt) {
+    throw NotImplementedException(
+        "Materialized view of a non-SELECT query not supported...\n");
+  }
+
+  parser::CreateStatement* result =
+      new parser::CreateStatement(CreateStatement::kMaterializedView);
+  result->if_not_exists = root->if_not_exists;
+  result->table_info_.reset(new TableInfo());
+  result->table_info_->table_name = root->into->rel->relname;
+  result->view_query.reset(static_cast<SelectStatement*>(
+      SelectTransform(reinterpret_cast<SelectStmt*>(root->query))));
+  return result;
+}
+
 parser::DropStatement* PostgresParser::DropTransform(DropStmt* root) {
   switch (root->removeType) {
     case ObjectType::OBJECT_TABLE:
       return DropTableTransform(root);
     case ObjectType::OBJECT_TRIGGER:
       return DropTriggerTransform(root);
+    case ObjectType::OBJECT_MATVIEW:
+      return DropMaterializedViewTransform(root);
     default: {
       throw NotImplementedException(StringUtil::Format(
           "Drop of ObjectType %d not supported yet...\n", root->removeType));
@@ -1064,6 +1189,18 @@ parser::DropStatement* PostgresParser::DropTriggerTransform(DropStmt* root) {
   return res;
 }
 
+parser::DropStatement* PostgresParser::DropMaterializedViewTransform(
+    DropStmt* root) {
+  auto res = new DropStatement(DropStatement::EntityType::kView);
+  res->missing = root->missing_ok;
+  auto list = reinterpret_cast<List*>(root->objects->head->data.ptr_value);
+  auto table_info = new TableInfo{};
+  table_info->table_name =
+      reinterpret_cast<value*>(list->head->data.ptr_value)->val.str;
+  res->table_info_.reset(table_info);
+  return res;
+}
+
 parser::DeleteStatement* PostgresParser::TruncateTransform(TruncateStmt* root) {
   auto result = new DeleteStatement();
   for (auto cell = root->relations->head; cell != nullptr; cell = cell->next) {
@@ -1092,19 +1229,37 @@ parser::PrepareStatement* PostgresParser::PrepareTransform(PrepareStmt* root) {
   return res;
 }
 
-// TODO: Only support COPY TABLE TO FILE and DELIMITER option
+// TODO: Only support COPY TABLE TO/FROM FILE/STDIN with the FORMAT and
+// DELIMITER options
 parser::CopyStatement* PostgresParser::CopyTransform(CopyStmt* root) {
-  auto res = new CopyStatement(peloton::CopyType::EXPORT_OTHER);
+  // COPY FROM defaults to csv, unless the text format is requested below
+  auto res = new CopyStatement(root->is_from ? peloton::CopyType::IMPORT_CSV
+                                             : peloton::CopyType::EXPORT_OTHER);
   res->cpy_table.reset(RangeVarTransform(root->relation));
-  res->file_path = root->filename;
-  for (auto cell = root->options->head; cell != NULL; cell = cell->next) {
-    auto def_elem = reinterpret_cast<DefElem*>(cell->data.ptr_value);
-    if (strcmp(def_elem->defname, "delimiter") == 0) {
-      auto delimiter = reinterpret_cast<value*>(def_elem->arg)->val.str;
-      res->delimiter = *delimiter;
-      break;
+  // A NULL file name means STDIN/STDOUT
+  if (root->filename != nullptr) {
+    res->file_path = root->filename;
+  }
+  bool has_delimiter = false;
+  if (root->options != nullptr) {
+    for (auto cell = root->options->head; cell != NULL; cell = cell->next) {
+      auto def_elem = reinterpret_cast<DefElem*>(cell->data.ptr_value);
+      if (strcmp(def_elem->defname, "delimiter") == 0) {
+        auto delimiter = reinterpret_cast<value*>(def_elem->arg)->val.str;
+        res->delimiter = *delimiter;
+        has_delimiter = true;
+      } else if (strcmp(def_elem->defname, "format") == 0 && root->is_from) {
+        auto format = reinterpret_cast<value*>(def_elem->arg)->val.str;
+        if (strcmp(format, "text") == 0) {
+          res->type = peloton::CopyType::IMPORT_TSV;
+        }
+      }
     }
   }
+  // The text format is tab separated by default
+  if (res->type == peloton::CopyType::IMPORT_TSV && has_delimiter == false) {
+    res->delimiter = '\t';
+  }
   return res;
 }
 
@@ -1321,6 +1476,10 @@ parser::SQLStatement* PostgresParser::NodeTransform(Node* stmt) {
     case T_CreateTrigStmt:
       result = CreateTriggerTransform(reinterpret_cast<CreateTrigStmt*>(stmt));
       break;
+    case T_CreateTableAsStmt:
+      result = CreateMaterializedViewTransform(
+          reinterpret_cast<CreateTableAsStmt*>(stmt));
+      break;
     case T_UpdateStmt:
       result = UpdateTransform((UpdateStmt*)stmt);
       break;
@@ -12,7 +12,11 @@
 
 #include "planner/create_plan.h"
 
+#include <algorithm>
+
+#include "common/exception.h"
 #include "expression/constant_value_expression.h"
+#include "expression/tuple_value_expression.h"
 #include "storage/data_table.h"
 #include "type/types.h"
 #include "expression/abstract_expression.h"
@@ -182,6 +186,13 @@ CreatePlan::CreatePlan(parser::CreateStatement *parse_tree)
 
       break;
     }
+    case parser::CreateStatement::CreateType::kMaterializedView: {
+      create_type = CreateType::MATERIALIZED_VIEW;
+      view_name = std::string(parse_tree->GetTableName());
+      database_name = std::string(parse_tree->GetDatabaseName());
+      ProcessMaterializedViewQuery(parse_tree->view_query.get());
+      break;
+    }
     default:
       LOG_ERROR("UNKNOWN CREATE TYPE");
       //TODO Should we handle this here?
@@ -227,5 +238,81 @@ expression::AbstractExpression *CreatePlan::GetTriggerWhen() const {
   }
 }
 
+void CreatePlan::ProcessMaterializedViewQuery(
+    parser::SelectStatement *view_query) {
+  if (view_query->group_by == nullptr ||
+      view_query->group_by->having != nullptr ||
+      view_query->where_clause != nullptr || view_query->order != nullptr ||
+      view_query->limit != nullptr || view_query->union_select != nullptr ||
+      view_query->select_distinct == true) {
+    throw NotImplementedException(
+        "Materialized views only support GROUP BY queries without WHERE, "
+        "HAVING, DISTINCT, ORDER BY or LIMIT");
+  }
+
+  auto table_ref = view_query->from_table.get();
+  if (table_ref != nullptr && table_ref->list.size() == 1) {
+    table_ref = table_ref->list.at(0).get();
+  }
+  if (table_ref == nullptr || table_ref->select != nullptr ||
+      table_ref->join != nullptr || table_ref->list.empty() == false) {
+    throw NotImplementedException(
+        "Materialized views only support queries over a single table");
+  }
+  table_name = table_ref->GetTableName();
+
+  for (auto &column : view_query->group_by->columns) {
+    if (column->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+      throw NotImplementedException(
+          "Materialized views can only group by columns");
+    }
+    view_group_columns.push_back(
+        static_cast<expression::TupleValueExpression *>(column.get())
+            ->GetColumnName());
+  }
+
+  for (auto &expr : view_query->select_list) {
+    auto expr_type = expr->GetExpressionType();
+    if (expr_type == ExpressionType::VALUE_TUPLE) {
+      auto column_name =
+          static_cast<expression::TupleValueExpression *>(expr.get())
+              ->GetColumnName();
+      if (std::find(view_group_columns.begin(), view_group_columns.end(),
+                    column_name) == view_group_columns.end()) {
+        throw NotImplementedException(StringUtil::Format(
+            "Column '%s' of a materialized view must be a group column",
+            column_name.c_str()));
+      }
+      continue;
+    }
+
+    switch (expr_type) {
+      case ExpressionType::AGGREGATE_COUNT_STAR:
+        view_aggregates.emplace_back(expr_type, "");
+        continue;
+      case ExpressionType::AGGREGATE_COUNT:
+      case ExpressionType::AGGREGATE_SUM:
+      case ExpressionType::AGGREGATE_MIN:
+      case ExpressionType::AGGREGATE_MAX:
+      case ExpressionType::AGGREGATE_AVG:
+        break;
+      default:
+        throw NotImplementedException(
+            "Materialized views only support group columns and COUNT, SUM, "
+            "MIN, MAX and AVG of columns");
+    }
+    if (expr->distinct_ == true || expr->GetChildrenSize() != 1 ||
+        expr->GetChild(0)->GetExpressionType() !=
+            ExpressionType::VALUE_TUPLE) {
+      throw NotImplementedException(
+          "Materialized views only support aggregates of columns");
+    }
+    view_aggregates.emplace_back(
+        expr_type,
+        static_cast<const expression::TupleValueExpression *>(expr->GetChild(0))
+            ->GetColumnName());
+  }
+}
+
 }  // namespace planner
 }  // namespace peloton
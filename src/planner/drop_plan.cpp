@@ -33,6 +33,10 @@ DropPlan::DropPlan(parser::DropStatement *parse_tree) {
     table_name = std::string(parse_tree->table_name_of_trigger);
     trigger_name = std::string(parse_tree->trigger_name);
     drop_type = DropType::TRIGGER;
+  } else if (parse_tree->type == parser::DropStatement::EntityType::kView) {
+    view_name = parse_tree->GetTableName();
+    missing = parse_tree->missing;
+    drop_type = DropType::MATERIALIZED_VIEW;
   }
 }
 
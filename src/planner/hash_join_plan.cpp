@@ -61,6 +61,31 @@ HashJoinPlan::HashJoinPlan(
       right_hash_keys_(std::move(right_hash_keys)),
       build_bloomfilter_(build_bloomfilter) {}
 
+std::unique_ptr<AbstractPlan> HashJoinPlan::Copy() const {
+  std::unique_ptr<const expression::AbstractExpression> predicate_copy(
+      GetPredicate() ? GetPredicate()->Copy() : nullptr);
+  std::shared_ptr<const catalog::Schema> schema_copy(
+      catalog::Schema::CopySchema(GetSchema()));
+  std::unique_ptr<const ProjectInfo> proj_info_copy(
+      GetProjInfo() ? GetProjInfo()->Copy().release() : nullptr);
+
+  std::vector<std::unique_ptr<const expression::AbstractExpression>>
+      left_hash_keys, right_hash_keys;
+  for (auto &left_key : left_hash_keys_) {
+    left_hash_keys.emplace_back(left_key->Copy());
+  }
+  for (auto &right_key : right_hash_keys_) {
+    right_hash_keys.emplace_back(right_key->Copy());
+  }
+
+  HashJoinPlan *new_plan = new HashJoinPlan(
+      GetJoinType(), std::move(predicate_copy), std::move(proj_info_copy),
+      schema_copy, left_hash_keys, right_hash_keys, build_bloomfilter_);
+  new_plan->outer_column_ids_ = outer_column_ids_;
+  new_plan->null_aware_ = null_aware_;
+  return std::unique_ptr<AbstractPlan>(new_plan);
+}
+
 void HashJoinPlan::HandleSubplanBinding(bool is_left,
                                         const BindingContext &input) {
   auto &keys = is_left ? left_hash_keys_ : right_hash_keys_;
@@ -0,0 +1,53 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// materialized_view_scan_plan.cpp
+//
+// Identification: src/planner/materialized_view_scan_plan.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "planner/materialized_view_scan_plan.h"
+
+#include "common/logger.h"
+
+namespace peloton {
+namespace planner {
+
+MaterializedViewScanPlan::MaterializedViewScanPlan(
+    std::shared_ptr<storage::MaterializedView> view,
+    const std::vector<storage::MaterializedViewColumn> &columns,
+    std::shared_ptr<const catalog::Schema> output_schema,
+    const std::vector<oid_t> &key_offsets,
+    const std::vector<type::Value> &key_values)
+    : view_(view),
+      columns_(columns),
+      output_schema_(output_schema),
+      key_offsets_(key_offsets) {
+  PL_ASSERT(key_offsets.size() == key_values.size());
+  for (auto &value : key_values) {
+    key_values_with_params_.push_back(value.Copy());
+    key_values_.push_back(value.Copy());
+  }
+}
+
+void MaterializedViewScanPlan::SetParameterValues(
+    std::vector<type::Value> *values) {
+  LOG_TRACE("Setting parameter values in Materialized View Scans");
+
+  key_values_.clear();
+  for (auto &value : key_values_with_params_) {
+    if (value.GetTypeId() == type::TypeId::PARAMETER_OFFSET) {
+      int offset = value.GetAs<int32_t>();
+      key_values_.push_back(values->at(offset).Copy());
+    } else {
+      key_values_.push_back(value.Copy());
+    }
+  }
+}
+
+}  // namespace planner
+}  // namespace peloton
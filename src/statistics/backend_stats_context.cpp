@@ -39,15 +39,18 @@ BackendStatsContext* BackendStatsContext::GetInstance() {
   std::shared_ptr<BackendStatsContext> result(nullptr);
   auto& stats_context_map = GetBackendContextMap();
   if (stats_context_map.Find(this_id, result) == false) {
-    result.reset(new BackendStatsContext(LATENCY_MAX_HISTORY_THREAD, true));
+    result.reset(new BackendStatsContext(true));
     stats_context_map.Insert(this_id, result);
   }
   return result.get();
 }
 
-BackendStatsContext::BackendStatsContext(size_t max_latency_history,
-                                         bool regiser_to_aggregator)
-    : txn_latencies_(LATENCY_METRIC, max_latency_history) {
+BackendStatsContext::BackendStatsContext(bool regiser_to_aggregator)
+    : txn_latencies_(LATENCY_METRIC) {
+  for (auto& query_latency : query_latencies_) {
+    query_latency.reset(new LatencyMetric(LATENCY_METRIC));
+  }
+
   std::thread::id this_id = std::this_thread::get_id();
   thread_id_ = this_id;
 
@@ -107,6 +110,11 @@ LatencyMetric& BackendStatsContext::GetTxnLatencyMetric() {
   return txn_latencies_;
 }
 
+LatencyMetric& BackendStatsContext::GetQueryLatencyMetric(
+    QueryLatencyType latency_type) {
+  return *query_latencies_[static_cast<int>(latency_type)];
+}
+
 void BackendStatsContext::IncrementTableReads(oid_t tile_group_id) {
   oid_t table_id =
       catalog::Manager::GetInstance().GetTileGroup(tile_group_id)->GetTableId();
@@ -222,7 +230,8 @@ void BackendStatsContext::InitQueryMetric(
     const std::shared_ptr<QueryMetric::QueryParams> params) {
   // TODO currently all queries belong to DEFAULT_DB
   ongoing_query_metric_.reset(new QueryMetric(
-      QUERY_METRIC, statement->GetQueryString(), params, DEFAULT_DB_ID));
+      QUERY_METRIC, statement->GetQueryString(), params, DEFAULT_DB_ID,
+      QueryMetric::GetLatencyType(statement->GetQueryTypeString())));
 }
 
 //===--------------------------------------------------------------------===//
@@ -233,6 +242,14 @@ void BackendStatsContext::Aggregate(BackendStatsContext& source) {
   // Aggregate all global metrics
   txn_latencies_.Aggregate(source.txn_latencies_);
   txn_latencies_.ComputeLatencies();
+  for (int i = 0; i < QUERY_LATENCY_TYPE_COUNT; i++) {
+    query_latencies_[i]->Aggregate(*source.query_latencies_[i]);
+    query_latencies_[i]->ComputeLatencies();
+  }
+  // Only what was recorded in this interval
+  source.version_chain_lengths_.Collect(version_chain_lengths_);
+  source.fast_path_planning_latencies_.Collect(fast_path_planning_latencies_);
+  source.optimizer_planning_latencies_.Collect(optimizer_planning_latencies_);
 
   // Aggregate all per-database metrics
   for (auto& database_item : source.database_metrics_) {
@@ -267,6 +284,12 @@ void BackendStatsContext::Aggregate(BackendStatsContext& source) {
 
 void BackendStatsContext::Reset() {
   txn_latencies_.Reset();
+  for (auto& query_latency : query_latencies_) {
+    query_latency->Reset();
+  }
+  version_chain_lengths_.Reset();
+  fast_path_planning_latencies_.Reset();
+  optimizer_planning_latencies_.Reset();
 
   for (auto& database_item : database_metrics_) {
     database_item.second->Reset();
@@ -324,7 +347,31 @@ void BackendStatsContext::Reset() {
 std::string BackendStatsContext::ToString() const {
   std::stringstream ss;
 
-  ss << txn_latencies_.GetInfo() << std::endl;
+  ss << "TXN " << txn_latencies_.GetInfo() << std::endl;
+  for (int i = 0; i < QUERY_LATENCY_TYPE_COUNT; i++) {
+    if (query_latencies_[i]->GetLatencyCount() > 0) {
+      ss << QueryMetric::LatencyTypeToString(
+                static_cast<QueryLatencyType>(i)) << " "
+         << query_latencies_[i]->GetInfo();
+    }
+  }
+  ss << std::endl;
+  if (version_chain_lengths_.GetCount() > 0) {
+    ss << "VERSION CHAIN LENGTH p50: "
+       << version_chain_lengths_.GetPercentile(0.5)
+       << " p99: " << version_chain_lengths_.GetPercentile(0.99)
+       << " max: " << version_chain_lengths_.GetMax() << std::endl;
+  }
+  for (bool fast_path : {true, false}) {
+    auto& planning_latencies = fast_path ? fast_path_planning_latencies_
+                                         : optimizer_planning_latencies_;
+    if (planning_latencies.GetCount() > 0) {
+      ss << (fast_path ? "FAST PATH" : "OPTIMIZER")
+         << " PLANNING count: " << planning_latencies.GetCount()
+         << " p50: " << planning_latencies.GetPercentile(0.5)
+         << " p99: " << planning_latencies.GetPercentile(0.99) << std::endl;
+    }
+  }
 
   for (auto& database_item : database_metrics_) {
     oid_t database_id = database_item.second->GetDatabaseId();
@@ -362,7 +409,9 @@ std::string BackendStatsContext::ToString() const {
 void BackendStatsContext::CompleteQueryMetric() {
   if (ongoing_query_metric_ != nullptr) {
     ongoing_query_metric_->GetProcessorMetric().RecordTime();
-    ongoing_query_metric_->GetQueryLatency().RecordLatency();
+    ongoing_query_metric_->RecordLatency();
+    GetQueryLatencyMetric(ongoing_query_metric_->GetLatencyType())
+        .RecordLatency(ongoing_query_metric_->GetLatency());
     completed_query_metrics_.Enqueue(ongoing_query_metric_);
     ongoing_query_metric_.reset();
     LOG_TRACE("Ongoing query completed");
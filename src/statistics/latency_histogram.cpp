@@ -0,0 +1,168 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// latency_histogram.cpp
+//
+// Identification: src/statistics/latency_histogram.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "statistics/latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace peloton {
+namespace stats {
+
+constexpr uint32_t LatencyHistogram::SUB_BUCKET_BITS;
+constexpr uint32_t LatencyHistogram::SUB_BUCKET_COUNT;
+constexpr uint32_t LatencyHistogram::MAX_VALUE_BITS;
+constexpr uint64_t LatencyHistogram::MAX_VALUE;
+constexpr uint32_t LatencyHistogram::BUCKET_COUNT;
+
+void LatencyHistogram::Merge(const LatencyHistogram &source) {
+  for (uint32_t bucket_index = 0; bucket_index < BUCKET_COUNT;
+       bucket_index++) {
+    auto bucket_count =
+        source.buckets_[bucket_index].load(std::memory_order_relaxed);
+    if (bucket_count != 0) {
+      buckets_[bucket_index].fetch_add(bucket_count,
+                                       std::memory_order_relaxed);
+    }
+  }
+  count_.fetch_add(source.count_.load(std::memory_order_relaxed),
+                   std::memory_order_relaxed);
+  sum_.fetch_add(source.sum_.load(std::memory_order_relaxed),
+                 std::memory_order_relaxed);
+
+  MergeMin(source.min_.load(std::memory_order_relaxed));
+  MergeMax(source.max_.load(std::memory_order_relaxed));
+}
+
+void LatencyHistogram::Collect(LatencyHistogram &target) {
+  uint64_t count = 0;
+  uint32_t min_index = BUCKET_COUNT;
+  uint32_t max_index = 0;
+  for (uint32_t bucket_index = 0; bucket_index < BUCKET_COUNT;
+       bucket_index++) {
+    auto bucket_count = buckets_[bucket_index].load(std::memory_order_relaxed);
+    auto new_count = bucket_count - collected_buckets_[bucket_index];
+    if (new_count == 0) continue;
+
+    collected_buckets_[bucket_index] = bucket_count;
+    target.buckets_[bucket_index].fetch_add(new_count,
+                                            std::memory_order_relaxed);
+    count += new_count;
+    min_index = std::min(min_index, bucket_index);
+    max_index = bucket_index;
+  }
+  if (count == 0) return;
+
+  // The owner adds to the sum last, so it may already hold latencies whose
+  // buckets we missed. They are counted by the next call.
+  auto sum = sum_.load(std::memory_order_relaxed);
+  target.count_.fetch_add(count, std::memory_order_relaxed);
+  target.sum_.fetch_add(sum - collected_sum_, std::memory_order_relaxed);
+  collected_sum_ = sum;
+
+  // Only the extremes since the start are exact, they bound the buckets
+  target.MergeMin(std::max(GetBucketLowerBound(min_index),
+                           min_.load(std::memory_order_relaxed)));
+  target.MergeMax(std::min(GetBucketUpperBound(max_index),
+                           max_.load(std::memory_order_relaxed)));
+}
+
+void LatencyHistogram::MergeMin(uint64_t value) {
+  auto min = min_.load(std::memory_order_relaxed);
+  while (value < min &&
+         !min_.compare_exchange_weak(min, value, std::memory_order_relaxed)) {
+  }
+}
+
+void LatencyHistogram::MergeMax(uint64_t value) {
+  auto max = max_.load(std::memory_order_relaxed);
+  while (value > max &&
+         !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+  }
+}
+
+void LatencyHistogram::Reset() {
+  for (auto &bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+  min_.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+  std::fill(std::begin(collected_buckets_), std::end(collected_buckets_), 0);
+  collected_sum_ = 0;
+}
+
+uint64_t LatencyHistogram::GetMin() const {
+  if (GetCount() == 0) return 0;
+  return min_.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::GetMax() const {
+  return max_.load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::GetMean() const {
+  auto count = GetCount();
+  if (count == 0) return 0;
+  return static_cast<double>(sum_.load(std::memory_order_relaxed)) / count;
+}
+
+uint64_t LatencyHistogram::GetPercentile(double fraction) const {
+  // Count from the buckets themselves, count_ may be ahead of them while
+  // the owner is recording
+  uint64_t total = 0;
+  for (auto &bucket : buckets_) {
+    total += bucket.load(std::memory_order_relaxed);
+  }
+  if (total == 0) return 0;
+
+  fraction = std::min(std::max(fraction, 0.0), 1.0);
+  auto rank = static_cast<uint64_t>(std::ceil(fraction * total));
+  rank = std::max<uint64_t>(rank, 1);
+
+  uint64_t seen = 0;
+  uint32_t bucket_index = 0;
+  for (; bucket_index < BUCKET_COUNT - 1; bucket_index++) {
+    seen += buckets_[bucket_index].load(std::memory_order_relaxed);
+    if (seen >= rank) break;
+  }
+
+  // Report the middle of the bucket, but never beyond the exact extremes
+  auto lower_bound = GetBucketLowerBound(bucket_index);
+  auto value =
+      lower_bound + (GetBucketUpperBound(bucket_index) - lower_bound) / 2;
+  value = std::min(value, GetMax());
+  value = std::max(value, GetMin());
+  return value;
+}
+
+uint64_t LatencyHistogram::GetBucketLowerBound(uint32_t bucket_index) {
+  if (bucket_index < SUB_BUCKET_COUNT) {
+    return bucket_index;
+  }
+  uint32_t shift = bucket_index / SUB_BUCKET_COUNT - 1;
+  uint64_t sub_bucket = bucket_index % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT;
+  return sub_bucket << shift;
+}
+
+uint64_t LatencyHistogram::GetBucketUpperBound(uint32_t bucket_index) {
+  if (bucket_index < SUB_BUCKET_COUNT) {
+    return bucket_index;
+  }
+  uint32_t shift = bucket_index / SUB_BUCKET_COUNT - 1;
+  return GetBucketLowerBound(bucket_index) + (1ull << shift) - 1;
+}
+
+}  // namespace stats
+}  // namespace peloton
@@ -21,12 +21,14 @@ namespace stats {
 
 QueryMetric::QueryMetric(MetricType type, const std::string& query_name,
                          std::shared_ptr<QueryParams> query_params,
-                         const oid_t database_id)
+                         const oid_t database_id,
+                         QueryLatencyType latency_type)
     : AbstractMetric(type),
       database_id_(database_id),
       query_name_(query_name),
-      query_params_(query_params) {
-  latency_metric_.StartTimer();
+      query_params_(query_params),
+      latency_type_(latency_type) {
+  latency_timer_.Start();
   processor_metric_.StartTimer();
   LOG_TRACE("Query metric initialized");
 }
@@ -45,5 +47,35 @@ QueryMetric::QueryParams::QueryParams(QueryParamBuf format_buf_copy,
 
 void QueryMetric::Aggregate(AbstractMetric& source UNUSED_ATTRIBUTE) {}
 
+QueryLatencyType QueryMetric::GetLatencyType(
+    const std::string& query_type_string) {
+  if (query_type_string == "SELECT") {
+    return QueryLatencyType::SELECT;
+  } else if (query_type_string == "INSERT") {
+    return QueryLatencyType::INSERT;
+  } else if (query_type_string == "UPDATE") {
+    return QueryLatencyType::UPDATE;
+  } else if (query_type_string == "DELETE") {
+    return QueryLatencyType::DELETE;
+  }
+  return QueryLatencyType::OTHER;
+}
+
+std::string QueryMetric::LatencyTypeToString(QueryLatencyType latency_type) {
+  switch (latency_type) {
+    case QueryLatencyType::SELECT:
+      return "SELECT";
+    case QueryLatencyType::INSERT:
+      return "INSERT";
+    case QueryLatencyType::UPDATE:
+      return "UPDATE";
+    case QueryLatencyType::DELETE:
+      return "DELETE";
+    case QueryLatencyType::OTHER:
+      return "OTHER";
+  }
+  return "INVALID";
+}
+
 }  // namespace stats
 }  // namespace peloton
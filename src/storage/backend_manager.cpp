@@ -16,17 +16,22 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/file.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <iterator>
 #include <string>
 
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/macros.h"
+#include "common/numa_topology.h"
 #include "type/types.h"
 // #include "logging/logging_util.h"
 #include "storage/backend_manager.h"
@@ -50,6 +55,16 @@ size_t peloton_data_file_size = 0;
 namespace peloton {
 namespace storage {
 
+// Precedes MM and NVM allocations. Keeps the data aligned like operator new.
+struct alignas(16) MemoryHeader {
+  // Length of the mapping the allocation is placed in, 0 if it is on the
+  // heap
+  size_t mapped_length;
+};
+
+// Allocations smaller than a page are not worth a mapping of their own
+#define NUMA_MIN_LENGTH 4096
+
 //===--------------------------------------------------------------------===//
 // INSTRUCTIONS
 //===--------------------------------------------------------------------===//
@@ -305,6 +320,45 @@ static void (*Func_drain)(void) = drain_no_pcommit;
 #define DATA_FILE_LEN 1024 * 1024 * UINT64_C(512)  // 512 MB
 #define DATA_FILE_NAME "peloton.pmem"
 
+// Allocations in the data file are rounded up to whole cache lines
+#define DATA_FILE_ALIGN ((size_t)64)
+
+// Address space reserved for the data file to grow into
+#define DATA_FILE_MAX_LEN (UINT64_C(1) << 40)  // 1 TB
+
+// The extents start at the second page of the file
+#define DATA_FILE_HEADER_LEN ((size_t)4096)
+
+#define DATA_FILE_MAGIC UINT64_C(0x31706d656f746c70)
+#define EXTENT_MAGIC UINT64_C(0x31746e6574786570)
+
+// Start of the data file
+struct DataFileHeader {
+  uint64_t magic;
+
+  // Address the file was mapped at
+  uint64_t address;
+
+  // End of the extents, the file beyond it has never been allocated
+  uint64_t end_offset;
+};
+
+// Precedes every extent of the data file, free or allocated
+struct alignas(64) ExtentHeader {
+  uint64_t magic;
+
+  // Length of the extent, the header included
+  uint64_t length;
+
+  // Key of an allocation that survives a restart, 0 if none
+  uint64_t key;
+
+  uint64_t allocated;
+};
+
+static_assert(sizeof(ExtentHeader) == DATA_FILE_ALIGN,
+              "extent header must take one cache line");
+
 // global singleton
 BackendManager &BackendManager::GetInstance(void) {
   static BackendManager backend_manager;
@@ -313,14 +367,6 @@ BackendManager &BackendManager::GetInstance(void) {
 
 BackendManager::BackendManager()
     : data_file_address(nullptr), data_file_len(0), data_file_offset(0) {
-  // // Check if we need a data pool
-  // if (logging::LoggingUtil::IsBasedOnWriteAheadLogging(peloton_logging_mode)
-  // ==
-  //         true ||
-  //     peloton_logging_mode == LoggingType::INVALID) {
-  //   return;
-  // }
-
   // // Check for instruction availability and flush mode
   // // (1 -- clflush or 2 -- clwb)
   // if (is_cpu_clwb_present() && peloton_flush_mode == 2) {
@@ -334,155 +380,378 @@ BackendManager::BackendManager()
   //   Func_drain = drain_pcommit;
   // }
 
-  // // Rest of this stuff is needed only for Write Behind Logging
-  // int data_fd;
-  // std::string data_file_name;
-  // struct stat data_stat;
-
-  // // Initialize file size
-  // if (peloton_data_file_size != 0)
-  //   data_file_len = peloton_data_file_size * 1024 * 1024;  // MB
-  // else
-  //   data_file_len = DATA_FILE_LEN;
-
-  // // Check for relevant file system
-  // bool found_file_system = false;
-
-  // switch (peloton_logging_mode) {
-  //   // Check for NVM FS for data
-  //   case LoggingType::NVM_WBL: {
-  //     int status = stat(NVM_DIR, &data_stat);
-  //     if (status == 0 && S_ISDIR(data_stat.st_mode)) {
-  //       data_file_name = std::string(NVM_DIR) + std::string(DATA_FILE_NAME);
-  //       found_file_system = true;
-  //     }
-
-  //   } break;
-
-  //   // Check for SSD FS for data
-  //   case LoggingType::SSD_WBL: {
-  //     int status = stat(SSD_DIR, &data_stat);
-  //     if (status == 0 && S_ISDIR(data_stat.st_mode)) {
-  //       data_file_name = std::string(SSD_DIR) + std::string(DATA_FILE_NAME);
-  //       found_file_system = true;
-  //     }
-
-  //   } break;
-
-  //   // Check for HDD FS
-  //   case LoggingType::HDD_WBL: {
-  //     int status = stat(HDD_DIR, &data_stat);
-  //     if (status == 0 && S_ISDIR(data_stat.st_mode)) {
-  //       data_file_name = std::string(HDD_DIR) + std::string(DATA_FILE_NAME);
-  //       found_file_system = true;
-  //     }
-
-  //   } break;
-
-  //   default:
-  //     break;
-  // }
+  // Initialize file size
+  if (peloton_data_file_size != 0)
+    data_file_len = peloton_data_file_size * 1024 * 1024;  // MB
+  else
+    data_file_len = DATA_FILE_LEN;
 
-  // // Fallback to tmp directory if needed
-  // if (found_file_system == false) {
-  //   int status = stat(TMP_DIR, &data_stat);
-  //   if (status == 0 && S_ISDIR(data_stat.st_mode)) {
-  //     data_file_name = std::string(TMP_DIR) + std::string(DATA_FILE_NAME);
-  //   } else {
-  //     throw Exception("Could not find temp directory : " +
-  //                     std::string(TMP_DIR));
-  //   }
-  // }
+  // The data file itself is only created once the SSD or HDD backend is used
+}
 
-  // LOG_TRACE("DATA DIR :: %s ", data_file_name.c_str());
+BackendManager::~BackendManager() {
+  LOG_TRACE("Allocation count : %ld \n", allocation_count);
 
-  // // Create a data file
-  // if ((data_fd = open(
-  //          data_file_name.c_str(), O_CREAT | O_TRUNC | O_RDWR,
-  //          S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH)) < 0) {
-  //   perror(data_file_name.c_str());
-  //   exit(EXIT_FAILURE);
-  // }
+  CloseDataFile();
+}
 
-  // // Allocate the data file
-  // if ((errno = posix_fallocate(data_fd, 0, data_file_len)) != 0) {
-  //   perror("posix_fallocate");
-  //   exit(EXIT_FAILURE);
-  // }
+void BackendManager::ConfigureDataFile(const std::string &directory,
+                                       size_t size_mb) {
+  data_file_spinlock.Lock();
+  if (data_file_address == nullptr) {
+    data_file_directory = directory;
+    if (size_mb != 0) {
+      data_file_len = size_mb * 1024 * 1024;
+    }
+  } else {
+    LOG_WARN("Data file %s is already in use, keeping its configuration",
+             data_file_name.c_str());
+  }
+  data_file_spinlock.Unlock();
+}
 
-  // // map the data file in memory
-  // if ((data_file_address = mmap(NULL, data_file_len, PROT_READ | PROT_WRITE,
-  //                               MAP_SHARED, data_fd, 0)) == MAP_FAILED) {
-  //   perror("mmap");
-  //   exit(EXIT_FAILURE);
-  // }
+size_t BackendManager::GetDataFileUsage() {
+  data_file_spinlock.Lock();
+  size_t usage = 0;
+  if (data_file_address != nullptr) {
+    usage = data_file_offset - DATA_FILE_HEADER_LEN;
+    for (auto &extent : free_extents) {
+      usage -= extent.second;
+    }
+  }
+  data_file_spinlock.Unlock();
+  return usage;
+}
 
-  // // close the pmem file -- it will remain mapped
-  // close(data_fd);
+void BackendManager::OpenDataFile() {
+  struct stat data_stat;
+
+  // Use the configured directory, or the fastest device that is mounted
+  std::string directory = data_file_directory;
+  if (directory.empty() == true) {
+    for (auto candidate : {SSD_DIR, HDD_DIR, TMP_DIR}) {
+      if (stat(candidate, &data_stat) == 0 && S_ISDIR(data_stat.st_mode)) {
+        directory = candidate;
+        break;
+      }
+    }
+  }
+  if (directory.empty() == true) {
+    throw Exception("Could not find a directory for the data file");
+  }
+  if (directory.back() != '/') {
+    directory += '/';
+  }
+
+  data_file_name = directory + DATA_FILE_NAME;
+
+  LOG_TRACE("DATA FILE :: %s ", data_file_name.c_str());
+
+  data_file_fd =
+      open(data_file_name.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+  if (data_file_fd < 0) {
+    throw Exception("Could not open data file " + data_file_name + " : " +
+                    strerror(errno));
+  }
+
+  // Only one process can use the file at a time
+  if (flock(data_file_fd, LOCK_EX | LOCK_NB) != 0) {
+    close(data_file_fd);
+    data_file_fd = -1;
+    throw Exception("Data file " + data_file_name + " is in use");
+  }
+
+  // Reattach to the file of a previous run if it is intact
+  DataFileHeader header;
+  bool is_reopened =
+      fstat(data_file_fd, &data_stat) == 0 &&
+      static_cast<size_t>(data_stat.st_size) >= DATA_FILE_HEADER_LEN &&
+      pread(data_file_fd, &header, sizeof(header), 0) ==
+          static_cast<ssize_t>(sizeof(header)) &&
+      header.magic == DATA_FILE_MAGIC &&
+      header.end_offset >= DATA_FILE_HEADER_LEN &&
+      header.end_offset <= static_cast<size_t>(data_stat.st_size);
+
+  size_t length = data_file_len;
+  if (is_reopened == true) {
+    length = std::max(length, static_cast<size_t>(data_stat.st_size));
+  } else if (ftruncate(data_file_fd, 0) != 0) {
+    LOG_WARN("Could not truncate data file %s : %s", data_file_name.c_str(),
+             strerror(errno));
+  }
+
+  // Reserve the address space the file can grow into, at the address of the
+  // previous run if possible so that pointers into the file stay valid
+  void *hint =
+      is_reopened ? reinterpret_cast<void *>(header.address) : nullptr;
+  data_file_address =
+      mmap(hint, DATA_FILE_MAX_LEN, PROT_NONE,
+           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (data_file_address == MAP_FAILED) {
+    std::string error = strerror(errno);
+    data_file_address = nullptr;
+    close(data_file_fd);
+    data_file_fd = -1;
+    throw Exception("Could not reserve memory for data file " +
+                    data_file_name + " : " + error);
+  }
+  if (is_reopened == true && data_file_address != hint) {
+    LOG_WARN("Data file %s is mapped at a new address",
+             data_file_name.c_str());
+  }
+
+  data_file_len = 0;
+  try {
+    GrowDataFile(length);
+  } catch (Exception &e) {
+    munmap(data_file_address, DATA_FILE_MAX_LEN);
+    data_file_address = nullptr;
+    close(data_file_fd);
+    data_file_fd = -1;
+    throw;
+  }
+
+  data_file_offset = DATA_FILE_HEADER_LEN;
+  if (is_reopened == true) {
+    data_file_offset = header.end_offset;
+    LoadExtents();
+  }
+  WriteFileHeader();
 }
 
-BackendManager::~BackendManager() {
-  LOG_TRACE("Allocation count : %ld \n", allocation_count);
+void BackendManager::CloseDataFile() {
+  if (data_file_address == nullptr) {
+    return;
+  }
 
-  // // Check if we need a PMEM pool
-  // if (peloton_logging_mode != LoggingType::NVM_WBL) return;
-
-  // // sync and unmap the data file
-  // if (data_file_address != nullptr) {
-  //   // sync the mmap'ed file to SSD or HDD
-  //   int status = msync(data_file_address, data_file_len, MS_SYNC);
-  //   if (status != 0) {
-  //     perror("msync");
-  //     exit(EXIT_FAILURE);
-  //   }
-
-  //   if (munmap(data_file_address, data_file_len)) {
-  //     perror("munmap");
-  //     exit(EXIT_FAILURE);
-  //   }
-  // }
+  // sync and unmap the data file
+  WriteFileHeader();
+  if (msync(data_file_address, data_file_len, MS_SYNC) != 0) {
+    LOG_ERROR("Could not sync data file %s : %s", data_file_name.c_str(),
+              strerror(errno));
+  }
+  if (munmap(data_file_address, DATA_FILE_MAX_LEN) != 0) {
+    LOG_ERROR("Could not unmap data file %s : %s", data_file_name.c_str(),
+              strerror(errno));
+  }
+  data_file_address = nullptr;
+
+  // The file stays for the next start, closing it also releases the lock
+  close(data_file_fd);
+  data_file_fd = -1;
+  free_extents.clear();
+  free_extent_lengths.clear();
+  allocated_extents.clear();
+  attachable_extents.clear();
+  data_file_offset = 0;
 }
 
-void *BackendManager::Allocate(BackendType type, size_t size) {
+void BackendManager::LoadExtents() {
+  char *base = reinterpret_cast<char *>(data_file_address);
+
+  // Allocations without a key belonged to objects of the previous run, so
+  // only keyed ones are kept
+  size_t offset = DATA_FILE_HEADER_LEN;
+  while (offset < data_file_offset) {
+    auto header = reinterpret_cast<ExtentHeader *>(base + offset);
+    if (header->magic != EXTENT_MAGIC || header->length == 0 ||
+        header->length % DATA_FILE_ALIGN != 0 ||
+        header->length > data_file_offset - offset) {
+      LOG_WARN("Data file %s is damaged at offset %lu, dropping the rest",
+               data_file_name.c_str(), offset);
+      data_file_offset = offset;
+      break;
+    }
+
+    size_t length = header->length;
+    if (header->allocated != 0 && header->key != 0 &&
+        attachable_extents.count(header->key) == 0) {
+      allocated_extents[offset] = length;
+      attachable_extents[header->key] = offset;
+    } else {
+      AddFreeExtent(offset, length);
+    }
+    offset += length;
+  }
+}
+
+void BackendManager::GrowDataFile(size_t min_length) {
+  static const size_t page_size = sysconf(_SC_PAGESIZE);
+  if (min_length > DATA_FILE_MAX_LEN) {
+    throw Exception("no more memory available: offset : " +
+                    std::to_string(data_file_offset) + " length : " +
+                    std::to_string(min_length));
+  }
+
+  // Double the file to keep the number of mappings low
+  size_t length = std::max(min_length, data_file_len * 2);
+  length = std::min((length + page_size - 1) / page_size * page_size,
+                    static_cast<size_t>(DATA_FILE_MAX_LEN));
+
+  // The file is sparse, so disk space is only used for pages that have been
+  // written. The page cache acts as the buffer pool of the data.
+  if (ftruncate(data_file_fd, length) != 0) {
+    throw Exception("Could not grow data file " + data_file_name + " : " +
+                    strerror(errno));
+  }
+
+  // Map the new part of the file behind the old one, so that nothing moves
+  void *address =
+      mmap(reinterpret_cast<char *>(data_file_address) + data_file_len,
+           length - data_file_len, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_FIXED, data_file_fd, data_file_len);
+  if (address == MAP_FAILED) {
+    throw Exception("Could not map data file " + data_file_name + " : " +
+                    strerror(errno));
+  }
+  data_file_len = length;
+}
+
+void BackendManager::AddFreeExtent(size_t offset, size_t length) {
+  // Give the disk space of whole pages back to the file system. The
+  // released range reads as zeros if it is allocated again.
+  static const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+  uintptr_t begin = reinterpret_cast<uintptr_t>(data_file_address) + offset +
+                    sizeof(ExtentHeader);
+  uintptr_t end = reinterpret_cast<uintptr_t>(data_file_address) + offset +
+                  length;
+  begin = (begin + page_size - 1) & ~(page_size - 1);
+  end = end & ~(page_size - 1);
+  if (begin < end) {
+    madvise(reinterpret_cast<void *>(begin), end - begin, MADV_REMOVE);
+  }
+
+  // Merge with the neighbouring free extents
+  auto next = free_extents.lower_bound(offset);
+  if (next != free_extents.end() && next->first == offset + length) {
+    length += next->second;
+    auto after_next = std::next(next);
+    RemoveFreeExtent(next);
+    next = after_next;
+  }
+  if (next != free_extents.begin()) {
+    auto previous = std::prev(next);
+    if (previous->first + previous->second == offset) {
+      offset = previous->first;
+      length += previous->second;
+      RemoveFreeExtent(previous);
+    }
+  }
+
+  // Space at the end goes back to the unused part of the file
+  if (offset + length == data_file_offset) {
+    data_file_offset = offset;
+    WriteFileHeader();
+  } else {
+    free_extents[offset] = length;
+    free_extent_lengths.emplace(length, offset);
+    WriteExtentHeader(offset, length, 0, false);
+  }
+}
+
+void BackendManager::RemoveFreeExtent(
+    std::map<size_t, size_t>::iterator extent) {
+  free_extent_lengths.erase(std::make_pair(extent->second, extent->first));
+  free_extents.erase(extent);
+}
+
+void BackendManager::WriteExtentHeader(size_t offset, size_t length,
+                                       uint64_t key, bool allocated) {
+  auto header = reinterpret_cast<ExtentHeader *>(
+      reinterpret_cast<char *>(data_file_address) + offset);
+  header->magic = EXTENT_MAGIC;
+  header->length = length;
+  header->key = key;
+  header->allocated = allocated ? 1 : 0;
+}
+
+void BackendManager::WriteFileHeader() {
+  auto header = reinterpret_cast<DataFileHeader *>(data_file_address);
+  header->magic = DATA_FILE_MAGIC;
+  header->address = reinterpret_cast<uint64_t>(data_file_address);
+  header->end_offset = data_file_offset;
+}
+
+void *BackendManager::Allocate(BackendType type, size_t size, uint64_t key) {
   // Update allocation count
   allocation_count++;
 
   switch (type) {
     case BackendType::MM:
     case BackendType::NVM: {
-      return ::operator new(size);
+      size_t length = sizeof(MemoryHeader) + size;
+      MemoryHeader *header = nullptr;
+
+      // Place the pages on the node of the thread that will use them. Heap
+      // pages may be touched already, so they get a mapping of their own.
+      auto &numa_topology = NumaTopology::GetInstance();
+      if (numa_topology.IsEnabled() == true && length >= NUMA_MIN_LENGTH) {
+        header = reinterpret_cast<MemoryHeader *>(numa_topology.AllocateOnNode(
+            length, numa_topology.GetAllocationNode()));
+      }
+
+      if (header != nullptr) {
+        header->mapped_length = length;
+      } else {
+        header = reinterpret_cast<MemoryHeader *>(::operator new(length));
+        header->mapped_length = 0;
+      }
+      return header + 1;
     } break;
 
     case BackendType::SSD:
     case BackendType::HDD: {
-      {
-        size_t cache_data_file_offset = 0;
-
-        // Lock the file
-        data_file_spinlock.Lock();
-
-        // Check if within bounds
-        if (data_file_offset < data_file_len) {
-          cache_data_file_offset = data_file_offset;
+      size_t length = (size + DATA_FILE_ALIGN - 1) / DATA_FILE_ALIGN *
+                          DATA_FILE_ALIGN +
+                      sizeof(ExtentHeader);
 
-          // Offset by the requested size
-          data_file_offset += size;
+      // Lock the file
+      data_file_spinlock.Lock();
 
-          // Unlock the file
+      if (data_file_address == nullptr) {
+        try {
+          OpenDataFile();
+        } catch (Exception &e) {
           data_file_spinlock.Unlock();
+          throw;
+        }
+      }
 
-          void *address = reinterpret_cast<char *>(data_file_address) +
-                          cache_data_file_offset;
-          return address;
+      // Reuse the smallest released extent that fits, otherwise extend the
+      // used part of the file
+      size_t offset;
+      auto fit = free_extent_lengths.lower_bound(std::make_pair(length, 0UL));
+      if (fit != free_extent_lengths.end()) {
+        offset = fit->second;
+        size_t remaining = fit->first - length;
+        RemoveFreeExtent(free_extents.find(offset));
+        if (remaining > 0) {
+          free_extents[offset + length] = remaining;
+          free_extent_lengths.emplace(remaining, offset + length);
+          WriteExtentHeader(offset + length, remaining, 0, false);
         }
+      } else {
+        if (data_file_offset + length > data_file_len) {
+          try {
+            GrowDataFile(data_file_offset + length);
+          } catch (Exception &e) {
+            data_file_spinlock.Unlock();
+            throw;
+          }
+        }
+        offset = data_file_offset;
+        data_file_offset += length;
+        WriteFileHeader();
+      }
 
-        data_file_spinlock.Unlock();
-        throw Exception("no more memory available: offset : " +
-                        std::to_string(data_file_offset) + " length : " +
-                        std::to_string(data_file_len));
+      allocated_extents[offset] = length;
+      WriteExtentHeader(offset, length, key, true);
 
-        return nullptr;
-      }
+      // Unlock the file
+      data_file_spinlock.Unlock();
+
+      return reinterpret_cast<char *>(data_file_address) + offset +
+             sizeof(ExtentHeader);
     } break;
 
     case BackendType::INVALID:
@@ -497,12 +766,38 @@ void BackendManager::Release(BackendType type, void *address) {
   switch (type) {
     case BackendType::MM:
     case BackendType::NVM: {
-      ::operator delete(address);
+      if (address == nullptr) {
+        return;
+      }
+
+      auto header = reinterpret_cast<MemoryHeader *>(address) - 1;
+      if (header->mapped_length > 0) {
+        NumaTopology::GetInstance().FreeOnNode(header, header->mapped_length);
+      } else {
+        ::operator delete(header);
+      }
     } break;
 
     case BackendType::SSD:
     case BackendType::HDD: {
-      // Nothing to do here
+      if (address == nullptr) {
+        return;
+      }
+
+      data_file_spinlock.Lock();
+      size_t offset = reinterpret_cast<char *>(address) -
+                      reinterpret_cast<char *>(data_file_address) -
+                      sizeof(ExtentHeader);
+      auto allocated_extent = allocated_extents.find(offset);
+      if (allocated_extent == allocated_extents.end()) {
+        data_file_spinlock.Unlock();
+        throw Exception("release of unknown data file address");
+      }
+      size_t length = allocated_extent->second;
+      allocated_extents.erase(allocated_extent);
+
+      AddFreeExtent(offset, length);
+      data_file_spinlock.Unlock();
     } break;
 
     case BackendType::INVALID:
@@ -513,6 +808,37 @@ void BackendManager::Release(BackendType type, void *address) {
   }
 }
 
+void *BackendManager::Attach(BackendType type, uint64_t key, size_t &size) {
+  if (type != BackendType::SSD && type != BackendType::HDD) {
+    return nullptr;
+  }
+
+  data_file_spinlock.Lock();
+
+  if (data_file_address == nullptr) {
+    try {
+      OpenDataFile();
+    } catch (Exception &e) {
+      data_file_spinlock.Unlock();
+      throw;
+    }
+  }
+
+  auto attachable_extent = attachable_extents.find(key);
+  if (attachable_extent == attachable_extents.end()) {
+    data_file_spinlock.Unlock();
+    return nullptr;
+  }
+  size_t offset = attachable_extent->second;
+  attachable_extents.erase(attachable_extent);
+  size = allocated_extents[offset] - sizeof(ExtentHeader);
+
+  data_file_spinlock.Unlock();
+
+  return reinterpret_cast<char *>(data_file_address) + offset +
+         sizeof(ExtentHeader);
+}
+
 void BackendManager::Sync(BackendType type, void *address, size_t length) {
   switch (type) {
     case BackendType::MM: {
@@ -528,11 +854,24 @@ void BackendManager::Sync(BackendType type, void *address, size_t length) {
 
     case BackendType::SSD:
     case BackendType::HDD: {
-      // sync the mmap'ed file to SSD or HDD
-      int status = msync(data_file_address, data_file_len, MS_SYNC);
+      if (data_file_address == nullptr) {
+        return;
+      }
+
+      // sync the dirty pages of the range to SSD or HDD, or of the whole
+      // file if no range is given
+      static const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+      uintptr_t begin = reinterpret_cast<uintptr_t>(data_file_address);
+      uintptr_t end = begin + data_file_len;
+      if (address != nullptr) {
+        begin = reinterpret_cast<uintptr_t>(address) & ~(page_size - 1);
+        end = reinterpret_cast<uintptr_t>(address) + length;
+      }
+      int status =
+          msync(reinterpret_cast<void *>(begin), end - begin, MS_SYNC);
       if (status != 0) {
-        perror("msync");
-        exit(EXIT_FAILURE);
+        throw Exception("Could not sync data file " + data_file_name + " : " +
+                        strerror(errno));
       }
 
       msync_count++;
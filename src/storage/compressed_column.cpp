@@ -0,0 +1,288 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// compressed_column.cpp
+//
+// Identification: src/storage/compressed_column.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/compressed_column.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace peloton {
+namespace storage {
+
+CompressedColumn::CompressedColumn(type::TypeId type_id, size_t width,
+                                   const char *base, size_t stride,
+                                   size_t count)
+    : type_id_(type_id), width_(width), count_(count) {
+  PL_ASSERT(CanEncode(width_));
+
+  std::vector<uint64_t> keys(count_);
+  for (size_t slot = 0; slot < count_; slot++) {
+    keys[slot] = LoadKey(base + slot * stride);
+  }
+
+  // Gather what every encoding needs to know to size itself
+  std::vector<uint64_t> distinct_keys(keys);
+  std::sort(distinct_keys.begin(), distinct_keys.end());
+  distinct_keys.erase(std::unique(distinct_keys.begin(), distinct_keys.end()),
+                      distinct_keys.end());
+
+  size_t run_count = 0;
+  for (size_t slot = 0; slot < count_; slot++) {
+    if (slot == 0 || keys[slot] != keys[slot - 1]) run_count++;
+  }
+
+  if (count_ > 0) {
+    min_key_ = static_cast<int64_t>(keys[0]);
+    max_key_ = min_key_;
+  }
+  for (auto key : keys) {
+    min_key_ = std::min(min_key_, static_cast<int64_t>(key));
+    max_key_ = std::max(max_key_, static_cast<int64_t>(key));
+  }
+  uint64_t key_range =
+      static_cast<uint64_t>(max_key_) - static_cast<uint64_t>(min_key_);
+
+  auto packed_size = [this](uint32_t bit_width) {
+    return (count_ * bit_width + 63) / 64 * sizeof(uint64_t);
+  };
+  uint32_t code_width =
+      distinct_keys.empty() ? 0 : GetBitWidth(distinct_keys.size() - 1);
+  uint32_t offset_width = GetBitWidth(key_range);
+
+  size_t plain_size = count_ * width_;
+  size_t dictionary_size =
+      distinct_keys.size() * sizeof(uint64_t) + packed_size(code_width);
+  size_t run_length_size = run_count * (sizeof(uint64_t) + sizeof(oid_t));
+  size_t bit_packed_size = packed_size(offset_width);
+
+  size_t best_size = plain_size;
+  if (dictionary_size < best_size) {
+    encoding_ = Encoding::DICTIONARY;
+    best_size = dictionary_size;
+  }
+  if (run_length_size < best_size) {
+    encoding_ = Encoding::RUN_LENGTH;
+    best_size = run_length_size;
+  }
+  if (bit_packed_size < best_size) {
+    encoding_ = Encoding::BIT_PACKED;
+    best_size = bit_packed_size;
+  }
+
+  switch (encoding_) {
+    case Encoding::PLAIN: {
+      plain_.resize(count_ * width_);
+      for (size_t slot = 0; slot < count_; slot++) {
+        StoreKey(keys[slot], plain_.data() + slot * width_);
+      }
+      break;
+    }
+    case Encoding::DICTIONARY: {
+      for (auto &key : keys) {
+        key = std::lower_bound(distinct_keys.begin(), distinct_keys.end(),
+                               key) -
+              distinct_keys.begin();
+      }
+      keys_ = std::move(distinct_keys);
+      bit_width_ = code_width;
+      Pack(keys);
+      break;
+    }
+    case Encoding::RUN_LENGTH: {
+      for (size_t slot = 0; slot < count_; slot++) {
+        if (slot > 0 && keys[slot] == keys[slot - 1]) {
+          run_ends_.back() = slot + 1;
+          continue;
+        }
+        keys_.push_back(keys[slot]);
+        run_ends_.push_back(slot + 1);
+      }
+      break;
+    }
+    case Encoding::BIT_PACKED: {
+      for (auto &key : keys) {
+        key -= static_cast<uint64_t>(min_key_);
+      }
+      bit_width_ = offset_width;
+      Pack(keys);
+      break;
+    }
+  }
+}
+
+void CompressedColumn::Decode(oid_t slot, char *out) const {
+  PL_ASSERT(slot < count_);
+  if (encoding_ == Encoding::PLAIN) {
+    PL_MEMCPY(out, plain_.data() + slot * width_, width_);
+    return;
+  }
+  StoreKey(GetKey(slot), out);
+}
+
+void CompressedColumn::DecodeAll(char *out) const {
+  switch (encoding_) {
+    case Encoding::PLAIN: {
+      PL_MEMCPY(out, plain_.data(), plain_.size());
+      break;
+    }
+    case Encoding::RUN_LENGTH: {
+      oid_t slot = 0;
+      for (size_t run = 0; run < keys_.size(); run++) {
+        for (; slot < run_ends_[run]; slot++) {
+          StoreKey(keys_[run], out + slot * width_);
+        }
+      }
+      break;
+    }
+    case Encoding::DICTIONARY:
+    case Encoding::BIT_PACKED: {
+      for (oid_t slot = 0; slot < count_; slot++) {
+        StoreKey(GetKey(slot), out + slot * width_);
+      }
+      break;
+    }
+  }
+}
+
+bool CompressedColumn::MayContain(const char *value) const {
+  if (count_ == 0) return false;
+
+  uint64_t key = LoadKey(value);
+  auto signed_key = static_cast<int64_t>(key);
+  if (signed_key < min_key_ || signed_key > max_key_) {
+    return false;
+  }
+
+  switch (encoding_) {
+    case Encoding::DICTIONARY:
+      return std::binary_search(keys_.begin(), keys_.end(), key);
+    case Encoding::RUN_LENGTH:
+      return std::find(keys_.begin(), keys_.end(), key) != keys_.end();
+    case Encoding::PLAIN:
+    case Encoding::BIT_PACKED:
+      return true;
+  }
+  return true;
+}
+
+size_t CompressedColumn::GetSize() const {
+  return plain_.size() + keys_.size() * sizeof(uint64_t) +
+         run_ends_.size() * sizeof(oid_t) + packed_.size() * sizeof(uint64_t);
+}
+
+bool CompressedColumn::HasExactEncoding(type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::BOOLEAN:
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+    case type::TypeId::DATE:
+    case type::TypeId::TIMESTAMP:
+      return true;
+    default:
+      return false;
+  }
+}
+
+std::string CompressedColumn::EncodingToString(Encoding encoding) {
+  switch (encoding) {
+    case Encoding::PLAIN:
+      return "PLAIN";
+    case Encoding::DICTIONARY:
+      return "DICTIONARY";
+    case Encoding::RUN_LENGTH:
+      return "RUN_LENGTH";
+    case Encoding::BIT_PACKED:
+      return "BIT_PACKED";
+  }
+  return "INVALID";
+}
+
+uint64_t CompressedColumn::LoadKey(const char *value) const {
+  uint64_t key = 0;
+  PL_MEMCPY(&key, value, width_);
+
+  switch (type_id_) {
+    case type::TypeId::TINYINT:
+      return static_cast<uint64_t>(static_cast<int8_t>(key));
+    case type::TypeId::SMALLINT:
+      return static_cast<uint64_t>(static_cast<int16_t>(key));
+    case type::TypeId::INTEGER:
+      return static_cast<uint64_t>(static_cast<int32_t>(key));
+    default:
+      return key;
+  }
+}
+
+void CompressedColumn::StoreKey(uint64_t key, char *out) const {
+  // Truncating undoes the sign extension of LoadKey()
+  PL_MEMCPY(out, &key, width_);
+}
+
+uint64_t CompressedColumn::GetKey(oid_t slot) const {
+  switch (encoding_) {
+    case Encoding::PLAIN:
+      return LoadKey(plain_.data() + slot * width_);
+    case Encoding::DICTIONARY:
+      return keys_[GetPacked(slot)];
+    case Encoding::RUN_LENGTH: {
+      auto run = std::upper_bound(run_ends_.begin(), run_ends_.end(), slot) -
+                 run_ends_.begin();
+      return keys_[run];
+    }
+    case Encoding::BIT_PACKED:
+      return static_cast<uint64_t>(min_key_) + GetPacked(slot);
+  }
+  return 0;
+}
+
+uint32_t CompressedColumn::GetBitWidth(uint64_t max_value) {
+  if (max_value == 0) return 0;
+  return 64 - __builtin_clzll(max_value);
+}
+
+uint64_t CompressedColumn::GetPacked(oid_t slot) const {
+  if (bit_width_ == 0) return 0;
+
+  uint64_t bit = static_cast<uint64_t>(slot) * bit_width_;
+  size_t word = bit / 64;
+  uint32_t shift = bit % 64;
+
+  uint64_t value = packed_[word] >> shift;
+  if (shift + bit_width_ > 64) {
+    value |= packed_[word + 1] << (64 - shift);
+  }
+  if (bit_width_ < 64) {
+    value &= (1ull << bit_width_) - 1;
+  }
+  return value;
+}
+
+void CompressedColumn::Pack(const std::vector<uint64_t> &values) {
+  packed_.assign((values.size() * bit_width_ + 63) / 64, 0);
+  if (bit_width_ == 0) return;
+
+  for (size_t slot = 0; slot < values.size(); slot++) {
+    uint64_t bit = static_cast<uint64_t>(slot) * bit_width_;
+    size_t word = bit / 64;
+    uint32_t shift = bit % 64;
+
+    packed_[word] |= values[slot] << shift;
+    if (shift + bit_width_ > 64) {
+      packed_[word + 1] |= values[slot] >> (64 - shift);
+    }
+  }
+}
+
+}  // namespace storage
+}  // namespace peloton
@@ -10,6 +10,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <mutex>
 #include <utility>
 
@@ -18,9 +21,12 @@
 #include "catalog/foreign_key.h"
 #include "catalog/table_catalog.h"
 #include "catalog/trigger_catalog.h"
+#include "common/container_tuple.h"
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/numa_topology.h"
 #include "common/platform.h"
+#include "concurrency/epoch_manager_factory.h"
 #include "concurrency/transaction.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "gc/gc_manager_factory.h"
@@ -29,12 +35,15 @@
 #include "storage/abstract_table.h"
 #include "storage/data_table.h"
 #include "storage/database.h"
+#include "storage/materialized_view.h"
 #include "storage/storage_manager.h"
 #include "storage/tile.h"
 #include "storage/tile_group.h"
 #include "storage/tile_group_factory.h"
 #include "storage/tile_group_header.h"
+#include "storage/tile_group_preallocator.h"
 #include "storage/tuple.h"
+#include "threadpool/parallel_for.h"
 
 //===--------------------------------------------------------------------===//
 // Configuration Variables
@@ -53,6 +62,8 @@ oid_t DataTable::invalid_tile_group_id = -1;
 
 size_t DataTable::default_active_tilegroup_count_ = 1;
 size_t DataTable::default_active_indirection_array_count_ = 1;
+size_t DataTable::default_tile_group_reserve_count_ = 0;
+bool DataTable::default_numa_partitioning_ = false;
 
 DataTable::DataTable(catalog::Schema *schema, const std::string &table_name,
                      const oid_t &database_oid, const oid_t &table_oid,
@@ -76,6 +87,17 @@ DataTable::DataTable(catalog::Schema *schema, const std::string &table_name,
   } else {
     active_tilegroup_count_ = default_active_tilegroup_count_;
     active_indirection_array_count_ = default_active_indirection_array_count_;
+
+    // every node gets the same number of active tile groups
+    auto &numa_topology = NumaTopology::GetInstance();
+    if (default_numa_partitioning_ == true &&
+        numa_topology.IsEnabled() == true &&
+        numa_topology.GetNodeCount() > 1) {
+      numa_node_count_ = numa_topology.GetNodeCount();
+      active_tilegroup_count_ =
+          (active_tilegroup_count_ + numa_node_count_ - 1) / numa_node_count_ *
+          numa_node_count_;
+    }
   }
 
   active_tile_groups_.resize(active_tilegroup_count_);
@@ -90,9 +112,22 @@ DataTable::DataTable(catalog::Schema *schema, const std::string &table_name,
   for (size_t i = 0; i < active_indirection_array_count_; ++i) {
     AddDefaultIndirectionArray(i);
   }
+
+  // Keep spare tile groups around for rollover. Catalog tables are small and
+  // rarely written, so they do not get a reserve. Neither do tables
+  // partitioned by NUMA node, whose tile groups must be allocated on the node
+  // that uses them.
+  if (is_catalog == false && default_tile_group_reserve_count_ > 0 &&
+      numa_node_count_ == 1) {
+    tile_group_preallocator_.reset(
+        new TileGroupPreallocator(this, default_tile_group_reserve_count_));
+  }
 }
 
 DataTable::~DataTable() {
+  // stop the preallocator first, its thread calls back into the table
+  tile_group_preallocator_.reset();
+
   // clean up tile groups by dropping the references in the catalog
   auto &catalog_manager = catalog::Manager::GetInstance();
   auto tile_groups_size = tile_groups_.GetSize();
@@ -109,6 +144,11 @@ DataTable::~DataTable() {
     }
   }
 
+  // queries may still hold views over this table
+  for (auto &view : materialized_views_) {
+    view->Detach();
+  }
+
   // clean up foreign keys
   for (auto foreign_key : foreign_keys_) {
     delete foreign_key;
@@ -232,20 +272,27 @@ ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple,
 
   //=============== garbage collection==================
   // check if there are recycled tuple slots
-  auto &gc_manager = gc::GCManagerFactory::GetInstance();
-  auto free_item_pointer = gc_manager.ReturnFreeSlot(this->table_oid);
-  if (free_item_pointer.IsNull() == false) {
+  auto free_item_pointer = recycled_slot_allocator_.Allocate();
+  while (free_item_pointer.IsNull() == false) {
+    auto tile_group =
+        catalog::Manager::GetInstance().GetTileGroup(free_item_pointer.block);
+
+    // slots of retired tile groups are dropped so that they drain, and
+    // frozen tile groups are never written to again
+    if (tile_group->IsRetired() == true || tile_group->IsFrozen() == true) {
+      free_item_pointer = recycled_slot_allocator_.Allocate();
+      continue;
+    }
+
     // when inserting a tuple
     if (tuple != nullptr) {
-      auto tile_group =
-          catalog::Manager::GetInstance().GetTileGroup(free_item_pointer.block);
       tile_group->CopyTuple(tuple, free_item_pointer.offset);
     }
     return free_item_pointer;
   }
   //====================================================
 
-  size_t active_tile_group_id = number_of_tuples_ % active_tilegroup_count_;
+  size_t active_tile_group_id = GetActiveTileGroupId();
   std::shared_ptr<storage::TileGroup> tile_group;
   oid_t tuple_slot = INVALID_OID;
   oid_t tile_group_id = INVALID_OID;
@@ -410,29 +457,7 @@ bool DataTable::InsertInIndexes(const AbstractTuple *tuple,
                                 ItemPointer **index_entry_ptr) {
   int index_count = GetIndexCount();
 
-  size_t active_indirection_array_id =
-      number_of_tuples_ % active_indirection_array_count_;
-
-  size_t indirection_offset = INVALID_INDIRECTION_OFFSET;
-
-  while (true) {
-    auto active_indirection_array =
-        active_indirection_arrays_[active_indirection_array_id];
-    indirection_offset = active_indirection_array->AllocateIndirection();
-
-    if (indirection_offset != INVALID_INDIRECTION_OFFSET) {
-      *index_entry_ptr =
-          active_indirection_array->GetIndirectionByOffset(indirection_offset);
-      break;
-    }
-  }
-
-  (*index_entry_ptr)->block = location.block;
-  (*index_entry_ptr)->offset = location.offset;
-
-  if (indirection_offset == INDIRECTION_ARRAY_MAX_SIZE - 1) {
-    AddDefaultIndirectionArray(active_indirection_array_id);
-  }
+  *index_entry_ptr = AllocateIndirection(location);
 
   auto &transaction_manager =
       concurrency::TransactionManagerFactory::GetInstance();
@@ -484,6 +509,35 @@ bool DataTable::InsertInIndexes(const AbstractTuple *tuple,
   return true;
 }
 
+ItemPointer *DataTable::AllocateIndirection(const ItemPointer &location) {
+  size_t active_indirection_array_id =
+      number_of_tuples_ % active_indirection_array_count_;
+
+  size_t indirection_offset = INVALID_INDIRECTION_OFFSET;
+  ItemPointer *index_entry_ptr = nullptr;
+
+  while (true) {
+    auto active_indirection_array =
+        active_indirection_arrays_[active_indirection_array_id];
+    indirection_offset = active_indirection_array->AllocateIndirection();
+
+    if (indirection_offset != INVALID_INDIRECTION_OFFSET) {
+      index_entry_ptr =
+          active_indirection_array->GetIndirectionByOffset(indirection_offset);
+      break;
+    }
+  }
+
+  index_entry_ptr->block = location.block;
+  index_entry_ptr->offset = location.offset;
+
+  if (indirection_offset == INDIRECTION_ARRAY_MAX_SIZE - 1) {
+    AddDefaultIndirectionArray(active_indirection_array_id);
+  }
+
+  return index_entry_ptr;
+}
+
 bool DataTable::InsertInSecondaryIndexes(const AbstractTuple *tuple,
                                          const TargetList *targets_ptr,
                                          concurrency::Transaction *transaction,
@@ -663,6 +717,92 @@ bool DataTable::IsDirty() const { return dirty_; }
  */
 void DataTable::ResetDirty() { dirty_ = false; }
 
+//===--------------------------------------------------------------------===//
+// BULK LOAD
+//===--------------------------------------------------------------------===//
+
+std::shared_ptr<TileGroup> DataTable::NewBulkLoadTileGroup() {
+  return std::shared_ptr<TileGroup>(GetTileGroupWithLayout(
+      GetTileGroupLayout((LayoutType)peloton_layout_mode)));
+}
+
+bool DataTable::InsertTileGroup(const std::shared_ptr<TileGroup> &tile_group,
+                                concurrency::Transaction *transaction) {
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  oid_t tile_group_id = tile_group->GetTileGroupId();
+  oid_t tuple_count = tile_group->GetNextTupleSlot();
+
+  // It never becomes an active tile group, it is full already
+  catalog::Manager::GetInstance().AddTileGroup(tile_group_id, tile_group);
+  tile_groups_.Append(tile_group_id);
+
+  COMPILER_MEMORY_FENCE;
+
+  tile_group_count_++;
+
+  // The tuples become inserts of the transaction before the first of them
+  // goes into an index, so that unique indexes see duplicate keys within the
+  // tile group as occupied. Until then nobody can see them.
+  std::vector<ItemPointer *> index_entries(tuple_count);
+  for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    ItemPointer location(tile_group_id, tuple_itr);
+    index_entries[tuple_itr] = AllocateIndirection(location);
+    transaction_manager.PerformInsert(transaction, location,
+                                      index_entries[tuple_itr]);
+  }
+
+  std::function<bool(const void *)> fn =
+      std::bind(&concurrency::TransactionManager::IsOccupied,
+                &transaction_manager, transaction, std::placeholders::_1);
+
+  oid_t index_count = GetIndexCount();
+  std::atomic<bool> violated(false);
+  threadpool::ParallelFor(index_count, index_count, [&](size_t index_itr) {
+    auto index = GetIndex(index_itr);
+    if (index == nullptr) return;
+    auto index_schema = index->GetKeySchema();
+    auto indexed_columns = index_schema->GetIndexedColumns();
+    bool is_unique =
+        index->GetIndexType() == IndexConstraintType::PRIMARY_KEY ||
+        index->GetIndexType() == IndexConstraintType::UNIQUE;
+
+    // The index copies the key, so one key tuple does for all of them
+    storage::Tuple key(index_schema, true);
+    for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+      if (violated.load(std::memory_order_relaxed)) return;
+
+      ContainerTuple<TileGroup> tuple(tile_group.get(), tuple_itr);
+      key.SetFromTuple(&tuple, indexed_columns, index->GetPool());
+      if (is_unique) {
+        if (index->CondInsertEntry(&key, index_entries[tuple_itr], fn) ==
+            false) {
+          LOG_TRACE("Index constraint on %s violated",
+                    index->GetName().c_str());
+          violated.store(true, std::memory_order_relaxed);
+          return;
+        }
+      } else {
+        index->InsertEntry(&key, index_entries[tuple_itr]);
+      }
+    }
+  });
+  if (violated.load()) return false;
+
+  if (HasForeignKeys()) {
+    for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+      ContainerTuple<TileGroup> tuple(tile_group.get(), tuple_itr);
+      if (CheckForeignKeyConstraints(&tuple) == false) {
+        LOG_TRACE("ForeignKey constraint violated");
+        return false;
+      }
+    }
+  }
+
+  IncreaseTupleCount(tuple_count);
+  return true;
+}
+
 //===--------------------------------------------------------------------===//
 // TILE GROUP
 //===--------------------------------------------------------------------===//
@@ -676,6 +816,22 @@ TileGroup *DataTable::GetTileGroupWithLayout(
 
 oid_t DataTable::AddDefaultIndirectionArray(
     const size_t &active_indirection_array_id) {
+  std::shared_ptr<IndirectionArray> indirection_array;
+  if (tile_group_preallocator_ != nullptr) {
+    indirection_array = tile_group_preallocator_->TakeIndirectionArray();
+  }
+  if (indirection_array == nullptr) {
+    indirection_array = PrepareDefaultIndirectionArray();
+  }
+
+  COMPILER_MEMORY_FENCE;
+
+  active_indirection_arrays_[active_indirection_array_id] = indirection_array;
+
+  return indirection_array->GetOid();
+}
+
+std::shared_ptr<IndirectionArray> DataTable::PrepareDefaultIndirectionArray() {
   auto &manager = catalog::Manager::GetInstance();
   oid_t indirection_array_id = manager.GetNextIndirectionArrayId();
 
@@ -683,11 +839,7 @@ oid_t DataTable::AddDefaultIndirectionArray(
       new IndirectionArray(indirection_array_id));
   manager.AddIndirectionArray(indirection_array_id, indirection_array);
 
-  COMPILER_MEMORY_FENCE;
-
-  active_indirection_arrays_[active_indirection_array_id] = indirection_array;
-
-  return indirection_array_id;
+  return indirection_array;
 }
 
 oid_t DataTable::AddDefaultTileGroup() {
@@ -695,25 +847,45 @@ oid_t DataTable::AddDefaultTileGroup() {
   return AddDefaultTileGroup(active_tile_group_id);
 }
 
-oid_t DataTable::AddDefaultTileGroup(const size_t &active_tile_group_id) {
-  column_map_type column_map;
-  oid_t tile_group_id = INVALID_OID;
+size_t DataTable::GetActiveTileGroupId() const {
+  if (numa_node_count_ == 1) {
+    return number_of_tuples_ % active_tilegroup_count_;
+  }
 
-  // Figure out the partitioning for given tilegroup layout
-  column_map = GetTileGroupLayout((LayoutType)peloton_layout_mode);
+  int node = NumaTopology::GetInstance().GetCurrentNode();
+  if (node == NumaTopology::ANY_NODE) {
+    node = 0;
+  }
+  size_t node_tile_group_count = active_tilegroup_count_ / numa_node_count_;
+  return (node % numa_node_count_) * node_tile_group_count +
+         number_of_tuples_ % node_tile_group_count;
+}
 
-  // Create a tile group with that partitioning
-  std::shared_ptr<TileGroup> tile_group(GetTileGroupWithLayout(column_map));
-  PL_ASSERT(tile_group.get());
+oid_t DataTable::AddDefaultTileGroup(const size_t &active_tile_group_id) {
+  // Prefer a tile group that was allocated in the background, so that the
+  // inserter that filled up the active tile group does not have to wait
+  std::shared_ptr<TileGroup> tile_group;
+  if (tile_group_preallocator_ != nullptr) {
+    tile_group = tile_group_preallocator_->TakeTileGroup(
+        GetTileGroupLayout((LayoutType)peloton_layout_mode));
+  }
+  if (tile_group == nullptr) {
+    // place the tile group on the NUMA node of the active slot, which is not
+    // necessarily the node of the calling thread, e.g. in the constructor
+    size_t node_tile_group_count = active_tilegroup_count_ / numa_node_count_;
+    int node = (numa_node_count_ == 1)
+                   ? NumaTopology::ANY_NODE
+                   : static_cast<int>(active_tile_group_id /
+                                      node_tile_group_count);
+    NumaNodeScope numa_scope(node);
+    tile_group = PrepareDefaultTileGroup();
+  }
 
-  tile_group_id = tile_group->GetTileGroupId();
+  oid_t tile_group_id = tile_group->GetTileGroupId();
 
   LOG_TRACE("Added a tile group ");
   tile_groups_.Append(tile_group_id);
 
-  // add tile group metadata in locator
-  catalog::Manager::GetInstance().AddTileGroup(tile_group_id, tile_group);
-
   COMPILER_MEMORY_FENCE;
 
   active_tile_groups_[active_tile_group_id] = tile_group;
@@ -729,6 +901,22 @@ oid_t DataTable::AddDefaultTileGroup(const size_t &active_tile_group_id) {
   return tile_group_id;
 }
 
+std::shared_ptr<TileGroup> DataTable::PrepareDefaultTileGroup() {
+  // Figure out the partitioning for given tilegroup layout
+  column_map_type column_map =
+      GetTileGroupLayout((LayoutType)peloton_layout_mode);
+
+  // Create a tile group with that partitioning
+  std::shared_ptr<TileGroup> tile_group(GetTileGroupWithLayout(column_map));
+  PL_ASSERT(tile_group.get());
+
+  // add tile group metadata in locator
+  catalog::Manager::GetInstance().AddTileGroup(tile_group->GetTileGroupId(),
+                                               tile_group);
+
+  return tile_group;
+}
+
 void DataTable::AddTileGroupWithOidForRecovery(const oid_t &tile_group_id) {
   PL_ASSERT(tile_group_id);
 
@@ -993,6 +1181,50 @@ void DataTable::RemoveForeignKeySource(const std::string &source_table_name) {
   }
 }
 
+//===--------------------------------------------------------------------===//
+// MATERIALIZED VIEWS
+//===--------------------------------------------------------------------===//
+
+void DataTable::AddMaterializedView(std::shared_ptr<MaterializedView> view) {
+  std::lock_guard<std::mutex> lock(data_table_mutex_);
+  materialized_views_.push_back(view);
+  has_materialized_views_ = true;
+}
+
+bool DataTable::DropMaterializedView(const std::string &view_name) {
+  std::shared_ptr<MaterializedView> view;
+  {
+    std::lock_guard<std::mutex> lock(data_table_mutex_);
+    for (auto view_itr = materialized_views_.begin();
+         view_itr != materialized_views_.end(); view_itr++) {
+      if ((*view_itr)->GetName() == view_name) {
+        view = *view_itr;
+        materialized_views_.erase(view_itr);
+        break;
+      }
+    }
+    has_materialized_views_ = materialized_views_.empty() == false;
+  }
+  if (view == nullptr) return false;
+  view->Detach();
+  return true;
+}
+
+std::shared_ptr<MaterializedView> DataTable::GetMaterializedView(
+    const std::string &view_name) {
+  std::lock_guard<std::mutex> lock(data_table_mutex_);
+  for (auto &view : materialized_views_) {
+    if (view->GetName() == view_name) return view;
+  }
+  return nullptr;
+}
+
+std::vector<std::shared_ptr<MaterializedView>>
+DataTable::GetMaterializedViews() {
+  std::lock_guard<std::mutex> lock(data_table_mutex_);
+  return materialized_views_;
+}
+
 // Get the schema for the new transformed tile group
 std::vector<catalog::Schema> TransformTileGroupSchema(
     storage::TileGroup *tile_group, const column_map_type &column_map) {
@@ -1067,6 +1299,9 @@ void SetTransformedTileGroup(storage::TileGroup *orig_tile_group,
   auto header = orig_tile_group->GetHeader();
   auto new_header = new_tile_group->GetHeader();
   *new_header = *header;
+
+  // The columns were copied tile-at-a-time, so recompute the zone map
+  new_tile_group->RebuildZoneMap();
 }
 
 storage::TileGroup *DataTable::TransformTileGroup(
@@ -1114,6 +1349,257 @@ storage::TileGroup *DataTable::TransformTileGroup(
   return new_tile_group.get();
 }
 
+bool DataTable::ReorganizeTileGroup(const oid_t &tile_group_offset,
+                                    const double &theta,
+                                    const double &fill_threshold,
+                                    const uint64_t &cold_period) {
+  if (tile_group_offset >= tile_groups_.GetSize()) {
+    LOG_ERROR("Tile group offset not found in table : %u ", tile_group_offset);
+    return false;
+  }
+
+  FreeReleasedTileGroups();
+
+  auto tile_group = GetTileGroup(tile_group_offset);
+  if (tile_group == nullptr) {
+    return false;
+  }
+
+  // Only cold tile groups are reorganized. A tile group that still hands out
+  // fresh slots is one of the active tile groups.
+  auto tuple_count = tile_group->GetAllocatedTupleCount();
+  if (tile_group->GetNextTupleSlot() < tuple_count) {
+    return false;
+  }
+
+  // Count the latest versions, whether committed or in flight. Commit ids
+  // carry the epoch in their upper half, so they also tell how long ago the
+  // tile group was last written to.
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  eid_t current_epoch_id = epoch_manager.GetCurrentEpochId();
+  eid_t cold_epoch_count = cold_period / EPOCH_LENGTH;
+  auto tile_group_header = tile_group->GetHeader();
+  oid_t live_tuple_count = 0;
+  bool is_cold = true;
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    auto tuple_txn_id = tile_group_header->GetTransactionId(tuple_id);
+    if (tuple_txn_id == INVALID_TXN_ID) {
+      continue;
+    }
+    auto end_commit_id = tile_group_header->GetEndCommitId(tuple_id);
+    if (end_commit_id == MAX_CID) {
+      live_tuple_count++;
+    }
+    cid_t last_commit_id = end_commit_id != MAX_CID
+                               ? end_commit_id
+                               : tile_group_header->GetBeginCommitId(tuple_id);
+    if (tuple_txn_id != INITIAL_TXN_ID ||
+        (last_commit_id >> 32) + cold_epoch_count > current_epoch_id) {
+      is_cold = false;
+    }
+  }
+
+  // Once the live tuples are gone, a retired tile group only waits for its
+  // old versions to become unreachable. An empty tile group that is not
+  // retired is left alone so that GC can hand out its slots.
+  if (live_tuple_count == 0) {
+    if (tile_group->IsRetired() == true) {
+      ReleaseRetiredTileGroup(tile_group);
+    }
+    return false;
+  }
+
+  // A retired tile group that still has live tuples is drained regardless,
+  // they were skipped by an earlier pass because they were busy
+  if (tile_group->IsRetired() == false) {
+    if (is_cold == false) {
+      return false;
+    }
+    double fill_factor = live_tuple_count / static_cast<double>(tuple_count);
+    bool sparse = fill_factor < fill_threshold;
+    bool stale_layout =
+        tile_group->GetSchemaDifference(default_partition_) >= theta;
+    if (sparse == false && stale_layout == false) {
+      return false;
+    }
+  }
+
+  LOG_TRACE("Reorganizing tile group : %u with %u live tuples",
+            tile_group_offset, live_tuple_count);
+
+  // Retire the tile group first, so that the versions we acquire below never
+  // land in one of its recycled slots
+  bool was_retired = tile_group->IsRetired();
+  tile_group->SetRetired(true);
+
+  auto &catalog_manager = catalog::Manager::GetInstance();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto tile_group_id = tile_group->GetTileGroupId();
+  auto column_count = schema->GetColumnCount();
+  TargetList no_targets;
+  oid_t moved_tuple_count = 0;
+  bool success = true;
+
+  // Move every latest version the same way an update does. The new version
+  // takes over the indirection entry of the old one when the transaction
+  // commits, so index entries switch to the new location atomically and
+  // concurrent readers keep following the version chain.
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    auto tuple_txn_id = tile_group_header->GetTransactionId(tuple_id);
+    if (tuple_txn_id == INVALID_TXN_ID ||
+        tile_group_header->GetEndCommitId(tuple_id) != MAX_CID) {
+      continue;
+    }
+
+    // Owned by an in-flight transaction, or committed after we started. The
+    // tile group stays retired, so a later pass picks the tuple up.
+    if (tuple_txn_id != INITIAL_TXN_ID ||
+        txn_manager.IsVisible(txn, tile_group_header, tuple_id) !=
+            VisibilityType::OK ||
+        txn_manager.AcquireOwnership(txn, tile_group_header, tuple_id) ==
+            false) {
+      continue;
+    }
+
+    ItemPointer old_location(tile_group_id, tuple_id);
+    ItemPointer new_location = AcquireVersion();
+    if (new_location.IsNull() == true) {
+      txn_manager.YieldOwnership(txn, tile_group_header, tuple_id);
+      success = false;
+      break;
+    }
+
+    auto new_tile_group = catalog_manager.GetTileGroup(new_location.block);
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      auto value = tile_group->GetValue(tuple_id, column_itr);
+      new_tile_group->SetValue(value, new_location.offset, column_itr);
+    }
+
+    // No column changes, so none of the secondary indexes is touched
+    ContainerTuple<storage::TileGroup> new_tuple(new_tile_group.get(),
+                                                 new_location.offset);
+    ItemPointer *indirection = tile_group_header->GetIndirection(tuple_id);
+    if (InstallVersion(&new_tuple, &no_targets, txn, indirection) == false) {
+      txn_manager.YieldOwnership(txn, tile_group_header, tuple_id);
+      success = false;
+      break;
+    }
+
+    txn_manager.PerformUpdate(txn, old_location, new_location);
+    moved_tuple_count++;
+  }
+
+  if (success == true) {
+    success = txn_manager.CommitTransaction(txn) == ResultType::SUCCESS;
+  } else {
+    txn_manager.SetTransactionResult(txn, ResultType::FAILURE);
+    txn_manager.AbortTransaction(txn);
+  }
+
+  if (success == false || moved_tuple_count == 0) {
+    LOG_TRACE("Failed to reorganize tile group : %u", tile_group_offset);
+    tile_group->SetRetired(was_retired);
+    return false;
+  }
+
+  return moved_tuple_count == live_tuple_count;
+}
+
+void DataTable::ReleaseRetiredTileGroup(
+    const std::shared_ptr<storage::TileGroup> &tile_group) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+
+  // The GC holds on to the old versions until no transaction can reach them
+  // anymore and then resets their slots. Without GC, they are unreachable
+  // once every transaction that was around when the tile group drained is
+  // gone.
+  if (gc::GCManagerFactory::GetGCType() == GarbageCollectionType::ON) {
+    auto tile_group_header = tile_group->GetHeader();
+    auto tuple_count = tile_group->GetAllocatedTupleCount();
+    for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+      if (tile_group_header->GetTransactionId(tuple_id) != INVALID_TXN_ID) {
+        return;
+      }
+    }
+  } else if (tile_group->GetRetireEpochId() == 0) {
+    tile_group->SetRetireEpochId(epoch_manager.GetCurrentEpochId());
+    return;
+  } else if (epoch_manager.GetExpiredEpochId() <=
+             tile_group->GetRetireEpochId()) {
+    return;
+  }
+
+  LOG_TRACE("Releasing retired tile group : %u",
+            tile_group->GetTileGroupId());
+
+  // Scans address tile groups by offset, so the slot keeps a tile group
+  // without any tuples under the same id
+  std::shared_ptr<storage::TileGroup> empty_tile_group(
+      TileGroupFactory::GetTileGroup(
+          tile_group->GetDatabaseId(), tile_group->GetTableId(),
+          tile_group->GetTileGroupId(), tile_group->GetAbstractTable(),
+          tile_group->GetTileSchemas(), tile_group->GetColumnMap(), 1));
+  empty_tile_group->SetRetired(true);
+  catalog::Manager::GetInstance().AddTileGroup(tile_group->GetTileGroupId(),
+                                               empty_tile_group);
+
+  // Scans that fetched the tile group before the swap may still be reading
+  // it, they are gone once the current epoch has expired
+  std::lock_guard<std::mutex> lock(released_tile_groups_mutex_);
+  released_tile_groups_.emplace_back(epoch_manager.GetCurrentEpochId(),
+                                     tile_group);
+}
+
+void DataTable::FreeReleasedTileGroups() {
+  auto expired_epoch_id =
+      concurrency::EpochManagerFactory::GetInstance().GetExpiredEpochId();
+
+  std::lock_guard<std::mutex> lock(released_tile_groups_mutex_);
+  auto released_itr = released_tile_groups_.begin();
+  while (released_itr != released_tile_groups_.end()) {
+    if (released_itr->first < expired_epoch_id) {
+      released_itr = released_tile_groups_.erase(released_itr);
+    } else {
+      released_itr++;
+    }
+  }
+}
+
+bool DataTable::FreezeTileGroup(const oid_t &tile_group_offset,
+                                const uint64_t &quiet_period) {
+  if (tile_group_offset >= tile_groups_.GetSize()) {
+    LOG_ERROR("Tile group offset not found in table : %u ", tile_group_offset);
+    return false;
+  }
+
+  auto tile_group = GetTileGroup(tile_group_offset);
+  if (tile_group == nullptr || tile_group->IsRetired() == true) {
+    return false;
+  }
+
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+
+  // Readers that started before the tile group was frozen may still be
+  // reading the uncompressed tiles until their epoch has expired
+  if (tile_group->IsFrozen() == true) {
+    if (tile_group->HasUncompressedData() == true &&
+        epoch_manager.GetExpiredEpochId() > tile_group->GetFreezeEpochId()) {
+      LOG_TRACE("Releasing uncompressed tiles of tile group : %u",
+                tile_group_offset);
+      tile_group->ReleaseUncompressedData();
+    }
+    return false;
+  }
+
+  if (tile_group->GetQuietPeriod() < quiet_period) {
+    return false;
+  }
+
+  LOG_TRACE("Freezing tile group : %u", tile_group_offset);
+  return tile_group->Freeze(epoch_manager.GetCurrentEpochId());
+}
+
 void DataTable::RecordLayoutSample(const brain::Sample &sample) {
   // Add layout sample
   {
@@ -1176,6 +1662,12 @@ std::map<oid_t, oid_t> DataTable::GetColumnMapStats() {
   return column_map_stats;
 }
 
+void DataTable::SetTileGroupReserveCount(
+    const size_t tile_group_reserve_count) {
+  default_tile_group_reserve_count_ = std::min(
+      tile_group_reserve_count, TileGroupPreallocator::max_reserve_count);
+}
+
 void DataTable::SetDefaultLayout(const column_map_type &layout) {
   default_partition_ = layout;
 }
@@ -15,6 +15,7 @@
 #include "catalog/foreign_key.h"
 #include "common/exception.h"
 #include "common/logger.h"
+#include "container/epoch_reclaimer.h"
 #include "gc/gc_manager_factory.h"
 #include "index/index.h"
 #include "storage/database.h"
@@ -86,14 +87,15 @@ void Database::DropTableWithOid(const oid_t table_oid) {
     oid_t table_offset = 0;
     for (auto table : tables) {
       if (table->GetOid() == table_oid) {
-        delete table;
         break;
       }
       table_offset++;
     }
     PL_ASSERT(table_offset < tables.size());
 
-    // Drop the table
+    // Drop the table. Threads that looked it up before might still be using
+    // it, so it is freed once they have left their epoch.
+    EpochReclaimer::GetInstance().Retire(tables[table_offset]);
     tables.erase(tables.begin() + table_offset);
   }
 }
@@ -0,0 +1,538 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// materialized_view.cpp
+//
+// Identification: src/storage/materialized_view.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/materialized_view.h"
+
+#include <algorithm>
+#include <exception>
+#include <sstream>
+
+#include "catalog/schema.h"
+#include "common/container_tuple.h"
+#include "common/exception.h"
+#include "common/logger.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/transaction.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace storage {
+
+std::atomic<size_t> MaterializedView::view_count_(0);
+
+MaterializedView::MaterializedView(
+    const std::string &view_name, DataTable *table,
+    const std::vector<oid_t> &group_column_ids,
+    const std::vector<MaterializedViewAggregate> &aggregates,
+    eid_t attach_epoch_id)
+    : view_name_(view_name),
+      table_(table),
+      group_column_ids_(group_column_ids),
+      aggregates_(aggregates),
+      attach_epoch_id_(attach_epoch_id) {
+  auto schema = table_->GetSchema();
+  for (auto column_id : group_column_ids_) {
+    group_types_.push_back(schema->GetType(column_id));
+  }
+  for (auto &aggregate : aggregates_) {
+    aggregate_types_.push_back(aggregate.column_id == INVALID_OID
+                                   ? type::TypeId::BIGINT
+                                   : schema->GetType(aggregate.column_id));
+  }
+  view_count_++;
+}
+
+MaterializedView::~MaterializedView() { view_count_--; }
+
+oid_t MaterializedView::GetAggregateOffset(ExpressionType aggregate_type,
+                                           oid_t column_id) const {
+  for (oid_t agg_itr = 0; agg_itr < aggregates_.size(); agg_itr++) {
+    auto &aggregate = aggregates_[agg_itr];
+    if (aggregate.column_id != column_id) continue;
+    auto kept_type = aggregate.aggregate_type;
+    switch (aggregate_type) {
+      // Every aggregate counts the values of its column
+      case ExpressionType::AGGREGATE_COUNT:
+      case ExpressionType::AGGREGATE_COUNT_STAR:
+        return agg_itr;
+      case ExpressionType::AGGREGATE_SUM:
+      case ExpressionType::AGGREGATE_AVG:
+        if (kept_type == ExpressionType::AGGREGATE_SUM ||
+            kept_type == ExpressionType::AGGREGATE_AVG) {
+          return agg_itr;
+        }
+        break;
+      default:
+        if (kept_type == aggregate_type) return agg_itr;
+        break;
+    }
+  }
+  return INVALID_OID;
+}
+
+bool MaterializedView::IsUsable() const {
+  if (detached_) return false;
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  return epoch_manager.GetExpiredEpochId() > attach_epoch_id_;
+}
+
+std::vector<type::Value> MaterializedView::GetGroupKey(
+    const AbstractTuple *tuple) const {
+  std::vector<type::Value> key;
+  key.reserve(group_column_ids_.size());
+  for (auto column_id : group_column_ids_) {
+    key.push_back(tuple->GetValue(column_id).Copy());
+  }
+  return key;
+}
+
+std::vector<type::Value> MaterializedView::GetAggregateValues(
+    const AbstractTuple *tuple) const {
+  std::vector<type::Value> values;
+  values.reserve(aggregates_.size());
+  for (auto &aggregate : aggregates_) {
+    if (aggregate.column_id == INVALID_OID) {
+      values.push_back(type::Value());
+    } else {
+      values.push_back(tuple->GetValue(aggregate.column_id).Copy());
+    }
+  }
+  return values;
+}
+
+bool MaterializedView::CanRead(concurrency::Transaction *txn) {
+  auto isolation_level = txn->GetIsolationLevel();
+  if (isolation_level != IsolationLevelType::READ_COMMITTED &&
+      isolation_level != IsolationLevelType::SNAPSHOT &&
+      isolation_level != IsolationLevelType::READ_ONLY) {
+    return false;
+  }
+  for (auto &tile_group_entry : txn->GetReadWriteSet()) {
+    for (auto &tuple_entry : tile_group_entry.second) {
+      if (tuple_entry.second != RWType::READ &&
+          tuple_entry.second != RWType::READ_OWN) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+//===--------------------------------------------------------------------===//
+// Maintenance
+//===--------------------------------------------------------------------===//
+
+void MaterializedView::Lock(cid_t commit_id) {
+  std::unique_lock<std::mutex> lock(view_mutex_);
+  rebuild_cv_.wait(lock, [&] {
+    return rebuilding_ == false || commit_id > rebuild_cid_;
+  });
+  maintained_cid_ = std::max(maintained_cid_, commit_id);
+  // Held until Unlock()
+  lock.release();
+}
+
+bool MaterializedView::AddToGroup(
+    GroupMap &groups, const std::vector<type::Value> &key,
+    const std::vector<type::Value> &values) const {
+  try {
+    auto &group = groups[key];
+    if (group.row_count++ == 0) {
+      group.aggregates.resize(aggregates_.size());
+    }
+
+    for (size_t agg_itr = 0; agg_itr < aggregates_.size(); agg_itr++) {
+      auto &aggregate = aggregates_[agg_itr];
+      if (aggregate.column_id == INVALID_OID) continue;
+      auto &value = values[agg_itr];
+      if (value.IsNull()) continue;
+
+      auto &state = group.aggregates[agg_itr];
+      if (aggregate.aggregate_type == ExpressionType::AGGREGATE_COUNT) {
+        state.count++;
+        continue;
+      }
+      if (state.count++ == 0) {
+        state.value = value.Copy();
+        continue;
+      }
+
+      switch (aggregate.aggregate_type) {
+        case ExpressionType::AGGREGATE_SUM:
+        case ExpressionType::AGGREGATE_AVG:
+          state.value = state.value.Add(value);
+          break;
+        case ExpressionType::AGGREGATE_MIN:
+          if (value.CompareLessThan(state.value) == type::CMP_TRUE) {
+            state.value = value.Copy();
+          }
+          break;
+        case ExpressionType::AGGREGATE_MAX:
+          if (value.CompareGreaterThan(state.value) == type::CMP_TRUE) {
+            state.value = value.Copy();
+          }
+          break;
+        default:
+          break;
+      }
+    }
+  } catch (Exception &e) {
+    // A sum out of range of its type. Let the readers run into it.
+    LOG_DEBUG("Materialized view %s goes stale: %s", view_name_.c_str(),
+              e.what());
+    return false;
+  }
+  return true;
+}
+
+bool MaterializedView::RemoveFromGroup(
+    GroupMap &groups, const std::vector<type::Value> &key,
+    const std::vector<type::Value> &values) const {
+  try {
+    auto group_itr = groups.find(key);
+    if (group_itr == groups.end()) {
+      // A version the view never counted
+      return false;
+    }
+
+    auto &group = group_itr->second;
+    if (--group.row_count == 0) {
+      groups.erase(group_itr);
+      return true;
+    }
+
+    bool is_valid = true;
+    for (size_t agg_itr = 0; agg_itr < aggregates_.size(); agg_itr++) {
+      auto &aggregate = aggregates_[agg_itr];
+      if (aggregate.column_id == INVALID_OID) continue;
+      auto &value = values[agg_itr];
+      if (value.IsNull()) continue;
+
+      auto &state = group.aggregates[agg_itr];
+      if (--state.count == 0) {
+        state.value = type::Value();
+        continue;
+      }
+
+      switch (aggregate.aggregate_type) {
+        case ExpressionType::AGGREGATE_SUM:
+        case ExpressionType::AGGREGATE_AVG:
+          state.value = state.value.Subtract(value);
+          break;
+        case ExpressionType::AGGREGATE_MIN:
+        case ExpressionType::AGGREGATE_MAX:
+          // The next extreme value is only known to the table
+          if (value.CompareEquals(state.value) == type::CMP_TRUE) {
+            is_valid = false;
+          }
+          break;
+        default:
+          break;
+      }
+    }
+    return is_valid;
+  } catch (Exception &e) {
+    LOG_DEBUG("Materialized view %s goes stale: %s", view_name_.c_str(),
+              e.what());
+    return false;
+  }
+}
+
+void MaterializedView::ApplyInsert(const AbstractTuple *tuple) {
+  // Tuples committed before the view is built get picked up by the scan
+  bool is_current = populated_ && stale_ == false;
+  if (detached_ || (is_current == false && rebuilding_ == false)) return;
+
+  auto key = GetGroupKey(tuple);
+  auto values = GetAggregateValues(tuple);
+  if (rebuilding_) {
+    pending_.push_back(Delta{true, key, values});
+  }
+  if (is_current && AddToGroup(groups_, key, values) == false) {
+    stale_ = true;
+  }
+}
+
+void MaterializedView::ApplyDelete(const AbstractTuple *tuple) {
+  bool is_current = populated_ && stale_ == false;
+  if (detached_ || (is_current == false && rebuilding_ == false)) return;
+
+  auto key = GetGroupKey(tuple);
+  auto values = GetAggregateValues(tuple);
+  if (rebuilding_) {
+    pending_.push_back(Delta{false, key, values});
+  }
+  if (is_current && RemoveFromGroup(groups_, key, values) == false) {
+    stale_ = true;
+  }
+}
+
+void MaterializedView::Refresh() {
+  std::unique_lock<std::mutex> lock(view_mutex_);
+  rebuild_cv_.wait(lock, [this] { return rebuilding_ == false; });
+  RebuildGroups(lock);
+}
+
+void MaterializedView::Detach() {
+  std::lock_guard<std::mutex> lock(view_mutex_);
+  detached_ = true;
+  groups_.clear();
+}
+
+void MaterializedView::Validate(std::unique_lock<std::mutex> &lock) {
+  while ((populated_ == false || stale_) && detached_ == false) {
+    if (rebuilding_) {
+      rebuild_cv_.wait(lock, [this] { return rebuilding_ == false; });
+    } else {
+      RebuildGroups(lock);
+    }
+  }
+}
+
+bool MaterializedView::BuildGroups(concurrency::Transaction *txn,
+                                   GroupMap &groups) const {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  oid_t tile_group_count = table_->GetTileGroupCount();
+  for (oid_t tile_group_offset = 0; tile_group_offset < tile_group_count;
+       tile_group_offset++) {
+    auto tile_group = table_->GetTileGroup(tile_group_offset);
+    auto tile_group_header = tile_group->GetHeader();
+    oid_t active_tuple_count = tile_group->GetNextTupleSlot();
+    for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+      if (txn_manager.IsVisible(txn, tile_group_header, tuple_id) !=
+          VisibilityType::OK) {
+        continue;
+      }
+      ContainerTuple<TileGroup> tuple(tile_group.get(), tuple_id);
+      if (AddToGroup(groups, GetGroupKey(&tuple),
+                     GetAggregateValues(&tuple)) == false) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void MaterializedView::RebuildGroups(std::unique_lock<std::mutex> &lock) {
+  PL_ASSERT(rebuilding_ == false);
+  if (detached_) {
+    groups_.clear();
+    populated_ = true;
+    stale_ = false;
+    return;
+  }
+
+  LOG_TRACE("Rebuilding materialized view %s", view_name_.c_str());
+
+  // No transaction is committing while we hold the latch. Those that began
+  // before the scan transaction wait in Lock() until the scan is done, those
+  // that began after cannot be seen by it and go to pending_.
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  rebuilding_ = true;
+  rebuild_cid_ = txn->GetCommitId();
+  pending_.clear();
+  lock.unlock();
+
+  GroupMap groups;
+  bool is_in_range = false;
+  std::exception_ptr error;
+  try {
+    is_in_range = BuildGroups(txn, groups);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  txn_manager.CommitTransaction(txn);
+
+  lock.lock();
+  bool is_current = true;
+  for (auto &delta : pending_) {
+    is_current = delta.is_insert
+                     ? AddToGroup(groups, delta.key, delta.values)
+                     : RemoveFromGroup(groups, delta.key, delta.values);
+    if (is_current == false) break;
+  }
+  pending_.clear();
+  rebuilding_ = false;
+  rebuild_cv_.notify_all();
+  maintained_cid_ = std::max(maintained_cid_, rebuild_cid_);
+
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+  populated_ = true;
+  if (detached_) {
+    return;
+  }
+  if (is_in_range == false) {
+    groups_.clear();
+    stale_ = true;
+    throw Exception(EXCEPTION_TYPE_OUT_OF_RANGE,
+                    "Aggregate out of range in materialized view " +
+                        view_name_);
+  }
+
+  // A change applied late can leave the groups stale again, the next
+  // reader then rebuilds them once more
+  groups_.swap(groups);
+  stale_ = is_current == false;
+}
+
+//===--------------------------------------------------------------------===//
+// Reading
+//===--------------------------------------------------------------------===//
+
+type::Value MaterializedView::GetValue(
+    const std::vector<type::Value> &key, const Group &group,
+    const MaterializedViewColumn &column) const {
+  if (column.aggregate_type == ExpressionType::INVALID) {
+    return key[column.offset];
+  }
+  if (column.aggregate_type == ExpressionType::AGGREGATE_COUNT_STAR) {
+    return type::ValueFactory::GetBigIntValue(group.row_count);
+  }
+
+  auto &state = group.aggregates[column.offset];
+  switch (column.aggregate_type) {
+    case ExpressionType::AGGREGATE_COUNT:
+      return type::ValueFactory::GetBigIntValue(state.count);
+    case ExpressionType::AGGREGATE_AVG:
+      if (state.count == 0) {
+        return type::ValueFactory::GetNullValueByType(type::TypeId::DECIMAL);
+      }
+      return state.value.Divide(type::ValueFactory::GetDecimalValue(
+          static_cast<double>(state.count)));
+    default:
+      if (state.count == 0) {
+        return type::ValueFactory::GetNullValueByType(
+            aggregate_types_[column.offset]);
+      }
+      return state.value;
+  }
+}
+
+std::vector<std::vector<type::Value>> MaterializedView::GetRows(
+    const std::vector<MaterializedViewColumn> &columns,
+    const std::vector<oid_t> &key_offsets,
+    const std::vector<type::Value> &key_values) {
+  std::unique_lock<std::mutex> lock(view_mutex_);
+  Validate(lock);
+  return ReadRows(groups_, columns, key_offsets, key_values);
+}
+
+std::vector<std::vector<type::Value>> MaterializedView::GetRows(
+    concurrency::Transaction *txn,
+    const std::vector<MaterializedViewColumn> &columns,
+    const std::vector<oid_t> &key_offsets,
+    const std::vector<type::Value> &key_values) {
+  PL_ASSERT(CanRead(txn));
+  std::unique_lock<std::mutex> lock(view_mutex_);
+  Validate(lock);
+  auto isolation_level = txn->GetIsolationLevel();
+  if (isolation_level == IsolationLevelType::READ_COMMITTED ||
+      maintained_cid_ <= txn->GetReadId()) {
+    return ReadRows(groups_, columns, key_offsets, key_values);
+  }
+  // A commit after the snapshot is in the groups already
+  lock.unlock();
+  return ScanRows(txn, columns, key_offsets, key_values);
+}
+
+std::vector<std::vector<type::Value>> MaterializedView::ScanRows(
+    concurrency::Transaction *txn,
+    const std::vector<MaterializedViewColumn> &columns,
+    const std::vector<oid_t> &key_offsets,
+    const std::vector<type::Value> &key_values) const {
+  PL_ASSERT(detached_ == false);
+  GroupMap groups;
+  if (BuildGroups(txn, groups) == false) {
+    throw Exception(EXCEPTION_TYPE_OUT_OF_RANGE,
+                    "Aggregate out of range in materialized view " +
+                        view_name_);
+  }
+  return ReadRows(groups, columns, key_offsets, key_values);
+}
+
+std::vector<std::vector<type::Value>> MaterializedView::ReadRows(
+    const GroupMap &groups, const std::vector<MaterializedViewColumn> &columns,
+    const std::vector<oid_t> &key_offsets,
+    const std::vector<type::Value> &key_values) const {
+  PL_ASSERT(key_offsets.size() == key_values.size());
+  std::vector<std::vector<type::Value>> rows;
+  auto add_row = [&](const std::vector<type::Value> &key, const Group &group) {
+    std::vector<type::Value> row;
+    row.reserve(columns.size());
+    for (auto &column : columns) {
+      row.push_back(GetValue(key, group, column));
+    }
+    rows.push_back(std::move(row));
+  };
+
+  // Look the group up if the whole key is given in order and by type
+  bool is_lookup = key_offsets.size() == group_column_ids_.size();
+  for (oid_t key_itr = 0; is_lookup && key_itr < key_offsets.size();
+       key_itr++) {
+    is_lookup = key_offsets[key_itr] == key_itr &&
+                key_values[key_itr].GetTypeId() == group_types_[key_itr] &&
+                key_values[key_itr].IsNull() == false;
+  }
+  if (is_lookup) {
+    auto group_itr = groups.find(key_values);
+    if (group_itr != groups.end()) {
+      add_row(group_itr->first, group_itr->second);
+    }
+    return rows;
+  }
+
+  for (auto &entry : groups) {
+    bool matches = true;
+    for (oid_t key_itr = 0; matches && key_itr < key_offsets.size();
+         key_itr++) {
+      matches = entry.first[key_offsets[key_itr]].CompareEquals(
+                    key_values[key_itr]) == type::CMP_TRUE;
+    }
+    if (matches) add_row(entry.first, entry.second);
+  }
+  return rows;
+}
+
+size_t MaterializedView::GetGroupCount() {
+  std::lock_guard<std::mutex> lock(view_mutex_);
+  return groups_.size();
+}
+
+const std::string MaterializedView::GetInfo() const {
+  std::ostringstream os;
+  os << "MaterializedView[" << view_name_ << " on "
+     << (detached_ ? "(dropped)" : table_->GetName()) << ", group by";
+  for (auto column_id : group_column_ids_) {
+    os << " " << column_id;
+  }
+  for (auto &aggregate : aggregates_) {
+    os << ", " << ExpressionTypeToString(aggregate.aggregate_type, true) << "(";
+    if (aggregate.column_id == INVALID_OID) {
+      os << "*";
+    } else {
+      os << aggregate.column_id;
+    }
+    os << ")";
+  }
+  os << "]";
+  return os.str();
+}
+
+}  // namespace storage
+}  // namespace peloton
@@ -0,0 +1,304 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// partition_scheme.cpp
+//
+// Identification: src/storage/partition_scheme.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/partition_scheme.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "common/macros.h"
+#include "expression/abstract_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/parameter_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "storage/zone_map.h"
+
+namespace peloton {
+namespace storage {
+
+namespace {
+
+bool IsIntegerType(type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// The value of an integer of any width
+int64_t GetInteger(const type::Value &value) {
+  switch (value.GetTypeId()) {
+    case type::TypeId::TINYINT:
+      return value.GetAs<int8_t>();
+    case type::TypeId::SMALLINT:
+      return value.GetAs<int16_t>();
+    case type::TypeId::INTEGER:
+      return value.GetAs<int32_t>();
+    default:
+      return value.GetAs<int64_t>();
+  }
+}
+
+// Spread the bits of a hash over all of them, so that its low bits alone
+// still split sequential keys evenly (the finalizer of MurmurHash3)
+uint64_t MixHash(uint64_t hash) {
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb93fe53a85a3ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+// Resolve a constant or parameter expression into a value. Returns false if
+// the expression is neither or the parameter cannot be resolved.
+bool ResolveValue(const expression::AbstractExpression *expr,
+                  const std::vector<type::Value> *params, type::Value &value) {
+  switch (expr->GetExpressionType()) {
+    case ExpressionType::VALUE_CONSTANT:
+      value = static_cast<const expression::ConstantValueExpression *>(expr)
+                  ->GetValue();
+      return true;
+    case ExpressionType::VALUE_PARAMETER: {
+      if (params == nullptr) return false;
+      auto idx = static_cast<size_t>(
+          static_cast<const expression::ParameterValueExpression *>(expr)
+              ->GetValueIdx());
+      if (idx >= params->size()) return false;
+      value = (*params)[idx];
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+// The partitions still candidates, in increasing order
+std::vector<oid_t> GetPartitions(const std::vector<bool> &candidates) {
+  std::vector<oid_t> partitions;
+  for (oid_t partition_itr = 0; partition_itr < candidates.size();
+       partition_itr++) {
+    if (candidates[partition_itr]) partitions.push_back(partition_itr);
+  }
+  return partitions;
+}
+
+}  // namespace
+
+PartitionScheme::PartitionScheme(oid_t column_id, type::TypeId key_type,
+                                 size_t partition_count)
+    : partition_type_(PartitionType::HASH),
+      column_id_(column_id),
+      key_type_(key_type),
+      partition_count_(partition_count) {
+  PL_ASSERT(partition_count_ > 0);
+}
+
+PartitionScheme::PartitionScheme(oid_t column_id,
+                                 const std::vector<type::Value> &bounds)
+    : partition_type_(PartitionType::RANGE),
+      column_id_(column_id),
+      key_type_(bounds.empty() ? type::TypeId::INVALID
+                               : bounds.front().GetTypeId()),
+      partition_count_(bounds.size() + 1) {
+  for (auto &bound : bounds) {
+    PL_ASSERT(bound.IsNull() == false);
+    PL_ASSERT(bounds_.empty() ||
+              bounds_.back().CompareLessThan(bound) == type::CMP_TRUE);
+    bounds_.push_back(bound.Copy());
+  }
+}
+
+oid_t PartitionScheme::GetPartition(const type::Value &key) const {
+  if (partition_count_ == 1 || key.IsNull()) return 0;
+
+  if (partition_type_ == PartitionType::HASH) {
+    uint64_t hash = IsIntegerType(key.GetTypeId()) ? GetInteger(key)
+                                                   : key.Hash();
+    return MixHash(hash) % partition_count_;
+  }
+
+  // The number of bounds at or below the key
+  size_t low = 0, high = bounds_.size();
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    if (bounds_[mid].CompareLessThanEquals(key) == type::CMP_TRUE) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+bool PartitionScheme::IsRoutable(type::TypeId type_id) const {
+  if (type_id == key_type_) return true;
+  if (IsIntegerType(type_id) && IsIntegerType(key_type_)) return true;
+  // Bounds compare with any number, hashes only with integers
+  return partition_type_ == PartitionType::RANGE &&
+         (IsIntegerType(type_id) || type_id == type::TypeId::DECIMAL) &&
+         (IsIntegerType(key_type_) || key_type_ == type::TypeId::DECIMAL);
+}
+
+void PartitionScheme::Restrict(ExpressionType comparison,
+                               const type::Value &value,
+                               std::vector<bool> &candidates) const {
+  // Only NULL keys, which all are in the first partition
+  if (comparison == ExpressionType::OPERATOR_IS_NULL) {
+    std::fill(candidates.begin() + 1, candidates.end(), false);
+    return;
+  }
+
+  // Comparisons against NULL never evaluate to true
+  if (value.IsNull()) {
+    std::fill(candidates.begin(), candidates.end(), false);
+    return;
+  }
+
+  if (IsRoutable(value.GetTypeId()) == false) return;
+
+  oid_t partition = GetPartition(value);
+  oid_t first = 0, last = partition_count_ - 1;
+  switch (comparison) {
+    case ExpressionType::COMPARE_EQUAL:
+      first = last = partition;
+      break;
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      if (partition_type_ == PartitionType::HASH) return;
+      last = partition;
+      // All keys of a partition starting at the value are not below it
+      if (comparison == ExpressionType::COMPARE_LESSTHAN && partition > 0 &&
+          bounds_[partition - 1].CompareEquals(value) == type::CMP_TRUE) {
+        last--;
+      }
+      break;
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      if (partition_type_ == PartitionType::HASH) return;
+      first = partition;
+      break;
+    default:
+      return;
+  }
+
+  for (oid_t partition_itr = 0; partition_itr < partition_count_;
+       partition_itr++) {
+    if (partition_itr < first || partition_itr > last) {
+      candidates[partition_itr] = false;
+    }
+  }
+}
+
+void PartitionScheme::RestrictToList(const std::vector<type::Value> &values,
+                                     std::vector<bool> &candidates) const {
+  std::vector<bool> listed(partition_count_, false);
+  for (auto &value : values) {
+    // A NULL in the list matches nothing
+    if (value.IsNull()) continue;
+    if (IsRoutable(value.GetTypeId()) == false) return;
+    listed[GetPartition(value)] = true;
+  }
+  for (oid_t partition_itr = 0; partition_itr < partition_count_;
+       partition_itr++) {
+    candidates[partition_itr] = candidates[partition_itr] &&
+                                listed[partition_itr];
+  }
+}
+
+void PartitionScheme::ExtractLists(
+    const expression::AbstractExpression *expr,
+    const std::vector<type::Value> *params,
+    std::vector<std::vector<type::Value>> &lists) const {
+  if (expr == nullptr) return;
+
+  auto expr_type = expr->GetExpressionType();
+  if (expr_type == ExpressionType::CONJUNCTION_AND) {
+    for (size_t child_itr = 0; child_itr < expr->GetChildrenSize();
+         child_itr++) {
+      ExtractLists(expr->GetChild(child_itr), params, lists);
+    }
+    return;
+  }
+  if (expr_type != ExpressionType::COMPARE_IN ||
+      expr->GetChildrenSize() < 2) {
+    return;
+  }
+
+  auto *key = expr->GetChild(0);
+  if (key->GetExpressionType() != ExpressionType::VALUE_TUPLE) return;
+  auto *tve = static_cast<const expression::TupleValueExpression *>(key);
+  if (tve->GetTupleId() != 0 || tve->GetColumnId() != (int)column_id_) {
+    return;
+  }
+
+  std::vector<type::Value> values;
+  for (size_t child_itr = 1; child_itr < expr->GetChildrenSize();
+       child_itr++) {
+    type::Value value;
+    if (ResolveValue(expr->GetChild(child_itr), params, value) == false) {
+      return;
+    }
+    values.push_back(value);
+  }
+  lists.push_back(std::move(values));
+}
+
+std::vector<oid_t> PartitionScheme::Prune(
+    const std::vector<ZoneMapPredicate> &predicates) const {
+  std::vector<bool> candidates(partition_count_, true);
+  for (auto &predicate : predicates) {
+    if (predicate.column_id != column_id_) continue;
+    Restrict(predicate.comparison, predicate.value, candidates);
+  }
+  return GetPartitions(candidates);
+}
+
+std::vector<oid_t> PartitionScheme::Prune(
+    const expression::AbstractExpression *predicate,
+    const std::vector<type::Value> *params) const {
+  std::vector<ZoneMapPredicate> predicates;
+  ZoneMap::ExtractPredicates(predicate, params, predicates);
+  std::vector<std::vector<type::Value>> lists;
+  ExtractLists(predicate, params, lists);
+
+  std::vector<bool> candidates(partition_count_, true);
+  for (auto &predicate : predicates) {
+    if (predicate.column_id != column_id_) continue;
+    Restrict(predicate.comparison, predicate.value, candidates);
+  }
+  for (auto &list : lists) {
+    RestrictToList(list, candidates);
+  }
+  return GetPartitions(candidates);
+}
+
+const std::string PartitionScheme::GetInfo() const {
+  std::ostringstream os;
+  os << "PartitionScheme["
+     << (partition_type_ == PartitionType::HASH ? "HASH" : "RANGE")
+     << " on column " << column_id_ << ", " << partition_count_
+     << " partitions";
+  for (auto &bound : bounds_) {
+    os << ", " << bound.ToString();
+  }
+  os << "]";
+  return os.str();
+}
+
+}  // namespace storage
+}  // namespace peloton
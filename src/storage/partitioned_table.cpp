@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// partitioned_table.cpp
+//
+// Identification: src/storage/partitioned_table.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/partitioned_table.h"
+
+#include <sstream>
+
+#include "catalog/schema.h"
+#include "common/macros.h"
+#include "index/index_factory.h"
+#include "storage/data_table.h"
+#include "storage/tuple.h"
+
+namespace peloton {
+namespace storage {
+
+PartitionedTable::PartitionedTable(const std::string &table_name,
+                                   PartitionScheme *scheme,
+                                   const std::vector<DataTable *> &partitions,
+                                   bool own_partitions)
+    : table_name_(table_name),
+      scheme_(scheme),
+      partitions_(partitions),
+      own_partitions_(own_partitions) {
+  PL_ASSERT(partitions_.size() == scheme_->GetPartitionCount());
+}
+
+PartitionedTable::~PartitionedTable() {
+  if (own_partitions_) {
+    for (auto partition : partitions_) {
+      delete partition;
+    }
+  }
+}
+
+catalog::Schema *PartitionedTable::GetSchema() const {
+  return partitions_.front()->GetSchema();
+}
+
+ItemPointer PartitionedTable::InsertTuple(
+    const Tuple *tuple, concurrency::Transaction *transaction,
+    ItemPointer **index_entry_ptr) {
+  return GetPartitionForTuple(tuple)->InsertTuple(tuple, transaction,
+                                                  index_entry_ptr);
+}
+
+void PartitionedTable::AddIndex(const std::string &index_name,
+                                oid_t index_oid, IndexType index_type,
+                                IndexConstraintType constraint_type,
+                                const std::vector<oid_t> &key_attrs,
+                                bool unique_keys) {
+  for (auto partition : partitions_) {
+    auto tuple_schema = partition->GetSchema();
+    catalog::Schema *key_schema =
+        catalog::Schema::CopySchema(tuple_schema, key_attrs);
+    key_schema->SetIndexedColumns(key_attrs);
+
+    index::IndexMetadata *index_metadata = new index::IndexMetadata(
+        index_name, index_oid, partition->GetOid(),
+        partition->GetDatabaseOid(), index_type, constraint_type,
+        tuple_schema, key_schema, key_attrs, unique_keys);
+
+    std::shared_ptr<index::Index> index(
+        index::IndexFactory::GetIndex(index_metadata));
+    partition->AddIndex(index);
+  }
+}
+
+size_t PartitionedTable::GetTupleCount() const {
+  size_t tuple_count = 0;
+  for (auto partition : partitions_) {
+    tuple_count += partition->GetTupleCount();
+  }
+  return tuple_count;
+}
+
+const std::string PartitionedTable::GetInfo() const {
+  std::ostringstream os;
+  os << "PartitionedTable[" << table_name_ << ", " << scheme_->GetInfo();
+  for (auto partition : partitions_) {
+    os << ", " << partition->GetName() << " (" << partition->GetOid() << ")";
+  }
+  os << "]";
+  return os.str();
+}
+
+}  // namespace storage
+}  // namespace peloton
@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// recycled_slot_allocator.cpp
+//
+// Identification: src/storage/recycled_slot_allocator.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/recycled_slot_allocator.h"
+
+#include <functional>
+#include <thread>
+
+namespace peloton {
+namespace storage {
+
+// Shard an inserter tries first. Threads start on different shards, and
+// stay on the one they last took a slot from. Only a hint, shared by all
+// tables.
+static size_t &GetPreferredShard() {
+  static thread_local size_t preferred_shard =
+      std::hash<std::thread::id>()(std::this_thread::get_id());
+  return preferred_shard;
+}
+
+void RecycledSlotAllocator::Recycle(const oid_t tile_group_id,
+                                    const std::vector<oid_t> &offsets) {
+  if (offsets.empty() == true) {
+    return;
+  }
+
+  auto &shard = shards_[tile_group_id % SHARD_COUNT];
+  shard.lock.Lock();
+  for (auto offset : offsets) {
+    shard.slots.emplace_back(tile_group_id, offset);
+  }
+  shard.slot_count.store(shard.slots.size(), std::memory_order_relaxed);
+  shard.lock.Unlock();
+
+  slot_count_.fetch_add(offsets.size(), std::memory_order_relaxed);
+}
+
+ItemPointer RecycledSlotAllocator::Allocate() {
+  if (slot_count_.load(std::memory_order_relaxed) == 0) {
+    return INVALID_ITEMPOINTER;
+  }
+
+  auto &preferred_shard = GetPreferredShard();
+  for (size_t shard_itr = 0; shard_itr < SHARD_COUNT; shard_itr++) {
+    size_t shard_id = (preferred_shard + shard_itr) % SHARD_COUNT;
+    auto &shard = shards_[shard_id];
+    if (shard.slot_count.load(std::memory_order_relaxed) == 0) {
+      continue;
+    }
+
+    ItemPointer location;
+    shard.lock.Lock();
+    if (shard.slots.empty() == false) {
+      location = shard.slots.back();
+      shard.slots.pop_back();
+      shard.slot_count.store(shard.slots.size(), std::memory_order_relaxed);
+    }
+    shard.lock.Unlock();
+
+    if (location.IsNull() == false) {
+      slot_count_.fetch_sub(1, std::memory_order_relaxed);
+      preferred_shard = shard_id;
+      return location;
+    }
+  }
+
+  return INVALID_ITEMPOINTER;
+}
+
+}  // namespace storage
+}  // namespace peloton
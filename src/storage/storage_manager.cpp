@@ -12,6 +12,7 @@
 
 #include "storage/storage_manager.h"
 
+#include "container/epoch_reclaimer.h"
 #include "storage/database.h"
 #include "storage/data_table.h"
 
@@ -105,7 +106,8 @@ void StorageManager::DestroyDatabases() {
 bool StorageManager::RemoveDatabaseFromStorageManager(oid_t database_oid) {
   for (auto it = databases_.begin(); it != databases_.end(); ++it) {
     if ((*it)->GetOid() == database_oid) {
-      delete (*it);
+      // Freed once no thread can be using the database anymore
+      EpochReclaimer::GetInstance().Retire(*it);
       databases_.erase(it);
       return true;
     }
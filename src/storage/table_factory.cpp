@@ -12,6 +12,7 @@
 
 #include "storage/table_factory.h"
 
+#include "catalog/schema.h"
 #include "common/exception.h"
 #include "storage/data_table.h"
 #include "storage/storage_manager.h"
@@ -34,6 +35,23 @@ DataTable *TableFactory::GetDataTable(oid_t database_id, oid_t relation_id,
   return table;
 }
 
+PartitionedTable *TableFactory::GetPartitionedTable(
+    oid_t database_id, oid_t first_table_id, const catalog::Schema *schema,
+    std::string table_name, size_t tuples_per_tilegroup_count,
+    PartitionScheme *scheme, bool own_partitions) {
+  std::vector<DataTable *> partitions;
+  for (oid_t partition_itr = 0; partition_itr < scheme->GetPartitionCount();
+       partition_itr++) {
+    partitions.push_back(GetDataTable(
+        database_id, first_table_id + partition_itr,
+        catalog::Schema::CopySchema(schema),
+        table_name + "_" + std::to_string(partition_itr),
+        tuples_per_tilegroup_count, true, false));
+  }
+
+  return new PartitionedTable(table_name, scheme, partitions, own_partitions);
+}
+
 TempTable *TableFactory::GetTempTable(catalog::Schema *schema,
                                       bool own_schema) {
   TempTable *table = new TempTable(INVALID_OID, schema, own_schema);
@@ -21,6 +21,8 @@
 #include "type/ephemeral_pool.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "storage/backend_manager.h"
+#include "storage/backend_pool.h"
+#include "storage/compressed_column.h"
 #include "storage/tile.h"
 #include "storage/tile_group_header.h"
 #include "storage/tuple.h"
@@ -53,29 +55,31 @@ Tile::Tile(BackendType backend_type, TileGroupHeader *tile_header,
   tile_size = tuple_count * tuple_length;
 
   // allocate tuple storage space for inlined data
-  // auto &storage_manager = storage::StorageManager::GetInstance();
-  // data = reinterpret_cast<char *>(
-  // storage_manager.Allocate(backend_type, tile_size));
-
-  data = new char[tile_size];
+  auto &backend_manager = storage::BackendManager::GetInstance();
+  data = reinterpret_cast<char *>(
+      backend_manager.Allocate(backend_type, tile_size));
   PL_ASSERT(data != NULL);
 
   // zero out the data
   PL_MEMSET(data, 0, tile_size);
 
-  // allocate pool for blob storage if schema not inlined
+  // allocate pool for blob storage if schema not inlined, on the backend
+  // of the tile so that varlen data is not left in memory
   // if (schema.IsInlined() == false) {
-  pool = new type::EphemeralPool();
+  if (backend_type == BackendType::SSD || backend_type == BackendType::HDD) {
+    pool = new storage::BackendPool(backend_type);
+  } else {
+    pool = new type::EphemeralPool();
+  }
   //}
 }
 
 Tile::~Tile() {
   // reclaim the tile memory (INLINED data)
-  // auto &storage_manager = storage::StorageManager::GetInstance();
-  // storage_manager.Release(backend_type, data);
-
-  delete[] data;
-  data = NULL;
+  if (data != nullptr) {
+    storage::BackendManager::GetInstance().Release(backend_type, data);
+    data = nullptr;
+  }
 
   // reclaim the tile memory (UNINLINED data)
   // if (schema.IsInlined() == false) {
@@ -98,6 +102,7 @@ Tile::~Tile() {
  */
 void Tile::InsertTuple(const oid_t tuple_offset, Tuple *tuple) {
   PL_ASSERT(tuple_offset < GetAllocatedTupleCount());
+  PL_ASSERT(IsFrozen() == false);
 
   // Find slot location
   char *location = tuple_offset * tuple_length + data;
@@ -116,8 +121,9 @@ type::Value Tile::GetValue(const oid_t tuple_offset, const oid_t column_id) {
 
   const type::TypeId column_type = schema.GetType(column_id);
 
-  const char *tuple_location = GetTupleLocation(tuple_offset);
-  const char *field_location = tuple_location + schema.GetOffset(column_id);
+  alignas(uint64_t) char buffer[sizeof(uint64_t)];
+  const char *field_location =
+      GetFieldLocation(tuple_offset, column_id, buffer);
   const bool is_inlined = schema.IsInlined(column_id);
 
   return type::Value::DeserializeFrom(field_location, column_type, is_inlined);
@@ -135,12 +141,31 @@ type::Value Tile::GetValueFast(const oid_t tuple_offset,
   PL_ASSERT(tuple_offset < GetAllocatedTupleCount());
   PL_ASSERT(column_offset < schema.GetLength());
 
+  // Frozen tiles are read by column id, which is rare enough to look up
+  if (IsFrozen() == true) {
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      if (schema.GetOffset(column_itr) == column_offset) {
+        return GetValue(tuple_offset, column_itr);
+      }
+    }
+    PL_ASSERT(false);
+  }
+
   const char *tuple_location = GetTupleLocation(tuple_offset);
   const char *field_location = tuple_location + column_offset;
 
   return type::Value::DeserializeFrom(field_location, column_type, is_inlined);
 }
 
+const char *Tile::GetFieldLocation(const oid_t tuple_offset,
+                                   const oid_t column_id, char *buffer) const {
+  if (IsFrozen() == true) {
+    compressed_columns[column_id]->Decode(tuple_offset, buffer);
+    return buffer;
+  }
+  return GetTupleLocation(tuple_offset) + schema.GetOffset(column_id);
+}
+
 /**
  * Sets value at tuple slot.
  */
@@ -149,6 +174,7 @@ void Tile::SetValue(const type::Value &value, const oid_t tuple_offset,
                     const oid_t column_id) {
   PL_ASSERT(tuple_offset < num_tuple_slots);
   PL_ASSERT(column_id < schema.GetColumnCount());
+  PL_ASSERT(IsFrozen() == false);
 
   char *tuple_location = GetTupleLocation(tuple_offset);
   char *field_location = tuple_location + schema.GetOffset(column_id);
@@ -177,6 +203,7 @@ void Tile::SetValueFast(const type::Value &value, const oid_t tuple_offset,
                         UNUSED_ATTRIBUTE const size_t column_length) {
   PL_ASSERT(tuple_offset < num_tuple_slots);
   PL_ASSERT(column_offset < schema.GetLength());
+  PL_ASSERT(IsFrozen() == false);
 
   char *tuple_location = GetTupleLocation(tuple_offset);
   char *field_location = tuple_location + column_offset;
@@ -197,6 +224,19 @@ Tile *Tile::CopyTile(BackendType backend_type) {
       backend_type, INVALID_OID, INVALID_OID, INVALID_OID, INVALID_OID,
       new_header, *schema, tile_group, allocated_tuple_count);
 
+  // A frozen tile may have released its slots, so the copy is thawed value
+  // by value
+  if (IsFrozen() == true) {
+    for (oid_t tuple_itr = 0; tuple_itr < allocated_tuple_count;
+         tuple_itr++) {
+      for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+        new_tile->SetValue(GetValue(tuple_itr, column_itr), tuple_itr,
+                           column_itr);
+      }
+    }
+    return new_tile;
+  }
+
   PL_MEMCPY(static_cast<void *>(new_tile->data), static_cast<void *>(data),
             tile_size);
 
@@ -221,6 +261,54 @@ Tile *Tile::CopyTile(BackendType backend_type) {
   return new_tile;
 }
 
+//===--------------------------------------------------------------------===//
+// Compression
+//===--------------------------------------------------------------------===//
+
+bool Tile::Freeze() {
+  if (IsFrozen() == true) return false;
+
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    if (CompressedColumn::CanEncode(schema.GetLength(column_itr)) == false) {
+      return false;
+    }
+  }
+
+  std::vector<std::unique_ptr<CompressedColumn>> columns;
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    columns.emplace_back(new CompressedColumn(
+        schema.GetType(column_itr), schema.GetLength(column_itr),
+        data + schema.GetOffset(column_itr), tuple_length, num_tuple_slots));
+  }
+
+  // Readers switch over once the columns are complete
+  compressed_columns = std::move(columns);
+  frozen.store(true);
+  return true;
+}
+
+void Tile::ReleaseUncompressedData() {
+  PL_ASSERT(IsFrozen() == true);
+  storage::BackendManager::GetInstance().Release(backend_type, data);
+  data = nullptr;
+}
+
+const CompressedColumn *Tile::GetCompressedColumn(
+    const oid_t column_id) const {
+  if (IsFrozen() == false) return nullptr;
+  return compressed_columns[column_id].get();
+}
+
+size_t Tile::GetCompressedSize() const {
+  size_t compressed_size = 0;
+  if (IsFrozen() == true) {
+    for (auto &column : compressed_columns) {
+      compressed_size += column->GetSize();
+    }
+  }
+  return compressed_size;
+}
+
 //===--------------------------------------------------------------------===//
 // Utilities
 //===--------------------------------------------------------------------===//
@@ -233,6 +321,17 @@ const std::string Tile::GetInfo() const {
   os << "Table[" << table_id << "] // ";
   os << "TileGroup[" << tile_group_id << "]" << std::endl;
 
+  // The slots of a frozen tile may be gone, so only describe its columns
+  if (IsFrozen() == true) {
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      auto column = compressed_columns[column_itr].get();
+      os << "Column[" << column_itr << "] "
+         << CompressedColumn::EncodingToString(column->GetEncoding()) << " ("
+         << column->GetSize() << " bytes)" << std::endl;
+    }
+    return os.str();
+  }
+
   // Tuples
   os << GETINFO_SINGLE_LINE << std::endl;
 
@@ -455,6 +554,7 @@ void Tile::DeserializeTuplesFromWithoutHeader(SerializeInput &input,
 
   // First, check if we have required space
   PL_ASSERT(tuple_count <= num_tuple_slots);
+  PL_ASSERT(IsFrozen() == false);
   storage::Tuple *temp_tuple = new storage::Tuple(&schema, true);
 
   for (oid_t tuple_itr = 0; tuple_itr < tuple_count; ++tuple_itr) {
@@ -479,8 +579,10 @@ oid_t Tile::GetActiveTupleCount() const {
 
 void Tile::Sync() {
   // Sync the tile data
-  // auto &storage_manager = storage::StorageManager::GetInstance();
-  // storage_manager.Sync(backend_type, data, tile_size);
+  if (data != nullptr) {
+    auto &backend_manager = storage::BackendManager::GetInstance();
+    backend_manager.Sync(backend_type, data, tile_size);
+  }
 }
 
 //===--------------------------------------------------------------------===//
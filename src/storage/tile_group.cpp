@@ -20,9 +20,11 @@
 #include "common/platform.h"
 #include "type/types.h"
 #include "storage/abstract_table.h"
+#include "storage/compressed_column.h"
 #include "storage/tile.h"
 #include "storage/tile_group_header.h"
 #include "storage/tuple.h"
+#include "storage/zone_map.h"
 
 namespace peloton {
 namespace storage {
@@ -53,6 +55,8 @@ TileGroup::TileGroup(BackendType backend_type,
     // Add a reference to the tile in the tile group
     tiles.push_back(tile);
   }
+
+  zone_map.reset(new ZoneMap(tile_schemas, column_map));
 }
 
 TileGroup::~TileGroup() {
@@ -112,6 +116,7 @@ void TileGroup::CopyTuple(const Tuple *tuple, const oid_t &tuple_slot_id) {
 
     storage::Tile *tile = GetTile(tile_itr);
     PL_ASSERT(tile);
+    PL_ASSERT(tile->IsFrozen() == false);
     char *tile_tuple_location = tile->GetTupleLocation(tuple_slot_id);
     PL_ASSERT(tile_tuple_location);
 
@@ -125,6 +130,8 @@ void TileGroup::CopyTuple(const Tuple *tuple, const oid_t &tuple_slot_id) {
       column_itr++;
     }
   }
+
+  zone_map->UpdateWithTuple(tuple);
 }
 
 /**
@@ -195,6 +202,7 @@ oid_t TileGroup::InsertTupleFromRecovery(cid_t commit_id, oid_t tuple_slot_id,
 
     storage::Tile *tile = GetTile(tile_itr);
     PL_ASSERT(tile);
+    PL_ASSERT(tile->IsFrozen() == false);
     char *tile_tuple_location = tile->GetTupleLocation(tuple_slot_id);
     PL_ASSERT(tile_tuple_location);
 
@@ -209,6 +217,8 @@ oid_t TileGroup::InsertTupleFromRecovery(cid_t commit_id, oid_t tuple_slot_id,
     }
   }
 
+  zone_map->UpdateWithTuple(tuple);
+
   // Set MVCC info
   tile_group_header->SetTransactionId(tuple_slot_id, INITIAL_TXN_ID);
   tile_group_header->SetBeginCommitId(tuple_slot_id, commit_id);
@@ -295,6 +305,7 @@ oid_t TileGroup::InsertTupleFromCheckpoint(oid_t tuple_slot_id,
 
     storage::Tile *tile = GetTile(tile_itr);
     PL_ASSERT(tile);
+    PL_ASSERT(tile->IsFrozen() == false);
     char *tile_tuple_location = tile->GetTupleLocation(tuple_slot_id);
     PL_ASSERT(tile_tuple_location);
 
@@ -309,6 +320,8 @@ oid_t TileGroup::InsertTupleFromCheckpoint(oid_t tuple_slot_id,
     }
   }
 
+  zone_map->UpdateWithTuple(tuple);
+
   // Set MVCC info
   tile_group_header->SetTransactionId(tuple_slot_id, INITIAL_TXN_ID);
   tile_group_header->SetBeginCommitId(tuple_slot_id, commit_id);
@@ -343,6 +356,122 @@ void TileGroup::SetValue(type::Value &value, oid_t tuple_id,
   oid_t tile_column_id, tile_offset;
   LocateTileAndColumn(column_id, tile_offset, tile_column_id);
   GetTile(tile_offset)->SetValue(value, tuple_id, tile_column_id);
+  zone_map->UpdateWithValue(column_id, value);
+}
+
+void TileGroup::UpdateZoneMap(const oid_t &tuple_slot_id) {
+  PL_ASSERT(tuple_slot_id < num_tuple_slots);
+  ContainerTuple<TileGroup> tuple(this, tuple_slot_id);
+  zone_map->UpdateWithTuple(&tuple);
+}
+
+void TileGroup::RebuildZoneMap() { zone_map->Rebuild(this); }
+
+bool TileGroup::Freeze(const eid_t &epoch_id) {
+  if (IsFrozen() == true) return false;
+
+  // Stop handing out recycled slots before checking that no slot can still
+  // be written to, so a slot that is recycled after the check stays unused
+  frozen.store(true);
+
+  bool writable = GetNextTupleSlot() < num_tuple_slots;
+  for (oid_t tuple_id = 0; tuple_id < num_tuple_slots && writable == false;
+       tuple_id++) {
+    if (tile_group_header->GetTransactionId(tuple_id) != INITIAL_TXN_ID) {
+      writable = true;
+    }
+  }
+
+  if (writable == true) {
+    frozen.store(false);
+    return false;
+  }
+
+  for (auto &tile : tiles) {
+    if (tile->Freeze() == false) {
+      LOG_TRACE("Tile %u of tile group %u stays uncompressed",
+                tile->GetTileId(), tile_group_id);
+    }
+  }
+
+  freeze_epoch_id = epoch_id;
+  return true;
+}
+
+void TileGroup::ReleaseUncompressedData() {
+  PL_ASSERT(IsFrozen() == true);
+  for (auto &tile : tiles) {
+    if (tile->IsFrozen() == true && tile->HasUncompressedData() == true) {
+      tile->ReleaseUncompressedData();
+    }
+  }
+}
+
+bool TileGroup::HasUncompressedData() const {
+  for (auto &tile : tiles) {
+    if (tile->HasUncompressedData() == true) return true;
+  }
+  return false;
+}
+
+size_t TileGroup::GetCompressedSize() const {
+  size_t compressed_size = 0;
+  for (auto &tile : tiles) {
+    compressed_size += tile->GetCompressedSize();
+  }
+  return compressed_size;
+}
+
+uint64_t TileGroup::GetQuietPeriod() {
+  uint64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::steady_clock::now().time_since_epoch())
+                     .count();
+  auto version = zone_map->GetVersion();
+
+  if (quiet_since == 0 || version != quiet_version) {
+    quiet_version = version;
+    quiet_since = now;
+    return 0;
+  }
+  return now - quiet_since;
+}
+
+bool TileGroup::ShouldScan(const ZoneMapPredicate *predicates,
+                           size_t num_predicates) const {
+  if (zone_map->ShouldScan(predicates, num_predicates) == false) {
+    return false;
+  }
+  if (IsFrozen() == false) {
+    return true;
+  }
+
+  // An equality predicate rules the tile group out if the value is missing
+  // from the dictionary or the runs of its column
+  for (size_t predicate_itr = 0; predicate_itr < num_predicates;
+       predicate_itr++) {
+    auto &predicate = predicates[predicate_itr];
+    if (predicate.comparison != ExpressionType::COMPARE_EQUAL ||
+        predicate.value.IsNull() ||
+        column_map.count(predicate.column_id) == 0) {
+      continue;
+    }
+
+    oid_t tile_offset, tile_column_offset;
+    LocateTileAndColumn(predicate.column_id, tile_offset, tile_column_offset);
+    auto column = GetTile(tile_offset)->GetCompressedColumn(tile_column_offset);
+    auto column_type = tile_schemas[tile_offset].GetType(tile_column_offset);
+    if (column == nullptr || predicate.value.GetTypeId() != column_type ||
+        CompressedColumn::HasExactEncoding(column_type) == false) {
+      continue;
+    }
+
+    alignas(uint64_t) char buffer[sizeof(uint64_t)];
+    predicate.value.SerializeTo(buffer, true, nullptr);
+    if (column->MayContain(buffer) == false) {
+      return false;
+    }
+  }
+  return true;
 }
 
 
@@ -377,6 +506,7 @@ void TileGroup::Sync() {
   for (auto tile : tiles) {
     tile->Sync();
   }
+  tile_group_header->Sync();
 }
 
 //===--------------------------------------------------------------------===//
@@ -24,13 +24,14 @@ extern peloton::LoggingType peloton_logging_mode;
 namespace peloton {
 namespace storage {
 
+BackendType TileGroupFactory::backend_type_ = BackendType::MM;
+
 TileGroup *TileGroupFactory::GetTileGroup(
     oid_t database_id, oid_t table_id, oid_t tile_group_id,
     AbstractTable *table, const std::vector<catalog::Schema> &schemas,
     const column_map_type &column_map, int tuple_count) {
   // Allocate the data on appropriate backend
-  BackendType backend_type = BackendType::MM;
-      // logging::LoggingUtil::GetBackendType(peloton_logging_mode);
+  BackendType backend_type = backend_type_;
 
   TileGroupHeader *tile_header = new TileGroupHeader(backend_type, tuple_count);
   TileGroup *tile_group = new TileGroup(backend_type, tile_header, table,
@@ -0,0 +1,235 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_preallocator.cpp
+//
+// Identification: src/storage/tile_group_preallocator.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/tile_group_preallocator.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <thread>
+
+#include "catalog/manager.h"
+#include "common/logger.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+
+namespace peloton {
+namespace storage {
+
+//===--------------------------------------------------------------------===//
+// Tile Group Refiller
+//===--------------------------------------------------------------------===//
+
+/**
+ * The one background thread refilling the reserves of all tables, in the
+ * order they ran low.
+ */
+class TileGroupRefiller {
+ public:
+  // Never destroyed, so that tables destroyed at exit can still remove
+  // themselves
+  static TileGroupRefiller &GetInstance() {
+    static TileGroupRefiller *refiller = new TileGroupRefiller();
+    return *refiller;
+  }
+
+  void Enqueue(TileGroupPreallocator *preallocator) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (std::find(queue_.begin(), queue_.end(), preallocator) !=
+        queue_.end()) {
+      return;
+    }
+    queue_.push_back(preallocator);
+
+    if (refill_thread_.joinable() == false) {
+      refill_thread_ = std::thread(&TileGroupRefiller::Run, this);
+      return;
+    }
+    refill_cv_.notify_one();
+  }
+
+  // Forget a preallocator, waiting for a refill of it in progress
+  void Remove(TileGroupPreallocator *preallocator) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    queue_.erase(std::remove(queue_.begin(), queue_.end(), preallocator),
+                 queue_.end());
+    done_cv_.wait(lock, [&] { return refilling_ != preallocator; });
+  }
+
+ private:
+  TileGroupRefiller() = default;
+
+  void Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      if (queue_.empty()) {
+        refill_cv_.wait(lock);
+        continue;
+      }
+
+      refilling_ = queue_.front();
+      queue_.pop_front();
+
+      // Do the expensive allocation without blocking the other tables
+      lock.unlock();
+      refilling_->Refill();
+      lock.lock();
+
+      refilling_ = nullptr;
+      done_cv_.notify_all();
+    }
+  }
+
+ private:
+  std::deque<TileGroupPreallocator *> queue_;
+
+  // The preallocator being refilled, not in the queue
+  TileGroupPreallocator *refilling_ = nullptr;
+
+  std::mutex mutex_;
+  std::condition_variable refill_cv_;
+  std::condition_variable done_cv_;
+  std::thread refill_thread_;
+};
+
+//===--------------------------------------------------------------------===//
+// Tile Group Preallocator
+//===--------------------------------------------------------------------===//
+
+const size_t TileGroupPreallocator::max_reserve_count;
+
+TileGroupPreallocator::TileGroupPreallocator(DataTable *table,
+                                             size_t reserve_count)
+    : table_(table), reserve_count_(reserve_count) {
+  PL_ASSERT(reserve_count_ > 0 && reserve_count_ <= max_reserve_count);
+}
+
+TileGroupPreallocator::~TileGroupPreallocator() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  TileGroupRefiller::GetInstance().Remove(this);
+
+  // Whatever is still in reserve was never handed out to the table
+  auto &catalog_manager = catalog::Manager::GetInstance();
+  for (auto &tile_group : tile_groups_) {
+    catalog_manager.DropTileGroup(tile_group->GetTileGroupId());
+  }
+  for (auto &indirection_array : indirection_arrays_) {
+    catalog_manager.DropIndirectionArray(indirection_array->GetOid());
+  }
+}
+
+std::shared_ptr<TileGroup> TileGroupPreallocator::TakeTileGroup(
+    const column_map_type &layout) {
+  std::shared_ptr<TileGroup> tile_group;
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (tile_groups_.empty() == false &&
+      tile_groups_.front()->GetColumnMap() != layout) {
+    LOG_TRACE("Discarding reserved tile groups of table %u with old layout",
+              table_->GetOid());
+    DiscardTileGroups();
+  }
+
+  if (tile_groups_.empty() == false) {
+    tile_group = std::move(tile_groups_.front());
+    tile_groups_.pop_front();
+    tile_group_hits_++;
+  } else {
+    tile_group_misses_++;
+    LOG_TRACE("Tile group reserve of table %u is empty", table_->GetOid());
+  }
+
+  RequestRefill();
+  return tile_group;
+}
+
+std::shared_ptr<IndirectionArray>
+TileGroupPreallocator::TakeIndirectionArray() {
+  std::shared_ptr<IndirectionArray> indirection_array;
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (indirection_arrays_.empty() == false) {
+    indirection_array = std::move(indirection_arrays_.front());
+    indirection_arrays_.pop_front();
+    indirection_array_hits_++;
+  } else {
+    indirection_array_misses_++;
+    LOG_TRACE("Indirection array reserve of table %u is empty",
+              table_->GetOid());
+  }
+
+  RequestRefill();
+  return indirection_array;
+}
+
+void TileGroupPreallocator::DiscardTileGroups() {
+  // A tile group allocated while the mutex is released is dropped as well
+  layout_generation_++;
+
+  auto &catalog_manager = catalog::Manager::GetInstance();
+  for (auto &tile_group : tile_groups_) {
+    catalog_manager.DropTileGroup(tile_group->GetTileGroupId());
+  }
+  tile_groups_.clear();
+}
+
+void TileGroupPreallocator::RequestRefill() {
+  if (stopped_) return;
+  TileGroupRefiller::GetInstance().Enqueue(this);
+}
+
+void TileGroupPreallocator::Refill() {
+  auto &catalog_manager = catalog::Manager::GetInstance();
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  while (stopped_ == false) {
+    bool need_tile_group = tile_groups_.size() < reserve_count_;
+    bool need_indirection_array = indirection_arrays_.size() < reserve_count_;
+    if (need_tile_group == false && need_indirection_array == false) {
+      break;
+    }
+    size_t layout_generation = layout_generation_;
+
+    // Do the expensive allocation without blocking inserters
+    lock.unlock();
+
+    std::shared_ptr<TileGroup> tile_group;
+    std::shared_ptr<IndirectionArray> indirection_array;
+    if (need_tile_group) {
+      tile_group = table_->PrepareDefaultTileGroup();
+    }
+    if (need_indirection_array) {
+      indirection_array = table_->PrepareDefaultIndirectionArray();
+    }
+
+    lock.lock();
+
+    if (tile_group != nullptr && layout_generation != layout_generation_) {
+      // The layout changed while it was being allocated
+      lock.unlock();
+      catalog_manager.DropTileGroup(tile_group->GetTileGroupId());
+      tile_group.reset();
+      lock.lock();
+    }
+    if (tile_group != nullptr) {
+      tile_groups_.push_back(std::move(tile_group));
+    }
+    if (indirection_array != nullptr) {
+      indirection_arrays_.push_back(std::move(indirection_array));
+    }
+  }
+}
+
+}  // namespace storage
+}  // namespace peloton
@@ -0,0 +1,361 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// zone_map.cpp
+//
+// Identification: src/storage/zone_map.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/zone_map.h"
+
+#include <sstream>
+
+#include "catalog/schema.h"
+#include "common/abstract_tuple.h"
+#include "common/logger.h"
+#include "expression/abstract_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/parameter_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "storage/tile_group.h"
+
+namespace peloton {
+namespace storage {
+
+namespace {
+
+// Numeric types are mutually comparable, everything else only with itself
+bool IsNumericType(type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+    case type::TypeId::DECIMAL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool AreComparable(type::TypeId left, type::TypeId right) {
+  if (IsNumericType(left) && IsNumericType(right)) return true;
+  return left == right;
+}
+
+// Flip a comparison so that "value <op> column" becomes "column <op'> value"
+ExpressionType FlipComparison(ExpressionType comparison) {
+  switch (comparison) {
+    case ExpressionType::COMPARE_LESSTHAN:
+      return ExpressionType::COMPARE_GREATERTHAN;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return ExpressionType::COMPARE_GREATERTHANOREQUALTO;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return ExpressionType::COMPARE_LESSTHAN;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return ExpressionType::COMPARE_LESSTHANOREQUALTO;
+    default:
+      return comparison;
+  }
+}
+
+// Resolve a constant or parameter expression into a value. Returns false if
+// the expression is neither or the parameter cannot be resolved.
+bool ResolveValue(const expression::AbstractExpression *expr,
+                  const std::vector<type::Value> *params, type::Value &value) {
+  switch (expr->GetExpressionType()) {
+    case ExpressionType::VALUE_CONSTANT: {
+      auto *constant =
+          static_cast<const expression::ConstantValueExpression *>(expr);
+      value = constant->GetValue();
+      return true;
+    }
+    case ExpressionType::VALUE_PARAMETER: {
+      if (params == nullptr) return false;
+      auto *param =
+          static_cast<const expression::ParameterValueExpression *>(expr);
+      auto idx = static_cast<size_t>(param->GetValueIdx());
+      if (idx >= params->size()) return false;
+      value = (*params)[idx];
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+ZoneMap::ZoneMap(const std::vector<catalog::Schema> &tile_schemas,
+                 const std::map<oid_t, std::pair<oid_t, oid_t>> &column_map)
+    : columns_(column_map.size()), version_(0) {
+  for (const auto &entry : column_map) {
+    const auto &tile_schema = tile_schemas[entry.second.first];
+    auto type_id = tile_schema.GetType(entry.second.second);
+    columns_[entry.first].tracked = IsTrackedType(type_id);
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Maintenance
+//===--------------------------------------------------------------------===//
+
+void ZoneMap::Widen(ColumnRange &range, const type::Value &value) {
+  if (value.IsNull()) {
+    range.null_count++;
+    return;
+  }
+
+  if (range.has_values == false) {
+    range.min = value.Copy();
+    range.max = value.Copy();
+    range.has_values = true;
+    return;
+  }
+
+  if (value.CompareLessThan(range.min) == type::CMP_TRUE) {
+    range.min = value.Copy();
+  } else if (value.CompareGreaterThan(range.max) == type::CMP_TRUE) {
+    range.max = value.Copy();
+  }
+}
+
+void ZoneMap::UpdateWithTuple(const AbstractTuple *tuple) {
+  lock_.Lock();
+  for (oid_t column_itr = 0; column_itr < columns_.size(); column_itr++) {
+    auto &range = columns_[column_itr];
+    if (range.tracked == false) continue;
+    Widen(range, tuple->GetValue(column_itr));
+  }
+  version_.fetch_add(1, std::memory_order_relaxed);
+  lock_.Unlock();
+}
+
+void ZoneMap::UpdateWithValue(oid_t column_id, const type::Value &value) {
+  // Rebuild() may replace columns_ at any time, only index it under the lock
+  lock_.Lock();
+  PL_ASSERT(column_id < columns_.size());
+  auto &range = columns_[column_id];
+  if (range.tracked == true) {
+    Widen(range, value);
+    version_.fetch_add(1, std::memory_order_relaxed);
+  }
+  lock_.Unlock();
+}
+
+// Scan every allocated slot, regardless of its visibility, and only install
+// the result if no writer widened the map in the meantime. A writer that
+// stores a value after we read its slot widens the installed map afterwards,
+// so the result is never narrower than the data.
+void ZoneMap::Rebuild(TileGroup *tile_group) {
+  // Another rebuild may install its ranges meanwhile, so read the tracked
+  // columns under the lock as well
+  lock_.Lock();
+  uint64_t start_version = version_.load(std::memory_order_relaxed);
+  std::vector<ColumnRange> columns(columns_.size());
+  for (oid_t column_itr = 0; column_itr < columns.size(); column_itr++) {
+    columns[column_itr].tracked = columns_[column_itr].tracked;
+  }
+  lock_.Unlock();
+
+  oid_t tuple_count = tile_group->GetNextTupleSlot();
+  for (oid_t column_itr = 0; column_itr < columns.size(); column_itr++) {
+    auto &range = columns[column_itr];
+    if (range.tracked == false) continue;
+
+    for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+      Widen(range, tile_group->GetValue(tuple_itr, column_itr));
+    }
+  }
+
+  lock_.Lock();
+  if (version_.load(std::memory_order_relaxed) == start_version) {
+    columns_ = std::move(columns);
+  } else {
+    LOG_TRACE("Zone map of tile group %u changed during rebuild",
+              tile_group->GetTileGroupId());
+  }
+  lock_.Unlock();
+}
+
+//===--------------------------------------------------------------------===//
+// Pruning
+//===--------------------------------------------------------------------===//
+
+bool ZoneMap::MayMatch(const ColumnRange &range,
+                       const ZoneMapPredicate &predicate) {
+  if (range.tracked == false) return true;
+
+  if (predicate.comparison == ExpressionType::OPERATOR_IS_NULL) {
+    return range.null_count > 0;
+  }
+
+  // Comparisons against NULL never evaluate to true
+  if (predicate.value.IsNull()) return false;
+
+  // Only nulls (or nothing at all) were ever stored in this column
+  if (range.has_values == false) return false;
+
+  const auto &value = predicate.value;
+  switch (predicate.comparison) {
+    case ExpressionType::COMPARE_EQUAL:
+      return range.min.CompareLessThanEquals(value) == type::CMP_TRUE &&
+             range.max.CompareGreaterThanEquals(value) == type::CMP_TRUE;
+    case ExpressionType::COMPARE_NOTEQUAL:
+      return !(range.min.CompareEquals(value) == type::CMP_TRUE &&
+               range.max.CompareEquals(value) == type::CMP_TRUE);
+    case ExpressionType::COMPARE_LESSTHAN:
+      return range.min.CompareLessThan(value) == type::CMP_TRUE;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return range.min.CompareLessThanEquals(value) == type::CMP_TRUE;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return range.max.CompareGreaterThan(value) == type::CMP_TRUE;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return range.max.CompareGreaterThanEquals(value) == type::CMP_TRUE;
+    default:
+      return true;
+  }
+}
+
+bool ZoneMap::ShouldScan(const ZoneMapPredicate *predicates,
+                         size_t num_predicates) const {
+  if (num_predicates == 0) return true;
+
+  lock_.Lock();
+  bool should_scan = true;
+  for (size_t pred_itr = 0; pred_itr < num_predicates; pred_itr++) {
+    const auto &predicate = predicates[pred_itr];
+    if (predicate.column_id >= columns_.size()) continue;
+    if (MayMatch(columns_[predicate.column_id], predicate) == false) {
+      should_scan = false;
+      break;
+    }
+  }
+  lock_.Unlock();
+  return should_scan;
+}
+
+bool ZoneMap::GetColumnRange(oid_t column_id, type::Value &min,
+                             type::Value &max, size_t &null_count) const {
+  PL_ASSERT(column_id < columns_.size());
+  lock_.Lock();
+  const auto &range = columns_[column_id];
+  bool has_values = range.tracked && range.has_values;
+  if (has_values) {
+    min = range.min.Copy();
+    max = range.max.Copy();
+  }
+  null_count = range.null_count;
+  lock_.Unlock();
+  return has_values;
+}
+
+bool ZoneMap::IsTrackedType(type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::BOOLEAN:
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+    case type::TypeId::DECIMAL:
+    case type::TypeId::TIMESTAMP:
+    case type::TypeId::DATE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void ZoneMap::ExtractPredicates(const expression::AbstractExpression *expr,
+                                const std::vector<type::Value> *params,
+                                std::vector<ZoneMapPredicate> &predicates) {
+  if (expr == nullptr) return;
+
+  auto expr_type = expr->GetExpressionType();
+
+  // Every conjunct of an AND must hold, so each can prune independently
+  if (expr_type == ExpressionType::CONJUNCTION_AND) {
+    for (size_t child_itr = 0; child_itr < expr->GetChildrenSize();
+         child_itr++) {
+      ExtractPredicates(expr->GetChild(child_itr), params, predicates);
+    }
+    return;
+  }
+
+  if (expr_type == ExpressionType::OPERATOR_IS_NULL) {
+    auto *child = expr->GetChild(0);
+    if (child != nullptr &&
+        child->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+      auto *tve = static_cast<const expression::TupleValueExpression *>(child);
+      if (tve->GetTupleId() == 0 && tve->GetColumnId() >= 0) {
+        predicates.emplace_back(tve->GetColumnId(), expr_type,
+                                type::Value());
+      }
+    }
+    return;
+  }
+
+  switch (expr_type) {
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      break;
+    default:
+      return;
+  }
+
+  const auto *left = expr->GetChild(0);
+  const auto *right = expr->GetChild(1);
+  if (left == nullptr || right == nullptr) return;
+
+  // Normalize into "column <op> value"
+  if (right->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+    std::swap(left, right);
+    expr_type = FlipComparison(expr_type);
+  }
+  if (left->GetExpressionType() != ExpressionType::VALUE_TUPLE) return;
+
+  auto *tve = static_cast<const expression::TupleValueExpression *>(left);
+  if (tve->GetTupleId() != 0 || tve->GetColumnId() < 0) return;
+
+  type::Value value;
+  if (ResolveValue(right, params, value) == false) return;
+
+  // Skip comparisons that would need a cast to evaluate
+  if (!value.IsNull() &&
+      !AreComparable(tve->GetValueType(), value.GetTypeId())) {
+    return;
+  }
+
+  predicates.emplace_back(tve->GetColumnId(), expr_type, value);
+}
+
+const std::string ZoneMap::GetInfo() const {
+  std::ostringstream os;
+  os << "ZoneMap[";
+  lock_.Lock();
+  for (oid_t column_itr = 0; column_itr < columns_.size(); column_itr++) {
+    const auto &range = columns_[column_itr];
+    if (range.tracked == false) continue;
+    os << " #" << column_itr << ":";
+    if (range.has_values) {
+      os << "[" << range.min.ToString() << ", " << range.max.ToString() << "]";
+    } else {
+      os << "[]";
+    }
+    os << " nulls=" << range.null_count;
+  }
+  lock_.Unlock();
+  os << " ]";
+  return os.str();
+}
+
+}  // namespace storage
+}  // namespace peloton
@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// parallel_for.cpp
+//
+// Identification: src/threadpool/parallel_for.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "threadpool/parallel_for.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+#include "common/macros.h"
+#include "threadpool/mono_queue_pool.h"
+
+namespace peloton {
+namespace threadpool {
+
+namespace {
+
+// Shared by the caller and its helpers. Helpers that run late hold on to
+// it after the caller has returned, but by then there is nothing to claim.
+struct ParallelForState {
+  ParallelForState(size_t count, const std::function<void(size_t)> &task)
+      : count(count), task(task) {}
+
+  const size_t count;
+
+  // Only called for a claimed item, i.e. while the caller is waiting
+  const std::function<void(size_t)> task;
+
+  std::atomic<size_t> next_item = ATOMIC_VAR_INIT(0);
+
+  std::mutex mutex;
+  std::condition_variable done_cv;
+  size_t done_count = 0;
+  std::exception_ptr error;
+};
+
+void RunItems(ParallelForState &state) {
+  size_t item;
+  while ((item = state.next_item++) < state.count) {
+    std::exception_ptr error;
+    try {
+      state.task(item);
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (error != nullptr) {
+      if (state.error == nullptr) state.error = error;
+      // Nobody claims the rest, count them as done
+      size_t next_item = state.next_item.exchange(state.count);
+      if (next_item < state.count) {
+        state.done_count += state.count - next_item;
+      }
+    }
+    if (++state.done_count == state.count) {
+      state.done_cv.notify_all();
+    }
+  }
+}
+
+void RunHelper(void *arg) {
+  std::unique_ptr<std::shared_ptr<ParallelForState>> state(
+      static_cast<std::shared_ptr<ParallelForState> *>(arg));
+  RunItems(**state);
+}
+
+void NoCallback(UNUSED_ATTRIBUTE void *arg) {}
+
+}  // namespace
+
+size_t GetParallelism() { return DEFAULT_WORKER_POOL_SIZE + 1; }
+
+void ParallelFor(size_t count, size_t max_parallelism,
+                 const std::function<void(size_t)> &task) {
+  if (count == 0) return;
+
+  size_t helper_count =
+      std::min(std::min(count, std::max<size_t>(max_parallelism, 1)),
+               GetParallelism()) -
+      1;
+  if (helper_count == 0) {
+    for (size_t item = 0; item < count; item++) task(item);
+    return;
+  }
+
+  auto state = std::make_shared<ParallelForState>(count, task);
+  for (size_t helper_itr = 0; helper_itr < helper_count; helper_itr++) {
+    MonoQueuePool::GetInstance().SubmitTask(
+        RunHelper, new std::shared_ptr<ParallelForState>(state), NoCallback,
+        nullptr);
+  }
+
+  RunItems(*state);
+
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->done_cv.wait(lock, [&] { return state->done_count == state->count; });
+  if (state->error != nullptr) {
+    std::rethrow_exception(state->error);
+  }
+}
+
+}  // namespace threadpool
+}  // namespace peloton
@@ -14,6 +14,7 @@
 
 #include "threadpool/worker.h"
 #include "common/logger.h"
+#include "common/numa_topology.h"
 
 #define MIN_PAUSE_TIME 1
 #define MAX_PAUSE_TIME 1000
@@ -27,6 +28,10 @@ void Worker::Start(TaskQueue *task_queue) {
 }
 
 void Worker::Execute(Worker *current_thread, TaskQueue *task_queue) {
+  // Workers are spread over the NUMA nodes so that the memory they allocate
+  // stays local
+  NumaTopology::GetInstance().PinThreadToNextNode();
+
   size_t time_pause = MIN_PAUSE_TIME;
   std::shared_ptr<Task> task;
   while (!current_thread->shutdown_thread_ || !task_queue->IsEmpty()) {
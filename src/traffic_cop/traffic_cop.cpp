@@ -34,20 +34,17 @@ namespace tcop {
 
 TrafficCop::TrafficCop():is_queuing_(false) {
   LOG_TRACE("Starting a new TrafficCop");
-  optimizer_.reset(new optimizer::Optimizer);
 //  result_ = ResultType::QUEUING;
 }
 
 TrafficCop::TrafficCop(void(* task_callback)(void *), void *task_callback_arg):
     task_callback_(task_callback), task_callback_arg_(task_callback_arg) {
-  optimizer_.reset(new optimizer::Optimizer);
 }
 
 void TrafficCop::Reset() {
-  std::stack<TcopTxnState> new_tcop_txn_state;
+  TcopTxnStack new_tcop_txn_state;
   // clear out the stack
   swap(tcop_txn_state_, new_tcop_txn_state);
-  optimizer_->Reset();
 //  result_ = ResultType::QUEUING;
 }
 
@@ -67,6 +64,16 @@ TrafficCop &TrafficCop::GetInstance() {
   return tcop;
 }
 
+optimizer::AbstractOptimizer &TrafficCop::GetOptimizer() {
+  // A statement is planned on the thread of its connection, one at a time,
+  // so the connections do not need an optimizer each
+  static thread_local std::unique_ptr<optimizer::AbstractOptimizer> optimizer;
+  if (optimizer == nullptr) {
+    optimizer.reset(new optimizer::Optimizer);
+  }
+  return *optimizer;
+}
+
 TrafficCop::TcopTxnState &TrafficCop::GetDefaultTxnState() {
   static TcopTxnState default_state;
   default_state = std::make_pair(nullptr, ResultType::INVALID);
@@ -165,7 +172,8 @@ ResultType TrafficCop::ExecuteStatement(
         return AbortQueryHelper();
       default:
         ExecuteStatementPlan(statement->GetPlanTree(), params, result,
-                             result_format, thread_id);
+                             result_format, thread_id,
+                             statement->IsExplainAnalyze());
         if (is_queuing_) {
           return ResultType::QUEUING;
         }
@@ -191,7 +199,7 @@ executor::ExecuteResult TrafficCop::ExecuteStatementPlan(
     std::shared_ptr<planner::AbstractPlan> plan,
     const std::vector<type::Value> &params,
     std::vector<StatementResult> &result, const std::vector<int> &result_format,
-    const size_t thread_id) {
+    const size_t thread_id, bool explain_analyze) {
   concurrency::Transaction *txn;
 
   auto &curr_state = GetCurrentTxnState();
@@ -214,9 +222,19 @@ executor::ExecuteResult TrafficCop::ExecuteStatementPlan(
   if (curr_state.second != ResultType::ABORTED) {
     PL_ASSERT(txn);
     PL_ASSERT(plan);
+    if (execute_inline_ == true) {
+      // Already on a worker, run the plan right away
+      executor::PlanExecutor::ExecutePlan(plan, txn, params, result,
+                                          result_format, p_status_,
+                                          explain_analyze);
+      ExecuteStatementPlanGetResult();
+      return p_status_;
+    }
     PL_ASSERT(task_callback_);
     PL_ASSERT(task_callback_arg_);
-    ExecutePlanArg* arg = new ExecutePlanArg(plan, txn, params, result, result_format, p_status_);
+    ExecutePlanArg* arg = new ExecutePlanArg(plan, txn, params, result,
+                                             result_format, p_status_,
+                                             explain_analyze);
     threadpool::MonoQueuePool::GetInstance().SubmitTask(ExecutePlanWrapper, arg, task_callback_, task_callback_arg_);
     LOG_TRACE("Submit Task into MonoQueuePool");
 
@@ -241,10 +259,48 @@ void TrafficCop::ExecutePlanWrapper(void *arg_ptr) {
   PL_ASSERT(&arg->params_);
   executor::PlanExecutor::ExecutePlan(arg->plan_, arg->txn_, arg->params_,
                                       arg->result_, arg->result_format_,
-                                      arg->p_status_);
+                                      arg->p_status_, arg->explain_analyze_);
   delete(arg);
 }
 
+ResultType TrafficCop::ExecutePipeline(
+    std::vector<PipelinedStatement> &pipeline, const size_t thread_id) {
+  PL_ASSERT(task_callback_);
+  PL_ASSERT(task_callback_arg_);
+  ExecutePipelineArg *arg = new ExecutePipelineArg(this, pipeline, thread_id);
+  threadpool::MonoQueuePool::GetInstance().SubmitTask(
+      ExecutePipelineWrapper, arg, task_callback_, task_callback_arg_);
+  LOG_TRACE("Submit pipeline of %lu statements into MonoQueuePool",
+            pipeline.size());
+  return ResultType::QUEUING;
+}
+
+void TrafficCop::ExecutePipelineWrapper(void *arg_ptr) {
+  LOG_TRACE("Entering ExecutePipelineWrapper");
+  PL_ASSERT(arg_ptr);
+  ExecutePipelineArg *arg = (ExecutePipelineArg *)arg_ptr;
+  auto tcop = arg->tcop_;
+  tcop->execute_inline_ = true;
+  for (auto &pipelined : arg->pipeline_) {
+    // Statements of the pipeline may share a plan, whose parameters were
+    // set by the last BIND
+    auto plan = pipelined.statement_->GetPlanTree();
+    if (plan != nullptr && pipelined.params_.empty() == false) {
+      plan->SetParameterValues(&pipelined.params_);
+    }
+    pipelined.status_ = tcop->ExecuteStatement(
+        pipelined.statement_, pipelined.params_,
+        pipelined.statement_->GetStatementName().empty(),
+        pipelined.param_stats_, pipelined.result_format_, pipelined.results_,
+        pipelined.rows_changed_, pipelined.error_message_, arg->thread_id_);
+    if (pipelined.Failed() == true) {
+      break;
+    }
+  }
+  tcop->execute_inline_ = false;
+  delete (arg);
+}
+
 void TrafficCop::ExecuteStatementPlanGetResult() {
   bool init_failure = false;
   if (p_status_.m_result == ResultType::FAILURE) {
@@ -328,14 +384,22 @@ std::shared_ptr<Statement> TrafficCop::PrepareStatement(
   }
 
   try {
+    // EXPLAIN ANALYZE plans the query it wraps, which is then profiled
+    std::string parse_string = query_string;
+    bool explain_analyze =
+        Statement::ParseExplainAnalyze(query_string, parse_string);
+
     auto &peloton_parser = parser::PostgresParser::GetInstance();
-    auto sql_stmt = peloton_parser.BuildParseTree(query_string);
+    auto sql_stmt = peloton_parser.BuildParseTree(parse_string);
     if (sql_stmt->is_valid == false) {
       throw ParserException("Error parsing SQL statement");
     }
     LOG_TRACE("Optimizer Build Peloton Plan Tree...");
-    auto plan =
-        optimizer_->BuildPelotonPlanTree(sql_stmt, default_database_name_, tcop_txn_state_.top().first);
+    // The optimizer is shared, clear whatever a failed statement left
+    auto &optimizer = GetOptimizer();
+    optimizer.Reset();
+    auto plan = optimizer.BuildPelotonPlanTree(
+        sql_stmt, default_database_name_, tcop_txn_state_.top().first);
     statement->SetPlanTree(plan);
     // Get the tables that our plan references so that we know how to
     // invalidate it at a later point when the catalog changes
@@ -352,6 +416,13 @@ std::shared_ptr<Statement> TrafficCop::PrepareStatement(
       break;
     }
 
+    // The result of EXPLAIN ANALYZE is one line of text per row
+    if (explain_analyze) {
+      statement->SetExplainAnalyze(true);
+      statement->SetTupleDescriptor(
+          {GetColumnFieldForValueType("QUERY PLAN", type::TypeId::VARCHAR)});
+    }
+
 #ifdef LOG_DEBUG_ENABLED
     if (statement->GetPlanTree().get() != nullptr) {
       LOG_TRACE("Statement Prepared: %s", statement->GetInfo().c_str());
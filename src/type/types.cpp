@@ -330,6 +330,9 @@ std::string CreateTypeToString(CreateType type) {
     case CreateType::TRIGGER: {
       return "TRIGGER";
     }
+    case CreateType::MATERIALIZED_VIEW: {
+      return "MATERIALIZED_VIEW";
+    }
     default: {
       throw ConversionException(StringUtil::Format(
           "No string conversion for CreateType value '%d'",
@@ -353,6 +356,8 @@ CreateType StringToCreateType(const std::string& str) {
     return CreateType::CONSTRAINT;
   } else if (upper_str == "TRIGGER") {
     return CreateType::TRIGGER;
+  } else if (upper_str == "MATERIALIZED_VIEW") {
+    return CreateType::MATERIALIZED_VIEW;
   } else {
     throw ConversionException(StringUtil::Format(
         "No CreateType conversion from string '%s'", upper_str.c_str()));
@@ -384,6 +389,9 @@ std::string DropTypeToString(DropType type) {
     case DropType::TRIGGER: {
       return "TRIGGER";
     }
+    case DropType::MATERIALIZED_VIEW: {
+      return "MATERIALIZED_VIEW";
+    }
     default: {
       throw ConversionException(StringUtil::Format(
           "No string conversion for DropType value '%d'",
@@ -407,6 +415,8 @@ DropType StringToDropType(const std::string& str) {
     return DropType::CONSTRAINT;
   } else if (upper_str == "TRIGGER") {
     return DropType::TRIGGER;
+  } else if (upper_str == "MATERIALIZED_VIEW") {
+    return DropType::MATERIALIZED_VIEW;
   } else {
     throw ConversionException(StringUtil::Format(
         "No DropType conversion from string '%s'", upper_str.c_str()));
@@ -588,6 +598,9 @@ std::string ExpressionTypeToString(ExpressionType type, bool short_str) {
     case ExpressionType::COMPARE_DISTINCT_FROM: {
       return ("COMPARE_DISTINCT_FROM");
     }
+    case ExpressionType::COMPARE_ILIKE: {
+      return short_str ? "~~*" : ("COMPARE_ILIKE");
+    }
     case ExpressionType::CONJUNCTION_AND: {
       return ("CONJUNCTION_AND");
     }
@@ -743,6 +756,8 @@ ExpressionType StringToExpressionType(const std::string& str) {
     return ExpressionType::COMPARE_IN;
   } else if (upper_str == "COMPARE_DISTINCT_FROM") {
     return ExpressionType::COMPARE_DISTINCT_FROM;
+  } else if (upper_str == "COMPARE_ILIKE" || upper_str == "~~*") {
+    return ExpressionType::COMPARE_ILIKE;
   } else if (upper_str == "CONJUNCTION_AND") {
     return ExpressionType::CONJUNCTION_AND;
   } else if (upper_str == "CONJUNCTION_OR") {
@@ -975,6 +990,9 @@ std::string PlanNodeTypeToString(PlanNodeType type) {
     case PlanNodeType::INDEXSCAN: {
       return ("INDEXSCAN");
     }
+    case PlanNodeType::MATERIALIZED_VIEW_SCAN: {
+      return ("MATERIALIZED_VIEW_SCAN");
+    }
     case PlanNodeType::NESTLOOP: {
       return ("NESTLOOP");
     }
@@ -1078,6 +1096,8 @@ PlanNodeType StringToPlanNodeType(const std::string& str) {
     return PlanNodeType::SEQSCAN;
   } else if (upper_str == "INDEXSCAN") {
     return PlanNodeType::INDEXSCAN;
+  } else if (upper_str == "MATERIALIZED_VIEW_SCAN") {
+    return PlanNodeType::MATERIALIZED_VIEW_SCAN;
   } else if (upper_str == "NESTLOOP") {
     return PlanNodeType::NESTLOOP;
   } else if (upper_str == "NESTLOOPINDEX") {
@@ -1262,6 +1282,9 @@ std::string JoinTypeToString(JoinType type) {
     case JoinType::SEMI: {
       return "SEMI";
     }
+    case JoinType::ANTI: {
+      return "ANTI";
+    }
     default: {
       throw ConversionException(
           StringUtil::Format("No string conversion for JoinType value '%d'",
@@ -1285,6 +1308,8 @@ JoinType StringToJoinType(const std::string& str) {
     return JoinType::OUTER;
   } else if (upper_str == "SEMI") {
     return JoinType::SEMI;
+  } else if (upper_str == "ANTI") {
+    return JoinType::ANTI;
   } else {
     throw ConversionException(StringUtil::Format(
         "No JoinType conversion from string '%s'", upper_str.c_str()));
@@ -0,0 +1,350 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// value_kernels.cpp
+//
+// Identification: src/type/value_kernels.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "type/value_kernels.h"
+
+#include <functional>
+
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace type {
+
+namespace {
+
+// The C++ type a fixed-width value is stored as
+template <TypeId T>
+struct NativeType;
+template <>
+struct NativeType<TypeId::TINYINT> {
+  typedef int8_t type;
+};
+template <>
+struct NativeType<TypeId::SMALLINT> {
+  typedef int16_t type;
+};
+template <>
+struct NativeType<TypeId::INTEGER> {
+  typedef int32_t type;
+};
+template <>
+struct NativeType<TypeId::BIGINT> {
+  typedef int64_t type;
+};
+template <>
+struct NativeType<TypeId::DECIMAL> {
+  typedef double type;
+};
+template <>
+struct NativeType<TypeId::DATE> {
+  typedef int32_t type;
+};
+template <>
+struct NativeType<TypeId::TIMESTAMP> {
+  typedef uint64_t type;
+};
+
+// Arithmetic on two integers gives the wider of both types, a decimal on
+// either side gives a decimal
+template <TypeId L, TypeId R>
+struct ResultType {
+  typedef typename NativeType<L>::type Left;
+  typedef typename NativeType<R>::type Right;
+  static constexpr TypeId value =
+      (L == TypeId::DECIMAL || R == TypeId::DECIMAL)
+          ? TypeId::DECIMAL
+          : (sizeof(Left) >= sizeof(Right) ? L : R);
+  typedef typename NativeType<value>::type type;
+};
+
+inline Value MakeValue(int8_t value) {
+  return ValueFactory::GetTinyIntValue(value);
+}
+inline Value MakeValue(int16_t value) {
+  return ValueFactory::GetSmallIntValue(value);
+}
+inline Value MakeValue(int32_t value) {
+  return ValueFactory::GetIntegerValue(value);
+}
+inline Value MakeValue(int64_t value) {
+  return ValueFactory::GetBigIntValue(value);
+}
+inline Value MakeValue(double value) {
+  return ValueFactory::GetDecimalValue(value);
+}
+
+//===--------------------------------------------------------------------===//
+// Operators
+//
+// Apply() computes the result, or returns false when the generic method
+// has to decide what happens, e.g. to raise the overflow error.
+//===--------------------------------------------------------------------===//
+
+struct AddOperator {
+  template <class T, class U, class Result>
+  static bool Apply(T x, U y, Result *result) {
+    return !__builtin_add_overflow(x, y, result);
+  }
+  template <class T, class U>
+  static bool Apply(T x, U y, double *result) {
+    *result = x + y;
+    return true;
+  }
+  static Value Generic(const Value &left, const Value &right) {
+    return left.Add(right);
+  }
+};
+
+struct SubtractOperator {
+  template <class T, class U, class Result>
+  static bool Apply(T x, U y, Result *result) {
+    return !__builtin_sub_overflow(x, y, result);
+  }
+  template <class T, class U>
+  static bool Apply(T x, U y, double *result) {
+    *result = x - y;
+    return true;
+  }
+  static Value Generic(const Value &left, const Value &right) {
+    return left.Subtract(right);
+  }
+};
+
+struct MultiplyOperator {
+  template <class T, class U, class Result>
+  static bool Apply(T x, U y, Result *result) {
+    return !__builtin_mul_overflow(x, y, result);
+  }
+  template <class T, class U>
+  static bool Apply(T x, U y, double *result) {
+    *result = x * y;
+    return true;
+  }
+  static Value Generic(const Value &left, const Value &right) {
+    return left.Multiply(right);
+  }
+};
+
+struct DivideOperator {
+  template <class T, class U, class Result>
+  static bool Apply(T x, U y, Result *result) {
+    if (y == 0) return false;
+    *result = static_cast<Result>(x / y);
+    return true;
+  }
+  static Value Generic(const Value &left, const Value &right) {
+    return left.Divide(right);
+  }
+};
+
+struct ModuloOperator {
+  template <class T, class U, class Result>
+  static bool Apply(T x, U y, Result *result) {
+    if (y == 0) return false;
+    *result = static_cast<Result>(x % y);
+    return true;
+  }
+  // A decimal modulo has no kernel
+  template <class T, class U>
+  static bool Apply(T, U, double *) {
+    return false;
+  }
+  static Value Generic(const Value &left, const Value &right) {
+    return left.Modulo(right);
+  }
+};
+
+//===--------------------------------------------------------------------===//
+// Kernels
+//===--------------------------------------------------------------------===//
+
+template <TypeId L, TypeId R, class Compare>
+CmpBool CompareValues(const Value &left, const Value &right) {
+  if (left.IsNull() || right.IsNull()) return CMP_NULL;
+  return GetCmpBool(Compare()(left.GetAs<typename NativeType<L>::type>(),
+                              right.GetAs<typename NativeType<R>::type>()));
+}
+
+template <TypeId L, TypeId R, class Operator>
+Value OperateValues(const Value &left, const Value &right) {
+  typename ResultType<L, R>::type result;
+  if (!left.IsNull() && !right.IsNull() &&
+      Operator::Apply(left.GetAs<typename NativeType<L>::type>(),
+                      right.GetAs<typename NativeType<R>::type>(), &result)) {
+    return MakeValue(result);
+  }
+  return Operator::Generic(left, right);
+}
+
+template <TypeId T>
+Value MinValue(const Value &left, const Value &right) {
+  if (left.IsNull() || right.IsNull()) return left.Min(right);
+  typedef typename NativeType<T>::type Native;
+  return left.GetAs<Native>() <= right.GetAs<Native>() ? left : right;
+}
+
+template <TypeId T>
+Value MaxValue(const Value &left, const Value &right) {
+  if (left.IsNull() || right.IsNull()) return left.Max(right);
+  typedef typename NativeType<T>::type Native;
+  return left.GetAs<Native>() >= right.GetAs<Native>() ? left : right;
+}
+
+template <class Compare>
+struct CompareBinder {
+  typedef CompareKernel Kernel;
+  template <TypeId L, TypeId R>
+  static Kernel Bind() {
+    return Kernel(L, R, &CompareValues<L, R, Compare>);
+  }
+};
+
+template <class Operator>
+struct ArithmeticBinder {
+  typedef ArithmeticKernel Kernel;
+  template <TypeId L, TypeId R>
+  static Kernel Bind() {
+    return Kernel(L, R, &OperateValues<L, R, Operator>);
+  }
+};
+
+//===--------------------------------------------------------------------===//
+// Dispatch
+//
+// Instantiates the kernel of every pair of numeric types and picks the one
+// for the given pair.
+//===--------------------------------------------------------------------===//
+
+template <class Binder, TypeId L>
+typename Binder::Kernel BindNumericRight(TypeId right) {
+  switch (right) {
+    case TypeId::TINYINT:
+      return Binder::template Bind<L, TypeId::TINYINT>();
+    case TypeId::SMALLINT:
+      return Binder::template Bind<L, TypeId::SMALLINT>();
+    case TypeId::INTEGER:
+      return Binder::template Bind<L, TypeId::INTEGER>();
+    case TypeId::BIGINT:
+      return Binder::template Bind<L, TypeId::BIGINT>();
+    case TypeId::DECIMAL:
+      return Binder::template Bind<L, TypeId::DECIMAL>();
+    default:
+      return typename Binder::Kernel();
+  }
+}
+
+template <class Binder>
+typename Binder::Kernel BindNumeric(TypeId left, TypeId right) {
+  switch (left) {
+    case TypeId::TINYINT:
+      return BindNumericRight<Binder, TypeId::TINYINT>(right);
+    case TypeId::SMALLINT:
+      return BindNumericRight<Binder, TypeId::SMALLINT>(right);
+    case TypeId::INTEGER:
+      return BindNumericRight<Binder, TypeId::INTEGER>(right);
+    case TypeId::BIGINT:
+      return BindNumericRight<Binder, TypeId::BIGINT>(right);
+    case TypeId::DECIMAL:
+      return BindNumericRight<Binder, TypeId::DECIMAL>(right);
+    default:
+      return typename Binder::Kernel();
+  }
+}
+
+template <class Compare>
+CompareKernel BindCompare(TypeId left, TypeId right) {
+  typedef CompareBinder<Compare> Binder;
+  // Dates and timestamps only compare with their own type
+  if (left == TypeId::DATE && right == TypeId::DATE) {
+    return Binder::template Bind<TypeId::DATE, TypeId::DATE>();
+  }
+  if (left == TypeId::TIMESTAMP && right == TypeId::TIMESTAMP) {
+    return Binder::template Bind<TypeId::TIMESTAMP, TypeId::TIMESTAMP>();
+  }
+  return BindNumeric<Binder>(left, right);
+}
+
+}  // namespace
+
+CompareKernel ValueKernels::GetCompare(ExpressionType type, TypeId left,
+                                       TypeId right) {
+  switch (type) {
+    case ExpressionType::COMPARE_EQUAL:
+      return BindCompare<std::equal_to<>>(left, right);
+    case ExpressionType::COMPARE_NOTEQUAL:
+      return BindCompare<std::not_equal_to<>>(left, right);
+    case ExpressionType::COMPARE_LESSTHAN:
+      return BindCompare<std::less<>>(left, right);
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return BindCompare<std::greater<>>(left, right);
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return BindCompare<std::less_equal<>>(left, right);
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return BindCompare<std::greater_equal<>>(left, right);
+    default:
+      return CompareKernel();
+  }
+}
+
+ArithmeticKernel ValueKernels::GetArithmetic(ExpressionType type,
+                                             TypeId left, TypeId right) {
+  switch (type) {
+    case ExpressionType::OPERATOR_PLUS:
+      return BindNumeric<ArithmeticBinder<AddOperator>>(left, right);
+    case ExpressionType::OPERATOR_MINUS:
+      return BindNumeric<ArithmeticBinder<SubtractOperator>>(left, right);
+    case ExpressionType::OPERATOR_MULTIPLY:
+      return BindNumeric<ArithmeticBinder<MultiplyOperator>>(left, right);
+    case ExpressionType::OPERATOR_DIVIDE:
+      return BindNumeric<ArithmeticBinder<DivideOperator>>(left, right);
+    case ExpressionType::OPERATOR_MOD:
+      if (left == TypeId::DECIMAL || right == TypeId::DECIMAL) {
+        return ArithmeticKernel();
+      }
+      return BindNumeric<ArithmeticBinder<ModuloOperator>>(left, right);
+    default:
+      return ArithmeticKernel();
+  }
+}
+
+#define VALUE_KERNELS_SAME_TYPE(FUNC)                                      \
+  switch (type_id) {                                                       \
+    case TypeId::TINYINT:                                                  \
+      return ArithmeticKernel(type_id, type_id, &FUNC<TypeId::TINYINT>);   \
+    case TypeId::SMALLINT:                                                 \
+      return ArithmeticKernel(type_id, type_id, &FUNC<TypeId::SMALLINT>);  \
+    case TypeId::INTEGER:                                                  \
+      return ArithmeticKernel(type_id, type_id, &FUNC<TypeId::INTEGER>);   \
+    case TypeId::BIGINT:                                                   \
+      return ArithmeticKernel(type_id, type_id, &FUNC<TypeId::BIGINT>);    \
+    case TypeId::DECIMAL:                                                  \
+      return ArithmeticKernel(type_id, type_id, &FUNC<TypeId::DECIMAL>);   \
+    case TypeId::DATE:                                                     \
+      return ArithmeticKernel(type_id, type_id, &FUNC<TypeId::DATE>);      \
+    case TypeId::TIMESTAMP:                                                \
+      return ArithmeticKernel(type_id, type_id, &FUNC<TypeId::TIMESTAMP>); \
+    default:                                                               \
+      return ArithmeticKernel();                                           \
+  }
+
+ArithmeticKernel ValueKernels::GetMin(TypeId type_id) {
+  VALUE_KERNELS_SAME_TYPE(MinValue);
+}
+
+ArithmeticKernel ValueKernels::GetMax(TypeId type_id) {
+  VALUE_KERNELS_SAME_TYPE(MaxValue);
+}
+
+#undef VALUE_KERNELS_SAME_TYPE
+
+}  // namespace type
+}  // namespace peloton
@@ -47,6 +47,74 @@ class HashJoinTranslatorTest : public PelotonCodeGenTest {
   storage::DataTable &GetRightTable() const {
     return GetTestTable(RightTableId());
   }
+
+  // Join column a of the build table with the given column of the probe table
+  // and return the output. The output contains columns a and b of both sides,
+  // or only those of the probe side for SEMI and ANTI joins.
+  std::vector<codegen::WrappedTuple> ExecuteJoin(JoinType join_type,
+                                                 storage::DataTable &build,
+                                                 storage::DataTable &probe,
+                                                 oid_t probe_key_col = 0) {
+    bool probe_only =
+        join_type == JoinType::SEMI || join_type == JoinType::ANTI;
+
+    DirectMapList direct_map_list;
+    std::vector<catalog::Column> columns;
+    if (!probe_only) {
+      direct_map_list.push_back(std::make_pair(0, std::make_pair(0, 0)));
+      direct_map_list.push_back(std::make_pair(1, std::make_pair(0, 1)));
+      columns.push_back(TestingExecutorUtil::GetColumnInfo(0));
+      columns.push_back(TestingExecutorUtil::GetColumnInfo(1));
+    }
+    oid_t offset = direct_map_list.size();
+    direct_map_list.push_back(std::make_pair(offset, std::make_pair(1, 0)));
+    direct_map_list.push_back(std::make_pair(offset + 1, std::make_pair(1, 1)));
+    columns.push_back(TestingExecutorUtil::GetColumnInfo(0));
+    columns.push_back(TestingExecutorUtil::GetColumnInfo(1));
+
+    std::unique_ptr<planner::ProjectInfo> projection{
+        new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+    auto schema =
+        std::shared_ptr<const catalog::Schema>(new catalog::Schema(columns));
+
+    std::vector<AbstractExprPtr> left_hash_keys;
+    left_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+    std::vector<AbstractExprPtr> right_hash_keys;
+    right_hash_keys.emplace_back(
+        ColRefExpr(type::TypeId::INTEGER, probe_key_col));
+    std::vector<AbstractExprPtr> hash_keys;
+    hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, probe_key_col));
+
+    std::unique_ptr<planner::HashJoinPlan> hj_plan{new planner::HashJoinPlan(
+        join_type, nullptr, std::move(projection), schema, left_hash_keys,
+        right_hash_keys, false)};
+    std::unique_ptr<planner::HashPlan> hash_plan{
+        new planner::HashPlan(hash_keys)};
+
+    std::unique_ptr<planner::AbstractPlan> left_scan{
+        new planner::SeqScanPlan(&build, nullptr, {0, 1, 2})};
+    std::unique_ptr<planner::AbstractPlan> right_scan{
+        new planner::SeqScanPlan(&probe, nullptr, {0, 1, 2})};
+
+    hash_plan->AddChild(std::move(right_scan));
+    hj_plan->AddChild(std::move(left_scan));
+    hj_plan->AddChild(std::move(hash_plan));
+
+    EXPECT_TRUE(codegen::QueryCompiler::IsSupported(*hj_plan));
+
+    planner::BindingContext context;
+    hj_plan->PerformBinding(context);
+
+    std::vector<oid_t> output_cols;
+    for (oid_t i = 0; i < columns.size(); i++) {
+      output_cols.push_back(i);
+    }
+    codegen::BufferingConsumer buffer{output_cols, context};
+
+    CompileAndExecute(*hj_plan, buffer,
+                      reinterpret_cast<char *>(buffer.GetState()));
+    return buffer.GetOutputTuples();
+  }
 };
 
 TEST_F(HashJoinTranslatorTest, SingleHashJoinColumnTest) {
@@ -129,5 +197,83 @@ TEST_F(HashJoinTranslatorTest, SingleHashJoinColumnTest) {
   }
 }
 
+TEST_F(HashJoinTranslatorTest, LeftOuterJoinTest) {
+  // The build side has 80 rows, only the first 20 of which have a partner in
+  // the 20 rows of the probe side
+  auto results = ExecuteJoin(JoinType::LEFT, GetRightTable(), GetLeftTable());
+  EXPECT_EQ(80, results.size());
+
+  uint32_t num_unmatched = 0;
+  for (const auto &tuple : results) {
+    EXPECT_EQ(type::CMP_FALSE, tuple.GetValue(0).IsNull());
+    if (tuple.GetValue(2).IsNull() == type::CMP_TRUE) {
+      EXPECT_EQ(type::CMP_TRUE, tuple.GetValue(3).IsNull());
+      num_unmatched++;
+    } else {
+      EXPECT_EQ(type::CMP_TRUE,
+                tuple.GetValue(0).CompareEquals(tuple.GetValue(2)));
+    }
+  }
+  EXPECT_EQ(60, num_unmatched);
+}
+
+TEST_F(HashJoinTranslatorTest, RightOuterJoinTest) {
+  // All 20 build rows match, 60 of the 80 probe rows don't
+  auto results = ExecuteJoin(JoinType::RIGHT, GetLeftTable(), GetRightTable());
+  EXPECT_EQ(80, results.size());
+
+  uint32_t num_unmatched = 0;
+  for (const auto &tuple : results) {
+    EXPECT_EQ(type::CMP_FALSE, tuple.GetValue(2).IsNull());
+    if (tuple.GetValue(0).IsNull() == type::CMP_TRUE) {
+      EXPECT_EQ(type::CMP_TRUE, tuple.GetValue(1).IsNull());
+      num_unmatched++;
+    } else {
+      EXPECT_EQ(type::CMP_TRUE,
+                tuple.GetValue(0).CompareEquals(tuple.GetValue(2)));
+    }
+  }
+  EXPECT_EQ(60, num_unmatched);
+}
+
+TEST_F(HashJoinTranslatorTest, FullOuterJoinTest) {
+  // Column a (10 * i) never equals column b (10 * i + 1), so every row of
+  // both sides is emitted without a partner
+  auto results =
+      ExecuteJoin(JoinType::OUTER, GetLeftTable(), GetRightTable(), 1);
+  EXPECT_EQ(100, results.size());
+
+  uint32_t num_left_only = 0, num_right_only = 0;
+  for (const auto &tuple : results) {
+    bool left_null = tuple.GetValue(0).IsNull() == type::CMP_TRUE;
+    bool right_null = tuple.GetValue(2).IsNull() == type::CMP_TRUE;
+    EXPECT_NE(left_null, right_null);
+    if (left_null) {
+      num_right_only++;
+    } else {
+      num_left_only++;
+    }
+  }
+  EXPECT_EQ(20, num_left_only);
+  EXPECT_EQ(80, num_right_only);
+}
+
+TEST_F(HashJoinTranslatorTest, SemiJoinTest) {
+  // Only the first 20 probe rows have a partner
+  auto results = ExecuteJoin(JoinType::SEMI, GetLeftTable(), GetRightTable());
+  EXPECT_EQ(20, results.size());
+  for (const auto &tuple : results) {
+    EXPECT_LT(tuple.GetValue(0).GetAs<int32_t>(), 200);
+  }
+}
+
+TEST_F(HashJoinTranslatorTest, AntiJoinTest) {
+  auto results = ExecuteJoin(JoinType::ANTI, GetLeftTable(), GetRightTable());
+  EXPECT_EQ(60, results.size());
+  for (const auto &tuple : results) {
+    EXPECT_GE(tuple.GetValue(0).GetAs<int32_t>(), 200);
+  }
+}
+
 }  // namespace test
 }  // namespace peloton
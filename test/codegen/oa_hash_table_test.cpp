@@ -17,7 +17,9 @@
 #include "murmur3/MurmurHash3.h"
 
 #include "codegen/util/oa_hash_table.h"
+#include "common/exception.h"
 #include "common/timer.h"
+#include "executor/executor_context.h"
 
 namespace peloton {
 namespace test {
@@ -145,6 +147,43 @@ TEST_F(OAHashTableTest, CanIterate) {
   EXPECT_EQ(3, dup_count);
 }
 
+TEST_F(OAHashTableTest, ExceedsQueryMemoryBudget) {
+  Value v = {3, 4, 5, 6};
+
+  // The budget fits the initial bucket array, but not the array it is resized
+  // into
+  uint64_t initial_size =
+      codegen::util::OAHashTable::kDefaultInitialSize *
+      (sizeof(codegen::util::OAHashTable::HashEntry) + sizeof(Key) +
+       sizeof(Value));
+  executor::ExecutorContext context(nullptr);
+  context.GetMemoryBudget().SetLimit(2 * initial_size);
+
+  auto &hash_table = GetHashTable();
+  hash_table.Destroy();
+  hash_table.Init(sizeof(Key), sizeof(Value),
+                  codegen::util::OAHashTable::kDefaultInitialSize, &context);
+  EXPECT_EQ(initial_size, context.GetMemoryBudget().GetUsed());
+
+  uint32_t inserted = 0;
+  EXPECT_THROW(
+      {
+        for (; inserted < codegen::util::OAHashTable::kDefaultInitialSize;
+             inserted++) {
+          Insert({1, inserted}, v);
+        }
+      },
+      OutOfMemoryException);
+
+  // The table is resized once it is half full
+  EXPECT_EQ(codegen::util::OAHashTable::kDefaultInitialSize / 2, inserted);
+
+  // Destroying the table returns all of its memory to the budget
+  hash_table.Destroy();
+  EXPECT_EQ(0U, context.GetMemoryBudget().GetUsed());
+  hash_table.Init(sizeof(Key), sizeof(Value));
+}
+
 TEST_F(OAHashTableTest, CanCodegenProbeOrInsert) {}
 
 TEST_F(OAHashTableTest, MicroBenchmark) {
@@ -12,8 +12,10 @@
 
 #include "codegen/query_compiler.h"
 #include "common/harness.h"
+#include "planner/limit_plan.h"
 #include "planner/order_by_plan.h"
 #include "planner/seq_scan_plan.h"
+#include "type/value_factory.h"
 
 #include "codegen/testing_codegen_util.h"
 
@@ -195,5 +197,48 @@ TEST_F(OrderByTranslatorTest, MultiIntColMixedTest) {
       }));
 }
 
+TEST_F(OrderByTranslatorTest, LimitTest) {
+  //
+  // SELECT * FROM test_table ORDER BY a DESC LIMIT 5 OFFSET 3;
+  //
+
+  // Load table with 20 rows
+  uint32_t num_test_rows = 20;
+  LoadTestTable(TestTableId(), num_test_rows);
+
+  // The limit is pushed into the sort, which only keeps the first eight rows
+  std::unique_ptr<planner::LimitPlan> limit_plan{new planner::LimitPlan(5, 3)};
+  std::unique_ptr<planner::OrderByPlan> order_by_plan{
+      new planner::OrderByPlan({0}, {true}, {0, 1, 2, 3})};
+  order_by_plan->SetLimit(true);
+  order_by_plan->SetLimitNumber(5);
+  order_by_plan->SetLimitOffset(3);
+  std::unique_ptr<planner::SeqScanPlan> seq_scan_plan{new planner::SeqScanPlan(
+      &GetTestTable(TestTableId()), nullptr, {0, 1, 2, 3})};
+
+  order_by_plan->AddChild(std::move(seq_scan_plan));
+  limit_plan->AddChild(std::move(order_by_plan));
+
+  // Do binding
+  planner::BindingContext context;
+  limit_plan->PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+
+  // COMPILE and execute
+  CompileAndExecute(*limit_plan, buffer,
+                    reinterpret_cast<char *>(buffer.GetState()));
+
+  // Rows 16 down to 12
+  auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(5, results.size());
+  for (uint32_t i = 0; i < results.size(); i++) {
+    EXPECT_EQ(type::CMP_TRUE,
+              results[i].GetValue(0).CompareEquals(
+                  type::ValueFactory::GetIntegerValue(10 * (16 - i))));
+  }
+}
+
 }  // namespace test
 }  // namespace peloton
\ No newline at end of file
@@ -10,11 +10,13 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cstdlib>
 
 #include "common/harness.h"
 #include "common/timer.h"
 #include "codegen/util/sorter.h"
+#include "settings/settings_manager.h"
 
 namespace peloton {
 namespace test {
@@ -34,6 +36,11 @@ static int CompareTuplesForAscending(const char *a, const char *b) {
   return at->col_b - bt->col_b;
 }
 
+// A prefix of column B that leaves ties for the comparison function to break
+static uint64_t ColumnBPrefix(const char *a) {
+  return reinterpret_cast<const TestTuple *>(a)->col_b / 16;
+}
+
 class SorterTest : public PelotonTest {
  public:
   SorterTest() {
@@ -103,5 +110,77 @@ TEST_F(SorterTest, BenchmarkSorter) {
   TestSort(5000000);
 }
 
+TEST_F(SorterTest, CanSortTopK) {
+  const uint64_t top_k = 10;
+  sorter.Destroy();
+  sorter.Init(CompareTuplesForAscending, sizeof(TestTuple), top_k);
+
+  std::vector<uint32_t> col_b_values;
+  for (uint32_t i = 0; i < 1000; i++) {
+    TestTuple *tuple = reinterpret_cast<TestTuple *>(sorter.StoreInputTuple());
+    tuple->col_a = i;
+    tuple->col_b = rand() % 1000;
+    col_b_values.push_back(tuple->col_b);
+  }
+  sorter.Sort();
+
+  // Only the k smallest tuples are kept, in order
+  std::sort(col_b_values.begin(), col_b_values.end());
+  std::vector<uint32_t> results;
+  for (auto iter : sorter) {
+    results.push_back(reinterpret_cast<const TestTuple *>(iter)->col_b);
+  }
+  ASSERT_EQ(top_k, results.size());
+  for (uint32_t i = 0; i < top_k; i++) {
+    EXPECT_EQ(col_b_values[i], results[i]);
+  }
+}
+
+TEST_F(SorterTest, CanSortWithKeyPrefix) {
+  sorter.Destroy();
+  sorter.Init(CompareTuplesForAscending, sizeof(TestTuple), 0, ColumnBPrefix);
+
+  // Enough tuples to be sorted in parallel runs. The other columns must still
+  // belong to the same tuple after the tuples are permuted into place.
+  const uint32_t num_tuples = 500000;
+  for (uint32_t i = 0; i < num_tuples; i++) {
+    TestTuple *tuple = reinterpret_cast<TestTuple *>(sorter.StoreInputTuple());
+    tuple->col_a = i;
+    tuple->col_b = rand() % 100000;
+    tuple->col_c = tuple->col_b + i;
+  }
+  sorter.Sort();
+
+  uint32_t num_results = 0;
+  uint32_t last_col_b = 0;
+  std::vector<bool> seen(num_tuples, false);
+  for (auto iter : sorter) {
+    const auto *tuple = reinterpret_cast<const TestTuple *>(iter);
+    EXPECT_LE(last_col_b, tuple->col_b);
+    EXPECT_EQ(tuple->col_b + tuple->col_a, tuple->col_c);
+    ASSERT_LT(tuple->col_a, num_tuples);
+    EXPECT_FALSE(seen[tuple->col_a]);
+    seen[tuple->col_a] = true;
+    last_col_b = tuple->col_b;
+    num_results++;
+  }
+  EXPECT_EQ(num_tuples, num_results);
+}
+
+TEST_F(SorterTest, CanSortWithSpilledRuns) {
+  // With a 64 KB budget, a sorted run is spilled about every 4K tuples
+  auto old_budget = settings::SettingsManager::GetInt(
+      settings::SettingId::sort_memory_budget);
+  settings::SettingsManager::SetInt(settings::SettingId::sort_memory_budget,
+                                    64);
+  sorter.Destroy();
+  sorter.Init(CompareTuplesForAscending, sizeof(TestTuple));
+
+  TestSort(100000);
+
+  settings::SettingsManager::SetInt(settings::SettingId::sort_memory_budget,
+                                    old_budget);
+}
+
 }  // namespace test
 }  // namespace peloton
\ No newline at end of file
@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// numa_topology_test.cpp
+//
+// Identification: test/common/numa_topology_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <thread>
+
+#include "common/harness.h"
+
+#include "common/numa_topology.h"
+#include "storage/backend_manager.h"
+#include "storage/data_table.h"
+#include "executor/testing_executor_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// NUMA Topology Tests
+//===--------------------------------------------------------------------===//
+
+class NumaTopologyTests : public PelotonTest {};
+
+TEST_F(NumaTopologyTests, ParseCpuListTest) {
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 8, 10, 11}),
+            NumaTopology::ParseCpuList("0-3,8,10-11"));
+  EXPECT_EQ(std::vector<int>({5}), NumaTopology::ParseCpuList("5\n"));
+  EXPECT_TRUE(NumaTopology::ParseCpuList("").empty());
+}
+
+TEST_F(NumaTopologyTests, DisabledTest) {
+  auto &numa_topology = NumaTopology::GetInstance();
+  numa_topology.Configure(false);
+
+  EXPECT_FALSE(numa_topology.IsEnabled());
+  EXPECT_LE(1UL, numa_topology.GetNodeCount());
+  EXPECT_EQ(NumaTopology::ANY_NODE, numa_topology.GetCurrentNode());
+  EXPECT_EQ(NumaTopology::ANY_NODE, numa_topology.PinThreadToNextNode());
+}
+
+TEST_F(NumaTopologyTests, SimulatedTest) {
+  auto &numa_topology = NumaTopology::GetInstance();
+  if (std::thread::hardware_concurrency() < 2) {
+    return;
+  }
+  numa_topology.Configure(true, 2);
+
+  EXPECT_TRUE(numa_topology.IsSimulated());
+  ASSERT_EQ(2UL, numa_topology.GetNodeCount());
+  EXPECT_FALSE(numa_topology.GetNodeCpus(0).empty());
+  EXPECT_FALSE(numa_topology.GetNodeCpus(1).empty());
+
+  // Threads are pinned in round robin order
+  int first_node = NumaTopology::ANY_NODE;
+  int second_node = NumaTopology::ANY_NODE;
+  std::thread first([&] {
+    first_node = numa_topology.PinThreadToNextNode();
+    EXPECT_EQ(first_node, numa_topology.GetCurrentNode());
+  });
+  first.join();
+  std::thread second([&] {
+    second_node = numa_topology.PinThreadToNextNode();
+    EXPECT_EQ(second_node, numa_topology.GetCurrentNode());
+
+    // Allocations can be directed to another node
+    {
+      NumaNodeScope numa_scope(1 - second_node);
+      EXPECT_EQ(1 - second_node, numa_topology.GetAllocationNode());
+    }
+    EXPECT_EQ(second_node, numa_topology.GetAllocationNode());
+  });
+  second.join();
+  EXPECT_EQ(0, first_node);
+  EXPECT_EQ(1, second_node);
+
+  numa_topology.Configure(false);
+}
+
+TEST_F(NumaTopologyTests, AllocateTest) {
+  auto &numa_topology = NumaTopology::GetInstance();
+  auto &backend_manager = storage::BackendManager::GetInstance();
+  numa_topology.Configure(true);
+
+  // Large allocations get node memory of their own, small ones stay on the
+  // heap. Both are released the same way.
+  NumaNodeScope numa_scope(0);
+  for (size_t size : {100UL, 1UL << 20}) {
+    auto data = reinterpret_cast<char *>(
+        backend_manager.Allocate(BackendType::MM, size));
+    ASSERT_NE(nullptr, data);
+    EXPECT_EQ(0UL, reinterpret_cast<uintptr_t>(data) % 16);
+    PL_MEMSET(data, 1, size);
+    EXPECT_EQ(1, data[size - 1]);
+    backend_manager.Release(BackendType::MM, data);
+  }
+
+#ifdef __linux__
+  void *node_memory = numa_topology.AllocateOnNode(1 << 20, 0);
+  EXPECT_NE(nullptr, node_memory);
+  numa_topology.FreeOnNode(node_memory, 1 << 20);
+#endif
+
+  numa_topology.Configure(false);
+  EXPECT_EQ(nullptr, numa_topology.AllocateOnNode(1 << 20, 0));
+}
+
+TEST_F(NumaTopologyTests, PartitionedTableTest) {
+  auto &numa_topology = NumaTopology::GetInstance();
+  if (std::thread::hardware_concurrency() < 2) {
+    return;
+  }
+  numa_topology.Configure(true, 2);
+  storage::DataTable::SetActiveTileGroupCount(3);
+  storage::DataTable::SetNumaPartitioning(true);
+
+  // Every node gets the same number of active tile groups
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(5));
+  EXPECT_EQ(2UL, table->GetNumaNodeCount());
+  EXPECT_EQ(4UL, table->GetTileGroupCount());
+
+  // Inserts of threads on different nodes go to different tile groups
+  ItemPointer locations[2];
+  for (int node = 0; node < 2; node++) {
+    std::thread inserter([&] {
+      numa_topology.PinThread(node);
+      locations[node] = table->GetEmptyTupleSlot(nullptr);
+    });
+    inserter.join();
+  }
+  EXPECT_NE(locations[0].block, locations[1].block);
+
+  storage::DataTable::SetNumaPartitioning(false);
+  storage::DataTable::SetActiveTileGroupCount(1);
+  numa_topology.Configure(false);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,252 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// epoch_reclaimer_test.cpp
+//
+// Identification: test/container/epoch_reclaimer_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "container/epoch_reclaimer.h"
+
+#include "common/harness.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// EpochReclaimer Test
+//===--------------------------------------------------------------------===//
+
+class EpochReclaimerTests : public PelotonTest {};
+
+// Frees an int and counts the call in the owner
+static void FreeCountedInt(void *object, void *owner) {
+  delete static_cast<int *>(object);
+  static_cast<std::atomic<int> *>(owner)->fetch_add(1);
+}
+
+TEST_F(EpochReclaimerTests, RetireTest) {
+  auto &reclaimer = EpochReclaimer::GetInstance();
+  std::atomic<int> freed_count(0);
+
+  reclaimer.Retire(new int(1), FreeCountedInt, &freed_count);
+  reclaimer.Retire(new int(2), FreeCountedInt, &freed_count);
+  EXPECT_EQ(0, freed_count.load());
+  EXPECT_LE(2UL, reclaimer.GetGarbageCount());
+
+  // No thread is in a critical section, so everything can be freed
+  auto epoch = reclaimer.GetCurrentEpoch();
+  reclaimer.ReclaimAll();
+  EXPECT_EQ(2, freed_count.load());
+  EXPECT_LT(epoch, reclaimer.GetCurrentEpoch());
+}
+
+TEST_F(EpochReclaimerTests, GuardTest) {
+  auto &reclaimer = EpochReclaimer::GetInstance();
+  std::atomic<int> freed_count(0);
+
+  {
+    EpochGuard guard;
+    EXPECT_TRUE(reclaimer.InCriticalSection());
+
+    // Nested sections are allowed
+    {
+      EpochGuard nested_guard;
+      reclaimer.Retire(new int(1), FreeCountedInt, &freed_count);
+    }
+    EXPECT_TRUE(reclaimer.InCriticalSection());
+
+    // This thread could still see the object
+    reclaimer.Reclaim();
+    reclaimer.ReclaimAll();
+    EXPECT_EQ(0, freed_count.load());
+  }
+  EXPECT_FALSE(reclaimer.InCriticalSection());
+
+  reclaimer.Reclaim();
+  EXPECT_EQ(1, freed_count.load());
+}
+
+TEST_F(EpochReclaimerTests, ReaderTest) {
+  auto &reclaimer = EpochReclaimer::GetInstance();
+  std::atomic<int> freed_count(0);
+  std::atomic<bool> entered(false);
+  std::atomic<bool> done(false);
+
+  // A reader that entered before the object was retired
+  std::thread reader([&] {
+    EpochGuard guard;
+    entered = true;
+    while (done.load() == false) {
+      std::this_thread::yield();
+    }
+  });
+  while (entered.load() == false) {
+    std::this_thread::yield();
+  }
+
+  reclaimer.Retire(new int(1), FreeCountedInt, &freed_count);
+  reclaimer.ReclaimAll();
+  EXPECT_EQ(0, freed_count.load());
+
+  // Objects retired by a reader are protected from other threads as well
+  {
+    EpochGuard guard;
+    reclaimer.ReclaimAll();
+    EXPECT_EQ(0, freed_count.load());
+  }
+
+  done = true;
+  reader.join();
+
+  reclaimer.ReclaimAll();
+  EXPECT_EQ(1, freed_count.load());
+}
+
+TEST_F(EpochReclaimerTests, ReclaimOwnerTest) {
+  auto &reclaimer = EpochReclaimer::GetInstance();
+  std::atomic<int> freed_count(0);
+  std::atomic<int> other_freed_count(0);
+
+  {
+    EpochGuard guard;
+    reclaimer.Retire(new int(1), FreeCountedInt, &freed_count);
+    reclaimer.Retire(new int(2), FreeCountedInt, &other_freed_count);
+    reclaimer.Retire(new int(3), FreeCountedInt, &freed_count);
+
+    // Freed regardless of the epoch, other owners are not touched
+    EXPECT_EQ(2UL, reclaimer.ReclaimOwner(&freed_count));
+    EXPECT_EQ(2, freed_count.load());
+    EXPECT_EQ(0, other_freed_count.load());
+  }
+
+  reclaimer.ReclaimAll();
+  EXPECT_EQ(1, other_freed_count.load());
+}
+
+// Owner of retired objects, like a tree and its nodes. Destroy() stands in
+// for the destructor, so freeing an object after it is detected.
+struct TestTree {
+  void Destroy() {
+    EpochReclaimer::GetInstance().ReclaimOwner(this);
+    destroyed = true;
+  }
+
+  std::atomic<bool> destroyed{false};
+  std::atomic<bool> in_deleter{false};
+  std::atomic<bool> release_deleter{false};
+  std::atomic<int> freed_count{0};
+};
+
+// Frees a node of a tree, blocking the first call until it is released
+static void FreeTreeNode(void *object, void *owner) {
+  auto tree = static_cast<TestTree *>(owner);
+  if (tree->in_deleter.exchange(true) == false) {
+    while (tree->release_deleter.load() == false) {
+      std::this_thread::yield();
+    }
+  }
+  EXPECT_FALSE(tree->destroyed.load());
+  delete static_cast<int *>(object);
+  tree->freed_count++;
+}
+
+TEST_F(EpochReclaimerTests, DestroyDuringCollectTest) {
+  auto &reclaimer = EpochReclaimer::GetInstance();
+  TestTree tree;
+
+  reclaimer.Retire(new int(1), FreeTreeNode, &tree);
+  reclaimer.Retire(new int(2), FreeTreeNode, &tree);
+
+  // Collects the first node and blocks in its deleter
+  std::thread collector([&] { reclaimer.ReclaimAll(); });
+  while (tree.in_deleter.load() == false) {
+    std::this_thread::yield();
+  }
+
+  // The tree must not be destroyed while its node is still being freed
+  std::atomic<bool> destroy_done(false);
+  std::thread destroyer([&] {
+    tree.Destroy();
+    destroy_done = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(destroy_done.load());
+
+  tree.release_deleter = true;
+  collector.join();
+  destroyer.join();
+
+  EXPECT_TRUE(tree.destroyed.load());
+  EXPECT_EQ(2, tree.freed_count.load());
+}
+
+// An owner destroyed by a deleter of its own thread's collection
+static void FreeTree(void *object, UNUSED_ATTRIBUTE void *owner) {
+  auto tree = static_cast<TestTree *>(object);
+  tree->Destroy();
+  delete tree;
+}
+
+TEST_F(EpochReclaimerTests, DestroyInDeleterTest) {
+  auto &reclaimer = EpochReclaimer::GetInstance();
+  std::atomic<int> freed_count(0);
+
+  auto tree = new TestTree();
+  tree->release_deleter = true;
+  reclaimer.Retire(tree, FreeTree);
+  reclaimer.Retire(new int(1), FreeTreeNode, tree);
+  reclaimer.Retire(new int(2), FreeCountedInt, &freed_count);
+
+  // Must not wait for its own collection. Destroying the tree frees its
+  // node before the collection gets to it.
+  reclaimer.ReclaimAll();
+  EXPECT_EQ(1, freed_count.load());
+  EXPECT_EQ(0UL, reclaimer.GetGarbageCount());
+}
+
+TEST_F(EpochReclaimerTests, ConcurrentTest) {
+  auto &reclaimer = EpochReclaimer::GetInstance();
+  std::atomic<int> freed_count(0);
+  std::atomic<int *> shared(new int(0));
+
+  const int thread_count = 4;
+  const int retire_count = 5000;
+  std::vector<std::thread> threads;
+  for (int thread_itr = 0; thread_itr < thread_count; thread_itr++) {
+    threads.emplace_back([&] {
+      for (int retire_itr = 0; retire_itr < retire_count; retire_itr++) {
+        EpochGuard guard;
+        // Replace the shared object, reading the old one before retiring it
+        int *old_value = shared.exchange(new int(retire_itr));
+        EXPECT_LE(0, *old_value);
+        reclaimer.Retire(old_value, FreeCountedInt, &freed_count);
+
+        // Any object still reachable must not have been freed
+        int *value = shared.load();
+        EXPECT_LE(0, *value);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Garbage of exited threads is freed by anyone reclaiming
+  reclaimer.ReclaimAll();
+  EXPECT_EQ(thread_count * retire_count, freed_count.load());
+
+  delete shared.load();
+}
+
+}  // namespace test
+}  // namespace peloton
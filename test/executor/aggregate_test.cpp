@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -22,6 +23,7 @@
 #include "type/value.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/aggregate_executor.h"
+#include "executor/aggregator.h"
 #include "executor/executor_context.h"
 #include "executor/logical_tile.h"
 #include "executor/logical_tile_factory.h"
@@ -29,6 +31,9 @@
 #include "planner/abstract_plan.h"
 #include "planner/aggregate_plan.h"
 #include "storage/data_table.h"
+#include "storage/table_factory.h"
+#include "storage/temp_table.h"
+#include "storage/tile_group.h"
 
 #include "executor/mock_executor.h"
 
@@ -863,5 +868,92 @@ TEST_F(AggregateTests, PlainSumCountDistinctTest) {
   EXPECT_TRUE(cmp == type::CMP_TRUE);
 }
 
+TEST_F(AggregateTests, HashSpillGroupByTest) {
+  // SELECT a, SUM(b) from table GROUP BY a;
+  // with a budget that only fits a single group in memory
+  const int tuple_count = 1000;
+  const int group_count = 200;
+
+  // 1) Set up group-by columns
+  std::vector<oid_t> group_by_columns = {0};
+
+  // 2) Set up project info
+  DirectMapList direct_map_list = {{0, {0, 0}}, {1, {1, 0}}};
+  std::unique_ptr<const planner::ProjectInfo> proj_info(
+      new planner::ProjectInfo(TargetList(), std::move(direct_map_list)));
+
+  // 3) Set up unique aggregates
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms;
+  planner::AggregatePlan::AggTerm sumB(
+      ExpressionType::AGGREGATE_SUM,
+      expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER, 0,
+                                                    1));
+  agg_terms.push_back(sumB);
+
+  // 4) Set up predicate (empty)
+  std::unique_ptr<const expression::AbstractExpression> predicate(nullptr);
+
+  // 5) Create output table schema
+  std::vector<catalog::Column> columns = {
+      catalog::Column(type::TypeId::VARCHAR, 32, "a", false),
+      catalog::Column(type::TypeId::INTEGER,
+                      type::Type::GetTypeSize(type::TypeId::INTEGER), "b",
+                      true)};
+  std::shared_ptr<const catalog::Schema> output_table_schema(
+      new catalog::Schema(columns));
+
+  planner::AggregatePlan node(std::move(proj_info), std::move(predicate),
+                              std::move(agg_terms), std::move(group_by_columns),
+                              output_table_schema, AggregateType::HASH);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+  context->GetMemoryBudget().SetLimit(1);
+  std::unique_ptr<storage::TempTable> output_table(
+      storage::TableFactory::GetTempTable(
+          const_cast<catalog::Schema *>(output_table_schema.get()), false));
+
+  std::map<std::string, int> expected;
+  {
+    executor::HashAggregator aggregator(&node, output_table.get(),
+                                        context.get(), 2);
+    for (int tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+      std::string key = "group_" + std::to_string(tuple_itr % group_count);
+      std::vector<type::Value> values = {
+          type::ValueFactory::GetVarcharValue(key),
+          type::ValueFactory::GetIntegerValue(tuple_itr)};
+      ContainerTuple<std::vector<type::Value>> tuple(&values);
+      EXPECT_TRUE(aggregator.Advance(&tuple));
+      expected[key] += tuple_itr;
+    }
+    EXPECT_TRUE(aggregator.Finalize());
+
+    // Every partition holds more than one group, so each of them has to be
+    // split again at least once
+    EXPECT_LT(0, aggregator.GetSpilledTupleCount());
+    EXPECT_LE(2, aggregator.GetMaxSpillDepth());
+    EXPECT_GE(HASH_AGGREGATE_MAX_SPILL_DEPTH, aggregator.GetMaxSpillDepth());
+  }
+  // The groups returned their memory to the budget of the query
+  EXPECT_EQ(0U, context->GetMemoryBudget().GetUsed());
+  txn_manager.CommitTransaction(txn);
+
+  // Every group is emitted exactly once with the complete sum
+  std::map<std::string, int> actual;
+  for (oid_t tile_group_itr = 0;
+       tile_group_itr < output_table->GetTileGroupCount(); tile_group_itr++) {
+    auto tile_group = output_table->GetTileGroup(tile_group_itr);
+    for (oid_t tuple_itr = 0; tuple_itr < tile_group->GetNextTupleSlot();
+         tuple_itr++) {
+      auto key = tile_group->GetValue(tuple_itr, 0).ToString();
+      EXPECT_EQ(0, actual.count(key));
+      actual[key] = tile_group->GetValue(tuple_itr, 1).GetAs<int32_t>();
+    }
+  }
+  EXPECT_EQ(expected, actual);
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -18,11 +18,17 @@
 #include "common/logger.h"
 #include "common/statement.h"
 #include "executor/copy_executor.h"
+#include "executor/executor_context.h"
+#include "executor/testing_executor_util.h"
 #include "executor/seq_scan_executor.h"
 #include "optimizer/optimizer.h"
 #include "optimizer/rule.h"
 #include "parser/postgresparser.h"
+#include "planner/copy_plan.h"
 #include "planner/seq_scan_plan.h"
+#include "storage/data_table.h"
+#include "storage/table_factory.h"
+#include "storage/tile_group.h"
 #include "include/traffic_cop/traffic_cop.h"
 
 #include "gtest/gtest.h"
@@ -151,5 +157,158 @@ TEST_F(CopyTests, Copying) {
   txn_manager.CommitTransaction(txn);
 }
 
+TEST_F(CopyTests, Importing) {
+  auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, true));
+
+  // Rows are out of primary key order, and use quoting and escaping
+  std::string file_path = "./copy_input.csv";
+  FILE* file = fopen(file_path.c_str(), "w");
+  ASSERT_NE(nullptr, file);
+  fputs("30,31,32.5,\"thirty, \"\"quoted\"\"\"\n", file);
+  fputs("10,11,12.5,ten\r\n", file);
+  fputs("20,21,22.5,twenty\n", file);
+  fclose(file);
+
+  planner::CopyPlan copy_plan(table.get(), file_path, ',', true);
+
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+  executor::CopyExecutor copy_executor(&copy_plan, context.get());
+  EXPECT_TRUE(copy_executor.Init());
+  EXPECT_TRUE(copy_executor.Execute());
+  EXPECT_FALSE(copy_executor.Execute());
+  EXPECT_EQ(3, context->num_processed);
+  txn_manager.CommitTransaction(txn);
+
+  EXPECT_EQ(3, table->GetTupleCount());
+
+  // The rows went in sorted on the primary key
+  auto tile_group = table->GetTileGroup(0);
+  for (oid_t tuple_itr = 0; tuple_itr < 3; tuple_itr++) {
+    int key = 10 * (tuple_itr + 1);
+    EXPECT_EQ(key, tile_group->GetValue(tuple_itr, 0).GetAs<int32_t>());
+    EXPECT_EQ(key + 1, tile_group->GetValue(tuple_itr, 1).GetAs<int32_t>());
+  }
+  EXPECT_EQ("ten", tile_group->GetValue(0, 3).ToString());
+  EXPECT_EQ("thirty, \"quoted\"", tile_group->GetValue(2, 3).ToString());
+
+  // Importing the same keys again violates the primary key
+  txn = txn_manager.BeginTransaction();
+  context.reset(new executor::ExecutorContext(txn));
+  executor::CopyExecutor duplicate_executor(&copy_plan, context.get());
+  EXPECT_TRUE(duplicate_executor.Init());
+  EXPECT_FALSE(duplicate_executor.Execute());
+  EXPECT_EQ(ResultType::FAILURE, txn->GetResult());
+  txn_manager.AbortTransaction(txn);
+
+  EXPECT_EQ(0, std::remove(file_path.c_str()));
+}
+
+TEST_F(CopyTests, ImportingTileGroups) {
+  auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, true));
+  size_t tile_group_count = table->GetTileGroupCount();
+
+  // Two tile groups worth of rows and two more, in reverse key order
+  int row_count = 2 * TESTS_TUPLES_PER_TILEGROUP + 2;
+  std::string data;
+  for (int row_itr = row_count; row_itr > 0; row_itr--) {
+    int key = 10 * row_itr;
+    data += std::to_string(key) + "," + std::to_string(key + 1) + ",1.5,r\n";
+  }
+  planner::CopyPlan copy_plan(table.get(), "", ',', true);
+  copy_plan.SetCopyData(std::string(data));
+
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+  executor::CopyExecutor copy_executor(&copy_plan, context.get());
+  EXPECT_TRUE(copy_executor.Init());
+  EXPECT_TRUE(copy_executor.Execute());
+  EXPECT_EQ(row_count, context->num_processed);
+  txn_manager.CommitTransaction(txn);
+
+  EXPECT_EQ(row_count, table->GetTupleCount());
+
+  // The first rows in key order filled two new tile groups, the last two
+  // went into the active tile group
+  ASSERT_EQ(tile_group_count + 2, table->GetTileGroupCount());
+  for (int tuple_itr = 0; tuple_itr < 2 * TESTS_TUPLES_PER_TILEGROUP;
+       tuple_itr++) {
+    auto tile_group = table->GetTileGroup(
+        tile_group_count + tuple_itr / TESTS_TUPLES_PER_TILEGROUP);
+    EXPECT_EQ(10 * (tuple_itr + 1),
+              tile_group->GetValue(tuple_itr % TESTS_TUPLES_PER_TILEGROUP, 0)
+                  .GetAs<int32_t>());
+  }
+  for (oid_t index_itr = 0; index_itr < table->GetIndexCount(); index_itr++) {
+    std::vector<ItemPointer*> entries;
+    table->GetIndex(index_itr)->ScanAllKeys(entries);
+    EXPECT_EQ(static_cast<size_t>(row_count), entries.size());
+  }
+
+  // A key that repeats within a new tile group violates the primary key
+  std::unique_ptr<storage::DataTable> duplicate_table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, true));
+  planner::CopyPlan duplicate_plan(duplicate_table.get(), "", ',', true);
+  duplicate_plan.SetCopyData("10,11,1.5,r\n" + data);
+  txn = txn_manager.BeginTransaction();
+  context.reset(new executor::ExecutorContext(txn));
+  executor::CopyExecutor duplicate_executor(&duplicate_plan, context.get());
+  EXPECT_TRUE(duplicate_executor.Init());
+  EXPECT_FALSE(duplicate_executor.Execute());
+  EXPECT_EQ(ResultType::FAILURE, txn->GetResult());
+  txn_manager.AbortTransaction(txn);
+}
+
+TEST_F(CopyTests, ImportingFromStdin) {
+  auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  // In a table of one column, an empty line is a row with an empty value
+  auto schema = new catalog::Schema({TestingExecutorUtil::GetColumnInfo(3)});
+  std::unique_ptr<storage::DataTable> table(
+      storage::TableFactory::GetDataTable(INVALID_OID, INVALID_OID, schema,
+                                          "copy_table",
+                                          TESTS_TUPLES_PER_TILEGROUP, true,
+                                          false));
+  planner::CopyPlan copy_plan(table.get(), "", '\t', false);
+  ASSERT_TRUE(copy_plan.IsCopyFromStdin());
+  copy_plan.SetCopyData("a\n\nb\n");
+
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+  executor::CopyExecutor copy_executor(&copy_plan, context.get());
+  EXPECT_TRUE(copy_executor.Init());
+  EXPECT_TRUE(copy_executor.Execute());
+  EXPECT_EQ(3, context->num_processed);
+  txn_manager.CommitTransaction(txn);
+
+  auto tile_group = table->GetTileGroup(0);
+  EXPECT_EQ("a", tile_group->GetValue(0, 0).ToString());
+  EXPECT_EQ("", tile_group->GetValue(1, 0).ToString());
+  EXPECT_EQ("b", tile_group->GetValue(2, 0).ToString());
+
+  copy_plan.ClearCopyData();
+  EXPECT_TRUE(copy_plan.GetCopyData().empty());
+
+  // Fields are parsed as the column type, and checked against its range
+  std::unique_ptr<storage::DataTable> typed_table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, false));
+  planner::CopyPlan typed_plan(typed_table.get(), "", ',', true);
+  typed_plan.SetCopyData("1,2,3.5,x\n4294967296,5,6.5,y\n");
+
+  txn = txn_manager.BeginTransaction();
+  context.reset(new executor::ExecutorContext(txn));
+  executor::CopyExecutor typed_executor(&typed_plan, context.get());
+  EXPECT_TRUE(typed_executor.Init());
+  EXPECT_THROW(typed_executor.Execute(), ExecutorException);
+  txn_manager.AbortTransaction(txn);
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -80,7 +80,7 @@ std::vector<JoinType> join_types = {JoinType::INNER, JoinType::LEFT,
                                     JoinType::RIGHT, JoinType::OUTER};
 
 void ExecuteJoinTest(PlanNodeType join_algorithm, JoinType join_type,
-                     oid_t join_test_type);
+                     oid_t join_test_type, bool spill_hash_join = false);
 void ExecuteNestedLoopJoinTest(JoinType join_type, bool IndexScan = false);
 
 void PopulateTable(storage::DataTable *table, int num_rows, bool random,
@@ -217,6 +217,17 @@ TEST_F(JoinTests, SpeedTest) {
   ExecuteNestedLoopJoinTest(JoinType::OUTER, false);
 }
 
+TEST_F(JoinTests, HashJoinSpillTest) {
+  // The build side of the hash join exceeds its budget right away, so both
+  // sides are joined from spill files
+  for (auto join_test_type : {BASIC_TEST, COMPLICATED_TEST, LEFT_TABLE_EMPTY}) {
+    for (auto join_type : join_types) {
+      LOG_TRACE("JOIN TYPE :: %s", JoinTypeToString(join_type).c_str());
+      ExecuteJoinTest(PlanNodeType::HASHJOIN, join_type, join_test_type, true);
+    }
+  }
+}
+
 TEST_F(JoinTests, BasicNestedLoopTest) {
   LOG_TRACE("PlanNodeType::NESTLOOP");
   ExecuteNestedLoopJoinTest(JoinType::INNER, true);
@@ -456,7 +467,7 @@ void ExecuteNestedLoopJoinTest(JoinType join_type, bool IndexScan) {
 }
 
 void ExecuteJoinTest(PlanNodeType join_algorithm, JoinType join_type,
-                     oid_t join_test_type) {
+                     oid_t join_test_type, bool spill_hash_join) {
   //===--------------------------------------------------------------------===//
   // Mock table scan executors
   //===--------------------------------------------------------------------===//
@@ -713,8 +724,15 @@ void ExecuteJoinTest(PlanNodeType join_algorithm, JoinType join_type,
       // Create hash plan node
       planner::HashPlan hash_plan_node(hash_keys);
 
+      // A query memory budget of a single byte makes the hash table spill
+      std::unique_ptr<executor::ExecutorContext> context;
+      if (spill_hash_join) {
+        context.reset(new executor::ExecutorContext(nullptr));
+        context->GetMemoryBudget().SetLimit(1);
+      }
+
       // Construct the hash executor
-      executor::HashExecutor hash_executor(&hash_plan_node, nullptr);
+      executor::HashExecutor hash_executor(&hash_plan_node, context.get());
 
       // Create hash join plan node.
       planner::HashJoinPlan hash_join_plan_node(join_type, std::move(predicate),
@@ -725,7 +743,7 @@ void ExecuteJoinTest(PlanNodeType join_algorithm, JoinType join_type,
 
       // Construct the hash join executor
       executor::HashJoinExecutor hash_join_executor(&hash_join_plan_node,
-                                                    nullptr);
+                                                    context.get());
 
       // Construct the executor tree
       hash_join_executor.AddChild(&left_table_scan_executor);
@@ -747,6 +765,7 @@ void ExecuteJoinTest(PlanNodeType join_algorithm, JoinType join_type,
           LOG_TRACE("%s", result_logical_tile->GetInfo().c_str());
         }
       }
+      EXPECT_EQ(spill_hash_join, hash_executor.IsSpilled());
 
     } break;
 
@@ -30,6 +30,7 @@
 #include "executor/logical_tile_factory.h"
 #include "executor/seq_scan_executor.h"
 #include "expression/abstract_expression.h"
+#include "expression/comparison_expression.h"
 #include "expression/expression_util.h"
 #include "planner/seq_scan_plan.h"
 #include "storage/data_table.h"
@@ -269,6 +270,62 @@ TEST_F(SeqScanTests, TwoTileGroupsWithPredicateTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+// Sequential scan of table with a predicate whose conjuncts are filtered a
+// tile group at a time: an IN over integer constants and LIKE patterns.
+TEST_F(SeqScanTests, BatchFilterPredicateTest) {
+  std::unique_ptr<storage::DataTable> table(CreateTable());
+  std::vector<oid_t> column_ids({0, 1, 3});
+
+  // The first column is one of tuples 0, 1 and 3
+  std::vector<expression::AbstractExpression *> list;
+  for (oid_t tuple_id : {0, 1, 3}) {
+    list.push_back(expression::ExpressionUtil::ConstantValueFactory(
+        type::ValueFactory::GetIntegerValue(
+            TestingExecutorUtil::PopulatedValue(tuple_id, 0))));
+  }
+  list.push_back(expression::ExpressionUtil::ConstantValueFactory(
+      type::ValueFactory::GetIntegerValue(1000)));
+  auto in_list = new expression::ComparisonExpression(
+      ExpressionType::COMPARE_IN,
+      expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER, 0,
+                                                    0),
+      list);
+
+  // The last column ends with a 3, but does not start with a 1, which drops
+  // tuple 1
+  auto like = expression::ExpressionUtil::ComparisonFactory(
+      ExpressionType::COMPARE_LIKE,
+      expression::ExpressionUtil::TupleValueFactory(type::TypeId::VARCHAR, 0,
+                                                    3),
+      expression::ExpressionUtil::ConstantValueFactory(
+          type::ValueFactory::GetVarcharValue("%3")));
+  auto not_like = expression::ExpressionUtil::ComparisonFactory(
+      ExpressionType::COMPARE_NOTLIKE,
+      expression::ExpressionUtil::TupleValueFactory(type::TypeId::VARCHAR, 0,
+                                                    3),
+      expression::ExpressionUtil::ConstantValueFactory(
+          type::ValueFactory::GetVarcharValue("1%")));
+  EXPECT_TRUE(in_list->IsBatchFilter());
+  EXPECT_TRUE(static_cast<expression::ComparisonExpression *>(like)
+                  ->IsBatchFilter());
+
+  auto predicate = expression::ExpressionUtil::ConjunctionFactory(
+      ExpressionType::CONJUNCTION_AND, in_list,
+      expression::ExpressionUtil::ConjunctionFactory(
+          ExpressionType::CONJUNCTION_AND, like, not_like));
+  planner::SeqScanPlan node(table.get(), predicate, column_ids);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  executor::SeqScanExecutor executor(&node, context.get());
+  RunTest(executor, table->GetTileGroupCount(), column_ids.size());
+
+  txn_manager.CommitTransaction(txn);
+}
+
 // Sequential scan of logical tile with predicate.
 TEST_F(SeqScanTests, NonLeafNodePredicateTest) {
   // No table for this case as seq scan is not a leaf node.
@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// in_list_set_test.cpp
+//
+// Identification: test/function/in_list_set_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include "common/harness.h"
+
+#include "function/in_list_set.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+class InListSetTests : public PelotonTest {};
+
+TEST_F(InListSetTests, IntegerTest) {
+  // Close together, a bitmap
+  function::InListSet small({type::ValueFactory::GetIntegerValue(3),
+                             type::ValueFactory::GetIntegerValue(7),
+                             type::ValueFactory::GetIntegerValue(5)});
+  EXPECT_TRUE(small.HasBitmap());
+  EXPECT_EQ(type::CMP_TRUE,
+            small.Find(type::ValueFactory::GetIntegerValue(7)));
+  EXPECT_EQ(type::CMP_TRUE,
+            small.Find(type::ValueFactory::GetBigIntValue(3)));
+  EXPECT_EQ(type::CMP_FALSE,
+            small.Find(type::ValueFactory::GetIntegerValue(4)));
+  EXPECT_EQ(type::CMP_FALSE,
+            small.Find(type::ValueFactory::GetIntegerValue(-100)));
+  EXPECT_EQ(type::CMP_NULL, small.Find(type::ValueFactory::GetNullValueByType(
+                                type::TypeId::INTEGER)));
+
+  // Far apart, a hash set
+  function::InListSet sparse({type::ValueFactory::GetBigIntValue(1),
+                              type::ValueFactory::GetBigIntValue(1000000)});
+  EXPECT_FALSE(sparse.HasBitmap());
+  EXPECT_EQ(type::CMP_TRUE,
+            sparse.Find(type::ValueFactory::GetIntegerValue(1000000)));
+  EXPECT_EQ(type::CMP_FALSE,
+            sparse.Find(type::ValueFactory::GetIntegerValue(2)));
+
+  // The probes of compiled queries
+  EXPECT_TRUE(small.ContainsInteger(5));
+  EXPECT_FALSE(small.ContainsInteger(6));
+  EXPECT_TRUE(sparse.ContainsInteger(1000000));
+  EXPECT_FALSE(sparse.ContainsInteger(5));
+
+  std::vector<int64_t> values = {5, 6, 1000000, 3, 9};
+  std::vector<uint32_t> sel(values.size());
+  EXPECT_EQ(2U, small.FindBatch(values.data(), values.size(), sel.data()));
+  EXPECT_EQ(0U, sel[0]);
+  EXPECT_EQ(3U, sel[1]);
+  EXPECT_EQ(1U, sparse.FindBatch(values.data(), values.size(), sel.data()));
+  EXPECT_EQ(2U, sel[0]);
+}
+
+TEST_F(InListSetTests, StringAndNullTest) {
+  function::InListSet strings({type::ValueFactory::GetVarcharValue("abc"),
+                               type::ValueFactory::GetVarcharValue("de")});
+  EXPECT_EQ(type::CMP_TRUE,
+            strings.Find(type::ValueFactory::GetVarcharValue("de")));
+  EXPECT_EQ(type::CMP_FALSE,
+            strings.Find(type::ValueFactory::GetVarcharValue("ab")));
+  EXPECT_TRUE(strings.ContainsString("abc", 4));
+  EXPECT_TRUE(strings.ContainsString("de", 2));
+  EXPECT_FALSE(strings.ContainsString("abc", 2));
+
+  // A NULL in the list makes a miss unknown
+  function::InListSet with_null(
+      {type::ValueFactory::GetIntegerValue(1),
+       type::ValueFactory::GetNullValueByType(type::TypeId::INTEGER)});
+  EXPECT_EQ(type::CMP_TRUE,
+            with_null.Find(type::ValueFactory::GetIntegerValue(1)));
+  EXPECT_EQ(type::CMP_NULL,
+            with_null.Find(type::ValueFactory::GetIntegerValue(2)));
+
+  // Other types are compared one by one
+  function::InListSet decimals({type::ValueFactory::GetDecimalValue(1.5),
+                                type::ValueFactory::GetDecimalValue(2.5)});
+  EXPECT_EQ(type::CMP_TRUE,
+            decimals.Find(type::ValueFactory::GetDecimalValue(2.5)));
+  EXPECT_EQ(type::CMP_FALSE,
+            decimals.Find(type::ValueFactory::GetDecimalValue(3.5)));
+}
+
+}  // namespace test
+}  // namespace peloton
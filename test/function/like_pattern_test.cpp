@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// like_pattern_test.cpp
+//
+// Identification: test/function/like_pattern_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "function/like_pattern.h"
+#include "function/string_functions.h"
+
+namespace peloton {
+namespace test {
+
+class LikePatternTests : public PelotonTest {};
+
+// Match with the compiled pattern and without, which must agree
+static bool Like(const std::string &str, const std::string &pattern,
+                 bool case_insensitive = false) {
+  function::LikePattern compiled(pattern, case_insensitive);
+  bool match = compiled.Match(str.data(), str.size());
+  EXPECT_EQ(match,
+            function::LikePattern::Match(str.data(), str.size(),
+                                         pattern.data(), pattern.size(),
+                                         case_insensitive));
+  return match;
+}
+
+TEST_F(LikePatternTests, KindTest) {
+  using Kind = function::LikePattern::Kind;
+  EXPECT_EQ(Kind::EXACT, function::LikePattern("abc").GetKind());
+  EXPECT_EQ(Kind::PREFIX, function::LikePattern("abc%").GetKind());
+  EXPECT_EQ(Kind::SUFFIX, function::LikePattern("%abc").GetKind());
+  EXPECT_EQ(Kind::CONTAINS, function::LikePattern("%%abc%").GetKind());
+  EXPECT_EQ(Kind::CONTAINS, function::LikePattern("%").GetKind());
+  EXPECT_EQ(Kind::GENERIC, function::LikePattern("a%c").GetKind());
+  EXPECT_EQ(Kind::GENERIC, function::LikePattern("ab_").GetKind());
+
+  // Escaped wildcards are part of the literal
+  function::LikePattern escaped("50\\%%");
+  EXPECT_EQ(Kind::PREFIX, escaped.GetKind());
+  EXPECT_EQ("50%", escaped.GetLiteral());
+  EXPECT_EQ("50%", escaped.GetPrefix());
+
+  EXPECT_EQ("ab", function::LikePattern("ab_d%").GetPrefix());
+  EXPECT_EQ("", function::LikePattern("%ab").GetPrefix());
+  EXPECT_EQ("", function::LikePattern("ab%", true).GetPrefix());
+}
+
+TEST_F(LikePatternTests, MatchTest) {
+  EXPECT_TRUE(Like("abc", "abc"));
+  EXPECT_FALSE(Like("abcd", "abc"));
+  EXPECT_TRUE(Like("abcd", "abc%"));
+  EXPECT_FALSE(Like("xabc", "abc%"));
+  EXPECT_TRUE(Like("xabc", "%abc"));
+  EXPECT_FALSE(Like("ab", "%abc"));
+  EXPECT_TRUE(Like("xxabcxx", "%abc%"));
+  EXPECT_FALSE(Like("xxabxcxx", "%abc%"));
+  EXPECT_TRUE(Like("", "%"));
+  EXPECT_TRUE(Like("", ""));
+  EXPECT_FALSE(Like("a", ""));
+
+  EXPECT_TRUE(Like("abc", "a_c"));
+  EXPECT_FALSE(Like("ac", "a_c"));
+  EXPECT_TRUE(Like("axxbxxc", "a%b%c"));
+  EXPECT_TRUE(Like("abcbc", "%b_"));
+  EXPECT_FALSE(Like("abcbcd", "%b_"));
+  EXPECT_TRUE(Like("mississippi", "m%iss%ppi"));
+  EXPECT_FALSE(Like("mississippi", "m%iss%ppx"));
+
+  EXPECT_TRUE(Like("50%", "50\\%"));
+  EXPECT_FALSE(Like("500", "50\\%"));
+  EXPECT_TRUE(Like("a_b", "a\\_b"));
+  EXPECT_FALSE(Like("axb", "a\\_b"));
+
+  EXPECT_TRUE(Like("ABCdef", "abc%", true));
+  EXPECT_TRUE(Like("xxABCxx", "%abc%", true));
+  EXPECT_TRUE(Like("AxC", "a_c", true));
+  EXPECT_FALSE(Like("ABCdef", "abc%"));
+}
+
+TEST_F(LikePatternTests, MatchBatchTest) {
+  std::vector<std::string> strs = {"apple", "banana", "grape", "pineapple",
+                                   "apricot"};
+  std::vector<const char *> data;
+  std::vector<uint32_t> lengths;
+  for (auto &str : strs) {
+    data.push_back(str.data());
+    lengths.push_back(str.size());
+  }
+  std::vector<uint32_t> sel(strs.size());
+
+  function::LikePattern prefix("ap%");
+  EXPECT_EQ(2U, prefix.MatchBatch(data.data(), lengths.data(), strs.size(),
+                                  sel.data()));
+  EXPECT_EQ(0U, sel[0]);
+  EXPECT_EQ(4U, sel[1]);
+
+  function::LikePattern generic("%p_e");
+  EXPECT_EQ(2U, generic.MatchBatch(data.data(), lengths.data(), strs.size(),
+                                   sel.data()));
+  EXPECT_EQ(0U, sel[0]);
+  EXPECT_EQ(3U, sel[1]);
+}
+
+TEST_F(LikePatternTests, MatchStringTest) {
+  // The strings of compiled queries may count their terminator
+  const char str[] = "peloton";
+  function::LikePattern suffix("%ton");
+  EXPECT_TRUE(suffix.MatchString(str, sizeof(str)));
+  EXPECT_TRUE(suffix.MatchString(str, sizeof(str) - 1));
+  EXPECT_FALSE(suffix.MatchString(str, 3));
+  EXPECT_FALSE(suffix.MatchString(nullptr, 0));
+}
+
+TEST_F(LikePatternTests, StringFunctionsTest) {
+  // Varchars count their terminator
+  const char str[] = "peloton";
+  EXPECT_TRUE(function::StringFunctions::Like(str, sizeof(str), "pel%", 5));
+  EXPECT_TRUE(function::StringFunctions::Like(str, sizeof(str), "%ton", 5));
+  EXPECT_FALSE(function::StringFunctions::Like(str, sizeof(str), "PEL%", 5));
+  EXPECT_TRUE(function::StringFunctions::ILike(str, sizeof(str), "PEL%", 5));
+}
+
+}  // namespace test
+}  // namespace peloton
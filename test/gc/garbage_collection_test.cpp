@@ -106,9 +106,8 @@ int GarbageNum(storage::DataTable *table) {
 // get tuple recycled by GC
 int RecycledNum(storage::DataTable *table) {
   int count = 0;
-  auto table_id = table->GetOid();
-  while (!gc::GCManagerFactory::GetInstance().ReturnFreeSlot(table_id).IsNull())
-    count++;
+  auto &recycled_slots = table->GetRecycledSlotAllocator();
+  while (!recycled_slots.Allocate().IsNull()) count++;
 
   LOG_INFO("recycled version num = %d", count);
   return count;
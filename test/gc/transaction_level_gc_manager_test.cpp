@@ -370,5 +370,58 @@ TEST_F(TransactionLevelGCManagerTests, ReInsertTest) {
   // EXPECT_FALSE(storage_manager->HasDatabase(db_id));
 }
 
+// garbage of every partition is collected by the owning gc thread
+TEST_F(TransactionLevelGCManagerTests, PartitionTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+  gc_manager.Reset();
+
+  EXPECT_EQ(GC_PARTITIONS_PER_THREAD, gc_manager.GetPartitionCount());
+
+  auto database = TestingExecutorUtil::InitializeDatabase("DATABASE2");
+  oid_t db_id = database->GetOid();
+
+  const int num_key = 10;
+  std::unique_ptr<storage::DataTable> table(TestingTransactionUtil::CreateTable(
+      num_key, "TABLE2", db_id, INVALID_OID, 1236, true));
+
+  // the partitions follow the size of the database, while the only gc thread
+  // stays active
+  gc_manager.ResizePartitions();
+  EXPECT_EQ(GC_MAX_PARTITIONS_PER_THREAD, gc_manager.GetMaxPartitionCount());
+  EXPECT_LE(1U, gc_manager.GetPartitionCount());
+  EXPECT_GE(gc_manager.GetMaxPartitionCount(), gc_manager.GetPartitionCount());
+  EXPECT_EQ(1, gc_manager.GetActiveThreadCount());
+
+  for (int key = 0; key < num_key; ++key) {
+    auto ret = UpdateTuple(table.get(), key);
+    EXPECT_TRUE(ret == ResultType::SUCCESS);
+  }
+
+  // workers do not help while the gc is not running
+  auto tile_group_id = table->GetTileGroup(0)->GetTileGroupId();
+  EXPECT_FALSE(gc_manager.HelpCollect(tile_group_id));
+
+  epoch_manager.SetCurrentEpochId(2);
+  auto expired_eid = epoch_manager.GetExpiredEpochId();
+  EXPECT_EQ(1, expired_eid);
+
+  // one garbage context per transaction
+  auto unlinked_count = gc_manager.Unlink(0, expired_eid);
+  EXPECT_EQ(num_key, unlinked_count);
+
+  epoch_manager.SetCurrentEpochId(3);
+  expired_eid = epoch_manager.GetExpiredEpochId();
+
+  auto reclaimed_count = gc_manager.Reclaim(0, expired_eid);
+  EXPECT_EQ(unlinked_count, reclaimed_count);
+
+  table.release();
+  TestingExecutorUtil::DeleteDatabase("DATABASE2");
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// connection_memory_test.cpp
+//
+// Identification: test/network/connection_memory_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <thread>
+
+#include <pqxx/pqxx> /* libpqxx is used to instantiate C++ client */
+
+#include "common/harness.h"
+#include "common/logger.h"
+#include "gtest/gtest.h"
+#include "network/network_manager.h"
+#include "util/string_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Connection Memory Tests
+//===--------------------------------------------------------------------===//
+
+class ConnectionMemoryTests : public PelotonTest {};
+
+// Most memory an idle connection may hold
+const size_t idle_connection_memory = 10 * 1024;
+
+static void LaunchMemoryServer(
+    peloton::network::NetworkManager network_manager, int port) {
+  try {
+    network_manager.SetPort(port);
+    network_manager.StartServer();
+  } catch (peloton::ConnectionException &exception) {
+    LOG_INFO("[LaunchServer] exception in thread");
+  }
+}
+
+TEST_F(ConnectionMemoryTests, BufferPoolTest) {
+  network::Buffer buffer;
+  EXPECT_EQ(0UL, buffer.GetMemoryUsage());
+  buffer.Acquire();
+  EXPECT_LE(static_cast<size_t>(SOCKET_BUFFER_SIZE), buffer.GetMemoryUsage());
+  auto memory = buffer.buf.data();
+
+  // The memory goes to the next buffer of the thread
+  buffer.Release();
+  EXPECT_EQ(0UL, buffer.GetMemoryUsage());
+  network::Buffer other_buffer;
+  other_buffer.Acquire();
+  EXPECT_EQ(memory, other_buffer.buf.data());
+  other_buffer.Release();
+}
+
+TEST_F(ConnectionMemoryTests, IdleConnectionTest) {
+  peloton::PelotonInit::Initialize();
+  peloton::network::NetworkManager network_manager;
+
+  int port = 15721;
+  std::thread server_thread(LaunchMemoryServer, network_manager, port);
+  while (!network_manager.GetIsStarted()) {
+    sleep(1);
+  }
+
+  try {
+    pqxx::connection C(StringUtil::Format(
+        "host=127.0.0.1 port=%d user=postgres sslmode=disable", port));
+    pqxx::work txn(C);
+    txn.exec("DROP TABLE IF EXISTS memory;");
+    txn.exec("CREATE TABLE memory(id INT, name VARCHAR(100));");
+    txn.exec("INSERT INTO memory VALUES (1, 'idle');");
+    pqxx::result R = txn.exec("SELECT * FROM memory;");
+    txn.commit();
+    EXPECT_EQ(1, static_cast<int>(R.size()));
+
+    // Let the server side of the connection go back to waiting
+    sleep(1);
+    auto conn = network::NetworkManager::GetConnection(
+        network::NetworkManager::recent_connfd);
+    EXPECT_NE(nullptr, conn);
+    if (conn != nullptr) {
+      LOG_INFO("Idle connection holds %lu bytes", conn->GetMemoryUsage());
+      EXPECT_GT(idle_connection_memory, conn->GetMemoryUsage());
+    }
+  } catch (const std::exception &e) {
+    LOG_INFO("[ConnectionMemoryTest] Exception occurred: %s", e.what());
+    EXPECT_TRUE(false);
+  }
+
+  network_manager.CloseServer();
+  server_thread.join();
+  peloton::PelotonInit::Shutdown();
+}
+
+}  // namespace test
+}  // namespace peloton
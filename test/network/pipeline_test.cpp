@@ -0,0 +1,245 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// pipeline_test.cpp
+//
+// Identification: test/network/pipeline_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include <pqxx/pqxx> /* libpqxx is used to instantiate C++ client */
+
+#include "common/harness.h"
+#include "common/logger.h"
+#include "gtest/gtest.h"
+#include "network/network_manager.h"
+#include "util/string_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Pipeline Tests
+//===--------------------------------------------------------------------===//
+
+class PipelineTests : public PelotonTest {};
+
+const int pipeline_length = 10;
+
+static void LaunchPipelineServer(
+    peloton::network::NetworkManager network_manager, int port) {
+  try {
+    network_manager.SetPort(port);
+    network_manager.StartServer();
+  } catch (peloton::ConnectionException &exception) {
+    LOG_INFO("[LaunchServer] exception in thread");
+  }
+}
+
+static void AppendInt(std::string &buf, int32_t value, size_t size) {
+  for (size_t i = size; i > 0; i--) {
+    buf.push_back(static_cast<char>((value >> (8 * (i - 1))) & 0xFF));
+  }
+}
+
+static void AppendString(std::string &buf, const std::string &value) {
+  buf.append(value);
+  buf.push_back('\0');
+}
+
+// A message of the frontend protocol, type is 0 for the startup packet
+static std::string MakeMessage(char type, const std::string &body) {
+  std::string msg;
+  if (type != 0) {
+    msg.push_back(type);
+  }
+  AppendInt(msg, body.size() + sizeof(int32_t), sizeof(int32_t));
+  return msg + body;
+}
+
+// Read messages until READY_FOR_QUERY, returning their types
+static std::string ReadResponseTypes(int sock_fd) {
+  std::string types, data;
+  char buf[4096];
+  size_t ptr = 0;
+  while (types.empty() == true || types.back() != 'Z') {
+    if (data.size() - ptr < 5) {
+      auto bytes = read(sock_fd, buf, sizeof(buf));
+      if (bytes <= 0) {
+        break;
+      }
+      data.append(buf, bytes);
+      continue;
+    }
+    uint32_t len = ntohl(*reinterpret_cast<const uint32_t *>(&data[ptr + 1]));
+    if (data.size() - ptr < len + 1) {
+      auto bytes = read(sock_fd, buf, sizeof(buf));
+      if (bytes <= 0) {
+        break;
+      }
+      data.append(buf, bytes);
+      continue;
+    }
+    types.push_back(data[ptr]);
+    ptr += len + 1;
+  }
+  return types;
+}
+
+static void RunPipelineClient(int port) {
+  try {
+    pqxx::connection C(StringUtil::Format(
+        "host=127.0.0.1 port=%d user=postgres sslmode=disable", port));
+    pqxx::work txn1(C);
+    txn1.exec("DROP TABLE IF EXISTS pipeline;");
+    txn1.exec("CREATE TABLE pipeline(a INT, b INT);");
+    txn1.commit();
+
+    int sock_fd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_LE(0, sock_fd);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+    ASSERT_EQ(0, connect(sock_fd, (struct sockaddr *)&addr, sizeof(addr)));
+
+    std::string startup;
+    AppendInt(startup, 196608, sizeof(int32_t));  // protocol 3.0
+    AppendString(startup, "user");
+    AppendString(startup, "postgres");
+    startup.push_back('\0');
+    startup = MakeMessage(0, startup);
+    ASSERT_EQ(static_cast<ssize_t>(startup.size()),
+              write(sock_fd, startup.data(), startup.size()));
+    EXPECT_EQ('Z', ReadResponseTypes(sock_fd).back());
+
+    // PARSE once, then every BIND/EXECUTE pair and the SYNC in one write
+    std::string parse;
+    AppendString(parse, "insert");
+    AppendString(parse, "INSERT INTO pipeline VALUES ($1, $2);");
+    AppendInt(parse, 2, 2);
+    AppendInt(parse, 23, 4);  // INT4
+    AppendInt(parse, 23, 4);
+    std::string pipeline = MakeMessage('P', parse);
+    for (int i = 0; i < pipeline_length; i++) {
+      std::string bind;
+      AppendString(bind, "");
+      AppendString(bind, "insert");
+      AppendInt(bind, 2, 2);
+      AppendInt(bind, 0, 2);  // text format
+      AppendInt(bind, 0, 2);
+      AppendInt(bind, 2, 2);
+      for (auto value : {std::to_string(i), std::to_string(i * 10)}) {
+        AppendInt(bind, value.size(), 4);
+        bind.append(value);
+      }
+      AppendInt(bind, 0, 2);
+      pipeline += MakeMessage('B', bind);
+
+      std::string execute;
+      AppendString(execute, "");
+      AppendInt(execute, 0, 4);
+      pipeline += MakeMessage('E', execute);
+    }
+    pipeline += MakeMessage('S', "");
+    ASSERT_EQ(static_cast<ssize_t>(pipeline.size()),
+              write(sock_fd, pipeline.data(), pipeline.size()));
+
+    // Results come in the order of the messages
+    std::string expected = "1";
+    for (int i = 0; i < pipeline_length; i++) {
+      expected += "2C";
+    }
+    expected += "Z";
+    EXPECT_EQ(expected, ReadResponseTypes(sock_fd));
+
+    // After a failed PARSE everything up to the SYNC is ignored, even if it
+    // arrives in a later read
+    std::string bad_parse;
+    AppendString(bad_parse, "");
+    AppendString(bad_parse, "SELEC a FROM pipeline;");
+    AppendInt(bad_parse, 0, 2);
+    std::string failed = MakeMessage('P', bad_parse);
+    ASSERT_EQ(static_cast<ssize_t>(failed.size()),
+              write(sock_fd, failed.data(), failed.size()));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::string unnamed_bind;
+    AppendString(unnamed_bind, "");
+    AppendString(unnamed_bind, "");
+    AppendInt(unnamed_bind, 0, 2);
+    AppendInt(unnamed_bind, 0, 2);
+    AppendInt(unnamed_bind, 0, 2);
+    std::string unnamed_execute;
+    AppendString(unnamed_execute, "");
+    AppendInt(unnamed_execute, 0, 4);
+    std::string ignored = MakeMessage('B', unnamed_bind) +
+                          MakeMessage('E', unnamed_execute) +
+                          MakeMessage('S', "");
+    ASSERT_EQ(static_cast<ssize_t>(ignored.size()),
+              write(sock_fd, ignored.data(), ignored.size()));
+    EXPECT_EQ("EZ", ReadResponseTypes(sock_fd));
+
+    // The SYNC ends the error state
+    std::string good_parse;
+    AppendString(good_parse, "");
+    AppendString(good_parse, "SELECT a FROM pipeline WHERE a = -1;");
+    AppendInt(good_parse, 0, 2);
+    std::string recovered = MakeMessage('P', good_parse) +
+                            MakeMessage('B', unnamed_bind) +
+                            MakeMessage('E', unnamed_execute) +
+                            MakeMessage('S', "");
+    ASSERT_EQ(static_cast<ssize_t>(recovered.size()),
+              write(sock_fd, recovered.data(), recovered.size()));
+    EXPECT_EQ("12CZ", ReadResponseTypes(sock_fd));
+    close(sock_fd);
+
+    // Every statement ran with its own parameters
+    pqxx::work txn2(C);
+    pqxx::result R = txn2.exec("SELECT a, b FROM pipeline;");
+    txn2.commit();
+    EXPECT_EQ(pipeline_length, static_cast<int>(R.size()));
+    int sum = 0;
+    for (const auto &row : R) {
+      EXPECT_EQ(row[0].as<int>() * 10, row[1].as<int>());
+      sum += row[0].as<int>();
+    }
+    EXPECT_EQ(pipeline_length * (pipeline_length - 1) / 2, sum);
+  } catch (const std::exception &e) {
+    LOG_INFO("[PipelineTest] Exception occurred: %s", e.what());
+    EXPECT_TRUE(false);
+  }
+}
+
+TEST_F(PipelineTests, BindExecutePipelineTest) {
+  peloton::PelotonInit::Initialize();
+  peloton::network::NetworkManager network_manager;
+
+  int port = 15721;
+  std::thread server_thread(LaunchPipelineServer, network_manager, port);
+  while (!network_manager.GetIsStarted()) {
+    sleep(1);
+  }
+
+  RunPipelineClient(port);
+
+  network_manager.CloseServer();
+  server_thread.join();
+  peloton::PelotonInit::Shutdown();
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,133 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// arena_test.cpp
+//
+// Identification: test/optimizer/arena_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+
+#include "common/harness.h"
+
+#include "optimizer/arena.h"
+#include "optimizer/memo.h"
+#include "optimizer/operators.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Arena Tests
+//===--------------------------------------------------------------------===//
+
+class ArenaTests : public PelotonTest {};
+
+namespace {
+
+struct Counted {
+  explicit Counted(int &count) : count_(count) { count_++; }
+  ~Counted() { count_--; }
+  int &count_;
+};
+
+}  // namespace
+
+TEST_F(ArenaTests, AllocateTest) {
+  optimizer::Arena arena;
+
+  // Allocations are aligned and do not overlap
+  auto first = static_cast<char *>(arena.Allocate(3, 1));
+  auto second = static_cast<char *>(arena.Allocate(16, 16));
+  EXPECT_EQ(0UL, reinterpret_cast<uintptr_t>(second) % 16);
+  EXPECT_LE(first + 3, second);
+  EXPECT_EQ(19UL, arena.GetAllocatedBytes());
+
+  // Large allocations get their own block
+  arena.Allocate(optimizer::Arena::BLOCK_SIZE);
+  EXPECT_EQ(2UL, arena.GetBlockCount());
+  auto third = static_cast<char *>(arena.Allocate(8, 8));
+  EXPECT_LE(second + 16, third);
+  EXPECT_GT(second + optimizer::Arena::BLOCK_SIZE, third);
+
+  // The first block is kept for reuse
+  arena.Reset();
+  EXPECT_EQ(0UL, arena.GetAllocatedBytes());
+  EXPECT_EQ(1UL, arena.GetBlockCount());
+  EXPECT_EQ(first, arena.Allocate(1, 1));
+}
+
+TEST_F(ArenaTests, DestructorTest) {
+  int count = 0;
+  {
+    optimizer::Arena arena;
+    for (int i = 0; i < 10000; i++) {
+      arena.New<Counted>(count);
+    }
+    EXPECT_EQ(10000, count);
+    EXPECT_LT(1UL, arena.GetBlockCount());
+
+    arena.Reset();
+    EXPECT_EQ(0, count);
+
+    arena.New<Counted>(count);
+    EXPECT_EQ(1, count);
+  }
+  EXPECT_EQ(0, count);
+}
+
+TEST_F(ArenaTests, LargeFirstAllocationTest) {
+  optimizer::Arena arena;
+
+  // A large first allocation does not become the block kept by Reset()
+  auto large = static_cast<char *>(
+      arena.Allocate(4 * optimizer::Arena::BLOCK_SIZE));
+  PL_MEMSET(large, 1, 4 * optimizer::Arena::BLOCK_SIZE);
+  EXPECT_EQ(1UL, arena.GetBlockCount());
+  arena.Reset();
+  EXPECT_EQ(0UL, arena.GetBlockCount());
+
+  // Filling whole regular blocks after the reset stays within them
+  for (int round = 0; round < 2; round++) {
+    for (size_t itr = 0; itr < 3 * optimizer::Arena::BLOCK_SIZE / 1024;
+         itr++) {
+      PL_MEMSET(arena.Allocate(1024), 1, 1024);
+    }
+    EXPECT_EQ(3UL, arena.GetBlockCount());
+    arena.Reset();
+    EXPECT_EQ(1UL, arena.GetBlockCount());
+  }
+}
+
+TEST_F(ArenaTests, MemoTest) {
+  optimizer::Memo memo;
+
+  // A new expression is moved into the memo, a duplicate is found there
+  optimizer::GroupExpression candidate(optimizer::DummyScan::make(), {});
+  bool inserted;
+  auto gexpr = memo.InsertExpression(&candidate, optimizer::UNDEFINED_GROUP,
+                                     false, inserted);
+  EXPECT_TRUE(inserted);
+  EXPECT_NE(&candidate, gexpr);
+  EXPECT_EQ(0, candidate.GetGroupID());
+  EXPECT_EQ(0, gexpr->GetGroupID());
+
+  optimizer::GroupExpression duplicate(optimizer::DummyScan::make(), {});
+  EXPECT_EQ(gexpr, memo.InsertExpression(&duplicate,
+                                         optimizer::UNDEFINED_GROUP, false,
+                                         inserted));
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(1UL, memo.Groups().size());
+  EXPECT_LT(0UL, memo.GetAllocatedBytes());
+
+  memo.Reset();
+  EXPECT_EQ(0UL, memo.Groups().size());
+  EXPECT_EQ(0UL, memo.GetAllocatedBytes());
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// expression_performance_test.cpp
+//
+// Identification: test/performance/expression_performance_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+
+#include "common/harness.h"
+#include "common/timer.h"
+#include "expression/comparison_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/operator_expression.h"
+#include "type/value_factory.h"
+#include "type/value_kernels.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Expression Performance Tests
+//===--------------------------------------------------------------------===//
+
+class ExpressionPerformanceTests : public PelotonTest {};
+
+const size_t expression_value_count = 1 << 16;
+const size_t expression_round_count = 200;
+
+static std::vector<type::Value> GetValues(type::TypeId type_id) {
+  std::vector<type::Value> values;
+  for (size_t i = 0; i < expression_value_count; i++) {
+    int32_t value = i * 2654435761u % 10000;
+    if (type_id == type::TypeId::DECIMAL) {
+      values.push_back(type::ValueFactory::GetDecimalValue(value));
+    } else {
+      values.push_back(type::ValueFactory::GetIntegerValue(value));
+    }
+  }
+  return values;
+}
+
+// Run the function over all pairs of values, returning the ns per call
+template <class Function>
+static double Measure(const std::vector<type::Value> &left,
+                      const std::vector<type::Value> &right,
+                      Function function) {
+  Timer<std::ratio<1, 1000000000>> timer;
+  timer.Start();
+  for (size_t round = 0; round < expression_round_count; round++) {
+    for (size_t i = 0; i < left.size(); i++) {
+      function(left[i], right[left.size() - i - 1]);
+    }
+  }
+  timer.Stop();
+  return timer.GetDuration() / (expression_round_count * left.size());
+}
+
+// Virtual dispatch through Type against the kernel resolved for the types
+TEST_F(ExpressionPerformanceTests, KernelTest) {
+  for (auto type_id : {type::TypeId::INTEGER, type::TypeId::DECIMAL}) {
+    auto left = GetValues(type_id);
+    auto right = GetValues(type_id);
+
+    size_t virtual_count = 0, kernel_count = 0;
+    auto less_than = type::ValueKernels::GetCompare(
+        ExpressionType::COMPARE_LESSTHAN, type_id, type_id);
+    double virtual_compare = Measure(
+        left, right, [&](const type::Value &x, const type::Value &y) {
+          virtual_count += x.CompareLessThan(y) == type::CMP_TRUE;
+        });
+    double kernel_compare = Measure(
+        left, right, [&](const type::Value &x, const type::Value &y) {
+          kernel_count += less_than(x, y) == type::CMP_TRUE;
+        });
+    EXPECT_EQ(virtual_count, kernel_count);
+
+    type::Value virtual_sum = type::ValueFactory::GetDecimalValue(0);
+    type::Value kernel_sum = type::ValueFactory::GetDecimalValue(0);
+    auto add = type::ValueKernels::GetArithmetic(
+        ExpressionType::OPERATOR_PLUS, type_id, type_id);
+    double virtual_add = Measure(
+        left, right, [&](const type::Value &x, const type::Value &y) {
+          virtual_sum = x.Add(y);
+        });
+    double kernel_add = Measure(
+        left, right, [&](const type::Value &x, const type::Value &y) {
+          kernel_sum = add(x, y);
+        });
+    EXPECT_EQ(type::CMP_TRUE, virtual_sum.CompareEquals(kernel_sum));
+
+    LOG_INFO("%s: compare %.2lf ns virtual, %.2lf ns kernel; "
+             "add %.2lf ns virtual, %.2lf ns kernel",
+             TypeIdToString(type_id).c_str(), virtual_compare,
+             kernel_compare, virtual_add, kernel_add);
+  }
+}
+
+// a + b < c evaluated as an expression tree
+TEST_F(ExpressionPerformanceTests, EvaluateTest) {
+  auto a = type::ValueFactory::GetIntegerValue(40);
+  auto b = type::ValueFactory::GetIntegerValue(2);
+  auto c = type::ValueFactory::GetIntegerValue(100);
+  std::unique_ptr<expression::AbstractExpression> expr(
+      new expression::ComparisonExpression(
+          ExpressionType::COMPARE_LESSTHAN,
+          new expression::OperatorExpression(
+              ExpressionType::OPERATOR_PLUS, type::TypeId::INTEGER,
+              new expression::ConstantValueExpression(a),
+              new expression::ConstantValueExpression(b)),
+          new expression::ConstantValueExpression(c)));
+
+  const size_t evaluation_count = expression_round_count *
+                                  expression_value_count;
+  size_t true_count = 0;
+  Timer<std::ratio<1, 1000000000>> timer;
+  timer.Start();
+  for (size_t i = 0; i < evaluation_count; i++) {
+    true_count += expr->Evaluate(nullptr, nullptr, nullptr).IsTrue();
+  }
+  timer.Stop();
+  EXPECT_EQ(evaluation_count, true_count);
+
+  LOG_INFO("a + b < c: %.2lf ns per evaluation",
+           timer.GetDuration() / evaluation_count);
+}
+
+}  // namespace test
+}  // namespace peloton
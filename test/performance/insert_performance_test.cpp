@@ -23,6 +23,7 @@
 #include "catalog/schema.h"
 #include "type/value_factory.h"
 #include "common/timer.h"
+#include "concurrency/epoch_manager_factory.h"
 #include "concurrency/transaction_manager_factory.h"
 
 #include "executor/executor_context.h"
@@ -37,6 +38,7 @@
 #include "storage/table_factory.h"
 
 #include "executor/mock_executor.h"
+#include "gc/gc_manager_factory.h"
 
 #include "planner/insert_plan.h"
 
@@ -84,6 +86,89 @@ void InsertTuple(storage::DataTable *table, type::AbstractPool *pool,
   txn_manager.CommitTransaction(txn);
 }
 
+// Inserts tuples and deletes them in the same transaction, so the GC keeps
+// handing their slots back to the table
+void ChurnTuples(storage::DataTable *table, type::AbstractPool *pool,
+                 oid_t batch_count_per_churner,
+                 UNUSED_ATTRIBUTE uint64_t thread_itr) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  const oid_t batch_size = 10;
+
+  std::vector<ItemPointer> locations;
+  for (oid_t batch_itr = 0; batch_itr < batch_count_per_churner; batch_itr++) {
+    auto txn = txn_manager.BeginTransaction();
+    for (oid_t tuple_itr = 0; tuple_itr < batch_size; tuple_itr++) {
+      std::unique_ptr<storage::Tuple> tuple(
+          TestingExecutorUtil::GetTuple(table, ++loader_tuple_id, pool));
+      ItemPointer *index_entry_ptr = nullptr;
+      auto location = table->InsertTuple(tuple.get(), txn, &index_entry_ptr);
+      EXPECT_FALSE(location.IsNull());
+      txn_manager.PerformInsert(txn, location, index_entry_ptr);
+      locations.push_back(location);
+    }
+
+    for (auto &location : locations) {
+      txn_manager.PerformDelete(txn, location);
+    }
+    locations.clear();
+
+    txn_manager.CommitTransaction(txn);
+  }
+}
+
+TEST_F(InsertPerformanceTests, ChurnTest) {
+  // Insert throughput of many threads on a table whose tuple slots are
+  // recycled by the GC
+  oid_t churn_threads_count = 32;
+  oid_t batch_count_per_churner = 200;
+  oid_t tuple_count = churn_threads_count * batch_count_per_churner * 10;
+
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(TEST_TUPLES_PER_TILEGROUP, false));
+
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  std::unique_ptr<std::thread> epoch_thread;
+  std::vector<std::unique_ptr<std::thread>> gc_threads;
+
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::GCManagerFactory::GetInstance();
+  gc_manager.RegisterTable(data_table->GetOid());
+
+  epoch_manager.StartEpoch(epoch_thread);
+  gc_manager.StartGC(gc_threads);
+
+  Timer<> timer;
+
+  timer.Start();
+
+  LaunchParallelTest(churn_threads_count, ChurnTuples, data_table.get(),
+                     testing_pool, batch_count_per_churner);
+
+  timer.Stop();
+  auto duration = timer.GetDuration();
+
+  gc_manager.StopGC();
+  epoch_manager.StopEpoch();
+  epoch_thread->join();
+  for (auto &gc_thread : gc_threads) {
+    gc_thread->join();
+  }
+
+  LOG_INFO("Churners: %u Duration: %.2lf Throughput: %.0lf inserts/s",
+           churn_threads_count, duration, tuple_count / duration);
+  LOG_INFO("Tile groups: %zu for %u inserted tuples",
+           data_table->GetTileGroupCount(), tuple_count);
+
+  // Every inserted tuple got a slot
+  EXPECT_GE(data_table->GetTileGroupCount() * TEST_TUPLES_PER_TILEGROUP,
+            churn_threads_count);
+
+  gc_manager.Reset();
+  gc::GCManagerFactory::Configure(0);
+}
+
 TEST_F(InsertPerformanceTests, LoadingTest) {
   // We are going to simply load tile groups concurrently in this test
   // WARNING: This test may potentially run for a long time if
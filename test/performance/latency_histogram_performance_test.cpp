@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// latency_histogram_performance_test.cpp
+//
+// Identification: test/performance/latency_histogram_performance_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "common/harness.h"
+#include "common/timer.h"
+#include "statistics/latency_histogram.h"
+#include "statistics/latency_metric.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Latency Histogram Performance Tests
+//===--------------------------------------------------------------------===//
+
+class LatencyHistogramPerformanceTests : public PelotonTest {};
+
+const uint64_t latency_count_per_thread = 10000000;
+
+std::atomic<bool> aggregator_done;
+
+void RecordLatencies(
+    std::vector<std::unique_ptr<stats::LatencyMetric>> *metrics,
+    uint64_t thread_itr) {
+  auto &metric = *(*metrics)[thread_itr];
+  for (uint64_t i = 0; i < latency_count_per_thread; i++) {
+    // A spread of latencies between 0 and ~65ms
+    metric.RecordLatency((i * 2654435761ull % 65536) / 1000.0);
+  }
+}
+
+void RunRecordTest(oid_t thread_count, bool with_aggregator) {
+  std::vector<std::unique_ptr<stats::LatencyMetric>> metrics;
+  for (oid_t thread_itr = 0; thread_itr < thread_count; thread_itr++) {
+    metrics.emplace_back(new stats::LatencyMetric(LATENCY_METRIC));
+  }
+
+  // Optionally keep aggregating the workers' histograms the way the stats
+  // aggregator does, to see what reading them costs the workers. Each
+  // aggregation only takes what was recorded since the previous one.
+  aggregator_done = false;
+  uint64_t aggregation_count = 0;
+  stats::LatencyMetric aggregated_metric(LATENCY_METRIC);
+  std::thread aggregator;
+  if (with_aggregator) {
+    aggregator = std::thread([&] {
+      while (aggregator_done == false) {
+        for (auto &metric : metrics) {
+          aggregated_metric.Aggregate(*metric);
+        }
+        aggregated_metric.ComputeLatencies();
+        aggregation_count++;
+      }
+    });
+  }
+
+  Timer<std::ratio<1, 1000000000>> timer;
+  timer.Start();
+  LaunchParallelTest(thread_count, RecordLatencies, &metrics);
+  timer.Stop();
+
+  aggregator_done = true;
+  if (with_aggregator) {
+    aggregator.join();
+  }
+
+  for (auto &metric : metrics) {
+    aggregated_metric.Aggregate(*metric);
+  }
+  aggregated_metric.ComputeLatencies();
+  EXPECT_EQ(thread_count * latency_count_per_thread,
+            aggregated_metric.GetLatencyCount());
+
+  LOG_INFO("%u threads%s: %.2lf ns per latency, %lu aggregations",
+           thread_count, with_aggregator ? " with aggregator" : "",
+           timer.GetDuration() / latency_count_per_thread, aggregation_count);
+  LOG_INFO("%s", aggregated_metric.GetInfo().c_str());
+}
+
+TEST_F(LatencyHistogramPerformanceTests, RecordTest) {
+  for (oid_t thread_count : {1, 4}) {
+    RunRecordTest(thread_count, false);
+    RunRecordTest(thread_count, true);
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,115 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// network_throughput_performance_test.cpp
+//
+// Identification: test/performance/network_throughput_performance_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <thread>
+
+#include <pqxx/pqxx> /* libpqxx is used to instantiate C++ client */
+
+#include "common/harness.h"
+#include "common/timer.h"
+#include "network/network_manager.h"
+#include "util/string_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Network Throughput Performance Tests
+//===--------------------------------------------------------------------===//
+
+class NetworkThroughputPerformanceTests : public PelotonTest {};
+
+const int throughput_row_count = 10000;
+
+const int throughput_query_count = 50;
+
+const int rows_per_insert = 100;
+
+static void LaunchThroughputServer(
+    peloton::network::NetworkManager network_manager, int port) {
+  try {
+    network_manager.SetPort(port);
+    network_manager.StartServer();
+  } catch (peloton::ConnectionException &exception) {
+    LOG_INFO("[LaunchServer] exception in thread");
+  }
+}
+
+static void RunThroughputClient(int port) {
+  try {
+    pqxx::connection C(StringUtil::Format(
+        "host=127.0.0.1 port=%d user=postgres sslmode=disable", port));
+
+    pqxx::work load_txn(C);
+    load_txn.exec("DROP TABLE IF EXISTS throughput;");
+    load_txn.exec(
+        "CREATE TABLE throughput(id INT PRIMARY KEY, name VARCHAR(32), "
+        "balance INT);");
+    for (int row = 0; row < throughput_row_count; row += rows_per_insert) {
+      std::string query = "INSERT INTO throughput VALUES ";
+      for (int i = row; i < row + rows_per_insert; i++) {
+        if (i != row) query += ", ";
+        query += StringUtil::Format("(%d, 'customer %d', %d)", i, i, i * 7);
+      }
+      load_txn.exec(query + ";");
+    }
+    load_txn.commit();
+
+    // Every query returns the whole table, so the time is dominated by
+    // encoding and sending the rows
+    pqxx::nontransaction txn(C);
+    size_t received_bytes = 0;
+    Timer<std::milli> timer;
+    timer.Start();
+    for (int query = 0; query < throughput_query_count; query++) {
+      pqxx::result R = txn.exec("SELECT * FROM throughput;");
+      EXPECT_EQ(throughput_row_count, static_cast<int>(R.size()));
+      for (const auto &row : R) {
+        for (const auto &field : row) {
+          received_bytes += field.size();
+        }
+      }
+    }
+    timer.Stop();
+
+    double seconds = timer.GetDuration() / 1000;
+    LOG_INFO("%d queries of %d rows took %.1f ms: %.0f rows/s, %.1f MB/s",
+             throughput_query_count, throughput_row_count,
+             timer.GetDuration(),
+             throughput_query_count * throughput_row_count / seconds,
+             received_bytes / seconds / (1024 * 1024));
+  } catch (const std::exception &e) {
+    LOG_INFO("[NetworkThroughputTest] Exception occurred: %s", e.what());
+    EXPECT_TRUE(false);
+  }
+}
+
+TEST_F(NetworkThroughputPerformanceTests, SelectThroughputTest) {
+  peloton::PelotonInit::Initialize();
+  peloton::network::NetworkManager network_manager;
+
+  int port = 15721;
+  std::thread server_thread(LaunchThroughputServer, network_manager, port);
+  while (!network_manager.GetIsStarted()) {
+    sleep(1);
+  }
+
+  RunThroughputClient(port);
+
+  network_manager.CloseServer();
+  server_thread.join();
+  peloton::PelotonInit::Shutdown();
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// explain_analyze_sql_test.cpp
+//
+// Identification: test/sql/explain_analyze_sql_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "sql/testing_sql_util.h"
+#include "catalog/catalog.h"
+#include "common/harness.h"
+#include "common/statement.h"
+#include "concurrency/transaction_manager_factory.h"
+
+namespace peloton {
+namespace test {
+
+class ExplainAnalyzeSQLTests : public PelotonTest {};
+
+void CreateAndLoadExplainTable() {
+  // Create a table first
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test(a INT PRIMARY KEY, b INT, c INT);");
+
+  // Insert tuples into table
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (1, 22, 333);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (2, 22, 333);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (3, 11, 222);");
+}
+
+// Does any line of the profile contain all of the given strings?
+bool ProfileContains(const std::vector<StatementResult> &result,
+                     const std::vector<std::string> &needles) {
+  for (size_t i = 0; i < result.size(); i++) {
+    auto line = TestingSQLUtil::GetResultValueAsString(result, i);
+    bool found = true;
+    for (auto &needle : needles) {
+      found = found && line.find(needle) != std::string::npos;
+    }
+    if (found) return true;
+  }
+  return false;
+}
+
+TEST_F(ExplainAnalyzeSQLTests, ParseTest) {
+  std::string query;
+  EXPECT_TRUE(Statement::ParseExplainAnalyze(
+      "explain analyze SELECT * FROM test", query));
+  EXPECT_EQ("SELECT * FROM test", query);
+
+  EXPECT_TRUE(Statement::ParseExplainAnalyze(
+      "EXPLAIN ANALYSE  SELECT a FROM test", query));
+  EXPECT_EQ("SELECT a FROM test", query);
+
+  EXPECT_FALSE(Statement::ParseExplainAnalyze("ANALYZE test", query));
+  EXPECT_FALSE(Statement::ParseExplainAnalyze("EXPLAIN SELECT 1", query));
+}
+
+TEST_F(ExplainAnalyzeSQLTests, ScanTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  CreateAndLoadExplainTable();
+
+  std::vector<StatementResult> result;
+  std::vector<FieldInfo> tuple_descriptor;
+  int rows_affected;
+  TestingSQLUtil::ExecuteSQLQuery(
+      "EXPLAIN ANALYZE SELECT a, b FROM test WHERE b = 22;", result,
+      tuple_descriptor, rows_affected);
+
+  // The profile is returned as a single text column
+  ASSERT_EQ(1, tuple_descriptor.size());
+  EXPECT_EQ("QUERY PLAN", std::get<0>(tuple_descriptor[0]));
+
+  // The scan produced the two matching rows, whichever engine ran it
+  EXPECT_TRUE(ProfileContains(result, {"SEQSCAN", "rows=2"}));
+  EXPECT_TRUE(ProfileContains(result, {"Execution Time"}));
+
+  // Without EXPLAIN ANALYZE the query still returns its rows
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a, b FROM test WHERE b = 22;", {"1|22", "2|22"}, false);
+
+  // Free the database
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+TEST_F(ExplainAnalyzeSQLTests, AggregateTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  CreateAndLoadExplainTable();
+
+  std::vector<StatementResult> result;
+  std::vector<FieldInfo> tuple_descriptor;
+  int rows_affected;
+  TestingSQLUtil::ExecuteSQLQuery(
+      "EXPLAIN ANALYZE SELECT b, COUNT(*) FROM test GROUP BY b;", result,
+      tuple_descriptor, rows_affected);
+
+  // Two groups out of three scanned rows
+  EXPECT_TRUE(ProfileContains(result, {"AGGREGATE", "rows=2"}));
+  EXPECT_TRUE(ProfileContains(result, {"SEQSCAN", "rows=3"}));
+
+  // Free the database
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -12,13 +12,17 @@
 
 #include <memory>
 
+#include "binder/bind_node_visitor.h"
 #include "catalog/catalog.h"
 #include "common/harness.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/create_executor.h"
+#include "optimizer/fast_path_planner.h"
 #include "optimizer/optimizer.h"
+#include "parser/postgresparser.h"
 #include "planner/create_plan.h"
 #include "planner/order_by_plan.h"
+#include "settings/settings_manager.h"
 #include "sql/testing_sql_util.h"
 
 using std::vector;
@@ -651,5 +655,77 @@ TEST_F(OptimizerSQLTests, IndexTest) {
            false);
 }
 
+TEST_F(OptimizerSQLTests, FastPathTest) {
+  // Statements on a prefix of the primary key get an index scan directly
+  TestUtil("SELECT b FROM test WHERE a = 2", {"11"}, false,
+           {PlanNodeType::INDEXSCAN});
+  TestUtil("SELECT * FROM test WHERE a > 2 AND a <= 3", {"3", "33", "444"},
+           false, {PlanNodeType::INDEXSCAN});
+  TestUtil("UPDATE test SET b = b + 1 WHERE a = 2", {}, false,
+           {PlanNodeType::UPDATE, PlanNodeType::INDEXSCAN});
+  TestUtil("SELECT b FROM test WHERE a = 2", {"12"}, false);
+  TestUtil("DELETE FROM test WHERE a = 4", {}, false,
+           {PlanNodeType::DELETE, PlanNodeType::INDEXSCAN});
+  TestUtil("SELECT a FROM test", {"1", "2", "3"}, false);
+
+  // Everything else is left to the optimizer
+  auto has_fast_path_plan = [](const std::string query) {
+    auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    auto parse_tree_list =
+        parser::PostgresParser::GetInstance().BuildParseTree(query);
+    auto parse_tree = parse_tree_list->GetStatements().at(0).get();
+    binder::BindNodeVisitor binder(txn, DEFAULT_DB_NAME);
+    binder.BindNameToNode(parse_tree);
+    bool has_plan =
+        optimizer::FastPathPlanner(txn).BuildPlan(parse_tree) != nullptr;
+    txn_manager.CommitTransaction(txn);
+    return has_plan;
+  };
+  EXPECT_TRUE(has_fast_path_plan("SELECT a, c FROM test WHERE a = $1"));
+  EXPECT_FALSE(has_fast_path_plan("SELECT b FROM test WHERE b = 11"));
+  EXPECT_FALSE(has_fast_path_plan("SELECT b FROM test WHERE a = 1 OR a = 2"));
+  EXPECT_FALSE(has_fast_path_plan("SELECT b + 1 FROM test WHERE a = 1"));
+  EXPECT_FALSE(has_fast_path_plan("SELECT b FROM test WHERE a = 1 ORDER BY b"));
+  EXPECT_FALSE(has_fast_path_plan("SELECT COUNT(*) FROM test WHERE a = 1"));
+  EXPECT_FALSE(has_fast_path_plan("UPDATE test SET b = 1 WHERE 1 = a"));
+  EXPECT_FALSE(has_fast_path_plan("DELETE FROM test"));
+}
+
+TEST_F(OptimizerSQLTests, SearchBudgetTest) {
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test1(a INT PRIMARY KEY, b INT, c INT);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test1 VALUES (1, 22, 333);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test1 VALUES (2, 11, 000);");
+
+  std::string query =
+      "SELECT test.a, test1.c FROM test JOIN test1 ON test.b = test1.b "
+      "WHERE test.c > 100 ORDER BY test.a";
+  auto rule_application_count = [&] {
+    auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    TestingSQLUtil::GeneratePlanWithOptimizer(optimizer, query, txn);
+    txn_manager.CommitTransaction(txn);
+    return static_cast<optimizer::Optimizer*>(optimizer.get())
+        ->GetRuleApplicationCount();
+  };
+  auto full_search_count = rule_application_count();
+
+  // Over budget, the search stops at the first plan of every group, which
+  // still gives the right result
+  settings::SettingsManager::SetInt(settings::SettingId::optimizer_rule_budget,
+                                    1);
+  EXPECT_GT(full_search_count, rule_application_count());
+  TestUtil(query, {"1", "333"}, true);
+
+  settings::SettingsManager::SetInt(settings::SettingId::optimizer_rule_budget,
+                                    0);
+  settings::SettingsManager::SetInt(
+      settings::SettingId::optimizer_search_budget, 1);
+  TestUtil(query, {"1", "333"}, true);
+  settings::SettingsManager::SetInt(
+      settings::SettingId::optimizer_search_budget, 0);
+}
+
 }  // namespace test
 }  // namespace peloton
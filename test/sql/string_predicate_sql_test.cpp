@@ -0,0 +1,136 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// string_predicate_sql_test.cpp
+//
+// Identification: test/sql/string_predicate_sql_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "sql/testing_sql_util.h"
+#include "catalog/catalog.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "optimizer/optimizer.h"
+#include "planner/index_scan_plan.h"
+
+namespace peloton {
+namespace test {
+
+class StringPredicateSQLTests : public PelotonTest {};
+
+static void CreateAndLoadTable() {
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test(a INT PRIMARY KEY, b VARCHAR(32));");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (1, 'apple');");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (2, 'apricot');");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (3, 'banana');");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (4, 'Grape');");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (5, 'pineapple');");
+}
+
+TEST_F(StringPredicateSQLTests, LikeTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  CreateAndLoadTable();
+
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM test WHERE b LIKE 'ap%';", {"1", "2"}, false);
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM test WHERE b LIKE '%apple';", {"1", "5"}, false);
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM test WHERE b LIKE '%an%';", {"3"}, false);
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM test WHERE b LIKE '_r%e';", {"4"}, false);
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM test WHERE b NOT LIKE '%p%';", {"3"}, false);
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM test WHERE b ILIKE 'g%';", {"4"}, false);
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM test WHERE b NOT ILIKE '%A%';", {}, false);
+
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+TEST_F(StringPredicateSQLTests, InListTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  CreateAndLoadTable();
+
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT b FROM test WHERE a IN (1, 3, 5);",
+      {"apple", "banana", "pineapple"}, false);
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM test WHERE b IN ('banana', 'Grape', 'kiwi');",
+      {"3", "4"}, false);
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM test WHERE a NOT IN (1, 2, 3);", {"4", "5"}, false);
+
+  // Lists longer than a few constants are probed through their set
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT b FROM test WHERE a IN (1, 3, 5, 7, 9, 11, 13, 15, 17, 19);",
+      {"apple", "banana", "pineapple"}, false);
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM test WHERE b IN ('banana', 'Grape', 'kiwi', 'fig', "
+      "'lime', 'lemon', 'mango', 'melon', 'peach', 'plum');",
+      {"3", "4"}, false);
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM test WHERE a NOT IN (1, 2, 3, 6, 7, 8, 9, 10, 11, 12);",
+      {"4", "5"}, false);
+
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+TEST_F(StringPredicateSQLTests, LikePrefixIndexScanTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  CreateAndLoadTable();
+  TestingSQLUtil::ExecuteSQLQuery("CREATE INDEX idx_b ON test(b);");
+
+  // The prefix becomes the range of the index scan
+  std::unique_ptr<optimizer::AbstractOptimizer> optimizer(
+      new optimizer::Optimizer());
+  txn = txn_manager.BeginTransaction();
+  auto plan = TestingSQLUtil::GeneratePlanWithOptimizer(
+      optimizer, "SELECT a FROM test WHERE b LIKE 'ap%';", txn);
+  txn_manager.CommitTransaction(txn);
+  EXPECT_EQ(PlanNodeType::INDEXSCAN, plan->GetPlanNodeType());
+  auto &index_scan = static_cast<planner::IndexScanPlan &>(*plan);
+  std::vector<ExpressionType> expr_types = {
+      ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+      ExpressionType::COMPARE_LESSTHAN};
+  EXPECT_EQ(expr_types, index_scan.GetExprTypes());
+
+  // The rest of the pattern still filters the range
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM test WHERE b LIKE 'ap%';", {"1", "2"}, false);
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM test WHERE b LIKE 'ap%t';", {"2"}, false);
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM test WHERE b LIKE 'banana';", {"3"}, false);
+
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// subquery_sql_test.cpp
+//
+// Identification: test/sql/subquery_sql_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "sql/testing_sql_util.h"
+#include "catalog/catalog.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+
+namespace peloton {
+namespace test {
+
+class SubquerySQLTests : public PelotonTest {};
+
+static void CreateAndLoadTables() {
+  TestingSQLUtil::ExecuteSQLQuery("CREATE TABLE t1(a INT PRIMARY KEY, b INT);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO t1 VALUES (1, 10);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO t1 VALUES (2, 20);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO t1 VALUES (3, 30);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO t1 VALUES (4, NULL);");
+
+  TestingSQLUtil::ExecuteSQLQuery("CREATE TABLE t2(c INT PRIMARY KEY, d INT);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO t2 VALUES (1, 10);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO t2 VALUES (2, 30);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO t2 VALUES (3, 40);");
+
+  // Same as t2 with a NULL
+  TestingSQLUtil::ExecuteSQLQuery("CREATE TABLE t3(e INT PRIMARY KEY, f INT);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO t3 VALUES (1, 10);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO t3 VALUES (2, NULL);");
+}
+
+TEST_F(SubquerySQLTests, InTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  CreateAndLoadTables();
+
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM t1 WHERE b IN (SELECT d FROM t2);", {"1", "3"}, false);
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM t1 WHERE b IN (SELECT d FROM t2 WHERE c > 1);", {"3"},
+      false);
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM t1 WHERE a < 3 AND b IN (SELECT d FROM t2);", {"1"},
+      false);
+  // The NULL of t3 never matches
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM t1 WHERE b IN (SELECT f FROM t3);", {"1"}, false);
+
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+TEST_F(SubquerySQLTests, NotInTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  CreateAndLoadTables();
+
+  // A NULL on the left is unknown unless the subquery is empty
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM t1 WHERE b NOT IN (SELECT d FROM t2);", {"2"}, false);
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM t1 WHERE b NOT IN (SELECT d FROM t2 WHERE c > 10);",
+      {"1", "2", "3", "4"}, false);
+  // A NULL in the subquery makes every comparison unknown
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM t1 WHERE b NOT IN (SELECT f FROM t3);", {}, false);
+
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+TEST_F(SubquerySQLTests, ExistsTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  CreateAndLoadTables();
+
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM t1 WHERE EXISTS (SELECT c FROM t2 WHERE t2.d = t1.b);",
+      {"1", "3"}, false);
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM t1 WHERE NOT EXISTS "
+      "(SELECT c FROM t2 WHERE t2.d = t1.b);",
+      {"2", "4"}, false);
+  // Unlike NOT IN, NOT EXISTS is not affected by NULLs
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM t1 WHERE NOT EXISTS "
+      "(SELECT e FROM t3 WHERE t3.f = t1.b);",
+      {"2", "3", "4"}, false);
+
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,217 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// latency_histogram_test.cpp
+//
+// Identification: test/statistics/latency_histogram_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "common/harness.h"
+#include "statistics/latency_histogram.h"
+#include "statistics/latency_metric.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Latency Histogram Tests
+//===--------------------------------------------------------------------===//
+
+class LatencyHistogramTests : public PelotonTest {};
+
+TEST_F(LatencyHistogramTests, BucketTest) {
+  // Every value falls into the bucket whose bounds contain it, and the
+  // buckets cover the values without gaps
+  uint64_t next_lower_bound = 0;
+  for (uint32_t bucket_index = 0;
+       bucket_index < stats::LatencyHistogram::BUCKET_COUNT; bucket_index++) {
+    auto lower_bound =
+        stats::LatencyHistogram::GetBucketLowerBound(bucket_index);
+    auto upper_bound =
+        stats::LatencyHistogram::GetBucketUpperBound(bucket_index);
+    EXPECT_EQ(next_lower_bound, lower_bound);
+    EXPECT_LE(lower_bound, upper_bound);
+    EXPECT_EQ(bucket_index,
+              stats::LatencyHistogram::GetBucketIndex(lower_bound));
+    EXPECT_EQ(bucket_index,
+              stats::LatencyHistogram::GetBucketIndex(upper_bound));
+
+    // No bucket is wider than 1/32 of its values
+    EXPECT_LE((upper_bound - lower_bound) * 32, lower_bound);
+    next_lower_bound = upper_bound + 1;
+  }
+  EXPECT_EQ(stats::LatencyHistogram::MAX_VALUE + 1, next_lower_bound);
+  EXPECT_EQ(stats::LatencyHistogram::BUCKET_COUNT - 1,
+            stats::LatencyHistogram::GetBucketIndex(UINT64_MAX));
+}
+
+TEST_F(LatencyHistogramTests, PercentileTest) {
+  stats::LatencyHistogram histogram;
+  EXPECT_EQ(0, histogram.GetCount());
+  EXPECT_EQ(0, histogram.GetPercentile(0.99));
+
+  // Mostly fast latencies with a long tail
+  std::mt19937_64 rng(42);
+  std::lognormal_distribution<double> distribution(5.0, 1.5);
+  std::vector<uint64_t> latencies;
+  for (int i = 0; i < 100000; i++) {
+    auto latency = static_cast<uint64_t>(distribution(rng));
+    latencies.push_back(latency);
+    histogram.Record(latency);
+  }
+  std::sort(latencies.begin(), latencies.end());
+
+  EXPECT_EQ(latencies.size(), histogram.GetCount());
+  EXPECT_EQ(latencies.front(), histogram.GetMin());
+  EXPECT_EQ(latencies.back(), histogram.GetMax());
+  EXPECT_EQ(latencies.back(), histogram.GetPercentile(1.0));
+
+  for (double fraction : {0.25, 0.5, 0.75, 0.99, 0.999}) {
+    auto rank = static_cast<size_t>(std::ceil(fraction * latencies.size()));
+    double expected = latencies[rank - 1];
+    double actual = histogram.GetPercentile(fraction);
+    EXPECT_LE(std::abs(actual - expected), expected / 64 + 1);
+  }
+}
+
+TEST_F(LatencyHistogramTests, MergeTest) {
+  stats::LatencyHistogram fast_histogram;
+  stats::LatencyHistogram slow_histogram;
+  for (uint64_t latency = 1; latency <= 990; latency++) {
+    fast_histogram.Record(latency);
+  }
+  for (uint64_t latency = 1; latency <= 10; latency++) {
+    slow_histogram.Record(latency * 100000);
+  }
+
+  stats::LatencyHistogram histogram;
+  histogram.Merge(fast_histogram);
+  histogram.Merge(slow_histogram);
+
+  EXPECT_EQ(1000, histogram.GetCount());
+  EXPECT_EQ(1, histogram.GetMin());
+  EXPECT_EQ(1000000, histogram.GetMax());
+  EXPECT_LE(histogram.GetPercentile(0.99), 990);
+  EXPECT_GE(histogram.GetPercentile(0.999), 900000 - 900000 / 64);
+
+  histogram.Reset();
+  EXPECT_EQ(0, histogram.GetCount());
+  EXPECT_EQ(0, histogram.GetMax());
+}
+
+TEST_F(LatencyHistogramTests, ConcurrentMergeTest) {
+  // One thread records while another one keeps merging its histogram, no
+  // latency may get lost or counted twice
+  const uint64_t latency_count = 1000000;
+  stats::LatencyHistogram worker_histogram;
+  std::atomic<bool> done(false);
+
+  std::thread worker([&] {
+    for (uint64_t i = 0; i < latency_count; i++) {
+      worker_histogram.Record(i % 5000);
+    }
+    done = true;
+  });
+
+  while (done == false) {
+    stats::LatencyHistogram aggregated_histogram;
+    aggregated_histogram.Merge(worker_histogram);
+    EXPECT_LE(aggregated_histogram.GetCount(), latency_count);
+  }
+  worker.join();
+
+  stats::LatencyHistogram aggregated_histogram;
+  aggregated_histogram.Merge(worker_histogram);
+  EXPECT_EQ(latency_count, aggregated_histogram.GetCount());
+  EXPECT_EQ(4999, aggregated_histogram.GetMax());
+}
+
+TEST_F(LatencyHistogramTests, CollectTest) {
+  stats::LatencyHistogram worker_histogram;
+  for (uint64_t i = 1; i <= 100; i++) {
+    worker_histogram.Record(i * 1000);
+  }
+
+  stats::LatencyHistogram first_interval;
+  worker_histogram.Collect(first_interval);
+  EXPECT_EQ(100, first_interval.GetCount());
+  EXPECT_EQ(1000, first_interval.GetMin());
+  EXPECT_EQ(100000, first_interval.GetMax());
+
+  // Nothing new to hand over
+  stats::LatencyHistogram empty_interval;
+  worker_histogram.Collect(empty_interval);
+  EXPECT_EQ(0, empty_interval.GetCount());
+
+  // The next interval only sees its own latencies
+  for (uint64_t i = 1; i <= 10; i++) {
+    worker_histogram.Record(i);
+  }
+  stats::LatencyHistogram second_interval;
+  worker_histogram.Collect(second_interval);
+  EXPECT_EQ(10, second_interval.GetCount());
+  EXPECT_EQ(1, second_interval.GetMin());
+  EXPECT_EQ(10, second_interval.GetMax());
+  EXPECT_DOUBLE_EQ(5.5, second_interval.GetMean());
+
+  // The worker still has everything
+  EXPECT_EQ(110, worker_histogram.GetCount());
+}
+
+TEST_F(LatencyHistogramTests, ConcurrentCollectTest) {
+  // One thread records while another one keeps collecting from it, no
+  // latency may get lost or counted twice across the intervals
+  const uint64_t latency_count = 1000000;
+  stats::LatencyHistogram worker_histogram;
+  std::atomic<bool> done(false);
+
+  std::thread worker([&] {
+    for (uint64_t i = 0; i < latency_count; i++) {
+      worker_histogram.Record(i % 5000);
+    }
+    done = true;
+  });
+
+  stats::LatencyHistogram aggregated_histogram;
+  while (done == false) {
+    worker_histogram.Collect(aggregated_histogram);
+    EXPECT_LE(aggregated_histogram.GetCount(), latency_count);
+  }
+  worker.join();
+
+  worker_histogram.Collect(aggregated_histogram);
+  EXPECT_EQ(latency_count, aggregated_histogram.GetCount());
+  EXPECT_EQ(4999, aggregated_histogram.GetMax());
+}
+
+TEST_F(LatencyHistogramTests, LatencyMetricTest) {
+  stats::LatencyMetric worker_metric(LATENCY_METRIC);
+  for (int i = 1; i <= 1000; i++) {
+    worker_metric.RecordLatency(i / 10.0);
+  }
+
+  stats::LatencyMetric aggregated_metric(LATENCY_METRIC);
+  aggregated_metric.Aggregate(worker_metric);
+  aggregated_metric.ComputeLatencies();
+
+  auto &measurements = aggregated_metric.GetLatencyMeasurements();
+  EXPECT_EQ(1000, aggregated_metric.GetLatencyCount());
+  EXPECT_DOUBLE_EQ(0.1, measurements.min_);
+  EXPECT_DOUBLE_EQ(100.0, measurements.max_);
+  EXPECT_NEAR(50.0, measurements.median_, 50.0 / 64);
+  EXPECT_NEAR(99.0, measurements.perc_99th_, 99.0 / 64);
+  EXPECT_NEAR(99.9, measurements.perc_99_9th_, 99.9 / 64);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -104,7 +104,7 @@ void TransactionTest(storage::Database *database, storage::DataTable *table,
 
     // Record database stat
     for (int i = 0; i < NUM_DB_COMMIT; i++) {
-      context->GetOnGoingQueryMetric()->GetQueryLatency().RecordLatency();
+      context->GetOnGoingQueryMetric()->RecordLatency();
       context->IncrementTxnCommitted(db_oid);
     }
     for (int i = 0; i < NUM_DB_ABORT; i++) {
@@ -10,9 +10,17 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <stdlib.h>
+#include <unistd.h>
+
 #include "common/harness.h"
 
+#include "catalog/schema.h"
 #include "storage/backend_manager.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_factory.h"
+#include "storage/tile_group_header.h"
 
 namespace peloton {
 namespace test {
@@ -54,5 +62,148 @@ TEST_F(StorageManagerTests, BasicTest) {
   }
 }
 
+// Directory of its own for the data file of a test
+static std::string MakeDataFileDirectory() {
+  char directory[] = "/tmp/peloton_data_file_XXXXXX";
+  EXPECT_NE(nullptr, mkdtemp(directory));
+  return std::string(directory) + "/";
+}
+
+static void RemoveDataFileDirectory(const std::string &directory) {
+  unlink((directory + "peloton.pmem").c_str());
+  rmdir(directory.c_str());
+}
+
+TEST_F(StorageManagerTests, DataFileTest) {
+  auto directory = MakeDataFileDirectory();
+  {
+    peloton::storage::BackendManager backend_manager;
+    backend_manager.ConfigureDataFile(directory, 4);
+    EXPECT_EQ(4UL * 1024 * 1024, backend_manager.GetDataFileLength());
+
+    size_t length = 3 * 4096;
+    for (auto backend_type : {BackendType::SSD, BackendType::HDD}) {
+      // Allocations are cache line aligned and do not overlap. Each one is
+      // preceded by a header line.
+      auto first = backend_manager.Allocate(backend_type, 100);
+      auto second = backend_manager.Allocate(backend_type, length);
+      EXPECT_EQ(0UL, reinterpret_cast<uintptr_t>(first) % 64);
+      EXPECT_EQ(0UL, reinterpret_cast<uintptr_t>(second) % 64);
+      EXPECT_LE(reinterpret_cast<char *>(first) + 100,
+                reinterpret_cast<char *>(second));
+      EXPECT_EQ(128 + length + 2 * 64, backend_manager.GetDataFileUsage());
+
+      PL_MEMSET(second, '-', length);
+      backend_manager.Sync(backend_type, second, length);
+
+      // Released space is reused, and reads as zeros once pages were
+      // returned
+      backend_manager.Release(backend_type, second);
+      auto third = backend_manager.Allocate(backend_type, length);
+      EXPECT_EQ(second, third);
+      EXPECT_EQ(0, reinterpret_cast<char *>(third)[length / 2]);
+
+      // The smallest released extent that fits is reused
+      auto large = backend_manager.Allocate(backend_type, 4 * 64);
+      auto separator = backend_manager.Allocate(backend_type, 64);
+      auto small = backend_manager.Allocate(backend_type, 64);
+      auto last = backend_manager.Allocate(backend_type, 64);
+      backend_manager.Release(backend_type, large);
+      backend_manager.Release(backend_type, small);
+      EXPECT_EQ(small, backend_manager.Allocate(backend_type, 64));
+      EXPECT_EQ(large, backend_manager.Allocate(backend_type, 64));
+
+      for (auto location : {first, third, large, separator, small, last}) {
+        backend_manager.Release(backend_type, location);
+      }
+      EXPECT_EQ(0UL, backend_manager.GetDataFileUsage());
+    }
+
+    // The data file grows when it is full, without moving what is in it
+    auto first = reinterpret_cast<char *>(
+        backend_manager.Allocate(BackendType::SSD, 64));
+    first[0] = 'x';
+    auto large = reinterpret_cast<char *>(
+        backend_manager.Allocate(BackendType::SSD, 8 * 1024 * 1024));
+    EXPECT_LE(8UL * 1024 * 1024, backend_manager.GetDataFileLength());
+    large[8 * 1024 * 1024 - 1] = 'y';
+    EXPECT_EQ('x', first[0]);
+  }
+  RemoveDataFileDirectory(directory);
+}
+
+TEST_F(StorageManagerTests, ReattachTest) {
+  auto directory = MakeDataFileDirectory();
+  const uint64_t key = 15721;
+  size_t length = 3 * 4096;
+
+  // A previous run with a keyed and an anonymous allocation
+  void *address;
+  {
+    peloton::storage::BackendManager backend_manager;
+    backend_manager.ConfigureDataFile(directory, 4);
+    address = backend_manager.Allocate(BackendType::SSD, length, key);
+    PL_MEMSET(address, '-', length);
+    backend_manager.Allocate(BackendType::SSD, length);
+  }
+
+  // Only the keyed allocation survives the restart, with its data
+  {
+    peloton::storage::BackendManager backend_manager;
+    backend_manager.ConfigureDataFile(directory, 4);
+
+    size_t size = 0;
+    EXPECT_EQ(nullptr, backend_manager.Attach(BackendType::SSD, key + 1, size));
+    auto data = reinterpret_cast<char *>(
+        backend_manager.Attach(BackendType::SSD, key, size));
+    ASSERT_NE(nullptr, data);
+    EXPECT_EQ(length, size);
+    EXPECT_EQ('-', data[0]);
+    EXPECT_EQ('-', data[length - 1]);
+    EXPECT_EQ(length + 64, backend_manager.GetDataFileUsage());
+    if (data != address) {
+      LOG_INFO("Data file was mapped at a new address");
+    }
+
+    // An attached allocation can only be taken once, and is released like
+    // any other
+    EXPECT_EQ(nullptr, backend_manager.Attach(BackendType::SSD, key, size));
+    backend_manager.Release(BackendType::SSD, data);
+    EXPECT_EQ(0UL, backend_manager.GetDataFileUsage());
+  }
+  RemoveDataFileDirectory(directory);
+}
+
+TEST_F(StorageManagerTests, TileGroupBackendTest) {
+  std::vector<catalog::Column> columns = {
+      catalog::Column(type::TypeId::INTEGER,
+                      type::Type::GetTypeSize(type::TypeId::INTEGER), "A",
+                      true)};
+  std::vector<catalog::Schema> schemas = {catalog::Schema(columns)};
+  column_map_type column_map;
+  column_map[0] = std::make_pair(0, 0);
+
+  // Tile groups can be placed in the data file
+  storage::TileGroupFactory::SetBackendType(BackendType::SSD);
+  std::unique_ptr<storage::TileGroup> tile_group(
+      storage::TileGroupFactory::GetTileGroup(INVALID_OID, INVALID_OID,
+                                              INVALID_OID, nullptr, schemas,
+                                              column_map, 100));
+  storage::TileGroupFactory::SetBackendType(BackendType::MM);
+
+  EXPECT_EQ(BackendType::SSD, tile_group->GetTile(0)->GetBackendType());
+  EXPECT_EQ(0U, tile_group->GetHeader()->GetCurrentNextTupleSlot());
+  tile_group->Sync();
+
+  // Varlen data goes to the data file as well
+  auto &backend_manager = storage::BackendManager::GetInstance();
+  size_t usage = backend_manager.GetDataFileUsage();
+  auto pool = tile_group->GetTile(0)->GetPool();
+  auto varlen = pool->Allocate(1000);
+  EXPECT_LT(usage, backend_manager.GetDataFileUsage());
+  pool->Free(varlen);
+  EXPECT_EQ(usage, backend_manager.GetDataFileUsage());
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// compressed_column_test.cpp
+//
+// Identification: test/storage/compressed_column_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <random>
+
+#include "common/harness.h"
+
+#include "storage/compressed_column.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Compressed Column Tests
+//===--------------------------------------------------------------------===//
+
+class CompressedColumnTests : public PelotonTest {};
+
+// Compress the values and check that every one of them decodes back, one at
+// a time and all at once
+template <typename T>
+std::unique_ptr<storage::CompressedColumn> CompressAndCheck(
+    type::TypeId type_id, const std::vector<T> &values) {
+  std::unique_ptr<storage::CompressedColumn> column(
+      new storage::CompressedColumn(
+          type_id, sizeof(T), reinterpret_cast<const char *>(values.data()),
+          sizeof(T), values.size()));
+  EXPECT_EQ(values.size(), column->GetCount());
+
+  for (oid_t slot = 0; slot < values.size(); slot++) {
+    T value;
+    column->Decode(slot, reinterpret_cast<char *>(&value));
+    EXPECT_EQ(values[slot], value);
+  }
+
+  std::vector<T> decoded(values.size());
+  column->DecodeAll(reinterpret_cast<char *>(decoded.data()));
+  EXPECT_EQ(values, decoded);
+
+  for (auto &value : values) {
+    EXPECT_TRUE(column->MayContain(reinterpret_cast<const char *>(&value)));
+  }
+  return column;
+}
+
+template <typename T>
+bool MayContain(const storage::CompressedColumn &column, T value) {
+  return column.MayContain(reinterpret_cast<const char *>(&value));
+}
+
+TEST_F(CompressedColumnTests, RunLengthTest) {
+  std::vector<int32_t> values;
+  for (int32_t run = 0; run < 4; run++) {
+    values.insert(values.end(), 250, run * 100);
+  }
+
+  auto column = CompressAndCheck(type::TypeId::INTEGER, values);
+  EXPECT_EQ(storage::CompressedColumn::Encoding::RUN_LENGTH,
+            column->GetEncoding());
+  EXPECT_LT(column->GetSize(), values.size() * sizeof(int32_t));
+
+  // Inside the value range, but not one of the runs
+  EXPECT_FALSE(MayContain<int32_t>(*column, 150));
+  EXPECT_FALSE(MayContain<int32_t>(*column, 1000));
+}
+
+TEST_F(CompressedColumnTests, DictionaryTest) {
+  std::vector<int64_t> distinct_values = {-5000000000000, 7, 9000000000000000};
+  std::vector<int64_t> values;
+  for (size_t itr = 0; itr < 1000; itr++) {
+    values.push_back(distinct_values[itr % distinct_values.size()]);
+  }
+
+  auto column = CompressAndCheck(type::TypeId::BIGINT, values);
+  EXPECT_EQ(storage::CompressedColumn::Encoding::DICTIONARY,
+            column->GetEncoding());
+  EXPECT_LT(column->GetSize(), values.size() * sizeof(int64_t));
+
+  EXPECT_FALSE(MayContain<int64_t>(*column, 8));
+}
+
+TEST_F(CompressedColumnTests, BitPackedTest) {
+  // Distinct values in a narrow range, including negative ones
+  std::vector<int32_t> values;
+  for (int32_t itr = 0; itr < 1000; itr++) {
+    values.push_back(itr * 3 - 100);
+  }
+
+  auto column = CompressAndCheck(type::TypeId::INTEGER, values);
+  EXPECT_EQ(storage::CompressedColumn::Encoding::BIT_PACKED,
+            column->GetEncoding());
+  EXPECT_LT(column->GetSize(), values.size() * sizeof(int32_t));
+
+  EXPECT_FALSE(MayContain<int32_t>(*column, -101));
+  EXPECT_FALSE(MayContain<int32_t>(*column, 3000));
+
+  std::vector<int8_t> small_values;
+  for (int itr = 0; itr < 1000; itr++) {
+    small_values.push_back(static_cast<int8_t>(itr % 16 - 8));
+  }
+  column = CompressAndCheck(type::TypeId::TINYINT, small_values);
+  EXPECT_EQ(storage::CompressedColumn::Encoding::BIT_PACKED,
+            column->GetEncoding());
+}
+
+TEST_F(CompressedColumnTests, PlainTest) {
+  std::mt19937_64 generator(42);
+  std::vector<uint64_t> values;
+  for (int itr = 0; itr < 1000; itr++) {
+    values.push_back(generator());
+  }
+
+  auto column = CompressAndCheck(type::TypeId::BIGINT, values);
+  EXPECT_EQ(storage::CompressedColumn::Encoding::PLAIN, column->GetEncoding());
+  EXPECT_EQ(values.size() * sizeof(uint64_t), column->GetSize());
+}
+
+TEST_F(CompressedColumnTests, StridedTest) {
+  // Values interleaved with other columns, as in a row-oriented tile
+  struct Row {
+    int32_t key;
+    int16_t flag;
+  };
+  std::vector<Row> rows;
+  for (int32_t itr = 0; itr < 100; itr++) {
+    rows.push_back({itr, static_cast<int16_t>(itr % 2)});
+  }
+
+  storage::CompressedColumn column(
+      type::TypeId::SMALLINT, sizeof(int16_t),
+      reinterpret_cast<const char *>(&rows[0].flag), sizeof(Row), rows.size());
+  for (oid_t slot = 0; slot < rows.size(); slot++) {
+    int16_t flag;
+    column.Decode(slot, reinterpret_cast<char *>(&flag));
+    EXPECT_EQ(rows[slot].flag, flag);
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -16,7 +16,11 @@
 
 #include "executor/testing_executor_util.h"
 #include "storage/tile_group.h"
+#include "storage/tile_group_preallocator.h"
 #include "storage/database.h"
+#include "storage/tile.h"
+#include "storage/zone_map.h"
+#include "type/value_factory.h"
 
 #include "concurrency/transaction_manager_factory.h"
 
@@ -73,6 +77,169 @@ TEST_F(DataTableTests, TransformTileGroupTest) {
 }
 
 
+TEST_F(DataTableTests, ReorganizeTileGroupTest) {
+  const int tuples_per_tile_group = 5;
+  const int tile_group_count = 4;
+  const int tuple_count = tuples_per_tile_group * tile_group_count;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuples_per_tile_group, true));
+  TestingExecutorUtil::PopulateTable(data_table.get(), tuple_count, false,
+                                     false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  auto tile_group = data_table->GetTileGroup(0);
+  auto tile_group_id = tile_group->GetTileGroupId();
+
+  // Just written to, so it is not cold yet
+  EXPECT_FALSE(data_table->ReorganizeTileGroup(0, 1.1, 1.1, 3600 * 1000));
+  EXPECT_FALSE(tile_group->IsRetired());
+
+  // Full and in the default layout, so there is nothing to do
+  EXPECT_FALSE(data_table->ReorganizeTileGroup(0, 1.1, 0.5, 0));
+  EXPECT_FALSE(tile_group->IsRetired());
+
+  // The active tile group is never touched
+  auto active_offset = data_table->GetTileGroupCount() - 1;
+  EXPECT_FALSE(data_table->ReorganizeTileGroup(active_offset, 0.0, 1.1, 0));
+
+  // Force the tile group to be merged into the active ones
+  EXPECT_TRUE(data_table->ReorganizeTileGroup(0, 1.1, 1.1, 0));
+  EXPECT_TRUE(tile_group->IsRetired());
+
+  // Nothing left to move
+  EXPECT_FALSE(data_table->ReorganizeTileGroup(0, 1.1, 1.1, 0));
+
+  // Every tuple is still visible exactly once, and none of them in the
+  // retired tile group
+  txn = txn_manager.BeginTransaction();
+  int visible_count = 0;
+  for (oid_t offset = 0; offset < data_table->GetTileGroupCount(); offset++) {
+    auto current_tile_group = data_table->GetTileGroup(offset);
+    auto header = current_tile_group->GetHeader();
+    for (oid_t tuple_id = 0; tuple_id < current_tile_group->GetNextTupleSlot();
+         tuple_id++) {
+      if (txn_manager.IsVisible(txn, header, tuple_id) == VisibilityType::OK) {
+        EXPECT_NE(tile_group_id, current_tile_group->GetTileGroupId());
+        visible_count++;
+      }
+    }
+  }
+  txn_manager.CommitTransaction(txn);
+  EXPECT_EQ(tuple_count, visible_count);
+
+  // The index entries followed the tuples through the indirection layer
+  std::vector<ItemPointer *> index_entries;
+  data_table->GetIndex(0)->ScanAllKeys(index_entries);
+  EXPECT_EQ(static_cast<size_t>(tuple_count), index_entries.size());
+  for (auto index_entry : index_entries) {
+    EXPECT_NE(tile_group_id, index_entry->block);
+  }
+}
+
+TEST_F(DataTableTests, ReorganizeBusyTileGroupTest) {
+  const int tuples_per_tile_group = 5;
+  const int tile_group_count = 4;
+  const int tuple_count = tuples_per_tile_group * tile_group_count;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuples_per_tile_group, true));
+  TestingExecutorUtil::PopulateTable(data_table.get(), tuple_count, false,
+                                     false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  auto tile_group = data_table->GetTileGroup(0);
+  auto tile_group_header = tile_group->GetHeader();
+
+  // An owned tuple keeps the tile group from being cold
+  auto owner_txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(txn_manager.AcquireOwnership(owner_txn, tile_group_header, 0));
+  EXPECT_FALSE(data_table->ReorganizeTileGroup(0, 1.1, 1.1, 0));
+  EXPECT_FALSE(tile_group->IsRetired());
+
+  // Once retired, the other tuples are moved around it
+  tile_group->SetRetired(true);
+  EXPECT_FALSE(data_table->ReorganizeTileGroup(0, 1.1, 1.1, 0));
+  EXPECT_TRUE(tile_group->IsRetired());
+  for (oid_t tuple_id = 1; tuple_id < tuples_per_tile_group; tuple_id++) {
+    EXPECT_NE(MAX_CID, tile_group_header->GetEndCommitId(tuple_id));
+  }
+  EXPECT_EQ(MAX_CID, tile_group_header->GetEndCommitId(0));
+
+  // And the last one as soon as it is released
+  txn_manager.YieldOwnership(owner_txn, tile_group_header, 0);
+  txn_manager.CommitTransaction(owner_txn);
+  EXPECT_TRUE(data_table->ReorganizeTileGroup(0, 1.1, 1.1, 0));
+  EXPECT_NE(MAX_CID, tile_group_header->GetEndCommitId(0));
+}
+
+TEST_F(DataTableTests, FreezeTileGroupTest) {
+  const int tuple_count = 100;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuple_count, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), tuple_count, false,
+                                     false, true, txn);
+  txn_manager.CommitTransaction(txn);
+
+  auto tile_group = data_table->GetTileGroup(0);
+  auto column_count = data_table->GetSchema()->GetColumnCount();
+  std::vector<type::Value> expected_values;
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      expected_values.push_back(
+          tile_group->GetValue(tuple_id, column_itr).Copy());
+    }
+  }
+
+  // The active tile group can still be written to
+  auto active_offset = data_table->GetTileGroupCount() - 1;
+  EXPECT_FALSE(data_table->FreezeTileGroup(active_offset, 0));
+  EXPECT_FALSE(data_table->GetTileGroup(active_offset)->IsFrozen());
+
+  EXPECT_TRUE(data_table->FreezeTileGroup(0, 0));
+  EXPECT_TRUE(tile_group->IsFrozen());
+  EXPECT_FALSE(data_table->FreezeTileGroup(0, 0));
+
+  // No transaction is left that could read the uncompressed tiles
+  if (tile_group->HasUncompressedData() == true) {
+    tile_group->ReleaseUncompressedData();
+  }
+  EXPECT_FALSE(tile_group->HasUncompressedData());
+  EXPECT_LT(tile_group->GetCompressedSize(),
+            tile_group->GetTile(0)->GetInlinedSize());
+
+  size_t value_itr = 0;
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      auto value = tile_group->GetValue(tuple_id, column_itr);
+      EXPECT_EQ(type::CMP_TRUE,
+                expected_values[value_itr++].CompareEquals(value));
+    }
+  }
+
+  // The first column only holds two values, so a value between them passes
+  // the zone map but not the compressed column
+  std::vector<storage::ZoneMapPredicate> predicates;
+  predicates.emplace_back(0, ExpressionType::COMPARE_EQUAL,
+                          type::ValueFactory::GetIntegerValue(
+                              TestingExecutorUtil::PopulatedValue(1, 0)));
+  EXPECT_TRUE(tile_group->ShouldScan(predicates.data(), predicates.size()));
+
+  predicates.clear();
+  predicates.emplace_back(0, ExpressionType::COMPARE_EQUAL,
+                          type::ValueFactory::GetIntegerValue(
+                              TestingExecutorUtil::PopulatedValue(1, 0) / 2));
+  EXPECT_TRUE(tile_group->GetZoneMap()->ShouldScan(predicates));
+  EXPECT_FALSE(tile_group->ShouldScan(predicates.data(), predicates.size()));
+}
+
 TEST_F(DataTableTests, GlobalTableTest) {
   const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
 
@@ -87,5 +254,75 @@ TEST_F(DataTableTests, GlobalTableTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+TEST_F(DataTableTests, TileGroupPreallocationTest) {
+  const int tuples_per_tile_group = 5;
+  const int tile_group_count = 4;
+
+  storage::DataTable::SetTileGroupReserveCount(2);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuples_per_tile_group, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(),
+                                     tuples_per_tile_group * tile_group_count,
+                                     false, false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  storage::DataTable::SetTileGroupReserveCount(0);
+
+  // Every rollover added exactly one tile group, whether it came from the
+  // reserve or had to be allocated on the spot
+  auto preallocator = data_table->GetTileGroupPreallocator();
+  ASSERT_NE(nullptr, preallocator);
+  EXPECT_EQ(tile_group_count + 1, data_table->GetTileGroupCount());
+  EXPECT_EQ(tile_group_count, preallocator->GetTileGroupHitCount() +
+                                  preallocator->GetTileGroupMissCount());
+
+  for (int tile_group_itr = 0; tile_group_itr < tile_group_count;
+       tile_group_itr++) {
+    auto tile_group = data_table->GetTileGroup(tile_group_itr);
+    EXPECT_EQ(tuples_per_tile_group, tile_group->GetActiveTupleCount());
+  }
+}
+
+TEST_F(DataTableTests, TileGroupPreallocationLayoutTest) {
+  const int tuples_per_tile_group = 5;
+
+  storage::DataTable::SetTileGroupReserveCount(2);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuples_per_tile_group, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(),
+                                     tuples_per_tile_group * 2, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  storage::DataTable::SetTileGroupReserveCount(0);
+
+  // Tile groups reserved in row layout are not handed out once new tile
+  // groups get the column layout
+  auto layout_mode = peloton_layout_mode;
+  peloton_layout_mode = LAYOUT_TYPE_COLUMN;
+  auto tile_group_count = data_table->GetTileGroupCount();
+
+  txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(data_table.get(),
+                                     tuples_per_tile_group * 2, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+  peloton_layout_mode = layout_mode;
+
+  auto column_count = data_table->GetSchema()->GetColumnCount();
+  ASSERT_LT(tile_group_count, data_table->GetTileGroupCount());
+  for (auto tile_group_itr = tile_group_count;
+       tile_group_itr < data_table->GetTileGroupCount(); tile_group_itr++) {
+    auto tile_group = data_table->GetTileGroup(tile_group_itr);
+    EXPECT_EQ(column_count, tile_group->GetTileCount());
+  }
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -0,0 +1,327 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// materialized_view_test.cpp
+//
+// Identification: test/storage/materialized_view_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <thread>
+
+#include "common/harness.h"
+
+#include "storage/materialized_view.h"
+
+#include "catalog/schema.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "executor/logical_tile.h"
+#include "executor/materialized_view_scan_executor.h"
+#include "executor/testing_executor_util.h"
+#include "planner/materialized_view_scan_plan.h"
+#include "storage/data_table.h"
+#include "storage/table_factory.h"
+#include "storage/tuple.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Materialized View Tests
+//===--------------------------------------------------------------------===//
+
+class MaterializedViewTests : public PelotonTest {};
+
+typedef storage::MaterializedViewColumn Column;
+
+// (a, b, c, d) = (key, key % 3, key, "x")
+static std::unique_ptr<storage::Tuple> MakeTuple(storage::DataTable *table,
+                                                 int key) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::unique_ptr<storage::Tuple> tuple(
+      new storage::Tuple(table->GetSchema(), true));
+  tuple->SetValue(0, type::ValueFactory::GetIntegerValue(key), pool);
+  tuple->SetValue(1, type::ValueFactory::GetIntegerValue(key % 3), pool);
+  tuple->SetValue(2, type::ValueFactory::GetDecimalValue(key), pool);
+  tuple->SetValue(3, type::ValueFactory::GetVarcharValue("x"), pool);
+  return tuple;
+}
+
+static void InsertTuples(storage::DataTable *table, int begin, int end) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  for (int key = begin; key < end; key++) {
+    auto tuple = MakeTuple(table, key);
+    ItemPointer *index_entry_ptr = nullptr;
+    auto location = table->InsertTuple(tuple.get(), txn, &index_entry_ptr);
+    ASSERT_NE(INVALID_OID, location.block);
+    txn_manager.PerformInsert(txn, location, index_entry_ptr);
+  }
+  txn_manager.CommitTransaction(txn);
+}
+
+static storage::DataTable *CreateTable() {
+  auto schema = new catalog::Schema({TestingExecutorUtil::GetColumnInfo(0),
+                                     TestingExecutorUtil::GetColumnInfo(1),
+                                     TestingExecutorUtil::GetColumnInfo(2),
+                                     TestingExecutorUtil::GetColumnInfo(3)});
+  return storage::TableFactory::GetDataTable(INVALID_OID, INVALID_OID, schema,
+                                             "view_table",
+                                             TESTS_TUPLES_PER_TILEGROUP,
+                                             true, false);
+}
+
+// SELECT b, COUNT(*), SUM(a), MIN(a), MAX(a), AVG(c) ... GROUP BY b
+static std::shared_ptr<storage::MaterializedView> CreateView(
+    storage::DataTable *table) {
+  std::shared_ptr<storage::MaterializedView> view(
+      new storage::MaterializedView(
+          "view", table, {1},
+          {{ExpressionType::AGGREGATE_COUNT_STAR, INVALID_OID},
+           {ExpressionType::AGGREGATE_SUM, 0},
+           {ExpressionType::AGGREGATE_MIN, 0},
+           {ExpressionType::AGGREGATE_MAX, 0},
+           {ExpressionType::AGGREGATE_AVG, 2}},
+          0));
+  table->AddMaterializedView(view);
+  return view;
+}
+
+static const std::vector<Column> kColumns = {
+    {ExpressionType::INVALID, 0},
+    {ExpressionType::AGGREGATE_COUNT_STAR, 0},
+    {ExpressionType::AGGREGATE_SUM, 1},
+    {ExpressionType::AGGREGATE_MIN, 2},
+    {ExpressionType::AGGREGATE_MAX, 3},
+    {ExpressionType::AGGREGATE_AVG, 4}};
+
+// The row of the group b = group
+static std::vector<type::Value> GetGroup(storage::MaterializedView *view,
+                                         int group) {
+  auto rows = view->GetRows(kColumns, {0},
+                            {type::ValueFactory::GetIntegerValue(group)});
+  EXPECT_EQ(1, rows.size());
+  return rows.empty() ? std::vector<type::Value>() : rows[0];
+}
+
+TEST_F(MaterializedViewTests, AggregateTest) {
+  std::unique_ptr<storage::DataTable> table(CreateTable());
+  InsertTuples(table.get(), 0, 30);
+
+  auto view = CreateView(table.get());
+  view->Refresh();
+  EXPECT_EQ(3, view->GetGroupCount());
+
+  // b = 1: a in 1, 4, ..., 28
+  auto row = GetGroup(view.get(), 1);
+  EXPECT_EQ(1, row[0].GetAs<int32_t>());
+  EXPECT_EQ(10, row[1].GetAs<int64_t>());
+  EXPECT_EQ(145, row[2].GetAs<int32_t>());
+  EXPECT_EQ(1, row[3].GetAs<int32_t>());
+  EXPECT_EQ(28, row[4].GetAs<int32_t>());
+  EXPECT_EQ(14.5, row[5].GetAs<double>());
+
+  // COUNT(a) and AVG(a) come from the aggregates over a
+  EXPECT_EQ(1, view->GetAggregateOffset(ExpressionType::AGGREGATE_COUNT, 0));
+  EXPECT_EQ(1, view->GetAggregateOffset(ExpressionType::AGGREGATE_AVG, 0));
+  EXPECT_EQ(3, view->GetAggregateOffset(ExpressionType::AGGREGATE_MAX, 0));
+  EXPECT_EQ(INVALID_OID,
+            view->GetAggregateOffset(ExpressionType::AGGREGATE_MIN, 2));
+
+  // Committed inserts are applied to the view
+  InsertTuples(table.get(), 30, 33);
+  EXPECT_EQ(3, view->GetGroupCount());
+  row = GetGroup(view.get(), 1);
+  EXPECT_EQ(11, row[1].GetAs<int64_t>());
+  EXPECT_EQ(176, row[2].GetAs<int32_t>());
+  EXPECT_EQ(31, row[4].GetAs<int32_t>());
+
+  // As are deletes
+  auto tuple = MakeTuple(table.get(), 4);
+  view->Lock();
+  view->ApplyDelete(tuple.get());
+  view->Unlock();
+  row = GetGroup(view.get(), 1);
+  EXPECT_EQ(10, row[1].GetAs<int64_t>());
+  EXPECT_EQ(172, row[2].GetAs<int32_t>());
+  EXPECT_EQ(1, row[3].GetAs<int32_t>());
+
+  // Deleting the minimum leaves the view to rebuild from the table, which
+  // still holds both tuples
+  tuple = MakeTuple(table.get(), 1);
+  view->Lock();
+  view->ApplyDelete(tuple.get());
+  view->Unlock();
+  row = GetGroup(view.get(), 1);
+  EXPECT_EQ(11, row[1].GetAs<int64_t>());
+  EXPECT_EQ(1, row[3].GetAs<int32_t>());
+
+  // A group comes with its first tuple and goes with its last one
+  tuple = MakeTuple(table.get(), 7);
+  tuple->SetValue(1, type::ValueFactory::GetIntegerValue(7), nullptr);
+  view->Lock();
+  view->ApplyInsert(tuple.get());
+  view->Unlock();
+  EXPECT_EQ(4, view->GetGroupCount());
+  row = GetGroup(view.get(), 7);
+  EXPECT_EQ(1, row[1].GetAs<int64_t>());
+  EXPECT_EQ(7, row[3].GetAs<int32_t>());
+  view->Lock();
+  view->ApplyDelete(tuple.get());
+  view->Unlock();
+  EXPECT_EQ(3, view->GetGroupCount());
+  EXPECT_EQ(0, view->GetRows(kColumns, {0},
+                             {type::ValueFactory::GetIntegerValue(7)}).size());
+
+  // A dropped view is empty and ignores changes
+  EXPECT_TRUE(table->DropMaterializedView("view"));
+  EXPECT_FALSE(table->HasMaterializedViews());
+  InsertTuples(table.get(), 33, 36);
+  EXPECT_EQ(0, view->GetGroupCount());
+}
+
+TEST_F(MaterializedViewTests, ScanTest) {
+  std::unique_ptr<storage::DataTable> table(CreateTable());
+  InsertTuples(table.get(), 0, 30);
+  auto view = CreateView(table.get());
+
+  // SELECT COUNT(*), b ... WHERE b = ? GROUP BY b
+  std::shared_ptr<const catalog::Schema> output_schema(new catalog::Schema(
+      {catalog::Column(type::TypeId::BIGINT,
+                       type::Type::GetTypeSize(type::TypeId::BIGINT),
+                       "count"),
+       catalog::Column(type::TypeId::INTEGER,
+                       type::Type::GetTypeSize(type::TypeId::INTEGER), "b")}));
+  std::unique_ptr<planner::MaterializedViewScanPlan> plan(
+      new planner::MaterializedViewScanPlan(
+          view, {{ExpressionType::AGGREGATE_COUNT_STAR, 0},
+                 {ExpressionType::INVALID, 0}},
+          output_schema, {0},
+          {type::ValueFactory::GetParameterOffsetValue(0).Copy()}));
+
+  for (int group = 0; group < 4; group++) {
+    std::vector<type::Value> params = {
+        type::ValueFactory::GetIntegerValue(group)};
+    auto copy = plan->Copy();
+    copy->SetParameterValues(&params);
+
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    executor::ExecutorContext context(txn);
+    executor::MaterializedViewScanExecutor executor(copy.get(), &context);
+    EXPECT_TRUE(executor.Init());
+
+    size_t row_count = 0;
+    while (executor.Execute()) {
+      std::unique_ptr<executor::LogicalTile> tile(executor.GetOutput());
+      for (auto tuple_id : *tile) {
+        EXPECT_EQ(10, tile->GetValue(tuple_id, 0).GetAs<int64_t>());
+        EXPECT_EQ(group, tile->GetValue(tuple_id, 1).GetAs<int32_t>());
+        row_count++;
+      }
+    }
+    EXPECT_EQ(group < 3 ? 1 : 0, row_count);
+    txn_manager.CommitTransaction(txn);
+  }
+
+  // A transaction that has written reads its own tuples from the table
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction(IsolationLevelType::READ_COMMITTED);
+  auto tuple = MakeTuple(table.get(), 30);
+  ItemPointer *index_entry_ptr = nullptr;
+  auto location = table->InsertTuple(tuple.get(), txn, &index_entry_ptr);
+  txn_manager.PerformInsert(txn, location, index_entry_ptr);
+  EXPECT_FALSE(storage::MaterializedView::CanRead(txn));
+
+  std::vector<type::Value> params = {type::ValueFactory::GetIntegerValue(0)};
+  auto copy = plan->Copy();
+  copy->SetParameterValues(&params);
+  {
+    executor::ExecutorContext context(txn);
+    executor::MaterializedViewScanExecutor executor(copy.get(), &context);
+    EXPECT_TRUE(executor.Init());
+    ASSERT_TRUE(executor.Execute());
+    std::unique_ptr<executor::LogicalTile> tile(executor.GetOutput());
+    ASSERT_EQ(1, tile->GetTupleCount());
+    EXPECT_EQ(11, tile->GetValue(0, 0).GetAs<int64_t>());
+  }
+  txn_manager.AbortTransaction(txn);
+
+  // A plan of a dropped view must be made again
+  EXPECT_TRUE(table->DropMaterializedView("view"));
+  txn = txn_manager.BeginTransaction(IsolationLevelType::READ_COMMITTED);
+  {
+    executor::ExecutorContext context(txn);
+    executor::MaterializedViewScanExecutor executor(copy.get(), &context);
+    EXPECT_THROW(executor.Init(), CatalogException);
+  }
+  txn_manager.CommitTransaction(txn);
+}
+
+TEST_F(MaterializedViewTests, SnapshotReadTest) {
+  std::unique_ptr<storage::DataTable> table(CreateTable());
+  InsertTuples(table.get(), 0, 30);
+  auto view = CreateView(table.get());
+  view->Refresh();
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction(IsolationLevelType::SERIALIZABLE);
+  EXPECT_FALSE(storage::MaterializedView::CanRead(txn));
+  txn_manager.CommitTransaction(txn);
+
+  // A snapshot reader gets the groups as of its snapshot, from the view or
+  // from the table, however much commits after it
+  txn = txn_manager.BeginTransaction(IsolationLevelType::SNAPSHOT);
+  EXPECT_TRUE(storage::MaterializedView::CanRead(txn));
+  std::vector<type::Value> key = {type::ValueFactory::GetIntegerValue(1)};
+  auto expected = view->ScanRows(txn, kColumns, {0}, key);
+  ASSERT_EQ(1, expected.size());
+  EXPECT_EQ(10, expected[0][1].GetAs<int64_t>());
+  for (int begin = 30; begin < 36; begin += 3) {
+    InsertTuples(table.get(), begin, begin + 3);
+    auto rows = view->GetRows(txn, kColumns, {0}, key);
+    ASSERT_EQ(1, rows.size());
+    for (size_t column_itr = 0; column_itr < kColumns.size(); column_itr++) {
+      EXPECT_EQ(type::CMP_TRUE,
+                rows[0][column_itr].CompareEquals(expected[0][column_itr]));
+    }
+  }
+  txn_manager.CommitTransaction(txn);
+
+  // READ COMMITTED reads the latest state
+  EXPECT_EQ(12, GetGroup(view.get(), 1)[1].GetAs<int64_t>());
+}
+
+TEST_F(MaterializedViewTests, ConcurrentRefreshTest) {
+  std::unique_ptr<storage::DataTable> table(CreateTable());
+  InsertTuples(table.get(), 0, 30);
+  auto view = CreateView(table.get());
+  view->Refresh();
+
+  // Commits go on while the view is rebuilt over and over, and none of
+  // them is lost or counted twice
+  std::thread writer([&] {
+    for (int key = 30; key < 330; key += 3) {
+      InsertTuples(table.get(), key, key + 3);
+    }
+  });
+  for (int refresh_itr = 0; refresh_itr < 20; refresh_itr++) {
+    view->Refresh();
+  }
+  writer.join();
+
+  auto row = GetGroup(view.get(), 1);
+  EXPECT_EQ(110, row[1].GetAs<int64_t>());
+  EXPECT_EQ(1, row[3].GetAs<int32_t>());
+  EXPECT_EQ(328, row[4].GetAs<int32_t>());
+  view->Refresh();
+  EXPECT_EQ(110, GetGroup(view.get(), 1)[1].GetAs<int64_t>());
+}
+
+}  // namespace test
+}  // namespace peloton
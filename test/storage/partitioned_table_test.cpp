@@ -0,0 +1,316 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// partitioned_table_test.cpp
+//
+// Identification: test/storage/partitioned_table_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "storage/partitioned_table.h"
+
+#include "catalog/schema.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/append_executor.h"
+#include "executor/executor_context.h"
+#include "executor/logical_tile.h"
+#include "executor/seq_scan_executor.h"
+#include "executor/testing_executor_util.h"
+#include "expression/comparison_expression.h"
+#include "expression/expression_util.h"
+#include "expression/parameter_value_expression.h"
+#include "index/index.h"
+#include "planner/append_plan.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/data_table.h"
+#include "storage/table_factory.h"
+#include "storage/tuple.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Partitioned Table Tests
+//===--------------------------------------------------------------------===//
+
+class PartitionedTableTests : public PelotonTest {};
+
+// a <comparison> value, on the partition key column
+static expression::AbstractExpression *Compare(ExpressionType comparison,
+                                               int value) {
+  return expression::ExpressionUtil::ComparisonFactory(
+      comparison,
+      expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER, 0,
+                                                    0),
+      expression::ExpressionUtil::ConstantValueFactory(
+          type::ValueFactory::GetIntegerValue(value)));
+}
+
+static std::vector<oid_t> Prune(const storage::PartitionScheme &scheme,
+                                expression::AbstractExpression *predicate,
+                                const std::vector<type::Value> *params =
+                                    nullptr) {
+  std::unique_ptr<expression::AbstractExpression> owned(predicate);
+  return scheme.Prune(predicate, params);
+}
+
+// A scan of the partitions of table the predicate does not prune: an
+// append of a sequential scan of each, run concurrently if parallel is set
+static std::unique_ptr<planner::AbstractPlan> ScanPlan(
+    const storage::PartitionedTable *table,
+    expression::AbstractExpression *predicate,
+    const std::vector<oid_t> &column_ids, bool parallel) {
+  std::unique_ptr<expression::AbstractExpression> owned(predicate);
+  std::unique_ptr<planner::AbstractPlan> plan(
+      new planner::AppendPlan(parallel));
+  for (auto partition : table->PrunePartitions(predicate)) {
+    plan->AddChild(std::unique_ptr<planner::AbstractPlan>(
+        new planner::SeqScanPlan(table->GetPartition(partition),
+                                 predicate->Copy(), column_ids)));
+  }
+  return plan;
+}
+
+// Execute an append scan of a partitioned table, returning the tuple count of
+// at most max_tiles tiles
+static size_t CountScanned(const planner::AbstractPlan *plan,
+                           concurrency::Transaction *txn,
+                           size_t max_tiles = SIZE_MAX) {
+  executor::ExecutorContext context(txn);
+  // The append goes away before its children, as in the plan executor
+  std::vector<std::unique_ptr<executor::AbstractExecutor>> children;
+  std::unique_ptr<executor::AbstractExecutor> root(
+      new executor::AppendExecutor(plan, &context));
+  for (auto &child : plan->GetChildren()) {
+    children.emplace_back(new executor::SeqScanExecutor(child.get(), &context));
+    root->AddChild(children.back().get());
+  }
+
+  EXPECT_TRUE(root->Init());
+  size_t tuple_count = 0;
+  for (size_t tile_itr = 0; tile_itr < max_tiles && root->Execute();
+       tile_itr++) {
+    std::unique_ptr<executor::LogicalTile> tile(root->GetOutput());
+    tuple_count += tile->GetTupleCount();
+  }
+  return tuple_count;
+}
+
+TEST_F(PartitionedTableTests, RoutingTest) {
+  storage::PartitionScheme hash(0, type::TypeId::INTEGER, 8);
+  for (int key = 0; key < 100; key++) {
+    auto partition =
+        hash.GetPartition(type::ValueFactory::GetIntegerValue(key));
+    EXPECT_LT(partition, 8);
+    // Integers of any width find the same partition
+    EXPECT_EQ(partition,
+              hash.GetPartition(type::ValueFactory::GetBigIntValue(key)));
+    EXPECT_EQ(partition,
+              hash.GetPartition(type::ValueFactory::GetTinyIntValue(key)));
+  }
+  EXPECT_EQ(0, hash.GetPartition(type::ValueFactory::GetNullValueByType(
+                   type::TypeId::INTEGER)));
+
+  // [.., 10) [10, 20) [20, 30) [30, ..)
+  storage::PartitionScheme range(
+      0, {type::ValueFactory::GetIntegerValue(10),
+          type::ValueFactory::GetIntegerValue(20),
+          type::ValueFactory::GetIntegerValue(30)});
+  EXPECT_EQ(4, range.GetPartitionCount());
+  EXPECT_EQ(0, range.GetPartition(type::ValueFactory::GetIntegerValue(-5)));
+  EXPECT_EQ(0, range.GetPartition(type::ValueFactory::GetIntegerValue(9)));
+  EXPECT_EQ(1, range.GetPartition(type::ValueFactory::GetIntegerValue(10)));
+  EXPECT_EQ(2, range.GetPartition(type::ValueFactory::GetIntegerValue(29)));
+  EXPECT_EQ(3, range.GetPartition(type::ValueFactory::GetIntegerValue(30)));
+  EXPECT_EQ(2, range.GetPartition(type::ValueFactory::GetDecimalValue(25.5)));
+}
+
+TEST_F(PartitionedTableTests, PruningTest) {
+  storage::PartitionScheme range(
+      0, {type::ValueFactory::GetIntegerValue(10),
+          type::ValueFactory::GetIntegerValue(20),
+          type::ValueFactory::GetIntegerValue(30)});
+  typedef std::vector<oid_t> Partitions;
+
+  EXPECT_EQ(Partitions({1}),
+            Prune(range, Compare(ExpressionType::COMPARE_EQUAL, 15)));
+  EXPECT_EQ(Partitions({0, 1}),
+            Prune(range, Compare(ExpressionType::COMPARE_LESSTHAN, 20)));
+  EXPECT_EQ(Partitions({0, 1, 2}),
+            Prune(range,
+                  Compare(ExpressionType::COMPARE_LESSTHANOREQUALTO, 20)));
+  EXPECT_EQ(Partitions({2, 3}),
+            Prune(range,
+                  Compare(ExpressionType::COMPARE_GREATERTHANOREQUALTO, 20)));
+  EXPECT_EQ(Partitions({0, 1, 2, 3}),
+            Prune(range, Compare(ExpressionType::COMPARE_NOTEQUAL, 20)));
+
+  // 10 < a AND a <= 20
+  EXPECT_EQ(Partitions({1, 2}),
+            Prune(range, expression::ExpressionUtil::ConjunctionFactory(
+                             ExpressionType::CONJUNCTION_AND,
+                             Compare(ExpressionType::COMPARE_GREATERTHAN, 10),
+                             Compare(ExpressionType::COMPARE_LESSTHANOREQUALTO,
+                                     20))));
+
+  // a IN (5, 35)
+  EXPECT_EQ(Partitions({0, 3}),
+            Prune(range,
+                  new expression::ComparisonExpression(
+                      ExpressionType::COMPARE_IN,
+                      expression::ExpressionUtil::TupleValueFactory(
+                          type::TypeId::INTEGER, 0, 0),
+                      {expression::ExpressionUtil::ConstantValueFactory(
+                           type::ValueFactory::GetIntegerValue(5)),
+                       expression::ExpressionUtil::ConstantValueFactory(
+                           type::ValueFactory::GetIntegerValue(35))})));
+
+  // a = ? only prunes once the parameter is known
+  auto param = [] {
+    return expression::ExpressionUtil::ComparisonFactory(
+        ExpressionType::COMPARE_EQUAL,
+        expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER,
+                                                      0, 0),
+        new expression::ParameterValueExpression(0));
+  };
+  std::vector<type::Value> params = {type::ValueFactory::GetIntegerValue(31)};
+  EXPECT_EQ(Partitions({0, 1, 2, 3}), Prune(range, param()));
+  EXPECT_EQ(Partitions({3}), Prune(range, param(), &params));
+
+  // Predicates on other columns keep every partition
+  EXPECT_EQ(Partitions({0, 1, 2, 3}),
+            Prune(range, expression::ExpressionUtil::ComparisonFactory(
+                             ExpressionType::COMPARE_EQUAL,
+                             expression::ExpressionUtil::TupleValueFactory(
+                                 type::TypeId::INTEGER, 0, 1),
+                             expression::ExpressionUtil::ConstantValueFactory(
+                                 type::ValueFactory::GetIntegerValue(15)))));
+
+  // A hash scheme prunes with equalities but not with ranges
+  storage::PartitionScheme hash(0, type::TypeId::INTEGER, 4);
+  auto partition = hash.GetPartition(type::ValueFactory::GetIntegerValue(7));
+  EXPECT_EQ(Partitions({partition}),
+            Prune(hash, Compare(ExpressionType::COMPARE_EQUAL, 7)));
+  EXPECT_EQ(Partitions({0, 1, 2, 3}),
+            Prune(hash, Compare(ExpressionType::COMPARE_LESSTHAN, 7)));
+  EXPECT_EQ(Partitions({partition}),
+            Prune(hash, expression::ExpressionUtil::ComparisonFactory(
+                            ExpressionType::COMPARE_EQUAL,
+                            expression::ExpressionUtil::TupleValueFactory(
+                                type::TypeId::INTEGER, 0, 0),
+                            expression::ExpressionUtil::ConstantValueFactory(
+                                type::ValueFactory::GetBigIntValue(7)))));
+}
+
+TEST_F(PartitionedTableTests, ScanTest) {
+  const int tuple_count = 40;
+
+  catalog::Schema schema({TestingExecutorUtil::GetColumnInfo(0),
+                          TestingExecutorUtil::GetColumnInfo(1),
+                          TestingExecutorUtil::GetColumnInfo(2),
+                          TestingExecutorUtil::GetColumnInfo(3)});
+  auto scheme = new storage::PartitionScheme(
+      0, {type::ValueFactory::GetIntegerValue(10),
+          type::ValueFactory::GetIntegerValue(20),
+          type::ValueFactory::GetIntegerValue(30)});
+  std::unique_ptr<storage::PartitionedTable> table(
+      storage::TableFactory::GetPartitionedTable(
+          INVALID_OID, 100, &schema, "partitioned_table",
+          TESTS_TUPLES_PER_TILEGROUP, scheme, true));
+  ASSERT_EQ(4, table->GetPartitionCount());
+  EXPECT_EQ(102, table->GetPartition(2)->GetOid());
+
+  // A local primary key index on every partition
+  table->AddIndex("partitioned_table_pkey", 1000, IndexType::BWTREE,
+                  IndexConstraintType::PRIMARY_KEY, {0}, true);
+
+  // Inserts go to the partition of column 0
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  for (int key = 0; key < tuple_count; key++) {
+    storage::Tuple tuple(table->GetSchema(), true);
+    tuple.SetValue(0, type::ValueFactory::GetIntegerValue(key), pool);
+    tuple.SetValue(1, type::ValueFactory::GetIntegerValue(key % 3), pool);
+    tuple.SetValue(2, type::ValueFactory::GetDecimalValue(key), pool);
+    tuple.SetValue(3, type::ValueFactory::GetVarcharValue("x"), pool);
+    ItemPointer *index_entry_ptr = nullptr;
+    auto location = table->InsertTuple(&tuple, txn, &index_entry_ptr);
+    ASSERT_NE(INVALID_OID, location.block);
+    txn_manager.PerformInsert(txn, location, index_entry_ptr);
+  }
+  txn_manager.CommitTransaction(txn);
+
+  for (oid_t partition_itr = 0; partition_itr < table->GetPartitionCount();
+       partition_itr++) {
+    auto partition = table->GetPartition(partition_itr);
+    EXPECT_EQ(tuple_count / 4, partition->GetTupleCount());
+    auto index = partition->GetIndexWithOid(1000);
+    EXPECT_EQ(partition->GetOid(), index->GetMetadata()->GetTableOid());
+  }
+  EXPECT_EQ(tuple_count, table->GetTupleCount());
+
+  // a >= 20 AND b = 1 scans the two upper partitions, in parallel for a
+  // read only transaction and one after the other otherwise
+  auto predicate = expression::ExpressionUtil::ConjunctionFactory(
+      ExpressionType::CONJUNCTION_AND,
+      Compare(ExpressionType::COMPARE_GREATERTHANOREQUALTO, 20),
+      expression::ExpressionUtil::ComparisonFactory(
+          ExpressionType::COMPARE_EQUAL,
+          expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER,
+                                                        0, 1),
+          expression::ExpressionUtil::ConstantValueFactory(
+              type::ValueFactory::GetIntegerValue(1))));
+  auto plan = ScanPlan(table.get(), predicate, {0, 1}, true);
+  EXPECT_EQ(2, plan->GetChildrenSize());
+
+  size_t expected = 0;
+  for (int key = 20; key < tuple_count; key++) {
+    expected += key % 3 == 1;
+  }
+  for (auto isolation_level :
+       {IsolationLevelType::READ_ONLY, IsolationLevelType::SERIALIZABLE}) {
+    txn = txn_manager.BeginTransaction(isolation_level);
+    EXPECT_EQ(expected, CountScanned(plan.get(), txn));
+    txn_manager.CommitTransaction(txn);
+  }
+
+  // Stopping after the first tile of a parallel scan of all partitions
+  // waits for the workers before the children are deleted
+  plan = ScanPlan(table.get(),
+                  Compare(ExpressionType::COMPARE_GREATERTHANOREQUALTO, 0),
+                  {0}, true);
+  EXPECT_EQ(4, plan->GetChildrenSize());
+  txn = txn_manager.BeginTransaction(IsolationLevelType::READ_ONLY);
+  EXPECT_LT(0, CountScanned(plan.get(), txn, 1));
+  EXPECT_EQ(tuple_count, CountScanned(plan.get(), txn));
+  txn_manager.CommitTransaction(txn);
+
+  // An equality scans a single partition, disjoint ranges none
+  plan = ScanPlan(table.get(), Compare(ExpressionType::COMPARE_EQUAL, 12), {0},
+                  true);
+  EXPECT_EQ(1, plan->GetChildrenSize());
+  txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(1, CountScanned(plan.get(), txn));
+  txn_manager.CommitTransaction(txn);
+
+  plan = ScanPlan(table.get(),
+                  expression::ExpressionUtil::ConjunctionFactory(
+                      ExpressionType::CONJUNCTION_AND,
+                      Compare(ExpressionType::COMPARE_LESSTHAN, 10),
+                      Compare(ExpressionType::COMPARE_GREATERTHAN, 30)),
+                  {0}, true);
+  EXPECT_EQ(0, plan->GetChildrenSize());
+  txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(0, CountScanned(plan.get(), txn));
+  txn_manager.CommitTransaction(txn);
+}
+
+}  // namespace test
+}  // namespace peloton
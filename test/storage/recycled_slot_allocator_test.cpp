@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// recycled_slot_allocator_test.cpp
+//
+// Identification: test/storage/recycled_slot_allocator_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "storage/recycled_slot_allocator.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Recycled Slot Allocator Tests
+//===--------------------------------------------------------------------===//
+
+class RecycledSlotAllocatorTests : public PelotonTest {};
+
+TEST_F(RecycledSlotAllocatorTests, AllocateTest) {
+  storage::RecycledSlotAllocator allocator;
+  EXPECT_TRUE(allocator.Allocate().IsNull());
+
+  allocator.Recycle(1, {0, 1, 2});
+  allocator.Recycle(2, {5});
+  allocator.Recycle(3, {});
+  EXPECT_EQ(4UL, allocator.GetSlotCount());
+
+  // Every slot is handed out exactly once
+  std::set<std::pair<oid_t, oid_t>> slots;
+  for (int slot_itr = 0; slot_itr < 4; slot_itr++) {
+    auto location = allocator.Allocate();
+    ASSERT_FALSE(location.IsNull());
+    oid_t block = location.block;
+    oid_t offset = location.offset;
+    slots.insert(std::make_pair(block, offset));
+  }
+  EXPECT_EQ(4UL, slots.size());
+  EXPECT_EQ(1UL, slots.count(std::make_pair(2U, 5U)));
+
+  EXPECT_TRUE(allocator.Allocate().IsNull());
+  EXPECT_EQ(0UL, allocator.GetSlotCount());
+}
+
+TEST_F(RecycledSlotAllocatorTests, LocalityTest) {
+  storage::RecycledSlotAllocator allocator;
+  allocator.Recycle(1, {0, 1, 2, 3});
+  allocator.Recycle(2, {0, 1, 2, 3});
+
+  // Once a thread found a slot, it keeps using the same tile group
+  auto first = allocator.Allocate();
+  for (int slot_itr = 0; slot_itr < 3; slot_itr++) {
+    EXPECT_EQ(first.block, allocator.Allocate().block);
+  }
+}
+
+TEST_F(RecycledSlotAllocatorTests, ConcurrentTest) {
+  storage::RecycledSlotAllocator allocator;
+
+  const oid_t tile_group_count = 64;
+  const oid_t slots_per_tile_group = 100;
+  const int thread_count = 8;
+
+  std::atomic<size_t> allocated_count(0);
+  std::atomic<bool> done(false);
+
+  // Inserters race with the hand-over of the slots
+  std::vector<std::thread> threads;
+  for (int thread_itr = 0; thread_itr < thread_count; thread_itr++) {
+    threads.emplace_back([&] {
+      while (true) {
+        bool finished = done.load();
+        if (allocator.Allocate().IsNull() == false) {
+          allocated_count++;
+        } else if (finished == true) {
+          break;
+        }
+      }
+    });
+  }
+
+  std::vector<oid_t> offsets;
+  for (oid_t offset = 0; offset < slots_per_tile_group; offset++) {
+    offsets.push_back(offset);
+  }
+  for (oid_t tile_group_id = 0; tile_group_id < tile_group_count;
+       tile_group_id++) {
+    allocator.Recycle(tile_group_id, offsets);
+  }
+  done = true;
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(static_cast<size_t>(tile_group_count * slots_per_tile_group),
+            allocated_count.load());
+  EXPECT_EQ(0UL, allocator.GetSlotCount());
+}
+
+}  // namespace test
+}  // namespace peloton
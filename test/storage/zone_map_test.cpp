@@ -0,0 +1,160 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// zone_map_test.cpp
+//
+// Identification: test/storage/zone_map_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "storage/zone_map.h"
+
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "expression/expression_util.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Zone Map Tests
+//===--------------------------------------------------------------------===//
+
+class ZoneMapTests : public PelotonTest {};
+
+TEST_F(ZoneMapTests, ColumnRangeTest) {
+  const int tuples_per_tile_group = 5;
+  const int tile_group_count = 3;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(tuples_per_tile_group, false));
+  TestingExecutorUtil::PopulateTable(table.get(),
+                                     tuples_per_tile_group * tile_group_count,
+                                     false, false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  for (int tile_group_itr = 0; tile_group_itr < tile_group_count;
+       tile_group_itr++) {
+    auto tile_group = table->GetTileGroup(tile_group_itr);
+    auto zone_map = tile_group->GetZoneMap();
+    LOG_INFO("%s", zone_map->GetInfo().c_str());
+
+    type::Value min, max;
+    size_t null_count;
+    EXPECT_TRUE(zone_map->GetColumnRange(0, min, max, null_count));
+    EXPECT_EQ(0, null_count);
+
+    int first_row = tile_group_itr * tuples_per_tile_group;
+    int last_row = first_row + tuples_per_tile_group - 1;
+    EXPECT_EQ(TestingExecutorUtil::PopulatedValue(first_row, 0),
+              min.GetAs<int32_t>());
+    EXPECT_EQ(TestingExecutorUtil::PopulatedValue(last_row, 0),
+              max.GetAs<int32_t>());
+
+    // Varchar columns are not tracked
+    EXPECT_FALSE(zone_map->GetColumnRange(3, min, max, null_count));
+  }
+
+  // An equality predicate only matches the tile group holding the value
+  auto value = type::ValueFactory::GetIntegerValue(
+      TestingExecutorUtil::PopulatedValue(tuples_per_tile_group + 2, 0));
+  std::vector<storage::ZoneMapPredicate> predicates;
+  predicates.emplace_back(0, ExpressionType::COMPARE_EQUAL, value);
+  for (int tile_group_itr = 0; tile_group_itr < tile_group_count;
+       tile_group_itr++) {
+    auto zone_map = table->GetTileGroup(tile_group_itr)->GetZoneMap();
+    EXPECT_EQ(tile_group_itr == 1, zone_map->ShouldScan(predicates));
+  }
+
+  // A range predicate past the end of the table matches nothing
+  predicates.clear();
+  predicates.emplace_back(
+      0, ExpressionType::COMPARE_GREATERTHAN,
+      type::ValueFactory::GetIntegerValue(TestingExecutorUtil::PopulatedValue(
+          tuples_per_tile_group * tile_group_count, 0)));
+  for (int tile_group_itr = 0; tile_group_itr < tile_group_count;
+       tile_group_itr++) {
+    auto zone_map = table->GetTileGroup(tile_group_itr)->GetZoneMap();
+    EXPECT_FALSE(zone_map->ShouldScan(predicates));
+  }
+
+  // Rebuilding from the stored tuples yields the same ranges
+  auto tile_group = table->GetTileGroup(0);
+  tile_group->RebuildZoneMap();
+  type::Value min, max;
+  size_t null_count;
+  EXPECT_TRUE(tile_group->GetZoneMap()->GetColumnRange(0, min, max,
+                                                       null_count));
+  EXPECT_EQ(TestingExecutorUtil::PopulatedValue(0, 0), min.GetAs<int32_t>());
+  EXPECT_EQ(
+      TestingExecutorUtil::PopulatedValue(tuples_per_tile_group - 1, 0),
+      max.GetAs<int32_t>());
+}
+
+TEST_F(ZoneMapTests, ExtractPredicatesTest) {
+  // 10 < a AND a <= 20 AND b = ? AND c LIKE 'x'
+  auto *lower = expression::ExpressionUtil::ComparisonFactory(
+      ExpressionType::COMPARE_LESSTHAN,
+      expression::ExpressionUtil::ConstantValueFactory(
+          type::ValueFactory::GetIntegerValue(10)),
+      expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER, 0,
+                                                    0));
+  auto *upper = expression::ExpressionUtil::ComparisonFactory(
+      ExpressionType::COMPARE_LESSTHANOREQUALTO,
+      expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER, 0,
+                                                    0),
+      expression::ExpressionUtil::ConstantValueFactory(
+          type::ValueFactory::GetIntegerValue(20)));
+  auto *param = expression::ExpressionUtil::ComparisonFactory(
+      ExpressionType::COMPARE_EQUAL,
+      expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER, 0,
+                                                    1),
+      new expression::ParameterValueExpression(0));
+  auto *like = expression::ExpressionUtil::ComparisonFactory(
+      ExpressionType::COMPARE_LIKE,
+      expression::ExpressionUtil::TupleValueFactory(type::TypeId::VARCHAR, 0,
+                                                    3),
+      expression::ExpressionUtil::ConstantValueFactory(
+          type::ValueFactory::GetVarcharValue("x")));
+  std::unique_ptr<expression::AbstractExpression> predicate(
+      expression::ExpressionUtil::ConjunctionFactory(
+          ExpressionType::CONJUNCTION_AND,
+          expression::ExpressionUtil::ConjunctionFactory(
+              ExpressionType::CONJUNCTION_AND, lower, upper),
+          expression::ExpressionUtil::ConjunctionFactory(
+              ExpressionType::CONJUNCTION_AND, param, like)));
+
+  // Without parameter values only the constant comparisons are usable
+  std::vector<storage::ZoneMapPredicate> predicates;
+  storage::ZoneMap::ExtractPredicates(predicate.get(), nullptr, predicates);
+  ASSERT_EQ(2, predicates.size());
+  EXPECT_EQ(0, predicates[0].column_id);
+  EXPECT_EQ(ExpressionType::COMPARE_GREATERTHAN, predicates[0].comparison);
+  EXPECT_EQ(10, predicates[0].value.GetAs<int32_t>());
+  EXPECT_EQ(0, predicates[1].column_id);
+  EXPECT_EQ(ExpressionType::COMPARE_LESSTHANOREQUALTO,
+            predicates[1].comparison);
+  EXPECT_EQ(20, predicates[1].value.GetAs<int32_t>());
+
+  // With parameter values the parameterized comparison is picked up as well
+  std::vector<type::Value> params = {type::ValueFactory::GetIntegerValue(42)};
+  predicates.clear();
+  storage::ZoneMap::ExtractPredicates(predicate.get(), &params, predicates);
+  ASSERT_EQ(3, predicates.size());
+  EXPECT_EQ(1, predicates[2].column_id);
+  EXPECT_EQ(ExpressionType::COMPARE_EQUAL, predicates[2].comparison);
+  EXPECT_EQ(42, predicates[2].value.GetAs<int32_t>());
+}
+
+}  // namespace test
+}  // namespace peloton
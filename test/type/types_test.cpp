@@ -317,7 +317,8 @@ TEST_F(TypesTests, HybridScanTypeTest) {
 TEST_F(TypesTests, JoinTypeTest) {
   std::vector<JoinType> list = {JoinType::INVALID, JoinType::LEFT,
                                 JoinType::RIGHT,   JoinType::INNER,
-                                JoinType::OUTER,   JoinType::SEMI};
+                                JoinType::OUTER,   JoinType::SEMI,
+                                JoinType::ANTI};
 
   // Make sure that ToString and FromString work
   for (auto val : list) {
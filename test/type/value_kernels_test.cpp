@@ -0,0 +1,192 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// value_kernels_test.cpp
+//
+// Identification: test/type/value_kernels_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "type/value_factory.h"
+#include "type/value_kernels.h"
+
+namespace peloton {
+namespace test {
+
+class ValueKernelsTests : public PelotonTest {};
+
+static const std::vector<type::TypeId> numeric_types = {
+    type::TypeId::TINYINT, type::TypeId::SMALLINT, type::TypeId::INTEGER,
+    type::TypeId::BIGINT, type::TypeId::DECIMAL};
+
+static type::Value GetValue(type::TypeId type_id, int value) {
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+      return type::ValueFactory::GetTinyIntValue(value);
+    case type::TypeId::SMALLINT:
+      return type::ValueFactory::GetSmallIntValue(value);
+    case type::TypeId::INTEGER:
+      return type::ValueFactory::GetIntegerValue(value);
+    case type::TypeId::BIGINT:
+      return type::ValueFactory::GetBigIntValue(value);
+    default:
+      return type::ValueFactory::GetDecimalValue(value + 0.5);
+  }
+}
+
+static type::CmpBool Compare(ExpressionType type, const type::Value &left,
+                             const type::Value &right) {
+  switch (type) {
+    case ExpressionType::COMPARE_EQUAL:
+      return left.CompareEquals(right);
+    case ExpressionType::COMPARE_NOTEQUAL:
+      return left.CompareNotEquals(right);
+    case ExpressionType::COMPARE_LESSTHAN:
+      return left.CompareLessThan(right);
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return left.CompareGreaterThan(right);
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return left.CompareLessThanEquals(right);
+    default:
+      return left.CompareGreaterThanEquals(right);
+  }
+}
+
+static type::Value Operate(ExpressionType type, const type::Value &left,
+                           const type::Value &right) {
+  switch (type) {
+    case ExpressionType::OPERATOR_PLUS:
+      return left.Add(right);
+    case ExpressionType::OPERATOR_MINUS:
+      return left.Subtract(right);
+    case ExpressionType::OPERATOR_MULTIPLY:
+      return left.Multiply(right);
+    case ExpressionType::OPERATOR_DIVIDE:
+      return left.Divide(right);
+    default:
+      return left.Modulo(right);
+  }
+}
+
+// The result of a kernel or the message of the error it raised
+template <class Function>
+static std::string Describe(Function function) {
+  try {
+    auto result = function();
+    return TypeIdToString(result.GetTypeId()) + " " + result.ToString();
+  } catch (Exception &e) {
+    return e.what();
+  }
+}
+
+TEST_F(ValueKernelsTests, CompareTest) {
+  std::vector<ExpressionType> types = {
+      ExpressionType::COMPARE_EQUAL, ExpressionType::COMPARE_NOTEQUAL,
+      ExpressionType::COMPARE_LESSTHAN, ExpressionType::COMPARE_GREATERTHAN,
+      ExpressionType::COMPARE_LESSTHANOREQUALTO,
+      ExpressionType::COMPARE_GREATERTHANOREQUALTO};
+  std::vector<int> values = {-100, -1, 0, 1, 100};
+
+  // Every pair of numeric types agrees with the generic comparison
+  for (auto type : types) {
+    for (auto left_type : numeric_types) {
+      for (auto right_type : numeric_types) {
+        auto kernel =
+            type::ValueKernels::GetCompare(type, left_type, right_type);
+        for (auto x : values) {
+          for (auto y : values) {
+            auto left = GetValue(left_type, x);
+            auto right = GetValue(right_type, y);
+            EXPECT_TRUE(kernel.Matches(left, right));
+            EXPECT_EQ(Compare(type, left, right), kernel(left, right));
+          }
+        }
+        auto null = type::ValueFactory::GetNullValueByType(left_type);
+        EXPECT_EQ(type::CMP_NULL, kernel(null, GetValue(right_type, 1)));
+      }
+    }
+  }
+
+  auto timestamp = type::ValueKernels::GetCompare(
+      ExpressionType::COMPARE_LESSTHAN, type::TypeId::TIMESTAMP,
+      type::TypeId::TIMESTAMP);
+  EXPECT_EQ(type::CMP_TRUE,
+            timestamp(type::ValueFactory::GetTimestampValue(1),
+                      type::ValueFactory::GetTimestampValue(2)));
+
+  // Only for the types it was resolved for
+  auto integer = type::ValueKernels::GetCompare(
+      ExpressionType::COMPARE_EQUAL, type::TypeId::INTEGER,
+      type::TypeId::INTEGER);
+  EXPECT_FALSE(integer.Matches(type::ValueFactory::GetIntegerValue(1),
+                               type::ValueFactory::GetBigIntValue(1)));
+  EXPECT_FALSE(type::ValueKernels::GetCompare(ExpressionType::COMPARE_EQUAL,
+                                              type::TypeId::VARCHAR,
+                                              type::TypeId::VARCHAR)
+                   .IsValid());
+  EXPECT_FALSE(type::ValueKernels::GetCompare(ExpressionType::COMPARE_LIKE,
+                                              type::TypeId::INTEGER,
+                                              type::TypeId::INTEGER)
+                   .IsValid());
+}
+
+TEST_F(ValueKernelsTests, ArithmeticTest) {
+  std::vector<ExpressionType> types = {
+      ExpressionType::OPERATOR_PLUS, ExpressionType::OPERATOR_MINUS,
+      ExpressionType::OPERATOR_MULTIPLY, ExpressionType::OPERATOR_DIVIDE,
+      ExpressionType::OPERATOR_MOD};
+  // Large enough to overflow the narrow types, and zero to divide by
+  std::vector<int> values = {-100, -3, 0, 1, 7, 127};
+
+  // Results, result types and errors are those of the generic methods
+  for (auto type : types) {
+    for (auto left_type : numeric_types) {
+      for (auto right_type : numeric_types) {
+        auto kernel =
+            type::ValueKernels::GetArithmetic(type, left_type, right_type);
+        if (type == ExpressionType::OPERATOR_MOD &&
+            (left_type == type::TypeId::DECIMAL ||
+             right_type == type::TypeId::DECIMAL)) {
+          EXPECT_FALSE(kernel.IsValid());
+          continue;
+        }
+        for (auto x : values) {
+          for (auto y : values) {
+            auto left = GetValue(left_type, x);
+            auto right = GetValue(right_type, y);
+            EXPECT_TRUE(kernel.Matches(left, right));
+            EXPECT_EQ(Describe([&] { return Operate(type, left, right); }),
+                      Describe([&] { return kernel(left, right); }));
+          }
+        }
+        auto null = type::ValueFactory::GetNullValueByType(right_type);
+        EXPECT_TRUE(kernel(GetValue(left_type, 1), null).IsNull());
+      }
+    }
+  }
+}
+
+TEST_F(ValueKernelsTests, MinMaxTest) {
+  for (auto type_id : numeric_types) {
+    auto min = type::ValueKernels::GetMin(type_id);
+    auto max = type::ValueKernels::GetMax(type_id);
+    auto small = GetValue(type_id, -5);
+    auto large = GetValue(type_id, 5);
+    EXPECT_EQ(type::CMP_TRUE, min(large, small).CompareEquals(small));
+    EXPECT_EQ(type::CMP_TRUE, max(small, large).CompareEquals(large));
+    EXPECT_TRUE(
+        min(small, type::ValueFactory::GetNullValueByType(type_id)).IsNull());
+  }
+  EXPECT_FALSE(type::ValueKernels::GetMin(type::TypeId::VARCHAR).IsValid());
+}
+
+}  // namespace test
+}  // namespace peloton